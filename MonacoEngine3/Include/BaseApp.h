@@ -18,6 +18,25 @@
 #include "GUI/GUI.h"
 #include "SceneGraph/SceneGraph.h"
 #include "EngineUtilities/Utilities/Camera.h"
+#include "RHI/IRenderBackend.h"
+#include "Renderer/RenderQueue.h"
+#include "Renderer/ParallelCommandRecorder.h"
+#include "Renderer/StaticBatcher.h"
+#include "Renderer/MeshPool.h"
+#include "Renderer/PipelineStateCache.h"
+#include "Renderer/ShaderCache.h"
+#include "Renderer/D3DShaderCompiler.h"
+#include "Renderer/ShaderPermutations.h"
+#include "Renderer/RenderGraph.h"
+#include "Renderer/CascadedShadowMap.h"
+#include "Renderer/ClusteredLighting.h"
+#include "Renderer/DynamicResolution.h"
+#include "Renderer/FramePacer.h"
+#include "Renderer/TextureStreamer.h"
+#include "EngineUtilities/Utilities/ThreadPool.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include "EngineUtilities/Utilities/EngineStats.h"
+#include "EngineUtilities/Utilities/FixedTimestep.h"
 
 
 // =================================================================================
@@ -89,6 +108,23 @@ public:
         init();
 
 
+    /**
+     * @brief Inicializa el motor sin ventana ni GPU sobre @c NullRenderBackend.
+     * Sustituye la swapchain por un render target fuera de pantalla del mismo tamao.
+     * @return HRESULT S_OK si el backend y la escena se inicializaron correctamente.
+     */
+    HRESULT
+        initHeadless();
+
+
+    /**
+     * @brief Crea los recursos de escena comunes a ambos modos (DSV, viewport, assets, shaders).
+     * Requiere que el backend y el render target ya existan.
+     */
+    HRESULT
+        initScene();
+
+
     /**
      * @brief Inicia el bucle principal de la aplicacin.
      * Contiene el bucle infinito de mensajes de Windows (Update/Render loop).
@@ -100,6 +136,109 @@ public:
         run(HINSTANCE hInst, int nCmdShow);
 
 
+    /**
+     * @brief Ejecuta un nmero fijo de frames sin ventana para medir el costo de CPU.
+     * Escribe tiempos y contadores del backend en @c HeadlessBenchmark.txt, junto con
+     * comprobaciones de los subsistemas sobre entradas sintticas (@c check_<nombre>).
+     * @param frameCount Cantidad de frames a simular con paso fijo de 1/60 s.
+     * @return int 0 si todo fue bien, 2 si hubo errores de validacin, 3 si fall alguna comprobacin.
+     */
+    int
+        runHeadless(unsigned int frameCount);
+
+
+    /**
+     * @brief Cantidad de espadas de la escena demo (llamar antes de @c run / @c runHeadless).
+     * Las copias comparten malla y material, por lo que la cola las dibuja instanciadas.
+     * @param count Nmero total de espadas (mnimo 1).
+     */
+    void
+        setCrowdSize(unsigned int count) { m_crowdSize = count > 0 ? count : 1; }
+
+
+    /**
+     * @brief Marca las copias de la espada como estticas (llamar antes de @c run / @c runHeadless).
+     * Se fusionan en pginas compartidas en lugar de dibujarse instanciadas.
+     */
+    void
+        setStaticCrowd(bool enabled) { m_staticCrowd = enabled; }
+
+
+    /**
+     * @brief Activa o desactiva el filtrado de binds redundantes del @c DeviceContext.
+     * Con el filtrado desactivado el benchmark headless mide el coste sin cach.
+     */
+    void
+        setStateFiltering(bool enabled) { m_deviceContext.setStateFiltering(enabled); }
+
+
+    /**
+     * @brief Hilos que graban los draws de la cola en contextos diferidos (llamar antes de @c run / @c runHeadless).
+     * @param count 0 usa todos los ncleos; 1 graba en serie sobre el contexto inmediato.
+     */
+    void
+        setRenderThreads(unsigned int count) { m_renderThreads = count; }
+
+
+    /**
+     * @brief Luces puntuales y focos de la escena demo (llamar antes de @c run / @c runHeadless).
+     * @param count 0 desactiva el reparto por clusters.
+     */
+    void
+        setLightCount(unsigned int count) { m_lightCount = count; }
+
+
+    /**
+     * @brief Presupuesto por frame de la resolucin dinmica (llamar antes de @c run / @c runHeadless).
+     * @param ms Un valor positivo activa el escalado; 0 o menos lo desactiva (por defecto).
+     */
+    void
+        setFrameBudget(float ms);
+
+
+    /**
+     * @brief Ritmo de frames y latencia (llamar antes de @c run / @c runHeadless).
+     * @param targetFps Frames por segundo objetivo; 0 sin lmite.
+     * @param maxFrameLatency Frames que la CPU puede adelantar a la GPU (1..16).
+     * @param vsync Present sincronizado con el refresco.
+     */
+    void
+        setFramePacing(float targetFps, unsigned int maxFrameLatency, bool vsync);
+
+
+    /**
+     * @brief Frecuencia de la simulacin a paso fijo (por defecto 60 Hz).
+     * @param hz Pasos por segundo; 0 o menos no cambia nada.
+     */
+    void
+        setSimulationRate(float hz);
+
+
+    /**
+     * @brief VRAM para las texturas en streaming (llamar antes de @c run / @c runHeadless).
+     * @param megabytes 0 no cambia nada (por defecto 64 MB).
+     */
+    void
+        setTextureBudget(unsigned int megabytes);
+
+
+    /**
+     * @brief Graba una traza de Chrome desde el arranque (carga incluida) durante N frames.
+     * Se escribe en @c Trace.json sin detener el bucle; requiere @c MONACO_PROFILING.
+     * @param frameCount 0 no graba.
+     */
+    void
+        setTraceCapture(unsigned int frameCount) { m_traceFrames = frameCount; }
+
+
+    /**
+     * @brief Escribe una fila por frame con los contadores de @c EngineStats en @p fileName.
+     * @return false si no se pudo abrir el archivo.
+     */
+    bool
+        setStatsCsv(const std::string& fileName) { return EngineStats::getInstance().startCsv(fileName); }
+
+
     /**
      * @brief Actualizacin lgica por fotograma (Update).
      * @param deltaTime Tiempo transcurrido en segundos desde el ltimo fotograma.
@@ -145,6 +284,14 @@ private:
     static LRESULT CALLBACK
         WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
+    /**
+     * @brief Detecta ediciones (gizmo, inspector) de actores estticos.
+     * Mientras alguno se mueve el batching queda deshecho y cada actor se dibuja suelto; al
+     * quedarse quietos se rehacen las pginas. En ambos casos se redibuja la sombra esttica.
+     */
+    void
+        syncStaticGeometry();
+
 
 private:
 
@@ -167,6 +314,12 @@ private:
     /** @brief Configuracin del rea de visualizacin. */
     Viewport        m_viewport;
 
+    /** @brief Backend de render activo (D3D11 o Null) al que delegan Device y DeviceContext. */
+    std::unique_ptr<IRenderBackend> m_renderBackend;
+
+    /** @brief true si la app corre sin ventana (sin GUI ni Present). */
+    bool            m_headless = false;
+
 
     // -----------------------------------------------------------------------------
     // RENDER TARGETS & VISTAS
@@ -178,11 +331,35 @@ private:
     /** @brief Vista de Render Target (RTV) para el Back Buffer. */
     RenderTargetView    m_renderTargetView;
 
-    /** @brief Textura de Profundidad/Estarcido. */
-    Texture             m_depthStencil;
+    /** @brief Grafo del frame; crea y recicla las texturas transitorias (profundidad incluida). */
+    RenderGraph         m_renderGraph;
+
+    /** @brief Profundidad/estarcido de la escena (MSAA igual que el back buffer). */
+    RGTextureDesc       m_sceneDepthDesc;
+
+    /** @brief Sombras de la luz direccional (mapa persistente, importado en el grafo). */
+    CascadedShadowMap   m_shadows;
 
-    /** @brief Vista de Profundidad (DSV). */
-    DepthStencilView    m_depthStencilView;
+    /** @brief Pase de sombras activo (slo si @c m_shadows se inicializ). */
+    bool                m_shadowsEnabled = false;
+
+    /** @brief Luces dinmicas repartidas en clusters del frustum. */
+    ClusteredLighting   m_clusteredLights;
+
+    /** @brief Reparto y subida de luces activos (slo si @c m_clusteredLights se inicializ). */
+    bool                m_lightsEnabled = false;
+
+    /** @brief Luces de la escena demo. */
+    unsigned int        m_lightCount = 256;
+
+    /** @brief Escala de la escena segn el tiempo de frame y escalado al back buffer. */
+    DynamicResolution   m_dynamicResolution;
+
+    /** @brief Limitador de frames, tope de frames en cola y estadsticas de jitter y latencia. */
+    FramePacer          m_framePacer;
+
+    /** @brief Acumulador de la simulacin: pasos fijos por frame y alpha de interpolacin. */
+    FixedTimestep       m_fixedStep;
 
 
     // -----------------------------------------------------------------------------
@@ -192,6 +369,15 @@ private:
     /** @brief Programa de Shader principal (Vertex + Pixel). */
     ShaderProgram       m_shaderProgram;
 
+    /** @brief Shader instanciado (mundo y color por instancia) y sus variantes por keyword. */
+    ShaderPermutations  m_shaderInstanced;
+
+    /** @brief Keywords elegidos en la GUI para el shader instanciado. */
+    ShaderKeywordMask   m_instancedKeywords = 0;
+
+    /** @brief Variante enlazada ahora en la cola (la base mientras compila la pedida). */
+    ShaderProgram*      m_instancedVariant = nullptr;
+
     /** @brief Constant Buffer esttico (Rara vez cambia). */
     Buffer              m_cbNeverChanges;
 
@@ -203,9 +389,12 @@ private:
     // DATOS DE LA ESCENA (Assets & Lgica)
     // -----------------------------------------------------------------------------
 
-    /** @brief Textura Albedo para demo. */
+    /** @brief Textura Albedo para demo (DDS completo si no hay PNG para el streaming). */
     Texture             m_EspadaAlbedo;
 
+    /** @brief Mips de las texturas importadas segn la densidad de texels en pantalla. */
+    TextureStreamer     m_textureStreamer;
+
     /** @brief Textura Cubemap para el Skybox. */
     Texture             m_skyboxTex;
 
@@ -218,12 +407,57 @@ private:
     /** @brief Grafo de Escena para jerarquas. */
     SceneGraph          m_sceneGraph;
 
+    /** @brief Cola de paquetes de dibujo del frame (ordenada por clave). */
+    RenderQueue         m_renderQueue;
+
+    /** @brief Memoria de constant buffers por objeto, sub-asignada por frame. */
+    ConstantBufferRing  m_constantRing;
+
+    /** @brief Hilos persistentes que graban los rangos de la cola. */
+    ThreadPool          m_threadPool;
+
+    /** @brief Contextos diferidos en los que se graba la cola en paralelo. */
+    ParallelCommandRecorder m_commandRecorder;
+
+    /** @brief Hilos de grabacin pedidos (0 = automtico, 1 = en serie). */
+    unsigned int        m_renderThreads = 0;
+
+    /** @brief Frames de la traza pedida al arrancar (0 = ninguna). */
+    unsigned int        m_traceFrames = 0;
+
     /** @brief Lista de actores en la escena. */
     std::vector<EU::TSharedPointer<Actor>> m_actors;
 
     /** @brief Actor principal de demostracin. */
     EU::TSharedPointer<Actor>              m_Espada;
 
+    /** @brief Espadas totales en la escena (1 = slo @c m_Espada). */
+    unsigned int                           m_crowdSize = 1;
+
+    /** @brief Las copias de la espada se marcan como estticas. */
+    bool                                   m_staticCrowd = false;
+
+    /** @brief Pginas de geometra de los actores estticos. */
+    StaticBatcher                          m_staticBatcher;
+
+    /** @brief Matriz de mundo de cada actor en la ltima comprobacin de estticos. */
+    std::vector<XMFLOAT4X4>                m_staticWorlds;
+
+    /** @brief Frames seguidos sin mover estticos desde que se deshizo el batching (0 = intacto). */
+    unsigned int                           m_staticStillFrames = 0;
+
+    /** @brief Algn actor esttico se edit y el batching est deshecho. */
+    bool                                   m_staticEditing = false;
+
+    /** @brief Vertex/index buffers compartidos por la geometra de los actores. */
+    MeshPool                               m_meshPool;
+
+    /** @brief Compilador HLSL que usa la cach en cada fallo. */
+    D3DShaderCompiler                      m_shaderCompiler;
+
+    /** @brief Bytecode compilado de ejecuciones anteriores (ShaderCache.bin). */
+    ShaderCache                            m_shaderCache;
+
 
     // -----------------------------------------------------------------------------
     // DATOS DE REFLEXIN (CPU Mirrors for Constant Buffers)
@@ -71,6 +71,41 @@ public:
             unsigned int ByteWidth);
 
 
+    /**
+     * @brief Inicializa un buffer dinmico (escritura de CPU va @c Map).
+     *
+     * Pensado para datos por instancia o constantes que se reescriben cada frame.
+     * @param device Dispositivo DirectX utilizado para crear el recurso.
+     * @param stride Tamao en bytes de cada elemento.
+     * @param elementCount Capacidad en elementos.
+     * @param bindFlag @c D3D11_BIND_VERTEX_BUFFER o @c D3D11_BIND_CONSTANT_BUFFER.
+     * @return @c S_OK si la creacin fue exitosa, o un cdigo de error HRESULT.
+     */
+    HRESULT
+        initDynamic(Device& device,
+            unsigned int stride,
+            unsigned int elementCount,
+            unsigned int bindFlag = D3D11_BIND_VERTEX_BUFFER);
+
+
+    /**
+     * @brief Inicializa un buffer por defecto vaco, que se rellena por tramos con @c update().
+     *
+     * Sirve para buffers compartidos (p. ej. el pool de mallas) donde cada malla ocupa
+     * una parte y se sube con @c UpdateSubresource y una caja de destino.
+     * @param device Dispositivo DirectX utilizado para crear el recurso.
+     * @param stride Tamao en bytes de cada elemento.
+     * @param elementCount Capacidad en elementos.
+     * @param bindFlag @c D3D11_BIND_VERTEX_BUFFER o @c D3D11_BIND_INDEX_BUFFER.
+     * @return @c S_OK si la creacin fue exitosa, o un cdigo de error HRESULT.
+     */
+    HRESULT
+        initDefault(Device& device,
+            unsigned int stride,
+            unsigned int elementCount,
+            unsigned int bindFlag);
+
+
     /**
      * @brief Mtodo interno para la creacin de bajo nivel del buffer.
      * @param device Dispositivo DirectX.
@@ -121,6 +156,24 @@ public:
         destroy();
 
 
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Recurso nativo (no propietario), p. ej. para armar paquetes de dibujo.
+     */
+    ID3D11Buffer*
+        getBuffer() const { return m_buffer; }
+
+
+    /**
+     * @brief Stride en bytes de un vertex buffer (0 para otros tipos).
+     */
+    unsigned int
+        getStride() const { return m_stride; }
+
+
 private:
 
     // -----------------------------------------------------------------------------
@@ -142,4 +195,8 @@ private:
     /** @brief Bandera de vinculacin que indica el tipo de buffer. */
     unsigned int m_bindFlag = 0;
 
+
+    /** @brief Tamao total en bytes (para las estadsticas de memoria y subidas). */
+    unsigned int m_byteWidth = 0;
+
 };
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "Prerequisites.h"
 
+class IRenderBackend;
+
 // =================================================================================
 // CLASE: DEVICE (Direct3D 11 Wrapper)
 // =================================================================================
@@ -179,6 +181,99 @@ public:
                            ID3D11SamplerState** ppSamplerState);
 
 
+    /**
+     * @brief Crea un estado de mezcla (Blend State) para el Output Merger.
+     * @param pBlendStateDesc Descripcin de la mezcla por render target.
+     * @param ppBlendState Salida del estado creado.
+     */
+    HRESULT
+        CreateBlendState(const D3D11_BLEND_DESC* pBlendStateDesc,
+                         ID3D11BlendState** ppBlendState);
+
+
+    /**
+     * @brief Crea un estado de rasterizacin (cull, fill, depth bias...).
+     * @param pRasterizerDesc Descripcin del rasterizador.
+     * @param ppRasterizerState Salida del estado creado.
+     */
+    HRESULT
+        CreateRasterizerState(const D3D11_RASTERIZER_DESC* pRasterizerDesc,
+                              ID3D11RasterizerState** ppRasterizerState);
+
+
+    /**
+     * @brief Crea un estado de profundidad y stencil.
+     * @param pDepthStencilDesc Descripcin de las pruebas de profundidad y stencil.
+     * @param ppDepthStencilState Salida del estado creado.
+     */
+    HRESULT
+        CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* pDepthStencilDesc,
+                                ID3D11DepthStencilState** ppDepthStencilState);
+
+
+    /**
+     * @brief Crea una vista de recurso de shader (SRV) sobre una textura o buffer.
+     * @param pResource Recurso de origen.
+     * @param pDesc Descriptor opcional de la vista.
+     * @param ppSRView Salida de la vista creada.
+     */
+    HRESULT
+        CreateShaderResourceView(ID3D11Resource* pResource,
+                                 const D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc,
+                                 ID3D11ShaderResourceView** ppSRView);
+
+
+    /**
+     * @brief Carga una imagen desde disco (DDS) y crea su SRV.
+     * @param fileName Ruta completa del archivo, incluyendo extensin.
+     * @param ppSRView Salida de la vista creada.
+     */
+    HRESULT
+        CreateShaderResourceViewFromFile(const std::string& fileName,
+                                         ID3D11ShaderResourceView** ppSRView);
+
+
+    /**
+     * @brief Consulta los niveles de calidad MSAA soportados para un formato.
+     * @param Format Formato a consultar.
+     * @param SampleCount Nmero de muestras por pxel.
+     * @param pNumQualityLevels Salida con la cantidad de niveles (0 = no soportado).
+     */
+    HRESULT
+        CheckMultisampleQualityLevels(DXGI_FORMAT Format,
+                                      UINT SampleCount,
+                                      UINT* pNumQualityLevels);
+
+
+    /**
+     * @brief Crea una consulta de GPU (timestamps, oclusin...).
+     * @param pQueryDesc Tipo de consulta.
+     * @param ppQuery Salida de la consulta creada.
+     */
+    HRESULT
+        CreateQuery(const D3D11_QUERY_DESC* pQueryDesc,
+                    ID3D11Query** ppQuery);
+
+
+    // -----------------------------------------------------------------------------
+    // BACKEND DE RENDER
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Asigna el backend por el que pasan todas las creaciones de recursos.
+     * @param backend Backend no propietario (D3D11 o Null).
+     */
+    void
+        setBackend(IRenderBackend* backend) { m_backend = backend; }
+
+
+    /**
+     * @brief Backend activo, o @c nullptr si an no se asign.
+     */
+    IRenderBackend*
+        getBackend() const { return m_backend; }
+
+
 public:
 
     // -----------------------------------------------------------------------------
@@ -191,4 +286,9 @@ public:
      */
     ID3D11Device* m_device = nullptr;
 
+    /**
+     * @brief Backend que ejecuta las llamadas de creacin (no propietario).
+     */
+    IRenderBackend* m_backend = nullptr;
+
 };
\ No newline at end of file
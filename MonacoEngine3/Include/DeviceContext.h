@@ -1,6 +1,21 @@
 #pragma once
 #include "Prerequisites.h"
 
+class IRenderBackend;
+class IRenderCommandList;
+
+/**
+ * @struct DeviceContextStats
+ * @brief Llamadas de estado que llegaron al backend frente a las que filtr la cach.
+ */
+struct DeviceContextStats {
+  unsigned long long stateCallsIssued = 0;    ///< Binds reenviados al backend.
+  unsigned long long stateCallsFiltered = 0;  ///< Binds descartados por no cambiar nada.
+
+  /** @brief Pone los contadores a cero. */
+  void reset() { *this = DeviceContextStats(); }
+};
+
 /**
  * @class DeviceContext
  * @brief Administra el contexto inmediato de Direct3D 11.
@@ -8,6 +23,13 @@
  * Proporciona funciones para configurar el pipeline de renderizado,
  * asignar recursos, limpiar buffers y ejecutar comandos de dibujo.
  * Sirve como interfaz entre el CPU y la GPU para la emisin de comandos.
+ *
+ * Guarda una copia del estado enlazado (shaders, buffers, SRVs, samplers, topologa,
+ * viewports, estados y render targets) y descarta los binds que no cambian nada.
+ * La cach slo ve lo que pasa por esta clase: si otro cdigo usa el contexto nativo
+ * (p. ej. ImGui) hay que llamar a @c invalidateStateCache() despus.
+ * Los punteros guardados no pueden colgar: D3D11 mantiene una referencia a todo lo
+ * enlazado, as que su direccin no se reutiliza mientras siga en la cach.
  */
 class DeviceContext {
 public:
@@ -67,6 +89,16 @@ public:
                          unsigned int SrcRowPitch,
                          unsigned int SrcDepthPitch);
 
+  /** @brief Copia una regin entre dos recursos de GPU (sin pasar por CPU). */
+  void CopySubresourceRegion(ID3D11Resource* pDstResource,
+                             unsigned int DstSubresource,
+                             unsigned int DstX,
+                             unsigned int DstY,
+                             unsigned int DstZ,
+                             ID3D11Resource* pSrcResource,
+                             unsigned int SrcSubresource,
+                             const D3D11_BOX* pSrcBox);
+
   /** @brief Asigna buffers de vrtices al Input Assembler. */
   void IASetVertexBuffers(unsigned int StartSlot,
                           unsigned int NumBuffers,
@@ -92,6 +124,10 @@ public:
     const float BlendFactor[4],
     unsigned int SampleMask);
 
+  /** @brief Asigna un Depth Stencil State al Output Merger. */
+  void OMSetDepthStencilState(ID3D11DepthStencilState* pDepthStencilState,
+                              unsigned int StencilRef);
+
   /** @brief Configura los Render Targets y Depth Stencil Views. */
   void OMSetRenderTargets(unsigned int NumViews,
                           ID3D11RenderTargetView* const* ppRenderTargetViews,
@@ -120,12 +156,179 @@ public:
                             unsigned int NumBuffers,
                             ID3D11Buffer* const* ppConstantBuffers);
 
+  /** @brief Asigna rangos de constant buffers al Vertex Shader (D3D11.1, unidades de 16 constantes). */
+  void VSSetConstantBuffers1(unsigned int StartSlot,
+                             unsigned int NumBuffers,
+                             ID3D11Buffer* const* ppConstantBuffers,
+                             const unsigned int* pFirstConstant,
+                             const unsigned int* pNumConstants);
+
+  /** @brief Asigna rangos de constant buffers al Pixel Shader (D3D11.1, unidades de 16 constantes). */
+  void PSSetConstantBuffers1(unsigned int StartSlot,
+                             unsigned int NumBuffers,
+                             ID3D11Buffer* const* ppConstantBuffers,
+                             const unsigned int* pFirstConstant,
+                             const unsigned int* pNumConstants);
+
+  /** @brief true si el backend admite @c *SSetConstantBuffers1 y NO_OVERWRITE sobre constant buffers. */
+  bool supportsConstantBufferOffsets() const;
+
   /** @brief Enva un comando de dibujado de primitivas indexadas. */
   void DrawIndexed(unsigned int IndexCount,
                    unsigned int StartIndexLocation,
                    int BaseVertexLocation);
 
+  /** @brief Dibuja varias instancias de la misma geometra indexada (datos por instancia en slot 1). */
+  void DrawIndexedInstanced(unsigned int IndexCountPerInstance,
+                            unsigned int InstanceCount,
+                            unsigned int StartIndexLocation,
+                            int BaseVertexLocation,
+                            unsigned int StartInstanceLocation);
+
+  /** @brief Mapea un recurso dinmico para escribirlo desde la CPU. */
+  HRESULT Map(ID3D11Resource* pResource,
+              unsigned int Subresource,
+              D3D11_MAP MapType,
+              unsigned int MapFlags,
+              D3D11_MAPPED_SUBRESOURCE* pMappedResource);
+
+  /** @brief Libera el mapeo abierto con @c Map. */
+  void Unmap(ID3D11Resource* pResource, unsigned int Subresource);
+
+  /** @brief Genera la cadena de mips de una SRV creada con @c D3D11_RESOURCE_MISC_GENERATE_MIPS. */
+  void GenerateMips(ID3D11ShaderResourceView* pShaderResourceView);
+
+  /** @brief Resuelve un recurso multisample en uno de una sola muestra del mismo tamao. */
+  void ResolveSubresource(ID3D11Resource* pDstResource,
+                          unsigned int DstSubresource,
+                          ID3D11Resource* pSrcResource,
+                          unsigned int SrcSubresource,
+                          DXGI_FORMAT Format);
+
+  /** @brief Abre una consulta (los timestamps no la usan: slo @c End). */
+  void Begin(ID3D11Asynchronous* pAsync);
+
+  /** @brief Cierra una consulta o escribe un timestamp. */
+  void End(ID3D11Asynchronous* pAsync);
+
+  /** @brief Lee una consulta sin bloquear; @c S_FALSE si an no est lista. */
+  HRESULT GetData(ID3D11Asynchronous* pAsync,
+                  void* pData,
+                  unsigned int DataSize,
+                  unsigned int GetDataFlags);
+
+  /** @brief Restablece todo el estado del pipeline a sus valores por defecto. */
+  void ClearState();
+
+  /** @brief Cierra lo grabado en este contexto diferido; su estado vuelve al de por defecto. */
+  HRESULT FinishCommandList(std::unique_ptr<IRenderCommandList>& commandList);
+
+  /** @brief Ejecuta una lista grabada en un contexto diferido; el estado queda limpio al terminar. */
+  void ExecuteCommandList(IRenderCommandList& commandList);
+
+  /** @brief Asigna el backend que ejecuta (o graba) los comandos del contexto. */
+  void setBackend(IRenderBackend* backend) {
+    m_backend = backend;
+    invalidateStateCache();
+  }
+
+  /** @brief Backend activo, o @c nullptr si an no se asign. */
+  IRenderBackend* getBackend() const { return m_backend; }
+
+  /** @brief Activa o desactiva el filtrado de binds redundantes (la cach se sigue actualizando). */
+  void setStateFiltering(bool enabled) { m_stateFiltering = enabled; }
+
+  /** @brief true si los binds redundantes se descartan. */
+  bool isStateFilteringEnabled() const { return m_stateFiltering; }
+
+  /** @brief Marca todo el estado como desconocido; el siguiente bind de cada slot siempre se emite. */
+  void invalidateStateCache();
+
+  /** @brief Contadores de binds emitidos y filtrados desde el ltimo @c resetStateStats(). */
+  const DeviceContextStats& getStateStats() const { return m_stateStats; }
+
+  /** @brief Reinicia los contadores de la cach (normalmente una vez por frame). */
+  void resetStateStats() { m_stateStats.reset(); }
+
+  /** @brief Suma los contadores de otro contexto (p. ej. uno diferido) a los de ste. */
+  void accumulateStateStats(const DeviceContextStats& other) {
+    m_stateStats.stateCallsIssued += other.stateCallsIssued;
+    m_stateStats.stateCallsFiltered += other.stateCallsFiltered;
+  }
+
 public:
   /** @brief Puntero al contexto inmediato de Direct3D 11. */
   ID3D11DeviceContext* m_deviceContext = nullptr;
+
+  /** @brief Backend por el que pasan todos los comandos (no propietario). */
+  IRenderBackend* m_backend = nullptr;
+
+private:
+  /** @brief Slots que cubre la cach; los binds fuera de rango siempre se emiten. */
+  static const unsigned int kCachedVertexBuffers = D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT;
+  static const unsigned int kCachedConstantBuffers = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT;
+  static const unsigned int kCachedShaderResources = 16;
+  static const unsigned int kCachedSamplers = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT;
+  static const unsigned int kCachedViewports = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+  static const unsigned int kCachedRenderTargets = D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT;
+
+  /** @brief Constant buffers de una etapa; @c numConstants 0 significa buffer completo. */
+  struct StageConstantBuffers {
+    const void* buffers[kCachedConstantBuffers];
+    unsigned int firstConstant[kCachedConstantBuffers];
+    unsigned int numConstants[kCachedConstantBuffers];
+  };
+
+  /**
+   * @brief Copia del estado enlazado.
+   * Un puntero con el valor de @c unknownState() nunca coincide con un bind real.
+   */
+  struct BoundState {
+    const void* inputLayout;
+    const void* vertexBuffers[kCachedVertexBuffers];
+    unsigned int vertexStrides[kCachedVertexBuffers];
+    unsigned int vertexOffsets[kCachedVertexBuffers];
+    const void* indexBuffer;
+    DXGI_FORMAT indexFormat;
+    unsigned int indexOffset;
+    D3D11_PRIMITIVE_TOPOLOGY topology;
+    const void* vertexShader;
+    const void* pixelShader;
+    StageConstantBuffers vsConstants;
+    StageConstantBuffers psConstants;
+    const void* psResources[kCachedShaderResources];
+    const void* psSamplers[kCachedSamplers];
+    const void* rasterizerState;
+    const void* blendState;
+    float blendFactor[4];
+    unsigned int sampleMask;
+    const void* depthStencilState;
+    unsigned int stencilRef;
+    unsigned int numRenderTargets;
+    const void* renderTargets[kCachedRenderTargets];
+    const void* depthStencil;
+    unsigned int numViewports;
+    D3D11_VIEWPORT viewports[kCachedViewports];
+  };
+
+  /** @brief Centinela para estado desconocido. */
+  static const void* unknownState();
+
+  /** @brief Cuenta un bind que llega al backend (cach local y @c EngineStats). */
+  void countStateCall();
+
+  /** @brief Rellena la cach con @c pointer (nullptr = estado tras @c ClearState). */
+  void resetStateCache(const void* pointer);
+
+  /** @brief Enlaza un rango de constant buffers (con o sin offsets) filtrando lo que no cambia. */
+  void setConstantBuffers(bool pixelStage,
+                          unsigned int StartSlot,
+                          unsigned int NumBuffers,
+                          ID3D11Buffer* const* ppConstantBuffers,
+                          const unsigned int* pFirstConstant,
+                          const unsigned int* pNumConstants);
+
+  BoundState m_bound = {};
+  bool m_stateFiltering = true;
+  DeviceContextStats m_stateStats;
 };
@@ -6,10 +6,13 @@
 #include "Transform.h"
 #include "SamplerState.h"
 #include "ShaderProgram.h"
+#include "Renderer/MeshPool.h"
+#include "Renderer/TextureStreamer.h"
 
 class Device;
 class DeviceContext;
 class MeshComponent;
+class RenderQueue;
 
 /**
  * @class Actor
@@ -73,6 +76,16 @@ public:
      */
     void render(DeviceContext& deviceContext) override;
 
+    /**
+     * @brief Enva un paquete de dibujo por malla a la cola de render.
+     *
+     * Equivale a @ref render, pero sin tocar el pipeline: la cola ordena los paquetes
+     * de todas las entidades y evita los binds redundantes al emitirlos.
+     *
+     * @param queue Cola del frame actual.
+     */
+    void submit(RenderQueue& queue) override;
+
     /**
      * @brief Libera los recursos de memoria y GPU asociados al actor.
      * Debe llamarse antes de eliminar el objeto para evitar fugas de memoria en VRAM.
@@ -90,6 +103,29 @@ public:
      */
     void setMesh(Device& device, std::vector<MeshComponent> meshes);
 
+    /**
+     * @brief Asigna la geometra al actor subindola a un @ref MeshPool compartido.
+     *
+     * No crea buffers propios: cada malla ocupa un tramo de los buffers del pool y se
+     * dibuja con su vrtice e ndice base. Si el pool no la acepta se usan buffers propios.
+     *
+     * @param device Dispositivo grfico (por si el pool tiene que crecer).
+     * @param deviceContext Contexto para copiar los datos al pool.
+     * @param pool Pool compartido; debe vivir ms que el actor.
+     * @param meshes Vector de componentes de malla (@ref MeshComponent) que conforman el objeto.
+     */
+    void setMesh(Device& device, DeviceContext& deviceContext, MeshPool& pool, std::vector<MeshComponent> meshes);
+
+    /**
+     * @brief Reutiliza la geometra ya subida de otro actor (sin crear buffers nuevos).
+     *
+     * Los actores que comparten buffers y material pueden agruparse en un solo draw
+     * instanciado por la @ref RenderQueue.
+     *
+     * @param source Actor con la geometra ya inicializada.
+     */
+    void shareMesh(const Actor& source);
+
     /**
      * @brief Obtiene el nombre identificador del actor.
      * @return Cadena de texto con el nombre actual.
@@ -108,6 +144,23 @@ public:
      */
     void setTextures(std::vector<Texture> textures) { m_textures = textures; }
 
+    /**
+     * @brief Toma el albedo (t0) de un @ref TextureStreamer en lugar de @c m_textures[0].
+     * @param streamer Streamer que posee la textura (no propietario), o `nullptr` para dejar de usarlo.
+     * @param handle Textura dentro de @p streamer.
+     */
+    void setTextureStream(TextureStreamer* streamer, StreamHandle handle) { m_textureStreamer = streamer; m_textureStream = handle; }
+
+    /**
+     * @brief Textura en streaming del albedo, o @c kInvalidStream si usa @c m_textures.
+     */
+    StreamHandle getTextureStream() const { return m_textureStreamer ? m_textureStream : kInvalidStream; }
+
+    /**
+     * @brief Streamer del albedo, o `nullptr` si usa @c m_textures.
+     */
+    TextureStreamer* getTextureStreamer() const { return m_textureStreamer; }
+
     /**
      * @brief Habilita o deshabilita la proyeccin de sombras para este actor.
      * @param v `true` para proyectar sombras, `false` para ignorarlas.
@@ -130,19 +183,96 @@ public:
      */
     void renderShadow(DeviceContext& deviceContext);
 
+    /**
+     * @brief Marca el actor como esttico (no se mover tras construir el batching esttico).
+     * @param v `true` para que @ref StaticBatcher lo fusione con otros actores estticos.
+     */
+    void setStatic(bool v) { m_static = v; }
+
+    /**
+     * @brief Consulta si el actor est marcado como esttico.
+     */
+    bool isStatic() const { return m_static; }
+
+    /**
+     * @brief Indica que su geometra ya vive en las pginas de un @ref StaticBatcher.
+     * Mientras est activo @ref submit no emite paquetes propios.
+     */
+    void setStaticBatched(bool v) { m_staticBatched = v; }
+
+    /**
+     * @brief Consulta si la geometra del actor la dibuja un @ref StaticBatcher.
+     */
+    bool isStaticBatched() const { return m_staticBatched; }
+
+    /**
+     * @brief Mallas de CPU del actor (las que se subieron en @ref setMesh).
+     */
+    const std::vector<MeshComponent>& getMeshes() const { return m_meshes; }
+
+    /**
+     * @brief AABB en espacio de mundo de toda la geometra del actor (para culling).
+     * @param boundsMin Esquina mnima.
+     * @param boundsMax Esquina mxima.
+     * @return `false` si el actor no tiene mallas.
+     */
+    bool getWorldBounds(XMFLOAT3& boundsMin, XMFLOAT3& boundsMax);
+
+    /**
+     * @brief Vista del albedo (t0), o `nullptr` si el actor no tiene texturas.
+     * Con streaming cambia al subir o expulsar niveles: consultarla cada vez que se dibuja.
+     */
+    ID3D11ShaderResourceView* getAlbedo() const {
+        if (m_textureStreamer) {
+            return m_textureStreamer->getView(m_textureStream);
+        }
+        return m_textures.empty() ? nullptr : m_textures[0].m_textureFromImg;
+    }
+
+    /**
+     * @brief Sampler del actor (s0).
+     */
+    ID3D11SamplerState* getSampler() const { return m_sampler.m_sampler; }
+
 private:
+    /**
+     * @brief Recalcula el AABB local a partir de @c m_meshes.
+     */
+    void computeLocalBounds();
+
+    /**
+     * @brief Enlaza el albedo en t0, desde el streamer o desde @c m_textures[0].
+     */
+    void bindAlbedo(DeviceContext& deviceContext);
+
     /** @brief Lista de componentes de malla que definen la forma del actor. */
     std::vector<MeshComponent> m_meshes;
 
+    /** @brief AABB en espacio local de todas las mallas (min > max si no hay geometra). */
+    XMFLOAT3 m_boundsMin = XMFLOAT3(1.0f, 1.0f, 1.0f);
+    XMFLOAT3 m_boundsMax = XMFLOAT3(-1.0f, -1.0f, -1.0f);
+
     /** @brief Lista de texturas aplicadas al modelo. */
     std::vector<Texture> m_textures;
 
+    /** @brief Streamer del albedo (no propietario), o `nullptr` si se usa @c m_textures[0]. */
+    TextureStreamer* m_textureStreamer = nullptr;
+
+    /** @brief Textura del albedo dentro de @c m_textureStreamer. */
+    StreamHandle m_textureStream = kInvalidStream;
+
     /** @brief Buffers de vrtices en GPU para cada malla. */
     std::vector<Buffer> m_vertexBuffers;
 
     /** @brief Buffers de ndices en GPU para cada malla. */
     std::vector<Buffer> m_indexBuffers;
 
+    /** @brief Pool donde vive la geometra (no propietario), o `nullptr` si usa buffers propios. */
+    MeshPool* m_meshPool = nullptr;
+
+    /** @brief Una referencia por malla dentro de @c m_meshPool. */
+    std::vector<MeshHandle> m_meshHandles;
+
     // Recursos de Estado (Comentados o activos segn implementacin)
     // BlendState m_blendstate;    ///< Estado de mezcla de colores.
     // Rasterizer m_rasterizer;    ///< Estado de rasterizacin (Cull mode, Fill mode).
@@ -153,9 +283,16 @@ private:
     /** @brief Estructura de datos para el Constant Buffer de transformaciones (World, View, Projection). */
     CBChangesEveryFrame m_model;
 
-    /** @brief Buffer constante en GPU que almacena la estructura @c m_model. */
+    /**
+     * @brief Buffer constante en GPU que almacena la estructura @c m_model.
+     * Slo lo usa @c render(); se crea en su primera llamada porque @c submit() sube
+     * @c m_model al anillo de constantes de la cola.
+     */
     Buffer m_modelBuffer;
 
+    /** @brief Dispositivo para crear @c m_modelBuffer bajo demanda (no propietario). */
+    Device* m_device = nullptr;
+
     // --- Recursos para Sombras ---
 
     /** @brief Programa de shader especfico para el pase de sombras. */
@@ -178,4 +315,10 @@ private:
 
     /** @brief Bandera que determina si el objeto debe renderizarse en el Shadow Map. */
     bool castShadow = true;
+
+    /** @brief El actor no se mueve y puede fusionarse en pginas estticas. */
+    bool m_static = false;
+
+    /** @brief Su geometra la dibuja un @ref StaticBatcher en lugar de @ref submit. */
+    bool m_staticBatched = false;
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Component.h"
 
 class DeviceContext;
+class RenderQueue;
 
 class
     Entity {
@@ -40,6 +41,14 @@ public:
     virtual void
         render(DeviceContext& deviceContext) = 0;
 
+    /**
+     * @brief Enva los paquetes de dibujo de la entidad a la cola de render.
+     * Por defecto no enva nada (entidades sin geometra).
+     * @param queue Cola del frame actual.
+     */
+    virtual void
+        submit(RenderQueue& queue) {}
+
     /**
      * @brief Mtodo virtual puro para destruir el componente.
      * Libera los recursos asociados al componente.
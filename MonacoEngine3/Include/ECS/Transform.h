@@ -11,6 +11,7 @@ public:
         rotation(),
         scale(),
         matrix(),
+        renderMatrix(),
         Component(ComponentType::TRANSFORM) {
     }
 
@@ -20,6 +21,8 @@ public:
         init() {
         scale.one();
         matrix = XMMatrixIdentity();
+        renderMatrix = XMMatrixIdentity();
+        hasPrevious = false;
     }
 
     // Actualiza el estado del objeto Transform basado en el tiempo transcurrido
@@ -82,6 +85,39 @@ public:
         scale = newSca;
     }
 
+    // Guarda el estado actual como el del paso anterior; se llama al empezar cada paso fijo
+    void
+        beginStep() {
+        prevPosition = position;
+        prevRotation = rotation;
+        prevScale = scale;
+        hasPrevious = true;
+    }
+
+    // Calcula renderMatrix entre el paso anterior y el actual
+    // @param alpha: Fraccin de paso pendiente en [0, 1) (0 = estado anterior)
+    void
+        interpolate(float alpha) {
+        // Sin paso anterior o sin movimiento (lo habitual) basta con la matriz del paso
+        if (!hasPrevious ||
+            (memcmp(&prevPosition, &position, sizeof(EU::Vector3)) == 0 &&
+             memcmp(&prevRotation, &rotation, sizeof(EU::Vector3)) == 0 &&
+             memcmp(&prevScale, &scale, sizeof(EU::Vector3)) == 0)) {
+            renderMatrix = matrix;
+            return;
+        }
+        XMVECTOR position0 = XMVectorSet(prevPosition.x, prevPosition.y, prevPosition.z, 0.0f);
+        XMVECTOR position1 = XMVectorSet(position.x, position.y, position.z, 0.0f);
+        XMVECTOR scale0 = XMVectorSet(prevScale.x, prevScale.y, prevScale.z, 0.0f);
+        XMVECTOR scale1 = XMVectorSet(scale.x, scale.y, scale.z, 0.0f);
+        // La rotacin por cuaterniones: interpolar los ngulos de Euler gira por el camino largo
+        XMVECTOR rotation0 = XMQuaternionRotationRollPitchYaw(prevRotation.x, prevRotation.y, prevRotation.z);
+        XMVECTOR rotation1 = XMQuaternionRotationRollPitchYaw(rotation.x, rotation.y, rotation.z);
+        renderMatrix = XMMatrixScalingFromVector(XMVectorLerp(scale0, scale1, alpha)) *
+            XMMatrixRotationQuaternion(XMQuaternionSlerp(rotation0, rotation1, alpha)) *
+            XMMatrixTranslationFromVector(XMVectorLerp(position0, position1, alpha));
+    }
+
     // Mtodo para trasladar la posicin del objeto
     // @param translation: Vector que representa la cantidad de traslado en cada eje
     void
@@ -92,6 +128,13 @@ private:
     EU::Vector3 rotation;  // Rotacin del objeto
     EU::Vector3 scale;     // Escala del objeto
 
+    // Estado del paso fijo anterior (doble buffer para interpolar)
+    EU::Vector3 prevPosition;
+    EU::Vector3 prevRotation;
+    EU::Vector3 prevScale;
+    bool hasPrevious = false;
+
 public:
     XMMATRIX matrix;    // Matriz de transformacin
+    XMMATRIX renderMatrix;  // Matriz interpolada entre pasos: la que se dibuja
 };
\ No newline at end of file
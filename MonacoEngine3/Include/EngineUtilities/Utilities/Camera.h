@@ -212,6 +212,31 @@ public:
     [[nodiscard]] float getFarZ()   const { return m_farPlane; }
 
 
+    // -----------------------------------------------------------------------------
+    // CASCADAS DE SOMBRA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Distancias de corte entre cascadas (esquema "prctico": mezcla de reparto
+     * logartmico y uniforme).
+     * @param count Nmero de cascadas.
+     * @param maxDistance Distancia mxima con sombra (se recorta al plano lejano).
+     * @param lambda 0 = uniforme, 1 = logartmico.
+     * @param splits Salida con @p count + 1 distancias de vista; splits[0] es el plano cercano.
+     */
+    void
+        computeCascadeSplits(unsigned int count, float maxDistance, float lambda, float* splits) const;
+
+
+    /**
+     * @brief Esquinas en espacio de mundo del tramo del frustum entre dos distancias de vista.
+     * Usa la base de la ltima llamada a @c updateViewMatrix().
+     * @param corners Salida de 8 esquinas: las 4 cercanas y despus las 4 lejanas.
+     */
+    void
+        getFrustumCorners(float nearZ, float farZ, XMFLOAT3* corners) const;
+
+
     // -----------------------------------------------------------------------------
     // UTILIDADES
     // -----------------------------------------------------------------------------
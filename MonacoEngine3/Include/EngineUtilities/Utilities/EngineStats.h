@@ -0,0 +1,229 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <mutex>
+
+// =================================================================================
+// ESTRUCTURAS: ESTADSTICAS
+// =================================================================================
+
+/**
+ * @enum StatType
+ * @brief Un contador vuelve a 0 en cada frame; un gauge conserva su valor.
+ */
+enum class StatType {
+    Counter,    ///< Eventos del frame: draws, tringulos, subidas...
+    Gauge       ///< Estado actual: memoria de texturas, recursos cargados...
+};
+
+
+/**
+ * @class StatValue
+ * @brief Valor registrado en @c EngineStats; su direccin no cambia mientras viva el proceso.
+ *
+ * Se puede sumar desde cualquier hilo (p. ej. contextos diferidos): es un atmico relajado.
+ */
+class StatValue {
+
+public:
+
+    StatValue(const std::string& name, StatType type) : m_name(name), m_type(type) {}
+
+    StatValue(const StatValue&) = delete;
+    StatValue& operator=(const StatValue&) = delete;
+
+    void
+        add(long long value = 1) { m_value.fetch_add(value, std::memory_order_relaxed); }
+
+    void
+        set(long long value) { m_value.store(value, std::memory_order_relaxed); }
+
+    /** @brief Valor en curso (el frame abierto, para un contador). */
+    long long
+        get() const { return m_value.load(std::memory_order_relaxed); }
+
+    const std::string&
+        getName() const { return m_name; }
+
+    StatType
+        getType() const { return m_type; }
+
+private:
+
+    friend class EngineStats;
+
+    std::string m_name;
+
+    StatType m_type;
+
+    std::atomic<long long> m_value{ 0 };
+
+    /** @brief Valor al cerrar el ltimo frame (lo que muestran el overlay y el CSV). */
+    long long m_lastFrame = 0;
+
+};
+
+
+/**
+ * @struct StatSnapshot
+ * @brief Copia de una estadstica al cerrar el ltimo frame.
+ */
+struct StatSnapshot {
+    std::string name;
+    StatType type = StatType::Counter;
+    long long value = 0;
+};
+
+
+// =================================================================================
+// CLASE: ENGINE STATS
+// =================================================================================
+
+/**
+ * @class EngineStats
+ * @brief Registro de contadores y gauges con nombre, cerrado una vez por frame.
+ *
+ * El cdigo que dibuja o crea recursos suma con @c ENGINE_STAT_ADD / @c ENGINE_GAUGE_ADD,
+ * que buscan el valor una sola vez (esttico local) y despus slo hacen un atmico.
+ * @c endFrame() guarda el valor del frame de cada uno, pone a 0 los contadores y, si hay
+ * un CSV abierto, escribe una fila.
+ */
+class EngineStats {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // PATRN SINGLETON
+    // -----------------------------------------------------------------------------
+
+    static EngineStats&
+        getInstance()
+    {
+        static EngineStats instance;
+        return instance;
+    }
+
+    EngineStats(const EngineStats&) = delete;
+    EngineStats& operator=(const EngineStats&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // REGISTRO
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Contador con ese nombre (lo crea la primera vez).
+     */
+    StatValue&
+        counter(const std::string& name) { return find(name, StatType::Counter); }
+
+
+    /**
+     * @brief Gauge con ese nombre (lo crea la primera vez).
+     */
+    StatValue&
+        gauge(const std::string& name) { return find(name, StatType::Gauge); }
+
+
+    // -----------------------------------------------------------------------------
+    // FRAME
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Cierra el frame: guarda los valores, reinicia los contadores y escribe el CSV.
+     * @param frameMs Duracin del frame, primera columna del CSV.
+     */
+    void
+        endFrame(double frameMs);
+
+
+    // -----------------------------------------------------------------------------
+    // CSV
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Empieza a escribir una fila por frame en @p fileName.
+     * Las columnas se fijan en la primera fila; lo registrado despus no se escribe.
+     */
+    bool
+        startCsv(const std::string& fileName);
+
+
+    void
+        stopCsv();
+
+
+    bool
+        isLoggingCsv() const { return m_csv.is_open(); }
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Valores del ltimo frame cerrado, en orden de registro.
+     */
+    void
+        getSnapshot(std::vector<StatSnapshot>& out) const;
+
+
+    /** @brief Frames cerrados desde el arranque. */
+    unsigned long long
+        getFrameCount() const { return m_frames; }
+
+
+private:
+
+    EngineStats() = default;
+
+    ~EngineStats() { stopCsv(); }
+
+
+    StatValue&
+        find(const std::string& name, StatType type);
+
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    /** @brief Protege la lista (registro, cierre de frame y lectura). */
+    mutable std::mutex m_mutex;
+
+    /** @brief deque: aadir no mueve los valores ya entregados. */
+    std::deque<StatValue> m_values;
+
+    unsigned long long m_frames = 0;
+
+    std::ofstream m_csv;
+
+    /** @brief Columnas del CSV (0 hasta escribir la cabecera). */
+    size_t m_csvColumns = 0;
+
+};
+
+
+// =================================================================================
+// MACROS
+// =================================================================================
+
+#define MONACO_STAT_JOIN_(a, b) a##b
+#define MONACO_STAT_JOIN(a, b) MONACO_STAT_JOIN_(a, b)
+
+/** @brief Suma @p value al contador @p name (literal) en este frame. */
+#define ENGINE_STAT_ADD(name, value) \
+    do { \
+        static StatValue& MONACO_STAT_JOIN(stat_, __LINE__) = EngineStats::getInstance().counter(name); \
+        MONACO_STAT_JOIN(stat_, __LINE__).add(value); \
+    } while (0)
+
+/** @brief Suma (o resta) @p value al gauge @p name (literal). */
+#define ENGINE_GAUGE_ADD(name, value) \
+    do { \
+        static StatValue& MONACO_STAT_JOIN(gauge_, __LINE__) = EngineStats::getInstance().gauge(name); \
+        MONACO_STAT_JOIN(gauge_, __LINE__).add(value); \
+    } while (0)
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Prerequisites.h"
+
+// =================================================================================
+// ESTRUCTURAS: PASO FIJO
+// =================================================================================
+
+/**
+ * @struct FixedTimestepSettings
+ * @brief Duracin del paso y tope de pasos por frame.
+ */
+struct FixedTimestepSettings {
+    float stepSeconds = 1.0f / 60.0f;   ///< Duracin de cada paso de simulacin.
+    unsigned int maxStepsPerFrame = 8;  ///< Tope contra la espiral de la muerte.
+    float maxFrameSeconds = 0.25f;      ///< Un frame ms largo (depurador, carga) cuenta como este.
+};
+
+
+/**
+ * @struct FixedTimestepStats
+ * @brief Contadores desde el ltimo @c reset().
+ */
+struct FixedTimestepStats {
+    unsigned long long frames = 0;
+    unsigned long long steps = 0;
+    unsigned int stepsLastFrame = 0;
+    unsigned int framesClamped = 0;     ///< Frames en los que se descart tiempo pendiente.
+    double droppedSeconds = 0.0;        ///< Tiempo descartado por los topes.
+};
+
+
+// =================================================================================
+// CLASE: FIXED TIMESTEP
+// =================================================================================
+
+/**
+ * @class FixedTimestep
+ * @brief Acumulador que convierte el tiempo de frame en pasos de simulacin de duracin fija.
+ *
+ * Cada frame suma su duracin al acumulador y devuelve cuntos pasos completos caben; lo
+ * que sobra queda para el siguiente frame y, dividido por el paso, es el @c alpha con el que
+ * se interpola entre el estado anterior y el actual. As la simulacin avanza igual a
+ * 30 Hz que a 240 Hz de pantalla y su coste por segundo no depende del refresco.
+ *
+ * Si un frame pide ms de @c maxStepsPerFrame pasos (la simulacin no da abasto) se
+ * ejecuta el tope y se descarta el resto: la simulacin va ms lenta que el reloj en
+ * lugar de pedir cada vez ms pasos por frame. Slo aritmtica, sin reloj propio.
+ */
+class FixedTimestep {
+
+public:
+
+    FixedTimestep() = default;
+
+    ~FixedTimestep() = default;
+
+
+    /**
+     * @brief Cambia los ajustes; el tiempo acumulado se conserva (recortado a un paso).
+     */
+    void
+        setSettings(const FixedTimestepSettings& settings);
+
+
+    const FixedTimestepSettings&
+        getSettings() const { return m_settings; }
+
+
+    /**
+     * @brief Vaca el acumulador y los contadores.
+     */
+    void
+        reset();
+
+
+    /**
+     * @brief Suma el tiempo de un frame y devuelve los pasos a ejecutar.
+     * @param frameSeconds Duracin del frame (negativa cuenta como 0).
+     */
+    unsigned int
+        advance(float frameSeconds);
+
+
+    float
+        getStepSeconds() const { return m_settings.stepSeconds; }
+
+
+    /**
+     * @brief Fraccin de paso pendiente tras @c advance(), en [0, 1).
+     * 0 = mostrar el ltimo estado simulado; cerca de 1 = casi el siguiente.
+     */
+    float
+        getAlpha() const { return m_alpha; }
+
+
+    const FixedTimestepStats&
+        getStats() const { return m_stats; }
+
+
+private:
+
+    FixedTimestepSettings m_settings;
+
+    /** @brief Tiempo pendiente de simular (double: no pierde precisin en sesiones largas). */
+    double m_accumulator = 0.0;
+
+    float m_alpha = 0.0f;
+
+    FixedTimestepStats m_stats;
+
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace EU {
+
+    /** @brief Semilla estndar de FNV-1a de 64 bits. */
+    const uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+
+    /** @brief Primo de FNV-1a de 64 bits. */
+    const uint64_t kFnvPrime = 1099511628211ull;
+
+
+    /**
+     * @brief Hash FNV-1a de 64 bits sobre un bloque de bytes.
+     *
+     * Rpido y sin tablas; suficiente para claves de cach (no criptogrfico).
+     * Encadenable: pasar el resultado anterior como @p seed combina varios bloques.
+     * Las estructuras deben inicializarse a cero (`= {}`) para que el relleno no vare.
+     * @param data Bytes a procesar.
+     * @param size Nmero de bytes.
+     * @param seed Hash previo o @c kFnvOffsetBasis.
+     */
+    inline uint64_t
+        fnv1a64(const void* data, size_t size, uint64_t seed = kFnvOffsetBasis) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= kFnvPrime;
+        }
+        return hash;
+    }
+
+
+    /**
+     * @brief Hash FNV-1a de un valor trivialmente copiable (struct, puntero, entero...).
+     */
+    template<typename T>
+    inline uint64_t
+        hashValue(const T& value, uint64_t seed = kFnvOffsetBasis) {
+        return fnv1a64(&value, sizeof(T), seed);
+    }
+
+} // namespace EU
@@ -0,0 +1,236 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "EngineUtilities/Utilities/BlockCompressor.h"
+
+class ThreadPool;
+
+// =================================================================================
+// ESTRUCTURAS: IMPORTACIN DE IMGENES
+// =================================================================================
+
+/**
+ * @struct ImageImportSettings
+ * @brief Qu se genera a partir de la imagen original. Todo forma parte de la clave de la cach.
+ */
+struct ImageImportSettings {
+    BcFormat compression = BcFormat::None;  ///< BCn (o RGBA8 si el tamao no es mltiplo de 4).
+    bool generateMips = true;               ///< Cadena completa (ver @c MipGenerator).
+    bool srgb = true;                       ///< Filtrar los mips en lineal; false para mscaras y normales.
+    ThreadPool* threadPool = nullptr;       ///< Hilos para filtrar y comprimir (nullptr = en serie).
+    bool useCache = true;                   ///< false: decodifica siempre y no escribe nada.
+};
+
+
+/**
+ * @struct ImageCacheStats
+ * @brief Aciertos de la cach y coste de cada camino.
+ */
+struct ImageCacheStats {
+    unsigned int imports = 0;
+    unsigned int hits = 0;                  ///< Servidas desde un archivo de la cach.
+    unsigned int misses = 0;                ///< Decodificadas con stb_image.
+    unsigned int writeErrors = 0;           ///< Fallos al guardar un blob o un DDS (la importacin sigue).
+    unsigned int ddsExports = 0;            ///< Copias .dds escritas junto a los blobs.
+    unsigned long long sourceBytes = 0;     ///< Bytes originales ledos para el hash.
+    unsigned long long mappedBytes = 0;     ///< Bytes de la cach servidos sin copia.
+    unsigned long long writtenBytes = 0;
+    double hitMs = 0.0;                     ///< Hash y mapeo de los aciertos.
+    double missMs = 0.0;                    ///< Decodificacin, mips, compresin y escritura de los fallos.
+};
+
+
+/**
+ * @struct ImportedLevel
+ * @brief Un nivel dentro de los datos de @c ImportedImage.
+ */
+struct ImportedLevel {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    unsigned int rowPitch = 0;  ///< Bytes por fila (de pxeles o de bloques).
+    size_t offset = 0;          ///< Bytes desde @c ImportedImage::getData().
+};
+
+
+// =================================================================================
+// CLASE: MAPPED FILE
+// =================================================================================
+
+/**
+ * @class MappedFile
+ * @brief Archivo completo proyectado en memoria de slo lectura; se desproyecta al destruirse.
+ */
+class MappedFile {
+
+public:
+
+    MappedFile() = default;
+
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile&
+        operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other);
+
+    MappedFile&
+        operator=(MappedFile&& other);
+
+
+    /**
+     * @brief Proyecta @p path entero.
+     * @return false si no existe, est vaco o no se puede proyectar.
+     */
+    bool
+        open(const std::string& path);
+
+
+    void
+        close();
+
+
+    bool
+        isOpen() const { return m_data != nullptr; }
+
+
+    const unsigned char*
+        getData() const { return m_data; }
+
+
+    size_t
+        getSize() const { return m_size; }
+
+
+private:
+
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+
+};
+
+
+// =================================================================================
+// CLASE: IMPORTED IMAGE
+// =================================================================================
+
+/**
+ * @class ImportedImage
+ * @brief Cadena de niveles lista para @c CreateTexture2D.
+ *
+ * Si vino de la cach, los datos son la proyeccin del archivo (sin copia) y slo valen
+ * mientras el objeto vive: hay que subirlos antes de destruirlo.
+ */
+class ImportedImage {
+
+public:
+
+    /** @brief Un @c D3D11_SUBRESOURCE_DATA por nivel. */
+    void
+        getSubresources(std::vector<D3D11_SUBRESOURCE_DATA>& out) const;
+
+
+    const unsigned char*
+        getData() const { return m_mapped.isOpen() ? m_mapped.getData() + m_dataOffset : m_owned.data(); }
+
+
+    /** @brief Suelta los datos (y la proyeccin). */
+    void
+        reset();
+
+
+    DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    std::vector<ImportedLevel> levels;
+    bool fromCache = false;
+
+
+private:
+
+    friend class ImageImporter;
+
+    std::vector<unsigned char> m_owned;
+    MappedFile m_mapped;
+    size_t m_dataOffset = 0;    ///< Inicio de los niveles dentro de la proyeccin.
+
+};
+
+
+// =================================================================================
+// CLASE: IMAGE IMPORTER
+// =================================================================================
+
+/**
+ * @class ImageImporter
+ * @brief nico camino de importacin de PNG/JPG: decodifica, genera mips, comprime y cachea.
+ *
+ * El original se proyecta en memoria y se le calcula un hash FNV-1a junto con la versin
+ * del formato y los ajustes. La clave nombra un blob en @c TextureCache/ con la cadena ya
+ * en su formato de GPU; si existe y su cabecera coincide, se devuelve proyectado y los
+ * niveles se suben directamente desde el archivo, sin stb_image ni copias intermedias.
+ * Si no, se decodifica desde la proyeccin, se filtra (@c MipGenerator), se comprime
+ * (@c BlockCompressor) y se escribe el blob para la prxima vez.
+ *
+ * Formato del blob (little-endian): cabecera (magic, versin, clave, formato DXGI,
+ * tamao y niveles), tabla de niveles y los datos alineados a 16 bytes. La misma cadena
+ * se puede exportar a un DDS estndar con @c exportDds().
+ *
+ * Se puede llamar desde varios hilos: los blobs se escriben en un temporal y se renombran,
+ * y los contadores se protegen con un mutex.
+ */
+class ImageImporter {
+
+public:
+
+    /**
+     * @brief Importa un archivo de imagen.
+     * @param error Si no es nullptr, recibe el motivo del fallo.
+     * @return false si no se puede leer o decodificar.
+     */
+    static bool
+        importFile(const std::string& path,
+                   const ImageImportSettings& settings,
+                   ImportedImage& out,
+                   std::string* error = nullptr);
+
+
+    /**
+     * @brief Guarda la cadena en un DDS (cabecera DX10) para abrirla con herramientas externas.
+     * @param error Si no es nullptr, recibe el motivo del fallo.
+     * @return false si el formato no es de la cach o no se puede escribir.
+     */
+    static bool
+        exportDds(const ImportedImage& image, const std::string& path, std::string* error = nullptr);
+
+
+    /**
+     * @brief Con true, cada importacin con cach deja tambin un .dds junto a su blob
+     * (si an no existe). El motor sigue leyendo slo el blob.
+     */
+    static void
+        setDdsExport(bool enabled);
+
+
+    /**
+     * @brief Ruta del blob en la cach para un original con ese hash.
+     */
+    static std::string
+        getCachePath(const std::string& path, uint64_t key, const ImageImportSettings& settings);
+
+
+    /** @brief Suma de todas las importaciones desde el arranque. */
+    static ImageCacheStats
+        getTotals();
+
+
+    /**
+     * @brief Resumen de una lnea ("hits, misses, bytes, tiempos") para el log.
+     */
+    static std::string
+        getReport();
+
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Prerequisites.h"
+
+class ThreadPool;
+
+// =================================================================================
+// ESTRUCTURAS: CADENA DE MIPS
+// =================================================================================
+
+/**
+ * @enum MipFilter
+ * @brief Filtro de reduccin entre niveles.
+ */
+enum class MipFilter {
+    Box,        ///< Media del rea que cubre cada texel (2x2 en potencias de dos). Rpido.
+    Kaiser      ///< Sinc con ventana de Kaiser (6 taps a 2:1): ms ntido y sin aliasing.
+};
+
+
+/**
+ * @struct MipSettings
+ * @brief Cmo se filtra la cadena.
+ */
+struct MipSettings {
+    MipFilter filter = MipFilter::Box;
+    bool srgb = true;                       ///< RGB codificado en sRGB: se filtra en lineal. El alfa siempre es lineal.
+    ThreadPool* threadPool = nullptr;       ///< Reparte filas entre hilos (nullptr = en serie).
+    unsigned int minParallelPixels = 256 * 256; ///< Por debajo, un nivel se filtra en serie.
+};
+
+
+/**
+ * @struct MipLevel
+ * @brief Un nivel dentro de @c MipChain::data.
+ */
+struct MipLevel {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    size_t offset = 0;          ///< Bytes desde el inicio de @c MipChain::data.
+};
+
+
+/**
+ * @struct MipChain
+ * @brief Cadena completa RGBA8 (nivel 0 incluido) en un solo bloque, lista para subir.
+ */
+struct MipChain {
+    std::vector<unsigned char> data;
+    std::vector<MipLevel> levels;
+
+    /**
+     * @brief Un @c D3D11_SUBRESOURCE_DATA por nivel para @c CreateTexture2D.
+     */
+    void
+        getSubresources(std::vector<D3D11_SUBRESOURCE_DATA>& out) const
+    {
+        out.resize(levels.size());
+        for (size_t i = 0; i < levels.size(); ++i) {
+            out[i].pSysMem = data.data() + levels[i].offset;
+            out[i].SysMemPitch = levels[i].width * 4;
+            out[i].SysMemSlicePitch = 0;
+        }
+    }
+};
+
+
+/**
+ * @struct MipStats
+ * @brief Coste de generar una o varias cadenas.
+ */
+struct MipStats {
+    unsigned int chains = 0;
+    unsigned long long sourcePixels = 0;    ///< Pxeles del nivel 0 procesados.
+    unsigned long long outputPixels = 0;    ///< Pxeles generados (niveles 1..N).
+    double ms = 0.0;
+
+    /** @brief Megapxeles de origen por segundo. */
+    double
+        megapixelsPerSecond() const { return ms > 0.0 ? sourcePixels / (ms * 1000.0) : 0.0; }
+};
+
+
+// =================================================================================
+// CLASE: MIP GENERATOR
+// =================================================================================
+
+/**
+ * @class MipGenerator
+ * @brief Genera en CPU la cadena de mips de una imagen RGBA8 al importarla.
+ *
+ * Cada nivel se obtiene del anterior con un filtro separable (horizontal y despus
+ * vertical) en coma flotante y en espacio lineal: promediar valores sRGB oscurece los
+ * bordes y las texturas de alto contraste. Un pxel RGBA lineal cabe en un registro SSE, as
+ * que cada tap es una multiplicacin y una suma vectoriales. Los taps de cada columna y
+ * fila se calculan una vez por nivel, lo que tambin resuelve tamaos impares.
+ *
+ * Con @c MipSettings::threadPool las filas de cada pase se reparten entre hilos. Las
+ * estadsticas acumuladas de todas las cadenas se consultan con @c getTotals().
+ */
+class MipGenerator {
+
+public:
+
+    /**
+     * @brief Niveles de la cadena completa hasta 1x1.
+     */
+    static unsigned int
+        getLevelCount(unsigned int width, unsigned int height);
+
+
+    /**
+     * @brief Genera la cadena completa.
+     * @param rgba Nivel 0, @p width x @p height pxeles RGBA8 sin relleno entre filas.
+     * @param out Se sobrescribe con la cadena (nivel 0 copiado).
+     * @param stats Si no es nullptr, recibe el coste de esta cadena.
+     * @return false si la imagen est vaca.
+     */
+    static bool
+        generate(const unsigned char* rgba,
+                 unsigned int width,
+                 unsigned int height,
+                 const MipSettings& settings,
+                 MipChain& out,
+                 MipStats* stats = nullptr);
+
+
+    /** @brief Suma de todas las cadenas generadas desde el arranque. */
+    static MipStats
+        getTotals();
+
+};
@@ -0,0 +1,415 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "EngineUtilities/Utilities/TraceCapture.h"
+#include <atomic>
+#include <unordered_set>
+
+class Device;
+class DeviceContext;
+
+// =================================================================================
+// CONFIGURACIN
+// =================================================================================
+
+// Las configuraciones Debug y Profile definen PROFILE; en Release las macros no generan
+// cdigo. Se puede forzar con /DMONACO_PROFILING=0 o 1.
+#ifndef MONACO_PROFILING
+#if defined(PROFILE)
+#define MONACO_PROFILING 1
+#else
+#define MONACO_PROFILING 0
+#endif
+#endif
+
+
+// =================================================================================
+// ESTRUCTURAS: DATOS DEL PROFILER
+// =================================================================================
+
+/**
+ * @struct ProfileEvent
+ * @brief Un scope medido dentro de un frame.
+ */
+struct ProfileEvent {
+    const char* name = nullptr;     ///< Literal o nombre de @c Profiler::internName().
+    double startMs = 0.0;           ///< Desde el inicio del frame.
+    double endMs = 0.0;
+    unsigned int depth = 0;         ///< 0 = scope de primer nivel.
+    int parent = -1;                ///< ndice del scope que lo contiene en la misma lista.
+};
+
+
+/**
+ * @struct ProfileFrame
+ * @brief Scopes de CPU y GPU de un frame.
+ *
+ * Los de GPU llegan unos frames despus (las consultas no se leen hasta que la GPU
+ * las alcanza); mientras tanto @c gpuReady es false.
+ */
+struct ProfileFrame {
+    unsigned long long index = 0;   ///< Nmero de frame del profiler.
+    double cpuMs = 0.0;             ///< De @c beginFrame() a @c endFrame().
+    double gpuMs = 0.0;             ///< Entre los timestamps de inicio y fin del frame.
+    bool gpuReady = false;          ///< Los tiempos de GPU ya se leyeron y son vlidos.
+    std::vector<ProfileEvent> cpuEvents;
+    std::vector<ProfileEvent> gpuEvents;
+};
+
+
+/**
+ * @struct ProfilerStats
+ * @brief Contadores acumulados desde @c init().
+ */
+struct ProfilerStats {
+    unsigned long long frames = 0;
+    unsigned long long cpuScopes = 0;
+    unsigned long long gpuScopes = 0;
+    unsigned long long droppedScopes = 0;       ///< Scopes fuera de capacidad o de profundidad.
+    unsigned long long gpuFramesResolved = 0;
+    unsigned long long gpuFramesDisjoint = 0;   ///< Frames cuyo reloj de GPU no fue estable.
+    unsigned long long gpuFramesLost = 0;       ///< Consultas que no llegaron a tiempo y se reciclaron.
+    double scopeCostUs = 0.0;                   ///< Coste medido de un par begin/end de CPU.
+    double overheadMs = 0.0;                    ///< Estimacin del coste total de los scopes de CPU.
+};
+
+
+// =================================================================================
+// CLASE: PROFILER
+// =================================================================================
+
+/**
+ * @class Profiler
+ * @brief Tiempos jerrquicos de CPU y GPU por frame en un buffer circular.
+ *
+ * Los scopes de CPU los abre @c PROFILE_SCOPE (RAII) en el hilo que llama a
+ * @c beginFrame(); en otros hilos no hacen nada. Cada uno cuesta dos lecturas de
+ * @c QueryPerformanceCounter y una escritura en un vector ya reservado: sin reservas ni
+ * bloqueos dentro del frame.
+ *
+ * Los de GPU (@c PROFILE_GPU_SCOPE) escriben timestamps de D3D11 en el contexto
+ * inmediato dentro de una consulta @c TIMESTAMP_DISJOINT por frame. Hay
+ * @c kGpuLatency juegos de consultas en vuelo; cada @c beginFrame() lee sin bloquear los
+ * que ya termin la GPU y los pasa al frame de la historia que les corresponde.
+ *
+ * Con @c MONACO_PROFILING a 0 las macros desaparecen y la clase slo queda vaca.
+ */
+class Profiler {
+
+public:
+
+    /** @brief Frames que guarda la historia. */
+    static const unsigned int kHistory = 128;
+
+    /** @brief Juegos de consultas de GPU en vuelo. */
+    static const unsigned int kGpuLatency = 4;
+
+    /** @brief Scopes de CPU por frame; los que sobran se descartan. */
+    static const unsigned int kMaxCpuScopes = 512;
+
+    /** @brief Scopes de GPU por frame. */
+    static const unsigned int kMaxGpuScopes = 64;
+
+    /** @brief Anidamiento mximo. */
+    static const unsigned int kMaxDepth = 32;
+
+
+    // -----------------------------------------------------------------------------
+    // PATRN SINGLETON
+    // -----------------------------------------------------------------------------
+
+    static Profiler&
+        getInstance()
+    {
+        static Profiler instance;
+        return instance;
+    }
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Reserva la historia, mide el coste de un scope y crea las consultas de GPU.
+     * @param device Sin dispositivo (o si las consultas fallan) slo se mide la CPU.
+     */
+    HRESULT
+        init(Device* device);
+
+
+    /**
+     * @brief Libera las consultas y vaca la historia.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // CONTROL
+    // -----------------------------------------------------------------------------
+
+    void
+        setEnabled(bool enabled) { m_enabled = enabled; }
+
+    bool
+        isEnabled() const { return m_enabled; }
+
+
+    /**
+     * @brief En pausa no se graban frames nuevos y la historia queda fija para inspeccionarla.
+     */
+    void
+        setPaused(bool paused) { m_paused = paused; }
+
+    bool
+        isPaused() const { return m_paused; }
+
+
+    // -----------------------------------------------------------------------------
+    // FRAME
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Abre un frame en el hilo actual; recoge los tiempos de GPU que ya estn listos.
+     * @param deviceContext Contexto inmediato, o nullptr para medir slo la CPU.
+     */
+    void
+        beginFrame(DeviceContext* deviceContext);
+
+
+    /**
+     * @brief Cierra el frame abierto con @c beginFrame().
+     */
+    void
+        endFrame(DeviceContext* deviceContext);
+
+
+    /**
+     * @brief Abre un scope de CPU.
+     * @param name Debe vivir mientras el frame est en la historia (literal o @c internName()).
+     * @return Identificador para @c endScope(), o -1 si no se graba.
+     */
+    int
+        beginScope(const char* name);
+
+
+    void
+        endScope(int scope);
+
+
+    /**
+     * @brief Escribe el timestamp de inicio de un scope de GPU (slo en el contexto inmediato).
+     * @return Identificador para @c endGpuScope(), o -1 si no se graba.
+     */
+    int
+        beginGpuScope(DeviceContext& deviceContext, const char* name);
+
+
+    void
+        endGpuScope(DeviceContext& deviceContext, int scope);
+
+
+    /**
+     * @brief Copia estable de un nombre construido en tiempo de ejecucin (p. ej. pases del grafo).
+     * No es seguro entre hilos; llamarlo desde el hilo del frame.
+     */
+    const char*
+        internName(const std::string& name);
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /** @brief Frames completos disponibles en la historia. */
+    unsigned int
+        getFrameCount() const;
+
+
+    /**
+     * @brief Frame de la historia.
+     * @param age 0 = el ltimo frame cerrado, 1 = el anterior...
+     */
+    const ProfileFrame&
+        getFrame(unsigned int age) const;
+
+
+    bool
+        hasGpuTiming() const { return !m_gpuFrames.empty(); }
+
+
+    const ProfilerStats&
+        getStats() const { return m_stats; }
+
+
+private:
+
+    Profiler() = default;
+
+    ~Profiler() = default;
+
+
+    /** @brief Consultas de un frame de GPU en vuelo. */
+    struct GpuFrame {
+        ID3D11Query* disjoint = nullptr;
+        ID3D11Query* frameBegin = nullptr;
+        ID3D11Query* frameEnd = nullptr;
+        std::vector<ID3D11Query*> timestamps;   ///< Dos por scope: inicio y fin.
+        std::vector<ProfileEvent> scopes;       ///< Nombre, profundidad y padre de cada par.
+        unsigned long long frameIndex = 0;
+        bool pending = false;
+    };
+
+
+    /**
+     * @brief Lee un frame de GPU si ya termin.
+     * @return false si la GPU an no lleg a sus consultas.
+     */
+    bool
+        resolveGpuFrame(DeviceContext& deviceContext, GpuFrame& gpuFrame);
+
+
+    /** @brief Ticks de @c QueryPerformanceCounter. */
+    static long long
+        now();
+
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    bool m_enabled = true;
+
+    bool m_paused = false;
+
+    /** @brief Lo leen los hilos del pool en cada PROFILE_SCOPE mientras el principal abre y cierra frames. */
+    std::atomic<bool> m_frameOpen{ false };
+
+    /** @brief Hilo que abri el frame: slo l graba scopes de CPU (slo se escribe si cambia). */
+    std::thread::id m_frameThread;
+
+    double m_msPerTick = 0.0;
+
+    long long m_frameStart = 0;
+
+    /** @brief Frames abiertos desde @c init(); el actual es m_frames[m_frameIndex % kHistory]. */
+    unsigned long long m_frameIndex = 0;
+
+    std::vector<ProfileFrame> m_frames;
+
+    int m_cpuStack[kMaxDepth];
+
+    unsigned int m_cpuDepth = 0;
+
+    std::vector<GpuFrame> m_gpuFrames;
+
+    /** @brief Juego de consultas del frame abierto (nullptr si no se mide la GPU). */
+    GpuFrame* m_gpuCurrent = nullptr;
+
+    int m_gpuStack[kMaxDepth];
+
+    unsigned int m_gpuDepth = 0;
+
+    std::unordered_set<std::string> m_names;
+
+    ProfilerStats m_stats;
+
+};
+
+
+// =================================================================================
+// SCOPES RAII
+// =================================================================================
+
+/**
+ * @class ProfileScope
+ * @brief Scope de CPU que dura lo que el bloque donde se declara.
+ *
+ * Con una @c TraceCapture en curso tambin se graba en la traza, en cualquier hilo.
+ */
+class ProfileScope {
+
+public:
+
+    explicit ProfileScope(const char* name)
+        : m_name(name),
+          m_scope(Profiler::getInstance().beginScope(name)),
+          m_traceStart(TraceCapture::getInstance().beginEvent()) {}
+
+    ~ProfileScope() {
+        if (m_traceStart != 0) {
+            TraceCapture::getInstance().endEvent(m_name, m_traceStart);
+        }
+        if (m_scope >= 0) {
+            Profiler::getInstance().endScope(m_scope);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+
+    const char* m_name;
+
+    int m_scope;
+
+    long long m_traceStart;
+
+};
+
+
+/**
+ * @class GpuProfileScope
+ * @brief Par de timestamps de GPU alrededor del bloque donde se declara.
+ */
+class GpuProfileScope {
+
+public:
+
+    GpuProfileScope(DeviceContext& deviceContext, const char* name)
+        : m_deviceContext(deviceContext),
+          m_scope(Profiler::getInstance().beginGpuScope(deviceContext, name)) {}
+
+    ~GpuProfileScope() {
+        if (m_scope >= 0) {
+            Profiler::getInstance().endGpuScope(m_deviceContext, m_scope);
+        }
+    }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+
+    DeviceContext& m_deviceContext;
+
+    int m_scope;
+
+};
+
+
+// =================================================================================
+// MACROS
+// =================================================================================
+
+#define MONACO_PROFILE_JOIN_(a, b) a##b
+#define MONACO_PROFILE_JOIN(a, b) MONACO_PROFILE_JOIN_(a, b)
+
+#if MONACO_PROFILING
+#define PROFILE_SCOPE(name) ProfileScope MONACO_PROFILE_JOIN(profileScope_, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(context, name) GpuProfileScope MONACO_PROFILE_JOIN(gpuProfileScope_, __LINE__)(context, name)
+#define PROFILE_BEGIN_FRAME(context) (Profiler::getInstance().beginFrame(context), TraceCapture::getInstance().beginFrame())
+#define PROFILE_END_FRAME(context) (Profiler::getInstance().endFrame(context), TraceCapture::getInstance().endFrame())
+#define PROFILE_THREAD_NAME(name) TraceCapture::getInstance().setThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_GPU_SCOPE(context, name) ((void)0)
+#define PROFILE_BEGIN_FRAME(context) ((void)0)
+#define PROFILE_END_FRAME(context) ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// =================================================================================
+// CLASE: THREAD POOL
+// =================================================================================
+
+/**
+ * @class ThreadPool
+ * @brief Hilos persistentes para repartir trabajo en paralelo dentro de un frame.
+ *
+ * Slo ofrece @c parallelFor: el hilo que llama tambin procesa ndices y no vuelve
+ * hasta que todos terminaron, as que no hace falta sincronizacin extra despus.
+ * Crear hilos cada frame cuesta ms que el trabajo que se reparte; por eso viven
+ * desde @c init() hasta @c destroy().
+ */
+class ThreadPool {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    ThreadPool() = default;
+
+    ~ThreadPool() { destroy(); }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Arranca los hilos de trabajo.
+     * @param workerCount Hilos adicionales al que llama; 0 usa (ncleos - 1).
+     */
+    void
+        init(unsigned int workerCount = 0);
+
+
+    /**
+     * @brief Detiene y espera a todos los hilos.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // TRABAJO
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Ejecuta @c task(i) para cada i en [0, count) y espera a que terminen.
+     * Los ndices se reparten dinmicamente; el orden de ejecucin no est definido.
+     * No es reentrante: @c task no debe volver a llamar a @c parallelFor.
+     */
+    void
+        parallelFor(unsigned int count, const std::function<void(unsigned int)>& task);
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /** @brief Hilos que pueden trabajar a la vez (incluido el que llama). */
+    unsigned int
+        getConcurrency() const { return static_cast<unsigned int>(m_workers.size()) + 1; }
+
+
+private:
+
+    /**
+     * @brief Bucle de cada hilo: espera un lote nuevo y toma ndices hasta agotarlos.
+     * @param index Nmero del hilo (nombre en la traza).
+     */
+    void
+        workerLoop(unsigned int index);
+
+
+    /**
+     * @brief Procesa ndices del lote actual hasta que no queden.
+     */
+    void
+        drain();
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    /** @brief Lote actual (slo vlido mientras @c parallelFor no ha vuelto). */
+    const std::function<void(unsigned int)>* m_task = nullptr;
+    unsigned int m_count = 0;
+    std::atomic<unsigned int> m_next{ 0 };
+
+    /** @brief Cambia con cada lote para despertar a los hilos una sola vez. */
+    unsigned long long m_generation = 0;
+
+    /** @brief Hilos que an no terminaron con el lote actual. */
+    unsigned int m_busyWorkers = 0;
+
+    bool m_stop = false;
+
+};
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include <atomic>
+#include <mutex>
+
+// =================================================================================
+// ESTRUCTURAS: EVENTOS DE TRAZA
+// =================================================================================
+
+/**
+ * @struct TraceEvent
+ * @brief Un scope completo (evento "X" de Chrome) en ticks de @c QueryPerformanceCounter.
+ */
+struct TraceEvent {
+    const char* name = nullptr;     ///< Literal o nombre de @c Profiler::internName().
+    long long start = 0;
+    long long end = 0;
+};
+
+
+/**
+ * @struct TraceCaptureStats
+ * @brief Contadores de la ltima captura.
+ */
+struct TraceCaptureStats {
+    unsigned int framesRequested = 0;
+    unsigned int framesCaptured = 0;
+    unsigned int threads = 0;                   ///< Hilos que grabaron al menos un evento.
+    unsigned long long events = 0;
+    unsigned long long droppedEvents = 0;       ///< Eventos que no cupieron en el buffer de su hilo.
+    unsigned long long bytesWritten = 0;
+    double writeMs = 0.0;                       ///< Tiempo del hilo escritor (fuera del frame).
+};
+
+
+// =================================================================================
+// CLASE: TRACE CAPTURE
+// =================================================================================
+
+/**
+ * @class TraceCapture
+ * @brief Graba los scopes de todos los hilos durante N frames y los vuelca como JSON de
+ * Chrome (chrome://tracing, ui.perfetto.dev).
+ *
+ * Cada hilo escribe en su propio buffer, reservado la primera vez que graba: slo ese
+ * hilo mueve su contador, as que grabar no toma bloqueos ni reserva memoria. Los
+ * scopes llegan de @c PROFILE_SCOPE en cualquier hilo (el profiler en vivo slo mira el
+ * del frame), y los frames de @c PROFILE_BEGIN_FRAME / @c PROFILE_END_FRAME.
+ *
+ * Al cerrar el ltimo frame pedido la captura se detiene y un hilo aparte escribe el
+ * archivo; el frame siguiente no espera. Una captura pedida antes de @c init() del motor
+ * incluye tambin la carga.
+ */
+class TraceCapture {
+
+public:
+
+    /** @brief Eventos que caben en el buffer de cada hilo. */
+    static const unsigned int kEventsPerThread = 1 << 16;
+
+
+    // -----------------------------------------------------------------------------
+    // PATRN SINGLETON
+    // -----------------------------------------------------------------------------
+
+    static TraceCapture&
+        getInstance()
+    {
+        static TraceCapture instance;
+        return instance;
+    }
+
+    TraceCapture(const TraceCapture&) = delete;
+    TraceCapture& operator=(const TraceCapture&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CAPTURA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Empieza a grabar; se detiene sola tras @p frameCount frames.
+     * @param fileName Archivo JSON de salida.
+     * @return false si ya hay una captura en curso o escribindose.
+     */
+    bool
+        start(unsigned int frameCount, const std::string& fileName);
+
+
+    /**
+     * @brief Detiene la captura en curso y lanza la escritura con lo grabado.
+     */
+    void
+        stop();
+
+
+    /**
+     * @brief Espera a que termine de escribirse la ltima captura.
+     */
+    void
+        destroy();
+
+
+    bool
+        isCapturing() const { return m_capturing.load(std::memory_order_relaxed); }
+
+
+    /** @brief La ltima captura an se est escribiendo. */
+    bool
+        isWriting() const { return m_writing.load(std::memory_order_acquire); }
+
+
+    // -----------------------------------------------------------------------------
+    // GRABACIN
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Nombre del hilo actual en la traza (p. ej. "Main", "Worker 2").
+     * Reserva ya su buffer: llamarlo al arrancar el hilo evita hacerlo dentro de un frame.
+     */
+    void
+        setThreadName(const std::string& name);
+
+
+    /**
+     * @brief Marca de inicio de un scope.
+     * @return Ticks actuales, o 0 si no hay captura (el scope no se graba).
+     */
+    long long
+        beginEvent() const
+    {
+        return isCapturing() ? now() : 0;
+    }
+
+
+    /**
+     * @brief Cierra un scope abierto con @c beginEvent() y lo guarda en el buffer del hilo.
+     */
+    void
+        endEvent(const char* name, long long start);
+
+
+    /** @brief Llamado por @c PROFILE_BEGIN_FRAME. */
+    void
+        beginFrame();
+
+
+    /** @brief Llamado por @c PROFILE_END_FRAME; detiene la captura en el ltimo frame pedido. */
+    void
+        endFrame();
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /** @brief Contadores de la ltima captura (vlidos cuando @c isWriting() es false). */
+    TraceCaptureStats
+        getStats() const;
+
+
+    const std::string&
+        getFileName() const { return m_fileName; }
+
+
+private:
+
+    TraceCapture() = default;
+
+    ~TraceCapture() { destroy(); }
+
+
+    /** @brief Buffer de un hilo; vive hasta que termina el proceso. */
+    struct ThreadBuffer {
+        DWORD threadId = 0;
+        std::string name;                           ///< Protegido por @c m_mutex.
+        std::vector<TraceEvent> events;
+        std::atomic<unsigned int> count{ 0 };
+        std::atomic<unsigned int> generation{ 0 };  ///< Captura a la que pertenece @c count.
+        std::atomic<unsigned long long> dropped{ 0 };
+    };
+
+
+    /** @brief Buffer del hilo actual; lo crea la primera vez. */
+    ThreadBuffer&
+        getThreadBuffer();
+
+
+    /**
+     * @brief Escribe el JSON de la captura @p generation (en el hilo escritor).
+     */
+    void
+        write(unsigned int generation, long long captureStart, std::string fileName);
+
+
+    static long long
+        now();
+
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    std::atomic<bool> m_capturing{ false };
+
+    std::atomic<bool> m_writing{ false };
+
+    /** @brief Sube con cada captura; un buffer con otra generacin se vaca al grabar. */
+    std::atomic<unsigned int> m_generation{ 0 };
+
+    long long m_captureStart = 0;
+
+    long long m_frameStart = 0;
+
+    unsigned int m_framesRequested = 0;
+
+    unsigned int m_framesCaptured = 0;
+
+    std::string m_fileName;
+
+    /** @brief Protege la lista de buffers (slo al registrar un hilo y al escribir). */
+    mutable std::mutex m_mutex;
+
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+
+    std::thread m_writer;
+
+    TraceCaptureStats m_stats;
+
+};
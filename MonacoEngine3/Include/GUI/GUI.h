@@ -6,12 +6,15 @@
 #include "imgui_impl_win32.h"
 #include "imgui_impl_dx11.h"
 #include "ImGuizmo.h"
+#include "EngineUtilities/Utilities/EngineStats.h"
 
 class Viewport;
 class Window;
 class Device;
 class DeviceContext;
 class Actor;
+class FramePacer;
+class TextureStreamer;
 
 class
     GUI {
@@ -68,6 +71,32 @@ public:
     void
         drawGizmoToolbar();
 
+    /**
+     * @brief Ventana del profiler: historia de frames, lnea de tiempo por profundidad
+     * (CPU y GPU) y rbol de scopes del frame elegido.
+     */
+    void
+        profilerWindow();
+
+    /**
+     * @brief Overlay compacto con los contadores de @c EngineStats del ltimo frame.
+     * Clic derecho: activar el registro en Stats.csv u ocultarlo (se vuelve a mostrar desde Tools).
+     */
+    void
+        statsOverlay();
+
+    /**
+     * @brief Ajustes del ritmo de frames (FPS objetivo, espera activa, latencia, vsync) y su jitter.
+     */
+    void
+        framePacingWindow(FramePacer& pacer);
+
+    /**
+     * @brief Presupuesto y sesgo del streaming de texturas, residencia y nivel de cada textura.
+     */
+    void
+        textureStreamingWindow(TextureStreamer& streamer);
+
     // Crea una funcin auxiliar para convertir XMMATRIX a lo que ImGuizmo quiere
     void ToFloatArray(const XMMATRIX& mat, float* dest) {
         XMFLOAT4X4 temp;
@@ -83,6 +112,17 @@ private:
 
     bool show_exit_popup = false; // Variable de estado para el popup
 
+    /** @brief Frame del profiler que se inspecciona (0 = el ltimo). */
+    int m_profilerFrameAge = 0;
+
+    /** @brief Frames de la prxima captura de traza. */
+    int m_traceFrames = 120;
+
+    bool m_showStatsOverlay = true;
+
+    /** @brief Copia reutilizada entre frames para no reservar al dibujar el overlay. */
+    std::vector<StatSnapshot> m_statsSnapshot;
+
 
 public:
     int selectedActorIndex = -1;
@@ -73,6 +73,13 @@ struct CBChangesEveryFrame
   XMFLOAT4 vMeshColor;
 };
 
+// Datos por instancia (slot 1). La matriz va sin transponer: el shader la arma por filas.
+struct InstanceData
+{
+  XMFLOAT4X4 mWorld;
+  XMFLOAT4 vMeshColor;
+};
+
 enum ExtensionType {
   DDS = 0,
   PNG = 1,
@@ -0,0 +1,389 @@
+#pragma once
+
+#include "RHI/IRenderBackend.h"
+#include <d3d11_1.h>
+
+class Device;
+class DeviceContext;
+
+// =================================================================================
+// CLASE: D3D11 COMMAND LIST
+// =================================================================================
+
+/**
+ * @class D3D11CommandList
+ * @brief Envoltorio propietario de un @c ID3D11CommandList.
+ */
+class D3D11CommandList : public IRenderCommandList {
+
+public:
+
+    explicit D3D11CommandList(ID3D11CommandList* commandList) : m_commandList(commandList) {}
+
+    ~D3D11CommandList() override { SAFE_RELEASE(m_commandList); }
+
+    ID3D11CommandList*
+        getNative() const { return m_commandList; }
+
+private:
+
+    ID3D11CommandList* m_commandList = nullptr;
+
+};
+
+
+// =================================================================================
+// CLASE: D3D11 RENDER BACKEND
+// =================================================================================
+
+/**
+ * @class D3D11RenderBackend
+ * @brief Implementacin de @c IRenderBackend que reenva todo a Direct3D 11.
+ *
+ * No es propietario del dispositivo ni del contexto: ambos siguen perteneciendo
+ * a @c Device y @c DeviceContext, que los liberan en su @c destroy(). S es dueo
+ * de la interfaz @c ID3D11DeviceContext1 que consulta en @c init() (si existe).
+ */
+class D3D11RenderBackend : public IRenderBackend {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    D3D11RenderBackend() = default;
+
+    /** @brief Suelta la interfaz D3D11.1 (los backends diferidos no pasan por @c destroy()). */
+    ~D3D11RenderBackend() override { SAFE_RELEASE(m_deviceContext1); }
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Enlaza el backend al dispositivo y contexto ya creados.
+     * @param device Dispositivo inicializado (p. ej. por @c SwapChain::init).
+     * @param deviceContext Contexto inmediato asociado.
+     * @return @c S_OK o @c E_POINTER si alguno de los dos no existe.
+     */
+    virtual HRESULT
+        init(Device& device, DeviceContext& deviceContext);
+
+
+    /**
+     * @brief Suelta las referencias no propietarias.
+     */
+    virtual void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // IDENTIFICACIN
+    // -----------------------------------------------------------------------------
+
+    const char*
+        getName() const override { return "D3D11"; }
+
+    bool
+        isHeadless() const override { return false; }
+
+    ID3D11Device*
+        getNativeDevice() const override { return m_device; }
+
+    ID3D11DeviceContext*
+        getNativeContext() const override { return m_deviceContext; }
+
+    bool
+        supportsConstantBufferOffsets() const override { return m_constantBufferOffsets; }
+
+
+    // -----------------------------------------------------------------------------
+    // CONTEXTOS DIFERIDOS
+    // -----------------------------------------------------------------------------
+
+    /** @brief Siempre disponibles: si el driver no los admite el runtime los emula. */
+    bool
+        supportsDeferredContexts() const override { return m_device != nullptr; }
+
+    HRESULT
+        createDeferredContext(DeviceContext& deferredContext,
+                              std::unique_ptr<IRenderBackend>& deferredBackend) override;
+
+    HRESULT
+        finishCommandList(std::unique_ptr<IRenderCommandList>& commandList) override;
+
+    void
+        executeCommandList(IRenderCommandList& commandList) override;
+
+
+    // -----------------------------------------------------------------------------
+    // CREACIN DE RECURSOS
+    // -----------------------------------------------------------------------------
+
+    HRESULT
+        CreateBuffer(const D3D11_BUFFER_DESC* pDesc,
+                     const D3D11_SUBRESOURCE_DATA* pInitialData,
+                     ID3D11Buffer** ppBuffer) override;
+
+    HRESULT
+        CreateTexture2D(const D3D11_TEXTURE2D_DESC* pDesc,
+                        const D3D11_SUBRESOURCE_DATA* pInitialData,
+                        ID3D11Texture2D** ppTexture2D) override;
+
+    HRESULT
+        CreateShaderResourceView(ID3D11Resource* pResource,
+                                 const D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc,
+                                 ID3D11ShaderResourceView** ppSRView) override;
+
+    HRESULT
+        CreateShaderResourceViewFromFile(const std::string& fileName,
+                                         ID3D11ShaderResourceView** ppSRView) override;
+
+    HRESULT
+        CreateRenderTargetView(ID3D11Resource* pResource,
+                               const D3D11_RENDER_TARGET_VIEW_DESC* pDesc,
+                               ID3D11RenderTargetView** ppRTView) override;
+
+    HRESULT
+        CreateDepthStencilView(ID3D11Resource* pResource,
+                               const D3D11_DEPTH_STENCIL_VIEW_DESC* pDesc,
+                               ID3D11DepthStencilView** ppDepthStencilView) override;
+
+    HRESULT
+        CreateVertexShader(const void* pShaderBytecode,
+                           SIZE_T BytecodeLength,
+                           ID3D11ClassLinkage* pClassLinkage,
+                           ID3D11VertexShader** ppVertexShader) override;
+
+    HRESULT
+        CreatePixelShader(const void* pShaderBytecode,
+                          SIZE_T BytecodeLength,
+                          ID3D11ClassLinkage* pClassLinkage,
+                          ID3D11PixelShader** ppPixelShader) override;
+
+    HRESULT
+        CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* pInputElementDescs,
+                          UINT NumElements,
+                          const void* pShaderBytecodeWithInputSignature,
+                          SIZE_T BytecodeLength,
+                          ID3D11InputLayout** ppInputLayout) override;
+
+    HRESULT
+        CreateSamplerState(const D3D11_SAMPLER_DESC* pSamplerDesc,
+                           ID3D11SamplerState** ppSamplerState) override;
+
+    HRESULT
+        CreateBlendState(const D3D11_BLEND_DESC* pBlendStateDesc,
+                         ID3D11BlendState** ppBlendState) override;
+
+    HRESULT
+        CreateRasterizerState(const D3D11_RASTERIZER_DESC* pRasterizerDesc,
+                              ID3D11RasterizerState** ppRasterizerState) override;
+
+    HRESULT
+        CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* pDepthStencilDesc,
+                                ID3D11DepthStencilState** ppDepthStencilState) override;
+
+    HRESULT
+        CheckMultisampleQualityLevels(DXGI_FORMAT Format,
+                                      UINT SampleCount,
+                                      UINT* pNumQualityLevels) override;
+
+    HRESULT
+        CreateQuery(const D3D11_QUERY_DESC* pQueryDesc,
+                    ID3D11Query** ppQuery) override;
+
+
+    // -----------------------------------------------------------------------------
+    // COMANDOS DE CONTEXTO
+    // -----------------------------------------------------------------------------
+
+    void
+        RSSetViewports(unsigned int NumViewports, const D3D11_VIEWPORT* pViewports) override;
+
+    void
+        RSSetState(ID3D11RasterizerState* pRasterizerState) override;
+
+    void
+        IASetInputLayout(ID3D11InputLayout* pInputLayout) override;
+
+    void
+        IASetVertexBuffers(unsigned int StartSlot,
+                           unsigned int NumBuffers,
+                           ID3D11Buffer* const* ppVertexBuffers,
+                           const unsigned int* pStrides,
+                           const unsigned int* pOffsets) override;
+
+    void
+        IASetIndexBuffer(ID3D11Buffer* pIndexBuffer,
+                         DXGI_FORMAT Format,
+                         unsigned int Offset) override;
+
+    void
+        IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) override;
+
+    void
+        VSSetShader(ID3D11VertexShader* pVertexShader,
+                    ID3D11ClassInstance* const* ppClassInstances,
+                    unsigned int NumClassInstances) override;
+
+    void
+        PSSetShader(ID3D11PixelShader* pPixelShader,
+                    ID3D11ClassInstance* const* ppClassInstances,
+                    unsigned int NumClassInstances) override;
+
+    void
+        VSSetConstantBuffers(unsigned int StartSlot,
+                             unsigned int NumBuffers,
+                             ID3D11Buffer* const* ppConstantBuffers) override;
+
+    void
+        PSSetConstantBuffers(unsigned int StartSlot,
+                             unsigned int NumBuffers,
+                             ID3D11Buffer* const* ppConstantBuffers) override;
+
+    void
+        VSSetConstantBuffers1(unsigned int StartSlot,
+                              unsigned int NumBuffers,
+                              ID3D11Buffer* const* ppConstantBuffers,
+                              const unsigned int* pFirstConstant,
+                              const unsigned int* pNumConstants) override;
+
+    void
+        PSSetConstantBuffers1(unsigned int StartSlot,
+                              unsigned int NumBuffers,
+                              ID3D11Buffer* const* ppConstantBuffers,
+                              const unsigned int* pFirstConstant,
+                              const unsigned int* pNumConstants) override;
+
+    void
+        PSSetShaderResources(unsigned int StartSlot,
+                             unsigned int NumViews,
+                             ID3D11ShaderResourceView* const* ppShaderResourceViews) override;
+
+    void
+        PSSetSamplers(unsigned int StartSlot,
+                      unsigned int NumSamplers,
+                      ID3D11SamplerState* const* ppSamplers) override;
+
+    void
+        OMSetBlendState(ID3D11BlendState* pBlendState,
+                        const float BlendFactor[4],
+                        unsigned int SampleMask) override;
+
+    void
+        OMSetDepthStencilState(ID3D11DepthStencilState* pDepthStencilState,
+                               unsigned int StencilRef) override;
+
+    void
+        OMSetRenderTargets(unsigned int NumViews,
+                           ID3D11RenderTargetView* const* ppRenderTargetViews,
+                           ID3D11DepthStencilView* pDepthStencilView) override;
+
+    void
+        ClearRenderTargetView(ID3D11RenderTargetView* pRenderTargetView,
+                              const float ColorRGBA[4]) override;
+
+    void
+        ClearDepthStencilView(ID3D11DepthStencilView* pDepthStencilView,
+                              unsigned int ClearFlags,
+                              float Depth,
+                              UINT8 Stencil) override;
+
+    void
+        UpdateSubresource(ID3D11Resource* pDstResource,
+                          unsigned int DstSubresource,
+                          const D3D11_BOX* pDstBox,
+                          const void* pSrcData,
+                          unsigned int SrcRowPitch,
+                          unsigned int SrcDepthPitch) override;
+
+    void
+        CopySubresourceRegion(ID3D11Resource* pDstResource,
+                              unsigned int DstSubresource,
+                              unsigned int DstX,
+                              unsigned int DstY,
+                              unsigned int DstZ,
+                              ID3D11Resource* pSrcResource,
+                              unsigned int SrcSubresource,
+                              const D3D11_BOX* pSrcBox) override;
+
+    void
+        GenerateMips(ID3D11ShaderResourceView* pShaderResourceView) override;
+
+    void
+        ResolveSubresource(ID3D11Resource* pDstResource,
+                           unsigned int DstSubresource,
+                           ID3D11Resource* pSrcResource,
+                           unsigned int SrcSubresource,
+                           DXGI_FORMAT Format) override;
+
+    void
+        DrawIndexed(unsigned int IndexCount,
+                    unsigned int StartIndexLocation,
+                    int BaseVertexLocation) override;
+
+    void
+        DrawIndexedInstanced(unsigned int IndexCountPerInstance,
+                             unsigned int InstanceCount,
+                             unsigned int StartIndexLocation,
+                             int BaseVertexLocation,
+                             unsigned int StartInstanceLocation) override;
+
+    HRESULT
+        Map(ID3D11Resource* pResource,
+            unsigned int Subresource,
+            D3D11_MAP MapType,
+            unsigned int MapFlags,
+            D3D11_MAPPED_SUBRESOURCE* pMappedResource) override;
+
+    void
+        Unmap(ID3D11Resource* pResource, unsigned int Subresource) override;
+
+    void
+        Begin(ID3D11Asynchronous* pAsync) override;
+
+    void
+        End(ID3D11Asynchronous* pAsync) override;
+
+    HRESULT
+        GetData(ID3D11Asynchronous* pAsync,
+                void* pData,
+                unsigned int DataSize,
+                unsigned int GetDataFlags) override;
+
+    void
+        ClearState() override;
+
+
+protected:
+
+    /**
+     * @brief Enlaza el backend a un dispositivo y un contexto (inmediato o diferido)
+     * y consulta las capacidades de D3D11.1.
+     */
+    void
+        bindNative(ID3D11Device* device, ID3D11DeviceContext* deviceContext);
+
+
+protected:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    /** @brief Dispositivo nativo (no propietario). */
+    ID3D11Device* m_device = nullptr;
+
+    /** @brief Contexto nativo, inmediato o diferido (no propietario). */
+    ID3D11DeviceContext* m_deviceContext = nullptr;
+
+    /** @brief Interfaz 11.1 del contexto (propietario), o nullptr en runtimes 11.0. */
+    ID3D11DeviceContext1* m_deviceContext1 = nullptr;
+
+    /** @brief Offsets de constant buffer y NO_OVERWRITE sobre constant buffers disponibles. */
+    bool m_constantBufferOffsets = false;
+
+};
@@ -0,0 +1,544 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include <atomic>
+
+class DeviceContext;
+
+// =================================================================================
+// ESTRUCTURAS: ESTADSTICAS DEL BACKEND
+// =================================================================================
+
+/**
+ * @struct RenderBackendStats
+ * @brief Contadores acumulados de los comandos emitidos a un backend de render.
+ *
+ * Ambos backends (D3D11 y Null) los alimentan, por lo que los nmeros de un
+ * benchmark headless son comparables con los de una sesin con GPU.
+ */
+struct RenderBackendStats {
+    unsigned long long drawCalls = 0;         ///< Llamadas de dibujo emitidas.
+    unsigned long long indicesSubmitted = 0;  ///< ndices enviados en todos los draws.
+    unsigned long long instancedDrawCalls = 0;///< Draws instanciados (incluidos en drawCalls).
+    unsigned long long instancesSubmitted = 0;///< Instancias dibujadas por los draws instanciados.
+    unsigned long long bytesUploaded = 0;     ///< Bytes copiados con UpdateSubresource o datos iniciales.
+    unsigned long long bytesCopied = 0;       ///< Bytes copiados de GPU a GPU con CopySubresourceRegion.
+    unsigned long long maps = 0;              ///< Llamadas a Map (los bytes los reporta quien escribe).
+    unsigned long long stateChanges = 0;      ///< Binds de pipeline (shaders, buffers, vistas, estados).
+    unsigned long long redundantStateChanges = 0; ///< Binds que repiten lo ya enlazado (slo el backend nulo los detecta).
+    unsigned long long clears = 0;            ///< Limpiezas de RTV/DSV.
+    unsigned long long resourcesCreated = 0;  ///< Recursos y vistas creados por el backend.
+    unsigned long long validationErrors = 0;  ///< Comandos rechazados por estado invlido.
+
+    /**
+     * @brief Pone todos los contadores a cero.
+     */
+    void
+        reset() { *this = RenderBackendStats(); }
+
+
+    /**
+     * @brief Suma los contadores de otro bloque (p. ej. de un frame) a ste.
+     */
+    void
+        accumulate(const RenderBackendStats& other) {
+        drawCalls += other.drawCalls;
+        indicesSubmitted += other.indicesSubmitted;
+        instancedDrawCalls += other.instancedDrawCalls;
+        instancesSubmitted += other.instancesSubmitted;
+        bytesUploaded += other.bytesUploaded;
+        bytesCopied += other.bytesCopied;
+        maps += other.maps;
+        stateChanges += other.stateChanges;
+        redundantStateChanges += other.redundantStateChanges;
+        clears += other.clears;
+        resourcesCreated += other.resourcesCreated;
+        validationErrors += other.validationErrors;
+    }
+};
+
+
+// =================================================================================
+// INTERFAZ: IRENDERCOMMANDLIST
+// =================================================================================
+
+/**
+ * @class IRenderCommandList
+ * @brief Comandos grabados en un contexto diferido, listos para el contexto inmediato.
+ *
+ * Cada backend la implementa a su manera (@c ID3D11CommandList, lista grabada...);
+ * slo el backend que la cre sabe ejecutarla.
+ */
+class IRenderCommandList {
+
+public:
+
+    virtual ~IRenderCommandList() = default;
+
+};
+
+
+// =================================================================================
+// INTERFAZ: IRENDERBACKEND
+// =================================================================================
+
+/**
+ * @class IRenderBackend
+ * @brief Capa delgada entre @c Device / @c DeviceContext y la API grfica.
+ *
+ * Expone la creacin de recursos y los comandos de contexto que usa el motor.
+ * @c D3D11RenderBackend los reenva a Direct3D 11; @c NullRenderBackend los
+ * registra, valida y contabiliza sin ejecutarlos en la GPU.
+ */
+class IRenderBackend {
+
+public:
+
+    /**
+     * @brief Destructor virtual.
+     */
+    virtual ~IRenderBackend() = default;
+
+
+    // -----------------------------------------------------------------------------
+    // IDENTIFICACIN
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Nombre legible del backend (para logs y reportes).
+     */
+    virtual const char*
+        getName() const = 0;
+
+
+    /**
+     * @brief Indica si el backend ejecuta comandos sin GPU ni ventana.
+     */
+    virtual bool
+        isHeadless() const = 0;
+
+
+    /**
+     * @brief Dispositivo nativo usado para crear recursos.
+     * @return Puntero no propietario; el backend conserva la referencia.
+     */
+    virtual ID3D11Device*
+        getNativeDevice() const = 0;
+
+
+    /**
+     * @brief Contexto inmediato nativo asociado al backend.
+     * @return Puntero no propietario; el backend conserva la referencia.
+     */
+    virtual ID3D11DeviceContext*
+        getNativeContext() const = 0;
+
+
+    /**
+     * @brief Marca el inicio de un frame.
+     * Los backends que graban comandos descartan aqu lo grabado en el frame anterior.
+     */
+    virtual void
+        beginFrame() {}
+
+
+    /**
+     * @brief Indica si se pueden enlazar rangos de un constant buffer grande
+     * (@c VSSetConstantBuffers1) y mapearlo con @c D3D11_MAP_WRITE_NO_OVERWRITE.
+     * Requiere Direct3D 11.1 y soporte del driver.
+     */
+    virtual bool
+        supportsConstantBufferOffsets() const { return false; }
+
+
+    // -----------------------------------------------------------------------------
+    // CONTEXTOS DIFERIDOS
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Indica si @c createDeferredContext() est implementado.
+     */
+    virtual bool
+        supportsDeferredContexts() const { return false; }
+
+
+    /**
+     * @brief Crea un contexto diferido y el backend que graba en l.
+     * @param deferredContext Contexto vaco; queda con su backend asignado y, si hay
+     *        contexto nativo, es su dueo (lo libera en @c destroy()).
+     * @param deferredBackend Recibe el backend; debe vivir mientras se use el contexto.
+     */
+    virtual HRESULT
+        createDeferredContext(DeviceContext& deferredContext,
+                              std::unique_ptr<IRenderBackend>& deferredBackend) { return E_NOTIMPL; }
+
+
+    /**
+     * @brief Cierra lo grabado en un contexto diferido. Su estado vuelve al de por defecto.
+     */
+    virtual HRESULT
+        finishCommandList(std::unique_ptr<IRenderCommandList>& commandList) { return E_NOTIMPL; }
+
+
+    /**
+     * @brief Ejecuta una lista en el contexto inmediato. Al terminar el estado del
+     * pipeline queda limpio, igual que tras @c ClearState().
+     */
+    virtual void
+        executeCommandList(IRenderCommandList& commandList) {}
+
+
+    // -----------------------------------------------------------------------------
+    // CREACIN DE RECURSOS
+    // -----------------------------------------------------------------------------
+
+    virtual HRESULT
+        CreateBuffer(const D3D11_BUFFER_DESC* pDesc,
+                     const D3D11_SUBRESOURCE_DATA* pInitialData,
+                     ID3D11Buffer** ppBuffer) = 0;
+
+    virtual HRESULT
+        CreateTexture2D(const D3D11_TEXTURE2D_DESC* pDesc,
+                        const D3D11_SUBRESOURCE_DATA* pInitialData,
+                        ID3D11Texture2D** ppTexture2D) = 0;
+
+    virtual HRESULT
+        CreateShaderResourceView(ID3D11Resource* pResource,
+                                 const D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc,
+                                 ID3D11ShaderResourceView** ppSRView) = 0;
+
+    virtual HRESULT
+        CreateShaderResourceViewFromFile(const std::string& fileName,
+                                         ID3D11ShaderResourceView** ppSRView) = 0;
+
+    virtual HRESULT
+        CreateRenderTargetView(ID3D11Resource* pResource,
+                               const D3D11_RENDER_TARGET_VIEW_DESC* pDesc,
+                               ID3D11RenderTargetView** ppRTView) = 0;
+
+    virtual HRESULT
+        CreateDepthStencilView(ID3D11Resource* pResource,
+                               const D3D11_DEPTH_STENCIL_VIEW_DESC* pDesc,
+                               ID3D11DepthStencilView** ppDepthStencilView) = 0;
+
+    virtual HRESULT
+        CreateVertexShader(const void* pShaderBytecode,
+                           SIZE_T BytecodeLength,
+                           ID3D11ClassLinkage* pClassLinkage,
+                           ID3D11VertexShader** ppVertexShader) = 0;
+
+    virtual HRESULT
+        CreatePixelShader(const void* pShaderBytecode,
+                          SIZE_T BytecodeLength,
+                          ID3D11ClassLinkage* pClassLinkage,
+                          ID3D11PixelShader** ppPixelShader) = 0;
+
+    virtual HRESULT
+        CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* pInputElementDescs,
+                          UINT NumElements,
+                          const void* pShaderBytecodeWithInputSignature,
+                          SIZE_T BytecodeLength,
+                          ID3D11InputLayout** ppInputLayout) = 0;
+
+    virtual HRESULT
+        CreateSamplerState(const D3D11_SAMPLER_DESC* pSamplerDesc,
+                           ID3D11SamplerState** ppSamplerState) = 0;
+
+    virtual HRESULT
+        CreateBlendState(const D3D11_BLEND_DESC* pBlendStateDesc,
+                         ID3D11BlendState** ppBlendState) = 0;
+
+    virtual HRESULT
+        CreateRasterizerState(const D3D11_RASTERIZER_DESC* pRasterizerDesc,
+                              ID3D11RasterizerState** ppRasterizerState) = 0;
+
+    virtual HRESULT
+        CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* pDepthStencilDesc,
+                                ID3D11DepthStencilState** ppDepthStencilState) = 0;
+
+    virtual HRESULT
+        CheckMultisampleQualityLevels(DXGI_FORMAT Format,
+                                      UINT SampleCount,
+                                      UINT* pNumQualityLevels) = 0;
+
+    virtual HRESULT
+        CreateQuery(const D3D11_QUERY_DESC* pQueryDesc,
+                    ID3D11Query** ppQuery) = 0;
+
+
+    // -----------------------------------------------------------------------------
+    // CREACIN DESDE OTROS HILOS
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Como @c CreateTexture2D, pero se puede llamar desde cualquier hilo.
+     *
+     * Crea sobre @c getNativeDevice() (el dispositivo es libre de hilos) y cuenta el
+     * recurso en contadores atmicos; @c collectConcurrentStats() los pasa a
+     * @c getStats() desde el hilo principal.
+     */
+    HRESULT
+        createTexture2DConcurrent(const D3D11_TEXTURE2D_DESC* pDesc,
+                                  const D3D11_SUBRESOURCE_DATA* pInitialData,
+                                  ID3D11Texture2D** ppTexture2D);
+
+
+    /**
+     * @brief Como @c CreateShaderResourceView, pero se puede llamar desde cualquier hilo.
+     */
+    HRESULT
+        createShaderResourceViewConcurrent(ID3D11Resource* pResource,
+                                           const D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc,
+                                           ID3D11ShaderResourceView** ppSRView);
+
+
+    /**
+     * @brief Suma a los contadores lo creado desde otros hilos desde la ltima llamada.
+     * Slo desde el hilo principal, antes de leer @c getStats().
+     */
+    void
+        collectConcurrentStats();
+
+
+    // -----------------------------------------------------------------------------
+    // COMANDOS DE CONTEXTO
+    // -----------------------------------------------------------------------------
+
+    virtual void
+        RSSetViewports(unsigned int NumViewports, const D3D11_VIEWPORT* pViewports) = 0;
+
+    virtual void
+        RSSetState(ID3D11RasterizerState* pRasterizerState) = 0;
+
+    virtual void
+        IASetInputLayout(ID3D11InputLayout* pInputLayout) = 0;
+
+    virtual void
+        IASetVertexBuffers(unsigned int StartSlot,
+                           unsigned int NumBuffers,
+                           ID3D11Buffer* const* ppVertexBuffers,
+                           const unsigned int* pStrides,
+                           const unsigned int* pOffsets) = 0;
+
+    virtual void
+        IASetIndexBuffer(ID3D11Buffer* pIndexBuffer,
+                         DXGI_FORMAT Format,
+                         unsigned int Offset) = 0;
+
+    virtual void
+        IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) = 0;
+
+    virtual void
+        VSSetShader(ID3D11VertexShader* pVertexShader,
+                    ID3D11ClassInstance* const* ppClassInstances,
+                    unsigned int NumClassInstances) = 0;
+
+    virtual void
+        PSSetShader(ID3D11PixelShader* pPixelShader,
+                    ID3D11ClassInstance* const* ppClassInstances,
+                    unsigned int NumClassInstances) = 0;
+
+    virtual void
+        VSSetConstantBuffers(unsigned int StartSlot,
+                             unsigned int NumBuffers,
+                             ID3D11Buffer* const* ppConstantBuffers) = 0;
+
+    virtual void
+        PSSetConstantBuffers(unsigned int StartSlot,
+                             unsigned int NumBuffers,
+                             ID3D11Buffer* const* ppConstantBuffers) = 0;
+
+    /**
+     * @brief Enlaza rangos de constant buffers (en unidades de 16 constantes = 256 bytes).
+     * Slo vlido si @c supportsConstantBufferOffsets() devuelve true.
+     */
+    virtual void
+        VSSetConstantBuffers1(unsigned int StartSlot,
+                              unsigned int NumBuffers,
+                              ID3D11Buffer* const* ppConstantBuffers,
+                              const unsigned int* pFirstConstant,
+                              const unsigned int* pNumConstants) = 0;
+
+    virtual void
+        PSSetConstantBuffers1(unsigned int StartSlot,
+                              unsigned int NumBuffers,
+                              ID3D11Buffer* const* ppConstantBuffers,
+                              const unsigned int* pFirstConstant,
+                              const unsigned int* pNumConstants) = 0;
+
+    virtual void
+        PSSetShaderResources(unsigned int StartSlot,
+                             unsigned int NumViews,
+                             ID3D11ShaderResourceView* const* ppShaderResourceViews) = 0;
+
+    virtual void
+        PSSetSamplers(unsigned int StartSlot,
+                      unsigned int NumSamplers,
+                      ID3D11SamplerState* const* ppSamplers) = 0;
+
+    virtual void
+        OMSetBlendState(ID3D11BlendState* pBlendState,
+                        const float BlendFactor[4],
+                        unsigned int SampleMask) = 0;
+
+    virtual void
+        OMSetDepthStencilState(ID3D11DepthStencilState* pDepthStencilState,
+                               unsigned int StencilRef) = 0;
+
+    virtual void
+        OMSetRenderTargets(unsigned int NumViews,
+                           ID3D11RenderTargetView* const* ppRenderTargetViews,
+                           ID3D11DepthStencilView* pDepthStencilView) = 0;
+
+    virtual void
+        ClearRenderTargetView(ID3D11RenderTargetView* pRenderTargetView,
+                              const float ColorRGBA[4]) = 0;
+
+    virtual void
+        ClearDepthStencilView(ID3D11DepthStencilView* pDepthStencilView,
+                              unsigned int ClearFlags,
+                              float Depth,
+                              UINT8 Stencil) = 0;
+
+    virtual void
+        UpdateSubresource(ID3D11Resource* pDstResource,
+                          unsigned int DstSubresource,
+                          const D3D11_BOX* pDstBox,
+                          const void* pSrcData,
+                          unsigned int SrcRowPitch,
+                          unsigned int SrcDepthPitch) = 0;
+
+    virtual void
+        CopySubresourceRegion(ID3D11Resource* pDstResource,
+                              unsigned int DstSubresource,
+                              unsigned int DstX,
+                              unsigned int DstY,
+                              unsigned int DstZ,
+                              ID3D11Resource* pSrcResource,
+                              unsigned int SrcSubresource,
+                              const D3D11_BOX* pSrcBox) = 0;
+
+    virtual void
+        GenerateMips(ID3D11ShaderResourceView* pShaderResourceView) = 0;
+
+    virtual void
+        ResolveSubresource(ID3D11Resource* pDstResource,
+                           unsigned int DstSubresource,
+                           ID3D11Resource* pSrcResource,
+                           unsigned int SrcSubresource,
+                           DXGI_FORMAT Format) = 0;
+
+    virtual void
+        DrawIndexed(unsigned int IndexCount,
+                    unsigned int StartIndexLocation,
+                    int BaseVertexLocation) = 0;
+
+    virtual void
+        DrawIndexedInstanced(unsigned int IndexCountPerInstance,
+                             unsigned int InstanceCount,
+                             unsigned int StartIndexLocation,
+                             int BaseVertexLocation,
+                             unsigned int StartInstanceLocation) = 0;
+
+    virtual HRESULT
+        Map(ID3D11Resource* pResource,
+            unsigned int Subresource,
+            D3D11_MAP MapType,
+            unsigned int MapFlags,
+            D3D11_MAPPED_SUBRESOURCE* pMappedResource) = 0;
+
+    virtual void
+        Unmap(ID3D11Resource* pResource, unsigned int Subresource) = 0;
+
+    virtual void
+        Begin(ID3D11Asynchronous* pAsync) = 0;
+
+    virtual void
+        End(ID3D11Asynchronous* pAsync) = 0;
+
+    /**
+     * @brief Lee el resultado de una consulta sin bloquear.
+     * @return @c S_OK con el dato listo, @c S_FALSE si la GPU an no lleg a ella.
+     */
+    virtual HRESULT
+        GetData(ID3D11Asynchronous* pAsync,
+                void* pData,
+                unsigned int DataSize,
+                unsigned int GetDataFlags) = 0;
+
+    virtual void
+        ClearState() = 0;
+
+
+    // -----------------------------------------------------------------------------
+    // ESTADSTICAS
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Contadores acumulados desde el ltimo @c resetStats().
+     */
+    const RenderBackendStats&
+        getStats() const { return m_stats; }
+
+
+    /**
+     * @brief Reinicia los contadores (tpicamente al inicio de cada frame medido).
+     */
+    void
+        resetStats() { m_stats.reset(); }
+
+
+    /**
+     * @brief Suma contadores ajenos (p. ej. de un contexto diferido ya ejecutado).
+     */
+    void
+        accumulateStats(const RenderBackendStats& other) { m_stats.accumulate(other); }
+
+
+protected:
+
+    /**
+     * @brief Estima los bytes que copia un @c UpdateSubresource.
+     *
+     * Usa la caja destino si existe; si no, la descripcin del recurso
+     * (ancho en bytes del buffer o pitch por alto de la mip destino).
+     */
+    static unsigned long long
+        computeUploadSize(ID3D11Resource* pDstResource,
+                          unsigned int DstSubresource,
+                          const D3D11_BOX* pDstBox,
+                          unsigned int SrcRowPitch,
+                          unsigned int SrcDepthPitch);
+
+
+    /**
+     * @brief Estima los bytes que mueve un @c CopySubresourceRegion.
+     *
+     * Para buffers es el ancho de la caja origen (o el buffer completo);
+     * para texturas 2D se estima con 4 bytes por texel (RGBA8, el formato del motor).
+     */
+    static unsigned long long
+        computeCopySize(ID3D11Resource* pSrcResource,
+                        const D3D11_BOX* pSrcBox);
+
+
+    /**
+     * @brief Suma los bytes de los datos iniciales de una textura 2D.
+     */
+    static unsigned long long
+        computeInitialDataSize(const D3D11_TEXTURE2D_DESC* pDesc,
+                               const D3D11_SUBRESOURCE_DATA* pInitialData);
+
+
+protected:
+
+    /** @brief Contadores alimentados por la implementacin concreta. */
+    RenderBackendStats m_stats;
+
+    /** @brief Recursos creados desde otros hilos y an no sumados a @c m_stats. */
+    std::atomic<unsigned long long> m_concurrentResources{ 0 };
+
+    /** @brief Bytes de datos iniciales de esos recursos. */
+    std::atomic<unsigned long long> m_concurrentBytes{ 0 };
+
+};
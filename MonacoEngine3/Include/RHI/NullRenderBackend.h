@@ -0,0 +1,493 @@
+#pragma once
+
+#include "RHI/D3D11RenderBackend.h"
+#include <unordered_map>
+
+// =================================================================================
+// ESTRUCTURAS: COMANDOS GRABADOS
+// =================================================================================
+
+/**
+ * @enum RecordedCommandType
+ * @brief Tipos de comando que el backend nulo puede grabar.
+ */
+enum class RecordedCommandType {
+    SetViewports,
+    SetRasterizerState,
+    SetInputLayout,
+    SetVertexBuffers,
+    SetIndexBuffer,
+    SetPrimitiveTopology,
+    SetVertexShader,
+    SetPixelShader,
+    SetVSConstantBuffers,
+    SetPSConstantBuffers,
+    SetVSConstantBuffers1,
+    SetPSConstantBuffers1,
+    SetPSShaderResources,
+    SetPSSamplers,
+    SetBlendState,
+    SetDepthStencilState,
+    SetRenderTargets,
+    ClearRenderTarget,
+    ClearDepthStencil,
+    UpdateSubresource,
+    CopySubresourceRegion,
+    GenerateMips,
+    ResolveSubresource,
+    DrawIndexed,
+    DrawIndexedInstanced,
+    Map,
+    Unmap,
+    BeginQuery,
+    EndQuery,
+    ClearState,
+    ExecuteCommandList
+};
+
+
+/**
+ * @struct RecordedCommand
+ * @brief Entrada compacta de la lista de comandos grabada por frame.
+ */
+struct RecordedCommand {
+    RecordedCommandType type;   ///< Tipo de comando.
+    const void* object;         ///< Objeto principal (buffer, shader, vista...).
+    unsigned int arg0;          ///< Primer argumento (slot, conteo de ndices...).
+    unsigned int arg1;          ///< Segundo argumento (cantidad, ndice inicial...).
+};
+
+
+// =================================================================================
+// CLASE: NULL COMMAND LIST
+// =================================================================================
+
+/**
+ * @class NullCommandList
+ * @brief Comandos grabados por un @c NullRenderBackend diferido.
+ */
+class NullCommandList : public IRenderCommandList {
+
+public:
+
+    std::vector<RecordedCommand> commands;
+
+};
+
+
+// =================================================================================
+// CLASE: NULL RENDER BACKEND
+// =================================================================================
+
+/**
+ * @class NullRenderBackend
+ * @brief Backend que graba, valida y contabiliza comandos sin ejecutarlos.
+ *
+ * Los recursos se siguen creando sobre un dispositivo D3D11 sin GPU
+ * (@c D3D_DRIVER_TYPE_NULL, o WARP si el primero no est disponible), de modo que
+ * los objetos COM son reales y @c SAFE_RELEASE sigue funcionando. Los comandos de
+ * contexto nunca llegan a ese dispositivo: slo actualizan un espejo del pipeline
+ * que se usa para validar cada draw.
+ */
+class NullRenderBackend : public D3D11RenderBackend {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    NullRenderBackend() = default;
+
+    ~NullRenderBackend() override = default;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Crea el dispositivo headless dentro de @c device / @c deviceContext.
+     * Ambos quedan como propietarios, igual que tras @c SwapChain::init.
+     * @return @c S_OK si se pudo crear un dispositivo NULL o WARP.
+     */
+    HRESULT
+        init(Device& device, DeviceContext& deviceContext) override;
+
+
+    /**
+     * @brief Libera la lista de comandos y suelta las referencias.
+     */
+    void
+        destroy() override;
+
+
+    // -----------------------------------------------------------------------------
+    // IDENTIFICACIN
+    // -----------------------------------------------------------------------------
+
+    const char*
+        getName() const override { return "Null"; }
+
+    bool
+        isHeadless() const override { return true; }
+
+    void
+        beginFrame() override;
+
+    bool
+        supportsConstantBufferOffsets() const override { return m_emulateConstantBufferOffsets; }
+
+
+    // -----------------------------------------------------------------------------
+    // CONTEXTOS DIFERIDOS
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Los contextos diferidos se emulan: cada uno graba en su propia lista
+     * y el inmediato la concatena en @c executeCommandList().
+     */
+    bool
+        supportsDeferredContexts() const override { return m_device != nullptr; }
+
+    HRESULT
+        createDeferredContext(DeviceContext& deferredContext,
+                              std::unique_ptr<IRenderBackend>& deferredBackend) override;
+
+    HRESULT
+        finishCommandList(std::unique_ptr<IRenderCommandList>& commandList) override;
+
+    void
+        executeCommandList(IRenderCommandList& commandList) override;
+
+
+    /**
+     * @brief Indica si el backend graba para un contexto diferido.
+     */
+    bool
+        isDeferred() const { return m_deferred; }
+
+
+    /**
+     * @brief Simula un runtime con o sin D3D11.1 para ejercitar ambos caminos.
+     */
+    void
+        setEmulateConstantBufferOffsets(bool enabled) { m_emulateConstantBufferOffsets = enabled; }
+
+
+    // -----------------------------------------------------------------------------
+    // GRABACIN
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Activa o desactiva la grabacin de comandos (el conteo siempre ocurre).
+     */
+    void
+        setRecording(bool recording) { m_recording = recording; }
+
+
+    /**
+     * @brief Comandos grabados desde el ltimo @c beginFrame().
+     */
+    const std::vector<RecordedCommand>&
+        getRecordedCommands() const { return m_commands; }
+
+
+    /**
+     * @brief Tipo de driver con el que se cre el dispositivo headless.
+     */
+    D3D_DRIVER_TYPE
+        getDriverType() const { return m_driverType; }
+
+
+    // -----------------------------------------------------------------------------
+    // COMANDOS DE CONTEXTO
+    // -----------------------------------------------------------------------------
+
+    void
+        RSSetViewports(unsigned int NumViewports, const D3D11_VIEWPORT* pViewports) override;
+
+    void
+        RSSetState(ID3D11RasterizerState* pRasterizerState) override;
+
+    void
+        IASetInputLayout(ID3D11InputLayout* pInputLayout) override;
+
+    void
+        IASetVertexBuffers(unsigned int StartSlot,
+                           unsigned int NumBuffers,
+                           ID3D11Buffer* const* ppVertexBuffers,
+                           const unsigned int* pStrides,
+                           const unsigned int* pOffsets) override;
+
+    void
+        IASetIndexBuffer(ID3D11Buffer* pIndexBuffer,
+                         DXGI_FORMAT Format,
+                         unsigned int Offset) override;
+
+    void
+        IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) override;
+
+    void
+        VSSetShader(ID3D11VertexShader* pVertexShader,
+                    ID3D11ClassInstance* const* ppClassInstances,
+                    unsigned int NumClassInstances) override;
+
+    void
+        PSSetShader(ID3D11PixelShader* pPixelShader,
+                    ID3D11ClassInstance* const* ppClassInstances,
+                    unsigned int NumClassInstances) override;
+
+    void
+        VSSetConstantBuffers(unsigned int StartSlot,
+                             unsigned int NumBuffers,
+                             ID3D11Buffer* const* ppConstantBuffers) override;
+
+    void
+        PSSetConstantBuffers(unsigned int StartSlot,
+                             unsigned int NumBuffers,
+                             ID3D11Buffer* const* ppConstantBuffers) override;
+
+    void
+        VSSetConstantBuffers1(unsigned int StartSlot,
+                              unsigned int NumBuffers,
+                              ID3D11Buffer* const* ppConstantBuffers,
+                              const unsigned int* pFirstConstant,
+                              const unsigned int* pNumConstants) override;
+
+    void
+        PSSetConstantBuffers1(unsigned int StartSlot,
+                              unsigned int NumBuffers,
+                              ID3D11Buffer* const* ppConstantBuffers,
+                              const unsigned int* pFirstConstant,
+                              const unsigned int* pNumConstants) override;
+
+    void
+        PSSetShaderResources(unsigned int StartSlot,
+                             unsigned int NumViews,
+                             ID3D11ShaderResourceView* const* ppShaderResourceViews) override;
+
+    void
+        PSSetSamplers(unsigned int StartSlot,
+                      unsigned int NumSamplers,
+                      ID3D11SamplerState* const* ppSamplers) override;
+
+    void
+        OMSetBlendState(ID3D11BlendState* pBlendState,
+                        const float BlendFactor[4],
+                        unsigned int SampleMask) override;
+
+    void
+        OMSetDepthStencilState(ID3D11DepthStencilState* pDepthStencilState,
+                               unsigned int StencilRef) override;
+
+    void
+        OMSetRenderTargets(unsigned int NumViews,
+                           ID3D11RenderTargetView* const* ppRenderTargetViews,
+                           ID3D11DepthStencilView* pDepthStencilView) override;
+
+    void
+        ClearRenderTargetView(ID3D11RenderTargetView* pRenderTargetView,
+                              const float ColorRGBA[4]) override;
+
+    void
+        ClearDepthStencilView(ID3D11DepthStencilView* pDepthStencilView,
+                              unsigned int ClearFlags,
+                              float Depth,
+                              UINT8 Stencil) override;
+
+    void
+        UpdateSubresource(ID3D11Resource* pDstResource,
+                          unsigned int DstSubresource,
+                          const D3D11_BOX* pDstBox,
+                          const void* pSrcData,
+                          unsigned int SrcRowPitch,
+                          unsigned int SrcDepthPitch) override;
+
+    void
+        CopySubresourceRegion(ID3D11Resource* pDstResource,
+                              unsigned int DstSubresource,
+                              unsigned int DstX,
+                              unsigned int DstY,
+                              unsigned int DstZ,
+                              ID3D11Resource* pSrcResource,
+                              unsigned int SrcSubresource,
+                              const D3D11_BOX* pSrcBox) override;
+
+    void
+        GenerateMips(ID3D11ShaderResourceView* pShaderResourceView) override;
+
+    void
+        ResolveSubresource(ID3D11Resource* pDstResource,
+                           unsigned int DstSubresource,
+                           ID3D11Resource* pSrcResource,
+                           unsigned int SrcSubresource,
+                           DXGI_FORMAT Format) override;
+
+    void
+        DrawIndexed(unsigned int IndexCount,
+                    unsigned int StartIndexLocation,
+                    int BaseVertexLocation) override;
+
+    void
+        DrawIndexedInstanced(unsigned int IndexCountPerInstance,
+                             unsigned int InstanceCount,
+                             unsigned int StartIndexLocation,
+                             int BaseVertexLocation,
+                             unsigned int StartInstanceLocation) override;
+
+    HRESULT
+        Map(ID3D11Resource* pResource,
+            unsigned int Subresource,
+            D3D11_MAP MapType,
+            unsigned int MapFlags,
+            D3D11_MAPPED_SUBRESOURCE* pMappedResource) override;
+
+    void
+        Unmap(ID3D11Resource* pResource, unsigned int Subresource) override;
+
+    void
+        Begin(ID3D11Asynchronous* pAsync) override;
+
+    void
+        End(ID3D11Asynchronous* pAsync) override;
+
+    /**
+     * @brief Sin GPU no hay tiempos: las consultas responden al momento con ceros y
+     * los intervalos de timestamps se marcan como discontinuos para que nadie los use.
+     */
+    HRESULT
+        GetData(ID3D11Asynchronous* pAsync,
+                void* pData,
+                unsigned int DataSize,
+                unsigned int GetDataFlags) override;
+
+    void
+        ClearState() override;
+
+
+private:
+
+    /**
+     * @brief Aade un comando a la lista si la grabacin est activa.
+     */
+    void
+        record(RecordedCommandType type,
+               const void* object,
+               unsigned int arg0 = 0,
+               unsigned int arg1 = 0);
+
+
+    /**
+     * @brief Comprueba el estado del pipeline antes de un draw indexado.
+     */
+    void
+        validateDraw(const char* method,
+                     unsigned int IndexCount,
+                     unsigned int StartIndexLocation);
+
+
+    /**
+     * @brief Comprueba los rangos de @c *SSetConstantBuffers1.
+     */
+    void
+        validateConstantBufferRanges(const char* method,
+                                     unsigned int NumBuffers,
+                                     ID3D11Buffer* const* ppConstantBuffers,
+                                     const unsigned int* pFirstConstant,
+                                     const unsigned int* pNumConstants);
+
+
+    /**
+     * @brief Cuenta un bind que no cambia el estado del espejo.
+     */
+    void
+        countRedundant(bool redundant) {
+        if (redundant) {
+            ++m_stats.redundantStateChanges;
+        }
+    }
+
+
+    /**
+     * @brief Registra un error de validacin (slo los primeros se escriben al log).
+     */
+    void
+        reportValidationError(const char* method, const char* reason);
+
+
+    /**
+     * @brief Constant buffer enlazado en un slot (con su rango si se us la variante 1).
+     */
+    struct ConstantBufferSlot {
+        ID3D11Buffer* buffer = nullptr;
+        unsigned int firstConstant = 0;
+        unsigned int numConstants = 0;
+    };
+
+
+    /**
+     * @brief Espejo del estado del pipeline usado para validar draws.
+     */
+    struct PipelineMirror {
+        ID3D11VertexShader* vertexShader = nullptr;
+        ID3D11PixelShader* pixelShader = nullptr;
+        ID3D11InputLayout* inputLayout = nullptr;
+        ID3D11Buffer* vertexBuffer = nullptr;
+        ID3D11Buffer* instanceBuffer = nullptr;
+        unsigned int instanceCapacity = 0;
+        ID3D11Buffer* indexBuffer = nullptr;
+        DXGI_FORMAT indexFormat = DXGI_FORMAT_UNKNOWN;
+        unsigned int indexOffset = 0;
+        unsigned int indexCapacity = 0;
+        ID3D11RasterizerState* rasterizerState = nullptr;
+        ID3D11DepthStencilState* depthStencilState = nullptr;
+        ID3D11BlendState* blendState = nullptr;
+        float blendFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        unsigned int sampleMask = 0xFFFFFFFF;
+        ConstantBufferSlot vsConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+        ConstantBufferSlot psConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+        ID3D11RenderTargetView* renderTarget = nullptr;
+        ID3D11DepthStencilView* depthStencil = nullptr;
+        D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+        bool viewportSet = false;
+    };
+
+
+    /**
+     * @brief Copia un bind de constant buffers al espejo.
+     * @return true si todos los slots ya tenan ese buffer y rango (bind redundante).
+     */
+    bool
+        bindConstantBuffers(ConstantBufferSlot* slots,
+                            unsigned int StartSlot,
+                            unsigned int NumBuffers,
+                            ID3D11Buffer* const* ppConstantBuffers,
+                            const unsigned int* pFirstConstant,
+                            const unsigned int* pNumConstants);
+
+
+private:
+
+    /** @brief Estado del pipeline segn los comandos recibidos. */
+    PipelineMirror m_pipeline;
+
+    /** @brief Comandos grabados en el frame actual. */
+    std::vector<RecordedCommand> m_commands;
+
+    /** @brief Memoria de CPU que sustituye a los recursos mapeados (el driver NULL no la da). */
+    std::unordered_map<ID3D11Resource*, std::vector<unsigned char>> m_mapShadow;
+
+    /** @brief Respuesta de @c supportsConstantBufferOffsets(). */
+    bool m_emulateConstantBufferOffsets = true;
+
+    /** @brief Si es false slo se cuentan comandos, sin grabarlos. */
+    bool m_recording = true;
+
+    /** @brief Driver con el que se cre el dispositivo headless. */
+    D3D_DRIVER_TYPE m_driverType = D3D_DRIVER_TYPE_NULL;
+
+    /** @brief true si graba para un contexto diferido (sin contexto nativo). */
+    bool m_deferred = false;
+
+};
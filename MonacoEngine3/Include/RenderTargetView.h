@@ -109,6 +109,13 @@ public:
             unsigned int numViews);
 
 
+    /**
+     * @brief Vista nativa, para enlazarla en contextos sin wrapper (p. ej. diferidos).
+     */
+    ID3D11RenderTargetView*
+        getView() const { return m_renderTargetView; }
+
+
     /**
      * @brief Libera el recurso `ID3D11RenderTargetView` asociado.
      * Reinicia el puntero interno a `nullptr`.
@@ -0,0 +1,316 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "Buffer.h"
+#include "ShaderProgram.h"
+#include "Renderer/RenderQueue.h"
+#include "Renderer/RenderGraph.h"
+
+class Device;
+class DeviceContext;
+class Camera;
+class Actor;
+class StaticBatcher;
+class ShaderCache;
+class ConstantBufferRing;
+
+// =================================================================================
+// ESTRUCTURAS: CASCADAS
+// =================================================================================
+
+/**
+ * @struct CBShadowCascades
+ * @brief Constantes que leen los shaders que reciben sombra (b3).
+ */
+struct CBShadowCascades {
+    XMMATRIX mCascadeViewProj[4];   ///< Mundo -> clip de cada cascada (transpuestas).
+    XMFLOAT4 vCascadeSplits;        ///< Distancia de vista donde termina cada cascada.
+    XMFLOAT4 vShadowParams;         ///< x = tamao de texel en UV, y = cascadas, z = bias de comparacin.
+};
+
+
+/**
+ * @struct ShadowCascade
+ * @brief Ajuste de una cascada y estado de su cach esttica.
+ */
+struct ShadowCascade {
+    XMFLOAT4X4 viewProj = {};               ///< Mundo -> clip (sin transponer).
+    XMFLOAT3 lightCenter = XMFLOAT3(0.0f, 0.0f, 0.0f); ///< Centro de la caja en espacio de luz.
+    float extent = 0.0f;                    ///< Semilado de la caja ortogrfica.
+    float splitNear = 0.0f;                 ///< Tramo del frustum de la cmara que cubre.
+    float splitFar = 0.0f;
+    bool fitted = false;                    ///< @c lightCenter viene de un ajuste anterior.
+    bool staticValid = false;               ///< La capa esttica corresponde a este ajuste.
+    bool liveIsStatic = false;              ///< El mapa vivo slo contiene la capa esttica.
+    unsigned int dynamicCasters = 0;        ///< Paquetes dinmicos del ltimo frame.
+};
+
+
+/**
+ * @struct ShadowStats
+ * @brief Trabajo del ltimo @c render().
+ */
+struct ShadowStats {
+    unsigned int cascades = 0;
+    unsigned int castersTested = 0;         ///< Actores y mallas estticas probados contra alguna cascada.
+    unsigned int castersCulled = 0;         ///< De ellos, los que quedaban fuera.
+    unsigned int staticPackets = 0;         ///< Paquetes enviados al redibujar capas estticas.
+    unsigned int dynamicPackets = 0;        ///< Paquetes de proyectores dinmicos.
+    unsigned int drawCalls = 0;             ///< Draws emitidos tras el instanciado.
+    unsigned int staticCascadesRendered = 0;///< Capas estticas redibujadas.
+    unsigned int staticCascadesReused = 0;  ///< Capas estticas servidas desde la cach.
+    unsigned int cascadesSkipped = 0;       ///< Cascadas que no cambiaron en absoluto.
+};
+
+
+// =================================================================================
+// CLASE: CASCADED SHADOW MAP
+// =================================================================================
+
+/**
+ * @class CascadedShadowMap
+ * @brief Sombras de una luz direccional repartidas en cascadas sobre el frustum de la cmara.
+ *
+ * Ajuste estable: cada tramo de @c Camera::computeCascadeSplits se envuelve en una esfera,
+ * cuyo radio slo depende de las distancias y del FOV, as que girar la cmara no cambia el
+ * tamao del texel. La caja ortogrfica aade una banda de guarda y slo se recoloca (en
+ * pasos de texel) cuando la esfera se sale de ella: mientras tanto la matriz no cambia y
+ * los bordes no "nadan".
+ *
+ * Cada cascada descarta por AABB los actores que no proyectan sombra en ella
+ * (@c Actor::canCastShadow) y enva el resto a una @c RenderQueue propia con shaders de
+ * slo profundidad, que ordena e instancia igual que el pase principal.
+ *
+ * Cach esttica: los proyectores estticos (pginas del @c StaticBatcher y actores
+ * @c isStatic) se dibujan en un array aparte que slo se rehace cuando cambia la matriz de
+ * la cascada, la luz o se llama a @c invalidateStaticCasters(). Cada frame la capa esttica
+ * se copia al mapa vivo y encima se dibujan slo los dinmicos; si no hay dinmicos y nada
+ * cambi, la cascada no se toca.
+ */
+class CascadedShadowMap {
+
+public:
+
+    /** @brief Cascadas como mximo (tamao de @c CBShadowCascades). */
+    static const unsigned int kMaxCascades = 4;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    CascadedShadowMap() = default;
+
+    ~CascadedShadowMap() = default;
+
+    CascadedShadowMap(const CascadedShadowMap&) = delete;
+    CascadedShadowMap& operator=(const CascadedShadowMap&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Crea los mapas, los shaders de profundidad y la cola de proyectores.
+     * @param device Dispositivo grfico.
+     * @param cache Cach de bytecode para los shaders de sombra.
+     * @param layout Layout de vrtice del shader por defecto.
+     * @param instancedLayout Layout de la variante instanciada (slot 1 por instancia).
+     * @param cascadeCount Cascadas (1..@c kMaxCascades).
+     * @param resolution Lado de cada mapa en texels.
+     * @return Error de creacin de algn recurso.
+     */
+    HRESULT
+        init(Device& device,
+             ShaderCache& cache,
+             const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout,
+             const std::vector<D3D11_INPUT_ELEMENT_DESC>& instancedLayout,
+             unsigned int cascadeCount = 4,
+             unsigned int resolution = 2048);
+
+
+    /**
+     * @brief Libera texturas, vistas, shaders y buffers.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // CONFIGURACIN
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Direccin hacia la que viaja la luz (se normaliza). Invalida todas las cascadas.
+     */
+    void
+        setLightDirection(const XMFLOAT3& direction);
+
+
+    /**
+     * @brief Distancia mxima con sombra y mezcla logartmica/uniforme de los cortes.
+     */
+    void
+        setSplitParams(float shadowDistance, float lambda);
+
+
+    /**
+     * @brief Obliga a redibujar las capas estticas (p. ej. tras reconstruir el batching).
+     */
+    void
+        invalidateStaticCasters();
+
+
+    /**
+     * @brief Anillo para las constantes por objeto de la cola de proyectores (no propietario).
+     */
+    void
+        setConstantRing(ConstantBufferRing* ring) { m_queue.setConstantRing(ring); }
+
+
+    // -----------------------------------------------------------------------------
+    // FRAME
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Ajusta las cascadas a la cmara (slo CPU). Llamar tras @c Camera::updateViewMatrix().
+     */
+    void
+        update(const Camera& camera);
+
+
+    /**
+     * @brief Dibuja los proyectores de cada cascada y sube las constantes de los receptores.
+     * Deja enlazados el viewport y el DSV de la ltima cascada dibujada.
+     * @param actors Actores candidatos (los fusionados los dibuja @p staticBatcher).
+     * @param staticBatcher Pginas estticas; se prueban malla a malla.
+     */
+    void
+        render(DeviceContext& deviceContext,
+               const std::vector<EU::TSharedPointer<Actor>>& actors,
+               StaticBatcher& staticBatcher);
+
+
+    /**
+     * @brief Enlaza mapa (t1), sampler de comparacin (s1) y constantes (b3) en el pixel shader.
+     */
+    void
+        bind(DeviceContext& deviceContext) const;
+
+
+    /**
+     * @brief Quita el mapa de t1 (antes de volver a escribirlo como profundidad).
+     */
+    void
+        unbind(DeviceContext& deviceContext) const;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Descripcin para importar el mapa vivo en el @c RenderGraph.
+     */
+    RGTextureDesc
+        getDesc() const;
+
+
+    ID3D11ShaderResourceView*
+        getShaderResourceView() const { return m_shaderResourceView; }
+
+
+    unsigned int
+        getCascadeCount() const { return m_cascadeCount; }
+
+
+    const ShadowCascade&
+        getCascade(unsigned int index) const { return m_cascades[index]; }
+
+
+    const ShadowStats&
+        getStats() const { return m_stats; }
+
+
+    /**
+     * @brief Indica si un AABB de mundo puede proyectar sombra dentro de la cascada.
+     * Lo que queda entre la luz y la caja cuenta: el rasterizador lo aplasta al plano cercano.
+     */
+    bool
+        intersects(unsigned int cascade, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax) const;
+
+
+private:
+
+    /**
+     * @brief Crea una textura array de profundidad con una DSV por capa (y SRV si se pide).
+     */
+    HRESULT
+        createDepthArray(Device& device,
+                         ID3D11Texture2D** texture,
+                         ID3D11DepthStencilView** depthStencilViews,
+                         ID3D11ShaderResourceView** shaderResourceView);
+
+
+    /**
+     * @brief Ordena y dibuja la cola de proyectores sobre una capa.
+     */
+    void
+        drawLayer(DeviceContext& deviceContext,
+                  ID3D11DepthStencilView* depthStencilView,
+                  unsigned int cascade);
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    unsigned int m_cascadeCount = 0;
+
+    unsigned int m_resolution = 0;
+
+    float m_shadowDistance = 40.0f;
+
+    float m_splitLambda = 0.75f;
+
+    /** @brief Direccin de la luz normalizada. */
+    XMFLOAT3 m_lightDirection = XMFLOAT3(-0.4f, -0.8f, 0.45f);
+
+    /** @brief Mundo -> espacio de luz (slo rotacin). */
+    XMFLOAT4X4 m_lightRotation = {};
+
+    ShadowCascade m_cascades[kMaxCascades];
+
+    /** @brief Mapa que leen los receptores: capa esttica + dinmicos. */
+    ID3D11Texture2D* m_shadowMap = nullptr;
+    ID3D11DepthStencilView* m_depthStencilViews[kMaxCascades] = {};
+    ID3D11ShaderResourceView* m_shaderResourceView = nullptr;
+
+    /** @brief Capa esttica de cada cascada (slo se rehace cuando cambia el ajuste). */
+    ID3D11Texture2D* m_staticMap = nullptr;
+    ID3D11DepthStencilView* m_staticDepthStencilViews[kMaxCascades] = {};
+
+    /** @brief Sampler de comparacin con PCF bilineal (propiedad de @c PipelineStateCache). */
+    ID3D11SamplerState* m_comparisonSampler = nullptr;
+
+    ShaderProgram m_shader;
+
+    ShaderProgram m_shaderInstanced;
+
+    /** @brief Cola de proyectores; se reutiliza capa a capa. */
+    RenderQueue m_queue;
+
+    /** @brief ViewProj de cada cascada (b0 del shader de sombra). */
+    Buffer m_cascadeBuffers[kMaxCascades];
+
+    /** @brief @c CBShadowCascades para los receptores (b3). */
+    Buffer m_receiverBuffer;
+
+    CBShadowCascades m_receiverConstants;
+
+    ShadowStats m_stats;
+
+};
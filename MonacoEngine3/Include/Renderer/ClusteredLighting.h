@@ -0,0 +1,365 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "Buffer.h"
+#include <vector>
+
+class Device;
+class DeviceContext;
+class Camera;
+class ThreadPool;
+
+// =================================================================================
+// ESTRUCTURAS: LUCES
+// =================================================================================
+
+/**
+ * @enum LightType
+ * @brief Tipos de luz dinmica que reparte @c ClusteredLighting.
+ */
+enum class LightType : unsigned int {
+    Point = 0,
+    Spot = 1
+};
+
+
+/**
+ * @struct Light
+ * @brief Luz puntual o foco en espacio de mundo.
+ */
+struct Light {
+    LightType type = LightType::Point;
+    XMFLOAT3 position = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    float range = 5.0f;                             ///< Distancia a la que la atenuacin llega a cero.
+    XMFLOAT3 color = XMFLOAT3(1.0f, 1.0f, 1.0f);    ///< Color ya multiplicado por la intensidad.
+    XMFLOAT3 direction = XMFLOAT3(0.0f, -1.0f, 0.0f); ///< Slo focos: hacia dnde apunta (se normaliza).
+    float spotAngle = XM_PIDIV4;                    ///< Slo focos: semingulo del cono en radianes.
+};
+
+
+/**
+ * @struct GPULight
+ * @brief Una luz visible tal como la lee el pixel shader (tres @c float4 en t2).
+ */
+struct GPULight {
+    XMFLOAT4 positionRange;     ///< xyz = posicin de mundo, w = alcance.
+    XMFLOAT4 colorType;         ///< rgb = color, w = @c LightType.
+    XMFLOAT4 directionCone;     ///< xyz = direccin del foco, w = coseno del semingulo.
+};
+
+
+/**
+ * @struct CBClusters
+ * @brief Constantes para que el pixel shader encuentre su cluster (b4).
+ */
+struct CBClusters {
+    XMFLOAT4 vClusterDims;      ///< x, y = teselas de pantalla, z = cortes de profundidad, w = luces visibles.
+    XMFLOAT4 vClusterDepth;     ///< x = fin del primer corte logartmico, y = fin del ltimo, z = cortes / log(y / x).
+    XMFLOAT4 vClusterScale;     ///< xy = teselas por pxel.
+};
+
+
+/**
+ * @struct ClusterStats
+ * @brief Resultado del ltimo @c assign().
+ */
+struct ClusterStats {
+    unsigned int lights = 0;                ///< Luces de la escena.
+    unsigned int visibleLights = 0;         ///< Las que tocan el frustum y se suben a la GPU.
+    unsigned int droppedLights = 0;         ///< Visibles que no cupieron en el buffer de luces.
+    unsigned int clusters = 0;
+    unsigned int activeClusters = 0;        ///< Clusters con al menos una luz.
+    unsigned int lightIndices = 0;          ///< Entradas de la lista compacta de ndices.
+    unsigned int maxLightsPerCluster = 0;
+    unsigned long long sphereTests = 0;     ///< Pruebas esfera-caja (filas y clusters, por luz).
+    double assignMs = 0.0;                  ///< Tiempo de CPU de @c assign().
+};
+
+
+// =================================================================================
+// CLASE: CLUSTERED LIGHTING
+// =================================================================================
+
+/**
+ * @class ClusteredLighting
+ * @brief Reparto de luces puntuales y focos en una rejilla 3D del frustum (froxels).
+ *
+ * La pantalla se divide en teselas y la profundidad de vista en cortes logartmicos; cada
+ * cluster es la caja (en espacio de vista) que envuelve un trozo del frustum. @c assign()
+ * pasa cada luz a espacio de vista como esfera (los focos, la esfera que envuelve el cono),
+ * descarta las que quedan fuera del frustum y reparte los cortes entre los hilos del
+ * @c ThreadPool. Cada corte filtra primero por profundidad, despus fila a fila y al final
+ * cluster a cluster; las pruebas esfera-caja se hacen de cuatro en cuatro luces con XNA Math.
+ *
+ * El resultado es una lista compacta: por cluster (desplazamiento, cantidad) y una sola
+ * lista de ndices de 16 bits a las luces visibles. @c upload() la sube a buffers tipados
+ * (shader model 4 no tiene structured buffers en el pixel shader) y @c bind() los enlaza en
+ * t2..t4 con las constantes en b4.
+ *
+ * @c assign() no toca la GPU: se puede medir sin dispositivo.
+ */
+class ClusteredLighting {
+
+public:
+
+    /** @brief Luces visibles como mximo (los ndices son de 16 bits). */
+    static const unsigned int kMaxVisibleLights = 65535;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    ClusteredLighting() = default;
+
+    ~ClusteredLighting() = default;
+
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Define la rejilla y crea los buffers de luces, clusters e ndices.
+     * @param device Dispositivo grfico.
+     * @param width Ancho del render target en pxeles.
+     * @param height Alto del render target en pxeles.
+     * @param tilesX Teselas horizontales.
+     * @param tilesY Teselas verticales.
+     * @param slices Cortes de profundidad.
+     * @param maxLights Luces visibles que caben en la GPU (como mucho @c kMaxVisibleLights).
+     * @return Error de creacin de algn buffer o vista.
+     */
+    HRESULT
+        init(Device& device,
+             unsigned int width,
+             unsigned int height,
+             unsigned int tilesX = 16,
+             unsigned int tilesY = 9,
+             unsigned int slices = 24,
+             unsigned int maxLights = 16384);
+
+
+    /**
+     * @brief Libera buffers y vistas; olvida las luces.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // CONFIGURACIN
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Sustituye las luces de la escena.
+     */
+    void
+        setLights(const std::vector<Light>& lights) { m_lights = lights; }
+
+
+    /**
+     * @brief Luces de la escena, para moverlas sin copiar la lista.
+     */
+    std::vector<Light>&
+        getLights() { return m_lights; }
+
+
+    /**
+     * @brief Tramo de profundidad de vista que cubren los cortes.
+     * Lo ms cercano que @p nearZ cae en el primer corte; ms all de @p farZ no hay luces.
+     */
+    void
+        setDepthRange(float nearZ, float farZ);
+
+
+    /**
+     * @brief Tamao del render target (tras redimensionar).
+     */
+    void
+        setViewportSize(unsigned int width, unsigned int height);
+
+
+    // -----------------------------------------------------------------------------
+    // FRAME
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Reparte las luces entre los clusters (slo CPU). Llamar tras @c Camera::updateViewMatrix().
+     * @param threadPool Hilos entre los que se reparten los cortes; sin hilos se hace en serie.
+     */
+    void
+        assign(const Camera& camera, ThreadPool& threadPool);
+
+
+    /**
+     * @brief Sube luces visibles, rejilla, ndices y constantes del ltimo @c assign().
+     * La lista de ndices crece (al doble) si no cabe.
+     * @return Error al mapear o al recrear el buffer de ndices.
+     */
+    HRESULT
+        upload(Device& device, DeviceContext& deviceContext);
+
+
+    /**
+     * @brief Enlaza luces (t2), rejilla (t3), ndices (t4) y constantes (b4) en el pixel shader.
+     */
+    void
+        bind(DeviceContext& deviceContext) const;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    const ClusterStats&
+        getStats() const { return m_stats; }
+
+
+    unsigned int
+        getClusterCount() const { return m_tilesX * m_tilesY * m_slices; }
+
+
+    /**
+     * @brief ndices (en la lista de luces visibles) que tocan un cluster.
+     * @param count Recibe la cantidad; el puntero no es vlido tras el siguiente @c assign().
+     */
+    const unsigned short*
+        getClusterLights(unsigned int cluster, unsigned int& count) const;
+
+
+private:
+
+    /** @brief Cuatro esferas en formato SoA para probarlas a la vez. */
+    struct SphereBlock {
+        XMFLOAT4A x;
+        XMFLOAT4A y;
+        XMFLOAT4A z;
+        XMFLOAT4A radiusSq;
+    };
+
+    /** @brief Memoria de trabajo de un corte; se reutiliza entre frames. */
+    struct SliceWork {
+        std::vector<unsigned short> sliceLights;
+        std::vector<SphereBlock> sliceBlocks;
+        std::vector<unsigned short> rowLights;
+        std::vector<SphereBlock> rowBlocks;
+        std::vector<unsigned short> indices;    ///< ndices de los clusters del corte, en orden.
+        std::vector<unsigned int> counts;       ///< Luces de cada cluster del corte.
+        unsigned long long tests = 0;
+    };
+
+
+    /**
+     * @brief Recalcula profundidades de los cortes y cajas de clusters y filas.
+     */
+    void
+        buildClusterBounds(const Camera& camera);
+
+
+    /**
+     * @brief Esferas de vista de las luces visibles y sus datos para la GPU.
+     */
+    void
+        cullLights(const Camera& camera);
+
+
+    /**
+     * @brief Asigna las luces de un corte a sus clusters (un hilo por corte).
+     */
+    void
+        assignSlice(unsigned int slice);
+
+
+    /**
+     * @brief Buffer dinmico tipado con su SRV.
+     */
+    HRESULT
+        createTypedBuffer(Device& device,
+                          Buffer& buffer,
+                          ID3D11ShaderResourceView** shaderResourceView,
+                          unsigned int stride,
+                          unsigned int elementCount,
+                          DXGI_FORMAT format);
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    unsigned int m_tilesX = 0;
+
+    unsigned int m_tilesY = 0;
+
+    unsigned int m_slices = 0;
+
+    unsigned int m_width = 0;
+
+    unsigned int m_height = 0;
+
+    unsigned int m_maxLights = 0;
+
+    /** @brief Tramo de los cortes logartmicos (el primero empieza en el plano cercano). */
+    float m_depthNear = 0.5f;
+
+    float m_depthFar = 100.0f;
+
+    /** @brief Parmetros de cmara con los que se calcularon las cajas. */
+    float m_boundsFovY = 0.0f;
+
+    float m_boundsAspect = 0.0f;
+
+    float m_boundsNear = 0.0f;
+
+    bool m_boundsDirty = true;
+
+    std::vector<Light> m_lights;
+
+    /** @brief Profundidad de vista donde empieza cada corte (m_slices + 1 valores). */
+    std::vector<float> m_sliceDepths;
+
+    /** @brief Cajas de vista por cluster, ordenadas como la rejilla (x, luego y, luego corte). */
+    std::vector<XMFLOAT3> m_clusterMin;
+
+    std::vector<XMFLOAT3> m_clusterMax;
+
+    /** @brief Caja que une los clusters de cada fila de cada corte. */
+    std::vector<XMFLOAT3> m_rowMin;
+
+    std::vector<XMFLOAT3> m_rowMax;
+
+    /** @brief Luces visibles: centro de vista (xyz) y radio (w). */
+    std::vector<XMFLOAT4> m_viewSpheres;
+
+    std::vector<GPULight> m_gpuLights;
+
+    std::vector<SliceWork> m_sliceWork;
+
+    /** @brief Por cluster: desplazamiento en @c m_indices y cantidad. */
+    std::vector<unsigned int> m_grid;
+
+    std::vector<unsigned short> m_indices;
+
+    CBClusters m_constants;
+
+    Buffer m_lightBuffer;
+    ID3D11ShaderResourceView* m_lightView = nullptr;
+
+    Buffer m_gridBuffer;
+    ID3D11ShaderResourceView* m_gridView = nullptr;
+
+    Buffer m_indexBuffer;
+    ID3D11ShaderResourceView* m_indexView = nullptr;
+
+    unsigned int m_indexCapacity = 0;
+
+    Buffer m_constantBuffer;
+
+    ClusterStats m_stats;
+
+};
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "Buffer.h"
+#include "Renderer/RingAllocator.h"
+
+class Device;
+class DeviceContext;
+
+// =================================================================================
+// ESTRUCTURAS: ASIGNACIN DE CONSTANTES
+// =================================================================================
+
+/**
+ * @struct ConstantBufferAllocation
+ * @brief Rango de constantes listo para enlazar.
+ *
+ * En el camino D3D11.1 @c buffer es el anillo compartido y el rango se expresa en
+ * constantes de 16 bytes (mltiplos de 16). En el camino de respaldo @c buffer es
+ * un constant buffer propio y @c numConstants vale 0 (se enlaza completo).
+ */
+struct ConstantBufferAllocation {
+    ID3D11Buffer* buffer = nullptr;
+    unsigned int firstConstant = 0;
+    unsigned int numConstants = 0;
+
+    bool
+        isValid() const { return buffer != nullptr; }
+};
+
+
+/**
+ * @struct ConstantBufferRingStats
+ * @brief Contadores del frame actual.
+ */
+struct ConstantBufferRingStats {
+    unsigned int allocations = 0;      ///< Bloques entregados.
+    unsigned int bytesWritten = 0;     ///< Bytes copiados por la CPU (sin relleno).
+    unsigned int discardMaps = 0;      ///< Maps con WRITE_DISCARD.
+    unsigned int noOverwriteMaps = 0;  ///< Maps con WRITE_NO_OVERWRITE.
+    unsigned int fallbackAllocations = 0; ///< Bloques servidos por buffers propios.
+};
+
+
+// =================================================================================
+// CLASE: CONSTANT BUFFER RING
+// =================================================================================
+
+/**
+ * @class ConstantBufferRing
+ * @brief Memoria de constantes por frame sub-asignada de un nico buffer dinmico.
+ *
+ * Con D3D11.1 cada bloque (alineado a 256 bytes) se escribe con
+ * @c WRITE_NO_OVERWRITE y se enlaza con @c *SSetConstantBuffers1; el anillo slo se
+ * descarta la primera vez que se mapea. Sin D3D11.1 (o si el anillo se llena) cada
+ * bloque sale de un pool de constant buffers dinmicos que se mapean con
+ * @c WRITE_DISCARD, uno por asignacin y frame.
+ */
+class ConstantBufferRing {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    ConstantBufferRing() = default;
+
+    ~ConstantBufferRing() = default;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Crea el anillo si el backend admite offsets; si no, slo prepara el pool.
+     * @param device Dispositivo para crear buffers (se guarda para el pool de respaldo).
+     * @param deviceContext Contexto usado para consultar el soporte de D3D11.1.
+     * @param capacity Bytes del anillo.
+     * @param framesInFlight Frames que la GPU puede ir por detrs.
+     */
+    HRESULT
+        init(Device& device,
+             DeviceContext& deviceContext,
+             unsigned int capacity = 4 * 1024 * 1024,
+             unsigned int framesInFlight = 3);
+
+
+    /**
+     * @brief Cambia cuntos frames retiene el anillo antes de reutilizar su memoria.
+     * Vaca el anillo; el siguiente Map es DISCARD, as que los datos en vuelo no se pisan.
+     * @param framesInFlight Debe cubrir la latencia mxima de la cadena (latencia + 1).
+     */
+    void
+        setFramesInFlight(unsigned int framesInFlight);
+
+
+    /**
+     * @brief Recupera la memoria del frame ms antiguo en vuelo y reinicia el pool.
+     */
+    void
+        beginFrame();
+
+
+    /**
+     * @brief Copia @c size bytes a un bloque nuevo y devuelve su rango.
+     * @return Asignacin invlida si no se pudo mapear ningn buffer.
+     */
+    ConstantBufferAllocation
+        upload(DeviceContext& deviceContext, const void* data, unsigned int size);
+
+
+    /**
+     * @brief Enlaza una asignacin en VS (y opcionalmente PS) por el camino que corresponda.
+     */
+    static void
+        bind(DeviceContext& deviceContext,
+             unsigned int slot,
+             const ConstantBufferAllocation& allocation,
+             bool pixelShader);
+
+
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /** @brief true si se usa el anillo con offsets (D3D11.1). */
+    bool
+        usesOffsets() const { return m_useOffsets; }
+
+    const ConstantBufferRingStats&
+        getStats() const { return m_stats; }
+
+    const RingAllocator&
+        getAllocator() const { return m_allocator; }
+
+
+private:
+
+    /**
+     * @brief Asignacin por el camino de respaldo (un constant buffer por bloque).
+     */
+    ConstantBufferAllocation
+        uploadFallback(DeviceContext& deviceContext, const void* data, unsigned int size);
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    /** @brief Dispositivo para crear buffers del pool (no propietario). */
+    Device* m_device = nullptr;
+
+    /** @brief Buffer grande del anillo (slo con D3D11.1). */
+    Buffer m_ring;
+
+    /** @brief Offsets libres/ocupados del anillo. */
+    RingAllocator m_allocator;
+
+    /** @brief true hasta el primer Map del anillo (que debe ser DISCARD). */
+    bool m_needsDiscard = true;
+
+    bool m_useOffsets = false;
+
+    /** @brief Pool de respaldo y su tamao por entrada. */
+    std::vector<Buffer> m_fallback;
+    std::vector<unsigned int> m_fallbackSizes;
+    unsigned int m_fallbackUsed = 0;
+
+    ConstantBufferRingStats m_stats;
+
+};
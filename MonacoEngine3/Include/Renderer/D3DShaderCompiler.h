@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "Renderer/ShaderCompiler.h"
+
+// =================================================================================
+// CLASE: D3D SHADER COMPILER
+// =================================================================================
+
+/**
+ * @class D3DShaderCompiler
+ * @brief @c IShaderCompiler sobre @c D3DX11CompileFromFile (resuelve los @c #include del archivo).
+ */
+class D3DShaderCompiler : public IShaderCompiler {
+
+public:
+
+    D3DShaderCompiler() = default;
+
+    ~D3DShaderCompiler() = default;
+
+
+    bool
+        compile(const ShaderCompileRequest& request,
+                std::vector<unsigned char>& bytecode,
+                std::string& errors) override;
+
+
+    const char*
+        getName() const override { return "D3DX11CompileFromFile"; }
+
+
+    /**
+     * @brief Flags con los que el motor compila siempre sus shaders
+     * (@c D3DCOMPILE_ENABLE_STRICTNESS, ms @c D3DCOMPILE_DEBUG en Debug).
+     */
+    static unsigned int
+        getDefaultFlags();
+
+};
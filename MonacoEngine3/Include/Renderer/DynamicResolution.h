@@ -0,0 +1,276 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "Buffer.h"
+#include "ShaderProgram.h"
+#include "Renderer/PipelineStateCache.h"
+
+class Device;
+class DeviceContext;
+class ShaderCache;
+
+// =================================================================================
+// ESTRUCTURAS: CONTROLADOR
+// =================================================================================
+
+/**
+ * @struct ResolutionControllerSettings
+ * @brief Presupuesto, lmites y ganancias del controlador de escala.
+ */
+struct ResolutionControllerSettings {
+    float targetMs = 16.6f;             ///< Presupuesto de tiempo por frame.
+    float minScale = 0.5f;              ///< Escala mnima por eje.
+    float maxScale = 1.0f;              ///< Escala mxima por eje.
+    float proportionalGain = 0.2f;      ///< Kp sobre el cambio del error relativo.
+    float integralGain = 0.05f;         ///< Ki sobre el error relativo de cada frame.
+    float derivativeGain = 0.02f;       ///< Kd sobre la curvatura del error.
+    float smoothing = 0.25f;            ///< Peso de la muestra nueva en la media exponencial.
+    float scaleStep = 1.0f / 32.0f;     ///< La escala aplicada slo cambia en pasos de este tamao.
+    float deadband = 0.04f;             ///< Error relativo que se da por bueno (se resta antes del PID).
+};
+
+
+/**
+ * @struct ResolutionControllerStats
+ * @brief Estado del controlador tras la ltima muestra.
+ */
+struct ResolutionControllerStats {
+    unsigned int samples = 0;           ///< Frames medidos desde @c reset().
+    unsigned int framesOverBudget = 0;  ///< Muestras por encima de @c targetMs.
+    unsigned int scaleChanges = 0;      ///< Veces que cambi la escala aplicada.
+    float filteredMs = 0.0f;            ///< Media exponencial del tiempo de frame.
+    float error = 0.0f;                 ///< (objetivo - medido) / objetivo; positivo = sobra tiempo.
+    float rawScale = 1.0f;              ///< Salida continua del controlador, antes de cuantizar.
+};
+
+
+// =================================================================================
+// CLASE: RESOLUTION CONTROLLER
+// =================================================================================
+
+/**
+ * @class ResolutionController
+ * @brief PID que ajusta la escala de resolucin a partir de tiempos de frame medidos.
+ *
+ * Slo aritmtica: no toca la GPU y su salida depende nicamente de la secuencia de
+ * tiempos, as que se puede probar con trazas sintticas.
+ *
+ * Usa la forma incremental (de velocidad): cada frame suma a la escala
+ * @c Kp*(e - e1) + @c Ki*e + @c Kd*(e - 2*e1 + e2), con @c e el error relativo. Al
+ * recortar la escala a [min, max] no se acumula integral (sin windup). El tiempo se
+ * filtra con una media exponencial para que un pico aislado no hunda la resolucin, y
+ * la escala aplicada se cuantiza a @c scaleStep para no cambiar de tamao cada frame.
+ * Dentro de @c deadband el error cuenta como cero: sin ella, cuando el presupuesto cae
+ * entre dos pasos de escala, la integral salta de uno a otro sin parar.
+ */
+class ResolutionController {
+
+public:
+
+    ResolutionController() = default;
+
+    ~ResolutionController() = default;
+
+
+    /**
+     * @brief Cambia ajustes; la escala actual se recorta a los nuevos lmites.
+     */
+    void
+        setSettings(const ResolutionControllerSettings& settings);
+
+
+    const ResolutionControllerSettings&
+        getSettings() const { return m_settings; }
+
+
+    /**
+     * @brief Vuelve a la escala mxima y olvida el historial.
+     */
+    void
+        reset();
+
+
+    /**
+     * @brief Aade una muestra y devuelve la escala aplicada para el siguiente frame.
+     * @param frameMs Tiempo del frame recin terminado (las muestras <= 0 se ignoran).
+     */
+    float
+        update(float frameMs);
+
+
+    /** @brief Escala por eje a aplicar (cuantizada). */
+    float
+        getScale() const { return m_scale; }
+
+
+    const ResolutionControllerStats&
+        getStats() const { return m_stats; }
+
+
+private:
+
+    ResolutionControllerSettings m_settings;
+
+    /** @brief Escala aplicada (mltiplo de @c scaleStep dentro de los lmites). */
+    float m_scale = 1.0f;
+
+    /** @brief Errores de los dos frames anteriores. */
+    float m_previousError = 0.0f;
+
+    float m_previousError2 = 0.0f;
+
+    ResolutionControllerStats m_stats;
+
+};
+
+
+// =================================================================================
+// ESTRUCTURAS: ESCALADO
+// =================================================================================
+
+/**
+ * @struct CBUpscale
+ * @brief Constantes del pase de escalado (b0).
+ */
+struct CBUpscale {
+    XMFLOAT4 vUVScale;      ///< xy = parte usada del objetivo interno, zw = UV mxima (medio texel dentro).
+};
+
+
+// =================================================================================
+// CLASE: DYNAMIC RESOLUTION
+// =================================================================================
+
+/**
+ * @class DynamicResolution
+ * @brief Escena a resolucin variable dentro de un objetivo de tamao fijo y escalado al back buffer.
+ *
+ * El objetivo interno siempre mide lo mismo que el back buffer; la escena slo dibuja en la
+ * esquina superior izquierda que marca @c getSceneViewport(). As el @c RenderGraph reutiliza
+ * la misma textura fsica cada frame (D3D11 no puede reinterpretar memoria a otro tamao) y
+ * cambiar de escala no crea nada. @c upscale() estira esa regin al back buffer con filtrado
+ * bilineal.
+ */
+class DynamicResolution {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    DynamicResolution() = default;
+
+    ~DynamicResolution() = default;
+
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Crea el quad de pantalla completa, el shader de escalado y sus estados.
+     * @param layout Layout de @c SimpleVertex (posicin + UV).
+     * @param width Ancho del back buffer.
+     * @param height Alto del back buffer.
+     */
+    HRESULT
+        init(Device& device,
+             ShaderCache& cache,
+             const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout,
+             unsigned int width,
+             unsigned int height);
+
+
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // CONTROL
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Con el escalado desactivado la escena va directa al back buffer a escala 1.
+     */
+    void
+        setEnabled(bool enabled);
+
+
+    bool
+        isEnabled() const { return m_enabled; }
+
+
+    ResolutionController&
+        getController() { return m_controller; }
+
+
+    const ResolutionController&
+        getController() const { return m_controller; }
+
+
+    /**
+     * @brief Pasa el tiempo del ltimo frame al controlador (no hace nada si est desactivado).
+     */
+    void
+        update(float frameMs);
+
+
+    // -----------------------------------------------------------------------------
+    // FRAME
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Viewport de la escena: la parte del objetivo interno que cubre la escala actual.
+     */
+    D3D11_VIEWPORT
+        getSceneViewport() const;
+
+
+    /**
+     * @brief Estira la regin de la escena de @p source a todo @p target.
+     * @param source Objetivo interno ya resuelto (una muestra).
+     */
+    void
+        upscale(DeviceContext& deviceContext,
+                ID3D11ShaderResourceView* source,
+                ID3D11RenderTargetView* target);
+
+
+    /** @brief Escala por eje que se est aplicando. */
+    float
+        getScale() const { return m_enabled ? m_controller.getScale() : 1.0f; }
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    ResolutionController m_controller;
+
+    /** @brief Apagado hasta que se da un presupuesto (@c --resolution-budget). */
+    bool m_enabled = false;
+
+    unsigned int m_width = 0;
+
+    unsigned int m_height = 0;
+
+    ShaderProgram m_shader;
+
+    PipelineHandle m_pipeline = kNoPipeline;
+
+    /** @brief Bilineal con clamp (propiedad de @c PipelineStateCache). */
+    ID3D11SamplerState* m_sampler = nullptr;
+
+    Buffer m_vertexBuffer;
+
+    Buffer m_indexBuffer;
+
+    Buffer m_constantBuffer;
+
+};
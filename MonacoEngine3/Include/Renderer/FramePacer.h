@@ -0,0 +1,289 @@
+#pragma once
+
+#include "Prerequisites.h"
+
+class Device;
+class DeviceContext;
+
+// =================================================================================
+// ESTRUCTURAS: RITMO DE FRAMES
+// =================================================================================
+
+/**
+ * @struct FramePacerSettings
+ * @brief Ritmo objetivo, margen de espera activa y latencia mxima de la GPU.
+ */
+struct FramePacerSettings {
+    float targetFps = 0.0f;             ///< Frames por segundo objetivo (0 = sin lmite).
+    float spinMs = 1.0f;                ///< ltimos ms de la espera que se hacen girando, no durmiendo.
+    unsigned int maxFrameLatency = 2;   ///< Frames que la CPU puede ir por delante de la GPU (1..16).
+    bool vsync = false;                 ///< Present con intervalo 1 en lugar de 0.
+};
+
+
+/**
+ * @struct FramePacerStats
+ * @brief Tiempos de los ltimos @c FramePacer::kWindow frames.
+ */
+struct FramePacerStats {
+    unsigned long long frames = 0;      ///< Frames registrados desde @c reset().
+    unsigned int framesMissed = 0;      ///< Frames que empezaron tarde (sin espera) desde @c reset().
+    float frameMsAvg = 0.0f;
+    float frameMsStdDev = 0.0f;         ///< Desviacin tpica del tiempo entre frames (jitter).
+    float frameMsWorst = 0.0f;
+    float latencyMsAvg = 0.0f;          ///< De la primera entrada leda a la vuelta de Present.
+    float latencyMsWorst = 0.0f;
+    float sleepMsAvg = 0.0f;            ///< Parte de la espera en el temporizador.
+    float spinMsAvg = 0.0f;             ///< Parte de la espera girando.
+    float lateMsAvg = 0.0f;             ///< Retraso al despertar respecto al instante pedido.
+    float gpuWaitMsAvg = 0.0f;          ///< Espera a la GPU por la latencia mxima.
+};
+
+
+// =================================================================================
+// CLASE: FRAME PACER
+// =================================================================================
+
+/**
+ * @class FramePacer
+ * @brief Limita el ritmo de frames, acota cuntos frames encola la CPU y mide el jitter.
+ *
+ * Cada frame empieza en un instante fijo (el anterior ms el periodo objetivo), as que el
+ * error de un frame no se arrastra al siguiente; si un frame llega ms de un periodo tarde,
+ * el calendario se vuelve a anclar en el momento actual. La espera duerme en un temporizador
+ * de alta resolucin hasta @c spinMs antes del instante y gira el resto.
+ *
+ * La latencia se acota por dos vas: @c IDXGIDevice1::SetMaximumFrameLatency y un anillo de
+ * consultas de evento; antes de empezar un frame se espera a que la GPU termine el de hace
+ * @c maxFrameLatency frames, durmiendo entre sondeos.
+ *
+ * @c scheduleFrame() y @c recordFrame() slo hacen aritmtica sobre ticks y milisegundos,
+ * as que el calendario y las estadsticas se pueden probar sin ventana ni GPU.
+ */
+class FramePacer {
+
+public:
+
+    /** @brief Frames que entran en las estadsticas. */
+    static const unsigned int kWindow = 240;
+
+    /** @brief Tope de @c maxFrameLatency (el de DXGI). */
+    static const unsigned int kMaxFrameLatency = 16;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    FramePacer() = default;
+
+    ~FramePacer() = default;
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Crea el temporizador y, con @p device, las consultas de latencia.
+     * @param device Sin dispositivo (headless) slo se limita el ritmo.
+     */
+    HRESULT
+        init(Device* device);
+
+
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // AJUSTES
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Cambia los ajustes; la latencia se aplica tambin al dispositivo DXGI.
+     */
+    void
+        setSettings(const FramePacerSettings& settings);
+
+
+    const FramePacerSettings&
+        getSettings() const { return m_settings; }
+
+
+    /** @brief Intervalo para @c IDXGISwapChain::Present. */
+    unsigned int
+        getSyncInterval() const { return m_settings.vsync ? 1 : 0; }
+
+
+    /**
+     * @brief Olvida el calendario y las estadsticas.
+     */
+    void
+        reset();
+
+
+    // -----------------------------------------------------------------------------
+    // FRAME
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Espera a la GPU (latencia) y despus al instante de inicio del frame.
+     * @param deviceContext Contexto inmediato; nullptr no espera a la GPU.
+     */
+    void
+        waitForFrame(DeviceContext* deviceContext);
+
+
+    /**
+     * @brief Anota una entrada (teclado, ratn) en el momento actual; para entrada sinttica.
+     */
+    void
+        markInput();
+
+
+    /**
+     * @brief Anota una entrada con la hora a la que la gener el sistema, no a la que se ley.
+     * Se queda la ms antigua desde el ltimo Present.
+     * @param messageTime @c MSG::time (reloj de @c GetTickCount, en ms).
+     */
+    void
+        markInput(DWORD messageTime);
+
+
+    /**
+     * @brief Cierra el frame tras Present: marca su fin en la GPU y registra los tiempos.
+     * @param deviceContext Contexto inmediato; nullptr no marca la GPU.
+     */
+    void
+        framePresented(DeviceContext* deviceContext);
+
+
+    // -----------------------------------------------------------------------------
+    // CALENDARIO (slo aritmtica)
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Avanza el calendario y devuelve hasta cundo esperar.
+     * @param now Ticks actuales.
+     * @param ticksPerSecond Frecuencia de @p now.
+     * @return Instante de inicio del frame; <= @p now si no hay que esperar.
+     */
+    long long
+        scheduleFrame(long long now, long long ticksPerSecond);
+
+
+    /**
+     * @brief Registra un frame en las estadsticas.
+     * @param frameMs Tiempo desde el inicio del frame anterior.
+     * @param latencyMs Entrada-Present, o negativo si el frame no ley entrada.
+     * @param sleepMs Tiempo dormido.
+     * @param spinMs Tiempo girando.
+     * @param lateMs Retraso al empezar respecto al instante pedido.
+     */
+    void
+        recordFrame(float frameMs, float latencyMs, float sleepMs, float spinMs, float lateMs);
+
+
+    const FramePacerStats&
+        getStats() const { return m_stats; }
+
+
+    /**
+     * @brief Trabajo del ltimo frame: de su inicio (tras las esperas) a la vuelta de Present.
+     * Es la medida para la resolucin dinmica; el tiempo entre frames incluye la espera del ritmo.
+     */
+    float
+        getFrameWorkMs() const { return m_frameWorkMs; }
+
+
+private:
+
+    /** @brief Muestras de un frame en el anillo de estadsticas. */
+    struct FrameSample {
+        float frameMs = 0.0f;
+        float latencyMs = -1.0f;
+        float sleepMs = 0.0f;
+        float spinMs = 0.0f;
+        float lateMs = 0.0f;
+        float gpuWaitMs = 0.0f;
+    };
+
+
+    /** @brief Guarda una muestra en el anillo y recalcula las estadsticas. */
+    void
+        addSample(const FrameSample& sample);
+
+
+    /**
+     * @brief Duerme hasta @c spinMs antes de @p deadline y gira el resto.
+     * @param sleepMs Salida: tiempo dormido.
+     * @param spinMs Salida: tiempo girando.
+     */
+    void
+        waitUntil(long long deadline, float& sleepMs, float& spinMs);
+
+
+    /** @brief Duerme @p ticks en el temporizador (o con @c Sleep si no lo hay). */
+    void
+        sleepTicks(long long ticks);
+
+
+    /** @brief Aplica @c maxFrameLatency al dispositivo DXGI. */
+    void
+        applyFrameLatency();
+
+
+    static long long
+        now();
+
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    FramePacerSettings m_settings;
+
+    long long m_frequency = 1;
+
+    /** @brief Instante de inicio del frame en curso. */
+    long long m_deadline = 0;
+
+    /** @brief El calendario ya est anclado (hay un @c m_deadline vlido). */
+    bool m_scheduled = false;
+
+    /** @brief Inicio real del frame anterior y del actual. */
+    long long m_previousStart = 0;
+
+    long long m_frameStart = 0;
+
+    /** @brief Primera entrada del frame (0 = ninguna). */
+    long long m_inputTicks = 0;
+
+    /** @brief Ver @c getFrameWorkMs(). */
+    float m_frameWorkMs = 0.0f;
+
+    /** @brief Tiempos de la espera del frame en curso, registrados en @c framePresented(). */
+    FrameSample m_current;
+
+    std::vector<FrameSample> m_samples;
+
+    unsigned int m_nextSample = 0;
+
+    FramePacerStats m_stats;
+
+    /** @brief Temporizador de alta resolucin (o normal si el sistema no lo tiene). */
+    HANDLE m_timer = nullptr;
+
+    IDXGIDevice1* m_dxgiDevice = nullptr;
+
+    /** @brief Fin de cada uno de los ltimos frames en la GPU. */
+    std::vector<ID3D11Query*> m_frameQueries;
+
+    /** @brief Frames cerrados con consulta (ndice en el anillo). */
+    unsigned long long m_queriesIssued = 0;
+
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+
+// =================================================================================
+// CLASE: FREE LIST ALLOCATOR
+// =================================================================================
+
+/**
+ * @class FreeListAllocator
+ * @brief Sub-asignador de rangos [offset, offset + size) con lista libre, sin dependencias de D3D.
+ *
+ * Igual que @c RingAllocator slo administra nmeros; la memoria real la gestiona
+ * quien lo usa (p. ej. @c MeshPool). Los huecos libres se indexan por offset (para
+ * fusionar vecinos al liberar) y por tamao (para elegir el ms ajustado), as que
+ * asignar y liberar cuestan O(log n) en el nmero de huecos.
+ */
+class FreeListAllocator {
+
+public:
+
+    /** @brief Valor devuelto por @c allocate() cuando no hay un hueco suficiente. */
+    static const unsigned int kInvalidOffset = ~0u;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    FreeListAllocator() = default;
+
+    ~FreeListAllocator() = default;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Deja todo el rango [0, capacity) libre.
+     */
+    void
+        init(unsigned int capacity);
+
+
+    /**
+     * @brief Reserva un rango contiguo (best fit).
+     * @return Offset del rango o @c kInvalidOffset si ningn hueco es suficiente.
+     */
+    unsigned int
+        allocate(unsigned int size);
+
+
+    /**
+     * @brief Devuelve un rango obtenido con @c allocate() y lo fusiona con sus vecinos libres.
+     * @return false si @p offset no corresponde a una asignacin viva.
+     */
+    bool
+        free(unsigned int offset);
+
+
+    /**
+     * @brief Olvida todas las asignaciones (todo vuelve a estar libre).
+     */
+    void
+        reset() { init(m_capacity); }
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    unsigned int
+        getCapacity() const { return m_capacity; }
+
+    unsigned int
+        getUsed() const { return m_used; }
+
+    unsigned int
+        getFree() const { return m_capacity - m_used; }
+
+    unsigned int
+        getAllocationCount() const { return static_cast<unsigned int>(m_allocated.size()); }
+
+    unsigned int
+        getFreeBlockCount() const { return static_cast<unsigned int>(m_freeByOffset.size()); }
+
+
+    /**
+     * @brief Hueco libre ms grande (la mayor asignacin que cabe ahora mismo).
+     */
+    unsigned int
+        getLargestFree() const { return m_freeBySize.empty() ? 0 : m_freeBySize.rbegin()->first; }
+
+
+    /**
+     * @brief 0 si todo el espacio libre es contiguo; tiende a 1 cuanto ms repartido est.
+     */
+    float
+        getFragmentation() const {
+        unsigned int freeTotal = getFree();
+        return freeTotal == 0 ? 0.0f : 1.0f - static_cast<float>(getLargestFree()) / freeTotal;
+    }
+
+
+private:
+
+    /**
+     * @brief Registra un hueco libre en ambos ndices.
+     */
+    void
+        insertFree(unsigned int offset, unsigned int size);
+
+
+    /**
+     * @brief Quita un hueco de ambos ndices.
+     */
+    void
+        eraseFree(std::map<unsigned int, unsigned int>::iterator block);
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    /** @brief Huecos libres: offset -> tamao. */
+    std::map<unsigned int, unsigned int> m_freeByOffset;
+
+    /** @brief Huecos libres: tamao -> offset (varios huecos pueden medir lo mismo). */
+    std::multimap<unsigned int, unsigned int> m_freeBySize;
+
+    /** @brief Asignaciones vivas: offset -> tamao. */
+    std::unordered_map<unsigned int, unsigned int> m_allocated;
+
+    unsigned int m_capacity = 0;
+    unsigned int m_used = 0;
+
+};
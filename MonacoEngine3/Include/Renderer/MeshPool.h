@@ -0,0 +1,237 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "Buffer.h"
+#include "Renderer/FreeListAllocator.h"
+
+class Device;
+class DeviceContext;
+class MeshComponent;
+
+// =================================================================================
+// ESTRUCTURAS: MALLAS EN EL POOL
+// =================================================================================
+
+/** @brief Identificador de una malla dentro de un @c MeshPool. */
+using MeshHandle = unsigned int;
+
+/** @brief Handle que no apunta a ninguna malla. */
+const MeshHandle kInvalidMesh = ~0u;
+
+
+/**
+ * @struct MeshRange
+ * @brief Posicin de una malla dentro de los buffers compartidos.
+ *
+ * Los ndices se guardan locales a la malla, as que se dibuja con
+ * @c DrawIndexed(indexCount, startIndex, baseVertex).
+ */
+struct MeshRange {
+    unsigned int baseVertex = 0;    ///< Primer vrtice dentro del vertex buffer del pool.
+    unsigned int vertexCount = 0;
+    unsigned int startIndex = 0;    ///< Primer ndice dentro del index buffer del pool.
+    unsigned int indexCount = 0;
+};
+
+
+/**
+ * @struct MeshPoolStats
+ * @brief Ocupacin y fragmentacin de los buffers compartidos.
+ */
+struct MeshPoolStats {
+    unsigned int vertexCapacity = 0;    ///< Vrtices que caben en el vertex buffer.
+    unsigned int verticesUsed = 0;
+    unsigned int indexCapacity = 0;     ///< ndices que caben en el index buffer.
+    unsigned int indicesUsed = 0;
+    unsigned int meshes = 0;            ///< Mallas vivas.
+    float vertexFragmentation = 0.0f;   ///< 0 = espacio libre contiguo (ver @c FreeListAllocator).
+    float indexFragmentation = 0.0f;
+    unsigned int defragmentations = 0;  ///< Compactaciones y crecimientos hechos.
+    unsigned long long bytesMoved = 0;  ///< Bytes copiados de GPU a GPU al compactar.
+};
+
+
+// =================================================================================
+// CLASE: MESH POOL
+// =================================================================================
+
+/**
+ * @class MeshPool
+ * @brief Un vertex buffer y un index buffer compartidos por todas las mallas que se suben.
+ *
+ * Cada malla ocupa un tramo de cada buffer, reservado con un @c FreeListAllocator, y se
+ * dibuja con @c BaseVertexLocation / @c StartIndexLocation. As todos los actores del pool
+ * enlazan los mismos buffers y la cola de render no vuelve a enlazarlos entre draws.
+ *
+ * Si un tramo no cabe, el pool se compacta (copias GPU a GPU con
+ * @c CopySubresourceRegion) cuando el espacio libre total alcanza, o crece al doble.
+ * En ambos casos cambian los buffers y los rangos: hay que consultarlos con
+ * @c getRange() / @c getVertexBuffer() cada vez que se dibuja, no guardarlos.
+ */
+class MeshPool {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    MeshPool() = default;
+
+    ~MeshPool() = default;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Crea los buffers compartidos.
+     * @param device Dispositivo para crear los buffers.
+     * @param vertexCapacity Vrtices iniciales (el pool crece si hace falta).
+     * @param indexCapacity ndices iniciales.
+     * @return @c S_OK o el error de creacin de algn buffer.
+     */
+    HRESULT
+        init(Device& device,
+             unsigned int vertexCapacity,
+             unsigned int indexCapacity);
+
+
+    /**
+     * @brief Libera los buffers y todas las mallas.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // MALLAS
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Copia una malla a los buffers compartidos.
+     * @param device Dispositivo (por si hay que crecer).
+     * @param deviceContext Contexto para @c UpdateSubresource y las copias de compactacin.
+     * @param mesh Malla con vrtices e ndices de 32 bits.
+     * @return Handle con una referencia, o @c kInvalidMesh si no se pudo subir.
+     */
+    MeshHandle
+        upload(Device& device,
+               DeviceContext& deviceContext,
+               const MeshComponent& mesh);
+
+
+    /**
+     * @brief Aade una referencia (p. ej. un actor que comparte la malla).
+     */
+    void
+        addRef(MeshHandle handle);
+
+
+    /**
+     * @brief Quita una referencia; con la ltima, el tramo vuelve a quedar libre.
+     */
+    void
+        release(MeshHandle handle);
+
+
+    /**
+     * @brief Compacta todas las mallas al principio de los buffers.
+     *
+     * Crea buffers nuevos, copia cada tramo vivo con @c CopySubresourceRegion y
+     * libera los antiguos. No hace falta llamarlo a mano: @c upload() lo hace
+     * cuando la fragmentacin impide colocar una malla.
+     * @return @c S_OK o el error de creacin de los buffers (el pool queda intacto).
+     */
+    HRESULT
+        defragment(Device& device, DeviceContext& deviceContext);
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Tramo actual de la malla (cambia tras compactar).
+     */
+    MeshRange
+        getRange(MeshHandle handle) const;
+
+
+    bool
+        isValid(MeshHandle handle) const {
+        return handle < m_entries.size() && m_entries[handle].refCount > 0;
+    }
+
+    ID3D11Buffer*
+        getVertexBuffer() const { return m_vertexBuffer.getBuffer(); }
+
+    ID3D11Buffer*
+        getIndexBuffer() const { return m_indexBuffer.getBuffer(); }
+
+    unsigned int
+        getVertexStride() const { return sizeof(SimpleVertex); }
+
+
+    /**
+     * @brief Ocupacin actual y contadores acumulados de compactacin.
+     */
+    MeshPoolStats
+        getStats() const;
+
+
+private:
+
+    /**
+     * @brief Estado de un handle.
+     */
+    struct MeshEntry {
+        MeshRange range;
+        unsigned int refCount = 0;    ///< 0 = handle libre para reutilizar.
+    };
+
+
+    /**
+     * @brief Mueve todas las mallas vivas a buffers nuevos de la capacidad indicada.
+     */
+    HRESULT
+        relocate(Device& device,
+                 DeviceContext& deviceContext,
+                 unsigned int vertexCapacity,
+                 unsigned int indexCapacity);
+
+
+    /**
+     * @brief Reserva los dos tramos de una malla; si alguno falla, no reserva ninguno.
+     */
+    bool
+        allocateRange(unsigned int vertexCount,
+                      unsigned int indexCount,
+                      MeshRange& range);
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    Buffer m_vertexBuffer;
+    Buffer m_indexBuffer;
+
+    /** @brief Tramos del vertex buffer, en vrtices. */
+    FreeListAllocator m_vertexAllocator;
+
+    /** @brief Tramos del index buffer, en ndices. */
+    FreeListAllocator m_indexAllocator;
+
+    std::vector<MeshEntry> m_entries;
+
+    /** @brief Handles liberados, para reutilizar sus entradas. */
+    std::vector<MeshHandle> m_freeHandles;
+
+    unsigned int m_defragmentations = 0;
+    unsigned long long m_bytesMoved = 0;
+
+};
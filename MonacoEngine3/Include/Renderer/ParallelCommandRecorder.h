@@ -0,0 +1,184 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "DeviceContext.h"
+#include "RHI/IRenderBackend.h"
+#include <functional>
+
+class ThreadPool;
+
+// =================================================================================
+// ESTRUCTURAS: REPARTO DE TRABAJO
+// =================================================================================
+
+/**
+ * @struct WorkRange
+ * @brief Rango contiguo [begin, end) de elementos que graba un mismo contexto.
+ */
+struct WorkRange {
+    unsigned int begin = 0;
+    unsigned int end = 0;
+
+    unsigned int
+        size() const { return end - begin; }
+};
+
+
+/**
+ * @struct ParallelRecorderStats
+ * @brief Contadores de la ltima grabacin.
+ */
+struct ParallelRecorderStats {
+    unsigned int ranges = 0;          ///< Rangos en que se parti el trabajo (1 = sin hilos).
+    unsigned int commandLists = 0;    ///< Listas ejecutadas en el contexto inmediato.
+    unsigned int itemsRecorded = 0;   ///< Elementos grabados en total.
+    unsigned int failedLists = 0;     ///< Listas descartadas porque no se pudieron cerrar.
+};
+
+
+// =================================================================================
+// CLASE: PARALLEL COMMAND RECORDER
+// =================================================================================
+
+/**
+ * @class ParallelCommandRecorder
+ * @brief Graba comandos en varios contextos diferidos a la vez y los ejecuta en orden.
+ *
+ * El trabajo se parte en rangos contiguos; cada rango lo graba un hilo del
+ * @c ThreadPool en su propio @c DeviceContext diferido y las listas resultantes se
+ * ejecutan en el contexto inmediato en el orden de los rangos, as que el resultado
+ * es el mismo que grabarlo todo en serie.
+ *
+ * Un contexto diferido empieza sin estado: @c SetupFn debe volver a enlazar lo que
+ * el inmediato tena (render targets, viewport, constantes del frame...). Los Map
+ * sobre recursos compartidos deben hacerse antes, en el inmediato.
+ * Si el backend no admite contextos diferidos o hay poco trabajo se graba todo
+ * directamente en el inmediato, sin llamar a @c SetupFn.
+ */
+class ParallelCommandRecorder {
+
+public:
+
+    /** @brief Vuelve a enlazar el estado compartido en un contexto diferido vaco. */
+    using SetupFn = std::function<void(DeviceContext&)>;
+
+    /** @brief Graba un rango en el contexto dado; el ltimo parmetro es el ndice del rango. */
+    using RecordFn = std::function<void(DeviceContext&, const WorkRange&, unsigned int)>;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    ParallelCommandRecorder() = default;
+
+    ~ParallelCommandRecorder() { destroy(); }
+
+    ParallelCommandRecorder(const ParallelCommandRecorder&) = delete;
+    ParallelCommandRecorder& operator=(const ParallelCommandRecorder&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Crea los contextos diferidos.
+     * @param immediate Contexto inmediato; su backend crea los diferidos.
+     * @param threadPool Hilos que graban (no propietario).
+     * @param maxContexts Contextos diferidos; 0 usa la concurrencia del pool, 1 desactiva los hilos.
+     * @param minItemsPerContext Por debajo de esta cantidad no compensa abrir otro contexto.
+     * @return @c S_OK tambin si se cae al camino en serie (no es un error fatal).
+     */
+    HRESULT
+        init(DeviceContext& immediate,
+             ThreadPool& threadPool,
+             unsigned int maxContexts = 0,
+             unsigned int minItemsPerContext = 64);
+
+
+    /**
+     * @brief Libera los contextos diferidos y sus backends.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // GRABACIN
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Parte [0, itemCount) en rangos, los graba en paralelo y los ejecuta en orden.
+     * Si hubo listas, al volver el estado del inmediato queda limpio (como tras @c ClearState()).
+     */
+    void
+        record(DeviceContext& immediate,
+               unsigned int itemCount,
+               const SetupFn& setupState,
+               const RecordFn& recordRange);
+
+
+    /**
+     * @brief Reparte @p itemCount elementos en, como mucho, @p maxRanges rangos contiguos
+     * de tamao parecido y nunca menores que @p minItemsPerRange (salvo si slo hay uno).
+     */
+    static void
+        partition(unsigned int itemCount,
+                  unsigned int maxRanges,
+                  unsigned int minItemsPerRange,
+                  std::vector<WorkRange>& ranges);
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /** @brief true si hay contextos diferidos disponibles. */
+    bool
+        isParallel() const { return !m_slots.empty(); }
+
+
+    /** @brief Rangos que puede usar como mucho una grabacin (ndices de @c RecordFn). */
+    unsigned int
+        getMaxRanges() const { return m_slots.empty() ? 1 : static_cast<unsigned int>(m_slots.size()); }
+
+
+    /** @brief Contadores de la ltima llamada a @c record(). */
+    const ParallelRecorderStats&
+        getStats() const { return m_stats; }
+
+
+private:
+
+    /**
+     * @brief Contexto diferido con su backend y la lista del ltimo frame.
+     */
+    struct DeferredSlot {
+        DeviceContext context;
+        std::unique_ptr<IRenderBackend> backend;
+        std::unique_ptr<IRenderCommandList> commandList;
+        HRESULT result = S_OK;
+    };
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    /** @brief Un contexto por rango posible (punteros para que no se muevan). */
+    std::vector<std::unique_ptr<DeferredSlot>> m_slots;
+
+    /** @brief Hilos que graban (no propietario). */
+    ThreadPool* m_threadPool = nullptr;
+
+    unsigned int m_minItemsPerContext = 64;
+
+    /** @brief Rangos de la grabacin actual (se reutiliza entre frames). */
+    std::vector<WorkRange> m_ranges;
+
+    ParallelRecorderStats m_stats;
+
+};
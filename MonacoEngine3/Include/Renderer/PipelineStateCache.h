@@ -0,0 +1,235 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "EngineUtilities/Utilities/Hash.h"
+#include <cstring>
+#include <unordered_map>
+
+class Device;
+class DeviceContext;
+
+// =================================================================================
+// ESTRUCTURAS: PIPELINE STATE
+// =================================================================================
+
+/** @brief Identificador compacto de un pipeline; comparar dos handles basta para saber si cambia. */
+using PipelineHandle = unsigned int;
+
+/** @brief Handle reservado: "sin pipeline" (la cola usa el suyo por defecto). */
+const PipelineHandle kNoPipeline = 0;
+
+
+/**
+ * @struct PipelineStateDesc
+ * @brief Shaders, input layout y estados fijos que se enlazan juntos.
+ *
+ * Los estados en @c nullptr se sustituyen por los de la descripcin por defecto de
+ * D3D11 (sin mezcla, cull back, depth test LESS), as un pipeline siempre deja el
+ * Output Merger y el rasterizador en un estado conocido.
+ */
+struct PipelineStateDesc {
+    ID3D11VertexShader* vertexShader = nullptr;
+    ID3D11PixelShader* pixelShader = nullptr;
+    ID3D11InputLayout* inputLayout = nullptr;
+    ID3D11BlendState* blendState = nullptr;
+    ID3D11RasterizerState* rasterizerState = nullptr;
+    ID3D11DepthStencilState* depthStencilState = nullptr;
+    D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+};
+
+
+/**
+ * @struct PipelineStateCacheStats
+ * @brief Objetos creados y peticiones resueltas desde la cach.
+ */
+struct PipelineStateCacheStats {
+    unsigned int samplerStates = 0;
+    unsigned int blendStates = 0;
+    unsigned int rasterizerStates = 0;
+    unsigned int depthStencilStates = 0;
+    unsigned int pipelines = 0;         ///< Pipelines distintos registrados.
+    unsigned int stateRequests = 0;     ///< Peticiones de estados y pipelines.
+    unsigned int stateHits = 0;         ///< Peticiones servidas sin crear nada.
+};
+
+
+// =================================================================================
+// CLASE: PIPELINE STATE CACHE (Singleton)
+// =================================================================================
+
+/**
+ * @class PipelineStateCache
+ * @brief Estados inmutables de D3D11 compartidos, indexados por el hash de su descriptor.
+ *
+ * Igual que @c ResourceManager, es un nico punto de acceso (Flyweight): dos peticiones
+ * con la misma descripcin devuelven el mismo objeto. Los descriptores se copian campo a
+ * campo sobre memoria a cero, descartando lo que D3D ignora (p. ej. RenderTarget[1..7]
+ * sin IndependentBlendEnable), y se comparan por sus bytes (hash FNV-1a y @c memcmp).
+ *
+ * La cach es propietaria de los estados que devuelve; quien quiera guardarlos ms
+ * all de @c destroy() debe hacer @c AddRef. Cada pipeline retiene (AddRef) sus shaders,
+ * layout y estados hasta @c destroy(), as que destruir un @c ShaderProgram no invalida
+ * los handles ya registrados.
+ *
+ * Crear estados o pipelines no es seguro entre hilos; @c bind() y las consultas s,
+ * mientras nadie cree nada a la vez (la cola slo crea pipelines en @c submit()).
+ */
+class PipelineStateCache final {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // PATRN SINGLETON
+    // -----------------------------------------------------------------------------
+
+    static PipelineStateCache&
+        getInstance()
+    {
+        static PipelineStateCache instance;
+        return instance;
+    }
+
+
+    PipelineStateCache(const PipelineStateCache&) = delete;
+    PipelineStateCache& operator=(const PipelineStateCache&) = delete;
+
+
+private:
+
+    PipelineStateCache();
+
+    ~PipelineStateCache() = default;
+
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Crea los estados por defecto que rellenan los huecos de cada @c PipelineStateDesc.
+     * @return @c S_OK o el error de creacin de algn estado.
+     */
+    HRESULT
+        init(Device& device);
+
+
+    /**
+     * @brief Libera todos los estados y olvida los pipelines (los handles dejan de valer).
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // ESTADOS
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Devuelve el sampler con esa descripcin, crendolo la primera vez.
+     * @return Puntero propiedad de la cach, o @c nullptr si la creacin falla.
+     */
+    ID3D11SamplerState*
+        getSamplerState(Device& device, const D3D11_SAMPLER_DESC& desc);
+
+    ID3D11BlendState*
+        getBlendState(Device& device, const D3D11_BLEND_DESC& desc);
+
+    ID3D11RasterizerState*
+        getRasterizerState(Device& device, const D3D11_RASTERIZER_DESC& desc);
+
+    ID3D11DepthStencilState*
+        getDepthStencilState(Device& device, const D3D11_DEPTH_STENCIL_DESC& desc);
+
+
+    // -----------------------------------------------------------------------------
+    // PIPELINES
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Registra (o encuentra) un pipeline y devuelve su handle.
+     * @return Handle estable hasta @c destroy(); @c kNoPipeline si faltan shaders o layout.
+     */
+    PipelineHandle
+        getPipeline(const PipelineStateDesc& desc);
+
+
+    /**
+     * @brief Descripcin completa (con los estados por defecto ya aplicados).
+     */
+    const PipelineStateDesc&
+        getDesc(PipelineHandle handle) const { return m_pipelines[handle < m_pipelines.size() ? handle : 0]; }
+
+
+    /**
+     * @brief Enlaza shaders, layout, topologa y estados del pipeline.
+     * El filtrado del @c DeviceContext descarta las partes que ya estaban enlazadas.
+     */
+    void
+        bind(DeviceContext& deviceContext, PipelineHandle handle) const;
+
+
+    const PipelineStateCacheStats&
+        getStats() const { return m_stats; }
+
+
+private:
+
+    /**
+     * @brief Tabla hash -> (descriptor, estado) de un tipo de estado.
+     */
+    template<typename Desc, typename State>
+    struct StateTable {
+        struct Entry {
+            Desc desc;
+            State* state;
+        };
+        std::unordered_multimap<uint64_t, Entry> entries;
+
+        State*
+            find(uint64_t hash, const Desc& desc) const {
+            auto range = entries.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (memcmp(&it->second.desc, &desc, sizeof(Desc)) == 0) {
+                    return it->second.state;
+                }
+            }
+            return nullptr;
+        }
+
+        void
+            release() {
+            for (auto& entry : entries) {
+                SAFE_RELEASE(entry.second.state);
+            }
+            entries.clear();
+        }
+    };
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    StateTable<D3D11_SAMPLER_DESC, ID3D11SamplerState> m_samplers;
+    StateTable<D3D11_BLEND_DESC, ID3D11BlendState> m_blendStates;
+    StateTable<D3D11_RASTERIZER_DESC, ID3D11RasterizerState> m_rasterizerStates;
+    StateTable<D3D11_DEPTH_STENCIL_DESC, ID3D11DepthStencilState> m_depthStencilStates;
+
+    /** @brief Pipelines por handle; la entrada 0 es @c kNoPipeline. */
+    std::vector<PipelineStateDesc> m_pipelines;
+
+    /** @brief Hash de la descripcin -> handles con ese hash. */
+    std::unordered_multimap<uint64_t, PipelineHandle> m_pipelineLookup;
+
+    /** @brief Estados que sustituyen a los @c nullptr de una descripcin. */
+    ID3D11BlendState* m_defaultBlend = nullptr;
+    ID3D11RasterizerState* m_defaultRasterizer = nullptr;
+    ID3D11DepthStencilState* m_defaultDepthStencil = nullptr;
+
+    PipelineStateCacheStats m_stats;
+
+};
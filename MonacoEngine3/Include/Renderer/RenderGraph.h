@@ -0,0 +1,386 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+class Device;
+class DeviceContext;
+
+// =================================================================================
+// ESTRUCTURAS: RECURSOS DEL GRAFO
+// =================================================================================
+
+/** @brief ndice de una textura del grafo (vlido slo durante el frame que la declar). */
+using RGHandle = unsigned int;
+
+/** @brief Handle que no apunta a ninguna textura. */
+const RGHandle kInvalidRGHandle = ~0u;
+
+
+/**
+ * @struct RGTextureDesc
+ * @brief Descripcin de una textura 2D del grafo.
+ *
+ * Para profundidad basta con el formato @c D*; si adems lleva
+ * @c D3D11_BIND_SHADER_RESOURCE el grafo crea la textura typeless y las vistas
+ * con el formato que toca a cada una.
+ */
+struct RGTextureDesc {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    unsigned int bindFlags = 0;         ///< Combinacin de @c D3D11_BIND_*.
+    unsigned int arraySize = 1;         ///< Capas; cada una tiene su propia RTV/DSV.
+    unsigned int sampleCount = 1;
+    unsigned int sampleQuality = 0;
+
+    bool
+        operator==(const RGTextureDesc& other) const {
+        return width == other.width && height == other.height && format == other.format &&
+               bindFlags == other.bindFlags && arraySize == other.arraySize &&
+               sampleCount == other.sampleCount && sampleQuality == other.sampleQuality;
+    }
+
+    /** @brief Bytes que ocupa en memoria de vdeo (estimado por el tamao del formato). */
+    unsigned long long
+        getSizeInBytes() const;
+};
+
+
+/**
+ * @struct RenderGraphStats
+ * @brief Resultado de la ltima compilacin y del pool de texturas fsicas.
+ */
+struct RenderGraphStats {
+    unsigned int passes = 0;                    ///< Pases declarados.
+    unsigned int passesCulled = 0;              ///< Pases eliminados porque nadie usa lo que escriben.
+    unsigned int transientTextures = 0;         ///< Texturas transitorias vivas tras el culling.
+    unsigned int physicalTextures = 0;          ///< Texturas reales que las respaldan.
+    unsigned int texturesCreated = 0;           ///< Texturas creadas por el pool desde @c init (no por frame).
+    unsigned long long transientBytes = 0;      ///< Lo que ocuparan sin aliasing.
+    unsigned long long physicalBytes = 0;       ///< Lo que ocupan de verdad.
+
+    /** @brief Memoria ahorrada por compartir texturas fsicas. */
+    unsigned long long
+        bytesSaved() const { return transientBytes - physicalBytes; }
+};
+
+
+// =================================================================================
+// CLASE: RENDER GRAPH BUILDER
+// =================================================================================
+
+class RenderGraph;
+
+/**
+ * @class RenderGraphBuilder
+ * @brief Lo que ve la funcin de setup de un pase: declara qu crea, lee y escribe.
+ */
+class RenderGraphBuilder {
+
+public:
+
+    /**
+     * @brief Declara una textura transitoria escrita por este pase.
+     * El grafo decide qu memoria la respalda; no existe fuera del frame.
+     */
+    RGHandle
+        create(const std::string& name, const RGTextureDesc& desc);
+
+
+    /** @brief El pase lee @p handle (como SRV); debe escribirlo antes otro pase. */
+    RGHandle
+        read(RGHandle handle);
+
+
+    /** @brief El pase escribe @p handle (como RTV o DSV). */
+    RGHandle
+        write(RGHandle handle);
+
+
+    /** @brief El pase no se elimina aunque nadie lea lo que escribe (present, GUI, readback...). */
+    void
+        setSideEffects();
+
+
+private:
+
+    friend class RenderGraph;
+
+    RenderGraphBuilder(RenderGraph& graph, unsigned int pass) : m_graph(graph), m_pass(pass) {}
+
+    RenderGraph& m_graph;
+
+    unsigned int m_pass;
+
+};
+
+
+// =================================================================================
+// CLASE: RENDER GRAPH RESOURCES
+// =================================================================================
+
+/**
+ * @class RenderGraphResources
+ * @brief Lo que ve la funcin de ejecucin de un pase: las vistas de sus texturas.
+ */
+class RenderGraphResources {
+
+public:
+
+    ID3D11RenderTargetView*
+        getRenderTargetView(RGHandle handle, unsigned int slice = 0) const;
+
+    ID3D11DepthStencilView*
+        getDepthStencilView(RGHandle handle, unsigned int slice = 0) const;
+
+    ID3D11ShaderResourceView*
+        getShaderResourceView(RGHandle handle) const;
+
+    /**
+     * @brief Textura fsica de una transitoria (para copias y resolves).
+     * Las importadas devuelven @c nullptr: el grafo slo conoce sus vistas.
+     */
+    ID3D11Texture2D*
+        getTexture(RGHandle handle) const;
+
+    const RGTextureDesc&
+        getDesc(RGHandle handle) const;
+
+
+private:
+
+    friend class RenderGraph;
+
+    explicit RenderGraphResources(const RenderGraph& graph) : m_graph(graph) {}
+
+    const RenderGraph& m_graph;
+
+};
+
+
+// =================================================================================
+// CLASE: RENDER GRAPH
+// =================================================================================
+
+/**
+ * @class RenderGraph
+ * @brief Grafo de pases de un frame con culling, orden automtico y aliasing de texturas.
+ *
+ * Cada frame: @c reset(), se importan las texturas externas (back buffer), se aaden
+ * los pases con @c addPass(), y despus @c compile() y @c execute().
+ *
+ * @c compile() no toca la GPU (se puede probar sin dispositivo):
+ *  - elimina los pases cuyas escrituras nadie lee (las texturas importadas y los pases
+ *    con @c setSideEffects() cuentan como usados);
+ *  - ordena los pases respetando las dependencias de datos; entre los que estn
+ *    listos elige el que menos memoria transitoria deja viva, para acortar vidas;
+ *  - asigna a cada textura transitoria una textura fsica compatible (misma
+ *    descripcin) cuya vida ya termin. D3D11 no tiene placed resources, as que el
+ *    aliasing es compartir el objeto de textura, no un heap.
+ *
+ * Las texturas fsicas se guardan en un pool entre frames: un frame igual al anterior
+ * no crea nada. Las que no se usan durante @c kPoolFrames frames se liberan.
+ */
+class RenderGraph {
+
+public:
+
+    /** @brief Frames que una textura fsica puede pasar sin uso antes de liberarse. */
+    static const unsigned int kPoolFrames = 60;
+
+    using SetupFunction = std::function<void(RenderGraphBuilder&)>;
+    using ExecuteFunction = std::function<void(DeviceContext&, const RenderGraphResources&)>;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    RenderGraph() = default;
+
+    ~RenderGraph() = default;
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Olvida los pases y texturas del frame anterior (el pool se conserva).
+     */
+    void
+        reset();
+
+
+    /**
+     * @brief Libera todas las texturas fsicas del pool.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // DECLARACIN
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Registra una textura que vive fuera del grafo (no se alias ni se libera).
+     * Escribir en ella cuenta como un uso: los pases que lo hacen no se eliminan.
+     */
+    RGHandle
+        importTexture(const std::string& name,
+                      const RGTextureDesc& desc,
+                      ID3D11RenderTargetView* renderTargetView,
+                      ID3D11DepthStencilView* depthStencilView = nullptr,
+                      ID3D11ShaderResourceView* shaderResourceView = nullptr);
+
+
+    /**
+     * @brief Aade un pase. @p setup se ejecuta ya; @p execute, dentro de @c execute().
+     * Los handles declarados en @p setup suelen capturarse por referencia en @p execute.
+     */
+    void
+        addPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute);
+
+
+    // -----------------------------------------------------------------------------
+    // COMPILACIN Y EJECUCIN
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Culling, orden y aliasing (slo CPU).
+     * @return false si hay un ciclo o un pase lee una textura que nadie escribi.
+     */
+    bool
+        compile();
+
+
+    /**
+     * @brief Crea (o reutiliza) las texturas fsicas y ejecuta los pases en orden.
+     * @return Error de creacin de alguna textura; los pases no se ejecutan en ese caso.
+     */
+    HRESULT
+        execute(Device& device, DeviceContext& deviceContext);
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    const RenderGraphStats&
+        getStats() const { return m_stats; }
+
+
+    /** @brief Nombres de los pases en el orden de ejecucin de la ltima compilacin. */
+    std::vector<std::string>
+        getExecutionOrder() const;
+
+
+    /** @brief ndice de textura fsica de cada transitoria (-1 si se elimin), para depurar. */
+    int
+        getPhysicalIndex(RGHandle handle) const;
+
+
+private:
+
+    friend class RenderGraphBuilder;
+    friend class RenderGraphResources;
+
+    struct Pass {
+        std::string name;
+        ExecuteFunction execute;
+        std::vector<RGHandle> reads;
+        std::vector<RGHandle> writes;
+        std::vector<RGHandle> creates;
+        bool sideEffects = false;
+        bool culled = false;
+        unsigned int refCount = 0;
+    };
+
+    struct Resource {
+        std::string name;
+        RGTextureDesc desc;
+        bool imported = false;
+        ID3D11RenderTargetView* importedRTV = nullptr;
+        ID3D11DepthStencilView* importedDSV = nullptr;
+        ID3D11ShaderResourceView* importedSRV = nullptr;
+        std::vector<unsigned int> writers;
+        std::vector<unsigned int> readers;
+        unsigned int refCount = 0;
+        int firstUse = -1;                  ///< Posicin en el orden de ejecucin.
+        int lastUse = -1;
+        int physical = -1;                  ///< ndice en m_slots.
+    };
+
+    /** @brief Textura fsica asignada este frame (ndice en el pool tras @c execute()). */
+    struct Slot {
+        RGTextureDesc desc;
+        int lastUse = -1;
+        int poolIndex = -1;
+    };
+
+    struct PhysicalTexture {
+        RGTextureDesc desc;
+        ID3D11Texture2D* texture = nullptr;
+        std::vector<ID3D11RenderTargetView*> renderTargetViews;
+        std::vector<ID3D11DepthStencilView*> depthStencilViews;
+        ID3D11ShaderResourceView* shaderResourceView = nullptr;
+        unsigned long long lastFrameUsed = 0;
+        bool taken = false;
+    };
+
+
+    void
+        cullPasses();
+
+
+    bool
+        sortPasses();
+
+
+    void
+        assignPhysicalTextures();
+
+
+    HRESULT
+        createPhysicalTexture(Device& device, PhysicalTexture& physical);
+
+
+    static void
+        releasePhysicalTexture(PhysicalTexture& physical);
+
+
+    const PhysicalTexture*
+        getPhysical(RGHandle handle) const;
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    std::vector<Pass> m_passes;
+
+    std::vector<Resource> m_resources;
+
+    /** @brief ndices de pases vivos, en orden de ejecucin. */
+    std::vector<unsigned int> m_order;
+
+    std::vector<Slot> m_slots;
+
+    std::vector<PhysicalTexture> m_pool;
+
+    unsigned long long m_frame = 0;
+
+    bool m_compiled = false;
+
+    RenderGraphStats m_stats;
+
+};
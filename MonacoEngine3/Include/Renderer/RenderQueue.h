@@ -0,0 +1,441 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "Buffer.h"
+#include "Renderer/ConstantBufferRing.h"
+#include "Renderer/PipelineStateCache.h"
+#include <functional>
+#include <unordered_map>
+
+class Device;
+class DeviceContext;
+class ShaderProgram;
+class ParallelCommandRecorder;
+
+// =================================================================================
+// ESTRUCTURAS: PAQUETES DE DIBUJO
+// =================================================================================
+
+/**
+ * @enum RenderPass
+ * @brief Pase al que pertenece un paquete. Ocupa los 4 bits altos de la clave.
+ */
+enum class RenderPass : unsigned int {
+    Opaque = 0,       ///< Geometra opaca: se agrupa por estado y luego de frente a fondo.
+    Transparent = 1   ///< Geometra con mezcla: se ordena de fondo a frente.
+};
+
+
+/**
+ * @struct DrawPacket
+ * @brief Todo lo que hace falta para emitir un @c DrawIndexed, sin tocar la entidad.
+ *
+ * Slo guarda punteros no propietarios; los recursos siguen perteneciendo a sus
+ * wrappers (@c Buffer, @c Texture, @c SamplerState...) y deben vivir hasta @c execute().
+ * Shaders, layout, topologa y estados fijos van en @c pipeline. Sin pipeline, la cola
+ * registra uno con los campos de shader y @c topology, o usa el suyo por defecto si
+ * los shaders quedan en @c nullptr.
+ * Los paquetes marcados @c instanceable que comparten malla y material se dibujan
+ * juntos con el shader instanciado, usando @c world y @c color en lugar del CB por objeto.
+ * Si hay @c objectData la cola lo sube al anillo de constantes y @c objectBuffer slo
+ * se usa cuando no hay anillo.
+ */
+struct DrawPacket {
+    RenderPass pass = RenderPass::Opaque;
+
+    PipelineHandle pipeline = kNoPipeline;         ///< Lo rellena @c submit() si falta.
+
+    ID3D11VertexShader* vertexShader = nullptr;
+    ID3D11PixelShader* pixelShader = nullptr;
+    ID3D11InputLayout* inputLayout = nullptr;
+
+    ID3D11ShaderResourceView* texture = nullptr;   ///< Albedo en t0.
+    ID3D11SamplerState* sampler = nullptr;         ///< Sampler en s0.
+
+    ID3D11Buffer* vertexBuffer = nullptr;
+    unsigned int vertexStride = 0;
+    ID3D11Buffer* indexBuffer = nullptr;
+    DXGI_FORMAT indexFormat = DXGI_FORMAT_R32_UINT;
+
+    ID3D11Buffer* objectBuffer = nullptr;          ///< CB por objeto (VS y PS).
+    unsigned int objectSlot = 2;
+    const void* objectData = nullptr;              ///< Contenido del CB por objeto (vive hasta execute()).
+    unsigned int objectDataSize = 0;
+
+    D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+    unsigned int indexCount = 0;
+    unsigned int startIndex = 0;
+    int baseVertex = 0;
+
+    bool instanceable = false;                     ///< Puede agruparse con paquetes iguales.
+    XMFLOAT4X4 world = {};                         ///< Mundo sin transponer (slo instancias).
+    XMFLOAT4 color = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f); ///< Color de malla (slo instancias).
+
+    float viewDepth = 0.0f;                        ///< Profundidad normalizada [0, 1].
+    unsigned long long sortKey = 0;                ///< La rellena @c RenderQueue::submit.
+};
+
+
+/**
+ * @struct RenderQueueStats
+ * @brief Binds y draws de un frame, antes y despus de filtrar estado redundante.
+ *
+ * "Solicitados" es lo que emitira el camino antiguo (cada paquete lo vuelve a
+ * enlazar todo); "emitidos" es lo que realmente llega al @c DeviceContext.
+ */
+struct RenderQueueStats {
+    unsigned int packets = 0;          ///< Paquetes enviados a la cola (draws sin agrupar).
+    unsigned int drawCalls = 0;        ///< Draws emitidos (simples + instanciados).
+    unsigned int instancedDraws = 0;   ///< Draws instanciados emitidos.
+    unsigned int instancesBatched = 0; ///< Paquetes que se dibujaron dentro de un draw instanciado.
+    unsigned int bindsRequested = 0;   ///< Binds que hara un submit ingenuo.
+    unsigned int bindsIssued = 0;      ///< Binds que llegaron al contexto.
+    unsigned int bytesMapped = 0;      ///< Bytes escritos va Map (instancias y constantes).
+
+    /**
+     * @brief Binds evitados por el filtrado de estado.
+     */
+    unsigned int
+        bindsSkipped() const { return bindsRequested - bindsIssued; }
+
+    /**
+     * @brief Draws ahorrados por el instanciado.
+     */
+    unsigned int
+        drawsSaved() const { return packets - drawCalls; }
+};
+
+
+// =================================================================================
+// CLASE: RENDER QUEUE
+// =================================================================================
+
+/**
+ * @class RenderQueue
+ * @brief Cola de paquetes de dibujo ordenados por una clave de 64 bits.
+ *
+ * Disposicin de la clave (bits altos primero):
+ * - Opaco:       pase(4) | pipeline(8) | material(16) | malla(12) | profundidad(24)
+ * - Transparente: pase(4) | profundidad invertida(24) | pipeline(8) | material(16) | malla(12)
+ *
+ * El pipeline es el handle de @c PipelineStateCache; material y malla se internan a
+ * partir de los punteros de D3D11. Si se agotan los bits se reutilizan (mdulo); eso
+ * slo empeora el agrupado, nunca la correccin, porque @c execute() compara los
+ * valores reales.
+ */
+class RenderQueue {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    RenderQueue() = default;
+
+    ~RenderQueue() = default;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Crea el buffer de instancias compartido por todos los grupos del frame.
+     * @param device Dispositivo para crear el recurso.
+     * @param maxInstances Instancias por frame; los paquetes que no caben se dibujan sueltos.
+     * @return @c S_OK o el error de creacin del buffer.
+     */
+    HRESULT
+        init(Device& device, unsigned int maxInstances = 1024);
+
+
+    /**
+     * @brief Libera el buffer de instancias.
+     */
+    void
+        destroy();
+
+
+    /**
+     * @brief Shader que se usa en paquetes que no especifican uno propio.
+     * @param states Estados fijos (mezcla, raster, profundidad) del pipeline; los
+     *        shaders y el layout de @p states se ignoran.
+     */
+    void
+        setDefaultShader(ShaderProgram& shader, const PipelineStateDesc& states = PipelineStateDesc());
+
+
+    /**
+     * @brief Variante del shader por defecto que lee mundo y color del slot 1.
+     * Sin l (o sin buffer de instancias) la cola no agrupa nada.
+     */
+    void
+        setInstancedShader(ShaderProgram& shader, const PipelineStateDesc& states = PipelineStateDesc());
+
+
+    /**
+     * @brief Anillo del que salen los constant buffers por objeto (no propietario).
+     * Con @c nullptr los datos se copian al @c objectBuffer de cada paquete.
+     */
+    void
+        setConstantRing(ConstantBufferRing* ring) { m_constantRing = ring; }
+
+
+    /**
+     * @brief Olvida los identificadores de material y malla (p. ej. al cambiar de escena).
+     * Las claves del siguiente frame se vuelven a numerar desde cero.
+     */
+    void
+        clearInternTables();
+
+
+    /**
+     * @brief Vaca la cola y fija la cmara usada para calcular profundidades.
+     * Cada cierto nmero de frames descarta de las tablas de internado los punteros
+     * que ya no se envan (recursos destruidos o texturas sustituidas por el streamer).
+     */
+     * @param view Matriz de vista (sin transponer).
+     * @param nearZ Plano cercano de la cmara.
+     * @param farZ Plano lejano de la cmara.
+     */
+    void
+        begin(const XMMATRIX& view, float nearZ, float farZ);
+
+
+    /**
+     * @brief Profundidad normalizada del origen de una matriz de mundo.
+     * @param world Matriz de mundo (sin transponer).
+     * @return Valor en [0, 1] respecto a los planos de @c begin().
+     */
+    float
+        computeViewDepth(const XMMATRIX& world) const;
+
+
+    /**
+     * @brief Aade un paquete y calcula su clave de ordenamiento.
+     */
+    void
+        submit(const DrawPacket& packet);
+
+
+    /**
+     * @brief Ordena los paquetes por clave (radix sort LSD de 8 bits por pasada).
+     */
+    void
+        sort();
+
+
+    /**
+     * @brief Emite los paquetes en orden, saltando binds que no cambian el estado.
+     * Las series de paquetes instanciables con la misma malla y material se emiten
+     * como un nico @c DrawIndexedInstanced.
+     * Asume que nadie ms toca el pipeline entre paquetes de la misma llamada.
+     */
+    void
+        execute(DeviceContext& deviceContext);
+
+
+    /**
+     * @brief Igual que @c execute(), pero graba las series en varios contextos diferidos.
+     * Los Map (instancias y constantes) se hacen antes en el contexto inmediato; cada
+     * contexto diferido graba un rango contiguo de series y las listas se ejecutan en orden.
+     * @param setupState Vuelve a enlazar en cada contexto diferido el estado del frame
+     *        (render targets, viewport, constantes de cmara) que el inmediato ya tiene.
+     * Si se usaron listas, el estado del inmediato queda limpio al volver.
+     */
+    void
+        executeParallel(DeviceContext& immediate,
+                        ParallelCommandRecorder& recorder,
+                        const std::function<void(DeviceContext&)>& setupState);
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Estadsticas del ltimo @c execute().
+     */
+    const RenderQueueStats&
+        getStats() const { return m_stats; }
+
+
+    /**
+     * @brief Paquetes actualmente en la cola, en el orden en que se emitirn tras @c sort().
+     */
+    size_t
+        size() const { return m_packets.size(); }
+
+
+private:
+
+    /**
+     * @brief Identificador internado y ltimo frame en que se us.
+     */
+    struct InternEntry {
+        unsigned int id;
+        unsigned long long lastFrame;
+    };
+
+
+    /**
+     * @brief Punteros internados de una parte de la clave, con los IDs libres para reutilizar.
+     */
+    struct InternTable {
+        std::unordered_map<const void*, InternEntry> entries;
+        std::vector<unsigned int> freeIds;
+        unsigned int nextId = 0;
+        bool wrapReported = false;
+    };
+
+
+    /**
+     * @brief Devuelve un identificador compacto y estable para un puntero.
+     * Si no quedan IDs de @p bits bits se reutilizan (mdulo) y se avisa una vez.
+     */
+    unsigned int
+        intern(InternTable& table,
+               const void* object,
+               unsigned int bits,
+               const char* name);
+
+
+    /**
+     * @brief Descarta las entradas que no se han usado en los ltimos @p maxAge frames.
+     */
+    void
+        pruneInternTable(InternTable& table, unsigned long long maxAge);
+
+
+    /**
+     * @brief Construye la clave de 64 bits de un paquete ya completo.
+     */
+    unsigned long long
+        buildKey(const DrawPacket& packet);
+
+
+    /**
+     * @brief Indica si dos paquetes pueden compartir un draw instanciado.
+     */
+    static bool
+        canBatch(const DrawPacket& a, const DrawPacket& b);
+
+
+    /**
+     * @brief Estado que la cola sabe enlazado en un contexto (uno por contexto que graba).
+     */
+    struct BindCache {
+        DrawPacket bound;
+        PipelineHandle pipeline = kNoPipeline;
+        ConstantBufferAllocation constants;
+        bool valid = false;
+        bool instanceBufferBound = false;
+    };
+
+
+    /**
+     * @brief Enlaza el estado de un paquete, saltando lo que ya est en @p cache.
+     * @param instanced Usa el shader instanciado y el buffer de instancias en slot 1.
+     */
+    void
+        bindState(DeviceContext& deviceContext,
+                  BindCache& cache,
+                  RenderQueueStats& stats,
+                  const DrawPacket& packet,
+                  bool instanced,
+                  const ConstantBufferAllocation& objectConstants) const;
+
+
+    /**
+     * @brief Planifica las series y hace todos los Map del frame en @p deviceContext.
+     * Deja @c m_batches listo para @c recordBatches().
+     */
+    void
+        prepare(DeviceContext& deviceContext);
+
+
+    /**
+     * @brief Emite las series [begin, end) de @c m_batches. No modifica la cola, as que
+     * varios hilos pueden grabar rangos distintos a la vez.
+     */
+    void
+        recordBatches(DeviceContext& deviceContext,
+                      unsigned int begin,
+                      unsigned int end,
+                      BindCache& cache,
+                      RenderQueueStats& stats) const;
+
+
+    /**
+     * @brief Entrada del ordenamiento: clave y posicin del paquete en @c m_packets.
+     */
+    struct SortEntry {
+        unsigned long long key;
+        unsigned int index;
+    };
+
+
+    /**
+     * @brief Serie de paquetes que se emite con un solo draw.
+     * @c instanced es false para paquetes sueltos (@c count == 1).
+     */
+    struct Batch {
+        unsigned int begin;          ///< Primera posicin en @c m_order.
+        unsigned int count;          ///< Paquetes de la serie.
+        unsigned int firstInstance;  ///< Primera entrada en el buffer de instancias.
+        bool instanced;
+        ConstantBufferAllocation objectConstants; ///< CB por objeto (slo paquetes sueltos).
+    };
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    /** @brief Paquetes del frame en orden de envo. */
+    std::vector<DrawPacket> m_packets;
+
+    /** @brief Orden de emisin; se reutiliza entre frames para no reservar memoria. */
+    std::vector<SortEntry> m_order;
+
+    /** @brief Buffer auxiliar del radix sort. */
+    std::vector<SortEntry> m_scratch;
+
+    /** @brief Tablas de internado (persisten entre frames para que las claves sean estables). */
+    InternTable m_materialIds;
+    InternTable m_meshIds;
+
+    /** @brief Frames empezados con @c begin(); fecha el ltimo uso de cada entrada. */
+    unsigned long long m_frameIndex = 0;
+
+    /** @brief Pipeline del shader por defecto. */
+    PipelineHandle m_defaultPipeline = kNoPipeline;
+
+    /** @brief Pipeline de la variante instanciada del shader por defecto. */
+    PipelineHandle m_instancedPipeline = kNoPipeline;
+
+    /** @brief Buffer dinmico con los @c InstanceData del frame. */
+    Buffer m_instanceBuffer;
+    unsigned int m_maxInstances = 0;
+
+    /** @brief Plan de emisin del frame: series consecutivas de @c m_order. */
+    std::vector<Batch> m_batches;
+
+    /** @brief Anillo de constantes por objeto (no propietario). */
+    ConstantBufferRing* m_constantRing = nullptr;
+
+    /** @brief Contadores de cada rango de @c executeParallel() (se suman al terminar). */
+    std::vector<RenderQueueStats> m_rangeStats;
+
+    /** @brief Cmara del frame actual. */
+    XMMATRIX m_view = XMMatrixIdentity();
+    float m_nearZ = 0.01f;
+    float m_farZ = 100.0f;
+
+    /** @brief Contadores del ltimo @c execute(). */
+    RenderQueueStats m_stats;
+
+};
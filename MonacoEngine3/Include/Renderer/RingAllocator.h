@@ -0,0 +1,130 @@
+#pragma once
+
+#include <vector>
+
+// =================================================================================
+// CLASE: RING ALLOCATOR
+// =================================================================================
+
+/**
+ * @class RingAllocator
+ * @brief Sub-asignador circular de offsets, sin dependencias de D3D.
+ *
+ * Slo administra nmeros: la memoria real (un buffer dinmico de GPU) la gestiona
+ * @c ConstantBufferRing. Cada frame reserva bloques alineados a @c alignment; al
+ * empezar un frame nuevo se libera lo que us el frame de hace @c framesInFlight
+ * frames, que la GPU ya termin de leer. As la CPU nunca pisa datos en vuelo y
+ * puede escribir con @c D3D11_MAP_WRITE_NO_OVERWRITE.
+ */
+class RingAllocator {
+
+public:
+
+    /** @brief Valor devuelto por @c allocate() cuando no hay espacio. */
+    static const unsigned long long kInvalidOffset = ~0ull;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    RingAllocator() = default;
+
+    ~RingAllocator() = default;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Configura el anillo y lo deja vaco.
+     * @param capacity Bytes totales (se redondea hacia abajo a mltiplo de @c alignment).
+     * @param alignment Alineacin de cada bloque; debe ser potencia de dos.
+     * @param framesInFlight Frames que la GPU puede ir por detrs de la CPU.
+     * @return false si los parmetros no son vlidos.
+     */
+    bool
+        init(unsigned long long capacity,
+             unsigned long long alignment = 256,
+             unsigned int framesInFlight = 3);
+
+
+    /**
+     * @brief Cierra el frame actual y recupera el espacio del frame ms antiguo en vuelo.
+     */
+    void
+        beginFrame();
+
+
+    /**
+     * @brief Reserva un bloque contiguo.
+     * @param size Bytes pedidos (se redondea a la alineacin).
+     * @return Offset del bloque o @c kInvalidOffset si el anillo est lleno.
+     */
+    unsigned long long
+        allocate(unsigned long long size);
+
+
+    /**
+     * @brief Vaca el anillo (todo el contenido pasa a considerarse libre).
+     */
+    void
+        reset();
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Redondea @c size hacia arriba a la alineacin del anillo.
+     */
+    unsigned long long
+        alignUp(unsigned long long size) const {
+        return (size + m_alignment - 1) & ~(m_alignment - 1);
+    }
+
+    unsigned long long
+        getCapacity() const { return m_capacity; }
+
+    unsigned long long
+        getAlignment() const { return m_alignment; }
+
+    /** @brief Bytes ocupados por frames an en vuelo (incluido el actual y el relleno). */
+    unsigned long long
+        getUsed() const { return m_used; }
+
+    /** @brief Bytes reservados en el frame actual. */
+    unsigned long long
+        getFrameBytes() const { return m_frameBytes; }
+
+    /** @brief Mayor ocupacin vista desde @c init(). */
+    unsigned long long
+        getHighWater() const { return m_highWater; }
+
+    /** @brief true si la ltima reserva volvi al inicio del anillo. */
+    bool
+        didWrap() const { return m_wrapped; }
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    unsigned long long m_capacity = 0;
+    unsigned long long m_alignment = 256;
+    unsigned long long m_head = 0;
+    unsigned long long m_used = 0;
+    unsigned long long m_frameBytes = 0;
+    unsigned long long m_highWater = 0;
+    bool m_wrapped = false;
+
+    /** @brief Bytes de cada frame en vuelo, del ms antiguo al ms reciente. */
+    std::vector<unsigned long long> m_frames;
+
+    unsigned int m_framesInFlight = 3;
+
+};
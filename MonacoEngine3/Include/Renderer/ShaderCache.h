@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Renderer/ShaderCompiler.h"
+#include "EngineUtilities/Utilities/Hash.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// =================================================================================
+// ESTRUCTURAS: ESTADSTICAS DE LA CACH
+// =================================================================================
+
+/**
+ * @struct ShaderCacheStats
+ * @brief Resultado de las peticiones y coste de la carga y las compilaciones.
+ */
+struct ShaderCacheStats {
+    unsigned int hits = 0;              ///< Peticiones servidas desde la cach.
+    unsigned int misses = 0;            ///< Peticiones que tuvieron que compilar.
+    unsigned int compileErrors = 0;     ///< Compilaciones fallidas (no se guardan).
+    unsigned int entries = 0;           ///< Bytecodes en memoria.
+    unsigned long long bytesLoaded = 0; ///< Tamao del archivo ledo al arrancar.
+    double loadMs = 0.0;                ///< Tiempo de lectura y parseo del archivo.
+    double compileMs = 0.0;             ///< Tiempo total dentro del compilador.
+};
+
+
+// =================================================================================
+// CLASE: SHADER CACHE
+// =================================================================================
+
+/**
+ * @class ShaderCache
+ * @brief Cach persistente de bytecode compilado, sin dependencias de D3D.
+ *
+ * La clave es un hash FNV-1a del contenido del archivo, del de cada archivo que
+ * incluye (transitivamente, siguiendo las lneas @c #include), del compilador, del
+ * entry point, del perfil, de las macros y de los flags. Editar cualquiera de ellos
+ * produce otra clave, as que nunca hace falta invalidar a mano.
+ *
+ * El archivo se lee de una sola vez en @c init() y slo se reescribe en @c save() si
+ * se aadi algo. Formato (little-endian): magic, versin, nmero de entradas y
+ * cada entrada como clave (64 bits), tamao (32 bits) y bytes.
+ *
+ * @c compile() se puede llamar desde varios hilos: la tabla se protege con un mutex
+ * y el compilador se ejecuta fuera de l (@c IShaderCompiler debe ser reentrante).
+ */
+class ShaderCache {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    ShaderCache() = default;
+
+    ~ShaderCache() = default;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Asocia el compilador y carga el archivo de cach.
+     * @param compiler Compilador usado en cada fallo; debe vivir ms que la cach.
+     * @param path Archivo de cach; si no existe o est corrupto se empieza vaca.
+     * @return false si el archivo exista pero no se pudo usar.
+     */
+    bool
+        init(IShaderCompiler& compiler, const std::string& path);
+
+
+    /**
+     * @brief Escribe la cach a disco si hay entradas nuevas.
+     * @return false si no se pudo escribir el archivo.
+     */
+    bool
+        save();
+
+
+    /**
+     * @brief Guarda lo pendiente y vaca la cach en memoria.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // COMPILACIN
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Devuelve el bytecode de la peticin, compilando slo si no est en la cach.
+     * @param request Archivo, entry point, perfil, macros y flags.
+     * @param bytecode Salida: bytecode compilado.
+     * @param errors Salida: mensajes del compilador si falla.
+     * @return true si hay bytecode.
+     */
+    bool
+        compile(const ShaderCompileRequest& request,
+                std::vector<unsigned char>& bytecode,
+                std::string& errors);
+
+
+    /**
+     * @brief Calcula la clave de la peticin.
+     * @param key Salida: hash de fuentes, includes y parmetros.
+     * @return false si el archivo principal no se puede leer.
+     */
+    bool
+        computeKey(const ShaderCompileRequest& request, uint64_t& key) const;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /** @brief Copia de los contadores (otros hilos pueden estar compilando). */
+    ShaderCacheStats
+        getStats() const;
+
+
+    /**
+     * @brief Resumen de una lnea ("hits, misses, entradas, tiempos") para el log.
+     */
+    std::string
+        getReport() const;
+
+
+private:
+
+    /**
+     * @brief Aade al hash @p path y su contenido, y despus el de sus @c #include.
+     * @return false si @p path no se puede leer.
+     */
+    bool
+        hashFile(const std::string& path,
+                 uint64_t& hash,
+                 std::unordered_set<std::string>& visited) const;
+
+
+    /**
+     * @brief Interpreta el archivo ya ledo; descarta todo si est mal formado.
+     */
+    bool
+        parse(const std::vector<char>& data);
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    IShaderCompiler* m_compiler = nullptr;
+
+    std::string m_path;
+
+    /** @brief Clave -> bytecode. */
+    std::unordered_map<uint64_t, std::vector<unsigned char>> m_entries;
+
+    /** @brief Hay entradas que an no estn en disco. */
+    bool m_dirty = false;
+
+    ShaderCacheStats m_stats;
+
+    /** @brief Protege la tabla, los contadores y el archivo. */
+    mutable std::mutex m_mutex;
+
+};
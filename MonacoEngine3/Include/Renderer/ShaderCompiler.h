@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// =================================================================================
+// ESTRUCTURAS: PETICIN DE COMPILACIN
+// =================================================================================
+
+/**
+ * @struct ShaderDefine
+ * @brief Macro del preprocesador que se pasa al compilador (`#define name value`).
+ */
+struct ShaderDefine {
+    std::string name;
+    std::string value;
+};
+
+
+/**
+ * @struct ShaderCompileRequest
+ * @brief Todo lo que determina el bytecode de un shader compilado desde archivo.
+ */
+struct ShaderCompileRequest {
+    std::string fileName;               ///< Ruta del archivo HLSL.
+    std::string entryPoint;             ///< Funcin principal ("VS", "PS"...).
+    std::string profile;                ///< Modelo de shader ("vs_4_0", "ps_4_0"...).
+    std::vector<ShaderDefine> defines;  ///< Macros, en el orden en que se aplican.
+    unsigned int flags = 0;             ///< Flags propios del compilador (strictness, debug...).
+};
+
+
+// =================================================================================
+// INTERFAZ: SHADER COMPILER
+// =================================================================================
+
+/**
+ * @class IShaderCompiler
+ * @brief Compilador de shaders visto por @c ShaderCache, sin tipos de D3D.
+ *
+ * La implementacin real es @c D3DShaderCompiler; cualquier otra (por ejemplo una
+ * que devuelva bytes fijos) permite probar la cach sin DirectX.
+ */
+class IShaderCompiler {
+
+public:
+
+    virtual ~IShaderCompiler() = default;
+
+
+    /**
+     * @brief Compila la peticin.
+     * @param request Archivo, entry point, perfil, macros y flags.
+     * @param bytecode Salida: bytecode compilado.
+     * @param errors Salida: mensajes del compilador si falla.
+     * @return true si se gener bytecode.
+     */
+    virtual bool
+        compile(const ShaderCompileRequest& request,
+                std::vector<unsigned char>& bytecode,
+                std::string& errors) = 0;
+
+
+    /**
+     * @brief Identifica al compilador y su versin; forma parte de la clave de la cach,
+     * as cambiar de compilador invalida las entradas antiguas.
+     */
+    virtual const char*
+        getName() const = 0;
+
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "ShaderProgram.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Device;
+class ShaderCache;
+
+// =================================================================================
+// ESTRUCTURAS: PERMUTACIONES
+// =================================================================================
+
+/** @brief Combinacin de keywords: el bit i activa el keyword i (`#define KEYWORD 1`). */
+using ShaderKeywordMask = unsigned int;
+
+
+/**
+ * @struct ShaderPermutationStats
+ * @brief Variantes compiladas y coste de compilarlas.
+ */
+struct ShaderPermutationStats {
+    unsigned int variantsReady = 0;     ///< Variantes con objetos de D3D creados (incluida la base).
+    unsigned int variantsPending = 0;   ///< Variantes pedidas que an se estn compilando.
+    unsigned int compiles = 0;          ///< Variantes compiladas (VS + PS), con xito o no.
+    unsigned int compileErrors = 0;     ///< Variantes que no compilaron (se sigue usando la base).
+    unsigned int fallbacksServed = 0;   ///< Peticiones resueltas con la variante base.
+    double compileMs = 0.0;             ///< Tiempo total compilando (incluye aciertos de cach).
+};
+
+
+// =================================================================================
+// CLASE: SHADER PERMUTATIONS
+// =================================================================================
+
+/**
+ * @class ShaderPermutations
+ * @brief Variantes de un mismo archivo .fx seleccionadas por una mscara de keywords.
+ *
+ * La variante base (mscara 0) se compila en @c init() y siempre est disponible.
+ * El resto se compila la primera vez que se pide, en un hilo propio: mientras tanto
+ * @c getVariant() devuelve la base, y en cuanto el bytecode est listo crea los
+ * objetos de D3D en el hilo que llama. Las variantes se guardan por mscara.
+ *
+ * La compilacin pasa por @c ShaderCache, as que una variante ya vista en otra
+ * ejecucin sale de disco. Todas comparten el input layout de la base.
+ */
+class ShaderPermutations {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    ShaderPermutations() = default;
+
+    ~ShaderPermutations() { destroy(); }
+
+    ShaderPermutations(const ShaderPermutations&) = delete;
+    ShaderPermutations& operator=(const ShaderPermutations&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Compila la variante base y arranca el hilo de compilacin.
+     * @param device Dispositivo con el que se crean los shaders.
+     * @param cache Cach de bytecode (debe vivir ms que este objeto).
+     * @param fileName Archivo HLSL con entry points "VS" y "PS".
+     * @param Layout Input layout comn a todas las variantes.
+     * @param keywords Nombres de los keywords, en el orden de sus bits (mximo 32).
+     * @return Error de la variante base, que es obligatoria.
+     */
+    HRESULT
+        init(Device& device,
+             ShaderCache& cache,
+             const std::string& fileName,
+             const std::vector<D3D11_INPUT_ELEMENT_DESC>& Layout,
+             const std::vector<std::string>& keywords);
+
+
+    /**
+     * @brief Detiene el hilo (termina la compilacin en curso) y libera todas las variantes.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // VARIANTES
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Devuelve la variante de @p mask, o la base si todava no est compilada.
+     *
+     * Recoge las compilaciones terminadas; la primera peticin de una mscara la
+     * encola. Los bits sin keyword se ignoran. Llamar siempre desde el mismo hilo.
+     */
+    ShaderProgram&
+        getVariant(Device& device, ShaderKeywordMask mask);
+
+
+    /**
+     * @brief Mscara con el bit del keyword @p name, o 0 si no existe.
+     */
+    ShaderKeywordMask
+        getKeywordMask(const std::string& name) const;
+
+
+    /**
+     * @brief true si la variante de @p mask ya tiene sus objetos de D3D.
+     */
+    bool
+        isReady(ShaderKeywordMask mask) const;
+
+
+    const ShaderPermutationStats&
+        getStats() const { return m_stats; }
+
+
+private:
+
+    /**
+     * @brief Bytecode producido por el hilo de compilacin.
+     */
+    struct CompiledVariant {
+        ShaderKeywordMask mask = 0;
+        std::vector<unsigned char> vertexBytecode;
+        std::vector<unsigned char> pixelBytecode;
+        std::string errors;
+        bool compiled = false;
+        double compileMs = 0.0;
+    };
+
+
+    /**
+     * @brief Compila VS y PS con las macros de @p mask (se puede llamar desde cualquier hilo).
+     */
+    CompiledVariant
+        compileVariant(ShaderKeywordMask mask) const;
+
+
+    /**
+     * @brief Crea los objetos de D3D de una variante compilada y la registra.
+     */
+    void
+        createVariant(Device& device, CompiledVariant& variant);
+
+
+    /**
+     * @brief Bucle del hilo: compila las mscaras encoladas una a una.
+     */
+    void
+        workerLoop();
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    ShaderCache* m_cache = nullptr;
+
+    std::string m_fileName;
+
+    std::vector<D3D11_INPUT_ELEMENT_DESC> m_layout;
+
+    std::vector<std::string> m_keywords;
+
+    /** @brief Bits que corresponden a algn keyword. */
+    ShaderKeywordMask m_validMask = 0;
+
+    /** @brief Mscara -> variante; @c nullptr mientras compila o si fall. */
+    std::unordered_map<ShaderKeywordMask, std::unique_ptr<ShaderProgram>> m_variants;
+
+    ShaderProgram* m_fallback = nullptr;
+
+    ShaderPermutationStats m_stats;
+
+    // Estado compartido con el hilo de compilacin
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<ShaderKeywordMask> m_queue;
+    std::vector<CompiledVariant> m_completed;
+    bool m_stop = false;
+
+};
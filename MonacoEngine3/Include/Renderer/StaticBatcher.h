@@ -0,0 +1,185 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "Buffer.h"
+#include "Renderer/TextureStreamer.h"
+#include <functional>
+
+class Device;
+class Actor;
+class MeshComponent;
+class RenderQueue;
+
+// =================================================================================
+// ESTRUCTURAS: PGINAS ESTTICAS
+// =================================================================================
+
+/**
+ * @struct StaticSubmesh
+ * @brief Rango de ndices de una malla original dentro de su pgina.
+ *
+ * Se conserva para poder descartar (culling) mallas sueltas aunque compartan buffer.
+ */
+struct StaticSubmesh {
+    unsigned int page = 0;          ///< Pgina que la contiene.
+    unsigned int startIndex = 0;    ///< Primer ndice dentro del index buffer de la pgina.
+    unsigned int indexCount = 0;    ///< ndices de la malla.
+    XMFLOAT3 boundsMin = XMFLOAT3(0.0f, 0.0f, 0.0f); ///< AABB en espacio de mundo.
+    XMFLOAT3 boundsMax = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    const Actor* owner = nullptr;   ///< Actor del que sale la malla (no propietario).
+};
+
+
+/**
+ * @struct StaticBatchStats
+ * @brief Tamao de las pginas construidas y draws del ltimo @c submit().
+ */
+struct StaticBatchStats {
+    unsigned int actors = 0;            ///< Actores fusionados.
+    unsigned int submeshes = 0;         ///< Mallas originales (draws que haran sin batching).
+    unsigned int pages = 0;             ///< Pginas de vrtices/ndices creadas.
+    unsigned int vertices = 0;          ///< Vrtices pre-transformados en total.
+    unsigned int indices = 0;           ///< ndices en total.
+    unsigned int drawsSubmitted = 0;    ///< Paquetes enviados en el ltimo @c submit().
+    unsigned int submeshesCulled = 0;   ///< Mallas descartadas en el ltimo @c submit().
+};
+
+
+// =================================================================================
+// CLASE: STATIC BATCHER
+// =================================================================================
+
+/**
+ * @class StaticBatcher
+ * @brief Fusiona la geometra de los actores estticos en pginas compartidas por material.
+ *
+ * Los vrtices se transforman a espacio de mundo una sola vez y se copian en pginas
+ * grandes (un vertex buffer y un index buffer por pgina), agrupadas por textura y
+ * sampler. Cada pgina se dibuja con un paquete de matriz identidad, as que N actores
+ * con el mismo material cuestan un draw y ningn cambio de buffer entre ellos.
+ *
+ * Los actores fusionados dejan de emitir paquetes propios. Si uno se mueve hay que
+ * volver a llamar a @c build(); el batcher no sigue sus transformaciones.
+ */
+class StaticBatcher {
+
+public:
+
+    /** @brief Decide si una malla es visible este frame (p. ej. prueba de frustum). */
+    using VisibilityFn = std::function<bool(const StaticSubmesh&)>;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    StaticBatcher() = default;
+
+    ~StaticBatcher() = default;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Construye las pginas a partir de los actores marcados con @c Actor::setStatic.
+     * Libera lo construido antes (y devuelve esos actores a su camino normal).
+     * @param device Dispositivo para crear los buffers.
+     * @param actors Actores candidatos; los no estticos o sin malla se ignoran.
+     * @param maxVerticesPerPage Vrtices por pgina antes de abrir otra del mismo material.
+     * @return @c S_OK o el error de creacin de algn buffer (en ese caso no se fusiona nada).
+     */
+    HRESULT
+        build(Device& device,
+              const std::vector<EU::TSharedPointer<Actor>>& actors,
+              unsigned int maxVerticesPerPage = 262144);
+
+
+    /**
+     * @brief Libera las pginas y devuelve los actores fusionados a su camino normal.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // RENDER
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Enva un paquete por cada serie de mallas visibles consecutivas de cada pgina.
+     * @param queue Cola del frame (ya iniciada).
+     * @param isVisible Si se omite, cada pgina sale en un nico draw.
+     */
+    void
+        submit(RenderQueue& queue, const VisibilityFn& isVisible = VisibilityFn());
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    /** @brief Mallas originales, agrupadas por pgina y en orden de ndices. */
+    const std::vector<StaticSubmesh>&
+        getSubmeshes() const { return m_submeshes; }
+
+
+    /** @brief Contadores de la construccin y del ltimo @c submit(). */
+    const StaticBatchStats&
+        getStats() const { return m_stats; }
+
+
+private:
+
+    /**
+     * @brief Vertex/index buffer compartidos por mallas del mismo material.
+     */
+    struct StaticPage {
+        Buffer vertexBuffer;
+        Buffer indexBuffer;
+        ID3D11ShaderResourceView* texture = nullptr;  ///< Albedo en t0 (no propietario).
+        TextureStreamer* streamer = nullptr;          ///< Si no es nullptr, el albedo se consulta aqu en cada @c submit().
+        StreamHandle stream = kInvalidStream;
+        ID3D11SamplerState* sampler = nullptr;        ///< Sampler en s0 (no propietario).
+        unsigned int firstSubmesh = 0;                ///< Primera entrada en @c m_submeshes.
+        unsigned int submeshCount = 0;
+        XMFLOAT3 center = XMFLOAT3(0.0f, 0.0f, 0.0f);  ///< Centro del AABB (profundidad para ordenar).
+    };
+
+
+    /**
+     * @brief Sube la geometra acumulada como una pgina nueva.
+     */
+    HRESULT
+        flushPage(Device& device,
+                  MeshComponent& staging,
+                  ID3D11ShaderResourceView* texture,
+                  TextureStreamer* streamer,
+                  StreamHandle stream,
+                  ID3D11SamplerState* sampler,
+                  unsigned int firstSubmesh);
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    std::vector<StaticPage> m_pages;
+
+    std::vector<StaticSubmesh> m_submeshes;
+
+    /** @brief Actores fusionados (para devolverlos a su camino normal en @c destroy()). */
+    std::vector<Actor*> m_batchedActors;
+
+    /** @brief Constantes por objeto de todas las pginas: mundo identidad y color blanco. */
+    CBChangesEveryFrame m_objectConstants;
+
+    /** @brief Copia en GPU de @c m_objectConstants para cuando la cola no tiene anillo. */
+    Buffer m_objectBuffer;
+
+    StaticBatchStats m_stats;
+
+};
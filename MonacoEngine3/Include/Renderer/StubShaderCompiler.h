@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Renderer/ShaderCompiler.h"
+#include <atomic>
+
+// =================================================================================
+// CLASE: STUB SHADER COMPILER
+// =================================================================================
+
+/**
+ * @class StubShaderCompiler
+ * @brief @c IShaderCompiler sin DirectX para probar @c ShaderCache en modo headless.
+ *
+ * No lee el archivo: el "bytecode" son los bytes de la peticin (archivo, entry point,
+ * perfil, macros y flags), as que dos peticiones iguales dan el mismo resultado. Falla
+ * siempre con el entry point marcado en @c setFailingEntryPoint().
+ */
+class StubShaderCompiler : public IShaderCompiler {
+
+public:
+
+    StubShaderCompiler() = default;
+
+    ~StubShaderCompiler() = default;
+
+
+    bool
+        compile(const ShaderCompileRequest& request,
+                std::vector<unsigned char>& bytecode,
+                std::string& errors) override;
+
+
+    const char*
+        getName() const override { return "StubShaderCompiler"; }
+
+
+    /**
+     * @brief Las peticiones con este entry point fallan (vaco = ninguna).
+     */
+    void
+        setFailingEntryPoint(const std::string& entryPoint) { m_failingEntryPoint = entryPoint; }
+
+
+    /**
+     * @brief Llamadas a @c compile() desde la creacin, con xito o no.
+     */
+    unsigned int
+        getCompileCount() const { return m_compiles; }
+
+
+private:
+
+    std::string m_failingEntryPoint;
+
+    std::atomic<unsigned int> m_compiles{ 0 };
+
+};
@@ -0,0 +1,367 @@
+#pragma once
+
+#include "Prerequisites.h"
+#include "EngineUtilities/Utilities/ImageImporter.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Camera;
+class Device;
+class IRenderBackend;
+
+// =================================================================================
+// ESTRUCTURAS: STREAMING DE TEXTURAS
+// =================================================================================
+
+/** @brief Identificador de una textura dentro de un @c TextureStreamer. */
+using StreamHandle = unsigned int;
+
+/** @brief Handle que no apunta a ninguna textura. */
+const StreamHandle kInvalidStream = ~0u;
+
+
+/**
+ * @struct TextureStreamerSettings
+ * @brief Presupuesto de memoria y ritmo de las subidas.
+ */
+struct TextureStreamerSettings {
+    unsigned long long budgetBytes = 64ull * 1024 * 1024;  ///< VRAM de todas las texturas en streaming (colas incluidas).
+    unsigned int tailSize = 64;         ///< Los niveles de este lado o menores se cargan en @c add() y nunca se expulsan.
+    float mipBias = 0.0f;               ///< Se suma al nivel pedido (positivo = menos detalle).
+    unsigned int maxInFlight = 4;       ///< Subidas encoladas o en curso a la vez.
+};
+
+
+/**
+ * @struct TextureStreamerStats
+ * @brief Residencia actual y trabajo acumulado desde @c init().
+ */
+struct TextureStreamerStats {
+    unsigned int textures = 0;
+    unsigned int visible = 0;               ///< Pedidas en el ltimo @c update().
+    unsigned int satisfied = 0;             ///< Visibles con su nivel pedido ya residente.
+    unsigned int pending = 0;               ///< Subidas encoladas o en curso.
+    unsigned long long residentBytes = 0;   ///< Niveles en GPU de todas las texturas.
+    unsigned long long reservedBytes = 0;   ///< Tamao de las texturas que se estn creando.
+    unsigned long long wantedBytes = 0;     ///< Lo que ocuparan todas con su nivel pedido.
+    unsigned int uploads = 0;
+    unsigned int evictions = 0;             ///< Texturas devueltas a su cola por falta de presupuesto.
+    unsigned int budgetMisses = 0;          ///< Subidas aplazadas porque no caban ni expulsando.
+    unsigned long long bytesUploaded = 0;
+    double uploadMs = 0.0;                  ///< Tiempo del hilo de subida creando texturas.
+};
+
+
+/**
+ * @struct StreamedTextureInfo
+ * @brief Estado de una textura para la GUI.
+ */
+struct StreamedTextureInfo {
+    std::string name;
+    unsigned int width = 0;                 ///< Tamao del nivel 0.
+    unsigned int height = 0;
+    unsigned int levels = 0;
+    unsigned int residentMip = 0;           ///< Nivel ms detallado en GPU.
+    unsigned int wantedMip = 0;             ///< Nivel pedido por la densidad de texels.
+    unsigned int tailMip = 0;               ///< Primer nivel de la cola siempre residente.
+    unsigned long long residentBytes = 0;
+    unsigned long long framesUnused = 0;    ///< Frames desde la ltima peticin.
+    bool pending = false;
+};
+
+
+// =================================================================================
+// CLASE: TEXTURE STREAMER
+// =================================================================================
+
+/**
+ * @class TextureStreamer
+ * @brief Carga por niveles de las texturas importadas, dentro de un presupuesto de VRAM.
+ *
+ * @c add() importa la imagen (ver @c ImageImporter; con un acierto de cach queda
+ * proyectada en memoria con todos sus niveles) y sube slo la cola de mips, as que la
+ * carga inicial cuesta unos KB por textura. Cada frame se pide el nivel que hace falta
+ * segn la densidad de texels en pantalla: el tamao proyectado de los bounds de la malla
+ * desde la @c Camera frente al tamao de la textura.
+ *
+ * En D3D11 no se puede cambiar el nmero de niveles de una textura, as que cada cambio
+ * de residencia crea otra con los niveles [nivel, cola] directamente desde el blob.
+ * Las subidas corren en un hilo propio con las entradas de creacin concurrente del
+ * @c IRenderBackend, que cuentan los recursos sin tocar sus contadores del frame.
+ * @c update() recoge las terminadas y cambia la vista en el hilo principal: la vista
+ * cambia de objeto, as que hay que consultarla con @c getView() cada vez que se dibuja,
+ * no guardarla.
+ *
+ * Si una subida no cabe en el presupuesto se devuelven a su cola las texturas que lleven
+ * ms tiempo sin pedirse (LRU); las pedidas en este frame nunca se expulsan. Si ni
+ * expulsando cabra, no se expulsa nada.
+ */
+class TextureStreamer {
+
+public:
+
+    // -----------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR
+    // -----------------------------------------------------------------------------
+
+    TextureStreamer() = default;
+
+    ~TextureStreamer() { destroy(); }
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+
+    // -----------------------------------------------------------------------------
+    // CICLO DE VIDA
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Guarda el dispositivo y arranca el hilo de subida.
+     * @return E_POINTER si el dispositivo no existe.
+     */
+    HRESULT
+        init(Device& device, const TextureStreamerSettings& settings);
+
+
+    /**
+     * @brief Detiene el hilo (termina la subida en curso) y libera todas las texturas.
+     */
+    void
+        destroy();
+
+
+    // -----------------------------------------------------------------------------
+    // TEXTURAS
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Importa una imagen y sube su cola de mips.
+     * @param settings Se fuerza @c generateMips; con cach, los niveles se leen de su blob proyectado.
+     * @return kInvalidStream si no se pudo importar o crear la cola.
+     */
+    StreamHandle
+        add(const std::string& path, const ImageImportSettings& settings);
+
+
+    /**
+     * @brief Pide el nivel que necesita una malla con estos bounds vista desde @p camera.
+     *
+     * Se puede llamar una vez por malla que use la textura; cuenta la ms exigente.
+     * Los bounds detrs de la cmara no piden nada.
+     * @param viewportHeight Alto en pxeles del rea donde se dibuja la escena.
+     */
+    void
+        request(StreamHandle handle,
+                const Camera& camera,
+                const XMFLOAT3& boundsMin,
+                const XMFLOAT3& boundsMax,
+                float viewportHeight);
+
+
+    /**
+     * @brief Nivel de mip cuyo tamao se acerca a un texel por pxel para esos bounds.
+     *
+     * Supone que las UVs recorren la textura una vez sobre la malla: el lado mayor de la
+     * textura se reparte sobre el dimetro proyectado de la esfera que envuelve los bounds.
+     * @return Nivel continuo (negativo = hara falta ms detalle que el nivel 0).
+     */
+    static float
+        computeMip(const Camera& camera,
+                   const XMFLOAT3& boundsMin,
+                   const XMFLOAT3& boundsMax,
+                   float viewportHeight,
+                   unsigned int width,
+                   unsigned int height);
+
+
+    /**
+     * @brief Recoge las subidas terminadas, aplica el presupuesto y encola las nuevas.
+     * Llamar una vez por frame, despus de las peticiones y antes de dibujar.
+     */
+    void
+        update();
+
+
+    /**
+     * @brief Vista actual de la textura (cambia al subir o expulsar niveles).
+     */
+    ID3D11ShaderResourceView*
+        getView(StreamHandle handle) const;
+
+
+    // -----------------------------------------------------------------------------
+    // CONSULTA
+    // -----------------------------------------------------------------------------
+
+    const TextureStreamerSettings&
+        getSettings() const { return m_settings; }
+
+
+    /**
+     * @brief Cambia el presupuesto o el ritmo; el nuevo presupuesto se aplica en el prximo @c update().
+     */
+    void
+        setSettings(const TextureStreamerSettings& settings) { m_settings = settings; }
+
+
+    const TextureStreamerStats&
+        getStats() const { return m_stats; }
+
+
+    unsigned int
+        getTextureCount() const { return static_cast<unsigned int>(m_textures.size()); }
+
+
+    StreamedTextureInfo
+        getInfo(StreamHandle handle) const;
+
+
+private:
+
+    /**
+     * @brief Una textura: su imagen importada con todos los niveles y la parte que est en GPU.
+     */
+    struct StreamedTexture {
+        std::string name;
+        ImportedImage image;
+        ID3D11Texture2D* texture = nullptr;
+        ID3D11ShaderResourceView* view = nullptr;
+        unsigned int residentMip = 0;
+        unsigned int tailMip = 0;
+        unsigned int wantedMip = 0;
+        float requestedMip = 0.0f;          ///< Mnimo de las peticiones de este frame.
+        bool requested = false;
+        bool pending = false;
+        unsigned long long residentBytes = 0;
+        unsigned long long lastUsedFrame = 0;
+    };
+
+
+    /**
+     * @brief Textura a crear con los niveles [firstMip, ltimo].
+     */
+    struct UploadJob {
+        StreamHandle handle = kInvalidStream;
+        unsigned int firstMip = 0;
+        D3D11_TEXTURE2D_DESC desc;
+        std::vector<D3D11_SUBRESOURCE_DATA> levels;     ///< Apuntan al blob de la textura.
+        unsigned long long bytes = 0;
+    };
+
+
+    /**
+     * @brief Resultado del hilo de subida.
+     */
+    struct CompletedUpload {
+        StreamHandle handle = kInvalidStream;
+        unsigned int firstMip = 0;
+        ID3D11Texture2D* texture = nullptr;
+        ID3D11ShaderResourceView* view = nullptr;
+        unsigned long long bytes = 0;
+        HRESULT hr = S_OK;
+        double ms = 0.0;
+    };
+
+
+    /**
+     * @brief Primer nivel vlido como nivel 0 de una textura (BCn exige mltiplos de 4) igual o ms detallado que @p mip.
+     */
+    unsigned int
+        getValidTopMip(const StreamedTexture& texture, unsigned int mip) const;
+
+
+    /**
+     * @brief Bytes de los niveles [firstMip, ltimo].
+     */
+    unsigned long long
+        getBytesFrom(const StreamedTexture& texture, unsigned int firstMip) const;
+
+
+    void
+        makeJob(StreamHandle handle, unsigned int firstMip, UploadJob& job) const;
+
+
+    /**
+     * @brief Crea textura y vista (desde cualquier hilo).
+     */
+    HRESULT
+        createTexture(const UploadJob& job,
+                      ID3D11Texture2D** texture,
+                      ID3D11ShaderResourceView** view) const;
+
+
+    /**
+     * @brief Sustituye la textura en GPU de @p handle y ajusta las cuentas.
+     */
+    void
+        replaceTexture(StreamHandle handle,
+                       unsigned int firstMip,
+                       ID3D11Texture2D* texture,
+                       ID3D11ShaderResourceView* view,
+                       unsigned long long bytes);
+
+
+    /**
+     * @brief Devuelve a su cola la textura sin pedir que lleve ms frames sin usarse.
+     * @return false si no queda ninguna que expulsar.
+     */
+    bool
+        evictLeastRecentlyUsed();
+
+
+    /**
+     * @brief Sin subida en curso, con niveles por encima de la cola y sin pedir este frame.
+     */
+    bool
+        isEvictable(const StreamedTexture& texture) const {
+        return !texture.pending && texture.residentMip < texture.tailMip && texture.lastUsedFrame < m_frame;
+    }
+
+
+    /**
+     * @brief Bytes que liberara expulsar todo lo que @c evictLeastRecentlyUsed() puede expulsar.
+     */
+    unsigned long long
+        getEvictableBytes() const;
+
+
+    /**
+     * @brief Bucle del hilo: crea las texturas encoladas una a una.
+     */
+    void
+        workerLoop();
+
+
+private:
+
+    // -----------------------------------------------------------------------------
+    // DATOS MIEMBRO
+    // -----------------------------------------------------------------------------
+
+    /** @brief Backend del dispositivo; el hilo de subida slo usa sus entradas concurrentes. */
+    IRenderBackend* m_backend = nullptr;
+
+    TextureStreamerSettings m_settings;
+
+    /** @brief Punteros estables: el hilo de subida lee los blobs mientras se aaden otras. */
+    std::vector<std::unique_ptr<StreamedTexture>> m_textures;
+
+    TextureStreamerStats m_stats;
+
+    unsigned long long m_frame = 0;
+
+    // Estado compartido con el hilo de subida
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<UploadJob> m_queue;
+    std::vector<CompletedUpload> m_completed;
+    bool m_stop = false;
+
+};
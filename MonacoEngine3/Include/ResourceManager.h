@@ -2,6 +2,7 @@
 
 #include "Prerequisites.h"
 #include "IResource.h"
+#include "EngineUtilities/Utilities/EngineStats.h"
 #include <unordered_map>
 #include <memory>
 #include <string>
@@ -101,6 +102,7 @@ public:
             // Verificar si el recurso es vlido y est cargado
             if (existing && existing->GetState() == ResourceState::Loaded)
             {
+                ENGINE_STAT_ADD("resource_cache_hits", 1);
                 return existing;
             }
         }
@@ -109,6 +111,7 @@ public:
         std::shared_ptr<T> resource = std::make_shared<T>(key, std::forward<Args>(args)...);
 
         // 3. Cargar desde archivo (I/O)
+        ENGINE_STAT_ADD("resource_loads", 1);
         if (!resource->load(filename))
         {
             // TODO: Loguear error especfico aqu ("Fallo al cargar archivo X")
@@ -122,7 +125,11 @@ public:
             return nullptr;
         }
 
-        // 5. Guardar en el cach y devolver
+        // 5. Guardar en el cach y devolver (si reemplaza una entrada no cargada, no suma)
+        if (it == m_resources.end())
+        {
+            ENGINE_GAUGE_ADD("resources", 1);
+        }
         m_resources[key] = resource;
 
         return resource;
@@ -171,6 +178,7 @@ public:
         {
             it->second->unload();
             m_resources.erase(it);
+            ENGINE_GAUGE_ADD("resources", -1);
         }
     }
 
@@ -190,6 +198,7 @@ public:
             }
         }
 
+        ENGINE_GAUGE_ADD("resources", -static_cast<long long>(m_resources.size()));
         m_resources.clear();
     }
 
@@ -1,6 +1,7 @@
 #include "SamplerState.h"
 #include "Device.h"
 #include "DeviceContext.h"
+#include "Renderer/PipelineStateCache.h"
 
 /*HRESULT
 SamplerState::init(Device& device) {
@@ -46,11 +47,14 @@ SamplerState::init(Device& device) {
   sampDesc.MinLOD = 0;
   sampDesc.MaxLOD = D3D11_FLOAT32_MAX;
 
-  HRESULT hr = device.CreateSamplerState(&sampDesc, &m_sampler);
-  if (FAILED(hr)) {
+  // Todos los actores piden la misma descripcin: se comparte un nico objeto
+  m_sampler = PipelineStateCache::getInstance().getSamplerState(device, sampDesc);
+  if (!m_sampler) {
     ERROR("SamplerState", "init", "Failed to create SamplerState");
-    return hr;
+    return E_FAIL;
   }
+  // La cach conserva su referencia; destroy() libera slo la nuestra
+  m_sampler->AddRef();
 
   return S_OK;
 }
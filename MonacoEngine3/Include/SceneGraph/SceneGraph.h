@@ -5,6 +5,7 @@
 // Forward declarations para reducir dependencias
 class Entity;
 class DeviceContext;
+class RenderQueue;
 
 /**
  * @class SceneGraph
@@ -74,13 +75,21 @@ public:
         detach(Entity* child);
 
     /**
-     * @brief Actualiza la lgica de todas las entidades y recalcula las matrices de mundo.
-     * @param deltaTime Tiempo transcurrido desde el ltimo frame.
+     * @brief Avanza un paso de simulacin: guarda el estado anterior de cada @c Transform,
+     * actualiza la lgica de todas las entidades y recalcula las matrices de mundo.
+     * @param deltaTime Duracin del paso (fija, ver @c FixedTimestep).
      * @param deviceContext Contexto del dispositivo (si es necesario para la lgica).
      */
     void
         update(float deltaTime, DeviceContext& deviceContext);
 
+    /**
+     * @brief Calcula la matriz de dibujo de cada entidad entre los dos ltimos pasos.
+     * @param alpha Fraccin de paso pendiente (@c FixedTimestep::getAlpha()).
+     */
+    void
+        interpolate(float alpha);
+
     /**
      * @brief Renderiza todas las entidades visibles gestionadas por el grafo.
      * @param deviceContext Contexto grfico necesario para dibujar.
@@ -88,6 +97,13 @@ public:
     void
         render(DeviceContext& deviceContext);
 
+    /**
+     * @brief Recolecta los paquetes de dibujo de todas las entidades en una cola.
+     * @param queue Cola del frame actual (ya iniciada con @c RenderQueue::begin).
+     */
+    void
+        submit(RenderQueue& queue);
+
     /**
      * @brief Destruye el grafo, liberando todas las entidades y recursos asociados.
      */
@@ -7,6 +7,7 @@
 
 class Device;
 class DeviceContext;
+class ShaderCache;
 
 
 // =================================================================================
@@ -59,6 +60,24 @@ public:
             std::vector<D3D11_INPUT_ELEMENT_DESC> Layout);
 
 
+    /**
+     * @brief Crea VS, PS e InputLayout a partir de bytecode ya compilado (sin tocar archivos).
+     *
+     * Lo usa @c ShaderPermutations: las variantes se compilan en otro hilo y slo la
+     * creacin de los objetos de D3D ocurre aqu.
+     * @param device Referencia al objeto Device de DirectX.
+     * @param vertexBytecode Bytecode del Vertex Shader.
+     * @param pixelBytecode Bytecode del Pixel Shader.
+     * @param Layout Vector de estructuras que describen los elementos del vrtice.
+     * @return HRESULT El cdigo de resultado de la operacin (S_OK si es exitosa).
+     */
+    HRESULT
+        init(Device& device,
+            const std::vector<unsigned char>& vertexBytecode,
+            const std::vector<unsigned char>& pixelBytecode,
+            std::vector<D3D11_INPUT_ELEMENT_DESC> Layout);
+
+
     /**
      * @brief Lgica de actualizacin (generalmente vaca para shaders estticos).
      */
@@ -135,9 +154,17 @@ public:
                     const std::string& fileName);
 
 
+    /**
+     * @brief Usa una cach de bytecode en las prximas compilaciones.
+     * @param cache Cach compartida (propiedad de quien llama) o @c nullptr para compilar siempre.
+     */
+    void
+        setShaderCache(ShaderCache* cache) { m_shaderCache = cache; }
+
+
     /**
      * @brief Compila el cdigo fuente del shader desde un archivo a un buffer de bytecodes.
-     * Funcin auxiliar de bajo nivel para compilar HLSL.
+     * Funcin auxiliar de bajo nivel para compilar HLSL; pasa por la cach si hay una.
      * @param szFileName Nombre del archivo del shader (HLSL).
      * @param szEntryPoint Nombre de la funcin principal (e.g., "VSMain", "PSMain").
      * @param szShaderModel Modelo del shader (e.g., "vs_5_0", "ps_5_0").
@@ -186,4 +213,8 @@ private:
     /** @brief Bfer de datos (blob) del Pixel Shader compilado. */
     ID3DBlob* m_pixelShaderData = nullptr;
 
+
+    /** @brief Cach de bytecode opcional (no es propietario). */
+    ShaderCache* m_shaderCache = nullptr;
+
 };
\ No newline at end of file
@@ -79,6 +79,11 @@ public:
    */
   void present();
 
+  /**
+   * @brief Intervalo de sincronizacin de los siguientes @c present() (0 = sin vsync).
+   */
+  void setSyncInterval(unsigned int syncInterval) { m_syncInterval = syncInterval; }
+
 public:
   /**
    * @brief Puntero COM al objeto de la cadena de intercambio de DXGI.
@@ -94,6 +99,11 @@ public:
   D3D_DRIVER_TYPE m_driverType = D3D_DRIVER_TYPE_NULL;
 
 private:
+  /**
+   * @brief Primer argumento de @c IDXGISwapChain::Present().
+   */
+  unsigned int m_syncInterval = 0;
+
   /**
    * @brief Nivel de caractersticas de Direct3D utilizado por el dispositivo.
    * @details Establece la versin mnima de caractersticas soportadas.
@@ -1,11 +1,25 @@
 #pragma once
 
 #include "Prerequisites.h"
+#include "EngineUtilities/Utilities/ImageImporter.h"
 #include <string>
 #include <array>
 
 class Device;
 class DeviceContext;
+class ThreadPool;
+
+
+/**
+ * @struct CubemapFaces
+ * @brief Las seis caras de un cubemap decodificadas en CPU, con sus mips si se pidieron.
+ */
+struct CubemapFaces {
+    std::array<ImportedImage, 6> faces;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    double decodeMs = 0.0;      ///< Decodificacin y mips de las seis caras.
+};
 
 
 // =================================================================================
@@ -50,15 +64,23 @@ public:
      * @brief Inicializa una textura cargada desde archivo.
      *
      * Crea un recurso de textura a partir de una imagen y genera su SRV.
+     * PNG y JPG pasan por @c ImageImporter: se suben con la cadena de mips completa, generada
+     * en CPU y, con @p compression, comprimida en bloques. El resultado queda en @c TextureCache/
+     * con el hash del archivo original como clave: las siguientes cargas suben directamente
+     * desde el blob proyectado en memoria, sin decodificar ni comprimir.
      * @param device Dispositivo con el que se crear la textura.
      * @param textureName Nombre o ruta del archivo de textura.
      * @param extensionType Tipo de extensin de archivo (ej. PNG, JPG, DDS).
+     * @param threadPool Hilos para filtrar y comprimir imgenes grandes (nullptr = en serie).
+     * @param compression Formato BCn para PNG/JPG (@c BcFormat::None = RGBA8 sin comprimir).
      * @return @c S_OK si fue exitoso.
      */
     HRESULT
         init(Device& device,
             const std::string& textureName,
-            ExtensionType extensionType);
+            ExtensionType extensionType,
+            ThreadPool* threadPool = nullptr,
+            BcFormat compression = BcFormat::None);
 
 
     /**
@@ -104,17 +126,38 @@ public:
     /**
      * @brief Crea un Cubemap (Skybox) a partir de 6 texturas individuales.
      *
+     * Las caras se decodifican a la vez (ver @c decodeCubemapFaces) y se suben con todos
+     * sus niveles en una sola llamada.
      * @param device Dispositivo grfico.
-     * @param deviceContext Contexto para comandos de copia.
      * @param facePaths Array de 6 rutas a las texturas (Right, Left, Top, Bottom, Front, Back).
-     * @param generateMips Si es true, genera mipmaps automticamente.
+     * @param generateMips Si es true, genera la cadena de mips en CPU (filtrada en lineal).
+     * @param threadPool Hilos para decodificar las caras (nullptr = en serie).
      * @return S_OK si el cubemap se cre correctamente.
      */
     HRESULT
         CreateCubemap(Device& device,
-                      DeviceContext& deviceContext,
                       const std::array<std::string, 6>& facePaths,
-                      bool generateMips = false);
+                      bool generateMips = false,
+                      ThreadPool* threadPool = nullptr);
+
+
+    /**
+     * @brief Decodifica las seis caras de un cubemap sin tocar la GPU.
+     *
+     * Cada cara es una tarea del pool: su importacin (ver @c ImageImporter) corre en su
+     * hilo, y el resultado se junta al volver. Si una cara falla se liberan todas.
+     * @param generateMips Genera la cadena completa de cada cara.
+     * @param threadPool Una cara por tarea (nullptr = en serie).
+     * @param out Caras decodificadas; vaco si falla.
+     * @param useCache false decodifica siempre (para medir), sin leer ni escribir la cach.
+     * @return E_FAIL si alguna cara no carga o los tamaos no coinciden.
+     */
+    static HRESULT
+        decodeCubemapFaces(const std::array<std::string, 6>& facePaths,
+                           bool generateMips,
+                           ThreadPool* threadPool,
+                           CubemapFaces& out,
+                           bool useCache = true);
 
 
     // -----------------------------------------------------------------------------
@@ -155,6 +198,14 @@ public:
     // UTILIDADES (Helpers)
     // -----------------------------------------------------------------------------
 
+    /**
+     * @brief Bytes de GPU de una textura 2D con su cadena de mips, caras y muestras MSAA.
+     * Los formatos BCn se cuentan por bloques de 4x4.
+     */
+    static unsigned long long
+        getTextureBytes(const D3D11_TEXTURE2D_DESC& desc);
+
+
     /**
      * @brief Helper para crear una vista (SRV) de una cara especfica de un Cubemap.
      * til para renderizar caras individuales de un entorno dinmico.
@@ -190,6 +241,31 @@ public:
     }
 
 
+private:
+
+    /**
+     * @brief Importa un PNG/JPG (ver @c ImageImporter) y lo sube con toda su cadena de mips.
+     * @param label Tipo de imagen para los mensajes de error ("PNG", "JPG").
+     */
+    HRESULT
+        initFromImage(Device& device,
+                      const char* label,
+                      ThreadPool* threadPool,
+                      BcFormat compression);
+
+
+    /**
+     * @brief Crea la textura con todos sus niveles y su SRV.
+     */
+    HRESULT
+        uploadLevels(Device& device,
+                     const char* label,
+                     DXGI_FORMAT format,
+                     unsigned int width,
+                     unsigned int height,
+                     const std::vector<D3D11_SUBRESOURCE_DATA>& levels);
+
+
 public:
 
     // -----------------------------------------------------------------------------
@@ -207,4 +283,8 @@ public:
     /** @brief Nombre o ruta de la textura (si proviene de archivo). */
     std::string m_textureName;
 
+
+    /** @brief Memoria de GPU del recurso, si esta textura lo cre (0 para vistas de otra). */
+    unsigned long long m_gpuBytes = 0;
+
 };
\ No newline at end of file
@@ -7,5 +7,103 @@
 int WINAPI
 wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, int nCmdShow) {
 	BaseApp app;
+
+	// --crowd=N: N espadas con la misma malla (demo de instanciado)
+	if (lpCmdLine) {
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--crowd=")) {
+			app.setCrowdSize(static_cast<unsigned int>(_wtoi(arg + wcslen(L"--crowd="))));
+		}
+	}
+
+	// --static-crowd: fusiona las copias en buffers compartidos en lugar de instanciarlas
+	if (lpCmdLine && wcsstr(lpCmdLine, L"--static-crowd")) {
+		app.setStaticCrowd(true);
+	}
+
+	// --no-state-filter: emite todos los binds aunque no cambien el estado (comparativa)
+	if (lpCmdLine && wcsstr(lpCmdLine, L"--no-state-filter")) {
+		app.setStateFiltering(false);
+	}
+
+	// --render-threads=N: contextos diferidos que graban la cola (1 = en serie)
+	if (lpCmdLine) {
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--render-threads=")) {
+			app.setRenderThreads(static_cast<unsigned int>(_wtoi(arg + wcslen(L"--render-threads="))));
+		}
+	}
+
+	// --lights=N: luces puntuales y focos repartidos por clusters (0 = desactivadas)
+	if (lpCmdLine) {
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--lights=")) {
+			app.setLightCount(static_cast<unsigned int>(_wtoi(arg + wcslen(L"--lights="))));
+		}
+	}
+
+	// --resolution-budget=MS: presupuesto por frame de la resolucion dinamica (sin el argumento, desactivada)
+	if (lpCmdLine) {
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--resolution-budget=")) {
+			app.setFrameBudget(static_cast<float>(_wtof(arg + wcslen(L"--resolution-budget="))));
+		}
+	}
+
+	// --fps=N [--max-latency=N] [--vsync]: ritmo de frames y frames en cola (tambien headless)
+	if (lpCmdLine) {
+		float fps = 0.0f;
+		unsigned int maxLatency = 2;
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--fps=")) {
+			fps = static_cast<float>(_wtof(arg + wcslen(L"--fps=")));
+		}
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--max-latency=")) {
+			maxLatency = static_cast<unsigned int>(_wtoi(arg + wcslen(L"--max-latency=")));
+		}
+		app.setFramePacing(fps, maxLatency, wcsstr(lpCmdLine, L"--vsync") != nullptr);
+	}
+
+	// --sim-hz=N: pasos por segundo de la simulacion (el dibujo interpola entre pasos)
+	if (lpCmdLine) {
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--sim-hz=")) {
+			app.setSimulationRate(static_cast<float>(_wtof(arg + wcslen(L"--sim-hz="))));
+		}
+	}
+
+	// --texture-budget=MB: VRAM de las texturas en streaming
+	if (lpCmdLine) {
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--texture-budget=")) {
+			app.setTextureBudget(static_cast<unsigned int>(_wtoi(arg + wcslen(L"--texture-budget="))));
+		}
+	}
+
+	// --trace=N: traza de Chrome (Trace.json) de la carga y los primeros N frames
+	if (lpCmdLine) {
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--trace=")) {
+			app.setTraceCapture(static_cast<unsigned int>(_wtoi(arg + wcslen(L"--trace="))));
+		}
+	}
+
+	// --stats-csv=FILE: una fila por frame con draws, triangulos, subidas y memoria
+	if (lpCmdLine) {
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--stats-csv=")) {
+			std::string file;
+			for (const wchar_t* c = arg + wcslen(L"--stats-csv="); *c && *c != L' '; ++c) {
+				file += static_cast<char>(*c);
+			}
+			app.setStatsCsv(file);
+		}
+	}
+
+	// --export-dds: deja un .dds junto a cada blob de TextureCache (para herramientas externas)
+	if (lpCmdLine && wcsstr(lpCmdLine, L"--export-dds")) {
+		ImageImporter::setDdsExport(true);
+	}
+
+	// --headless [--frames=N]: benchmark de CPU sin ventana ni GPU
+	if (lpCmdLine && wcsstr(lpCmdLine, L"--headless")) {
+		unsigned int frames = 600;
+		if (const wchar_t* arg = wcsstr(lpCmdLine, L"--frames=")) {
+			frames = static_cast<unsigned int>(_wtoi(arg + wcslen(L"--frames=")));
+		}
+		return app.runHeadless(frames);
+	}
+
 	return app.run(hInstance, nCmdShow);
 }
@@ -1,5 +1,452 @@
 #include "BaseApp.h"
 #include "ResourceManager.h"
+#include "RHI/D3D11RenderBackend.h"
+#include "RHI/NullRenderBackend.h"
+#include "EngineUtilities/Utilities/EngineStats.h"
+#include "EngineUtilities/Utilities/MipGenerator.h"
+#include "EngineUtilities/Utilities/BlockCompressor.h"
+#include "Renderer/StubShaderCompiler.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+namespace {
+    const std::array<std::string, 6> kSkyboxFaces = {
+        "Skybox/cubemap_0.png",
+        "Skybox/cubemap_1.png",
+        "Skybox/cubemap_2.png",
+        "Skybox/cubemap_3.png",
+        "Skybox/cubemap_4.png",
+        "Skybox/cubemap_5.png"
+    };
+
+    // Bytes del anillo de constantes por objeto
+    const unsigned int kConstantRingCapacity = 4 * 1024 * 1024;
+
+    // Luces de la demo repartidas sobre las espadas; semilla fija para que el benchmark se repita
+    void
+    makeDemoLights(unsigned int count, std::vector<Light>& lights) {
+        unsigned int seed = 12345u;
+        auto random = [&seed](float low, float high) {
+            seed = seed * 1664525u + 1013904223u;
+            return low + (high - low) * static_cast<float>(seed >> 8) / 16777216.0f;
+        };
+        lights.resize(count);
+        for (unsigned int i = 0; i < count; ++i) {
+            Light& light = lights[i];
+            light.position = XMFLOAT3(random(-12.0f, 12.0f), random(-6.0f, 2.0f), random(2.0f, 40.0f));
+            light.range = random(1.0f, 3.0f);
+            light.color = XMFLOAT3(random(0.2f, 1.0f), random(0.2f, 1.0f), random(0.2f, 1.0f));
+            if (i % 4 == 3) {
+                light.type = LightType::Spot;
+                light.direction = XMFLOAT3(random(-0.3f, 0.3f), -1.0f, random(-0.3f, 0.3f));
+                light.spotAngle = random(0.3f, 0.7f);
+            }
+        }
+    }
+
+    void
+    writeTextFile(const std::string& path, const std::string& text) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    // ShaderCache con un compilador falso: fallo y acierto, claves que cambian con macros e
+    // includes, errores que no se guardan y entradas que se sirven en la siguiente ejecucin
+    bool
+    checkShaderCache() {
+        const std::string source = "HeadlessCheck.hlsl";
+        const std::string include = "HeadlessCheck.hlsli";
+        const std::string cachePath = "HeadlessCheckShaders.bin";
+        writeTextFile(source, "#include \"HeadlessCheck.hlsli\"\nfloat4 VS() : SV_POSITION { return Value(); }\n");
+        writeTextFile(include, "float4 Value() { return 0; }\n");
+        std::remove(cachePath.c_str());
+
+        StubShaderCompiler compiler;
+        compiler.setFailingEntryPoint("Broken");
+        ShaderCompileRequest request;
+        request.fileName = source;
+        request.entryPoint = "VS";
+        request.profile = "vs_4_0";
+        std::vector<unsigned char> first, bytecode;
+        std::string errors;
+        bool ok = true;
+        {
+            ShaderCache cache;
+            ok &= cache.init(compiler, cachePath);
+            ok &= cache.compile(request, first, errors) && compiler.getCompileCount() == 1;
+            ok &= cache.compile(request, bytecode, errors) && bytecode == first && compiler.getCompileCount() == 1;
+            ShaderCompileRequest defined = request;
+            defined.defines.push_back({ "USE_FOG", "1" });
+            ok &= cache.compile(defined, bytecode, errors) && bytecode != first && compiler.getCompileCount() == 2;
+            writeTextFile(include, "float4 Value() { return 1; }\n");
+            ok &= cache.compile(request, bytecode, errors) && compiler.getCompileCount() == 3;
+            ShaderCompileRequest broken = request;
+            broken.entryPoint = "Broken";
+            errors.clear();
+            ok &= !cache.compile(broken, bytecode, errors) && !errors.empty();
+            ok &= !cache.compile(broken, bytecode, errors) && compiler.getCompileCount() == 5;
+            const ShaderCacheStats stats = cache.getStats();
+            ok &= stats.hits == 1 && stats.misses == 5 && stats.compileErrors == 2 && stats.entries == 3;
+            ok &= cache.save();
+        }
+        {
+            ShaderCache cache;
+            ok &= cache.init(compiler, cachePath) && cache.getStats().entries == 3;
+            ok &= cache.compile(request, bytecode, errors) && compiler.getCompileCount() == 5 && cache.getStats().hits == 1;
+        }
+        std::remove(source.c_str());
+        std::remove(include.c_str());
+        std::remove(cachePath.c_str());
+        return ok;
+    }
+
+    // RenderGraph compilado sin dispositivo: una cadena de pases sin lector se elimina entera,
+    // las dependencias fijan el orden y una textura muerta presta su memoria a la siguiente
+    bool
+    checkRenderGraph() {
+        RenderGraph graph;
+        RGTextureDesc color;
+        color.width = 640;
+        color.height = 360;
+        color.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        color.bindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+        RGTextureDesc depth = color;
+        depth.format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+        depth.bindFlags = D3D11_BIND_DEPTH_STENCIL;
+        RGTextureDesc shadow = depth;
+        shadow.width = shadow.height = 1024;
+        shadow.format = DXGI_FORMAT_D32_FLOAT;
+        shadow.bindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
+        auto noExecute = [](DeviceContext&, const RenderGraphResources&) {};
+
+        RGHandle backBuffer = graph.importTexture("BackBuffer", color, nullptr);
+        RGHandle shadowMap = kInvalidRGHandle, scene = kInvalidRGHandle, sceneDepth = kInvalidRGHandle;
+        RGHandle debug = kInvalidRGHandle, debugBlur = kInvalidRGHandle, lit = kInvalidRGHandle, post = kInvalidRGHandle;
+        graph.addPass("Scene", [&](RenderGraphBuilder& builder) {
+            scene = builder.create("Scene", color);
+            sceneDepth = builder.create("SceneDepth", depth);
+        }, noExecute);
+        graph.addPass("Debug", [&](RenderGraphBuilder& builder) {
+            debug = builder.create("Debug", color);
+        }, noExecute);
+        graph.addPass("DebugBlur", [&](RenderGraphBuilder& builder) {
+            builder.read(debug);
+            debugBlur = builder.create("DebugBlur", color);
+        }, noExecute);
+        graph.addPass("Shadow", [&](RenderGraphBuilder& builder) {
+            shadowMap = builder.create("ShadowMap", shadow);
+        }, noExecute);
+        graph.addPass("Lighting", [&](RenderGraphBuilder& builder) {
+            builder.read(scene);
+            builder.read(shadowMap);
+            lit = builder.create("Lit", color);
+        }, noExecute);
+        graph.addPass("Post", [&](RenderGraphBuilder& builder) {
+            builder.read(lit);
+            post = builder.create("Post", color);
+        }, noExecute);
+        graph.addPass("Present", [&](RenderGraphBuilder& builder) {
+            builder.read(post);
+            builder.write(backBuffer);
+        }, noExecute);
+        if (!graph.compile()) {
+            return false;
+        }
+
+        const std::vector<std::string> order = graph.getExecutionOrder();
+        auto position = [&order](const char* name) {
+            return static_cast<int>(std::find(order.begin(), order.end(), name) - order.begin());
+        };
+        const int count = static_cast<int>(order.size());
+        bool ok = graph.getStats().passes == 7 && graph.getStats().passesCulled == 2 && count == 5;
+        ok &= position("Debug") == count && position("DebugBlur") == count;
+        ok &= graph.getPhysicalIndex(debug) < 0 && graph.getPhysicalIndex(debugBlur) < 0;
+        ok &= position("Scene") < position("Lighting") && position("Shadow") < position("Lighting") &&
+              position("Lighting") < position("Post") && position("Post") < position("Present");
+        // Scene muere en Lighting: Post (misma descripcin, empieza despus) reutiliza su textura,
+        // Lit no (convive con Scene en Lighting)
+        ok &= graph.getPhysicalIndex(post) == graph.getPhysicalIndex(scene) &&
+              graph.getPhysicalIndex(lit) != graph.getPhysicalIndex(scene);
+        ok &= graph.getStats().transientTextures == 5 && graph.getStats().physicalTextures == 4 &&
+              graph.getStats().bytesSaved() == color.getSizeInBytes();
+        graph.destroy();
+        return ok;
+    }
+
+    // Controlador de resolucin en lazo cerrado con una GPU sinttica (parte fija + parte
+    // proporcional a los pxeles): carga estable, pico y vuelta. En cada tramo estable la
+    // escala debe asentarse cerca del presupuesto y dejar de moverse
+    bool
+    checkResolutionController() {
+        ResolutionControllerSettings settings;
+        settings.targetMs = 16.6f;
+        ResolutionController controller;
+        controller.setSettings(settings);
+        controller.reset();
+
+        const float fixedMs = 4.0f;
+        struct Phase {
+            unsigned int frames = 0;
+            unsigned int changes = 0;       // cambios de escala en la segunda mitad
+            unsigned int reversals = 0;     // cambios de sentido en la segunda mitad
+            float filteredMs = 0.0f;
+            float scale = 0.0f;
+        };
+        auto runPhase = [&](float pixelMs, unsigned int frames) {
+            Phase phase;
+            phase.frames = frames;
+            float scale = controller.getScale();
+            float lastDirection = 0.0f;
+            for (unsigned int frame = 0; frame < frames; ++frame) {
+                const float next = controller.update(fixedMs + pixelMs * scale * scale);
+                if (next != scale && frame >= frames / 2) {
+                    const float direction = next > scale ? 1.0f : -1.0f;
+                    phase.reversals += lastDirection != 0.0f && direction != lastDirection ? 1 : 0;
+                    lastDirection = direction;
+                    ++phase.changes;
+                }
+                scale = next;
+            }
+            phase.filteredMs = controller.getStats().filteredMs;
+            phase.scale = scale;
+            return phase;
+        };
+        auto settled = [&](const Phase& phase) {
+            return fabsf(phase.filteredMs - settings.targetMs) <= settings.targetMs * 0.1f &&
+                   phase.changes <= 1 && phase.reversals == 0;
+        };
+
+        // 20 ms a escala completa: hay que bajar hasta ~0.9
+        const Phase steady = runPhase(16.0f, 300);
+        // Pico de 44 ms: baja ms sin llegar al mnimo (~0.56 cumple)
+        const Phase spike = runPhase(40.0f, 60);
+        // Vuelve la carga inicial: sube otra vez a la escala estable
+        const Phase recovery = runPhase(16.0f, 300);
+        // Con holgura de sobra vuelve a escala completa y se queda
+        const Phase idle = runPhase(4.0f, 120);
+
+        bool ok = settled(steady) && steady.scale < settings.maxScale;
+        ok &= spike.scale < steady.scale - settings.scaleStep && spike.scale > settings.minScale;
+        ok &= settled(recovery) && fabsf(recovery.scale - steady.scale) <= 2.0f * settings.scaleStep;
+        ok &= idle.scale == settings.maxScale && idle.changes == 0;
+        return ok;
+    }
+
+    // Calendario del FramePacer con ticks inventados (1 tick = 1 us, 100 fps = 10000 ticks):
+    // los retrasos cortos no mueven el calendario, los de ms de un periodo lo vuelven a anclar
+    bool
+    checkFramePacer() {
+        const long long ticksPerSecond = 1000000;
+        FramePacer pacer;
+        FramePacerSettings settings;
+        settings.targetFps = 100.0f;
+        pacer.setSettings(settings);
+        pacer.reset();
+
+        bool ok = pacer.scheduleFrame(5000, ticksPerSecond) == 5000;        // ancla
+        ok &= pacer.scheduleFrame(8000, ticksPerSecond) == 15000;           // a tiempo: espera
+        ok &= pacer.scheduleFrame(25500, ticksPerSecond) == 25000;          // tarde, sin re-anclar
+        ok &= pacer.getStats().framesMissed == 1;
+        ok &= pacer.scheduleFrame(30000, ticksPerSecond) == 35000;          // recupera el calendario
+        ok &= pacer.scheduleFrame(80000, ticksPerSecond) == 80000;          // > 1 periodo: re-ancla
+        ok &= pacer.getStats().framesMissed == 2;
+        ok &= pacer.scheduleFrame(81000, ticksPerSecond) == 90000;          // sin rfaga tras re-anclar
+        settings.targetFps = 50.0f;
+        pacer.setSettings(settings);
+        ok &= pacer.scheduleFrame(95000, ticksPerSecond) == 95000;          // otro ritmo: ancla otra vez
+        ok &= pacer.scheduleFrame(96000, ticksPerSecond) == 115000;
+        settings.targetFps = 0.0f;
+        pacer.setSettings(settings);
+        ok &= pacer.scheduleFrame(120000, ticksPerSecond) == 120000;        // sin lmite: no espera
+
+        // Estadsticas: 9 frames de 10 ms y uno de 30; la latencia negativa no cuenta
+        pacer.reset();
+        for (unsigned int i = 0; i < 9; ++i) {
+            pacer.recordFrame(10.0f, i % 3 == 0 ? 20.0f : -1.0f, 6.0f, 1.0f, 0.0f);
+        }
+        pacer.recordFrame(30.0f, 40.0f, 0.0f, 0.0f, 20.0f);
+        const FramePacerStats& stats = pacer.getStats();
+        ok &= stats.frames == 10 && fabsf(stats.frameMsAvg - 12.0f) < 1e-3f &&
+              fabsf(stats.frameMsStdDev - 6.0f) < 1e-3f && stats.frameMsWorst == 30.0f;
+        ok &= fabsf(stats.latencyMsAvg - 25.0f) < 1e-3f && stats.latencyMsWorst == 40.0f;
+        ok &= fabsf(stats.sleepMsAvg - 5.4f) < 1e-3f && fabsf(stats.lateMsAvg - 2.0f) < 1e-3f;
+        // Pasada una ventana entera, el frame lento ya no cuenta
+        for (unsigned int i = 0; i < FramePacer::kWindow; ++i) {
+            pacer.recordFrame(10.0f, -1.0f, 0.0f, 0.0f, 0.0f);
+        }
+        ok &= stats.frameMsAvg == 10.0f && stats.frameMsStdDev == 0.0f && stats.frameMsWorst == 10.0f;
+        ok &= stats.latencyMsAvg == 0.0f;
+        return ok;
+    }
+
+    // RingAllocator: bloques alineados, relleno al dar la vuelta, un frame se libera cuando
+    // se han cerrado otros framesInFlight detrs de l y un anillo lleno no entrega nada
+    bool
+    checkRingAllocator() {
+        RingAllocator ring;
+        bool ok = !ring.init(1024, 100, 3);                                  // alineacin no potencia de 2
+        ok &= ring.init(1000, 256, 3) && ring.getCapacity() == 768;          // redondea hacia abajo
+
+        ok &= ring.init(1024, 256, 3);
+        ok &= ring.allocate(1) == 0;
+        ok &= ring.allocate(300) == 256 && ring.getUsed() == 768;            // 300 -> 512 bytes
+        ring.beginFrame();                                                   // cierra el frame 0
+        for (unsigned int i = 0; i < 3; ++i) {
+            ok &= ring.getUsed() == 768;                                     // an en vuelo
+            ring.beginFrame();
+        }
+        ok &= ring.getUsed() == 0;
+
+        // Anillo lleno: ni un byte ms hasta que se retire un frame
+        ok &= ring.init(1024, 256, 1);
+        ok &= ring.allocate(512) == 0;
+        ring.beginFrame();
+        ok &= ring.allocate(256) == 512 && !ring.didWrap();
+        ring.beginFrame();                                                   // libera los 512 iniciales
+        ok &= ring.getUsed() == 256;
+        // No cabe al final: los 256 bytes que sobran cuentan como relleno del frame
+        ok &= ring.allocate(512) == 0 && ring.didWrap();
+        ok &= ring.getUsed() == 1024 && ring.getFrameBytes() == 768;
+        ok &= ring.allocate(1) == RingAllocator::kInvalidOffset;
+        ring.beginFrame();                                                   // libera slo los 256
+        ok &= ring.getUsed() == 768 && ring.allocate(512) == RingAllocator::kInvalidOffset;
+        ring.beginFrame();
+        ok &= ring.getUsed() == 0 && ring.allocate(1024) == 0;
+        ok &= ring.getHighWater() == 1024;
+        return ok;
+    }
+
+    // FreeListAllocator: liberar en desorden fusiona los vecinos hasta volver a un nico
+    // hueco, y una peticin que no cabe falla sin tocar el estado
+    bool
+    checkFreeList() {
+        FreeListAllocator list;
+        list.init(1000);
+        const unsigned int a = list.allocate(100);
+        const unsigned int b = list.allocate(200);
+        const unsigned int c = list.allocate(300);
+        const unsigned int d = list.allocate(150);
+        bool ok = a == 0 && b == 100 && c == 300 && d == 600;
+        ok &= list.getUsed() == 750 && list.getFreeBlockCount() == 1;
+
+        ok &= list.allocate(400) == FreeListAllocator::kInvalidOffset;      // el hueco libre es de 250
+        ok &= list.allocate(0) == FreeListAllocator::kInvalidOffset;
+        ok &= list.getUsed() == 750 && list.getAllocationCount() == 4;
+
+        ok &= list.free(b) && list.getFreeBlockCount() == 2;
+        ok &= list.free(d) && list.getFreeBlockCount() == 2;               // se une a la cola
+        ok &= list.getLargestFree() == 400;
+        ok &= list.allocate(150) == b && list.free(b);                       // best fit: el hueco de 200
+        ok &= list.free(a) && list.getFreeBlockCount() == 2;               // se une al hueco de b
+        ok &= !list.free(a) && !list.free(12345);                            // doble liberacin
+        ok &= list.free(c);                                                  // une los dos huecos
+        ok &= list.getFreeBlockCount() == 1 && list.getLargestFree() == 1000;
+        ok &= list.getUsed() == 0 && list.getAllocationCount() == 0 && list.getFragmentation() == 0.0f;
+        ok &= list.allocate(1000) == 0;
+        return ok;
+    }
+
+    // TextureStreamer sobre el dispositivo headless con tres caras del skybox: el nivel pedido
+    // sube uno al doblar la distancia, no se expulsa nada para una subida que no cabe y el LRU
+    // nunca expulsa una textura pedida en este frame
+    bool
+    checkTextureStreamer(Device& device) {
+        Camera camera;
+        camera.setLens(XM_PIDIV4, 16.0f / 9.0f, 0.01f, 1000.0f);
+        const XMFLOAT3 boundsMin(-1.0f, -1.0f, -1.0f);
+        const XMFLOAT3 boundsMax(1.0f, 1.0f, 1.0f);
+        const float radius = sqrtf(3.0f);
+        const float viewportHeight = 720.0f;
+
+        // computeMip mide desde el punto ms cercano de la esfera: se dobla esa distancia
+        bool ok = true;
+        float previous = 0.0f;
+        for (unsigned int i = 0; i < 4; ++i) {
+            camera.setPosition(0.0f, 0.0f, -(radius + 4.0f * static_cast<float>(1u << i)));
+            const float mip = TextureStreamer::computeMip(camera, boundsMin, boundsMax, viewportHeight, 2048, 2048);
+            ok &= i == 0 || fabsf(mip - previous - 1.0f) < 1e-3f;
+            previous = mip;
+        }
+        ok &= fabsf(TextureStreamer::computeMip(camera, boundsMin, boundsMax, viewportHeight, 1024, 1024) -
+                    (previous - 1.0f)) < 1e-3f;
+
+        TextureStreamerSettings settings;
+        settings.tailSize = 16;
+        settings.budgetBytes = ~0ull;
+        TextureStreamer streamer;
+        if (!ok || FAILED(streamer.init(device, settings))) {
+            return false;
+        }
+        StreamHandle handles[3] = { kInvalidStream, kInvalidStream, kInvalidStream };
+        for (unsigned int i = 0; i < 3; ++i) {
+            handles[i] = streamer.add(kSkyboxFaces[i], ImageImportSettings());
+            if (handles[i] == kInvalidStream) {
+                return false;
+            }
+        }
+        const StreamHandle a = handles[0], b = handles[1], c = handles[2];
+        const unsigned int tailMip = streamer.getInfo(a).tailMip;
+        if (tailMip == 0) {
+            return false;
+        }
+        camera.setPosition(0.0f, 0.0f, -(radius + 0.5f));
+        const float closeMip = TextureStreamer::computeMip(camera, boundsMin, boundsMax, viewportHeight,
+                                                           streamer.getInfo(a).width, streamer.getInfo(a).height);
+
+        // Un frame por vuelta, pidiendo @p requested, hasta que se cumpla @p done (mx. ~2 s)
+        bool aEvicted = false;
+        auto pumpUntil = [&](std::initializer_list<StreamHandle> requested, const std::function<bool()>& done) {
+            for (unsigned int frame = 0; frame < 2000; ++frame) {
+                for (StreamHandle handle : requested) {
+                    streamer.request(handle, camera, boundsMin, boundsMax, viewportHeight);
+                }
+                streamer.update();
+                aEvicted |= streamer.getInfo(a).residentMip == tailMip;
+                if (streamer.getStats().pending == 0 && done()) {
+                    return true;
+                }
+                Sleep(1);
+            }
+            return false;
+        };
+        auto setBudget = [&](unsigned long long bytes, float mipBias) {
+            settings.budgetBytes = bytes;
+            settings.mipBias = mipBias;
+            streamer.setSettings(settings);
+        };
+
+        // 1) A slo con el nivel de encima de la cola. Con el presupuesto justo, B no cabe ni
+        // expulsando A (liberara menos que el nivel ms pequeo de B): no se expulsa nada
+        setBudget(~0ull, static_cast<float>(tailMip) - 0.5f - closeMip);
+        ok &= pumpUntil({ a }, [&] { return streamer.getInfo(a).residentMip == tailMip - 1; });
+        setBudget(streamer.getStats().residentBytes, 0.0f);
+        const unsigned int missesBefore = streamer.getStats().budgetMisses;
+        for (unsigned int frame = 0; frame < 8; ++frame) {
+            streamer.request(b, camera, boundsMin, boundsMax, viewportHeight);
+            streamer.update();
+        }
+        ok &= streamer.getStats().evictions == 0 && streamer.getStats().budgetMisses > missesBefore;
+        ok &= streamer.getInfo(a).residentMip == tailMip - 1 && streamer.getInfo(b).residentMip == tailMip;
+
+        // 2) A y B enteras (A la menos reciente). Con sitio para una ms a costa de otra, pedir A y
+        // C debe expulsar B aunque A lleve ms tiempo residente
+        setBudget(~0ull, 0.0f);
+        ok &= pumpUntil({ a }, [&] { return streamer.getInfo(a).residentMip == 0; });
+        ok &= pumpUntil({ b }, [&] { return streamer.getInfo(b).residentMip == 0; });
+        setBudget(streamer.getStats().residentBytes + streamer.getInfo(c).residentBytes, 0.0f);
+        aEvicted = false;
+        ok &= pumpUntil({ a, c }, [&] { return streamer.getInfo(c).residentMip == 0; });
+        ok &= !aEvicted && streamer.getInfo(a).residentMip == 0 && streamer.getInfo(b).residentMip == tailMip;
+        ok &= streamer.getStats().evictions == 1;
+        streamer.destroy();
+        return ok;
+    }
+}
 
 HRESULT BaseApp::awake() {
     HRESULT hr = S_OK;
@@ -11,6 +458,12 @@ HRESULT BaseApp::awake() {
 }
 
 int BaseApp::run(HINSTANCE hInst, int nCmdShow) {
+    PROFILE_THREAD_NAME("Main");
+#if MONACO_PROFILING
+    if (m_traceFrames > 0) {
+        TraceCapture::getInstance().start(m_traceFrames, "Trace.json");
+    }
+#endif
     // 1) Initialize Window
     if (FAILED(m_window.init(hInst, nCmdShow, WndProc))) {
         ERROR("Main", "Run", "Failed to initialize window.");
@@ -22,7 +475,12 @@ int BaseApp::run(HINSTANCE hInst, int nCmdShow) {
         return 0;
     }
     // 3) Initialize Device and Device Context
-    if (FAILED(init())) {
+    HRESULT hr = S_OK;
+    {
+        PROFILE_SCOPE("BaseApp::init");
+        hr = init();
+    }
+    if (FAILED(hr)) {
         ERROR("Main", "Run", "Failed to initialize device and device context.");
         return 0;
     }
@@ -35,24 +493,360 @@ int BaseApp::run(HINSTANCE hInst, int nCmdShow) {
     QueryPerformanceCounter(&prev);
     while (WM_QUIT != msg.message)
     {
-        if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+        // Minimizada no hay nada que presentar: dormir hasta el siguiente mensaje
+        if (IsIconic(m_window.m_hWnd))
+        {
+            WaitMessage();
+        }
+        // Primero la espera y despus la entrada: lo que llegue mientras tanto entra en este frame
+        m_framePacer.waitForFrame(&m_deviceContext);
+        while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
         {
+            if (msg.message == WM_QUIT)
+            {
+                break;
+            }
+            if ((msg.message >= WM_KEYFIRST && msg.message <= WM_KEYLAST) ||
+                (msg.message >= WM_MOUSEFIRST && msg.message <= WM_MOUSELAST))
+            {
+                m_framePacer.markInput(msg.time);
+            }
             TranslateMessage(&msg);
             DispatchMessage(&msg);
         }
-        else
+        if (msg.message == WM_QUIT)
         {
-            LARGE_INTEGER curr;
-            QueryPerformanceCounter(&curr);
-            float deltaTime = static_cast<float>(curr.QuadPart - prev.QuadPart) / freq.QuadPart;
-            prev = curr;
-            update(deltaTime);
-            render();
+            break;
         }
+        LARGE_INTEGER curr;
+        QueryPerformanceCounter(&curr);
+        float deltaTime = static_cast<float>(curr.QuadPart - prev.QuadPart) / freq.QuadPart;
+        prev = curr;
+        PROFILE_BEGIN_FRAME(&m_deviceContext);
+        update(deltaTime);
+        render();
+        m_framePacer.framePresented(&m_deviceContext);
+        // Sin la espera del ritmo: con --fps el tiempo entre frames siempre cuadra con el presupuesto
+        m_dynamicResolution.update(m_framePacer.getFrameWorkMs());
+        PROFILE_END_FRAME(&m_deviceContext);
+        EngineStats::getInstance().endFrame(deltaTime * 1000.0);
     }
     return (int)msg.wParam;
 }
 
+int BaseApp::runHeadless(unsigned int frameCount) {
+    m_headless = true;
+    PROFILE_THREAD_NAME("Main");
+#if MONACO_PROFILING
+    if (m_traceFrames > 0) {
+        TraceCapture::getInstance().start(m_traceFrames, "Trace.json");
+    }
+#endif
+    if (FAILED(awake())) {
+        ERROR("Main", "RunHeadless", "Failed to awake application.");
+        return 1;
+    }
+    HRESULT hr = S_OK;
+    {
+        PROFILE_SCOPE("BaseApp::initHeadless");
+        hr = initHeadless();
+    }
+    if (FAILED(hr)) {
+        ERROR("Main", "RunHeadless", "Failed to initialize headless backend.");
+        return 1;
+    }
+
+    // Paso fijo para que dos corridas procesen exactamente el mismo trabajo
+    const float deltaTime = 1.0f / 60.0f;
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+
+    RenderBackendStats totals;
+    unsigned long long queueBindsRequested = 0;
+    unsigned long long queueBindsIssued = 0;
+    unsigned long long queuePackets = 0;
+    unsigned long long queueBytesMapped = 0;
+    DeviceContextStats contextTotals;
+    unsigned long long commandLists = 0;
+    unsigned long long shadowStaticRendered = 0;
+    unsigned long long shadowStaticReused = 0;
+    unsigned long long shadowDraws = 0;
+    unsigned long long shadowCastersCulled = 0;
+    unsigned long long clusterVisibleLights = 0;
+    unsigned long long clusterLightIndices = 0;
+    double clusterAssignMs = 0.0;
+    double resolutionScaleSum = 0.0;
+    float resolutionScaleMin = 1.0f;
+    double totalMs = 0.0;
+    double worstMs = 0.0;
+    for (unsigned int frame = 0; frame < frameCount; ++frame) {
+        m_renderBackend->beginFrame();
+        m_renderBackend->resetStats();
+
+        // Con --fps el ritmo es real; la entrada sinttica de cada frame mide entrada-fin de frame
+        m_framePacer.waitForFrame(nullptr);
+        m_framePacer.markInput();
+
+        LARGE_INTEGER begin, end;
+        QueryPerformanceCounter(&begin);
+        PROFILE_BEGIN_FRAME(&m_deviceContext);
+        update(deltaTime);
+        render();
+        PROFILE_END_FRAME(&m_deviceContext);
+        QueryPerformanceCounter(&end);
+        m_framePacer.framePresented(nullptr);
+
+        double frameMs = 1000.0 * (end.QuadPart - begin.QuadPart) / freq.QuadPart;
+        EngineStats::getInstance().endFrame(frameMs);
+        // La escala de este frame ya se us; la nueva vale para el siguiente
+        const float resolutionScale = m_dynamicResolution.getScale();
+        resolutionScaleSum += resolutionScale;
+        resolutionScaleMin = resolutionScale < resolutionScaleMin ? resolutionScale : resolutionScaleMin;
+        m_dynamicResolution.update(static_cast<float>(frameMs));
+        totalMs += frameMs;
+        worstMs = frameMs > worstMs ? frameMs : worstMs;
+        m_renderBackend->collectConcurrentStats();
+        totals.accumulate(m_renderBackend->getStats());
+        queueBindsRequested += m_renderQueue.getStats().bindsRequested;
+        queueBindsIssued += m_renderQueue.getStats().bindsIssued;
+        queuePackets += m_renderQueue.getStats().packets;
+        queueBytesMapped += m_renderQueue.getStats().bytesMapped;
+        contextTotals.stateCallsIssued += m_deviceContext.getStateStats().stateCallsIssued;
+        contextTotals.stateCallsFiltered += m_deviceContext.getStateStats().stateCallsFiltered;
+        commandLists += m_commandRecorder.getStats().commandLists;
+        shadowStaticRendered += m_shadows.getStats().staticCascadesRendered;
+        shadowStaticReused += m_shadows.getStats().staticCascadesReused;
+        shadowDraws += m_shadows.getStats().drawCalls;
+        shadowCastersCulled += m_shadows.getStats().castersCulled;
+        clusterVisibleLights += m_clusteredLights.getStats().visibleLights;
+        clusterLightIndices += m_clusteredLights.getStats().lightIndices;
+        clusterAssignMs += m_clusteredLights.getStats().assignMs;
+    }
+
+    // Reparto aislado con 1k y 10k luces desde la misma cmara: con el pool y en serie
+    const unsigned int assignRuns = 50;
+    ThreadPool serialPool;
+    std::vector<Light> sceneLights = m_clusteredLights.getLights();
+    auto measureAssign = [&](unsigned int lightCount, ThreadPool& pool) {
+        std::vector<Light> lights;
+        makeDemoLights(lightCount, lights);
+        m_clusteredLights.setLights(lights);
+        double ms = 0.0;
+        for (unsigned int i = 0; i < assignRuns; ++i) {
+            m_clusteredLights.assign(m_camera, pool);
+            ms += m_clusteredLights.getStats().assignMs;
+        }
+        return ms / assignRuns;
+    };
+    const double assign1k = measureAssign(1000, m_threadPool);
+    const double assign1kSerial = measureAssign(1000, serialPool);
+    const double assign10k = measureAssign(10000, m_threadPool);
+    const unsigned int indices10k = m_clusteredLights.getStats().lightIndices;
+    const double assign10kSerial = measureAssign(10000, serialPool);
+    m_clusteredLights.setLights(sceneLights);
+
+    // Cadena de mips de una imagen sinttica de 2048x2048 (la demo no carga PNG/JPG)
+    const unsigned int mipSize = 2048;
+    std::vector<unsigned char> mipImage(static_cast<size_t>(mipSize) * mipSize * 4);
+    for (size_t i = 0; i < mipImage.size(); ++i) {
+        mipImage[i] = static_cast<unsigned char>((i * 2654435761u) >> 24);
+    }
+    auto measureMips = [&](MipFilter filter, ThreadPool* pool) {
+        MipSettings mipSettings;
+        mipSettings.filter = filter;
+        mipSettings.threadPool = pool;
+        MipChain chain;
+        MipStats mipStats;
+        MipGenerator::generate(mipImage.data(), mipSize, mipSize, mipSettings, chain, &mipStats);
+        return mipStats.megapixelsPerSecond();
+    };
+    const double mipBoxMps = measureMips(MipFilter::Box, nullptr);
+    const double mipKaiserMps = measureMips(MipFilter::Kaiser, nullptr);
+    const double mipKaiserThreadedMps = measureMips(MipFilter::Kaiser, &m_threadPool);
+
+    // Caras del skybox (con mips) decodificadas en serie y con el pool, y servidas desde la
+    // cach de imgenes (initScene ya dej sus blobs en disco)
+    CubemapFaces cubemapFaces;
+    const double cubemapSerialMs = SUCCEEDED(Texture::decodeCubemapFaces(kSkyboxFaces, true, nullptr, cubemapFaces, false))
+        ? cubemapFaces.decodeMs : 0.0;
+    const double cubemapMs = SUCCEEDED(Texture::decodeCubemapFaces(kSkyboxFaces, true, &m_threadPool, cubemapFaces, false))
+        ? cubemapFaces.decodeMs : 0.0;
+    const double cubemapCachedMs = SUCCEEDED(Texture::decodeCubemapFaces(kSkyboxFaces, true, &m_threadPool, cubemapFaces))
+        ? cubemapFaces.decodeMs : 0.0;
+    const ImageCacheStats imageCache = ImageImporter::getTotals();
+    const TextureStreamerStats& streamStats = m_textureStreamer.getStats();
+
+    // Compresin BCn de una imagen suave de 1024x1024 (el ruido de arriba no dice nada del PSNR)
+    const unsigned int bcSize = 1024;
+    std::vector<unsigned char> bcImage(static_cast<size_t>(bcSize) * bcSize * 4);
+    for (unsigned int y = 0; y < bcSize; ++y) {
+        for (unsigned int x = 0; x < bcSize; ++x) {
+            unsigned char* pixel = &bcImage[(static_cast<size_t>(y) * bcSize + x) * 4];
+            pixel[0] = static_cast<unsigned char>(127.5f + 127.5f * sinf(x * 0.02f) * cosf(y * 0.03f));
+            pixel[1] = static_cast<unsigned char>(x * 255 / bcSize);
+            pixel[2] = static_cast<unsigned char>((x ^ y) & 0xFF);
+            pixel[3] = static_cast<unsigned char>(y * 255 / bcSize);
+        }
+    }
+    std::ostringstream bcReport;
+    std::vector<unsigned char> bcBlocks;
+    const BcFormat bcFormats[] = { BcFormat::BC1, BcFormat::BC3, BcFormat::BC4, BcFormat::BC5, BcFormat::BC7 };
+    for (BcFormat format : bcFormats) {
+        BcSettings bcSettings;
+        bcSettings.format = format;
+        bcBlocks.resize(static_cast<size_t>(bcSize / 4) * (bcSize / 4) * BlockCompressor::getBlockBytes(format));
+        BcStats serialStats, threadedStats;
+        BlockCompressor::compress(bcImage.data(), bcSize, bcSize, bcSettings, bcBlocks.data(), &serialStats);
+        bcSettings.threadPool = &m_threadPool;
+        BlockCompressor::compress(bcImage.data(), bcSize, bcSize, bcSettings, bcBlocks.data(), &threadedStats);
+        std::string name = BlockCompressor::getName(format);
+        for (char& c : name) {
+            c = static_cast<char>(tolower(c));
+        }
+        bcReport << name << "_mps=" << threadedStats.megapixelsPerSecond() << "\n"
+                 << name << "_serial_mps=" << serialStats.megapixelsPerSecond() << "\n"
+                 << name << "_psnr=" << BlockCompressor::computePsnr(bcImage.data(), bcBlocks.data(), bcSize, bcSize, format) << "\n";
+    }
+
+    // Comprobaciones de los subsistemas con entradas sintticas; cada una deja check_<nombre>=0/1
+    std::ostringstream checkReport;
+    unsigned int checksFailed = 0;
+    auto runCheck = [&](const char* name, bool passed) {
+        checkReport << "check_" << name << "=" << (passed ? 1 : 0) << "\n";
+        if (!passed) {
+            ++checksFailed;
+            ERROR("Main", "RunHeadless", (std::string("Headless check failed: ") + name).c_str());
+        }
+    };
+    runCheck("shader_cache", checkShaderCache());
+    runCheck("render_graph", checkRenderGraph());
+    runCheck("resolution_controller", checkResolutionController());
+    runCheck("frame_pacer", checkFramePacer());
+    runCheck("ring_allocator", checkRingAllocator());
+    runCheck("free_list", checkFreeList());
+    runCheck("texture_streamer", checkTextureStreamer(m_device));
+
+    double frames = frameCount > 0 ? static_cast<double>(frameCount) : 1.0;
+    const PipelineStateCacheStats& stateStats = PipelineStateCache::getInstance().getStats();
+    const ShaderCacheStats shaderStats = m_shaderCache.getStats();
+    std::ostringstream report;
+    report << "backend=" << m_renderBackend->getName() << "\n"
+           << "frames=" << frameCount << "\n"
+           << "render_contexts=" << m_commandRecorder.getMaxRanges() << "\n"
+           << "static_meshes_merged=" << m_staticBatcher.getStats().submeshes << "\n"
+           << "static_pages=" << m_staticBatcher.getStats().pages << "\n"
+           << "pipelines=" << stateStats.pipelines << "\n"
+           << "state_objects=" << stateStats.samplerStates + stateStats.blendStates +
+                                  stateStats.rasterizerStates + stateStats.depthStencilStates << "\n"
+           << "state_cache_hits=" << stateStats.stateHits << "\n"
+           << "shader_cache_hits=" << shaderStats.hits << "\n"
+           << "shader_cache_misses=" << shaderStats.misses << "\n"
+           << "shader_compile_ms=" << shaderStats.compileMs << "\n"
+           << "shader_variants_compiled=" << m_shaderInstanced.getStats().compiles << "\n"
+           << "shader_variant_compile_ms=" << m_shaderInstanced.getStats().compileMs << "\n"
+           << "render_graph_passes=" << m_renderGraph.getStats().passes << "\n"
+           << "render_graph_passes_culled=" << m_renderGraph.getStats().passesCulled << "\n"
+           << "render_graph_transient_bytes=" << m_renderGraph.getStats().transientBytes << "\n"
+           << "render_graph_bytes_saved=" << m_renderGraph.getStats().bytesSaved() << "\n"
+           << "render_graph_textures_created=" << m_renderGraph.getStats().texturesCreated << "\n"
+           << "shadow_cascades=" << m_shadows.getCascadeCount() << "\n"
+           << "shadow_static_cascades_rendered=" << shadowStaticRendered << "\n"
+           << "shadow_static_cascades_reused=" << shadowStaticReused << "\n"
+           << "shadow_draws_per_frame=" << shadowDraws / frames << "\n"
+           << "shadow_casters_culled_per_frame=" << shadowCastersCulled / frames << "\n"
+           << "cluster_lights=" << m_clusteredLights.getLights().size() << "\n"
+           << "cluster_visible_lights_per_frame=" << clusterVisibleLights / frames << "\n"
+           << "cluster_light_indices_per_frame=" << clusterLightIndices / frames << "\n"
+           << "cluster_assign_ms_avg=" << clusterAssignMs / frames << "\n"
+           << "cluster_assign_1k_ms=" << assign1k << "\n"
+           << "cluster_assign_1k_serial_ms=" << assign1kSerial << "\n"
+           << "cluster_assign_10k_ms=" << assign10k << "\n"
+           << "cluster_assign_10k_serial_ms=" << assign10kSerial << "\n"
+           << "cluster_light_indices_10k=" << indices10k << "\n"
+           << "mip_levels_2048=" << MipGenerator::getLevelCount(mipSize, mipSize) << "\n"
+           << "mip_box_mps=" << mipBoxMps << "\n"
+           << "mip_kaiser_mps=" << mipKaiserMps << "\n"
+           << "mip_kaiser_threaded_mps=" << mipKaiserThreadedMps << "\n"
+           << "mip_threads=" << m_threadPool.getConcurrency() << "\n"
+           << bcReport.str()
+           << "cubemap_decode_ms=" << cubemapMs << "\n"
+           << "cubemap_decode_serial_ms=" << cubemapSerialMs << "\n"
+           << "cubemap_decode_speedup=" << (cubemapMs > 0.0 ? cubemapSerialMs / cubemapMs : 0.0) << "\n"
+           << "cubemap_cached_ms=" << cubemapCachedMs << "\n"
+           << "cubemap_cache_speedup=" << (cubemapCachedMs > 0.0 ? cubemapMs / cubemapCachedMs : 0.0) << "\n"
+           << "image_cache_hits=" << imageCache.hits << "\n"
+           << "image_cache_misses=" << imageCache.misses << "\n"
+           << "image_cache_mapped_bytes=" << imageCache.mappedBytes << "\n"
+           << "image_cache_write_errors=" << imageCache.writeErrors << "\n"
+           << "stream_textures=" << streamStats.textures << "\n"
+           << "stream_budget_bytes=" << m_textureStreamer.getSettings().budgetBytes << "\n"
+           << "stream_resident_bytes=" << streamStats.residentBytes << "\n"
+           << "stream_wanted_bytes=" << streamStats.wantedBytes << "\n"
+           << "stream_satisfied=" << streamStats.satisfied << "\n"
+           << "stream_uploads=" << streamStats.uploads << "\n"
+           << "stream_upload_bytes=" << streamStats.bytesUploaded << "\n"
+           << "stream_upload_ms=" << streamStats.uploadMs << "\n"
+           << "stream_evictions=" << streamStats.evictions << "\n"
+           << "stream_budget_misses=" << streamStats.budgetMisses << "\n"
+           << "profiler=" << MONACO_PROFILING << "\n"
+           << "profiler_cpu_scopes_per_frame=" << Profiler::getInstance().getStats().cpuScopes / frames << "\n"
+           << "profiler_gpu_scopes_per_frame=" << Profiler::getInstance().getStats().gpuScopes / frames << "\n"
+           << "profiler_scope_cost_us=" << Profiler::getInstance().getStats().scopeCostUs << "\n"
+           << "profiler_overhead_pct=" << (totalMs > 0.0 ? 100.0 * Profiler::getInstance().getStats().overheadMs / totalMs : 0.0) << "\n"
+           << "profiler_gpu_frames_resolved=" << Profiler::getInstance().getStats().gpuFramesResolved << "\n"
+           << "profiler_gpu_frames_disjoint=" << Profiler::getInstance().getStats().gpuFramesDisjoint << "\n"
+           << "dynamic_resolution=" << (m_dynamicResolution.isEnabled() ? 1 : 0) << "\n"
+           << "dynamic_resolution_target_ms=" << m_dynamicResolution.getController().getSettings().targetMs << "\n"
+           << "dynamic_resolution_scale_avg=" << resolutionScaleSum / frames << "\n"
+           << "dynamic_resolution_scale_min=" << resolutionScaleMin << "\n"
+           << "dynamic_resolution_scale_changes=" << m_dynamicResolution.getController().getStats().scaleChanges << "\n"
+           << "dynamic_resolution_frames_over_budget=" << m_dynamicResolution.getController().getStats().framesOverBudget << "\n"
+           << "mesh_pool_meshes=" << m_meshPool.getStats().meshes << "\n"
+           << "mesh_pool_vertices=" << m_meshPool.getStats().verticesUsed << "/" << m_meshPool.getStats().vertexCapacity << "\n"
+           << "mesh_pool_indices=" << m_meshPool.getStats().indicesUsed << "/" << m_meshPool.getStats().indexCapacity << "\n"
+           << "mesh_pool_fragmentation=" << m_meshPool.getStats().vertexFragmentation << "\n"
+           << "command_lists_per_frame=" << commandLists / frames << "\n"
+           << "pacing_target_fps=" << m_framePacer.getSettings().targetFps << "\n"
+           << "pacing_frame_ms_avg=" << m_framePacer.getStats().frameMsAvg << "\n"
+           << "pacing_frame_ms_stddev=" << m_framePacer.getStats().frameMsStdDev << "\n"
+           << "pacing_frame_ms_worst=" << m_framePacer.getStats().frameMsWorst << "\n"
+           << "pacing_frames_missed=" << m_framePacer.getStats().framesMissed << "\n"
+           << "pacing_sleep_ms_avg=" << m_framePacer.getStats().sleepMsAvg << "\n"
+           << "pacing_spin_ms_avg=" << m_framePacer.getStats().spinMsAvg << "\n"
+           << "pacing_wake_late_ms_avg=" << m_framePacer.getStats().lateMsAvg << "\n"
+           << "pacing_input_latency_ms_avg=" << m_framePacer.getStats().latencyMsAvg << "\n"
+           << "sim_step_hz=" << 1.0f / m_fixedStep.getStepSeconds() << "\n"
+           << "sim_steps=" << m_fixedStep.getStats().steps << "\n"
+           << "sim_frames_clamped=" << m_fixedStep.getStats().framesClamped << "\n"
+           << "cpu_ms_avg=" << totalMs / frames << "\n"
+           << "cpu_ms_worst=" << worstMs << "\n"
+           << "packets_per_frame=" << queuePackets / frames << "\n"
+           << "draws_per_frame=" << totals.drawCalls / frames << "\n"
+           << "instanced_draws_per_frame=" << totals.instancedDrawCalls / frames << "\n"
+           << "instances_per_frame=" << totals.instancesSubmitted / frames << "\n"
+           << "indices_per_frame=" << totals.indicesSubmitted / frames << "\n"
+           << "bytes_uploaded_per_frame=" << totals.bytesUploaded / frames << "\n"
+           << "bytes_mapped_per_frame=" << queueBytesMapped / frames << "\n"
+           << "maps_per_frame=" << totals.maps / frames << "\n"
+           << "state_changes_per_frame=" << totals.stateChanges / frames << "\n"
+           << "state_calls_filtered_per_frame=" << contextTotals.stateCallsFiltered / frames << "\n"
+           << "redundant_binds_per_frame=" << totals.redundantStateChanges / frames << "\n"
+           << "queue_binds_naive_per_frame=" << queueBindsRequested / frames << "\n"
+           << "queue_binds_issued_per_frame=" << queueBindsIssued / frames << "\n"
+           << "validation_errors=" << totals.validationErrors << "\n"
+           << checkReport.str()
+           << "checks_failed=" << checksFailed << "\n";
+
+    std::ofstream file("HeadlessBenchmark.txt");
+    file << report.str();
+    MESSAGE("Main", "RunHeadless", report.str().c_str());
+
+    if (totals.validationErrors > 0) {
+        return 2;
+    }
+    return checksFailed == 0 ? 0 : 3;
+}
+
 HRESULT BaseApp::init() {
     HRESULT hr = S_OK;
     // Crear swapchain
@@ -61,64 +855,147 @@ HRESULT BaseApp::init() {
         ERROR("Main", "InitDevice", ("Failed to initialize SwapChain. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
+    // Enlazar el backend D3D11 al dispositivo creado por la swapchain
+    auto backend = std::make_unique<D3D11RenderBackend>();
+    hr = backend->init(m_device, m_deviceContext);
+    if (FAILED(hr)) {
+        ERROR("Main", "InitDevice", ("Failed to initialize RenderBackend. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
+    m_renderBackend = std::move(backend);
+    m_device.setBackend(m_renderBackend.get());
+    m_deviceContext.setBackend(m_renderBackend.get());
     // Crear render target view
     hr = m_renderTargetView.init(m_device, m_backBuffer, DXGI_FORMAT_R8G8B8A8_UNORM);
     if (FAILED(hr)) {
         ERROR("Main", "InitDevice", ("Failed to initialize RenderTargetView. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
-    // FIX IMPORTANTE: Depth Stencil con quality correcta (no 0)
-    UINT sampleCount = 4;
+    return initScene();
+}
+
+HRESULT BaseApp::initHeadless() {
+    HRESULT hr = S_OK;
+    // Sin ventana: mismas dimensiones que Window::init para que el trabajo sea comparable
+    m_window.m_width = 1200;
+    m_window.m_height = 950;
+
+    auto backend = std::make_unique<NullRenderBackend>();
+    hr = backend->init(m_device, m_deviceContext);
+    if (FAILED(hr)) {
+        ERROR("Main", "InitHeadless", ("Failed to initialize NullRenderBackend. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
+    m_renderBackend = std::move(backend);
+    m_device.setBackend(m_renderBackend.get());
+    m_deviceContext.setBackend(m_renderBackend.get());
+
+    // Render target fuera de pantalla en lugar del back buffer de la swapchain
     UINT quality = 0;
-    m_device.m_device->CheckMultisampleQualityLevels(DXGI_FORMAT_D24_UNORM_S8_UINT, sampleCount, &quality);
-    if (quality > 0) quality = quality - 1; // El mximo -1
-    hr = m_depthStencil.init(m_device,
-                             m_window.m_width,
-                             m_window.m_height,
-                             DXGI_FORMAT_D24_UNORM_S8_UINT,
-                             D3D11_BIND_DEPTH_STENCIL,
-                             sampleCount,
-                             quality);
+    m_device.CheckMultisampleQualityLevels(DXGI_FORMAT_R8G8B8A8_UNORM, 4, &quality);
+    hr = m_backBuffer.init(m_device,
+                           m_window.m_width,
+                           m_window.m_height,
+                           DXGI_FORMAT_R8G8B8A8_UNORM,
+                           D3D11_BIND_RENDER_TARGET,
+                           4,
+                           quality > 0 ? quality - 1 : 0);
     if (FAILED(hr)) {
-        ERROR("Main", "InitDevice", ("Failed to initialize DepthStencil. HRESULT: " + std::to_string(hr)).c_str());
+        ERROR("Main", "InitHeadless", ("Failed to initialize offscreen target. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
-    hr = m_depthStencilView.init(m_device, m_depthStencil, DXGI_FORMAT_D24_UNORM_S8_UINT);
+    hr = m_renderTargetView.init(m_device, m_backBuffer, DXGI_FORMAT_R8G8B8A8_UNORM);
+    if (FAILED(hr)) {
+        ERROR("Main", "InitHeadless", ("Failed to initialize RenderTargetView. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
+    return initScene();
+}
+
+HRESULT BaseApp::initScene() {
+    HRESULT hr = S_OK;
+    // Estados compartidos: antes de crear actores (cada uno pide su sampler a la cach)
+    hr = PipelineStateCache::getInstance().init(m_device);
     if (FAILED(hr)) {
-        ERROR("Main", "InitDevice", ("Failed to initialize DepthStencilView. HRESULT: " + std::to_string(hr)).c_str());
+        ERROR("Main", "InitDevice", ("Failed to initialize PipelineStateCache. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
+#if MONACO_PROFILING
+    // Si no hay consultas de timestamp el profiler slo mide la CPU
+    Profiler::getInstance().init(&m_device);
+#endif
+    // Sin swapchain (headless) slo se limita el ritmo: no hay GPU a la que esperar
+    m_framePacer.init(m_headless ? nullptr : &m_device);
+    // FIX IMPORTANTE: Depth Stencil con quality correcta (no 0)
+    UINT sampleCount = 4;
+    UINT quality = 0;
+    m_device.CheckMultisampleQualityLevels(DXGI_FORMAT_D24_UNORM_S8_UINT, sampleCount, &quality);
+    if (quality > 0) quality = quality - 1; // El mximo -1
+    // La textura la crea el grafo la primera vez que un frame la pide
+    m_sceneDepthDesc.width = m_window.m_width;
+    m_sceneDepthDesc.height = m_window.m_height;
+    m_sceneDepthDesc.format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    m_sceneDepthDesc.bindFlags = D3D11_BIND_DEPTH_STENCIL;
+    m_sceneDepthDesc.sampleCount = sampleCount;
+    m_sceneDepthDesc.sampleQuality = quality;
     // Crear el viewport
-    hr = m_viewport.init(m_window);
+    hr = m_viewport.init(m_window.m_width, m_window.m_height);
     if (FAILED(hr)) {
         ERROR("Main", "InitDevice", ("Failed to initialize Viewport. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
+    // Pool de hilos para la carga del skybox y la grabacin paralela de la cola; con un hilo, en serie
+    if (m_renderThreads != 1) {
+        m_threadPool.init(m_renderThreads > 1 ? m_renderThreads - 1 : 0);
+    }
     // Load skybox
-    std::array<std::string, 6> faces = {
-        "Skybox/cubemap_0.png",
-        "Skybox/cubemap_1.png",
-        "Skybox/cubemap_2.png",
-        "Skybox/cubemap_3.png",
-        "Skybox/cubemap_4.png",
-        "Skybox/cubemap_5.png"
-    };
-    m_skyboxTex.CreateCubemap(m_device, m_deviceContext, faces, true);
+    m_skyboxTex.CreateCubemap(m_device, kSkyboxFaces, true, &m_threadPool);
+    // Streaming de texturas: al arrancar slo se sube la cola de mips de cada una
+    hr = m_textureStreamer.init(m_device, m_textureStreamer.getSettings());
+    if (FAILED(hr)) {
+        ERROR("Main", "InitDevice", ("Texture streaming disabled. HRESULT: " + std::to_string(hr)).c_str());
+    }
+    // Pool de geometra: crece solo si la escena no cabe
+    hr = m_meshPool.init(m_device, 65536, 196608);
+    if (FAILED(hr)) {
+        ERROR("Main", "InitDevice", ("Failed to initialize MeshPool, actors use their own buffers. HRESULT: " + std::to_string(hr)).c_str());
+    }
     // Set Espada Actor
     m_Espada = EU::MakeShared<Actor>(m_device);
     if (!m_Espada.isNull()) {
         std::vector<MeshComponent> EspadaMeshes;
-        m_model = new Model3D("Assets/AnyConv.com__Espada.fbx", ModelType::FBX);
+        {
+            PROFILE_SCOPE("Model3D::load");
+            m_model = new Model3D("Assets/AnyConv.com__Espada.fbx", ModelType::FBX);
+        }
         EspadaMeshes = m_model->GetMeshes();
         std::vector<Texture> EspadaTextures;
-        hr = m_EspadaAlbedo.init(m_device, "Assets/basecolor", ExtensionType::DDS);
-        if (FAILED(hr)) {
-            ERROR("Main", "InitDevice", ("Failed to initialize EspadaAlbedo. HRESULT: " + std::to_string(hr)).c_str());
-            return hr;
+        // Con el PNG original el albedo va por streaming; si no, el DDS completo
+        StreamHandle albedoStream = kInvalidStream;
+        if (GetFileAttributesA("Assets/basecolor.png") != INVALID_FILE_ATTRIBUTES) {
+            ImageImportSettings albedoSettings;
+            albedoSettings.compression = BcFormat::BC1;
+            albedoSettings.threadPool = &m_threadPool;
+            albedoStream = m_textureStreamer.add("Assets/basecolor.png", albedoSettings);
+        }
+        if (albedoStream == kInvalidStream) {
+            hr = m_EspadaAlbedo.init(m_device, "Assets/basecolor", ExtensionType::DDS);
+            if (FAILED(hr)) {
+                ERROR("Main", "InitDevice", ("Failed to initialize EspadaAlbedo. HRESULT: " + std::to_string(hr)).c_str());
+                return hr;
+            }
+            EspadaTextures.push_back(m_EspadaAlbedo);
+        }
+        if (m_meshPool.getVertexBuffer()) {
+            m_Espada->setMesh(m_device, m_deviceContext, m_meshPool, EspadaMeshes);
+        }
+        else {
+            m_Espada->setMesh(m_device, EspadaMeshes);
         }
-        EspadaTextures.push_back(m_EspadaAlbedo);
-        m_Espada->setMesh(m_device, EspadaMeshes);
         m_Espada->setTextures(EspadaTextures);
+        if (albedoStream != kInvalidStream) {
+            m_Espada->setTextureStream(&m_textureStreamer, albedoStream);
+        }
         m_Espada->setName("Espada");
         m_actors.push_back(m_Espada);
         m_Espada->getComponent<Transform>()->setTransform(
@@ -131,10 +1008,35 @@ HRESULT BaseApp::init() {
         ERROR("Main", "InitDevice", "Failed to create Espada Actor.");
         return E_FAIL;
     }
+    // Copias de la espada: misma geometra y textura, slo cambia el transform
+    for (unsigned int i = 1; i < m_crowdSize; ++i) {
+        EU::TSharedPointer<Actor> copy = EU::MakeShared<Actor>(m_device);
+        copy->shareMesh(*m_Espada);
+        // Cada Actor libera su textura en destroy()
+        if (m_EspadaAlbedo.m_textureFromImg) m_EspadaAlbedo.m_textureFromImg->AddRef();
+        copy->setTextures({ m_EspadaAlbedo });
+        copy->setTextureStream(m_Espada->getTextureStreamer(), m_Espada->getTextureStream());
+        copy->setName("Espada_" + std::to_string(i));
+        copy->setStatic(m_staticCrowd);
+        float x = -6.0f + 1.5f * static_cast<float>(i % 9);
+        float z = 11.60f + 2.0f * static_cast<float>(i / 9);
+        copy->getComponent<Transform>()->setTransform(
+            EU::Vector3(x, -4.90f, z),
+            EU::Vector3(-0.60f, 3.0f, -0.20f),
+            EU::Vector3(1.0f, 1.0f, 1.0f)
+        );
+        m_actors.push_back(copy);
+    }
     // Store the Actors in the Scene Graph
     for (auto& actor : m_actors) {
         m_sceneGraph.addEntity(actor.get());
     }
+    // Los actores estticos se dibujan desde pginas compartidas ya en espacio de mundo
+    hr = m_staticBatcher.build(m_device, m_actors);
+    if (FAILED(hr)) {
+        // No es fatal: cada actor sigue emitiendo sus propios paquetes
+        ERROR("Main", "InitDevice", ("Static batching disabled. HRESULT: " + std::to_string(hr)).c_str());
+    }
     // Input layout
     std::vector<D3D11_INPUT_ELEMENT_DESC> Layout;
     D3D11_INPUT_ELEMENT_DESC position = {};
@@ -155,11 +1057,101 @@ HRESULT BaseApp::init() {
     texcoord.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
     texcoord.InstanceDataStepRate = 0;
     Layout.push_back(texcoord);
+    // Bytecode de ejecuciones anteriores; un archivo corrupto slo obliga a recompilar
+    if (!m_shaderCache.init(m_shaderCompiler, "ShaderCache.bin")) {
+        ERROR("Main", "InitDevice", "Shader cache file is invalid; shaders will be recompiled.");
+    }
+    m_shaderProgram.setShaderCache(&m_shaderCache);
     hr = m_shaderProgram.init(m_device, "MonacoEngine3.fx", Layout);
     if (FAILED(hr)) {
         ERROR("Main", "InitDevice", ("Failed to initialize ShaderProgram. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
+    m_renderQueue.setDefaultShader(m_shaderProgram);
+    // El anillo no tiene fence: retiene tantos frames como la CPU puede adelantarse, ms el actual
+    hr = m_constantRing.init(m_device, m_deviceContext, kConstantRingCapacity,
+                             m_framePacer.getSettings().maxFrameLatency + 1);
+    if (FAILED(hr)) {
+        ERROR("Main", "InitDevice", ("Failed to initialize ConstantBufferRing. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
+    m_renderQueue.setConstantRing(&m_constantRing);
+    // Variante instanciada: mismo vrtice en slot 0, mundo (4 filas) y color en slot 1
+    std::vector<D3D11_INPUT_ELEMENT_DESC> instancedLayout = Layout;
+    for (unsigned int row = 0; row < 4; ++row) {
+        D3D11_INPUT_ELEMENT_DESC world = {};
+        world.SemanticName = "WORLD";
+        world.SemanticIndex = row;
+        world.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        world.InputSlot = 1;
+        world.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+        world.InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+        world.InstanceDataStepRate = 1;
+        instancedLayout.push_back(world);
+    }
+    D3D11_INPUT_ELEMENT_DESC color = {};
+    color.SemanticName = "COLOR";
+    color.SemanticIndex = 0;
+    color.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    color.InputSlot = 1;
+    color.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+    color.InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+    color.InstanceDataStepRate = 1;
+    instancedLayout.push_back(color);
+    hr = m_shaderInstanced.init(m_device, m_shaderCache, "MonacoEngine3_Instanced.fx",
+                                instancedLayout, { "SHOW_INSTANCE_COLOR", "RECEIVE_SHADOWS", "CLUSTERED_LIGHTS" });
+    if (SUCCEEDED(hr)) {
+        hr = m_renderQueue.init(m_device);
+    }
+    if (SUCCEEDED(hr)) {
+        m_instancedVariant = &m_shaderInstanced.getVariant(m_device, 0);
+        m_renderQueue.setInstancedShader(*m_instancedVariant);
+    }
+    else {
+        // No es fatal: la cola dibuja cada paquete por separado
+        ERROR("Main", "InitDevice", ("Instancing disabled. HRESULT: " + std::to_string(hr)).c_str());
+    }
+    // Sombras en cascada; sin ellas la escena se dibuja igual, sin receptor de sombra
+    hr = m_shadows.init(m_device, m_shaderCache, Layout, instancedLayout);
+    if (SUCCEEDED(hr)) {
+        m_shadows.setConstantRing(&m_constantRing);
+        m_shadowsEnabled = true;
+        m_instancedKeywords |= m_shaderInstanced.getKeywordMask("RECEIVE_SHADOWS");
+    }
+    else {
+        ERROR("Main", "InitDevice", ("Shadows disabled. HRESULT: " + std::to_string(hr)).c_str());
+    }
+    // Luces dinmicas por clusters; sin ellas el shader instanciado no las suma
+    hr = m_clusteredLights.init(m_device, m_window.m_width, m_window.m_height);
+    if (SUCCEEDED(hr)) {
+        std::vector<Light> lights;
+        makeDemoLights(m_lightCount, lights);
+        m_clusteredLights.setLights(lights);
+        m_lightsEnabled = m_lightCount > 0;
+        if (m_lightsEnabled) {
+            m_instancedKeywords |= m_shaderInstanced.getKeywordMask("CLUSTERED_LIGHTS");
+        }
+    }
+    else {
+        ERROR("Main", "InitDevice", ("Clustered lighting disabled. HRESULT: " + std::to_string(hr)).c_str());
+    }
+    // Resolucin dinmica; sin ella la escena se dibuja directamente en el back buffer
+    hr = m_dynamicResolution.init(m_device, m_shaderCache, Layout, m_window.m_width, m_window.m_height);
+    if (FAILED(hr)) {
+        m_dynamicResolution.setEnabled(false);
+        ERROR("Main", "InitDevice", ("Dynamic resolution disabled. HRESULT: " + std::to_string(hr)).c_str());
+    }
+    if (!m_shaderCache.save()) {
+        ERROR("Main", "InitDevice", "Failed to write ShaderCache.bin.");
+    }
+    MESSAGE("Main", "InitDevice", ("Shader cache: " + m_shaderCache.getReport()).c_str());
+    MESSAGE("Main", "InitDevice", ("Image cache: " + ImageImporter::getReport()).c_str());
+    // Grabacin paralela de la cola; con un hilo (o sin contextos diferidos) se graba en serie
+    hr = m_commandRecorder.init(m_deviceContext, m_threadPool, m_renderThreads);
+    if (FAILED(hr)) {
+        ERROR("Main", "InitDevice", ("Failed to initialize ParallelCommandRecorder. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
     // Constant buffers
     hr = m_cbNeverChanges.init(m_device, sizeof(CBNeverChanges));
     if (FAILED(hr)) return hr;
@@ -173,6 +1165,41 @@ HRESULT BaseApp::init() {
     return S_OK;
 }
 
+void BaseApp::setFrameBudget(float ms) {
+    if (ms <= 0.0f) {
+        m_dynamicResolution.setEnabled(false);
+        return;
+    }
+    ResolutionControllerSettings settings = m_dynamicResolution.getController().getSettings();
+    settings.targetMs = ms;
+    m_dynamicResolution.getController().setSettings(settings);
+    m_dynamicResolution.setEnabled(true);
+}
+
+void BaseApp::setFramePacing(float targetFps, unsigned int maxFrameLatency, bool vsync) {
+    FramePacerSettings settings = m_framePacer.getSettings();
+    settings.targetFps = targetFps;
+    settings.maxFrameLatency = maxFrameLatency;
+    settings.vsync = vsync;
+    m_framePacer.setSettings(settings);
+    m_constantRing.setFramesInFlight(m_framePacer.getSettings().maxFrameLatency + 1);
+}
+
+void BaseApp::setSimulationRate(float hz) {
+    FixedTimestepSettings settings = m_fixedStep.getSettings();
+    settings.stepSeconds = hz > 0.0f ? 1.0f / hz : settings.stepSeconds;
+    m_fixedStep.setSettings(settings);
+}
+
+void BaseApp::setTextureBudget(unsigned int megabytes) {
+    if (megabytes == 0) {
+        return;
+    }
+    TextureStreamerSettings settings = m_textureStreamer.getSettings();
+    settings.budgetBytes = static_cast<unsigned long long>(megabytes) * 1024 * 1024;
+    m_textureStreamer.setSettings(settings);
+}
+
 void BaseApp::update(float deltaTime)
 {
     // Update our time
@@ -190,7 +1217,107 @@ void BaseApp::update(float deltaTime)
         t = (dwTimeCur - dwTimeStart) / 1000.0f;
     }
 
+    PROFILE_SCOPE("BaseApp::update");
+
     // GUI
+    if (!m_headless) {
+        PROFILE_SCOPE("BaseApp::renderGUI");
+        renderGUI();
+    }
+
+    // Variante elegida en la GUI; hasta que termine de compilar se dibuja con la base
+    if (m_instancedVariant) {
+        ShaderProgram& variant = m_shaderInstanced.getVariant(m_device, m_instancedKeywords);
+        if (&variant != m_instancedVariant) {
+            m_instancedVariant = &variant;
+            m_renderQueue.setInstancedShader(variant);
+        }
+    }
+
+    // Update matrices
+    m_camera.updateViewMatrix();
+    if (m_shadowsEnabled) {
+        m_shadows.update(m_camera);
+    }
+    if (m_lightsEnabled) {
+        // Las teselas se cuentan sobre la parte del objetivo que dibuja la escena
+        const D3D11_VIEWPORT sceneViewport = m_dynamicResolution.getSceneViewport();
+        m_clusteredLights.setViewportSize(static_cast<unsigned int>(sceneViewport.Width),
+                                          static_cast<unsigned int>(sceneViewport.Height));
+        m_clusteredLights.assign(m_camera, m_threadPool);
+    }
+    cbNeverChanges.mView = XMMatrixTranspose(m_camera.getView());
+    m_cbNeverChanges.update(m_deviceContext, nullptr, 0, nullptr, &cbNeverChanges, 0, 0);
+    m_cbChangeOnResize.update(m_deviceContext, nullptr, 0, nullptr, &cbChangesOnResize, 0, 0);
+
+    // Simulacin a paso fijo: N pasos segn el tiempo acumulado y dibujo interpolado
+    const unsigned int steps = m_fixedStep.advance(deltaTime);
+    for (unsigned int step = 0; step < steps; ++step) {
+        m_sceneGraph.update(m_fixedStep.getStepSeconds(), m_deviceContext);
+    }
+    ENGINE_STAT_ADD("sim_steps", steps);
+    m_sceneGraph.interpolate(m_fixedStep.getAlpha());
+    syncStaticGeometry();
+
+    // Niveles de mip pedidos desde los bounds ya interpolados de cada actor
+    const float sceneHeight = m_dynamicResolution.getSceneViewport().Height;
+    for (auto& actor : m_actors) {
+        XMFLOAT3 boundsMin, boundsMax;
+        const StreamHandle stream = actor->getTextureStream();
+        if (stream != kInvalidStream && actor->getWorldBounds(boundsMin, boundsMax)) {
+            m_textureStreamer.request(stream, m_camera, boundsMin, boundsMax, sceneHeight);
+        }
+    }
+    m_textureStreamer.update();
+}
+
+void BaseApp::syncStaticGeometry()
+{
+    // Frames quietos antes de rehacer las pginas: una pausa del ratn no rehace el batching
+    const unsigned int kSettleFrames = 30;
+
+    // Se compara la matriz de paso (la que copia el batcher), no la interpolada. La primera
+    // vez slo se guardan: build() ya us las actuales
+    const bool firstCheck = m_staticWorlds.size() != m_actors.size();
+    m_staticWorlds.resize(m_actors.size());
+    bool moved = false;
+    for (size_t i = 0; i < m_actors.size(); ++i) {
+        if (!m_actors[i]->isStatic()) {
+            continue;
+        }
+        XMFLOAT4X4 world;
+        XMStoreFloat4x4(&world, m_actors[i]->getComponent<Transform>()->matrix);
+        if (memcmp(&world, &m_staticWorlds[i], sizeof(world)) != 0) {
+            m_staticWorlds[i] = world;
+            moved = true;
+        }
+    }
+    if (firstCheck) {
+        return;
+    }
+
+    if (moved) {
+        if (!m_staticEditing) {
+            // Cada actor vuelve a su propio paquete para verse moverse en vivo
+            m_staticBatcher.destroy();
+            m_staticEditing = true;
+        }
+        m_staticStillFrames = 0;
+        m_shadows.invalidateStaticCasters();
+        return;
+    }
+    if (m_staticEditing && ++m_staticStillFrames >= kSettleFrames) {
+        HRESULT hr = m_staticBatcher.build(m_device, m_actors);
+        if (FAILED(hr)) {
+            ERROR("Main", "SyncStaticGeometry", ("Static batching disabled. HRESULT: " + std::to_string(hr)).c_str());
+        }
+        m_staticEditing = false;
+        m_staticStillFrames = 0;
+        m_shadows.invalidateStaticCasters();
+    }
+}
+
+void BaseApp::renderGUI() {
     m_gui.update(m_viewport, m_window);
 
     // Skybox debug - 6 caras pequeas
@@ -227,45 +1354,291 @@ void BaseApp::update(float deltaTime)
         m_gui.editTransform(m_camera.getView(), m_camera.getProj(), m_actors[m_gui.selectedActorIndex]);
     }
     m_gui.outliner(m_actors);
+    m_gui.profilerWindow();
+    m_gui.statsOverlay();
+    m_gui.framePacingWindow(m_framePacer);
+    m_gui.textureStreamingWindow(m_textureStreamer);
 
-    // Update matrices
-    m_camera.updateViewMatrix();
-    cbNeverChanges.mView = XMMatrixTranspose(m_camera.getView());
-    m_cbNeverChanges.update(m_deviceContext, nullptr, 0, nullptr, &cbNeverChanges, 0, 0);
-    m_cbChangeOnResize.update(m_deviceContext, nullptr, 0, nullptr, &cbChangesOnResize, 0, 0);
-
-    // Update scene
-    m_sceneGraph.update(deltaTime, m_deviceContext);
+    // Estadsticas de la cola del frame anterior
+    const RenderQueueStats& queueStats = m_renderQueue.getStats();
+    ImGui::Begin("Render Queue");
+    ImGui::Text("Packets: %u", queueStats.packets);
+    ImGui::Text("Draw calls: %u (instanced: %u)", queueStats.drawCalls, queueStats.instancedDraws);
+    ImGui::Text("Draws saved by instancing: %u", queueStats.drawsSaved());
+    ImGui::Text("Binds (naive): %u", queueStats.bindsRequested);
+    ImGui::Text("Binds (issued): %u", queueStats.bindsIssued);
+    ImGui::Text("Binds skipped: %u", queueStats.bindsSkipped());
+    const ConstantBufferRingStats& ringStats = m_constantRing.getStats();
+    ImGui::Separator();
+    ImGui::Text("CB ring: %s", m_constantRing.usesOffsets() ? "D3D11.1 offsets" : "per-draw fallback");
+    ImGui::Text("CB allocations: %u (fallback: %u)", ringStats.allocations, ringStats.fallbackAllocations);
+    ImGui::Text("CB maps: %u no-overwrite, %u discard", ringStats.noOverwriteMaps, ringStats.discardMaps);
+    ImGui::Text("CB ring in flight: %llu / %llu bytes",
+                m_constantRing.getAllocator().getUsed(),
+                m_constantRing.getAllocator().getCapacity());
+    const DeviceContextStats& contextStats = m_deviceContext.getStateStats();
+    ImGui::Separator();
+    ImGui::Text("State cache: %s", m_deviceContext.isStateFilteringEnabled() ? "on" : "off");
+    ImGui::Text("State calls issued: %llu", contextStats.stateCallsIssued);
+    ImGui::Text("State calls filtered: %llu", contextStats.stateCallsFiltered);
+    const ParallelRecorderStats& recorderStats = m_commandRecorder.getStats();
+    ImGui::Separator();
+    ImGui::Text("Deferred contexts: %u", m_commandRecorder.isParallel() ? m_commandRecorder.getMaxRanges() : 0);
+    ImGui::Text("Command lists: %u (ranges: %u)", recorderStats.commandLists, recorderStats.ranges);
+    const StaticBatchStats& staticStats = m_staticBatcher.getStats();
+    ImGui::Separator();
+    ImGui::Text("Static meshes: %u in %u pages (%u draws)",
+                staticStats.submeshes, staticStats.pages, staticStats.drawsSubmitted);
+    const PipelineStateCacheStats& stateStats = PipelineStateCache::getInstance().getStats();
+    ImGui::Separator();
+    ImGui::Text("Pipelines: %u", stateStats.pipelines);
+    ImGui::Text("State objects: %u sampler, %u blend, %u raster, %u depth",
+                stateStats.samplerStates, stateStats.blendStates,
+                stateStats.rasterizerStates, stateStats.depthStencilStates);
+    ImGui::Text("State cache hits: %u / %u", stateStats.stateHits, stateStats.stateRequests);
+    const ShaderCacheStats shaderStats = m_shaderCache.getStats();
+    ImGui::Separator();
+    ImGui::Text("Shader cache: %u hits, %u misses (%u entries)",
+                shaderStats.hits, shaderStats.misses, shaderStats.entries);
+    ImGui::Text("Shader compile: %.1f ms, load: %.2f ms", shaderStats.compileMs, shaderStats.loadMs);
+    const ShaderPermutationStats& variantStats = m_shaderInstanced.getStats();
+    bool showInstanceColor = (m_instancedKeywords & m_shaderInstanced.getKeywordMask("SHOW_INSTANCE_COLOR")) != 0;
+    if (ImGui::Checkbox("Show instance colors", &showInstanceColor)) {
+        m_instancedKeywords ^= m_shaderInstanced.getKeywordMask("SHOW_INSTANCE_COLOR");
+    }
+    ImGui::Text("Shader variants: %u ready, %u pending, %u failed",
+                variantStats.variantsReady, variantStats.variantsPending, variantStats.compileErrors);
+    ImGui::Text("Variant compiles: %u (%.1f ms)", variantStats.compiles, variantStats.compileMs);
+    const ShadowStats& shadowStats = m_shadows.getStats();
+    ImGui::Separator();
+    if (m_shadows.getCascadeCount() > 0 && ImGui::Checkbox("Cascaded shadows", &m_shadowsEnabled)) {
+        // El receptor slo puede muestrear el mapa mientras el pase existe
+        m_instancedKeywords ^= m_shaderInstanced.getKeywordMask("RECEIVE_SHADOWS");
+    }
+    ImGui::Text("Shadow casters: %u tested, %u culled", shadowStats.castersTested, shadowStats.castersCulled);
+    ImGui::Text("Shadow packets: %u static, %u dynamic (%u draws)",
+                shadowStats.staticPackets, shadowStats.dynamicPackets, shadowStats.drawCalls);
+    ImGui::Text("Static cascades: %u rendered, %u cached, %u untouched",
+                shadowStats.staticCascadesRendered, shadowStats.staticCascadesReused, shadowStats.cascadesSkipped);
+    const ClusterStats& clusterStats = m_clusteredLights.getStats();
+    ImGui::Separator();
+    if (clusterStats.clusters > 0 && ImGui::Checkbox("Clustered lights", &m_lightsEnabled)) {
+        m_instancedKeywords ^= m_shaderInstanced.getKeywordMask("CLUSTERED_LIGHTS");
+    }
+    ImGui::Text("Lights: %u visible of %u (%u dropped)",
+                clusterStats.visibleLights, clusterStats.lights, clusterStats.droppedLights);
+    ImGui::Text("Clusters: %u active of %u (max %u lights)",
+                clusterStats.activeClusters, clusterStats.clusters, clusterStats.maxLightsPerCluster);
+    ImGui::Text("Light indices: %u, sphere tests: %llu", clusterStats.lightIndices, clusterStats.sphereTests);
+    ImGui::Text("Light assignment: %.3f ms", clusterStats.assignMs);
+    const ResolutionControllerStats& resolutionStats = m_dynamicResolution.getController().getStats();
+    ImGui::Separator();
+    bool dynamicResolution = m_dynamicResolution.isEnabled();
+    if (ImGui::Checkbox("Dynamic resolution", &dynamicResolution)) {
+        m_dynamicResolution.setEnabled(dynamicResolution);
+    }
+    const D3D11_VIEWPORT sceneViewport = m_dynamicResolution.getSceneViewport();
+    ImGui::Text("Scene: %.0f x %.0f (scale %.3f, raw %.3f)",
+                sceneViewport.Width, sceneViewport.Height, m_dynamicResolution.getScale(), resolutionStats.rawScale);
+    ImGui::Text("Frame: %.2f ms filtered, budget %.2f ms",
+                resolutionStats.filteredMs, m_dynamicResolution.getController().getSettings().targetMs);
+    ImGui::Text("Over budget: %u of %u frames, %u scale changes",
+                resolutionStats.framesOverBudget, resolutionStats.samples, resolutionStats.scaleChanges);
+    const RenderGraphStats& graphStats = m_renderGraph.getStats();
+    ImGui::Separator();
+    ImGui::Text("Render graph: %u passes (%u culled)", graphStats.passes, graphStats.passesCulled);
+    ImGui::Text("Transient textures: %u on %u physical", graphStats.transientTextures, graphStats.physicalTextures);
+    ImGui::Text("Transient memory: %.2f MB (%.2f MB saved)",
+                graphStats.transientBytes / (1024.0 * 1024.0), graphStats.bytesSaved() / (1024.0 * 1024.0));
+    const MeshPoolStats poolStats = m_meshPool.getStats();
+    ImGui::Separator();
+    ImGui::Text("Mesh pool: %u meshes", poolStats.meshes);
+    ImGui::Text("Pool vertices: %u / %u (frag %.2f)",
+                poolStats.verticesUsed, poolStats.vertexCapacity, poolStats.vertexFragmentation);
+    ImGui::Text("Pool indices: %u / %u (frag %.2f)",
+                poolStats.indicesUsed, poolStats.indexCapacity, poolStats.indexFragmentation);
+    ImGui::Text("Pool compactions: %u (%llu bytes moved)", poolStats.defragmentations, poolStats.bytesMoved);
+    ImGui::End();
 }
 
 void BaseApp::render() {
-    float ClearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
-    m_renderTargetView.render(m_deviceContext, m_depthStencilView, 1, ClearColor);
-    m_viewport.render(m_deviceContext);
-    m_depthStencilView.render(m_deviceContext);
-    m_shaderProgram.render(m_deviceContext);
-    m_cbNeverChanges.render(m_deviceContext, 0, 1);
-    m_cbChangeOnResize.render(m_deviceContext, 1, 1);
-    m_sceneGraph.render(m_deviceContext);
-    m_gui.render();
-    m_swapChain.present();
+    PROFILE_SCOPE("BaseApp::render");
+    // Las estadsticas del frame anterior ya se leyeron (GUI en update, headless tras render)
+    m_deviceContext.resetStateStats();
+    // Sombras y escena suben sus constantes por objeto al mismo anillo
+    m_constantRing.beginFrame();
+
+    // Grafo del frame: el back buffer viene de fuera, la profundidad es transitoria
+    m_renderGraph.reset();
+    RGTextureDesc backBufferDesc = m_sceneDepthDesc;
+    backBufferDesc.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    backBufferDesc.bindFlags = D3D11_BIND_RENDER_TARGET;
+    RGHandle backBuffer = m_renderGraph.importTexture("BackBuffer", backBufferDesc, m_renderTargetView.getView());
+    RGHandle sceneDepth = kInvalidRGHandle;
+
+    // Con resolucin dinmica la escena va a un objetivo intermedio del tamao del back buffer
+    // y slo ocupa la esquina del viewport escalado; el pase Upscale la estira despus
+    const bool scaleScene = m_dynamicResolution.isEnabled();
+    const D3D11_VIEWPORT sceneViewport = scaleScene ? m_dynamicResolution.getSceneViewport() : m_viewport.m_viewport;
+    RGTextureDesc sceneColorDesc = backBufferDesc;
+    if (sceneColorDesc.sampleCount <= 1) {
+        // Sin MSAA no hace falta resolver: el pase de escalado lee el mismo objetivo
+        sceneColorDesc.bindFlags |= D3D11_BIND_SHADER_RESOURCE;
+    }
+    RGHandle sceneColor = kInvalidRGHandle;
+    RGHandle sceneResolved = kInvalidRGHandle;
+
+    // El mapa de sombras persiste entre frames (cach esttica): se importa, no es transitorio
+    RGHandle shadowMap = kInvalidRGHandle;
+    if (m_shadowsEnabled) {
+        shadowMap = m_renderGraph.importTexture("ShadowMap", m_shadows.getDesc(), nullptr, nullptr,
+                                                m_shadows.getShaderResourceView());
+        m_renderGraph.addPass("Shadows",
+            [&](RenderGraphBuilder& builder) {
+                builder.write(shadowMap);
+            },
+            [this](DeviceContext& context, const RenderGraphResources&) {
+                m_shadows.render(context, m_actors, m_staticBatcher);
+            });
+    }
+
+    m_renderGraph.addPass("Scene",
+        [&](RenderGraphBuilder& builder) {
+            if (scaleScene) {
+                sceneColor = builder.create("SceneColor", sceneColorDesc);
+            }
+            else {
+                builder.write(backBuffer);
+            }
+            sceneDepth = builder.create("SceneDepth", m_sceneDepthDesc);
+            if (shadowMap != kInvalidRGHandle) {
+                builder.read(shadowMap);
+            }
+        },
+        [&](DeviceContext& context, const RenderGraphResources& resources) {
+            ID3D11RenderTargetView* renderTarget = resources.getRenderTargetView(scaleScene ? sceneColor : backBuffer);
+            ID3D11DepthStencilView* depthStencil = resources.getDepthStencilView(sceneDepth);
+            float ClearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+            context.ClearRenderTargetView(renderTarget, ClearColor);
+            context.ClearDepthStencilView(depthStencil, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+            context.OMSetRenderTargets(1, &renderTarget, depthStencil);
+            context.RSSetViewports(1, &sceneViewport);
+            m_cbNeverChanges.render(context, 0, 1);
+            m_cbChangeOnResize.render(context, 1, 1);
+            if (shadowMap != kInvalidRGHandle) {
+                m_shadows.bind(context);
+            }
+            if (m_lightsEnabled) {
+                m_clusteredLights.upload(m_device, context);
+                m_clusteredLights.bind(context);
+            }
+            // La escena emite paquetes; la cola los ordena y enlaza shaders y estado sin repetir
+            m_renderQueue.begin(m_camera.getView(), m_camera.getNearZ(), m_camera.getFarZ());
+            m_sceneGraph.submit(m_renderQueue);
+            m_staticBatcher.submit(m_renderQueue);
+            m_renderQueue.sort();
+            // Cada contexto diferido empieza vaco: vuelve a enlazar el estado del frame
+            m_renderQueue.executeParallel(context, m_commandRecorder, [&](DeviceContext& deferred) {
+                deferred.OMSetRenderTargets(1, &renderTarget, depthStencil);
+                deferred.RSSetViewports(1, &sceneViewport);
+                ID3D11Buffer* frameConstants[] = { m_cbNeverChanges.getBuffer(), m_cbChangeOnResize.getBuffer() };
+                deferred.VSSetConstantBuffers(0, 2, frameConstants);
+                if (shadowMap != kInvalidRGHandle) {
+                    m_shadows.bind(deferred);
+                }
+                if (m_lightsEnabled) {
+                    m_clusteredLights.bind(deferred);
+                }
+            });
+        });
+
+    if (scaleScene) {
+        sceneResolved = sceneColor;
+        if (sceneColorDesc.sampleCount > 1) {
+            m_renderGraph.addPass("Resolve",
+                [&](RenderGraphBuilder& builder) {
+                    builder.read(sceneColor);
+                    RGTextureDesc resolvedDesc = sceneColorDesc;
+                    resolvedDesc.bindFlags = D3D11_BIND_SHADER_RESOURCE;
+                    resolvedDesc.sampleCount = 1;
+                    resolvedDesc.sampleQuality = 0;
+                    sceneResolved = builder.create("SceneResolved", resolvedDesc);
+                },
+                [&](DeviceContext& context, const RenderGraphResources& resources) {
+                    context.ResolveSubresource(resources.getTexture(sceneResolved), 0,
+                                               resources.getTexture(sceneColor), 0,
+                                               sceneColorDesc.format);
+                });
+        }
+        m_renderGraph.addPass("Upscale",
+            [&](RenderGraphBuilder& builder) {
+                builder.read(sceneResolved);
+                builder.write(backBuffer);
+            },
+            [&](DeviceContext& context, const RenderGraphResources& resources) {
+                m_dynamicResolution.upscale(context,
+                                            resources.getShaderResourceView(sceneResolved),
+                                            resources.getRenderTargetView(backBuffer));
+            });
+    }
+
+    if (!m_headless) {
+        m_renderGraph.addPass("GUI",
+            [&](RenderGraphBuilder& builder) {
+                builder.write(backBuffer);
+                builder.setSideEffects();
+            },
+            [this](DeviceContext& context, const RenderGraphResources&) {
+                m_gui.render();
+                // ImGui enlaza su propio estado directamente en el contexto nativo
+                context.invalidateStateCache();
+            });
+    }
+
+    if (!m_renderGraph.compile() || FAILED(m_renderGraph.execute(m_device, m_deviceContext))) {
+        ERROR("Main", "Render", "Failed to compile or execute the frame render graph.");
+    }
+    if (!m_headless) {
+        PROFILE_SCOPE("SwapChain::present");
+        m_swapChain.setSyncInterval(m_framePacer.getSyncInterval());
+        m_swapChain.present();
+    }
 }
 
 void BaseApp::destroy() {
-    if (m_deviceContext.m_deviceContext) m_deviceContext.m_deviceContext->ClearState();
+    if (m_deviceContext.m_deviceContext) m_deviceContext.ClearState();
+    m_staticBatcher.destroy();
     m_sceneGraph.destroy();
+    m_textureStreamer.destroy();
+    // Los actores no se destruyen aqu: el pool libera sus tramos de golpe
+    m_meshPool.destroy();
     m_cbNeverChanges.destroy();
     m_cbChangeOnResize.destroy();
     m_shaderProgram.destroy();
-    m_depthStencil.destroy();
-    m_depthStencilView.destroy();
+    m_shaderInstanced.destroy();
+    m_shadows.destroy();
+    m_clusteredLights.destroy();
+    m_dynamicResolution.destroy();
+    m_framePacer.destroy();
+    m_shaderCache.destroy();
+    m_commandRecorder.destroy();
+    m_threadPool.destroy();
+    m_renderQueue.destroy();
+    m_constantRing.destroy();
+    // Una captura sin terminar se escribe con lo que haya; espera al hilo escritor
+    TraceCapture::getInstance().destroy();
+    EngineStats::getInstance().stopCsv();
+    Profiler::getInstance().destroy();
+    PipelineStateCache::getInstance().destroy();
+    m_renderGraph.destroy();
     m_renderTargetView.destroy();
     m_swapChain.destroy();
     m_backBuffer.destroy();
     m_skyboxTex.destroy();
-    m_gui.destroy();
+    if (!m_headless) m_gui.destroy();
     m_deviceContext.destroy();
     m_device.destroy();
+    m_renderBackend.reset();
 }
 
 LRESULT BaseApp::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
@@ -0,0 +1,795 @@
+#include "EngineUtilities/Utilities/BlockCompressor.h"
+#include "EngineUtilities/Utilities/ThreadPool.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include <xmmintrin.h>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace {
+  /** @brief Un bloque de 4x4: bytes RGBA y, para SSE, cada canal en 16 floats seguidos. */
+  struct Block {
+    unsigned char rgba[16][4];
+    float channel[4][16];
+  };
+
+  /** @brief Extremo BC7 modo 6: 7 bits por canal ms un p-bit compartido. */
+  struct Bc7Endpoint {
+    int c7[4];
+    int p;
+    int value[4];   ///< (c7 << 1) | p, lo que reconstruye el hardware.
+  };
+
+  const int kBc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+  std::mutex g_totalsMutex;
+  BcStats g_totals;
+
+  inline float
+  clampByte(float value) {
+    return value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+  }
+
+  void
+  loadBlock(const unsigned char* rgba, unsigned int width, unsigned int height,
+            unsigned int bx, unsigned int by, Block& block) {
+    for (unsigned int y = 0; y < 4; ++y) {
+      // Niveles menores de 4x4: se repite el borde
+      const unsigned int sy = by * 4 + y < height ? by * 4 + y : height - 1;
+      for (unsigned int x = 0; x < 4; ++x) {
+        const unsigned int sx = bx * 4 + x < width ? bx * 4 + x : width - 1;
+        memcpy(block.rgba[y * 4 + x], rgba + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+      }
+    }
+    for (unsigned int i = 0; i < 16; ++i) {
+      for (unsigned int c = 0; c < 4; ++c) {
+        block.channel[c][i] = block.rgba[i][c];
+      }
+    }
+  }
+
+  /**
+   * @brief Posicin de cada pxel sobre el segmento @p e0 -> @p e1, en [0, 1].
+   * Slo cuentan los canales con @p weight distinto de 0. Cuatro pxeles por iteracin.
+   */
+  void
+  project(const Block& block, const float e0[4], const float e1[4], const float weight[4], float t[16]) {
+    float d[4];
+    float lengthSq = 0.0f;
+    for (unsigned int c = 0; c < 4; ++c) {
+      d[c] = (e1[c] - e0[c]) * weight[c];
+      lengthSq += d[c] * (e1[c] - e0[c]);
+    }
+    if (lengthSq < 1e-6f) {
+      memset(t, 0, 16 * sizeof(float));
+      return;
+    }
+    const __m128 inverse = _mm_set1_ps(1.0f / lengthSq);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (unsigned int g = 0; g < 16; g += 4) {
+      __m128 dot = zero;
+      for (unsigned int c = 0; c < 4; ++c) {
+        const __m128 offset = _mm_sub_ps(_mm_loadu_ps(block.channel[c] + g), _mm_set1_ps(e0[c]));
+        dot = _mm_add_ps(dot, _mm_mul_ps(offset, _mm_set1_ps(d[c])));
+      }
+      _mm_storeu_ps(t + g, _mm_min_ps(_mm_max_ps(_mm_mul_ps(dot, inverse), zero), one));
+    }
+  }
+
+  /**
+   * @brief Extremos sobre el eje principal de los canales con peso: media ms la
+   * proyeccin mnima y mxima sobre el autovector dominante de la covarianza.
+   */
+  void
+  principalEndpoints(const Block& block, const float weight[4], float e0[4], float e1[4]) {
+    float mean[4] = {};
+    float low[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+    float high[4] = {};
+    for (unsigned int i = 0; i < 16; ++i) {
+      for (unsigned int c = 0; c < 4; ++c) {
+        const float v = block.channel[c][i];
+        mean[c] += v;
+        low[c] = v < low[c] ? v : low[c];
+        high[c] = v > high[c] ? v : high[c];
+      }
+    }
+    float axis[4];
+    float range = 0.0f;
+    for (unsigned int c = 0; c < 4; ++c) {
+      mean[c] /= 16.0f;
+      e0[c] = mean[c];
+      e1[c] = mean[c];
+      axis[c] = (high[c] - low[c]) * weight[c];
+      range += axis[c];
+    }
+    if (range <= 0.0f) {
+      return;
+    }
+
+    float covariance[4][4] = {};
+    for (unsigned int i = 0; i < 16; ++i) {
+      float d[4];
+      for (unsigned int c = 0; c < 4; ++c) {
+        d[c] = (block.channel[c][i] - mean[c]) * weight[c];
+      }
+      for (unsigned int a = 0; a < 4; ++a) {
+        for (unsigned int b = 0; b < 4; ++b) {
+          covariance[a][b] += d[a] * d[b];
+        }
+      }
+    }
+    // Iteracin de potencia desde la diagonal de la caja: converge en pocas vueltas
+    for (unsigned int iteration = 0; iteration < 8; ++iteration) {
+      float next[4] = {};
+      float largest = 0.0f;
+      for (unsigned int a = 0; a < 4; ++a) {
+        for (unsigned int b = 0; b < 4; ++b) {
+          next[a] += covariance[a][b] * axis[b];
+        }
+        largest = fabsf(next[a]) > largest ? fabsf(next[a]) : largest;
+      }
+      if (largest < 1e-9f) {
+        break;
+      }
+      for (unsigned int c = 0; c < 4; ++c) {
+        axis[c] = next[c] / largest;
+      }
+    }
+    float length = 0.0f;
+    for (unsigned int c = 0; c < 4; ++c) {
+      length += axis[c] * axis[c];
+    }
+    length = sqrtf(length);
+    float minT = 1e9f, maxT = -1e9f;
+    for (unsigned int i = 0; i < 16; ++i) {
+      float t = 0.0f;
+      for (unsigned int c = 0; c < 4; ++c) {
+        t += (block.channel[c][i] - mean[c]) * axis[c] / length;
+      }
+      minT = t < minT ? t : minT;
+      maxT = t > maxT ? t : maxT;
+    }
+    for (unsigned int c = 0; c < 4; ++c) {
+      e0[c] = clampByte(mean[c] + axis[c] / length * minT);
+      e1[c] = clampByte(mean[c] + axis[c] / length * maxT);
+    }
+  }
+
+  /**
+   * @brief Extremos que minimizan el error cuadrtico con los pesos de interpolacin elegidos.
+   * @param w Peso de @p e1 en cada pxel, en [0, 1].
+   * @return false si el sistema es singular (todos los pxeles con el mismo peso).
+   */
+  bool
+  refitEndpoints(const Block& block, const float w[16], float e0[4], float e1[4]) {
+    float a = 0.0f, b = 0.0f, c = 0.0f;
+    float x0[4] = {}, x1[4] = {};
+    for (unsigned int i = 0; i < 16; ++i) {
+      const float u = 1.0f - w[i];
+      a += u * u;
+      b += u * w[i];
+      c += w[i] * w[i];
+      for (unsigned int ch = 0; ch < 4; ++ch) {
+        x0[ch] += u * block.channel[ch][i];
+        x1[ch] += w[i] * block.channel[ch][i];
+      }
+    }
+    const float determinant = a * c - b * b;
+    if (fabsf(determinant) < 1e-6f) {
+      return false;
+    }
+    for (unsigned int ch = 0; ch < 4; ++ch) {
+      e0[ch] = clampByte((c * x0[ch] - b * x1[ch]) / determinant);
+      e1[ch] = clampByte((a * x1[ch] - b * x0[ch]) / determinant);
+    }
+    return true;
+  }
+
+  // -----------------------------------------------------------------------------
+  // BC1 (color) y BC4 (un canal)
+  // -----------------------------------------------------------------------------
+
+  inline unsigned short
+  to565(const float c[4]) {
+    const int r = static_cast<int>(c[0] * 31.0f / 255.0f + 0.5f);
+    const int g = static_cast<int>(c[1] * 63.0f / 255.0f + 0.5f);
+    const int b = static_cast<int>(c[2] * 31.0f / 255.0f + 0.5f);
+    return static_cast<unsigned short>((r << 11) | (g << 5) | b);
+  }
+
+  inline void
+  from565(unsigned short value, int out[3]) {
+    const int r = (value >> 11) & 31;
+    const int g = (value >> 5) & 63;
+    const int b = value & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+  }
+
+  /** @brief Paleta de un bloque de color; @p fourColor segn el orden de los extremos. */
+  void
+  bc1Palette(unsigned short c0, unsigned short c1, bool fourColor, int palette[4][4]) {
+    from565(c0, palette[0]);
+    from565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = palette[2][3] = 255;
+    for (unsigned int c = 0; c < 3; ++c) {
+      if (fourColor) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+      }
+      else {
+        palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+        palette[3][c] = 0;
+      }
+    }
+    palette[3][3] = fourColor ? 255 : 0;
+  }
+
+  /** @brief Codifica el color de un bloque en 8 bytes (siempre en modo de 4 colores). */
+  void
+  encodeColorBlock(const Block& block, unsigned char* out) {
+    static const float kWeight[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+    // Paso a lo largo del segmento (0..3) -> cdigo BC1
+    static const unsigned int kCode[4] = { 0, 2, 3, 1 };
+    float e0[4], e1[4];
+    principalEndpoints(block, kWeight, e0, e1);
+
+    unsigned int bestError = 0xFFFFFFFFu;
+    unsigned short best0 = 0, best1 = 0;
+    unsigned int bestCodes[16] = {};
+    for (unsigned int pass = 0; pass < 2; ++pass) {
+      const unsigned short c0 = to565(e0);
+      const unsigned short c1 = to565(e1);
+      int palette[4][4];
+      bc1Palette(c0, c1, true, palette);
+      const float q0[4] = { static_cast<float>(palette[0][0]), static_cast<float>(palette[0][1]), static_cast<float>(palette[0][2]), 0.0f };
+      const float q1[4] = { static_cast<float>(palette[1][0]), static_cast<float>(palette[1][1]), static_cast<float>(palette[1][2]), 0.0f };
+      float t[16];
+      project(block, q0, q1, kWeight, t);
+
+      unsigned int codes[16];
+      float w[16];
+      unsigned int error = 0;
+      for (unsigned int i = 0; i < 16; ++i) {
+        const unsigned int step = static_cast<unsigned int>(t[i] * 3.0f + 0.5f);
+        codes[i] = c0 == c1 ? 0 : kCode[step];
+        w[i] = step / 3.0f;
+        for (unsigned int c = 0; c < 3; ++c) {
+          const int d = palette[codes[i]][c] - block.rgba[i][c];
+          error += d * d;
+        }
+      }
+      if (error < bestError) {
+        bestError = error;
+        best0 = c0;
+        best1 = c1;
+        memcpy(bestCodes, codes, sizeof(codes));
+      }
+      if (pass == 0 && !refitEndpoints(block, w, e0, e1)) {
+        break;
+      }
+    }
+
+    // El modo de 4 colores exige c0 > c1: al cambiar el orden, los cdigos se intercambian por pares
+    if (best0 < best1) {
+      const unsigned short swap = best0;
+      best0 = best1;
+      best1 = swap;
+      for (unsigned int i = 0; i < 16; ++i) {
+        bestCodes[i] ^= 1;
+      }
+    }
+    unsigned int indices = 0;
+    for (unsigned int i = 0; i < 16; ++i) {
+      indices |= bestCodes[i] << (2 * i);
+    }
+    out[0] = static_cast<unsigned char>(best0);
+    out[1] = static_cast<unsigned char>(best0 >> 8);
+    out[2] = static_cast<unsigned char>(best1);
+    out[3] = static_cast<unsigned char>(best1 >> 8);
+    memcpy(out + 4, &indices, 4);
+  }
+
+  /** @brief Codifica un canal en 8 bytes, en modo de 8 valores (a0 > a1). */
+  void
+  encodeChannelBlock(const Block& block, unsigned int channel, unsigned char* out) {
+    float low = 255.0f, high = 0.0f;
+    for (unsigned int i = 0; i < 16; ++i) {
+      const float v = block.channel[channel][i];
+      low = v < low ? v : low;
+      high = v > high ? v : high;
+    }
+    memset(out, 0, 8);
+    out[0] = static_cast<unsigned char>(high);
+    out[1] = static_cast<unsigned char>(low);
+    if (high == low) {
+      return;
+    }
+
+    float weight[4] = {}, e0[4] = {}, e1[4] = {};
+    weight[channel] = 1.0f;
+    e0[channel] = high;
+    e1[channel] = low;
+    float t[16];
+    project(block, e0, e1, weight, t);
+    unsigned long long indices = 0;
+    for (unsigned int i = 0; i < 16; ++i) {
+      // Paso 0 = a0, paso 7 = a1, los intermedios son los cdigos 2..7
+      const unsigned int step = static_cast<unsigned int>(t[i] * 7.0f + 0.5f);
+      const unsigned long long code = step == 0 ? 0 : (step == 7 ? 1 : step + 1);
+      indices |= code << (3 * i);
+    }
+    for (unsigned int b = 0; b < 6; ++b) {
+      out[2 + b] = static_cast<unsigned char>(indices >> (8 * b));
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  // BC7 (modo 6)
+  // -----------------------------------------------------------------------------
+
+  /** @brief Elige el p-bit que mejor reconstruye @p e y cuantiza a 7 bits. */
+  void
+  quantizeBc7(const float e[4], Bc7Endpoint& q) {
+    int bestError = 0x7FFFFFFF;
+    for (int p = 0; p < 2; ++p) {
+      Bc7Endpoint candidate;
+      candidate.p = p;
+      int error = 0;
+      for (unsigned int c = 0; c < 4; ++c) {
+        int c7 = static_cast<int>(floorf((e[c] - p) * 0.5f + 0.5f));
+        c7 = c7 < 0 ? 0 : (c7 > 127 ? 127 : c7);
+        candidate.c7[c] = c7;
+        candidate.value[c] = (c7 << 1) | p;
+        const int d = candidate.value[c] - static_cast<int>(e[c] + 0.5f);
+        error += d * d;
+      }
+      if (error < bestError) {
+        bestError = error;
+        q = candidate;
+      }
+    }
+  }
+
+  /** @brief ndice de 4 bits ms cercano a cada posicin 0..64 del segmento. */
+  const unsigned char*
+  bc7WeightIndex() {
+    static const struct Table {
+      unsigned char index[65];
+      Table() {
+        for (int t = 0; t <= 64; ++t) {
+          int best = 0;
+          for (int i = 1; i < 16; ++i) {
+            if (abs(kBc7Weights[i] - t) < abs(kBc7Weights[best] - t)) {
+              best = i;
+            }
+          }
+          index[t] = static_cast<unsigned char>(best);
+        }
+      }
+    } table;
+    return table.index;
+  }
+
+  unsigned int
+  evaluateBc7(const Block& block, const float e0[4], const float e1[4],
+              Bc7Endpoint& q0, Bc7Endpoint& q1, unsigned char indices[16]) {
+    static const float kWeight[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    quantizeBc7(e0, q0);
+    quantizeBc7(e1, q1);
+    float f0[4], f1[4];
+    for (unsigned int c = 0; c < 4; ++c) {
+      f0[c] = static_cast<float>(q0.value[c]);
+      f1[c] = static_cast<float>(q1.value[c]);
+    }
+    float t[16];
+    project(block, f0, f1, kWeight, t);
+    const unsigned char* weightIndex = bc7WeightIndex();
+    unsigned int error = 0;
+    for (unsigned int i = 0; i < 16; ++i) {
+      indices[i] = weightIndex[static_cast<int>(t[i] * 64.0f + 0.5f)];
+      const int w = kBc7Weights[indices[i]];
+      for (unsigned int c = 0; c < 4; ++c) {
+        const int d = (((64 - w) * q0.value[c] + w * q1.value[c] + 32) >> 6) - block.rgba[i][c];
+        error += d * d;
+      }
+    }
+    return error;
+  }
+
+  /** @brief Escribe bits del LSB al MSB, como los lee el hardware. */
+  struct BitWriter {
+    unsigned char* out;
+    unsigned int position;
+
+    void
+    write(unsigned int value, unsigned int bits) {
+      for (unsigned int b = 0; b < bits; ++b, ++position) {
+        if ((value >> b) & 1) {
+          out[position >> 3] |= static_cast<unsigned char>(1 << (position & 7));
+        }
+      }
+    }
+  };
+
+  struct BitReader {
+    const unsigned char* in;
+    unsigned int position;
+
+    unsigned int
+    read(unsigned int bits) {
+      unsigned int value = 0;
+      for (unsigned int b = 0; b < bits; ++b, ++position) {
+        value |= ((in[position >> 3] >> (position & 7)) & 1) << b;
+      }
+      return value;
+    }
+  };
+
+  void
+  encodeBc7Block(const Block& block, unsigned char* out) {
+    static const float kWeight[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float e0[4], e1[4];
+    principalEndpoints(block, kWeight, e0, e1);
+    Bc7Endpoint q0, q1;
+    unsigned char indices[16];
+    unsigned int error = evaluateBc7(block, e0, e1, q0, q1, indices);
+
+    float w[16];
+    for (unsigned int i = 0; i < 16; ++i) {
+      w[i] = kBc7Weights[indices[i]] / 64.0f;
+    }
+    if (error > 0 && refitEndpoints(block, w, e0, e1)) {
+      Bc7Endpoint r0, r1;
+      unsigned char refit[16];
+      const unsigned int refitError = evaluateBc7(block, e0, e1, r0, r1, refit);
+      if (refitError < error) {
+        q0 = r0;
+        q1 = r1;
+        memcpy(indices, refit, sizeof(indices));
+      }
+    }
+
+    // El ndice del pxel 0 se guarda con 3 bits: su bit alto tiene que ser 0
+    if (indices[0] >= 8) {
+      const Bc7Endpoint swap = q0;
+      q0 = q1;
+      q1 = swap;
+      for (unsigned int i = 0; i < 16; ++i) {
+        indices[i] = static_cast<unsigned char>(15 - indices[i]);
+      }
+    }
+
+    memset(out, 0, 16);
+    BitWriter writer = { out, 0 };
+    writer.write(1 << 6, 7);        // Modo 6
+    for (unsigned int c = 0; c < 4; ++c) {
+      writer.write(q0.c7[c], 7);
+      writer.write(q1.c7[c], 7);
+    }
+    writer.write(q0.p, 1);
+    writer.write(q1.p, 1);
+    for (unsigned int i = 0; i < 16; ++i) {
+      writer.write(indices[i], i == 0 ? 3 : 4);
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  // Decodificacin (para el PSNR)
+  // -----------------------------------------------------------------------------
+
+  void
+  decodeColorBlock(const unsigned char* in, bool forceFourColor, unsigned char out[16][4]) {
+    const unsigned short c0 = static_cast<unsigned short>(in[0] | (in[1] << 8));
+    const unsigned short c1 = static_cast<unsigned short>(in[2] | (in[3] << 8));
+    int palette[4][4];
+    bc1Palette(c0, c1, forceFourColor || c0 > c1, palette);
+    unsigned int indices;
+    memcpy(&indices, in + 4, 4);
+    for (unsigned int i = 0; i < 16; ++i) {
+      const int* color = palette[(indices >> (2 * i)) & 3];
+      for (unsigned int c = 0; c < 4; ++c) {
+        out[i][c] = static_cast<unsigned char>(color[c]);
+      }
+    }
+  }
+
+  void
+  decodeChannelBlock(const unsigned char* in, unsigned int channel, unsigned char out[16][4]) {
+    const int a0 = in[0], a1 = in[1];
+    int palette[8] = { a0, a1 };
+    for (int k = 2; k < 8; ++k) {
+      palette[k] = a0 > a1
+        ? ((8 - k) * a0 + (k - 1) * a1) / 7
+        : (k < 6 ? ((6 - k) * a0 + (k - 1) * a1) / 5 : (k == 6 ? 0 : 255));
+    }
+    unsigned long long indices = 0;
+    for (unsigned int b = 0; b < 6; ++b) {
+      indices |= static_cast<unsigned long long>(in[2 + b]) << (8 * b);
+    }
+    for (unsigned int i = 0; i < 16; ++i) {
+      out[i][channel] = static_cast<unsigned char>(palette[(indices >> (3 * i)) & 7]);
+    }
+  }
+
+  /** @brief Slo el modo 6, el nico que escribe el codificador; otros modos salen en negro. */
+  void
+  decodeBc7Block(const unsigned char* in, unsigned char out[16][4]) {
+    memset(out, 0, 64);
+    BitReader reader = { in, 0 };
+    if (reader.read(7) != (1u << 6)) {
+      return;
+    }
+    int e[2][4];
+    for (unsigned int c = 0; c < 4; ++c) {
+      e[0][c] = reader.read(7) << 1;
+      e[1][c] = reader.read(7) << 1;
+    }
+    const unsigned int p0 = reader.read(1), p1 = reader.read(1);
+    for (unsigned int c = 0; c < 4; ++c) {
+      e[0][c] |= p0;
+      e[1][c] |= p1;
+    }
+    for (unsigned int i = 0; i < 16; ++i) {
+      const int w = kBc7Weights[reader.read(i == 0 ? 3 : 4)];
+      for (unsigned int c = 0; c < 4; ++c) {
+        out[i][c] = static_cast<unsigned char>(((64 - w) * e[0][c] + w * e[1][c] + 32) >> 6);
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  // Cadenas
+  // -----------------------------------------------------------------------------
+
+  /** @brief Distribucin de los niveles de una cadena comprimida; devuelve el tamao total. */
+  size_t
+  layoutLevels(unsigned int width, unsigned int height, unsigned int levelCount,
+               unsigned int blockBytes, std::vector<CompressedLevel>& levels) {
+    levels.resize(levelCount);
+    size_t total = 0;
+    for (unsigned int i = 0; i < levelCount; ++i) {
+      CompressedLevel& level = levels[i];
+      level.width = (width >> i) > 0 ? (width >> i) : 1;
+      level.height = (height >> i) > 0 ? (height >> i) : 1;
+      level.rowPitch = ((level.width + 3) / 4) * blockBytes;
+      level.offset = total;
+      total += static_cast<size_t>(level.rowPitch) * ((level.height + 3) / 4);
+    }
+    return total;
+  }
+
+  void
+  addTotals(const BcStats& stats) {
+    std::lock_guard<std::mutex> lock(g_totalsMutex);
+    g_totals.blocks += stats.blocks;
+    g_totals.pixels += stats.pixels;
+    g_totals.ms += stats.ms;
+  }
+}
+
+const char*
+BlockCompressor::getName(BcFormat format) {
+  switch (format) {
+  case BcFormat::BC1: return "BC1";
+  case BcFormat::BC3: return "BC3";
+  case BcFormat::BC4: return "BC4";
+  case BcFormat::BC5: return "BC5";
+  case BcFormat::BC7: return "BC7";
+  default: return "RGBA8";
+  }
+}
+
+DXGI_FORMAT
+BlockCompressor::getDxgiFormat(BcFormat format) {
+  switch (format) {
+  case BcFormat::BC1: return DXGI_FORMAT_BC1_UNORM;
+  case BcFormat::BC3: return DXGI_FORMAT_BC3_UNORM;
+  case BcFormat::BC4: return DXGI_FORMAT_BC4_UNORM;
+  case BcFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+  case BcFormat::BC7: return DXGI_FORMAT_BC7_UNORM;
+  default: return DXGI_FORMAT_R8G8B8A8_UNORM;
+  }
+}
+
+unsigned int
+BlockCompressor::getBlockBytes(BcFormat format) {
+  switch (format) {
+  case BcFormat::BC1:
+  case BcFormat::BC4:
+    return 8;
+  case BcFormat::BC3:
+  case BcFormat::BC5:
+  case BcFormat::BC7:
+    return 16;
+  default:
+    return 0;
+  }
+}
+
+bool
+BlockCompressor::compress(const unsigned char* rgba,
+                          unsigned int width,
+                          unsigned int height,
+                          const BcSettings& settings,
+                          unsigned char* out,
+                          BcStats* stats) {
+  PROFILE_SCOPE("BlockCompressor::compress");
+  const unsigned int blockBytes = getBlockBytes(settings.format);
+  if (!rgba || !out || blockBytes == 0 || width == 0 || height == 0) {
+    return false;
+  }
+  const auto begin = std::chrono::steady_clock::now();
+  const unsigned int blocksX = (width + 3) / 4;
+  const unsigned int blocksY = (height + 3) / 4;
+  const BcFormat format = settings.format;
+
+  // Una tarea por fila de bloques
+  auto encodeRow = [&](unsigned int by) {
+    Block block;
+    unsigned char* dst = out + static_cast<size_t>(by) * blocksX * blockBytes;
+    for (unsigned int bx = 0; bx < blocksX; ++bx, dst += blockBytes) {
+      loadBlock(rgba, width, height, bx, by, block);
+      switch (format) {
+      case BcFormat::BC1:
+        encodeColorBlock(block, dst);
+        break;
+      case BcFormat::BC3:
+        encodeChannelBlock(block, 3, dst);
+        encodeColorBlock(block, dst + 8);
+        break;
+      case BcFormat::BC4:
+        encodeChannelBlock(block, 0, dst);
+        break;
+      case BcFormat::BC5:
+        encodeChannelBlock(block, 0, dst);
+        encodeChannelBlock(block, 1, dst + 8);
+        break;
+      case BcFormat::BC7:
+        encodeBc7Block(block, dst);
+        break;
+      default:
+        break;
+      }
+    }
+  };
+  if (settings.threadPool && blocksX * blocksY >= settings.minParallelBlocks) {
+    settings.threadPool->parallelFor(blocksY, encodeRow);
+  }
+  else {
+    for (unsigned int by = 0; by < blocksY; ++by) {
+      encodeRow(by);
+    }
+  }
+
+  BcStats result;
+  result.blocks = static_cast<unsigned long long>(blocksX) * blocksY;
+  result.pixels = static_cast<unsigned long long>(width) * height;
+  result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+  if (stats) {
+    *stats = result;
+  }
+  addTotals(result);
+  return true;
+}
+
+bool
+BlockCompressor::compressChain(const MipChain& chain,
+                               const BcSettings& settings,
+                               CompressedTexture& out,
+                               BcStats* stats) {
+  const unsigned int blockBytes = getBlockBytes(settings.format);
+  out.format = settings.format;
+  out.data.clear();
+  out.levels.clear();
+  if (blockBytes == 0 || chain.levels.empty()) {
+    return false;
+  }
+  const size_t total = layoutLevels(chain.levels[0].width, chain.levels[0].height,
+                                    static_cast<unsigned int>(chain.levels.size()), blockBytes, out.levels);
+  out.data.resize(total);
+
+  BcStats sum;
+  for (size_t i = 0; i < chain.levels.size(); ++i) {
+    const MipLevel& level = chain.levels[i];
+    BcStats levelStats;
+    compress(chain.data.data() + level.offset, level.width, level.height, settings,
+             out.data.data() + out.levels[i].offset, &levelStats);
+    sum.blocks += levelStats.blocks;
+    sum.pixels += levelStats.pixels;
+    sum.ms += levelStats.ms;
+  }
+  if (stats) {
+    *stats = sum;
+  }
+  return true;
+}
+
+void
+BlockCompressor::decompress(const unsigned char* blocks,
+                            unsigned int width,
+                            unsigned int height,
+                            BcFormat format,
+                            std::vector<unsigned char>& rgba) {
+  const unsigned int blockBytes = getBlockBytes(format);
+  rgba.assign(static_cast<size_t>(width) * height * 4, 0);
+  if (!blocks || blockBytes == 0) {
+    return;
+  }
+  const unsigned int blocksX = (width + 3) / 4;
+  const unsigned int blocksY = (height + 3) / 4;
+  for (unsigned int by = 0; by < blocksY; ++by) {
+    for (unsigned int bx = 0; bx < blocksX; ++bx) {
+      const unsigned char* in = blocks + (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+      unsigned char texels[16][4] = {};
+      for (unsigned int i = 0; i < 16; ++i) {
+        texels[i][3] = 255;
+      }
+      switch (format) {
+      case BcFormat::BC1:
+        decodeColorBlock(in, false, texels);
+        break;
+      case BcFormat::BC3:
+        decodeColorBlock(in + 8, true, texels);
+        decodeChannelBlock(in, 3, texels);
+        break;
+      case BcFormat::BC4:
+        decodeChannelBlock(in, 0, texels);
+        break;
+      case BcFormat::BC5:
+        decodeChannelBlock(in, 0, texels);
+        decodeChannelBlock(in + 8, 1, texels);
+        break;
+      case BcFormat::BC7:
+        decodeBc7Block(in, texels);
+        break;
+      default:
+        break;
+      }
+      for (unsigned int y = 0; y < 4 && by * 4 + y < height; ++y) {
+        for (unsigned int x = 0; x < 4 && bx * 4 + x < width; ++x) {
+          memcpy(&rgba[((static_cast<size_t>(by) * 4 + y) * width + bx * 4 + x) * 4], texels[y * 4 + x], 4);
+        }
+      }
+    }
+  }
+}
+
+double
+BlockCompressor::computePsnr(const unsigned char* original,
+                             const unsigned char* blocks,
+                             unsigned int width,
+                             unsigned int height,
+                             BcFormat format) {
+  std::vector<unsigned char> decoded;
+  decompress(blocks, width, height, format, decoded);
+  // Canales que guarda cada formato (BC1 descarta el alfa)
+  unsigned int count = 4;
+  switch (format) {
+  case BcFormat::BC1: count = 3; break;
+  case BcFormat::BC4: count = 1; break;
+  case BcFormat::BC5: count = 2; break;
+  default: break;
+  }
+  double squared = 0.0;
+  const size_t pixels = static_cast<size_t>(width) * height;
+  for (size_t i = 0; i < pixels; ++i) {
+    for (unsigned int c = 0; c < count; ++c) {
+      const double d = static_cast<double>(original[i * 4 + c]) - decoded[i * 4 + c];
+      squared += d * d;
+    }
+  }
+  const double mse = pixels > 0 ? squared / (pixels * count) : 0.0;
+  return mse > 0.0 ? 10.0 * log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+BcStats
+BlockCompressor::getTotals() {
+  std::lock_guard<std::mutex> lock(g_totalsMutex);
+  return g_totals;
+}
@@ -1,6 +1,7 @@
 #include "Buffer.h"
 #include "Device.h"
 #include "DeviceContext.h"
+#include "EngineUtilities/Utilities/EngineStats.h"
 
 HRESULT
 Buffer::init(Device& device, const MeshComponent& mesh, unsigned int bindFlag) {
@@ -61,6 +62,56 @@ Buffer::init(Device& device, unsigned int ByteWidth) {
 	return createBuffer(device, desc, nullptr);
 }
 
+HRESULT
+Buffer::initDynamic(Device& device,
+	unsigned int stride,
+	unsigned int elementCount,
+	unsigned int bindFlag) {
+	if (!device.m_device) {
+		ERROR("Buffer", "initDynamic", "Device is null.");
+		return E_POINTER;
+	}
+	if (stride == 0 || elementCount == 0) {
+		ERROR("Buffer", "initDynamic", "stride or elementCount is zero");
+		return E_INVALIDARG;
+	}
+	m_stride = stride;
+
+	D3D11_BUFFER_DESC desc = {};
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.ByteWidth = stride * elementCount;
+	desc.BindFlags = bindFlag;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	m_bindFlag = desc.BindFlags;
+
+	return createBuffer(device, desc, nullptr);
+}
+
+HRESULT
+Buffer::initDefault(Device& device,
+	unsigned int stride,
+	unsigned int elementCount,
+	unsigned int bindFlag) {
+	if (!device.m_device) {
+		ERROR("Buffer", "initDefault", "Device is null.");
+		return E_POINTER;
+	}
+	if (stride == 0 || elementCount == 0) {
+		ERROR("Buffer", "initDefault", "stride or elementCount is zero");
+		return E_INVALIDARG;
+	}
+	m_stride = stride;
+
+	D3D11_BUFFER_DESC desc = {};
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.ByteWidth = stride * elementCount;
+	desc.BindFlags = bindFlag;
+	desc.CPUAccessFlags = 0;
+	m_bindFlag = desc.BindFlags;
+
+	return createBuffer(device, desc, nullptr);
+}
+
 void
 Buffer::update(DeviceContext& deviceContext,
 	ID3D11Resource* pDstResource,
@@ -77,12 +128,14 @@ Buffer::update(DeviceContext& deviceContext,
 		ERROR("ShaderProgram", "update", "pSrcData is null.");
 		return;
 	}
-	deviceContext.m_deviceContext->UpdateSubresource(m_buffer,
+	deviceContext.UpdateSubresource(m_buffer,
 		DstSubresource,
 		pDstBox,
 		pSrcData,
 		SrcRowPitch,
 		SrcDepthPitch);
+	ENGINE_STAT_ADD("buffer_uploads", 1);
+	ENGINE_STAT_ADD("buffer_upload_bytes", pDstBox ? pDstBox->right - pDstBox->left : m_byteWidth);
 
 
 }
@@ -104,16 +157,16 @@ Buffer::render(DeviceContext& deviceContext,
 
 	switch (m_bindFlag) {
 	case D3D11_BIND_VERTEX_BUFFER:
-		deviceContext.m_deviceContext->IASetVertexBuffers(StartSlot, NumBuffers, &m_buffer, &m_stride, &m_offset);
+		deviceContext.IASetVertexBuffers(StartSlot, NumBuffers, &m_buffer, &m_stride, &m_offset);
 		break;
 	case D3D11_BIND_CONSTANT_BUFFER:
-		deviceContext.m_deviceContext->VSSetConstantBuffers(StartSlot, NumBuffers, &m_buffer);
+		deviceContext.VSSetConstantBuffers(StartSlot, NumBuffers, &m_buffer);
 		if (setPixelShader) {
-			deviceContext.m_deviceContext->PSSetConstantBuffers(StartSlot, NumBuffers, &m_buffer);
+			deviceContext.PSSetConstantBuffers(StartSlot, NumBuffers, &m_buffer);
 		}
 		break;
 	case D3D11_BIND_INDEX_BUFFER:
-		deviceContext.m_deviceContext->IASetIndexBuffer(m_buffer, format, m_offset);
+		deviceContext.IASetIndexBuffer(m_buffer, format, m_offset);
 		break;
 	default:
 		ERROR("Buffer", "render", "Unsupported BindFlag");
@@ -123,7 +176,12 @@ Buffer::render(DeviceContext& deviceContext,
 
 void
 Buffer::destroy() {
-	SAFE_RELEASE(m_buffer);
+	// Las copias comparten el buffer: slo la ltima referencia descuenta la memoria
+	if (m_buffer && m_buffer->Release() == 0) {
+		ENGINE_GAUGE_ADD("buffers", -1);
+		ENGINE_GAUGE_ADD("buffer_bytes", -static_cast<long long>(m_byteWidth));
+	}
+	m_buffer = nullptr;
 }
 
 HRESULT
@@ -140,5 +198,8 @@ Buffer::createBuffer(Device& device,
 		ERROR("Buffer", "createBuffer", "Failed to create buffer");
 		return hr;
 	}
+	m_byteWidth = desc.ByteWidth;
+	ENGINE_GAUGE_ADD("buffers", 1);
+	ENGINE_GAUGE_ADD("buffer_bytes", m_byteWidth);
 	return S_OK;
 }
@@ -127,3 +127,40 @@ Camera::updateViewMatrix() {
 	XMStoreFloat4x4(&m_view, view);
 	m_viewDirty = false;
 }
+
+void 
+Camera::computeCascadeSplits(unsigned int count, float maxDistance, float lambda, float* splits) const {
+	const float nearZ = m_nearPlane;
+	const float farZ = (maxDistance > nearZ && maxDistance < m_farPlane) ? maxDistance : m_farPlane;
+	splits[0] = nearZ;
+	for (unsigned int i = 1; i <= count; ++i) {
+		// Logartmico reparte la resolucin como la perspectiva; uniforme evita cascadas diminutas cerca
+		float p = static_cast<float>(i) / static_cast<float>(count);
+		float logSplit = nearZ * powf(farZ / nearZ, p);
+		float uniformSplit = nearZ + (farZ - nearZ) * p;
+		splits[i] = lambda * logSplit + (1.0f - lambda) * uniformSplit;
+	}
+	splits[count] = farZ;
+}
+
+void 
+Camera::getFrustumCorners(float nearZ, float farZ, XMFLOAT3* corners) const {
+	XMVECTOR R = XMVectorSet(m_right.x, m_right.y, m_right.z, 0.0f);
+	XMVECTOR U = XMVectorSet(m_up.x, m_up.y, m_up.z, 0.0f);
+	XMVECTOR F = XMVectorSet(m_forward.x, m_forward.y, m_forward.z, 0.0f);
+	XMVECTOR P = XMVectorSet(m_position.x, m_position.y, m_position.z, 1.0f);
+
+	const float tanHalfY = tanf(m_fovY * 0.5f);
+	const float tanHalfX = tanHalfY * m_aspectRatio;
+	const float distances[2] = { nearZ, farZ };
+	for (unsigned int plane = 0; plane < 2; ++plane) {
+		const float d = distances[plane];
+		XMVECTOR center = XMVectorAdd(P, XMVectorScale(F, d));
+		XMVECTOR x = XMVectorScale(R, d * tanHalfX);
+		XMVECTOR y = XMVectorScale(U, d * tanHalfY);
+		XMStoreFloat3(&corners[plane * 4 + 0], XMVectorSubtract(XMVectorSubtract(center, x), y));
+		XMStoreFloat3(&corners[plane * 4 + 1], XMVectorSubtract(XMVectorAdd(center, x), y));
+		XMStoreFloat3(&corners[plane * 4 + 2], XMVectorAdd(XMVectorAdd(center, x), y));
+		XMStoreFloat3(&corners[plane * 4 + 3], XMVectorAdd(XMVectorSubtract(center, x), y));
+	}
+}
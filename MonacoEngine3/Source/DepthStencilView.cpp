@@ -21,7 +21,7 @@ DepthStencilView::init(Device& device, Texture& depthStencil, DXGI_FORMAT format
 	descDSV.Texture2D.MipSlice = 0;
 
 	// Create depth stencil view
-	HRESULT hr = device.m_device->CreateDepthStencilView(depthStencil.m_texture,
+	HRESULT hr = device.CreateDepthStencilView(depthStencil.m_texture,
 		&descDSV,
 		&m_depthStencilView);
 
@@ -43,7 +43,7 @@ DepthStencilView::render(DeviceContext& deviceContext) {
 	}
 
 	// Clear depth stencil view
-	deviceContext.m_deviceContext->ClearDepthStencilView(m_depthStencilView,
+	deviceContext.ClearDepthStencilView(m_depthStencilView,
 		D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL,
 		1.0f,
 		0);
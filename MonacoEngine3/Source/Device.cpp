@@ -1,13 +1,20 @@
 #include "Device.h"
+#include "RHI/IRenderBackend.h"
 
 void Device::destroy() {
   SAFE_RELEASE(m_device);
+  m_backend = nullptr;
 }
 //CreateRenderTargetView
 HRESULT Device::CreateRenderTargetView(ID3D11Resource* pResource,
                                        const D3D11_RENDER_TARGET_VIEW_DESC* pDesc,
                                        ID3D11RenderTargetView** ppRTView) {
   // Validar parametros de entrada
+  if (!m_backend) {
+    ERROR("Device", "CreateRenderTargetView", "m_backend is nullptr");
+    return E_FAIL;
+  }
+
   if (!pResource) {
     ERROR("Device", "CreateRenderTargetView", "pResource is nullptr");
     return E_INVALIDARG;
@@ -19,7 +26,7 @@ HRESULT Device::CreateRenderTargetView(ID3D11Resource* pResource,
   }
 
   // Crear el Render Target View
-  HRESULT hr = m_device->CreateRenderTargetView(pResource, pDesc, ppRTView);
+  HRESULT hr = m_backend->CreateRenderTargetView(pResource, pDesc, ppRTView);
 
   if (SUCCEEDED(hr)) {
     MESSAGE("Device", "CreateRenderTargetView",
@@ -40,8 +47,8 @@ HRESULT Device::CreateTexture2D(
                 const D3D11_SUBRESOURCE_DATA* pInitialData,
                 ID3D11Texture2D** ppTexture2D)
 {
-  if (!m_device) {
-    ERROR("Device", "CreateTexture2D", "m_device is nullptr");
+  if (!m_backend) {
+    ERROR("Device", "CreateTexture2D", "m_backend is nullptr");
     return E_FAIL;
   }
 
@@ -55,7 +62,7 @@ HRESULT Device::CreateTexture2D(
     return E_POINTER;
   }
 
-  HRESULT hr = m_device->CreateTexture2D(pDesc, pInitialData, ppTexture2D);
+  HRESULT hr = m_backend->CreateTexture2D(pDesc, pInitialData, ppTexture2D);
 
   if (SUCCEEDED(hr)) {
     MESSAGE("Device", "CreateTexture2D",
@@ -76,8 +83,8 @@ HRESULT Device::CreateDepthStencilView(
                 const D3D11_DEPTH_STENCIL_VIEW_DESC* pDesc,
                 ID3D11DepthStencilView** ppDepthStencilView)
 {
-  if (!m_device) {
-    ERROR("Device", "CreateDepthStencilView", "m_device is nullptr");
+  if (!m_backend) {
+    ERROR("Device", "CreateDepthStencilView", "m_backend is nullptr");
     return E_FAIL;
   }
 
@@ -91,7 +98,7 @@ HRESULT Device::CreateDepthStencilView(
     return E_POINTER;
   }
 
-  HRESULT hr = m_device->CreateDepthStencilView(pResource, pDesc, ppDepthStencilView);
+  HRESULT hr = m_backend->CreateDepthStencilView(pResource, pDesc, ppDepthStencilView);
 
   if (SUCCEEDED(hr)) {
     MESSAGE("Device", "CreateDepthStencilView",
@@ -113,8 +120,8 @@ HRESULT Device::CreateVertexShader(
                 ID3D11ClassLinkage* pClassLinkage,
                 ID3D11VertexShader** ppVertexShader)
 {
-  if (!m_device) {
-    ERROR("Device", "CreateVertexShader", "m_device is nullptr");
+  if (!m_backend) {
+    ERROR("Device", "CreateVertexShader", "m_backend is nullptr");
     return E_FAIL;
   }
   if (!pShaderBytecode) {
@@ -126,7 +133,7 @@ HRESULT Device::CreateVertexShader(
     return E_POINTER;
   }
 
-  HRESULT hr = m_device->CreateVertexShader(
+  HRESULT hr = m_backend->CreateVertexShader(
     pShaderBytecode, BytecodeLength, pClassLinkage, ppVertexShader);
 
   if (SUCCEEDED(hr)) {
@@ -146,8 +153,8 @@ HRESULT Device::CreateInputLayout(
                 SIZE_T BytecodeLength,
                 ID3D11InputLayout** ppInputLayout)
 {
-  if (!m_device) {
-    ERROR("Device", "CreateInputLayout", "m_device is nullptr");
+  if (!m_backend) {
+    ERROR("Device", "CreateInputLayout", "m_backend is nullptr");
     return E_FAIL;
   }
   if (!pInputElementDescs) {
@@ -163,7 +170,7 @@ HRESULT Device::CreateInputLayout(
     return E_POINTER;
   }
 
-  HRESULT hr = m_device->CreateInputLayout(
+  HRESULT hr = m_backend->CreateInputLayout(
     pInputElementDescs, NumElements,
     pShaderBytecodeWithInputSignature, BytecodeLength, ppInputLayout);
 
@@ -183,8 +190,8 @@ HRESULT Device::CreatePixelShader(
                 ID3D11ClassLinkage* pClassLinkage,
                 ID3D11PixelShader** ppPixelShader)
 {
-  if (!m_device) {
-    ERROR("Device", "CreatePixelShader", "m_device is nullptr");
+  if (!m_backend) {
+    ERROR("Device", "CreatePixelShader", "m_backend is nullptr");
     return E_FAIL;
   }
   if (!pShaderBytecode) {
@@ -196,7 +203,7 @@ HRESULT Device::CreatePixelShader(
     return E_POINTER;
   }
 
-  HRESULT hr = m_device->CreatePixelShader(
+  HRESULT hr = m_backend->CreatePixelShader(
     pShaderBytecode, BytecodeLength, pClassLinkage, ppPixelShader);
 
   if (SUCCEEDED(hr)) {
@@ -214,8 +221,8 @@ HRESULT Device::CreateBuffer(
                 const D3D11_SUBRESOURCE_DATA* pInitialData,
                 ID3D11Buffer** ppBuffer)
 {
-  if (!m_device) {
-    ERROR("Device", "CreateBuffer", "m_device is nullptr");
+  if (!m_backend) {
+    ERROR("Device", "CreateBuffer", "m_backend is nullptr");
     return E_FAIL;
   }
   if (!pDesc) {
@@ -227,7 +234,7 @@ HRESULT Device::CreateBuffer(
     return E_POINTER;
   }
 
-  HRESULT hr = m_device->CreateBuffer(pDesc, pInitialData, ppBuffer);
+  HRESULT hr = m_backend->CreateBuffer(pDesc, pInitialData, ppBuffer);
 
   if (SUCCEEDED(hr)) {
     MESSAGE("Device", "CreateBuffer", "Buffer created successfully!");
@@ -243,8 +250,8 @@ HRESULT Device::CreateSamplerState(
                 const D3D11_SAMPLER_DESC* pSamplerDesc,
                 ID3D11SamplerState** ppSamplerState)
 {
-  if (!m_device) {
-    ERROR("Device", "CreateSamplerState", "m_device is nullptr");
+  if (!m_backend) {
+    ERROR("Device", "CreateSamplerState", "m_backend is nullptr");
     return E_FAIL;
   }
   if (!pSamplerDesc) {
@@ -256,7 +263,7 @@ HRESULT Device::CreateSamplerState(
     return E_POINTER;
   }
 
-  HRESULT hr = m_device->CreateSamplerState(pSamplerDesc, ppSamplerState);
+  HRESULT hr = m_backend->CreateSamplerState(pSamplerDesc, ppSamplerState);
 
   if (SUCCEEDED(hr)) {
     MESSAGE("Device", "CreateSamplerState", "SamplerState created successfully!");
@@ -267,3 +274,192 @@ HRESULT Device::CreateSamplerState(
   }
   return hr;
 }
+
+HRESULT Device::CreateBlendState(
+                const D3D11_BLEND_DESC* pBlendStateDesc,
+                ID3D11BlendState** ppBlendState)
+{
+  if (!m_backend) {
+    ERROR("Device", "CreateBlendState", "m_backend is nullptr");
+    return E_FAIL;
+  }
+  if (!pBlendStateDesc) {
+    ERROR("Device", "CreateBlendState", "pBlendStateDesc is nullptr");
+    return E_INVALIDARG;
+  }
+  if (!ppBlendState) {
+    ERROR("Device", "CreateBlendState", "ppBlendState is nullptr");
+    return E_POINTER;
+  }
+
+  HRESULT hr = m_backend->CreateBlendState(pBlendStateDesc, ppBlendState);
+
+  if (SUCCEEDED(hr)) {
+    MESSAGE("Device", "CreateBlendState", "BlendState created successfully!");
+  }
+  else {
+    ERROR("Device", "CreateBlendState",
+      ("Failed to create BlendState. HRESULT: " + std::to_string(hr)).c_str());
+  }
+  return hr;
+}
+
+HRESULT Device::CreateRasterizerState(
+                const D3D11_RASTERIZER_DESC* pRasterizerDesc,
+                ID3D11RasterizerState** ppRasterizerState)
+{
+  if (!m_backend) {
+    ERROR("Device", "CreateRasterizerState", "m_backend is nullptr");
+    return E_FAIL;
+  }
+  if (!pRasterizerDesc) {
+    ERROR("Device", "CreateRasterizerState", "pRasterizerDesc is nullptr");
+    return E_INVALIDARG;
+  }
+  if (!ppRasterizerState) {
+    ERROR("Device", "CreateRasterizerState", "ppRasterizerState is nullptr");
+    return E_POINTER;
+  }
+
+  HRESULT hr = m_backend->CreateRasterizerState(pRasterizerDesc, ppRasterizerState);
+
+  if (SUCCEEDED(hr)) {
+    MESSAGE("Device", "CreateRasterizerState", "RasterizerState created successfully!");
+  }
+  else {
+    ERROR("Device", "CreateRasterizerState",
+      ("Failed to create RasterizerState. HRESULT: " + std::to_string(hr)).c_str());
+  }
+  return hr;
+}
+
+HRESULT Device::CreateDepthStencilState(
+                const D3D11_DEPTH_STENCIL_DESC* pDepthStencilDesc,
+                ID3D11DepthStencilState** ppDepthStencilState)
+{
+  if (!m_backend) {
+    ERROR("Device", "CreateDepthStencilState", "m_backend is nullptr");
+    return E_FAIL;
+  }
+  if (!pDepthStencilDesc) {
+    ERROR("Device", "CreateDepthStencilState", "pDepthStencilDesc is nullptr");
+    return E_INVALIDARG;
+  }
+  if (!ppDepthStencilState) {
+    ERROR("Device", "CreateDepthStencilState", "ppDepthStencilState is nullptr");
+    return E_POINTER;
+  }
+
+  HRESULT hr = m_backend->CreateDepthStencilState(pDepthStencilDesc, ppDepthStencilState);
+
+  if (SUCCEEDED(hr)) {
+    MESSAGE("Device", "CreateDepthStencilState", "DepthStencilState created successfully!");
+  }
+  else {
+    ERROR("Device", "CreateDepthStencilState",
+      ("Failed to create DepthStencilState. HRESULT: " + std::to_string(hr)).c_str());
+  }
+  return hr;
+}
+
+HRESULT Device::CreateShaderResourceView(
+                ID3D11Resource* pResource,
+                const D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc,
+                ID3D11ShaderResourceView** ppSRView)
+{
+  if (!m_backend) {
+    ERROR("Device", "CreateShaderResourceView", "m_backend is nullptr");
+    return E_FAIL;
+  }
+  if (!pResource) {
+    ERROR("Device", "CreateShaderResourceView", "pResource is nullptr");
+    return E_INVALIDARG;
+  }
+  if (!ppSRView) {
+    ERROR("Device", "CreateShaderResourceView", "ppSRView is nullptr");
+    return E_POINTER;
+  }
+
+  HRESULT hr = m_backend->CreateShaderResourceView(pResource, pDesc, ppSRView);
+
+  if (SUCCEEDED(hr)) {
+    MESSAGE("Device", "CreateShaderResourceView", "ShaderResourceView created successfully!");
+  }
+  else {
+    ERROR("Device", "CreateShaderResourceView",
+      ("Failed to create ShaderResourceView. HRESULT: " + std::to_string(hr)).c_str());
+  }
+  return hr;
+}
+
+HRESULT Device::CreateShaderResourceViewFromFile(
+                const std::string& fileName,
+                ID3D11ShaderResourceView** ppSRView)
+{
+  if (!m_backend) {
+    ERROR("Device", "CreateShaderResourceViewFromFile", "m_backend is nullptr");
+    return E_FAIL;
+  }
+  if (fileName.empty()) {
+    ERROR("Device", "CreateShaderResourceViewFromFile", "fileName is empty");
+    return E_INVALIDARG;
+  }
+  if (!ppSRView) {
+    ERROR("Device", "CreateShaderResourceViewFromFile", "ppSRView is nullptr");
+    return E_POINTER;
+  }
+
+  HRESULT hr = m_backend->CreateShaderResourceViewFromFile(fileName, ppSRView);
+
+  if (SUCCEEDED(hr)) {
+    MESSAGE("Device", "CreateShaderResourceViewFromFile", "ShaderResourceView loaded successfully!");
+  }
+  else {
+    ERROR("Device", "CreateShaderResourceViewFromFile",
+      ("Failed to load " + fileName + ". HRESULT: " + std::to_string(hr)).c_str());
+  }
+  return hr;
+}
+
+HRESULT Device::CheckMultisampleQualityLevels(
+                DXGI_FORMAT Format,
+                UINT SampleCount,
+                UINT* pNumQualityLevels)
+{
+  if (!m_backend) {
+    ERROR("Device", "CheckMultisampleQualityLevels", "m_backend is nullptr");
+    return E_FAIL;
+  }
+  if (!pNumQualityLevels) {
+    ERROR("Device", "CheckMultisampleQualityLevels", "pNumQualityLevels is nullptr");
+    return E_POINTER;
+  }
+
+  return m_backend->CheckMultisampleQualityLevels(Format, SampleCount, pNumQualityLevels);
+}
+
+HRESULT Device::CreateQuery(
+                const D3D11_QUERY_DESC* pQueryDesc,
+                ID3D11Query** ppQuery)
+{
+  if (!m_backend) {
+    ERROR("Device", "CreateQuery", "m_backend is nullptr");
+    return E_FAIL;
+  }
+  if (!pQueryDesc) {
+    ERROR("Device", "CreateQuery", "pQueryDesc is nullptr");
+    return E_INVALIDARG;
+  }
+  if (!ppQuery) {
+    ERROR("Device", "CreateQuery", "ppQuery is nullptr");
+    return E_POINTER;
+  }
+
+  // Sin MESSAGE: un profiler crea decenas de consultas y llenara el log
+  HRESULT hr = m_backend->CreateQuery(pQueryDesc, ppQuery);
+  if (FAILED(hr)) {
+    ERROR("Device", "CreateQuery",
+      ("Failed to create Query. HRESULT: " + std::to_string(hr)).c_str());
+  }
+  return hr;
+}
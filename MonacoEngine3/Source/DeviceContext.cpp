@@ -1,60 +1,225 @@
 #include "DeviceContext.h"
+#include "RHI/IRenderBackend.h"
+#include "EngineUtilities/Utilities/EngineStats.h"
+
+namespace {
+	/**
+	 * Busca el sub-rango [first, last) que difiere de la cach.
+	 * Devuelve false si todo el rango ya est enlazado.
+	 */
+	template<typename SameFn>
+	bool
+	findChangedRange(unsigned int count, SameFn same, unsigned int& first, unsigned int& last) {
+		first = 0;
+		while (first < count && same(first)) {
+			++first;
+		}
+		if (first == count) {
+			return false;
+		}
+		last = count;
+		while (last > first + 1 && same(last - 1)) {
+			--last;
+		}
+		return true;
+	}
+}
 
 void
 DeviceContext::destroy() {
 	SAFE_RELEASE(m_deviceContext);
+	m_backend = nullptr;
+	invalidateStateCache();
+}
+
+const void*
+DeviceContext::unknownState() {
+	static const char sentinel = 0;
+	return &sentinel;
+}
+
+void
+DeviceContext::countStateCall() {
+	++m_stateStats.stateCallsIssued;
+	ENGINE_STAT_ADD("state_changes", 1);
+}
+
+void
+DeviceContext::resetStateCache(const void* pointer) {
+	m_bound.inputLayout = pointer;
+	for (unsigned int i = 0; i < kCachedVertexBuffers; ++i) {
+		m_bound.vertexBuffers[i] = pointer;
+		m_bound.vertexStrides[i] = 0;
+		m_bound.vertexOffsets[i] = 0;
+	}
+	m_bound.indexBuffer = pointer;
+	m_bound.indexFormat = DXGI_FORMAT_UNKNOWN;
+	m_bound.indexOffset = 0;
+	// UNDEFINED nunca se enlaza (se rechaza antes), as que sirve tambin como desconocido
+	m_bound.topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	m_bound.vertexShader = pointer;
+	m_bound.pixelShader = pointer;
+	for (unsigned int i = 0; i < kCachedConstantBuffers; ++i) {
+		m_bound.vsConstants.buffers[i] = pointer;
+		m_bound.vsConstants.firstConstant[i] = 0;
+		m_bound.vsConstants.numConstants[i] = 0;
+		m_bound.psConstants.buffers[i] = pointer;
+		m_bound.psConstants.firstConstant[i] = 0;
+		m_bound.psConstants.numConstants[i] = 0;
+	}
+	for (unsigned int i = 0; i < kCachedShaderResources; ++i) {
+		m_bound.psResources[i] = pointer;
+	}
+	for (unsigned int i = 0; i < kCachedSamplers; ++i) {
+		m_bound.psSamplers[i] = pointer;
+	}
+	m_bound.rasterizerState = pointer;
+	m_bound.blendState = pointer;
+	for (unsigned int i = 0; i < 4; ++i) {
+		m_bound.blendFactor[i] = 1.0f;
+	}
+	m_bound.sampleMask = 0xffffffff;
+	m_bound.depthStencilState = pointer;
+	m_bound.stencilRef = 0;
+	// Un conteo imposible fuerza el siguiente bind cuando el estado es desconocido
+	m_bound.numRenderTargets = pointer ? ~0u : 0;
+	for (unsigned int i = 0; i < kCachedRenderTargets; ++i) {
+		m_bound.renderTargets[i] = pointer;
+	}
+	m_bound.depthStencil = pointer;
+	m_bound.numViewports = pointer ? ~0u : 0;
+}
+
+void
+DeviceContext::invalidateStateCache() {
+	resetStateCache(unknownState());
 }
 
 void
 DeviceContext::RSSetViewports(unsigned int NumViewports,
 	                            const D3D11_VIEWPORT* pViewports) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "RSSetViewports", "m_backend is nullptr");
+		return;
+	}
 	if (!pViewports) {
 		ERROR("DeviceContext", "RSSetViewports", "pViewports is nullptr");
 		return;
 	}
-	m_deviceContext->RSSetViewports(NumViewports, pViewports);
+	if (NumViewports <= kCachedViewports) {
+		if (m_stateFiltering && NumViewports == m_bound.numViewports &&
+			  memcmp(m_bound.viewports, pViewports, NumViewports * sizeof(D3D11_VIEWPORT)) == 0) {
+			++m_stateStats.stateCallsFiltered;
+			return;
+		}
+		m_bound.numViewports = NumViewports;
+		memcpy(m_bound.viewports, pViewports, NumViewports * sizeof(D3D11_VIEWPORT));
+	}
+	else {
+		m_bound.numViewports = ~0u;
+	}
+	countStateCall();
+	m_backend->RSSetViewports(NumViewports, pViewports);
 }
 
 void
 DeviceContext::PSSetShaderResources(unsigned int StartSlot,
 	                                  unsigned int NumViews,
 	                                  ID3D11ShaderResourceView* const* ppShaderResourceViews) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "PSSetShaderResources", "m_backend is nullptr");
+		return;
+	}
 	if (!ppShaderResourceViews) {
 		ERROR("DeviceContext", "PSSetShaderResources", "ppShaderResourceViews is nullptr");
 		return;
 	}
-	m_deviceContext->PSSetShaderResources(StartSlot, NumViews, ppShaderResourceViews);
+	unsigned int first = 0;
+	unsigned int last = NumViews;
+	if (StartSlot + NumViews <= kCachedShaderResources) {
+		auto same = [&](unsigned int i) { return m_bound.psResources[StartSlot + i] == ppShaderResourceViews[i]; };
+		if (m_stateFiltering && !findChangedRange(NumViews, same, first, last)) {
+			++m_stateStats.stateCallsFiltered;
+			return;
+		}
+	}
+	for (unsigned int i = 0; i < NumViews && StartSlot + i < kCachedShaderResources; ++i) {
+		m_bound.psResources[StartSlot + i] = ppShaderResourceViews[i];
+	}
+	countStateCall();
+	m_backend->PSSetShaderResources(StartSlot + first, last - first, ppShaderResourceViews + first);
 }
 
 void
 DeviceContext::IASetInputLayout(ID3D11InputLayout* pInputLayout) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "IASetInputLayout", "m_backend is nullptr");
+		return;
+	}
 	if (!pInputLayout) {
 		ERROR("DeviceContext", "IASetInputLayout", "pInputLayout is nullptr");
 		return;
 	}
-	m_deviceContext->IASetInputLayout(pInputLayout);
+	if (m_stateFiltering && m_bound.inputLayout == pInputLayout) {
+		++m_stateStats.stateCallsFiltered;
+		return;
+	}
+	m_bound.inputLayout = pInputLayout;
+	countStateCall();
+	m_backend->IASetInputLayout(pInputLayout);
 }
 
 void
 DeviceContext::VSSetShader(ID3D11VertexShader* pVertexShader,
 	                         ID3D11ClassInstance* const* ppClassInstances,
 	                         unsigned int NumClassInstances) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "VSSetShader", "m_backend is nullptr");
+		return;
+	}
 	if (!pVertexShader) {
 		ERROR("DeviceContext", "VSSetShader", "pVertexShader is nullptr");
 		return;
 	}
-	m_deviceContext->VSSetShader(pVertexShader, ppClassInstances, NumClassInstances);
+	// Con class instances no basta con comparar el puntero
+	if (NumClassInstances == 0) {
+		if (m_stateFiltering && m_bound.vertexShader == pVertexShader) {
+			++m_stateStats.stateCallsFiltered;
+			return;
+		}
+		m_bound.vertexShader = pVertexShader;
+	}
+	else {
+		m_bound.vertexShader = unknownState();
+	}
+	countStateCall();
+	m_backend->VSSetShader(pVertexShader, ppClassInstances, NumClassInstances);
 }
 
 void
 DeviceContext::PSSetShader(ID3D11PixelShader* pPixelShader,
 	ID3D11ClassInstance* const* ppClassInstances,
 	unsigned int NumClassInstances) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "PSSetShader", "m_backend is nullptr");
+		return;
+	}
 	if (!pPixelShader) {
 		ERROR("DeviceContext", "PSSetShader", "pPixelShader is nullptr");
 		return;
 	}
-	m_deviceContext->PSSetShader(pPixelShader, ppClassInstances, NumClassInstances);
+	if (NumClassInstances == 0) {
+		if (m_stateFiltering && m_bound.pixelShader == pPixelShader) {
+			++m_stateStats.stateCallsFiltered;
+			return;
+		}
+		m_bound.pixelShader = pPixelShader;
+	}
+	else {
+		m_bound.pixelShader = unknownState();
+	}
+	countStateCall();
+	m_backend->PSSetShader(pPixelShader, ppClassInstances, NumClassInstances);
 }
 
 void
@@ -64,12 +229,16 @@ DeviceContext::UpdateSubresource(ID3D11Resource* pDstResource,
 	const void* pSrcData,
 	unsigned int SrcRowPitch,
 	unsigned int SrcDepthPitch) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "UpdateSubresource", "m_backend is nullptr");
+		return;
+	}
 	if (!pDstResource || !pSrcData) {
 		ERROR("DeviceContext", "UpdateSubresource",
 			"Invalid arguments: pDstResource or pSrcData is nullptr");
 		return;
 	}
-	m_deviceContext->UpdateSubresource(pDstResource,
+	m_backend->UpdateSubresource(pDstResource,
 		DstSubresource,
 		pDstBox,
 		pSrcData,
@@ -77,70 +246,204 @@ DeviceContext::UpdateSubresource(ID3D11Resource* pDstResource,
 		SrcDepthPitch);
 }
 
+void
+DeviceContext::CopySubresourceRegion(ID3D11Resource* pDstResource,
+	unsigned int DstSubresource,
+	unsigned int DstX,
+	unsigned int DstY,
+	unsigned int DstZ,
+	ID3D11Resource* pSrcResource,
+	unsigned int SrcSubresource,
+	const D3D11_BOX* pSrcBox) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "CopySubresourceRegion", "m_backend is nullptr");
+		return;
+	}
+	if (!pDstResource || !pSrcResource) {
+		ERROR("DeviceContext", "CopySubresourceRegion",
+			"Invalid arguments: pDstResource or pSrcResource is nullptr");
+		return;
+	}
+	m_backend->CopySubresourceRegion(pDstResource,
+		DstSubresource,
+		DstX,
+		DstY,
+		DstZ,
+		pSrcResource,
+		SrcSubresource,
+		pSrcBox);
+}
+
 void
 DeviceContext::IASetVertexBuffers(unsigned int StartSlot,
 	unsigned int NumBuffers,
 	ID3D11Buffer* const* ppVertexBuffers,
 	const unsigned int* pStrides,
 	const unsigned int* pOffsets) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "IASetVertexBuffers", "m_backend is nullptr");
+		return;
+	}
 	if (!ppVertexBuffers || !pStrides || !pOffsets) {
 		ERROR("DeviceContext", "IASetVertexBuffers",
 			"Invalid arguments: ppVertexBuffers, pStrides, or pOffsets is nullptr");
 		return;
 	}
-	m_deviceContext->IASetVertexBuffers(StartSlot,
-		NumBuffers,
-		ppVertexBuffers,
-		pStrides,
-		pOffsets);
+	unsigned int first = 0;
+	unsigned int last = NumBuffers;
+	if (StartSlot + NumBuffers <= kCachedVertexBuffers) {
+		auto same = [&](unsigned int i) {
+			unsigned int slot = StartSlot + i;
+			return m_bound.vertexBuffers[slot] == ppVertexBuffers[i] &&
+				     m_bound.vertexStrides[slot] == pStrides[i] &&
+				     m_bound.vertexOffsets[slot] == pOffsets[i];
+		};
+		if (m_stateFiltering && !findChangedRange(NumBuffers, same, first, last)) {
+			++m_stateStats.stateCallsFiltered;
+			return;
+		}
+	}
+	for (unsigned int i = 0; i < NumBuffers && StartSlot + i < kCachedVertexBuffers; ++i) {
+		m_bound.vertexBuffers[StartSlot + i] = ppVertexBuffers[i];
+		m_bound.vertexStrides[StartSlot + i] = pStrides[i];
+		m_bound.vertexOffsets[StartSlot + i] = pOffsets[i];
+	}
+	countStateCall();
+	m_backend->IASetVertexBuffers(StartSlot + first,
+		last - first,
+		ppVertexBuffers + first,
+		pStrides + first,
+		pOffsets + first);
 }
 
 void
 DeviceContext::IASetIndexBuffer(ID3D11Buffer* pIndexBuffer,
 	                              DXGI_FORMAT Format,
 	                              unsigned int Offset) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "IASetIndexBuffer", "m_backend is nullptr");
+		return;
+	}
 	if (!pIndexBuffer) {
 		ERROR("DeviceContext", "IASetIndexBuffer", "pIndexBuffer is nullptr");
 		return;
 	}
-	m_deviceContext->IASetIndexBuffer(pIndexBuffer, Format, Offset);
+	if (m_stateFiltering && m_bound.indexBuffer == pIndexBuffer &&
+		  m_bound.indexFormat == Format && m_bound.indexOffset == Offset) {
+		++m_stateStats.stateCallsFiltered;
+		return;
+	}
+	m_bound.indexBuffer = pIndexBuffer;
+	m_bound.indexFormat = Format;
+	m_bound.indexOffset = Offset;
+	countStateCall();
+	m_backend->IASetIndexBuffer(pIndexBuffer, Format, Offset);
 }
 
 void
 DeviceContext::PSSetSamplers(unsigned int StartSlot,
 	                           unsigned int NumSamplers,
 	                           ID3D11SamplerState* const* ppSamplers) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "PSSetSamplers", "m_backend is nullptr");
+		return;
+	}
 	if (!ppSamplers) {
 		ERROR("DeviceContext", "PSSetSamplers", "ppSamplers is nullptr");
 		return;
 	}
-	m_deviceContext->PSSetSamplers(StartSlot, NumSamplers, ppSamplers);
+	unsigned int first = 0;
+	unsigned int last = NumSamplers;
+	if (StartSlot + NumSamplers <= kCachedSamplers) {
+		auto same = [&](unsigned int i) { return m_bound.psSamplers[StartSlot + i] == ppSamplers[i]; };
+		if (m_stateFiltering && !findChangedRange(NumSamplers, same, first, last)) {
+			++m_stateStats.stateCallsFiltered;
+			return;
+		}
+	}
+	for (unsigned int i = 0; i < NumSamplers && StartSlot + i < kCachedSamplers; ++i) {
+		m_bound.psSamplers[StartSlot + i] = ppSamplers[i];
+	}
+	countStateCall();
+	m_backend->PSSetSamplers(StartSlot + first, last - first, ppSamplers + first);
 }
 
 void
 DeviceContext::RSSetState(ID3D11RasterizerState* pRasterizerState) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "RSSetState", "m_backend is nullptr");
+		return;
+	}
 	if (!pRasterizerState) {
 		ERROR("DeviceContext", "RSSetState", "pRasterizerState is nullptr");
 		return;
 	}
-	m_deviceContext->RSSetState(pRasterizerState);
+	if (m_stateFiltering && m_bound.rasterizerState == pRasterizerState) {
+		++m_stateStats.stateCallsFiltered;
+		return;
+	}
+	m_bound.rasterizerState = pRasterizerState;
+	countStateCall();
+	m_backend->RSSetState(pRasterizerState);
 }
 
 void
 DeviceContext::OMSetBlendState(ID3D11BlendState* pBlendState,
 	                             const float BlendFactor[4],
 	                             unsigned int SampleMask) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "OMSetBlendState", "m_backend is nullptr");
+		return;
+	}
 	if (!pBlendState) {
 		ERROR("DeviceContext", "OMSetBlendState", "pBlendState is nullptr");
 		return;
 	}
-	m_deviceContext->OMSetBlendState(pBlendState, BlendFactor, SampleMask);
+	// Sin factor D3D11 usa {1, 1, 1, 1}
+	static const float defaultFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	const float* factor = BlendFactor ? BlendFactor : defaultFactor;
+	if (m_stateFiltering && m_bound.blendState == pBlendState && m_bound.sampleMask == SampleMask &&
+		  memcmp(m_bound.blendFactor, factor, sizeof(m_bound.blendFactor)) == 0) {
+		++m_stateStats.stateCallsFiltered;
+		return;
+	}
+	m_bound.blendState = pBlendState;
+	m_bound.sampleMask = SampleMask;
+	memcpy(m_bound.blendFactor, factor, sizeof(m_bound.blendFactor));
+	countStateCall();
+	m_backend->OMSetBlendState(pBlendState, BlendFactor, SampleMask);
+}
+
+void
+DeviceContext::OMSetDepthStencilState(ID3D11DepthStencilState* pDepthStencilState,
+	                                    unsigned int StencilRef) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "OMSetDepthStencilState", "m_backend is nullptr");
+		return;
+	}
+	if (!pDepthStencilState) {
+		ERROR("DeviceContext", "OMSetDepthStencilState", "pDepthStencilState is nullptr");
+		return;
+	}
+	if (m_stateFiltering && m_bound.depthStencilState == pDepthStencilState &&
+		  m_bound.stencilRef == StencilRef) {
+		++m_stateStats.stateCallsFiltered;
+		return;
+	}
+	m_bound.depthStencilState = pDepthStencilState;
+	m_bound.stencilRef = StencilRef;
+	countStateCall();
+	m_backend->OMSetDepthStencilState(pDepthStencilState, StencilRef);
 }
 
 void
 DeviceContext::OMSetRenderTargets(unsigned int NumViews,
 	                                ID3D11RenderTargetView* const* ppRenderTargetViews,
 	                                ID3D11DepthStencilView* pDepthStencilView) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "OMSetRenderTargets", "m_backend is nullptr");
+		return;
+	}
 	// Validar los parmetros
 	if (!ppRenderTargetViews && !pDepthStencilView) {
 		ERROR("DeviceContext", "OMSetRenderTargets",
@@ -155,11 +458,38 @@ DeviceContext::OMSetRenderTargets(unsigned int NumViews,
 	}
 
 	// Asignar los render targets y el depth stencil
-	m_deviceContext->OMSetRenderTargets(NumViews, ppRenderTargetViews, pDepthStencilView);
+	if (NumViews <= kCachedRenderTargets) {
+		bool same = m_bound.numRenderTargets == NumViews && m_bound.depthStencil == pDepthStencilView;
+		for (unsigned int i = 0; same && i < NumViews; ++i) {
+			same = m_bound.renderTargets[i] == ppRenderTargetViews[i];
+		}
+		if (m_stateFiltering && same) {
+			++m_stateStats.stateCallsFiltered;
+			return;
+		}
+		m_bound.numRenderTargets = NumViews;
+		for (unsigned int i = 0; i < NumViews; ++i) {
+			m_bound.renderTargets[i] = ppRenderTargetViews[i];
+		}
+		m_bound.depthStencil = pDepthStencilView;
+	}
+	else {
+		m_bound.numRenderTargets = ~0u;
+	}
+	// D3D11 desenlaza las SRVs que apuntan a un target recin enlazado: ya no se sabe cules quedan
+	for (unsigned int i = 0; i < kCachedShaderResources; ++i) {
+		m_bound.psResources[i] = unknownState();
+	}
+	countStateCall();
+	m_backend->OMSetRenderTargets(NumViews, ppRenderTargetViews, pDepthStencilView);
 }
 
 void
 DeviceContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "IASetPrimitiveTopology", "m_backend is nullptr");
+		return;
+	}
 	// Validar el parmetro Topology
 	if (Topology == D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED) {
 		ERROR("DeviceContext", "IASetPrimitiveTopology",
@@ -168,12 +498,22 @@ DeviceContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) {
 	}
 
 	// Asignar la topologa al Input Assembler
-	m_deviceContext->IASetPrimitiveTopology(Topology);
+	if (m_stateFiltering && m_bound.topology == Topology) {
+		++m_stateStats.stateCallsFiltered;
+		return;
+	}
+	m_bound.topology = Topology;
+	countStateCall();
+	m_backend->IASetPrimitiveTopology(Topology);
 }
 
 void
 DeviceContext::ClearRenderTargetView(ID3D11RenderTargetView* pRenderTargetView,
 	const float ColorRGBA[4]) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "ClearRenderTargetView", "m_backend is nullptr");
+		return;
+	}
 	// Validar parmetros
 	if (!pRenderTargetView) {
 		ERROR("DeviceContext", "ClearRenderTargetView", "pRenderTargetView is nullptr");
@@ -185,7 +525,7 @@ DeviceContext::ClearRenderTargetView(ID3D11RenderTargetView* pRenderTargetView,
 	}
 
 	// Limpiar el render target
-	m_deviceContext->ClearRenderTargetView(pRenderTargetView, ColorRGBA);
+	m_backend->ClearRenderTargetView(pRenderTargetView, ColorRGBA);
 }
 
 void
@@ -193,6 +533,10 @@ DeviceContext::ClearDepthStencilView(ID3D11DepthStencilView* pDepthStencilView,
 	                                   unsigned int ClearFlags,
 	                                   float Depth,
 	                                   UINT8 Stencil) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "ClearDepthStencilView", "m_backend is nullptr");
+		return;
+	}
 	// Validar parmetros
 	if (!pDepthStencilView) {
 		ERROR("DeviceContext", "ClearDepthStencilView",
@@ -208,13 +552,17 @@ DeviceContext::ClearDepthStencilView(ID3D11DepthStencilView* pDepthStencilView,
 	}
 
 	// Limpiar el depth stencil
-	m_deviceContext->ClearDepthStencilView(pDepthStencilView, ClearFlags, Depth, Stencil);
+	m_backend->ClearDepthStencilView(pDepthStencilView, ClearFlags, Depth, Stencil);
 }
 
 void
 DeviceContext::VSSetConstantBuffers(unsigned int StartSlot,
 	                                  unsigned int NumBuffers,
 	                                  ID3D11Buffer* const* ppConstantBuffers) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "VSSetConstantBuffers", "m_backend is nullptr");
+		return;
+	}
 	// Validar parmetros
 	if (!ppConstantBuffers) {
 		ERROR("DeviceContext", "VSSetConstantBuffers", "ppConstantBuffers is nullptr");
@@ -222,13 +570,17 @@ DeviceContext::VSSetConstantBuffers(unsigned int StartSlot,
 	}
 
 	// Asignar los constant buffers al vertex shader
-	m_deviceContext->VSSetConstantBuffers(StartSlot, NumBuffers, ppConstantBuffers);
+	setConstantBuffers(false, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr);
 }
 
 void
 DeviceContext::PSSetConstantBuffers(unsigned int StartSlot,
 	                                  unsigned int NumBuffers,
 	                                  ID3D11Buffer* const* ppConstantBuffers) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "PSSetConstantBuffers", "m_backend is nullptr");
+		return;
+	}
 	// Validar parmetros
 	if (!ppConstantBuffers) {
 		ERROR("DeviceContext", "PSSetConstantBuffers", "ppConstantBuffers is nullptr");
@@ -236,13 +588,122 @@ DeviceContext::PSSetConstantBuffers(unsigned int StartSlot,
 	}
 
 	// Asignar los constant buffers al pixel shader
-	m_deviceContext->PSSetConstantBuffers(StartSlot, NumBuffers, ppConstantBuffers);
+	setConstantBuffers(true, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr);
+}
+
+void
+DeviceContext::VSSetConstantBuffers1(unsigned int StartSlot,
+	                                   unsigned int NumBuffers,
+	                                   ID3D11Buffer* const* ppConstantBuffers,
+	                                   const unsigned int* pFirstConstant,
+	                                   const unsigned int* pNumConstants) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "VSSetConstantBuffers1", "m_backend is nullptr");
+		return;
+	}
+	// Validar parmetros
+	if (!ppConstantBuffers || !pFirstConstant || !pNumConstants) {
+		ERROR("DeviceContext", "VSSetConstantBuffers1", "ppConstantBuffers, pFirstConstant or pNumConstants is nullptr");
+		return;
+	}
+	// Sin D3D11.1 se enlaza el buffer completo (el llamador debe usar su propio camino de respaldo)
+	if (!m_backend->supportsConstantBufferOffsets()) {
+		ERROR("DeviceContext", "VSSetConstantBuffers1", "Constant buffer offsets not supported");
+		setConstantBuffers(false, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr);
+		return;
+	}
+
+	setConstantBuffers(false, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants);
+}
+
+void
+DeviceContext::PSSetConstantBuffers1(unsigned int StartSlot,
+	                                   unsigned int NumBuffers,
+	                                   ID3D11Buffer* const* ppConstantBuffers,
+	                                   const unsigned int* pFirstConstant,
+	                                   const unsigned int* pNumConstants) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "PSSetConstantBuffers1", "m_backend is nullptr");
+		return;
+	}
+	// Validar parmetros
+	if (!ppConstantBuffers || !pFirstConstant || !pNumConstants) {
+		ERROR("DeviceContext", "PSSetConstantBuffers1", "ppConstantBuffers, pFirstConstant or pNumConstants is nullptr");
+		return;
+	}
+	if (!m_backend->supportsConstantBufferOffsets()) {
+		ERROR("DeviceContext", "PSSetConstantBuffers1", "Constant buffer offsets not supported");
+		setConstantBuffers(true, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr);
+		return;
+	}
+
+	setConstantBuffers(true, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants);
+}
+
+void
+DeviceContext::setConstantBuffers(bool pixelStage,
+	                                unsigned int StartSlot,
+	                                unsigned int NumBuffers,
+	                                ID3D11Buffer* const* ppConstantBuffers,
+	                                const unsigned int* pFirstConstant,
+	                                const unsigned int* pNumConstants) {
+	StageConstantBuffers& stage = pixelStage ? m_bound.psConstants : m_bound.vsConstants;
+	// Sin rangos el buffer se enlaza completo (se guarda como 0/0)
+	bool ranged = pFirstConstant && pNumConstants;
+
+	unsigned int first = 0;
+	unsigned int last = NumBuffers;
+	if (StartSlot + NumBuffers <= kCachedConstantBuffers) {
+		auto same = [&](unsigned int i) {
+			unsigned int slot = StartSlot + i;
+			return stage.buffers[slot] == ppConstantBuffers[i] &&
+				     stage.firstConstant[slot] == (ranged ? pFirstConstant[i] : 0) &&
+				     stage.numConstants[slot] == (ranged ? pNumConstants[i] : 0);
+		};
+		if (m_stateFiltering && !findChangedRange(NumBuffers, same, first, last)) {
+			++m_stateStats.stateCallsFiltered;
+			return;
+		}
+	}
+	for (unsigned int i = 0; i < NumBuffers && StartSlot + i < kCachedConstantBuffers; ++i) {
+		stage.buffers[StartSlot + i] = ppConstantBuffers[i];
+		stage.firstConstant[StartSlot + i] = ranged ? pFirstConstant[i] : 0;
+		stage.numConstants[StartSlot + i] = ranged ? pNumConstants[i] : 0;
+	}
+
+	countStateCall();
+	unsigned int count = last - first;
+	if (ranged) {
+		if (pixelStage) {
+			m_backend->PSSetConstantBuffers1(StartSlot + first, count, ppConstantBuffers + first,
+			                                 pFirstConstant + first, pNumConstants + first);
+		}
+		else {
+			m_backend->VSSetConstantBuffers1(StartSlot + first, count, ppConstantBuffers + first,
+			                                 pFirstConstant + first, pNumConstants + first);
+		}
+	}
+	else if (pixelStage) {
+		m_backend->PSSetConstantBuffers(StartSlot + first, count, ppConstantBuffers + first);
+	}
+	else {
+		m_backend->VSSetConstantBuffers(StartSlot + first, count, ppConstantBuffers + first);
+	}
+}
+
+bool
+DeviceContext::supportsConstantBufferOffsets() const {
+	return m_backend && m_backend->supportsConstantBufferOffsets();
 }
 
 void
 DeviceContext::DrawIndexed(unsigned int IndexCount,
 	                         unsigned int StartIndexLocation,
 	                         int BaseVertexLocation) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "DrawIndexed", "m_backend is nullptr");
+		return;
+	}
 	// Validar parmetros
 	if (IndexCount == 0) {
 		ERROR("DeviceContext", "DrawIndexed", "IndexCount is zero");
@@ -250,5 +711,176 @@ DeviceContext::DrawIndexed(unsigned int IndexCount,
 	}
 
 	// Ejecutar el dibujo
-	m_deviceContext->DrawIndexed(IndexCount, StartIndexLocation, BaseVertexLocation);
+	ENGINE_STAT_ADD("draw_calls", 1);
+	ENGINE_STAT_ADD("triangles", IndexCount / 3);
+	m_backend->DrawIndexed(IndexCount, StartIndexLocation, BaseVertexLocation);
+}
+
+void
+DeviceContext::DrawIndexedInstanced(unsigned int IndexCountPerInstance,
+	                                  unsigned int InstanceCount,
+	                                  unsigned int StartIndexLocation,
+	                                  int BaseVertexLocation,
+	                                  unsigned int StartInstanceLocation) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "DrawIndexedInstanced", "m_backend is nullptr");
+		return;
+	}
+	// Validar parmetros
+	if (IndexCountPerInstance == 0 || InstanceCount == 0) {
+		ERROR("DeviceContext", "DrawIndexedInstanced", "IndexCountPerInstance or InstanceCount is zero");
+		return;
+	}
+	ENGINE_STAT_ADD("draw_calls", 1);
+	ENGINE_STAT_ADD("instances", InstanceCount);
+	ENGINE_STAT_ADD("triangles", static_cast<long long>(IndexCountPerInstance / 3) * InstanceCount);
+
+	m_backend->DrawIndexedInstanced(IndexCountPerInstance,
+	                                InstanceCount,
+	                                StartIndexLocation,
+	                                BaseVertexLocation,
+	                                StartInstanceLocation);
+}
+
+HRESULT
+DeviceContext::Map(ID3D11Resource* pResource,
+	                 unsigned int Subresource,
+	                 D3D11_MAP MapType,
+	                 unsigned int MapFlags,
+	                 D3D11_MAPPED_SUBRESOURCE* pMappedResource) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "Map", "m_backend is nullptr");
+		return E_POINTER;
+	}
+	// Validar parmetros
+	if (!pResource || !pMappedResource) {
+		ERROR("DeviceContext", "Map", "pResource or pMappedResource is nullptr");
+		return E_INVALIDARG;
+	}
+	ENGINE_STAT_ADD("buffer_maps", 1);
+
+	return m_backend->Map(pResource, Subresource, MapType, MapFlags, pMappedResource);
+}
+
+void
+DeviceContext::Unmap(ID3D11Resource* pResource, unsigned int Subresource) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "Unmap", "m_backend is nullptr");
+		return;
+	}
+	if (!pResource) {
+		ERROR("DeviceContext", "Unmap", "pResource is nullptr");
+		return;
+	}
+	m_backend->Unmap(pResource, Subresource);
+}
+
+void
+DeviceContext::GenerateMips(ID3D11ShaderResourceView* pShaderResourceView) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "GenerateMips", "m_backend is nullptr");
+		return;
+	}
+	if (!pShaderResourceView) {
+		ERROR("DeviceContext", "GenerateMips", "pShaderResourceView is nullptr");
+		return;
+	}
+	m_backend->GenerateMips(pShaderResourceView);
+}
+
+void
+DeviceContext::ResolveSubresource(ID3D11Resource* pDstResource,
+	unsigned int DstSubresource,
+	ID3D11Resource* pSrcResource,
+	unsigned int SrcSubresource,
+	DXGI_FORMAT Format) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "ResolveSubresource", "m_backend is nullptr");
+		return;
+	}
+	if (!pDstResource || !pSrcResource) {
+		ERROR("DeviceContext", "ResolveSubresource",
+			"Invalid arguments: pDstResource or pSrcResource is nullptr");
+		return;
+	}
+	m_backend->ResolveSubresource(pDstResource, DstSubresource, pSrcResource, SrcSubresource, Format);
+}
+
+void
+DeviceContext::Begin(ID3D11Asynchronous* pAsync) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "Begin", "m_backend is nullptr");
+		return;
+	}
+	if (!pAsync) {
+		ERROR("DeviceContext", "Begin", "pAsync is nullptr");
+		return;
+	}
+	m_backend->Begin(pAsync);
+}
+
+void
+DeviceContext::End(ID3D11Asynchronous* pAsync) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "End", "m_backend is nullptr");
+		return;
+	}
+	if (!pAsync) {
+		ERROR("DeviceContext", "End", "pAsync is nullptr");
+		return;
+	}
+	m_backend->End(pAsync);
+}
+
+HRESULT
+DeviceContext::GetData(ID3D11Asynchronous* pAsync,
+	void* pData,
+	unsigned int DataSize,
+	unsigned int GetDataFlags) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "GetData", "m_backend is nullptr");
+		return E_POINTER;
+	}
+	if (!pAsync) {
+		ERROR("DeviceContext", "GetData", "pAsync is nullptr");
+		return E_INVALIDARG;
+	}
+	return m_backend->GetData(pAsync, pData, DataSize, GetDataFlags);
+}
+
+void
+DeviceContext::ClearState() {
+	if (!m_backend) {
+		ERROR("DeviceContext", "ClearState", "m_backend is nullptr");
+		return;
+	}
+	m_backend->ClearState();
+	// Tras ClearState el estado es conocido: todo desenlazado
+	resetStateCache(nullptr);
+}
+
+HRESULT
+DeviceContext::FinishCommandList(std::unique_ptr<IRenderCommandList>& commandList) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "FinishCommandList", "m_backend is nullptr");
+		return E_POINTER;
+	}
+	HRESULT hr = m_backend->finishCommandList(commandList);
+	if (FAILED(hr)) {
+		invalidateStateCache();
+		return hr;
+	}
+	// Con RestoreDeferredContextState = FALSE el contexto vuelve al estado por defecto
+	resetStateCache(nullptr);
+	return hr;
+}
+
+void
+DeviceContext::ExecuteCommandList(IRenderCommandList& commandList) {
+	if (!m_backend) {
+		ERROR("DeviceContext", "ExecuteCommandList", "m_backend is nullptr");
+		return;
+	}
+	m_backend->executeCommandList(commandList);
+	resetStateCache(nullptr);
 }
@@ -2,6 +2,9 @@
 #include "MeshComponent.h"
 #include "Device.h"
 #include "DeviceContext.h"
+#include "Renderer/RenderQueue.h"
+#include "EngineUtilities/Utilities/EngineStats.h"
+#include <cfloat>
 
 
 Actor::Actor(Device& device) {
@@ -13,10 +16,7 @@ Actor::Actor(Device& device) {
 
 	HRESULT hr;
 	std::string classNameType = "Actor -> " + m_name;
-	hr = m_modelBuffer.init(device, sizeof(CBChangesEveryFrame));
-	if (FAILED(hr)) {
-		ERROR("Actor", classNameType.c_str(), "Failed to create new CBChangesEveryFrame");
-	}
+	m_device = &device;
 
 	// Awake
 	awake();
@@ -77,15 +77,15 @@ Actor::update(float deltaTime, DeviceContext& deviceContext) {
 		}
 	}
 
-	// Update the model buffer
-	m_model.mWorld = XMMatrixTranspose(getComponent<Transform>()->matrix);
+	// Update the model buffer (mWorld se escribe al dibujar, con la matriz interpolada)
 	m_model.vMeshColor = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-	// Update the constant buffer
-	m_modelBuffer.update(deviceContext, nullptr, 0, nullptr, &m_model, 0, 0);
+	// La subida al GPU la hace quien dibuja: la RenderQueue (anillo de constantes) o render()
 }
 
 void
 Actor::render(DeviceContext& deviceContext) {
+	ENGINE_STAT_ADD("actors_rendered", 1);
+	m_model.mWorld = XMMatrixTranspose(getComponent<Transform>()->renderMatrix);
 	// 1) Proyectar sombra primero (sobre el suelo)
 	//if (canCastShadow()) {
 	//	renderShadow(deviceContext);
@@ -95,8 +95,31 @@ Actor::render(DeviceContext& deviceContext) {
 	//m_blendstate.render(deviceContext);
 	//m_rasterizer.render(deviceContext);
 	m_sampler.render(deviceContext, 0, 1);
+	if (!m_modelBuffer.getBuffer()) {
+		if (!m_device || FAILED(m_modelBuffer.init(*m_device, sizeof(CBChangesEveryFrame)))) {
+			ERROR("Actor", "render", ("Failed to create CBChangesEveryFrame for " + m_name).c_str());
+			return;
+		}
+	}
+	m_modelBuffer.update(deviceContext, nullptr, 0, nullptr, &m_model, 0, 0);
 
 	deviceContext.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	if (m_meshPool) {
+		// Todas las mallas del pool comparten buffers: se enlazan una vez
+		ID3D11Buffer* vertexBuffer = m_meshPool->getVertexBuffer();
+		unsigned int stride = m_meshPool->getVertexStride();
+		unsigned int offset = 0;
+		deviceContext.IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+		deviceContext.IASetIndexBuffer(m_meshPool->getIndexBuffer(), DXGI_FORMAT_R32_UINT, 0);
+		m_modelBuffer.render(deviceContext, 2, 1, true);
+		bindAlbedo(deviceContext); // Albedo -> t0
+		for (MeshHandle handle : m_meshHandles) {
+			MeshRange range = m_meshPool->getRange(handle);
+			deviceContext.DrawIndexed(range.indexCount, range.startIndex, static_cast<int>(range.baseVertex));
+		}
+		return;
+	}
+
 	// Update buffer and render all components
 	for (unsigned int i = 0; i < m_meshes.size(); i++) {
 		m_vertexBuffers[i].render(deviceContext, 0, 1);
@@ -105,7 +128,10 @@ Actor::render(DeviceContext& deviceContext) {
 		m_modelBuffer.render(deviceContext, 2, 1, true);
 
 		// Render mesh texture
-		if (m_textures.size() > 0) {
+		if (m_textureStreamer) {
+			bindAlbedo(deviceContext); // Albedo -> t0
+		}
+		else if (m_textures.size() > 0) {
 			if (i < m_textures.size()) {
 				if (m_textures.size() >= 1) {
 					m_textures[0].render(deviceContext, 0, 1); // Albedo -> t0
@@ -120,6 +146,53 @@ Actor::render(DeviceContext& deviceContext) {
 	}
 }
 
+void
+Actor::submit(RenderQueue& queue) {
+	// La geometra ya est en las pginas del batching esttico
+	if (m_staticBatched) {
+		return;
+	}
+
+	const XMMATRIX world = getComponent<Transform>()->renderMatrix;
+	m_model.mWorld = XMMatrixTranspose(world);
+
+	DrawPacket packet;
+	packet.sampler = m_sampler.m_sampler;
+	packet.texture = getAlbedo();
+	packet.objectBuffer = m_modelBuffer.getBuffer();
+	packet.objectSlot = 2;
+	packet.objectData = &m_model;
+	packet.objectDataSize = sizeof(CBChangesEveryFrame);
+	packet.viewDepth = queue.computeViewDepth(world);
+	// Los actores con la misma malla y material se agrupan en un draw instanciado
+	packet.instanceable = true;
+	XMStoreFloat4x4(&packet.world, world);
+	packet.color = m_model.vMeshColor;
+
+	if (m_meshPool) {
+		packet.vertexBuffer = m_meshPool->getVertexBuffer();
+		packet.vertexStride = m_meshPool->getVertexStride();
+		packet.indexBuffer = m_meshPool->getIndexBuffer();
+		packet.indexFormat = DXGI_FORMAT_R32_UINT;
+		for (MeshHandle handle : m_meshHandles) {
+			MeshRange range = m_meshPool->getRange(handle);
+			packet.indexCount = range.indexCount;
+			packet.startIndex = range.startIndex;
+			packet.baseVertex = static_cast<int>(range.baseVertex);
+			queue.submit(packet);
+		}
+		return;
+	}
+
+	for (unsigned int i = 0; i < m_meshes.size() && i < m_vertexBuffers.size() && i < m_indexBuffers.size(); i++) {
+		packet.vertexBuffer = m_vertexBuffers[i].getBuffer();
+		packet.vertexStride = m_vertexBuffers[i].getStride();
+		packet.indexBuffer = m_indexBuffers[i].getBuffer();
+		packet.indexFormat = DXGI_FORMAT_R32_UINT;
+		packet.indexCount = m_meshes[i].m_numIndex;
+		queue.submit(packet);
+	}
+}
 
 void
 Actor::destroy() {
@@ -131,6 +204,14 @@ Actor::destroy() {
 		indexBuffer.destroy();
 	}
 
+	if (m_meshPool) {
+		for (MeshHandle handle : m_meshHandles) {
+			m_meshPool->release(handle);
+		}
+		m_meshHandles.clear();
+		m_meshPool = nullptr;
+	}
+
 	for (auto& tex : m_textures) {
 		tex.destroy();
 	}
@@ -141,9 +222,38 @@ Actor::destroy() {
 	m_sampler.destroy();
 }
 
+void
+Actor::shareMesh(const Actor& source) {
+	if (!m_vertexBuffers.empty() || !m_indexBuffers.empty() || m_meshPool) {
+		ERROR("Actor", "shareMesh", "Actor already has geometry");
+		return;
+	}
+	m_meshes = source.m_meshes;
+	m_boundsMin = source.m_boundsMin;
+	m_boundsMax = source.m_boundsMax;
+	if (source.m_meshPool) {
+		m_meshPool = source.m_meshPool;
+		m_meshHandles = source.m_meshHandles;
+		for (MeshHandle handle : m_meshHandles) {
+			m_meshPool->addRef(handle);
+		}
+		return;
+	}
+	m_vertexBuffers = source.m_vertexBuffers;
+	m_indexBuffers = source.m_indexBuffers;
+	// Cada Actor libera sus buffers en destroy(): una referencia extra por copia
+	for (auto& vertexBuffer : m_vertexBuffers) {
+		if (vertexBuffer.getBuffer()) vertexBuffer.getBuffer()->AddRef();
+	}
+	for (auto& indexBuffer : m_indexBuffers) {
+		if (indexBuffer.getBuffer()) indexBuffer.getBuffer()->AddRef();
+	}
+}
+
 void
 Actor::setMesh(Device& device, std::vector<MeshComponent> meshes) {
 	m_meshes = meshes;
+	computeLocalBounds();
 	HRESULT hr;
 	for (auto& mesh : m_meshes) {
 		// Crear vertex buffer
@@ -167,3 +277,81 @@ Actor::setMesh(Device& device, std::vector<MeshComponent> meshes) {
 		}
 	}
 }
+
+void
+Actor::setMesh(Device& device, DeviceContext& deviceContext, MeshPool& pool, std::vector<MeshComponent> meshes) {
+	if (!m_vertexBuffers.empty() || !m_indexBuffers.empty() || m_meshPool) {
+		ERROR("Actor", "setMesh", "Actor already has geometry");
+		return;
+	}
+	std::vector<MeshHandle> handles;
+	for (const auto& mesh : meshes) {
+		MeshHandle handle = pool.upload(device, deviceContext, mesh);
+		if (handle == kInvalidMesh) {
+			// Todo o nada: si una malla no entra, el actor usa buffers propios
+			ERROR("Actor", "setMesh", "Mesh pool upload failed, using per-mesh buffers");
+			for (MeshHandle uploaded : handles) {
+				pool.release(uploaded);
+			}
+			setMesh(device, meshes);
+			return;
+		}
+		handles.push_back(handle);
+	}
+	m_meshes = meshes;
+	computeLocalBounds();
+	m_meshPool = &pool;
+	m_meshHandles = handles;
+}
+
+void
+Actor::bindAlbedo(DeviceContext& deviceContext) {
+	if (!m_textureStreamer) {
+		if (!m_textures.empty()) {
+			m_textures[0].render(deviceContext, 0, 1);
+		}
+		return;
+	}
+	ID3D11ShaderResourceView* view = m_textureStreamer->getView(m_textureStream);
+	if (view) {
+		ENGINE_STAT_ADD("texture_binds", 1);
+		deviceContext.PSSetShaderResources(0, 1, &view);
+	}
+}
+
+void
+Actor::computeLocalBounds() {
+	XMVECTOR boundsMin = XMVectorReplicate(FLT_MAX);
+	XMVECTOR boundsMax = XMVectorReplicate(-FLT_MAX);
+	for (const auto& mesh : m_meshes) {
+		for (const SimpleVertex& vertex : mesh.m_vertex) {
+			XMVECTOR position = XMLoadFloat3(&vertex.Pos);
+			boundsMin = XMVectorMin(boundsMin, position);
+			boundsMax = XMVectorMax(boundsMax, position);
+		}
+	}
+	XMStoreFloat3(&m_boundsMin, boundsMin);
+	XMStoreFloat3(&m_boundsMax, boundsMax);
+}
+
+bool
+Actor::getWorldBounds(XMFLOAT3& boundsMin, XMFLOAT3& boundsMax) {
+	if (m_boundsMin.x > m_boundsMax.x) {
+		return false;
+	}
+	// Centro y semiejes: |M| * extents da el AABB del cubo transformado sin recorrer 8 esquinas
+	XMVECTOR localMin = XMLoadFloat3(&m_boundsMin);
+	XMVECTOR localMax = XMLoadFloat3(&m_boundsMax);
+	XMVECTOR center = XMVectorScale(XMVectorAdd(localMin, localMax), 0.5f);
+	XMVECTOR extents = XMVectorScale(XMVectorSubtract(localMax, localMin), 0.5f);
+
+	const XMMATRIX world = getComponent<Transform>()->renderMatrix;
+	XMVECTOR worldCenter = XMVector3TransformCoord(center, world);
+	XMVECTOR worldExtents = XMVectorAdd(XMVectorAdd(
+		XMVectorMultiply(XMVectorSplatX(extents), XMVectorAbs(world.r[0])),
+		XMVectorMultiply(XMVectorSplatY(extents), XMVectorAbs(world.r[1]))),
+		XMVectorMultiply(XMVectorSplatZ(extents), XMVectorAbs(world.r[2])));
+	XMStoreFloat3(&boundsMin, XMVectorSubtract(worldCenter, worldExtents));
+	XMStoreFloat3(&boundsMax, XMVectorAdd(worldCenter, worldExtents));
+	return true;
+}
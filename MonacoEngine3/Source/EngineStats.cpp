@@ -0,0 +1,76 @@
+#include "EngineUtilities/Utilities/EngineStats.h"
+
+StatValue&
+EngineStats::find(const std::string& name, StatType type) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (StatValue& value : m_values) {
+    if (value.m_name == name) {
+      return value;
+    }
+  }
+  m_values.emplace_back(name, type);
+  return m_values.back();
+}
+
+void
+EngineStats::endFrame(double frameMs) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (StatValue& value : m_values) {
+    value.m_lastFrame = value.m_type == StatType::Counter
+      ? value.m_value.exchange(0, std::memory_order_relaxed)
+      : value.m_value.load(std::memory_order_relaxed);
+  }
+  ++m_frames;
+
+  if (!m_csv.is_open()) {
+    return;
+  }
+  if (m_csvColumns == 0) {
+    m_csvColumns = m_values.size();
+    m_csv << "frame,frame_ms";
+    for (size_t i = 0; i < m_csvColumns; ++i) {
+      m_csv << ',' << m_values[i].m_name;
+    }
+    m_csv << '\n';
+  }
+  m_csv << m_frames << ',' << frameMs;
+  for (size_t i = 0; i < m_csvColumns; ++i) {
+    m_csv << ',' << m_values[i].m_lastFrame;
+  }
+  m_csv << '\n';
+}
+
+bool
+EngineStats::startCsv(const std::string& fileName) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_csv.is_open()) {
+    m_csv.close();
+  }
+  m_csv.open(fileName, std::ios::out | std::ios::trunc);
+  m_csvColumns = 0;
+  if (!m_csv.is_open()) {
+    ERROR("EngineStats", "startCsv", ("Failed to open " + fileName).c_str());
+    return false;
+  }
+  return true;
+}
+
+void
+EngineStats::stopCsv() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_csv.is_open()) {
+    m_csv.close();
+  }
+  m_csvColumns = 0;
+}
+
+void
+EngineStats::getSnapshot(std::vector<StatSnapshot>& out) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  out.resize(m_values.size());
+  for (size_t i = 0; i < m_values.size(); ++i) {
+    out[i].name = m_values[i].m_name;
+    out[i].type = m_values[i].m_type;
+    out[i].value = m_values[i].m_lastFrame;
+  }
+}
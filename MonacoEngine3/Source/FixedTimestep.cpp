@@ -0,0 +1,56 @@
+#include "EngineUtilities/Utilities/FixedTimestep.h"
+
+void
+FixedTimestep::setSettings(const FixedTimestepSettings& settings) {
+  m_settings = settings;
+  m_settings.stepSeconds = m_settings.stepSeconds > 0.0001f ? m_settings.stepSeconds : 0.0001f;
+  m_settings.maxStepsPerFrame = m_settings.maxStepsPerFrame > 0 ? m_settings.maxStepsPerFrame : 1;
+  if (m_accumulator >= m_settings.stepSeconds) {
+    m_accumulator = 0.0;
+  }
+  m_alpha = static_cast<float>(m_accumulator / m_settings.stepSeconds);
+}
+
+void
+FixedTimestep::reset() {
+  m_accumulator = 0.0;
+  m_alpha = 0.0f;
+  m_stats = FixedTimestepStats();
+}
+
+unsigned int
+FixedTimestep::advance(float frameSeconds) {
+  const double step = m_settings.stepSeconds;
+  double frame = frameSeconds > 0.0f ? frameSeconds : 0.0;
+  bool clamped = false;
+  if (frame > m_settings.maxFrameSeconds) {
+    m_stats.droppedSeconds += frame - m_settings.maxFrameSeconds;
+    clamped = true;
+    frame = m_settings.maxFrameSeconds;
+  }
+  m_accumulator += frame;
+
+  // Tolerancia de 1/1000 de paso: los frames en float no suman exacto (144 x 1/144 < 1)
+  unsigned int steps = static_cast<unsigned int>(m_accumulator / step + 0.001);
+  if (steps > m_settings.maxStepsPerFrame) {
+    // No da abasto: se simula el tope y se olvida el resto, salvo la fraccin de paso
+    const double dropped = (steps - m_settings.maxStepsPerFrame) * step;
+    m_stats.droppedSeconds += dropped;
+    clamped = true;
+    m_accumulator -= dropped;
+    steps = m_settings.maxStepsPerFrame;
+  }
+  if (clamped) {
+    ++m_stats.framesClamped;
+  }
+  m_accumulator -= steps * step;
+  // Redondeo: lo que quede por debajo de 0 es error de coma flotante
+  m_accumulator = m_accumulator > 0.0 ? m_accumulator : 0.0;
+  m_alpha = static_cast<float>(m_accumulator / step);
+  m_alpha = m_alpha < 1.0f ? m_alpha : 0.9999f;
+
+  ++m_stats.frames;
+  m_stats.steps += steps;
+  m_stats.stepsLastFrame = steps;
+  return steps;
+}
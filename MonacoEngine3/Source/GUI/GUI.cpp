@@ -5,6 +5,10 @@
 #include "DeviceContext.h"
 #include "MeshComponent.h"
 #include "ECS\Actor.h"
+#include "EngineUtilities\Utilities\Profiler.h"
+#include "EngineUtilities\Utilities\EngineStats.h"
+#include "Renderer\FramePacer.h"
+#include "Renderer\TextureStreamer.h"
 //#include "imgui_internal.h"
 static ImGuizmo::OPERATION mCurrentGizmoOperation(ImGuizmo::TRANSLATE);
 void 
@@ -283,6 +287,7 @@ GUI::ToolBar() {
 			if (ImGui::MenuItem("Settings")) {
 				// Acci?n para "Settings"
 			}
+			ImGui::MenuItem("Stats overlay", nullptr, &m_showStatsOverlay);
 			ImGui::EndMenu();
 		}
 		ImGui::EndMainMenuBar();
@@ -555,3 +560,287 @@ void GUI::drawGizmoToolbar() {
 		//if (ImGui::IsKeyPressed(ImGuiKey_R)) mCurrentGizmoOperation = ImGuizmo::SCALE;
 	}
 }
+
+// Color estable por nombre para que un scope conserve su color entre frames
+static ImU32
+profileColor(const char* name) {
+	unsigned int hash = 2166136261u;
+	for (const char* c = name; c && *c; ++c) {
+		hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+	}
+	return IM_COL32(80 + (hash & 0x7F), 80 + ((hash >> 8) & 0x7F), 80 + ((hash >> 16) & 0x7F), 255);
+}
+
+// Una fila por profundidad; devuelve la altura usada
+static float
+drawProfileLane(const std::vector<ProfileEvent>& events, ImVec2 origin, float width, double spanMs) {
+	const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	const float scale = spanMs > 0.0 ? static_cast<float>(width / spanMs) : 0.0f;
+	const ImVec2 mouse = ImGui::GetIO().MousePos;
+	unsigned int maxDepth = 0;
+	for (const ProfileEvent& event : events) {
+		maxDepth = event.depth > maxDepth ? event.depth : maxDepth;
+		ImVec2 a(origin.x + static_cast<float>(event.startMs) * scale, origin.y + event.depth * rowHeight);
+		ImVec2 b(origin.x + static_cast<float>(event.endMs) * scale, a.y + rowHeight - 1.0f);
+		b.x = b.x < a.x + 1.0f ? a.x + 1.0f : b.x;
+		drawList->AddRectFilled(a, b, profileColor(event.name));
+		const ImVec2 textSize = ImGui::CalcTextSize(event.name);
+		if (textSize.x + 4.0f < b.x - a.x) {
+			drawList->AddText(ImVec2(a.x + 2.0f, a.y + 2.0f), IM_COL32(0, 0, 0, 255), event.name);
+		}
+		if (mouse.x >= a.x && mouse.x < b.x && mouse.y >= a.y && mouse.y < b.y) {
+			ImGui::SetTooltip("%s\n%.3f ms (%.3f - %.3f)", event.name,
+				event.endMs - event.startMs, event.startMs, event.endMs);
+		}
+	}
+	return events.empty() ? rowHeight : (maxDepth + 1) * rowHeight;
+}
+
+// Dibuja el scope first y su subarbol (los hijos le siguen en orden de apertura)
+static unsigned int
+drawProfileTree(const std::vector<ProfileEvent>& events, unsigned int first, double frameMs) {
+	const ProfileEvent& event = events[first];
+	unsigned int next = first + 1;
+	const bool leaf = next >= events.size() || events[next].depth <= event.depth;
+	const double ms = event.endMs - event.startMs;
+	ImGuiTreeNodeFlags flags = leaf ? ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen : 0;
+	const bool open = ImGui::TreeNodeEx(reinterpret_cast<void*>(static_cast<intptr_t>(first)), flags,
+		"%s  %.3f ms (%.1f%%)", event.name, ms, frameMs > 0.0 ? 100.0 * ms / frameMs : 0.0);
+	if (leaf) {
+		return next;
+	}
+	while (next < events.size() && events[next].depth > event.depth) {
+		next = open ? drawProfileTree(events, next, frameMs) : next + 1;
+	}
+	if (open) {
+		ImGui::TreePop();
+	}
+	return next;
+}
+
+void
+GUI::profilerWindow() {
+	Profiler& profiler = Profiler::getInstance();
+	ImGui::Begin("Profiler");
+#if !MONACO_PROFILING
+	ImGui::TextDisabled("Profiling compiled out (build Debug or Profile).");
+#else
+	bool enabled = profiler.isEnabled();
+	if (ImGui::Checkbox("Enabled", &enabled)) {
+		profiler.setEnabled(enabled);
+	}
+	ImGui::SameLine();
+	bool paused = profiler.isPaused();
+	if (ImGui::Checkbox("Paused", &paused)) {
+		profiler.setPaused(paused);
+	}
+
+	// Captura para chrome://tracing o ui.perfetto.dev; se escribe en otro hilo
+	TraceCapture& trace = TraceCapture::getInstance();
+	if (trace.isCapturing()) {
+		if (ImGui::Button("Stop trace")) {
+			trace.stop();
+		}
+		ImGui::SameLine();
+		ImGui::Text("Capturing to %s...", trace.getFileName().c_str());
+	}
+	else if (trace.isWriting()) {
+		ImGui::TextDisabled("Writing %s...", trace.getFileName().c_str());
+	}
+	else {
+		if (ImGui::Button("Capture trace")) {
+			trace.start(static_cast<unsigned int>(m_traceFrames), "Trace.json");
+		}
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(120.0f);
+		ImGui::SliderInt("frames", &m_traceFrames, 1, 1000);
+		const TraceCaptureStats traceStats = trace.getStats();
+		if (traceStats.bytesWritten > 0) {
+			ImGui::Text("Last trace: %u frames, %llu events on %u threads (%llu dropped), %.1f KB in %.1f ms",
+				traceStats.framesCaptured, traceStats.events, traceStats.threads, traceStats.droppedEvents,
+				traceStats.bytesWritten / 1024.0, traceStats.writeMs);
+		}
+	}
+
+	const unsigned int frameCount = profiler.getFrameCount();
+	if (frameCount == 0) {
+		ImGui::TextDisabled("No frames recorded yet.");
+		ImGui::End();
+		return;
+	}
+
+	// Historia, de la mas antigua a la mas nueva
+	float history[Profiler::kHistory];
+	float maxMs = 0.0f;
+	for (unsigned int i = 0; i < frameCount; ++i) {
+		history[i] = static_cast<float>(profiler.getFrame(frameCount - 1 - i).cpuMs);
+		maxMs = history[i] > maxMs ? history[i] : maxMs;
+	}
+	ImGui::PlotHistogram("##frames", history, static_cast<int>(frameCount), 0, "CPU ms per frame",
+		0.0f, maxMs * 1.1f, ImVec2(-1.0f, 60.0f));
+	m_profilerFrameAge = m_profilerFrameAge < static_cast<int>(frameCount) ? m_profilerFrameAge : 0;
+	ImGui::SliderInt("Frame age", &m_profilerFrameAge, 0, static_cast<int>(frameCount) - 1);
+
+	const ProfileFrame& frame = profiler.getFrame(static_cast<unsigned int>(m_profilerFrameAge));
+	const ProfilerStats& stats = profiler.getStats();
+	ImGui::Text("Frame %llu: CPU %.3f ms", frame.index, frame.cpuMs);
+	ImGui::SameLine();
+	if (!profiler.hasGpuTiming()) {
+		ImGui::TextDisabled("GPU n/a");
+	}
+	else if (frame.gpuReady) {
+		ImGui::Text("GPU %.3f ms", frame.gpuMs);
+	}
+	else {
+		ImGui::TextDisabled("GPU pending");
+	}
+	ImGui::Text("Scopes: %u CPU, %u GPU (%llu dropped)",
+		static_cast<unsigned int>(frame.cpuEvents.size()), static_cast<unsigned int>(frame.gpuEvents.size()),
+		stats.droppedScopes);
+	ImGui::Text("Overhead: %.3f us per scope, %.4f ms this frame", stats.scopeCostUs,
+		frame.cpuEvents.size() * stats.scopeCostUs * 0.001);
+	ImGui::Text("GPU frames: %llu resolved, %llu disjoint, %llu lost",
+		stats.gpuFramesResolved, stats.gpuFramesDisjoint, stats.gpuFramesLost);
+
+	// Linea de tiempo: CPU y GPU en la misma escala
+	ImGui::Separator();
+	const double spanMs = frame.gpuMs > frame.cpuMs ? frame.gpuMs : frame.cpuMs;
+	const float width = ImGui::GetContentRegionAvail().x;
+	ImGui::TextUnformatted("CPU");
+	ImVec2 origin = ImGui::GetCursorScreenPos();
+	ImGui::Dummy(ImVec2(width, drawProfileLane(frame.cpuEvents, origin, width, spanMs)));
+	if (frame.gpuReady) {
+		ImGui::TextUnformatted("GPU");
+		origin = ImGui::GetCursorScreenPos();
+		ImGui::Dummy(ImVec2(width, drawProfileLane(frame.gpuEvents, origin, width, spanMs)));
+	}
+
+	// Arbol de scopes con su parte del frame
+	if (ImGui::CollapsingHeader("CPU scopes", ImGuiTreeNodeFlags_DefaultOpen)) {
+		for (unsigned int i = 0; i < frame.cpuEvents.size();) {
+			i = drawProfileTree(frame.cpuEvents, i, frame.cpuMs);
+		}
+	}
+	if (frame.gpuReady && ImGui::CollapsingHeader("GPU scopes")) {
+		ImGui::PushID("gpu");
+		for (unsigned int i = 0; i < frame.gpuEvents.size();) {
+			i = drawProfileTree(frame.gpuEvents, i, frame.gpuMs);
+		}
+		ImGui::PopID();
+	}
+#endif
+	ImGui::End();
+}
+
+void
+GUI::statsOverlay() {
+	if (!m_showStatsOverlay) {
+		return;
+	}
+	EngineStats& stats = EngineStats::getInstance();
+	stats.getSnapshot(m_statsSnapshot);
+
+	// Esquina superior derecha, debajo de la barra de menus
+	const ImGuiViewport* viewport = ImGui::GetMainViewport();
+	ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - 10.0f, viewport->WorkPos.y + 10.0f),
+		ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+	ImGui::SetNextWindowBgAlpha(0.35f);
+	const ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+		ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav |
+		ImGuiWindowFlags_NoMove;
+	if (ImGui::Begin("Stats overlay", nullptr, flags)) {
+		ImGui::Text("%.1f FPS (%.2f ms)", ImGui::GetIO().Framerate, 1000.0f / ImGui::GetIO().Framerate);
+		ImGui::Separator();
+		for (const StatSnapshot& stat : m_statsSnapshot) {
+			if (stat.name.find("bytes") != std::string::npos) {
+				ImGui::Text("%-22s %10.2f MB", stat.name.c_str(), stat.value / (1024.0 * 1024.0));
+			}
+			else {
+				ImGui::Text("%-22s %10lld", stat.name.c_str(), stat.value);
+			}
+		}
+		if (stats.isLoggingCsv()) {
+			ImGui::TextDisabled("Logging Stats.csv");
+		}
+		// Clic derecho: registro CSV y ocultar
+		if (ImGui::BeginPopupContextWindow()) {
+			if (ImGui::MenuItem("Log to Stats.csv", nullptr, stats.isLoggingCsv())) {
+				if (stats.isLoggingCsv()) {
+					stats.stopCsv();
+				}
+				else {
+					stats.startCsv("Stats.csv");
+				}
+			}
+			if (ImGui::MenuItem("Hide")) {
+				m_showStatsOverlay = false;
+			}
+			ImGui::EndPopup();
+		}
+	}
+	ImGui::End();
+}
+
+void
+GUI::framePacingWindow(FramePacer& pacer) {
+	ImGui::Begin("Frame Pacing");
+	FramePacerSettings settings = pacer.getSettings();
+	bool changed = ImGui::SliderFloat("Target FPS", &settings.targetFps, 0.0f, 240.0f, settings.targetFps > 0.0f ? "%.0f" : "Unlimited");
+	changed |= ImGui::SliderFloat("Spin (ms)", &settings.spinMs, 0.0f, 4.0f, "%.2f");
+	int maxLatency = static_cast<int>(settings.maxFrameLatency);
+	if (ImGui::SliderInt("Max frame latency", &maxLatency, 1, static_cast<int>(FramePacer::kMaxFrameLatency))) {
+		settings.maxFrameLatency = static_cast<unsigned int>(maxLatency);
+		changed = true;
+	}
+	changed |= ImGui::Checkbox("VSync", &settings.vsync);
+	if (changed) {
+		pacer.setSettings(settings);
+	}
+
+	const FramePacerStats& stats = pacer.getStats();
+	ImGui::Separator();
+	ImGui::Text("Frame: %.2f ms avg, %.2f ms stddev, %.2f ms worst", stats.frameMsAvg, stats.frameMsStdDev, stats.frameMsWorst);
+	ImGui::Text("Input to present: %.2f ms avg, %.2f ms worst", stats.latencyMsAvg, stats.latencyMsWorst);
+	ImGui::Text("Wait: %.2f ms sleep, %.2f ms spin, %.3f ms late", stats.sleepMsAvg, stats.spinMsAvg, stats.lateMsAvg);
+	ImGui::Text("GPU wait: %.2f ms, missed frames: %u", stats.gpuWaitMsAvg, stats.framesMissed);
+	ImGui::End();
+}
+
+void
+GUI::textureStreamingWindow(TextureStreamer& streamer) {
+	const double mb = 1024.0 * 1024.0;
+	ImGui::Begin("Texture Streaming");
+	TextureStreamerSettings settings = streamer.getSettings();
+	int budgetMb = static_cast<int>(settings.budgetBytes / (1024 * 1024));
+	bool changed = false;
+	if (ImGui::SliderInt("Budget (MB)", &budgetMb, 1, 1024)) {
+		settings.budgetBytes = static_cast<unsigned long long>(budgetMb) * 1024 * 1024;
+		changed = true;
+	}
+	changed |= ImGui::SliderFloat("Mip bias", &settings.mipBias, -2.0f, 4.0f, "%.1f");
+	if (changed) {
+		streamer.setSettings(settings);
+	}
+
+	const TextureStreamerStats& stats = streamer.getStats();
+	ImGui::Separator();
+	const float used = settings.budgetBytes > 0 ? static_cast<float>(stats.residentBytes) / static_cast<float>(settings.budgetBytes) : 0.0f;
+	ImGui::ProgressBar(used, ImVec2(-1.0f, 0.0f));
+	ImGui::Text("Resident: %.2f / %.2f MB (wanted %.2f MB, in flight %.2f MB)",
+		stats.residentBytes / mb, settings.budgetBytes / mb, stats.wantedBytes / mb, stats.reservedBytes / mb);
+	ImGui::Text("Textures: %u (%u visible, %u at wanted mip, %u pending)",
+		stats.textures, stats.visible, stats.satisfied, stats.pending);
+	ImGui::Text("Uploads: %u (%.2f MB, %.2f ms), evictions: %u, over budget: %u",
+		stats.uploads, stats.bytesUploaded / mb, stats.uploadMs, stats.evictions, stats.budgetMisses);
+
+	ImGui::Separator();
+	for (StreamHandle handle = 0; handle < streamer.getTextureCount(); ++handle) {
+		const StreamedTextureInfo info = streamer.getInfo(handle);
+		ImGui::Text("%s %ux%u", info.name.c_str(), info.width, info.height);
+		ImGui::Text("  mip %u (wants %u, tail %u of %u), %.2f MB, unused %llu frames%s",
+			info.residentMip, info.wantedMip, info.tailMip, info.levels,
+			info.residentBytes / mb, info.framesUnused, info.pending ? ", uploading" : "");
+	}
+	ImGui::End();
+}
@@ -0,0 +1,522 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "EngineUtilities/Utilities/ImageImporter.h"
+#include "EngineUtilities/Utilities/EngineStats.h"
+#include "EngineUtilities/Utilities/Hash.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+namespace {
+  // Versin del blob y de lo que lo produce (filtro de mips, codificador BCn):
+  // cambiarla invalida toda la cach
+  const uint32_t kCacheVersion = 1;
+  const uint32_t kCacheMagic = 0x474D494D;   // "MIMG"
+  const char* const kCacheDirectory = "TextureCache";
+
+  /** @brief Cabecera del blob; los niveles van detrs y los datos alineados a 16 bytes. */
+  struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t dxgiFormat;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint64_t dataBytes;
+  };
+
+  struct CacheLevel {
+    uint32_t width;
+    uint32_t height;
+    uint32_t rowPitch;
+    uint32_t reserved;
+    uint64_t offset;
+  };
+
+  std::mutex g_totalsMutex;
+  ImageCacheStats g_totals;
+  std::atomic<unsigned int> g_tempCounter(0);
+  std::atomic<bool> g_exportDds(false);
+
+  const uint32_t kDdsMagic = 0x20534444;       // "DDS "
+  const uint32_t kDdsFourCCDx10 = 0x30315844;  // "DX10"
+
+  struct DdsPixelFormat {
+    uint32_t size, flags, fourCC, rgbBitCount, rBitMask, gBitMask, bBitMask, aBitMask;
+  };
+
+  struct DdsHeader {
+    uint32_t size, flags, height, width, pitchOrLinearSize, depth, mipMapCount;
+    uint32_t reserved1[11];
+    DdsPixelFormat pixelFormat;
+    uint32_t caps, caps2, caps3, caps4, reserved2;
+  };
+
+  struct DdsHeaderDx10 {
+    uint32_t dxgiFormat, resourceDimension, miscFlag, arraySize, miscFlags2;
+  };
+
+  inline size_t
+  getDataOffset(unsigned int levelCount) {
+    const size_t tableEnd = sizeof(CacheHeader) + levelCount * sizeof(CacheLevel);
+    return (tableEnd + 15) & ~static_cast<size_t>(15);
+  }
+
+  // Filas que ocupa un nivel: de pxeles en RGBA8, de bloques de 4x4 en BCn
+  inline unsigned int
+  getRowCount(DXGI_FORMAT format, unsigned int height) {
+    return format == DXGI_FORMAT_R8G8B8A8_UNORM ? height : (height + 3) / 4;
+  }
+
+  bool
+  isSupportedFormat(uint32_t dxgiFormat) {
+    if (dxgiFormat == DXGI_FORMAT_R8G8B8A8_UNORM) {
+      return true;
+    }
+    const BcFormat formats[] = { BcFormat::BC1, BcFormat::BC3, BcFormat::BC4, BcFormat::BC5, BcFormat::BC7 };
+    for (BcFormat format : formats) {
+      if (static_cast<uint32_t>(BlockCompressor::getDxgiFormat(format)) == dxgiFormat) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  inline double
+  elapsedMs(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+  }
+
+  inline void
+  setError(std::string* error, const std::string& message) {
+    if (error) {
+      *error = message;
+    }
+  }
+}
+
+// =================================================================================
+// MAPPED FILE
+// =================================================================================
+
+MappedFile::MappedFile(MappedFile&& other) {
+  *this = std::move(other);
+}
+
+MappedFile&
+MappedFile::operator=(MappedFile&& other) {
+  if (this != &other) {
+    close();
+    m_file = other.m_file;
+    m_mapping = other.m_mapping;
+    m_data = other.m_data;
+    m_size = other.m_size;
+    other.m_file = INVALID_HANDLE_VALUE;
+    other.m_mapping = nullptr;
+    other.m_data = nullptr;
+    other.m_size = 0;
+  }
+  return *this;
+}
+
+bool
+MappedFile::open(const std::string& path) {
+  close();
+  m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (m_file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_file, &size) || size.QuadPart <= 0 ||
+      static_cast<unsigned long long>(size.QuadPart) > static_cast<size_t>(-1)) {
+    close();
+    return false;
+  }
+  m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_mapping) {
+    close();
+    return false;
+  }
+  m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!m_data) {
+    close();
+    return false;
+  }
+  m_size = static_cast<size_t>(size.QuadPart);
+  return true;
+}
+
+void
+MappedFile::close() {
+  if (m_data) {
+    UnmapViewOfFile(m_data);
+    m_data = nullptr;
+  }
+  if (m_mapping) {
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+  }
+  if (m_file != INVALID_HANDLE_VALUE) {
+    CloseHandle(m_file);
+    m_file = INVALID_HANDLE_VALUE;
+  }
+  m_size = 0;
+}
+
+// =================================================================================
+// IMPORTED IMAGE
+// =================================================================================
+
+void
+ImportedImage::getSubresources(std::vector<D3D11_SUBRESOURCE_DATA>& out) const {
+  const unsigned char* data = getData();
+  out.resize(levels.size());
+  for (size_t i = 0; i < levels.size(); ++i) {
+    out[i].pSysMem = data + levels[i].offset;
+    out[i].SysMemPitch = levels[i].rowPitch;
+    out[i].SysMemSlicePitch = 0;
+  }
+}
+
+void
+ImportedImage::reset() {
+  format = DXGI_FORMAT_R8G8B8A8_UNORM;
+  width = 0;
+  height = 0;
+  levels.clear();
+  fromCache = false;
+  std::vector<unsigned char>().swap(m_owned);
+  m_mapped.close();
+  m_dataOffset = 0;
+}
+
+// =================================================================================
+// IMAGE IMPORTER
+// =================================================================================
+
+namespace {
+  // Proyecta el blob y valida cabecera, tabla y tamaos contra el archivo; nada se copia
+  bool
+  openCached(const std::string& path, uint64_t key, ImportedImage& out, MappedFile& mapped, size_t& dataOffset) {
+    if (!mapped.open(path) || mapped.getSize() < sizeof(CacheHeader)) {
+      return false;
+    }
+    CacheHeader header;
+    std::memcpy(&header, mapped.getData(), sizeof(header));
+    if (header.magic != kCacheMagic || header.version != kCacheVersion || header.key != key ||
+        !isSupportedFormat(header.dxgiFormat) || header.width == 0 || header.height == 0 ||
+        header.levelCount == 0 || header.levelCount > MipGenerator::getLevelCount(header.width, header.height)) {
+      return false;
+    }
+    dataOffset = getDataOffset(header.levelCount);
+    if (mapped.getSize() < dataOffset || mapped.getSize() - dataOffset < header.dataBytes) {
+      return false;
+    }
+
+    const DXGI_FORMAT format = static_cast<DXGI_FORMAT>(header.dxgiFormat);
+    out.levels.resize(header.levelCount);
+    for (unsigned int i = 0; i < header.levelCount; ++i) {
+      CacheLevel level;
+      std::memcpy(&level, mapped.getData() + sizeof(CacheHeader) + i * sizeof(CacheLevel), sizeof(level));
+      const unsigned long long bytes = static_cast<unsigned long long>(level.rowPitch) * getRowCount(format, level.height);
+      if (level.width == 0 || level.height == 0 || level.offset > header.dataBytes ||
+          bytes > header.dataBytes - level.offset) {
+        return false;
+      }
+      out.levels[i].width = level.width;
+      out.levels[i].height = level.height;
+      out.levels[i].rowPitch = level.rowPitch;
+      out.levels[i].offset = static_cast<size_t>(level.offset);
+    }
+    out.format = format;
+    out.width = header.width;
+    out.height = header.height;
+    return true;
+  }
+
+  // Escribe en un temporal y lo renombra: otro hilo o proceso nunca ve un blob a medias
+  bool
+  writeCached(const std::string& path, uint64_t key, const ImportedImage& image, size_t dataBytes) {
+    CacheHeader header = {};
+    header.magic = kCacheMagic;
+    header.version = kCacheVersion;
+    header.key = key;
+    header.dxgiFormat = static_cast<uint32_t>(image.format);
+    header.width = image.width;
+    header.height = image.height;
+    header.levelCount = static_cast<uint32_t>(image.levels.size());
+    header.dataBytes = dataBytes;
+
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%lu_%u.tmp", static_cast<unsigned long>(GetCurrentThreadId()),
+             g_tempCounter.fetch_add(1));
+    const std::string tempPath = path + suffix;
+    {
+      std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+      if (!file) {
+        return false;
+      }
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      for (const ImportedLevel& imported : image.levels) {
+        CacheLevel level = {};
+        level.width = imported.width;
+        level.height = imported.height;
+        level.rowPitch = imported.rowPitch;
+        level.offset = imported.offset;
+        file.write(reinterpret_cast<const char*>(&level), sizeof(level));
+      }
+      const char padding[16] = {};
+      const size_t tableEnd = sizeof(CacheHeader) + image.levels.size() * sizeof(CacheLevel);
+      file.write(padding, getDataOffset(header.levelCount) - tableEnd);
+      file.write(reinterpret_cast<const char*>(image.getData()), dataBytes);
+      if (!file.good()) {
+        file.close();
+        DeleteFileA(tempPath.c_str());
+        return false;
+      }
+    }
+    if (!MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+      DeleteFileA(tempPath.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  // Copia .dds junto al blob (mismo nombre) si la exportacin est activa y an no existe
+  void
+  exportCachedDds(const std::string& cachePath, const ImportedImage& image) {
+    if (!g_exportDds.load()) {
+      return;
+    }
+    const std::string ddsPath = cachePath.substr(0, cachePath.find_last_of('.')) + ".dds";
+    if (GetFileAttributesA(ddsPath.c_str()) != INVALID_FILE_ATTRIBUTES) {
+      return;
+    }
+    std::string error;
+    const bool exported = ImageImporter::exportDds(image, ddsPath, &error);
+    if (!exported) {
+      ERROR("ImageImporter", "exportDds", error.c_str());
+    }
+    std::lock_guard<std::mutex> lock(g_totalsMutex);
+    if (exported) {
+      ++g_totals.ddsExports;
+    }
+    else {
+      ++g_totals.writeErrors;
+    }
+  }
+}
+
+bool
+ImageImporter::importFile(const std::string& path,
+                          const ImageImportSettings& settings,
+                          ImportedImage& out,
+                          std::string* error) {
+  PROFILE_SCOPE("ImageImporter::importFile");
+  const auto begin = std::chrono::steady_clock::now();
+  out.reset();
+
+  // El original se proyecta: el hash y stb_image lo leen sin copiarlo
+  MappedFile source;
+  if (!source.open(path)) {
+    setError(error, "Cannot read " + path);
+    return false;
+  }
+  uint64_t key = EU::hashValue(kCacheVersion);
+  key = EU::hashValue(static_cast<uint32_t>(settings.compression), key);
+  key = EU::hashValue(static_cast<uint32_t>(settings.generateMips), key);
+  key = EU::hashValue(static_cast<uint32_t>(settings.srgb), key);
+  key = EU::fnv1a64(source.getData(), source.getSize(), key);
+  const unsigned long long sourceBytes = source.getSize();
+
+  std::string cachePath;
+  if (settings.useCache) {
+    cachePath = getCachePath(path, key, settings);
+    if (openCached(cachePath, key, out, out.m_mapped, out.m_dataOffset)) {
+      out.fromCache = true;
+      exportCachedDds(cachePath, out);
+      const unsigned long long mappedBytes = out.m_mapped.getSize() - out.m_dataOffset;
+      ENGINE_STAT_ADD("image_cache_hits", 1);
+      ENGINE_STAT_ADD("image_cache_mapped_bytes", static_cast<long long>(mappedBytes));
+      std::lock_guard<std::mutex> lock(g_totalsMutex);
+      ++g_totals.imports;
+      ++g_totals.hits;
+      g_totals.sourceBytes += sourceBytes;
+      g_totals.mappedBytes += mappedBytes;
+      g_totals.hitMs += elapsedMs(begin);
+      return true;
+    }
+    out.reset();
+  }
+
+  int width = 0, height = 0, channels = 0;
+  unsigned char* pixels = stbi_load_from_memory(source.getData(), static_cast<int>(source.getSize()),
+                                                &width, &height, &channels, 4); // 4 bytes por pxel (RGBA)
+  if (!pixels) {
+    setError(error, path + ": " + stbi_failure_reason());
+    return false;
+  }
+  source.close();
+
+  // Cadena de mips en CPU, filtrada en espacio lineal
+  MipChain chain;
+  if (settings.generateMips) {
+    MipSettings mipSettings;
+    mipSettings.filter = MipFilter::Kaiser;
+    mipSettings.srgb = settings.srgb;
+    mipSettings.threadPool = settings.threadPool;
+    MipStats mipStats;
+    MipGenerator::generate(pixels, static_cast<unsigned int>(width), static_cast<unsigned int>(height),
+                           mipSettings, chain, &mipStats);
+    ENGINE_STAT_ADD("mip_chains", 1);
+    ENGINE_STAT_ADD("mip_source_pixels", static_cast<long long>(mipStats.sourcePixels));
+  }
+  else {
+    chain.levels.resize(1);
+    chain.levels[0].width = static_cast<unsigned int>(width);
+    chain.levels[0].height = static_cast<unsigned int>(height);
+    chain.data.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+  }
+  stbi_image_free(pixels); // La cadena ya lleva su copia del nivel 0
+
+  out.width = static_cast<unsigned int>(width);
+  out.height = static_cast<unsigned int>(height);
+  // D3D11 pide el nivel 0 de una textura BCn en mltiplos de 4; si no, se queda en RGBA8
+  if (settings.compression != BcFormat::None && BlockCompressor::canCompress(out.width, out.height)) {
+    BcSettings bcSettings;
+    bcSettings.format = settings.compression;
+    bcSettings.threadPool = settings.threadPool;
+    CompressedTexture compressed;
+    BcStats bcStats;
+    BlockCompressor::compressChain(chain, bcSettings, compressed, &bcStats);
+    ENGINE_STAT_ADD("bc_blocks", static_cast<long long>(bcStats.blocks));
+    out.format = BlockCompressor::getDxgiFormat(settings.compression);
+    out.levels.resize(compressed.levels.size());
+    for (size_t i = 0; i < compressed.levels.size(); ++i) {
+      out.levels[i].width = compressed.levels[i].width;
+      out.levels[i].height = compressed.levels[i].height;
+      out.levels[i].rowPitch = compressed.levels[i].rowPitch;
+      out.levels[i].offset = compressed.levels[i].offset;
+    }
+    out.m_owned.swap(compressed.data);
+  }
+  else {
+    out.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    out.levels.resize(chain.levels.size());
+    for (size_t i = 0; i < chain.levels.size(); ++i) {
+      out.levels[i].width = chain.levels[i].width;
+      out.levels[i].height = chain.levels[i].height;
+      out.levels[i].rowPitch = chain.levels[i].width * 4;
+      out.levels[i].offset = chain.levels[i].offset;
+    }
+    out.m_owned.swap(chain.data);
+  }
+
+  bool written = false;
+  if (settings.useCache) {
+    CreateDirectoryA(kCacheDirectory, nullptr);
+    written = writeCached(cachePath, key, out, out.m_owned.size());
+    exportCachedDds(cachePath, out);
+  }
+  ENGINE_STAT_ADD("image_cache_misses", 1);
+  std::lock_guard<std::mutex> lock(g_totalsMutex);
+  ++g_totals.imports;
+  ++g_totals.misses;
+  g_totals.sourceBytes += sourceBytes;
+  if (written) {
+    g_totals.writtenBytes += out.m_owned.size();
+  }
+  else if (settings.useCache) {
+    ++g_totals.writeErrors;
+  }
+  g_totals.missMs += elapsedMs(begin);
+  return true;
+}
+
+bool
+ImageImporter::exportDds(const ImportedImage& image, const std::string& path, std::string* error) {
+  if (image.levels.empty() || !isSupportedFormat(static_cast<uint32_t>(image.format))) {
+    setError(error, "Nothing to export to " + path);
+    return false;
+  }
+  const bool compressed = image.format != DXGI_FORMAT_R8G8B8A8_UNORM;
+  const ImportedLevel& top = image.levels[0];
+
+  DdsHeader header = {};
+  header.size = sizeof(DdsHeader);
+  // CAPS|HEIGHT|WIDTH|PIXELFORMAT|MIPMAPCOUNT y LINEARSIZE (BCn) o PITCH (RGBA8)
+  header.flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | (compressed ? 0x80000 : 0x8);
+  header.width = image.width;
+  header.height = image.height;
+  header.pitchOrLinearSize = compressed ? top.rowPitch * getRowCount(image.format, top.height) : top.rowPitch;
+  header.mipMapCount = static_cast<uint32_t>(image.levels.size());
+  header.pixelFormat.size = sizeof(DdsPixelFormat);
+  header.pixelFormat.flags = 0x4;   // FOURCC
+  header.pixelFormat.fourCC = kDdsFourCCDx10;
+  header.caps = 0x1000 | (image.levels.size() > 1 ? 0x400008 : 0);  // TEXTURE (| COMPLEX | MIPMAP)
+
+  DdsHeaderDx10 dx10 = {};
+  dx10.dxgiFormat = static_cast<uint32_t>(image.format);
+  dx10.resourceDimension = 3;       // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+  dx10.arraySize = 1;
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    setError(error, "Cannot write " + path);
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(&kDdsMagic), sizeof(kDdsMagic));
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(&dx10), sizeof(dx10));
+  // El DDS guarda los niveles seguidos y sin relleno entre filas, igual que la cach
+  for (const ImportedLevel& level : image.levels) {
+    const size_t bytes = static_cast<size_t>(level.rowPitch) * getRowCount(image.format, level.height);
+    file.write(reinterpret_cast<const char*>(image.getData() + level.offset), bytes);
+  }
+  if (!file.good()) {
+    setError(error, "Failed writing " + path);
+    return false;
+  }
+  return true;
+}
+
+void
+ImageImporter::setDdsExport(bool enabled) {
+  g_exportDds.store(enabled);
+}
+
+std::string
+ImageImporter::getCachePath(const std::string& path, uint64_t key, const ImageImportSettings& settings) {
+  // TextureCache/<nombre>_<formato>_<clave>.img; la clave es el contenido, no la fecha del archivo
+  const size_t slash = path.find_last_of("/\\");
+  const size_t dot = path.find_last_of('.');
+  const size_t begin = slash == std::string::npos ? 0 : slash + 1;
+  const std::string stem = path.substr(begin, dot != std::string::npos && dot > begin ? dot - begin : std::string::npos);
+  const char* format = settings.compression == BcFormat::None ? "RGBA8" : BlockCompressor::getName(settings.compression);
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key));
+  return std::string(kCacheDirectory) + "/" + stem + "_" + format + "_" + hex + ".img";
+}
+
+ImageCacheStats
+ImageImporter::getTotals() {
+  std::lock_guard<std::mutex> lock(g_totalsMutex);
+  return g_totals;
+}
+
+std::string
+ImageImporter::getReport() {
+  const ImageCacheStats stats = getTotals();
+  std::ostringstream report;
+  report << stats.hits << " hits (" << stats.mappedBytes << " bytes mapped in " << stats.hitMs << " ms), "
+         << stats.misses << " misses (" << stats.writtenBytes << " bytes written in " << stats.missMs << " ms), "
+         << stats.ddsExports << " DDS exports, " << stats.writeErrors << " write errors";
+  return report.str();
+}
@@ -0,0 +1,309 @@
+#include "EngineUtilities/Utilities/MipGenerator.h"
+#include "EngineUtilities/Utilities/ThreadPool.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include <xmmintrin.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace {
+  /** @brief Un tap del filtro: ndice de origen (ya recortado al borde) y peso. */
+  struct FilterTap {
+    unsigned int index;
+    float weight;
+  };
+
+  /** @brief Taps de cada pxel de destino en una dimensin. */
+  struct FilterTaps {
+    std::vector<unsigned int> first;    ///< Primer tap de cada destino (first[d + 1] marca el fin).
+    std::vector<FilterTap> taps;
+  };
+
+  /** @brief Filas por tarea al repartir un pase entre hilos. */
+  const unsigned int kRowsPerTask = 16;
+
+  const unsigned int kLinearToSrgbSize = 4096;
+
+  float g_srgbToLinear[256];
+  unsigned char g_linearToSrgb[kLinearToSrgbSize];
+  std::once_flag g_tablesOnce;
+
+  std::mutex g_totalsMutex;
+  MipStats g_totals;
+
+  void
+  buildTables() {
+    for (unsigned int i = 0; i < 256; ++i) {
+      const float c = i / 255.0f;
+      g_srgbToLinear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+    }
+    // 4096 entradas: el error de cuantizar a 8 bits domina sobre el de la tabla
+    for (unsigned int i = 0; i < kLinearToSrgbSize; ++i) {
+      const float l = i / static_cast<float>(kLinearToSrgbSize - 1);
+      const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+      g_linearToSrgb[i] = static_cast<unsigned char>(c * 255.0f + 0.5f);
+    }
+  }
+
+  /** @brief Funcin de Bessel modificada de orden 0 (serie de potencias). */
+  double
+  besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    const double halfSq = x * x * 0.25;
+    for (int k = 1; k < 32; ++k) {
+      term *= halfSq / (k * k);
+      sum += term;
+      if (term < sum * 1e-12) {
+        break;
+      }
+    }
+    return sum;
+  }
+
+  /**
+   * @brief Calcula los taps de reducir @p src pxeles a @p dst.
+   *
+   * Box pesa cada origen por cunto solapa el rea del destino. Kaiser evala un sinc
+   * escalado a la frecuencia de destino con radio de 1.5 pxeles de destino. Los taps que
+   * caen fuera se suman al pxel del borde, as que los pesos siempre suman 1.
+   */
+  void
+  buildTaps(unsigned int src, unsigned int dst, MipFilter filter, FilterTaps& out) {
+    out.first.assign(dst + 1, 0);
+    out.taps.clear();
+    const double scale = static_cast<double>(src) / dst;
+
+    for (unsigned int d = 0; d < dst; ++d) {
+      out.first[d] = static_cast<unsigned int>(out.taps.size());
+      if (src == dst) {
+        out.taps.push_back({ d, 1.0f });
+        continue;
+      }
+
+      double begin, end;
+      if (filter == MipFilter::Box) {
+        begin = d * scale;
+        end = (d + 1) * scale;
+      }
+      else {
+        const double radius = 1.5 * scale;
+        const double center = (d + 0.5) * scale;
+        begin = center - radius;
+        end = center + radius;
+      }
+
+      const size_t firstTap = out.taps.size();
+      double total = 0.0;
+      for (int s = static_cast<int>(floor(begin)); s < static_cast<int>(ceil(end)); ++s) {
+        double weight;
+        if (filter == MipFilter::Box) {
+          const double lo = s > begin ? s : begin;
+          const double hi = s + 1 < end ? s + 1 : end;
+          weight = hi - lo;
+        }
+        else {
+          // Distancia en pxeles de destino desde el centro de la muestra
+          const double x = ((s + 0.5) - (d + 0.5) * scale) / scale;
+          const double t = x / 1.5;
+          if (t <= -1.0 || t >= 1.0) {
+            continue;
+          }
+          const double sinc = fabs(x) < 1e-6 ? 1.0 : sin(3.14159265358979 * x) / (3.14159265358979 * x);
+          const double alpha = 4.0;
+          weight = sinc * besselI0(alpha * sqrt(1.0 - t * t)) / besselI0(alpha);
+        }
+        if (weight == 0.0) {
+          continue;
+        }
+        const unsigned int index = s < 0 ? 0 : (s >= static_cast<int>(src) ? src - 1 : static_cast<unsigned int>(s));
+        // Fuera de la imagen: se acumula en el borde en lugar de aadir otro tap
+        if (out.taps.size() > firstTap && out.taps.back().index == index) {
+          out.taps.back().weight += static_cast<float>(weight);
+        }
+        else {
+          out.taps.push_back({ index, static_cast<float>(weight) });
+        }
+        total += weight;
+      }
+      for (size_t i = firstTap; i < out.taps.size(); ++i) {
+        out.taps[i].weight = static_cast<float>(out.taps[i].weight / total);
+      }
+    }
+    out.first[dst] = static_cast<unsigned int>(out.taps.size());
+  }
+
+  /** @brief Ejecuta @p rows filas en bloques, repartidos entre hilos si compensa. */
+  void
+  forEachRowBlock(ThreadPool* pool,
+                  bool parallel,
+                  unsigned int rows,
+                  const std::function<void(unsigned int, unsigned int)>& block) {
+    const unsigned int blocks = (rows + kRowsPerTask - 1) / kRowsPerTask;
+    auto task = [&](unsigned int i) {
+      const unsigned int begin = i * kRowsPerTask;
+      const unsigned int end = begin + kRowsPerTask < rows ? begin + kRowsPerTask : rows;
+      block(begin, end);
+    };
+    if (pool && parallel) {
+      pool->parallelFor(blocks, task);
+    }
+    else {
+      for (unsigned int i = 0; i < blocks; ++i) {
+        task(i);
+      }
+    }
+  }
+
+  /** @brief Cuantiza un pxel lineal a RGBA8 (RGB por la tabla sRGB si procede). */
+  inline void
+  storePixel(__m128 pixel, bool srgb, unsigned char* out) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    pixel = _mm_min_ps(_mm_max_ps(pixel, zero), one);
+    float values[4];
+    _mm_storeu_ps(values, pixel);
+    for (int c = 0; c < 3; ++c) {
+      out[c] = srgb
+        ? g_linearToSrgb[static_cast<unsigned int>(values[c] * (kLinearToSrgbSize - 1) + 0.5f)]
+        : static_cast<unsigned char>(values[c] * 255.0f + 0.5f);
+    }
+    out[3] = static_cast<unsigned char>(values[3] * 255.0f + 0.5f);
+  }
+}
+
+unsigned int
+MipGenerator::getLevelCount(unsigned int width, unsigned int height) {
+  unsigned int size = width > height ? width : height;
+  unsigned int levels = 1;
+  while (size > 1) {
+    size >>= 1;
+    ++levels;
+  }
+  return levels;
+}
+
+bool
+MipGenerator::generate(const unsigned char* rgba,
+                       unsigned int width,
+                       unsigned int height,
+                       const MipSettings& settings,
+                       MipChain& out,
+                       MipStats* stats) {
+  PROFILE_SCOPE("MipGenerator::generate");
+  out.data.clear();
+  out.levels.clear();
+  if (!rgba || width == 0 || height == 0) {
+    return false;
+  }
+  std::call_once(g_tablesOnce, buildTables);
+  const auto begin = std::chrono::steady_clock::now();
+
+  // Distribucin de la cadena en un solo bloque
+  const unsigned int levelCount = getLevelCount(width, height);
+  size_t totalBytes = 0;
+  unsigned long long outputPixels = 0;
+  out.levels.resize(levelCount);
+  for (unsigned int i = 0; i < levelCount; ++i) {
+    MipLevel& level = out.levels[i];
+    level.width = (width >> i) > 0 ? (width >> i) : 1;
+    level.height = (height >> i) > 0 ? (height >> i) : 1;
+    level.offset = totalBytes;
+    totalBytes += static_cast<size_t>(level.width) * level.height * 4;
+    outputPixels += i > 0 ? static_cast<unsigned long long>(level.width) * level.height : 0;
+  }
+  out.data.resize(totalBytes);
+  memcpy(out.data.data(), rgba, static_cast<size_t>(width) * height * 4);
+
+  // Nivel actual en lineal; cada nivel sale del anterior en coma flotante, no de sus 8 bits.
+  // Floats sueltos y cargas sin alinear: en Win32 un vector de __m128 no garantiza 16 bytes
+  const bool srgb = settings.srgb;
+  const bool parallelSource = settings.threadPool && width * height >= settings.minParallelPixels;
+  std::vector<float> current(static_cast<size_t>(width) * height * 4);
+  forEachRowBlock(settings.threadPool, parallelSource, height, [&](unsigned int y0, unsigned int y1) {
+    const float inv255 = 1.0f / 255.0f;
+    for (unsigned int y = y0; y < y1; ++y) {
+      const unsigned char* src = rgba + static_cast<size_t>(y) * width * 4;
+      float* dst = current.data() + static_cast<size_t>(y) * width * 4;
+      for (unsigned int x = 0; x < width; ++x, src += 4, dst += 4) {
+        dst[0] = srgb ? g_srgbToLinear[src[0]] : src[0] * inv255;
+        dst[1] = srgb ? g_srgbToLinear[src[1]] : src[1] * inv255;
+        dst[2] = srgb ? g_srgbToLinear[src[2]] : src[2] * inv255;
+        dst[3] = src[3] * inv255;
+      }
+    }
+  });
+
+  std::vector<float> horizontal;
+  std::vector<float> next;
+  FilterTaps tapsX, tapsY;
+  for (unsigned int i = 1; i < levelCount; ++i) {
+    const MipLevel& source = out.levels[i - 1];
+    const MipLevel& target = out.levels[i];
+    const unsigned int sw = source.width, sh = source.height;
+    const unsigned int tw = target.width, th = target.height;
+    const bool parallel = settings.threadPool && sw * sh >= settings.minParallelPixels;
+    buildTaps(sw, tw, settings.filter, tapsX);
+    buildTaps(sh, th, settings.filter, tapsY);
+
+    // Pase horizontal: sh filas de tw pxeles
+    horizontal.resize(static_cast<size_t>(tw) * sh * 4);
+    forEachRowBlock(settings.threadPool, parallel, sh, [&](unsigned int y0, unsigned int y1) {
+      for (unsigned int y = y0; y < y1; ++y) {
+        const float* src = current.data() + static_cast<size_t>(y) * sw * 4;
+        float* dst = horizontal.data() + static_cast<size_t>(y) * tw * 4;
+        for (unsigned int x = 0; x < tw; ++x) {
+          __m128 sum = _mm_setzero_ps();
+          for (unsigned int t = tapsX.first[x]; t < tapsX.first[x + 1]; ++t) {
+            const __m128 pixel = _mm_loadu_ps(src + tapsX.taps[t].index * 4);
+            sum = _mm_add_ps(sum, _mm_mul_ps(pixel, _mm_set1_ps(tapsX.taps[t].weight)));
+          }
+          _mm_storeu_ps(dst + x * 4, sum);
+        }
+      }
+    });
+
+    // Pase vertical: cada fila de destino combina filas enteras (acceso secuencial)
+    next.resize(static_cast<size_t>(tw) * th * 4);
+    unsigned char* level = out.data.data() + target.offset;
+    forEachRowBlock(settings.threadPool, parallel, th, [&](unsigned int y0, unsigned int y1) {
+      for (unsigned int y = y0; y < y1; ++y) {
+        float* dst = next.data() + static_cast<size_t>(y) * tw * 4;
+        memset(dst, 0, static_cast<size_t>(tw) * 4 * sizeof(float));
+        for (unsigned int t = tapsY.first[y]; t < tapsY.first[y + 1]; ++t) {
+          const float* src = horizontal.data() + static_cast<size_t>(tapsY.taps[t].index) * tw * 4;
+          const __m128 weight = _mm_set1_ps(tapsY.taps[t].weight);
+          for (unsigned int x = 0; x < tw * 4; x += 4) {
+            _mm_storeu_ps(dst + x, _mm_add_ps(_mm_loadu_ps(dst + x), _mm_mul_ps(_mm_loadu_ps(src + x), weight)));
+          }
+        }
+        unsigned char* row = level + static_cast<size_t>(y) * tw * 4;
+        for (unsigned int x = 0; x < tw; ++x) {
+          storePixel(_mm_loadu_ps(dst + x * 4), srgb, row + x * 4);
+        }
+      }
+    });
+    current.swap(next);
+  }
+
+  MipStats chain;
+  chain.chains = 1;
+  chain.sourcePixels = static_cast<unsigned long long>(width) * height;
+  chain.outputPixels = outputPixels;
+  chain.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+  if (stats) {
+    *stats = chain;
+  }
+  std::lock_guard<std::mutex> lock(g_totalsMutex);
+  g_totals.chains += chain.chains;
+  g_totals.sourcePixels += chain.sourcePixels;
+  g_totals.outputPixels += chain.outputPixels;
+  g_totals.ms += chain.ms;
+  return true;
+}
+
+MipStats
+MipGenerator::getTotals() {
+  std::lock_guard<std::mutex> lock(g_totalsMutex);
+  return g_totals;
+}
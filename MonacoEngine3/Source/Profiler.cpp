@@ -0,0 +1,317 @@
+#include "EngineUtilities/Utilities/Profiler.h"
+#include "Device.h"
+#include "DeviceContext.h"
+
+long long
+Profiler::now() {
+  LARGE_INTEGER ticks;
+  QueryPerformanceCounter(&ticks);
+  return ticks.QuadPart;
+}
+
+HRESULT
+Profiler::init(Device* device) {
+  destroy();
+  LARGE_INTEGER frequency;
+  QueryPerformanceFrequency(&frequency);
+  m_msPerTick = 1000.0 / static_cast<double>(frequency.QuadPart);
+
+  // Toda la memoria de la historia se reserva aqu: dentro del frame no se pide nada
+  m_frames.assign(kHistory, ProfileFrame());
+  for (ProfileFrame& frame : m_frames) {
+    frame.cpuEvents.reserve(kMaxCpuScopes);
+    frame.gpuEvents.reserve(kMaxGpuScopes);
+  }
+  m_frameIndex = 0;
+  m_stats = ProfilerStats();
+
+  // Coste de un scope vaco, para estimar cunto del frame se lleva el propio profiler
+  const unsigned int calibrationScopes = 256;
+  const bool enabled = m_enabled;
+  const bool paused = m_paused;
+  m_enabled = true;
+  m_paused = false;
+  beginFrame(nullptr);
+  const long long start = now();
+  for (unsigned int i = 0; i < calibrationScopes; ++i) {
+    ProfileScope scope("Calibration");
+  }
+  m_stats.scopeCostUs = (now() - start) * m_msPerTick * 1000.0 / calibrationScopes;
+  m_frameOpen = false;
+  m_frames[0].cpuEvents.clear();
+  m_stats.cpuScopes = 0;
+  m_enabled = enabled;
+  m_paused = paused;
+
+  if (!device) {
+    return S_OK;
+  }
+  D3D11_QUERY_DESC disjointDesc = {};
+  disjointDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+  D3D11_QUERY_DESC timestampDesc = {};
+  timestampDesc.Query = D3D11_QUERY_TIMESTAMP;
+  HRESULT hr = S_OK;
+  m_gpuFrames.resize(kGpuLatency);
+  for (GpuFrame& gpuFrame : m_gpuFrames) {
+    gpuFrame.timestamps.assign(kMaxGpuScopes * 2, nullptr);
+    gpuFrame.scopes.reserve(kMaxGpuScopes);
+    hr = device->CreateQuery(&disjointDesc, &gpuFrame.disjoint);
+    if (SUCCEEDED(hr)) hr = device->CreateQuery(&timestampDesc, &gpuFrame.frameBegin);
+    if (SUCCEEDED(hr)) hr = device->CreateQuery(&timestampDesc, &gpuFrame.frameEnd);
+    for (unsigned int i = 0; SUCCEEDED(hr) && i < gpuFrame.timestamps.size(); ++i) {
+      hr = device->CreateQuery(&timestampDesc, &gpuFrame.timestamps[i]);
+    }
+    if (FAILED(hr)) {
+      break;
+    }
+  }
+  if (FAILED(hr)) {
+    // Sin consultas se sigue midiendo la CPU
+    ERROR("Profiler", "init", ("Failed to create timestamp queries; GPU timing disabled. HRESULT: " + std::to_string(hr)).c_str());
+    for (GpuFrame& gpuFrame : m_gpuFrames) {
+      SAFE_RELEASE(gpuFrame.disjoint);
+      SAFE_RELEASE(gpuFrame.frameBegin);
+      SAFE_RELEASE(gpuFrame.frameEnd);
+      for (ID3D11Query*& query : gpuFrame.timestamps) {
+        SAFE_RELEASE(query);
+      }
+    }
+    m_gpuFrames.clear();
+  }
+  return hr;
+}
+
+void
+Profiler::destroy() {
+  for (GpuFrame& gpuFrame : m_gpuFrames) {
+    SAFE_RELEASE(gpuFrame.disjoint);
+    SAFE_RELEASE(gpuFrame.frameBegin);
+    SAFE_RELEASE(gpuFrame.frameEnd);
+    for (ID3D11Query*& query : gpuFrame.timestamps) {
+      SAFE_RELEASE(query);
+    }
+  }
+  m_gpuFrames.clear();
+  m_gpuCurrent = nullptr;
+  m_frames.clear();
+  m_names.clear();
+  m_frameOpen = false;
+  m_cpuDepth = 0;
+  m_gpuDepth = 0;
+}
+
+void
+Profiler::beginFrame(DeviceContext* deviceContext) {
+  m_frameOpen = false;
+  m_gpuCurrent = nullptr;
+  if (!m_enabled || m_paused || m_frames.empty()) {
+    return;
+  }
+
+  if (deviceContext && !m_gpuFrames.empty()) {
+    // Del ms antiguo al ms nuevo; el que toca reutilizar y no termin se pierde
+    const unsigned int current = static_cast<unsigned int>(m_frameIndex % kGpuLatency);
+    for (unsigned int i = 0; i < kGpuLatency; ++i) {
+      GpuFrame& gpuFrame = m_gpuFrames[(current + i) % kGpuLatency];
+      if (gpuFrame.pending && resolveGpuFrame(*deviceContext, gpuFrame)) {
+        gpuFrame.pending = false;
+      }
+    }
+    GpuFrame& gpuFrame = m_gpuFrames[current];
+    if (gpuFrame.pending) {
+      ++m_stats.gpuFramesLost;
+      gpuFrame.pending = false;
+    }
+    gpuFrame.frameIndex = m_frameIndex;
+    gpuFrame.scopes.clear();
+    deviceContext->Begin(gpuFrame.disjoint);
+    deviceContext->End(gpuFrame.frameBegin);
+    m_gpuCurrent = &gpuFrame;
+  }
+
+  ProfileFrame& frame = m_frames[m_frameIndex % kHistory];
+  frame.index = m_frameIndex;
+  frame.cpuMs = 0.0;
+  frame.gpuMs = 0.0;
+  frame.gpuReady = false;
+  frame.cpuEvents.clear();
+  frame.gpuEvents.clear();
+  m_cpuDepth = 0;
+  m_gpuDepth = 0;
+  // Los otros hilos leen m_frameThread sin lock: slo se escribe si el hilo principal cambia
+  if (m_frameThread != std::this_thread::get_id()) {
+    m_frameThread = std::this_thread::get_id();
+  }
+  m_frameStart = now();
+  m_frameOpen.store(true, std::memory_order_release);
+}
+
+void
+Profiler::endFrame(DeviceContext* deviceContext) {
+  if (!m_frameOpen) {
+    return;
+  }
+  ProfileFrame& frame = m_frames[m_frameIndex % kHistory];
+  frame.cpuMs = (now() - m_frameStart) * m_msPerTick;
+  if (m_gpuCurrent && deviceContext) {
+    deviceContext->End(m_gpuCurrent->frameEnd);
+    deviceContext->End(m_gpuCurrent->disjoint);
+    m_gpuCurrent->pending = true;
+  }
+  m_gpuCurrent = nullptr;
+  ++m_stats.frames;
+  m_stats.overheadMs += frame.cpuEvents.size() * m_stats.scopeCostUs * 0.001;
+  ++m_frameIndex;
+  m_frameOpen.store(false, std::memory_order_release);
+}
+
+int
+Profiler::beginScope(const char* name) {
+  if (!m_frameOpen.load(std::memory_order_acquire) || std::this_thread::get_id() != m_frameThread) {
+    return -1;
+  }
+  ProfileFrame& frame = m_frames[m_frameIndex % kHistory];
+  if (frame.cpuEvents.size() >= kMaxCpuScopes || m_cpuDepth >= kMaxDepth) {
+    ++m_stats.droppedScopes;
+    return -1;
+  }
+  ProfileEvent event;
+  event.name = name;
+  event.depth = m_cpuDepth;
+  event.parent = m_cpuDepth > 0 ? m_cpuStack[m_cpuDepth - 1] : -1;
+  event.startMs = (now() - m_frameStart) * m_msPerTick;
+  event.endMs = event.startMs;
+  const int scope = static_cast<int>(frame.cpuEvents.size());
+  frame.cpuEvents.push_back(event);
+  m_cpuStack[m_cpuDepth++] = scope;
+  ++m_stats.cpuScopes;
+  return scope;
+}
+
+void
+Profiler::endScope(int scope) {
+  if (scope < 0 || !m_frameOpen.load(std::memory_order_acquire)) {
+    return;
+  }
+  ProfileFrame& frame = m_frames[m_frameIndex % kHistory];
+  if (scope >= static_cast<int>(frame.cpuEvents.size())) {
+    return;
+  }
+  frame.cpuEvents[scope].endMs = (now() - m_frameStart) * m_msPerTick;
+  while (m_cpuDepth > 0) {
+    if (m_cpuStack[--m_cpuDepth] == scope) {
+      break;
+    }
+  }
+}
+
+int
+Profiler::beginGpuScope(DeviceContext& deviceContext, const char* name) {
+  if (!m_gpuCurrent || std::this_thread::get_id() != m_frameThread) {
+    return -1;
+  }
+  if (m_gpuCurrent->scopes.size() >= kMaxGpuScopes || m_gpuDepth >= kMaxDepth) {
+    ++m_stats.droppedScopes;
+    return -1;
+  }
+  // endMs < 0 marca que an no se escribi el timestamp de fin
+  ProfileEvent event;
+  event.name = name;
+  event.depth = m_gpuDepth;
+  event.parent = m_gpuDepth > 0 ? m_gpuStack[m_gpuDepth - 1] : -1;
+  event.endMs = -1.0;
+  const int scope = static_cast<int>(m_gpuCurrent->scopes.size());
+  m_gpuCurrent->scopes.push_back(event);
+  deviceContext.End(m_gpuCurrent->timestamps[scope * 2]);
+  m_gpuStack[m_gpuDepth++] = scope;
+  ++m_stats.gpuScopes;
+  return scope;
+}
+
+void
+Profiler::endGpuScope(DeviceContext& deviceContext, int scope) {
+  if (!m_gpuCurrent || scope < 0 || scope >= static_cast<int>(m_gpuCurrent->scopes.size())) {
+    return;
+  }
+  deviceContext.End(m_gpuCurrent->timestamps[scope * 2 + 1]);
+  m_gpuCurrent->scopes[scope].endMs = 0.0;
+  while (m_gpuDepth > 0) {
+    if (m_gpuStack[--m_gpuDepth] == scope) {
+      break;
+    }
+  }
+}
+
+bool
+Profiler::resolveGpuFrame(DeviceContext& deviceContext, GpuFrame& gpuFrame) {
+  // DONOTFLUSH: preguntar no debe obligar al driver a vaciar su cola
+  D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+  HRESULT hr = deviceContext.GetData(gpuFrame.disjoint, &disjoint, sizeof(disjoint),
+                                     D3D11_ASYNC_GETDATA_DONOTFLUSH);
+  if (hr == S_FALSE) {
+    return false;
+  }
+  if (FAILED(hr)) {
+    ++m_stats.gpuFramesLost;
+    return true;
+  }
+  if (disjoint.Disjoint || disjoint.Frequency == 0) {
+    ++m_stats.gpuFramesDisjoint;
+    return true;
+  }
+  UINT64 frameBegin = 0;
+  UINT64 frameEnd = 0;
+  if (deviceContext.GetData(gpuFrame.frameBegin, &frameBegin, sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+      deviceContext.GetData(gpuFrame.frameEnd, &frameEnd, sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+    ++m_stats.gpuFramesLost;
+    return true;
+  }
+  ++m_stats.gpuFramesResolved;
+
+  // El frame puede haber salido ya de la historia (o estar en pausa sobre otro)
+  ProfileFrame& frame = m_frames[gpuFrame.frameIndex % kHistory];
+  if (frame.index != gpuFrame.frameIndex || m_frameIndex - gpuFrame.frameIndex >= kHistory) {
+    return true;
+  }
+  const double msPerTick = 1000.0 / static_cast<double>(disjoint.Frequency);
+  frame.gpuMs = (frameEnd - frameBegin) * msPerTick;
+  frame.gpuEvents.clear();
+  for (unsigned int i = 0; i < gpuFrame.scopes.size(); ++i) {
+    // Un scope sin fin o sin dato queda vaco pero en su sitio: los padres son ndices
+    ProfileEvent event = gpuFrame.scopes[i];
+    event.startMs = 0.0;
+    event.endMs = 0.0;
+    UINT64 scopeBegin = 0;
+    UINT64 scopeEnd = 0;
+    if (gpuFrame.scopes[i].endMs >= 0.0 &&
+        deviceContext.GetData(gpuFrame.timestamps[i * 2], &scopeBegin, sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK &&
+        deviceContext.GetData(gpuFrame.timestamps[i * 2 + 1], &scopeEnd, sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK) {
+      event.startMs = (scopeBegin - frameBegin) * msPerTick;
+      event.endMs = (scopeEnd - frameBegin) * msPerTick;
+    }
+    frame.gpuEvents.push_back(event);
+  }
+  frame.gpuReady = true;
+  return true;
+}
+
+const char*
+Profiler::internName(const std::string& name) {
+  return m_names.insert(name).first->c_str();
+}
+
+unsigned int
+Profiler::getFrameCount() const {
+  // La ranura del frame abierto es la ms antigua de la historia: no cuenta
+  const unsigned long long available = m_frameIndex < kHistory - 1 ? m_frameIndex : kHistory - 1;
+  return m_frames.empty() ? 0 : static_cast<unsigned int>(available);
+}
+
+const ProfileFrame&
+Profiler::getFrame(unsigned int age) const {
+  static const ProfileFrame empty;
+  if (age >= getFrameCount()) {
+    return empty;
+  }
+  return m_frames[(m_frameIndex - 1 - age) % kHistory];
+}
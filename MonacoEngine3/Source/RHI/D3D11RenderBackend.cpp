@@ -0,0 +1,574 @@
+#include "RHI/D3D11RenderBackend.h"
+#include "Device.h"
+#include "DeviceContext.h"
+
+HRESULT
+D3D11RenderBackend::init(Device& device, DeviceContext& deviceContext) {
+  if (!device.m_device) {
+    ERROR("D3D11RenderBackend", "init", "Device is nullptr");
+    return E_POINTER;
+  }
+  if (!deviceContext.m_deviceContext) {
+    ERROR("D3D11RenderBackend", "init", "DeviceContext is nullptr");
+    return E_POINTER;
+  }
+
+  bindNative(device.m_device, deviceContext.m_deviceContext);
+
+  D3D11_FEATURE_DATA_THREADING threading = {};
+  if (SUCCEEDED(m_device->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading))) &&
+      !threading.DriverCommandLists) {
+    MESSAGE("D3D11RenderBackend", "init", "Driver command lists unavailable, deferred contexts are emulated by the runtime.");
+  }
+
+  MESSAGE("D3D11RenderBackend", "init", "Render backend bound to D3D11 device.");
+  return S_OK;
+}
+
+void
+D3D11RenderBackend::bindNative(ID3D11Device* device, ID3D11DeviceContext* deviceContext) {
+  m_device = device;
+  m_deviceContext = deviceContext;
+  m_stats.reset();
+
+  // D3D11.1: rangos de constant buffer + NO_OVERWRITE sobre constant buffers
+  m_constantBufferOffsets = false;
+  SAFE_RELEASE(m_deviceContext1);
+  if (SUCCEEDED(m_deviceContext->QueryInterface(__uuidof(ID3D11DeviceContext1),
+                                                reinterpret_cast<void**>(&m_deviceContext1)))) {
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+    if (SUCCEEDED(m_device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options)))) {
+      m_constantBufferOffsets = options.ConstantBufferOffsetting &&
+                                options.MapNoOverwriteOnDynamicConstantBuffer;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Contextos diferidos
+// -----------------------------------------------------------------------------
+
+HRESULT
+D3D11RenderBackend::createDeferredContext(DeviceContext& deferredContext,
+                                          std::unique_ptr<IRenderBackend>& deferredBackend) {
+  if (!m_device) {
+    ERROR("D3D11RenderBackend", "createDeferredContext", "Device is nullptr");
+    return E_POINTER;
+  }
+  if (deferredContext.m_deviceContext) {
+    ERROR("D3D11RenderBackend", "createDeferredContext", "DeviceContext already initialized");
+    return E_FAIL;
+  }
+
+  // El DeviceContext queda como dueo del contexto nativo, igual que el inmediato
+  HRESULT hr = m_device->CreateDeferredContext(0, &deferredContext.m_deviceContext);
+  if (FAILED(hr)) {
+    ERROR("D3D11RenderBackend", "createDeferredContext",
+      ("Failed to create deferred context. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
+  }
+
+  auto backend = std::make_unique<D3D11RenderBackend>();
+  backend->bindNative(m_device, deferredContext.m_deviceContext);
+  deferredContext.setBackend(backend.get());
+  deferredBackend = std::move(backend);
+  return S_OK;
+}
+
+HRESULT
+D3D11RenderBackend::finishCommandList(std::unique_ptr<IRenderCommandList>& commandList) {
+  ID3D11CommandList* nativeList = nullptr;
+  // FALSE: el contexto diferido vuelve al estado por defecto para la prxima grabacin
+  HRESULT hr = m_deviceContext->FinishCommandList(FALSE, &nativeList);
+  if (FAILED(hr)) {
+    ERROR("D3D11RenderBackend", "finishCommandList",
+      ("Failed to finish command list. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
+  }
+  commandList = std::make_unique<D3D11CommandList>(nativeList);
+  return S_OK;
+}
+
+void
+D3D11RenderBackend::executeCommandList(IRenderCommandList& commandList) {
+  D3D11CommandList* nativeList = dynamic_cast<D3D11CommandList*>(&commandList);
+  if (!nativeList || !nativeList->getNative()) {
+    ERROR("D3D11RenderBackend", "executeCommandList", "Command list was not recorded by a D3D11 backend");
+    return;
+  }
+  m_deviceContext->ExecuteCommandList(nativeList->getNative(), FALSE);
+}
+
+void
+D3D11RenderBackend::destroy() {
+  SAFE_RELEASE(m_deviceContext1);
+  m_constantBufferOffsets = false;
+  m_device = nullptr;
+  m_deviceContext = nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// Creacion de recursos
+// -----------------------------------------------------------------------------
+
+HRESULT
+D3D11RenderBackend::CreateBuffer(const D3D11_BUFFER_DESC* pDesc,
+                                 const D3D11_SUBRESOURCE_DATA* pInitialData,
+                                 ID3D11Buffer** ppBuffer) {
+  HRESULT hr = m_device->CreateBuffer(pDesc, pInitialData, ppBuffer);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+    if (pInitialData) {
+      m_stats.bytesUploaded += pDesc->ByteWidth;
+    }
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateTexture2D(const D3D11_TEXTURE2D_DESC* pDesc,
+                                    const D3D11_SUBRESOURCE_DATA* pInitialData,
+                                    ID3D11Texture2D** ppTexture2D) {
+  HRESULT hr = m_device->CreateTexture2D(pDesc, pInitialData, ppTexture2D);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+    m_stats.bytesUploaded += computeInitialDataSize(pDesc, pInitialData);
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateShaderResourceView(ID3D11Resource* pResource,
+                                             const D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc,
+                                             ID3D11ShaderResourceView** ppSRView) {
+  HRESULT hr = m_device->CreateShaderResourceView(pResource, pDesc, ppSRView);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateShaderResourceViewFromFile(const std::string& fileName,
+                                                     ID3D11ShaderResourceView** ppSRView) {
+  HRESULT hr = D3DX11CreateShaderResourceViewFromFile(m_device,
+                                                      fileName.c_str(),
+                                                      nullptr,
+                                                      nullptr,
+                                                      ppSRView,
+                                                      nullptr);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateRenderTargetView(ID3D11Resource* pResource,
+                                           const D3D11_RENDER_TARGET_VIEW_DESC* pDesc,
+                                           ID3D11RenderTargetView** ppRTView) {
+  HRESULT hr = m_device->CreateRenderTargetView(pResource, pDesc, ppRTView);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateDepthStencilView(ID3D11Resource* pResource,
+                                           const D3D11_DEPTH_STENCIL_VIEW_DESC* pDesc,
+                                           ID3D11DepthStencilView** ppDepthStencilView) {
+  HRESULT hr = m_device->CreateDepthStencilView(pResource, pDesc, ppDepthStencilView);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateVertexShader(const void* pShaderBytecode,
+                                       SIZE_T BytecodeLength,
+                                       ID3D11ClassLinkage* pClassLinkage,
+                                       ID3D11VertexShader** ppVertexShader) {
+  HRESULT hr = m_device->CreateVertexShader(pShaderBytecode,
+                                            BytecodeLength,
+                                            pClassLinkage,
+                                            ppVertexShader);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreatePixelShader(const void* pShaderBytecode,
+                                      SIZE_T BytecodeLength,
+                                      ID3D11ClassLinkage* pClassLinkage,
+                                      ID3D11PixelShader** ppPixelShader) {
+  HRESULT hr = m_device->CreatePixelShader(pShaderBytecode,
+                                           BytecodeLength,
+                                           pClassLinkage,
+                                           ppPixelShader);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* pInputElementDescs,
+                                      UINT NumElements,
+                                      const void* pShaderBytecodeWithInputSignature,
+                                      SIZE_T BytecodeLength,
+                                      ID3D11InputLayout** ppInputLayout) {
+  HRESULT hr = m_device->CreateInputLayout(pInputElementDescs,
+                                           NumElements,
+                                           pShaderBytecodeWithInputSignature,
+                                           BytecodeLength,
+                                           ppInputLayout);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateSamplerState(const D3D11_SAMPLER_DESC* pSamplerDesc,
+                                       ID3D11SamplerState** ppSamplerState) {
+  HRESULT hr = m_device->CreateSamplerState(pSamplerDesc, ppSamplerState);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateBlendState(const D3D11_BLEND_DESC* pBlendStateDesc,
+                                     ID3D11BlendState** ppBlendState) {
+  HRESULT hr = m_device->CreateBlendState(pBlendStateDesc, ppBlendState);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateRasterizerState(const D3D11_RASTERIZER_DESC* pRasterizerDesc,
+                                          ID3D11RasterizerState** ppRasterizerState) {
+  HRESULT hr = m_device->CreateRasterizerState(pRasterizerDesc, ppRasterizerState);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* pDepthStencilDesc,
+                                            ID3D11DepthStencilState** ppDepthStencilState) {
+  HRESULT hr = m_device->CreateDepthStencilState(pDepthStencilDesc, ppDepthStencilState);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+HRESULT
+D3D11RenderBackend::CheckMultisampleQualityLevels(DXGI_FORMAT Format,
+                                                  UINT SampleCount,
+                                                  UINT* pNumQualityLevels) {
+  return m_device->CheckMultisampleQualityLevels(Format, SampleCount, pNumQualityLevels);
+}
+
+HRESULT
+D3D11RenderBackend::CreateQuery(const D3D11_QUERY_DESC* pQueryDesc,
+                                ID3D11Query** ppQuery) {
+  HRESULT hr = m_device->CreateQuery(pQueryDesc, ppQuery);
+  if (SUCCEEDED(hr)) {
+    ++m_stats.resourcesCreated;
+  }
+  return hr;
+}
+
+// -----------------------------------------------------------------------------
+// Comandos de contexto
+// -----------------------------------------------------------------------------
+
+void
+D3D11RenderBackend::RSSetViewports(unsigned int NumViewports,
+                                   const D3D11_VIEWPORT* pViewports) {
+  ++m_stats.stateChanges;
+  m_deviceContext->RSSetViewports(NumViewports, pViewports);
+}
+
+void
+D3D11RenderBackend::RSSetState(ID3D11RasterizerState* pRasterizerState) {
+  ++m_stats.stateChanges;
+  m_deviceContext->RSSetState(pRasterizerState);
+}
+
+void
+D3D11RenderBackend::IASetInputLayout(ID3D11InputLayout* pInputLayout) {
+  ++m_stats.stateChanges;
+  m_deviceContext->IASetInputLayout(pInputLayout);
+}
+
+void
+D3D11RenderBackend::IASetVertexBuffers(unsigned int StartSlot,
+                                       unsigned int NumBuffers,
+                                       ID3D11Buffer* const* ppVertexBuffers,
+                                       const unsigned int* pStrides,
+                                       const unsigned int* pOffsets) {
+  ++m_stats.stateChanges;
+  m_deviceContext->IASetVertexBuffers(StartSlot, NumBuffers, ppVertexBuffers, pStrides, pOffsets);
+}
+
+void
+D3D11RenderBackend::IASetIndexBuffer(ID3D11Buffer* pIndexBuffer,
+                                     DXGI_FORMAT Format,
+                                     unsigned int Offset) {
+  ++m_stats.stateChanges;
+  m_deviceContext->IASetIndexBuffer(pIndexBuffer, Format, Offset);
+}
+
+void
+D3D11RenderBackend::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) {
+  ++m_stats.stateChanges;
+  m_deviceContext->IASetPrimitiveTopology(Topology);
+}
+
+void
+D3D11RenderBackend::VSSetShader(ID3D11VertexShader* pVertexShader,
+                                ID3D11ClassInstance* const* ppClassInstances,
+                                unsigned int NumClassInstances) {
+  ++m_stats.stateChanges;
+  m_deviceContext->VSSetShader(pVertexShader, ppClassInstances, NumClassInstances);
+}
+
+void
+D3D11RenderBackend::PSSetShader(ID3D11PixelShader* pPixelShader,
+                                ID3D11ClassInstance* const* ppClassInstances,
+                                unsigned int NumClassInstances) {
+  ++m_stats.stateChanges;
+  m_deviceContext->PSSetShader(pPixelShader, ppClassInstances, NumClassInstances);
+}
+
+void
+D3D11RenderBackend::VSSetConstantBuffers(unsigned int StartSlot,
+                                         unsigned int NumBuffers,
+                                         ID3D11Buffer* const* ppConstantBuffers) {
+  ++m_stats.stateChanges;
+  m_deviceContext->VSSetConstantBuffers(StartSlot, NumBuffers, ppConstantBuffers);
+}
+
+void
+D3D11RenderBackend::PSSetConstantBuffers(unsigned int StartSlot,
+                                         unsigned int NumBuffers,
+                                         ID3D11Buffer* const* ppConstantBuffers) {
+  ++m_stats.stateChanges;
+  m_deviceContext->PSSetConstantBuffers(StartSlot, NumBuffers, ppConstantBuffers);
+}
+
+void
+D3D11RenderBackend::VSSetConstantBuffers1(unsigned int StartSlot,
+                                          unsigned int NumBuffers,
+                                          ID3D11Buffer* const* ppConstantBuffers,
+                                          const unsigned int* pFirstConstant,
+                                          const unsigned int* pNumConstants) {
+  ++m_stats.stateChanges;
+  if (!m_deviceContext1) {
+    ERROR("D3D11RenderBackend", "VSSetConstantBuffers1", "D3D11.1 context not available");
+    m_deviceContext->VSSetConstantBuffers(StartSlot, NumBuffers, ppConstantBuffers);
+    return;
+  }
+  m_deviceContext1->VSSetConstantBuffers1(StartSlot, NumBuffers, ppConstantBuffers,
+                                          pFirstConstant, pNumConstants);
+}
+
+void
+D3D11RenderBackend::PSSetConstantBuffers1(unsigned int StartSlot,
+                                          unsigned int NumBuffers,
+                                          ID3D11Buffer* const* ppConstantBuffers,
+                                          const unsigned int* pFirstConstant,
+                                          const unsigned int* pNumConstants) {
+  ++m_stats.stateChanges;
+  if (!m_deviceContext1) {
+    ERROR("D3D11RenderBackend", "PSSetConstantBuffers1", "D3D11.1 context not available");
+    m_deviceContext->PSSetConstantBuffers(StartSlot, NumBuffers, ppConstantBuffers);
+    return;
+  }
+  m_deviceContext1->PSSetConstantBuffers1(StartSlot, NumBuffers, ppConstantBuffers,
+                                          pFirstConstant, pNumConstants);
+}
+
+void
+D3D11RenderBackend::PSSetShaderResources(unsigned int StartSlot,
+                                         unsigned int NumViews,
+                                         ID3D11ShaderResourceView* const* ppShaderResourceViews) {
+  ++m_stats.stateChanges;
+  m_deviceContext->PSSetShaderResources(StartSlot, NumViews, ppShaderResourceViews);
+}
+
+void
+D3D11RenderBackend::PSSetSamplers(unsigned int StartSlot,
+                                  unsigned int NumSamplers,
+                                  ID3D11SamplerState* const* ppSamplers) {
+  ++m_stats.stateChanges;
+  m_deviceContext->PSSetSamplers(StartSlot, NumSamplers, ppSamplers);
+}
+
+void
+D3D11RenderBackend::OMSetBlendState(ID3D11BlendState* pBlendState,
+                                    const float BlendFactor[4],
+                                    unsigned int SampleMask) {
+  ++m_stats.stateChanges;
+  m_deviceContext->OMSetBlendState(pBlendState, BlendFactor, SampleMask);
+}
+
+void
+D3D11RenderBackend::OMSetDepthStencilState(ID3D11DepthStencilState* pDepthStencilState,
+                                           unsigned int StencilRef) {
+  ++m_stats.stateChanges;
+  m_deviceContext->OMSetDepthStencilState(pDepthStencilState, StencilRef);
+}
+
+void
+D3D11RenderBackend::OMSetRenderTargets(unsigned int NumViews,
+                                       ID3D11RenderTargetView* const* ppRenderTargetViews,
+                                       ID3D11DepthStencilView* pDepthStencilView) {
+  ++m_stats.stateChanges;
+  m_deviceContext->OMSetRenderTargets(NumViews, ppRenderTargetViews, pDepthStencilView);
+}
+
+void
+D3D11RenderBackend::ClearRenderTargetView(ID3D11RenderTargetView* pRenderTargetView,
+                                          const float ColorRGBA[4]) {
+  ++m_stats.clears;
+  m_deviceContext->ClearRenderTargetView(pRenderTargetView, ColorRGBA);
+}
+
+void
+D3D11RenderBackend::ClearDepthStencilView(ID3D11DepthStencilView* pDepthStencilView,
+                                          unsigned int ClearFlags,
+                                          float Depth,
+                                          UINT8 Stencil) {
+  ++m_stats.clears;
+  m_deviceContext->ClearDepthStencilView(pDepthStencilView, ClearFlags, Depth, Stencil);
+}
+
+void
+D3D11RenderBackend::UpdateSubresource(ID3D11Resource* pDstResource,
+                                      unsigned int DstSubresource,
+                                      const D3D11_BOX* pDstBox,
+                                      const void* pSrcData,
+                                      unsigned int SrcRowPitch,
+                                      unsigned int SrcDepthPitch) {
+  m_stats.bytesUploaded += computeUploadSize(pDstResource,
+                                             DstSubresource,
+                                             pDstBox,
+                                             SrcRowPitch,
+                                             SrcDepthPitch);
+  m_deviceContext->UpdateSubresource(pDstResource,
+                                     DstSubresource,
+                                     pDstBox,
+                                     pSrcData,
+                                     SrcRowPitch,
+                                     SrcDepthPitch);
+}
+
+void
+D3D11RenderBackend::CopySubresourceRegion(ID3D11Resource* pDstResource,
+                                          unsigned int DstSubresource,
+                                          unsigned int DstX,
+                                          unsigned int DstY,
+                                          unsigned int DstZ,
+                                          ID3D11Resource* pSrcResource,
+                                          unsigned int SrcSubresource,
+                                          const D3D11_BOX* pSrcBox) {
+  m_stats.bytesCopied += computeCopySize(pSrcResource, pSrcBox);
+  m_deviceContext->CopySubresourceRegion(pDstResource,
+                                         DstSubresource,
+                                         DstX,
+                                         DstY,
+                                         DstZ,
+                                         pSrcResource,
+                                         SrcSubresource,
+                                         pSrcBox);
+}
+
+void
+D3D11RenderBackend::GenerateMips(ID3D11ShaderResourceView* pShaderResourceView) {
+  m_deviceContext->GenerateMips(pShaderResourceView);
+}
+
+void
+D3D11RenderBackend::ResolveSubresource(ID3D11Resource* pDstResource,
+                                       unsigned int DstSubresource,
+                                       ID3D11Resource* pSrcResource,
+                                       unsigned int SrcSubresource,
+                                       DXGI_FORMAT Format) {
+  m_deviceContext->ResolveSubresource(pDstResource, DstSubresource, pSrcResource, SrcSubresource, Format);
+}
+
+void
+D3D11RenderBackend::DrawIndexed(unsigned int IndexCount,
+                                unsigned int StartIndexLocation,
+                                int BaseVertexLocation) {
+  ++m_stats.drawCalls;
+  m_stats.indicesSubmitted += IndexCount;
+  m_deviceContext->DrawIndexed(IndexCount, StartIndexLocation, BaseVertexLocation);
+}
+
+void
+D3D11RenderBackend::DrawIndexedInstanced(unsigned int IndexCountPerInstance,
+                                         unsigned int InstanceCount,
+                                         unsigned int StartIndexLocation,
+                                         int BaseVertexLocation,
+                                         unsigned int StartInstanceLocation) {
+  ++m_stats.drawCalls;
+  ++m_stats.instancedDrawCalls;
+  m_stats.instancesSubmitted += InstanceCount;
+  m_stats.indicesSubmitted += static_cast<unsigned long long>(IndexCountPerInstance) * InstanceCount;
+  m_deviceContext->DrawIndexedInstanced(IndexCountPerInstance,
+                                        InstanceCount,
+                                        StartIndexLocation,
+                                        BaseVertexLocation,
+                                        StartInstanceLocation);
+}
+
+HRESULT
+D3D11RenderBackend::Map(ID3D11Resource* pResource,
+                        unsigned int Subresource,
+                        D3D11_MAP MapType,
+                        unsigned int MapFlags,
+                        D3D11_MAPPED_SUBRESOURCE* pMappedResource) {
+  ++m_stats.maps;
+  return m_deviceContext->Map(pResource, Subresource, MapType, MapFlags, pMappedResource);
+}
+
+void
+D3D11RenderBackend::Unmap(ID3D11Resource* pResource, unsigned int Subresource) {
+  m_deviceContext->Unmap(pResource, Subresource);
+}
+
+void
+D3D11RenderBackend::Begin(ID3D11Asynchronous* pAsync) {
+  m_deviceContext->Begin(pAsync);
+}
+
+void
+D3D11RenderBackend::End(ID3D11Asynchronous* pAsync) {
+  m_deviceContext->End(pAsync);
+}
+
+HRESULT
+D3D11RenderBackend::GetData(ID3D11Asynchronous* pAsync,
+                            void* pData,
+                            unsigned int DataSize,
+                            unsigned int GetDataFlags) {
+  return m_deviceContext->GetData(pAsync, pData, DataSize, GetDataFlags);
+}
+
+void
+D3D11RenderBackend::ClearState() {
+  m_deviceContext->ClearState();
+}
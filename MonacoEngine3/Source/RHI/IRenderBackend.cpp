@@ -0,0 +1,128 @@
+#include "RHI/IRenderBackend.h"
+
+unsigned long long
+IRenderBackend::computeUploadSize(ID3D11Resource* pDstResource,
+                                  unsigned int DstSubresource,
+                                  const D3D11_BOX* pDstBox,
+                                  unsigned int SrcRowPitch,
+                                  unsigned int SrcDepthPitch) {
+  if (!pDstResource) {
+    return 0;
+  }
+
+  D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+  pDstResource->GetType(&dimension);
+
+  if (dimension == D3D11_RESOURCE_DIMENSION_BUFFER) {
+    if (pDstBox) {
+      return pDstBox->right - pDstBox->left;
+    }
+    D3D11_BUFFER_DESC desc = {};
+    static_cast<ID3D11Buffer*>(pDstResource)->GetDesc(&desc);
+    return desc.ByteWidth;
+  }
+
+  if (dimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
+    if (SrcDepthPitch != 0) {
+      return SrcDepthPitch;
+    }
+    if (pDstBox) {
+      return static_cast<unsigned long long>(SrcRowPitch) * (pDstBox->bottom - pDstBox->top);
+    }
+    D3D11_TEXTURE2D_DESC desc = {};
+    static_cast<ID3D11Texture2D*>(pDstResource)->GetDesc(&desc);
+    unsigned int mip = desc.MipLevels ? DstSubresource % desc.MipLevels : 0;
+    unsigned int height = desc.Height >> mip;
+    return static_cast<unsigned long long>(SrcRowPitch) * (height ? height : 1);
+  }
+
+  return SrcDepthPitch ? SrcDepthPitch : SrcRowPitch;
+}
+
+unsigned long long
+IRenderBackend::computeCopySize(ID3D11Resource* pSrcResource,
+                                const D3D11_BOX* pSrcBox) {
+  if (!pSrcResource) {
+    return 0;
+  }
+
+  D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+  pSrcResource->GetType(&dimension);
+
+  if (dimension == D3D11_RESOURCE_DIMENSION_BUFFER) {
+    if (pSrcBox) {
+      return pSrcBox->right > pSrcBox->left ? pSrcBox->right - pSrcBox->left : 0;
+    }
+    D3D11_BUFFER_DESC desc = {};
+    static_cast<ID3D11Buffer*>(pSrcResource)->GetDesc(&desc);
+    return desc.ByteWidth;
+  }
+
+  if (dimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
+    if (pSrcBox) {
+      return 4ull * (pSrcBox->right - pSrcBox->left) * (pSrcBox->bottom - pSrcBox->top);
+    }
+    D3D11_TEXTURE2D_DESC desc = {};
+    static_cast<ID3D11Texture2D*>(pSrcResource)->GetDesc(&desc);
+    return 4ull * desc.Width * desc.Height;
+  }
+
+  return 0;
+}
+
+unsigned long long
+IRenderBackend::computeInitialDataSize(const D3D11_TEXTURE2D_DESC* pDesc,
+                                       const D3D11_SUBRESOURCE_DATA* pInitialData) {
+  if (!pDesc || !pInitialData) {
+    return 0;
+  }
+
+  unsigned long long total = 0;
+  unsigned int mipLevels = pDesc->MipLevels ? pDesc->MipLevels : 1;
+  for (unsigned int slice = 0; slice < pDesc->ArraySize; ++slice) {
+    for (unsigned int mip = 0; mip < mipLevels; ++mip) {
+      unsigned int height = pDesc->Height >> mip;
+      const D3D11_SUBRESOURCE_DATA& data = pInitialData[slice * mipLevels + mip];
+      total += static_cast<unsigned long long>(data.SysMemPitch) * (height ? height : 1);
+    }
+  }
+  return total;
+}
+
+HRESULT
+IRenderBackend::createTexture2DConcurrent(const D3D11_TEXTURE2D_DESC* pDesc,
+                                          const D3D11_SUBRESOURCE_DATA* pInitialData,
+                                          ID3D11Texture2D** ppTexture2D) {
+  ID3D11Device* device = getNativeDevice();
+  if (!device) {
+    return E_POINTER;
+  }
+  HRESULT hr = device->CreateTexture2D(pDesc, pInitialData, ppTexture2D);
+  if (SUCCEEDED(hr)) {
+    m_concurrentResources.fetch_add(1, std::memory_order_relaxed);
+    m_concurrentBytes.fetch_add(computeInitialDataSize(pDesc, pInitialData),
+                                std::memory_order_relaxed);
+  }
+  return hr;
+}
+
+HRESULT
+IRenderBackend::createShaderResourceViewConcurrent(ID3D11Resource* pResource,
+                                                   const D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc,
+                                                   ID3D11ShaderResourceView** ppSRView) {
+  ID3D11Device* device = getNativeDevice();
+  if (!device) {
+    return E_POINTER;
+  }
+  HRESULT hr = device->CreateShaderResourceView(pResource, pDesc, ppSRView);
+  if (SUCCEEDED(hr)) {
+    m_concurrentResources.fetch_add(1, std::memory_order_relaxed);
+  }
+  return hr;
+}
+
+void
+IRenderBackend::collectConcurrentStats() {
+  m_stats.resourcesCreated += m_concurrentResources.exchange(0, std::memory_order_relaxed);
+  m_stats.bytesUploaded += m_concurrentBytes.exchange(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,846 @@
+#include "RHI/NullRenderBackend.h"
+#include "Device.h"
+#include "DeviceContext.h"
+
+namespace {
+  // Evita inundar el log cuando un error se repite en cada frame.
+  const unsigned long long kMaxLoggedValidationErrors = 16;
+
+  // Bytes por texel, o por bloque de 4x4 en los formatos BCn (4 si no se conoce)
+  unsigned int
+  bytesPerElement(DXGI_FORMAT format, bool& blockCompressed) {
+    blockCompressed = false;
+    switch (format) {
+    case DXGI_FORMAT_BC1_TYPELESS:
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC4_TYPELESS:
+    case DXGI_FORMAT_BC4_UNORM:
+    case DXGI_FORMAT_BC4_SNORM:
+      blockCompressed = true;
+      return 8;
+    case DXGI_FORMAT_BC2_TYPELESS:
+    case DXGI_FORMAT_BC2_UNORM:
+    case DXGI_FORMAT_BC2_UNORM_SRGB:
+    case DXGI_FORMAT_BC3_TYPELESS:
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+    case DXGI_FORMAT_BC5_TYPELESS:
+    case DXGI_FORMAT_BC5_UNORM:
+    case DXGI_FORMAT_BC5_SNORM:
+    case DXGI_FORMAT_BC6H_TYPELESS:
+    case DXGI_FORMAT_BC6H_UF16:
+    case DXGI_FORMAT_BC6H_SF16:
+    case DXGI_FORMAT_BC7_TYPELESS:
+    case DXGI_FORMAT_BC7_UNORM:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:
+      blockCompressed = true;
+      return 16;
+    case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+    case DXGI_FORMAT_R32G32B32A32_UINT:
+      return 16;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R16G16B16A16_UNORM:
+    case DXGI_FORMAT_R32G32_FLOAT:
+    case DXGI_FORMAT_R32G32_UINT:
+      return 8;
+    case DXGI_FORMAT_R16_FLOAT:
+    case DXGI_FORMAT_R16_UNORM:
+    case DXGI_FORMAT_R8G8_UNORM:
+      return 2;
+    case DXGI_FORMAT_R8_UNORM:
+      return 1;
+    default:
+      return 4;
+    }
+  }
+
+  // Pitch que devolvera el driver al mapear un subrecurso
+  bool
+  computeMapPitch(ID3D11Resource* pResource,
+                  D3D11_RESOURCE_DIMENSION dimension,
+                  unsigned int Subresource,
+                  unsigned int& rowPitch,
+                  unsigned int& depthPitch) {
+    if (dimension == D3D11_RESOURCE_DIMENSION_BUFFER) {
+      D3D11_BUFFER_DESC desc = {};
+      static_cast<ID3D11Buffer*>(pResource)->GetDesc(&desc);
+      rowPitch = desc.ByteWidth;
+      depthPitch = desc.ByteWidth;
+      return true;
+    }
+    if (dimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
+      return false;
+    }
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    static_cast<ID3D11Texture2D*>(pResource)->GetDesc(&desc);
+    unsigned int mip = desc.MipLevels ? Subresource % desc.MipLevels : 0;
+    unsigned int width = desc.Width >> mip;
+    unsigned int height = desc.Height >> mip;
+    width = width ? width : 1;
+    height = height ? height : 1;
+
+    bool blockCompressed = false;
+    unsigned int elementBytes = bytesPerElement(desc.Format, blockCompressed);
+    unsigned int rows = height;
+    if (blockCompressed) {
+      // Una fila de bloques cubre 4 filas de texels
+      width = (width + 3) / 4;
+      rows = (height + 3) / 4;
+    }
+    rowPitch = width * elementBytes;
+    depthPitch = rowPitch * rows;
+    return true;
+  }
+}
+
+HRESULT
+NullRenderBackend::init(Device& device, DeviceContext& deviceContext) {
+  if (device.m_device || deviceContext.m_deviceContext) {
+    ERROR("NullRenderBackend", "init", "Device already initialized");
+    return E_FAIL;
+  }
+
+  D3D_DRIVER_TYPE driverTypes[] = {
+      D3D_DRIVER_TYPE_NULL,
+      D3D_DRIVER_TYPE_WARP,
+  };
+  D3D_FEATURE_LEVEL featureLevels[] = {
+      D3D_FEATURE_LEVEL_11_0,
+      D3D_FEATURE_LEVEL_10_1,
+      D3D_FEATURE_LEVEL_10_0,
+  };
+
+  HRESULT hr = E_FAIL;
+  for (unsigned int i = 0; i < ARRAYSIZE(driverTypes); ++i) {
+    D3D_FEATURE_LEVEL featureLevel;
+    hr = D3D11CreateDevice(nullptr,
+                           driverTypes[i],
+                           nullptr,
+                           0,
+                           featureLevels,
+                           ARRAYSIZE(featureLevels),
+                           D3D11_SDK_VERSION,
+                           &device.m_device,
+                           &featureLevel,
+                           &deviceContext.m_deviceContext);
+    if (SUCCEEDED(hr)) {
+      m_driverType = driverTypes[i];
+      break;
+    }
+  }
+
+  if (FAILED(hr)) {
+    ERROR("NullRenderBackend", "init",
+      ("Failed to create headless device. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
+  }
+
+  hr = D3D11RenderBackend::init(device, deviceContext);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  m_pipeline = PipelineMirror();
+  m_commands.clear();
+  MESSAGE("NullRenderBackend", "init",
+    (m_driverType == D3D_DRIVER_TYPE_NULL ? "Headless device created (NULL driver)."
+                                          : "Headless device created (WARP fallback)."));
+  return S_OK;
+}
+
+void
+NullRenderBackend::destroy() {
+  m_commands.clear();
+  m_commands.shrink_to_fit();
+  m_mapShadow.clear();
+  m_pipeline = PipelineMirror();
+  D3D11RenderBackend::destroy();
+}
+
+void
+NullRenderBackend::beginFrame() {
+  m_commands.clear();
+}
+
+// -----------------------------------------------------------------------------
+// Contextos diferidos
+// -----------------------------------------------------------------------------
+
+HRESULT
+NullRenderBackend::createDeferredContext(DeviceContext& deferredContext,
+                                         std::unique_ptr<IRenderBackend>& deferredBackend) {
+  if (!m_device) {
+    ERROR("NullRenderBackend", "createDeferredContext", "Device is nullptr");
+    return E_POINTER;
+  }
+  if (m_deferred) {
+    ERROR("NullRenderBackend", "createDeferredContext", "Deferred contexts must be created from the immediate backend");
+    return E_FAIL;
+  }
+
+  // Sin contexto nativo: los comandos nunca llegan al dispositivo, slo se graban
+  auto backend = std::make_unique<NullRenderBackend>();
+  backend->m_device = m_device;
+  backend->m_driverType = m_driverType;
+  backend->m_emulateConstantBufferOffsets = m_emulateConstantBufferOffsets;
+  backend->m_recording = m_recording;
+  backend->m_deferred = true;
+  deferredContext.setBackend(backend.get());
+  deferredBackend = std::move(backend);
+  return S_OK;
+}
+
+HRESULT
+NullRenderBackend::finishCommandList(std::unique_ptr<IRenderCommandList>& commandList) {
+  if (!m_deferred) {
+    reportValidationError("finishCommandList", "FinishCommandList called on the immediate context");
+    return E_FAIL;
+  }
+  auto list = std::make_unique<NullCommandList>();
+  list->commands.swap(m_commands);
+  m_pipeline = PipelineMirror();
+  commandList = std::move(list);
+  return S_OK;
+}
+
+void
+NullRenderBackend::executeCommandList(IRenderCommandList& commandList) {
+  NullCommandList* list = dynamic_cast<NullCommandList*>(&commandList);
+  if (!list) {
+    reportValidationError("executeCommandList", "Command list was not recorded by a null backend");
+    return;
+  }
+  if (m_deferred) {
+    reportValidationError("executeCommandList", "Nested command lists are not emulated");
+    return;
+  }
+  record(RecordedCommandType::ExecuteCommandList, list, static_cast<unsigned int>(list->commands.size()));
+  if (m_recording) {
+    m_commands.insert(m_commands.end(), list->commands.begin(), list->commands.end());
+  }
+  // Igual que ExecuteCommandList(list, FALSE): el estado del inmediato queda limpio
+  m_pipeline = PipelineMirror();
+}
+
+void
+NullRenderBackend::record(RecordedCommandType type,
+                          const void* object,
+                          unsigned int arg0,
+                          unsigned int arg1) {
+  if (m_recording) {
+    m_commands.push_back({ type, object, arg0, arg1 });
+  }
+}
+
+void
+NullRenderBackend::reportValidationError(const char* method, const char* reason) {
+  ++m_stats.validationErrors;
+  if (m_stats.validationErrors <= kMaxLoggedValidationErrors) {
+    ERROR("NullRenderBackend", method, reason);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Comandos de contexto
+// -----------------------------------------------------------------------------
+
+void
+NullRenderBackend::RSSetViewports(unsigned int NumViewports,
+                                  const D3D11_VIEWPORT* pViewports) {
+  ++m_stats.stateChanges;
+  if (NumViewports == 0 || pViewports[0].Width <= 0.0f || pViewports[0].Height <= 0.0f) {
+    reportValidationError("RSSetViewports", "Viewport has no area");
+  }
+  m_pipeline.viewportSet = NumViewports > 0;
+  record(RecordedCommandType::SetViewports, pViewports, NumViewports);
+}
+
+void
+NullRenderBackend::RSSetState(ID3D11RasterizerState* pRasterizerState) {
+  ++m_stats.stateChanges;
+  countRedundant(m_pipeline.rasterizerState == pRasterizerState);
+  m_pipeline.rasterizerState = pRasterizerState;
+  record(RecordedCommandType::SetRasterizerState, pRasterizerState);
+}
+
+void
+NullRenderBackend::IASetInputLayout(ID3D11InputLayout* pInputLayout) {
+  ++m_stats.stateChanges;
+  countRedundant(m_pipeline.inputLayout == pInputLayout);
+  m_pipeline.inputLayout = pInputLayout;
+  record(RecordedCommandType::SetInputLayout, pInputLayout);
+}
+
+void
+NullRenderBackend::IASetVertexBuffers(unsigned int StartSlot,
+                                      unsigned int NumBuffers,
+                                      ID3D11Buffer* const* ppVertexBuffers,
+                                      const unsigned int* pStrides,
+                                      const unsigned int* pOffsets) {
+  ++m_stats.stateChanges;
+  if (StartSlot == 0 && NumBuffers > 0) {
+    m_pipeline.vertexBuffer = ppVertexBuffers[0];
+  }
+  // Slot 1: datos por instancia
+  if (StartSlot <= 1 && StartSlot + NumBuffers > 1) {
+    unsigned int slot = 1 - StartSlot;
+    m_pipeline.instanceBuffer = ppVertexBuffers[slot];
+    m_pipeline.instanceCapacity = 0;
+    if (ppVertexBuffers[slot] && pStrides[slot] > 0) {
+      D3D11_BUFFER_DESC desc = {};
+      ppVertexBuffers[slot]->GetDesc(&desc);
+      unsigned int offset = pOffsets ? pOffsets[slot] : 0;
+      m_pipeline.instanceCapacity = offset < desc.ByteWidth ? (desc.ByteWidth - offset) / pStrides[slot] : 0;
+    }
+  }
+  for (unsigned int i = 0; i < NumBuffers; ++i) {
+    if (ppVertexBuffers[i] && pStrides[i] == 0) {
+      reportValidationError("IASetVertexBuffers", "Vertex buffer bound with zero stride");
+    }
+  }
+  record(RecordedCommandType::SetVertexBuffers, NumBuffers ? ppVertexBuffers[0] : nullptr,
+         StartSlot, NumBuffers);
+}
+
+void
+NullRenderBackend::IASetIndexBuffer(ID3D11Buffer* pIndexBuffer,
+                                    DXGI_FORMAT Format,
+                                    unsigned int Offset) {
+  ++m_stats.stateChanges;
+  countRedundant(m_pipeline.indexBuffer == pIndexBuffer &&
+                 m_pipeline.indexFormat == Format &&
+                 m_pipeline.indexOffset == Offset);
+  m_pipeline.indexBuffer = pIndexBuffer;
+  m_pipeline.indexFormat = Format;
+  m_pipeline.indexOffset = Offset;
+  m_pipeline.indexCapacity = 0;
+
+  unsigned int indexSize = 0;
+  if (Format == DXGI_FORMAT_R32_UINT) {
+    indexSize = 4;
+  }
+  else if (Format == DXGI_FORMAT_R16_UINT) {
+    indexSize = 2;
+  }
+  else {
+    reportValidationError("IASetIndexBuffer", "Index format must be R16_UINT or R32_UINT");
+  }
+
+  if (pIndexBuffer && indexSize) {
+    D3D11_BUFFER_DESC desc = {};
+    pIndexBuffer->GetDesc(&desc);
+    if (Offset >= desc.ByteWidth) {
+      reportValidationError("IASetIndexBuffer", "Offset is past the end of the index buffer");
+    }
+    else {
+      m_pipeline.indexCapacity = (desc.ByteWidth - Offset) / indexSize;
+    }
+  }
+  record(RecordedCommandType::SetIndexBuffer, pIndexBuffer, Format, Offset);
+}
+
+void
+NullRenderBackend::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) {
+  ++m_stats.stateChanges;
+  countRedundant(m_pipeline.topology == Topology);
+  m_pipeline.topology = Topology;
+  record(RecordedCommandType::SetPrimitiveTopology, nullptr, Topology);
+}
+
+void
+NullRenderBackend::VSSetShader(ID3D11VertexShader* pVertexShader,
+                               ID3D11ClassInstance* const* ppClassInstances,
+                               unsigned int NumClassInstances) {
+  ++m_stats.stateChanges;
+  countRedundant(m_pipeline.vertexShader == pVertexShader);
+  m_pipeline.vertexShader = pVertexShader;
+  record(RecordedCommandType::SetVertexShader, pVertexShader, NumClassInstances);
+}
+
+void
+NullRenderBackend::PSSetShader(ID3D11PixelShader* pPixelShader,
+                               ID3D11ClassInstance* const* ppClassInstances,
+                               unsigned int NumClassInstances) {
+  ++m_stats.stateChanges;
+  countRedundant(m_pipeline.pixelShader == pPixelShader);
+  m_pipeline.pixelShader = pPixelShader;
+  record(RecordedCommandType::SetPixelShader, pPixelShader, NumClassInstances);
+}
+
+void
+NullRenderBackend::VSSetConstantBuffers(unsigned int StartSlot,
+                                        unsigned int NumBuffers,
+                                        ID3D11Buffer* const* ppConstantBuffers) {
+  ++m_stats.stateChanges;
+  if (StartSlot + NumBuffers > D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT) {
+    reportValidationError("VSSetConstantBuffers", "Constant buffer slot out of range");
+  }
+  countRedundant(bindConstantBuffers(m_pipeline.vsConstantBuffers, StartSlot, NumBuffers,
+                                     ppConstantBuffers, nullptr, nullptr));
+  record(RecordedCommandType::SetVSConstantBuffers, NumBuffers ? ppConstantBuffers[0] : nullptr,
+         StartSlot, NumBuffers);
+}
+
+void
+NullRenderBackend::PSSetConstantBuffers(unsigned int StartSlot,
+                                        unsigned int NumBuffers,
+                                        ID3D11Buffer* const* ppConstantBuffers) {
+  ++m_stats.stateChanges;
+  if (StartSlot + NumBuffers > D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT) {
+    reportValidationError("PSSetConstantBuffers", "Constant buffer slot out of range");
+  }
+  countRedundant(bindConstantBuffers(m_pipeline.psConstantBuffers, StartSlot, NumBuffers,
+                                     ppConstantBuffers, nullptr, nullptr));
+  record(RecordedCommandType::SetPSConstantBuffers, NumBuffers ? ppConstantBuffers[0] : nullptr,
+         StartSlot, NumBuffers);
+}
+
+bool
+NullRenderBackend::bindConstantBuffers(ConstantBufferSlot* slots,
+                                       unsigned int StartSlot,
+                                       unsigned int NumBuffers,
+                                       ID3D11Buffer* const* ppConstantBuffers,
+                                       const unsigned int* pFirstConstant,
+                                       const unsigned int* pNumConstants) {
+  bool redundant = NumBuffers > 0;
+  for (unsigned int i = 0; i < NumBuffers; ++i) {
+    unsigned int slot = StartSlot + i;
+    if (slot >= D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT) {
+      return false;
+    }
+    // Sin rango explcito el slot ve el buffer completo (0 constantes = todo)
+    ConstantBufferSlot binding;
+    binding.buffer = ppConstantBuffers ? ppConstantBuffers[i] : nullptr;
+    binding.firstConstant = pFirstConstant ? pFirstConstant[i] : 0;
+    binding.numConstants = pNumConstants ? pNumConstants[i] : 0;
+    if (slots[slot].buffer != binding.buffer ||
+        slots[slot].firstConstant != binding.firstConstant ||
+        slots[slot].numConstants != binding.numConstants) {
+      redundant = false;
+    }
+    slots[slot] = binding;
+  }
+  return redundant;
+}
+
+void
+NullRenderBackend::validateConstantBufferRanges(const char* method,
+                                                unsigned int NumBuffers,
+                                                ID3D11Buffer* const* ppConstantBuffers,
+                                                const unsigned int* pFirstConstant,
+                                                const unsigned int* pNumConstants) {
+  if (!m_emulateConstantBufferOffsets) {
+    reportValidationError(method, "Constant buffer offsets require D3D11.1");
+  }
+  if (!pFirstConstant || !pNumConstants) {
+    reportValidationError(method, "Missing first/num constant arrays");
+    return;
+  }
+  for (unsigned int i = 0; i < NumBuffers; ++i) {
+    // Rangos en mltiplos de 16 constantes (256 bytes), mximo 4096 constantes
+    if (pFirstConstant[i] % 16 != 0 || pNumConstants[i] % 16 != 0 ||
+        pNumConstants[i] == 0 || pNumConstants[i] > 4096) {
+      reportValidationError(method, "Constant range must be a non-empty multiple of 16 constants (max 4096)");
+    }
+    if (ppConstantBuffers[i]) {
+      D3D11_BUFFER_DESC desc = {};
+      ppConstantBuffers[i]->GetDesc(&desc);
+      if ((static_cast<unsigned long long>(pFirstConstant[i]) + pNumConstants[i]) * 16 > desc.ByteWidth) {
+        reportValidationError(method, "Constant range exceeds the buffer");
+      }
+    }
+  }
+}
+
+void
+NullRenderBackend::VSSetConstantBuffers1(unsigned int StartSlot,
+                                         unsigned int NumBuffers,
+                                         ID3D11Buffer* const* ppConstantBuffers,
+                                         const unsigned int* pFirstConstant,
+                                         const unsigned int* pNumConstants) {
+  ++m_stats.stateChanges;
+  validateConstantBufferRanges("VSSetConstantBuffers1", NumBuffers, ppConstantBuffers,
+                               pFirstConstant, pNumConstants);
+  countRedundant(bindConstantBuffers(m_pipeline.vsConstantBuffers, StartSlot, NumBuffers,
+                                     ppConstantBuffers, pFirstConstant, pNumConstants));
+  record(RecordedCommandType::SetVSConstantBuffers1, NumBuffers ? ppConstantBuffers[0] : nullptr,
+         StartSlot, pFirstConstant ? pFirstConstant[0] : 0);
+}
+
+void
+NullRenderBackend::PSSetConstantBuffers1(unsigned int StartSlot,
+                                         unsigned int NumBuffers,
+                                         ID3D11Buffer* const* ppConstantBuffers,
+                                         const unsigned int* pFirstConstant,
+                                         const unsigned int* pNumConstants) {
+  ++m_stats.stateChanges;
+  validateConstantBufferRanges("PSSetConstantBuffers1", NumBuffers, ppConstantBuffers,
+                               pFirstConstant, pNumConstants);
+  countRedundant(bindConstantBuffers(m_pipeline.psConstantBuffers, StartSlot, NumBuffers,
+                                     ppConstantBuffers, pFirstConstant, pNumConstants));
+  record(RecordedCommandType::SetPSConstantBuffers1, NumBuffers ? ppConstantBuffers[0] : nullptr,
+         StartSlot, pFirstConstant ? pFirstConstant[0] : 0);
+}
+
+void
+NullRenderBackend::PSSetShaderResources(unsigned int StartSlot,
+                                        unsigned int NumViews,
+                                        ID3D11ShaderResourceView* const* ppShaderResourceViews) {
+  ++m_stats.stateChanges;
+  if (StartSlot + NumViews > D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT) {
+    reportValidationError("PSSetShaderResources", "Shader resource slot out of range");
+  }
+  record(RecordedCommandType::SetPSShaderResources,
+         NumViews ? ppShaderResourceViews[0] : nullptr, StartSlot, NumViews);
+}
+
+void
+NullRenderBackend::PSSetSamplers(unsigned int StartSlot,
+                                 unsigned int NumSamplers,
+                                 ID3D11SamplerState* const* ppSamplers) {
+  ++m_stats.stateChanges;
+  if (StartSlot + NumSamplers > D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT) {
+    reportValidationError("PSSetSamplers", "Sampler slot out of range");
+  }
+  record(RecordedCommandType::SetPSSamplers, NumSamplers ? ppSamplers[0] : nullptr,
+         StartSlot, NumSamplers);
+}
+
+void
+NullRenderBackend::OMSetBlendState(ID3D11BlendState* pBlendState,
+                                   const float BlendFactor[4],
+                                   unsigned int SampleMask) {
+  ++m_stats.stateChanges;
+  // Sin factor explcito D3D usa {1, 1, 1, 1}
+  float blendFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+  if (BlendFactor) {
+    for (int i = 0; i < 4; ++i) {
+      blendFactor[i] = BlendFactor[i];
+    }
+  }
+  bool sameFactor = true;
+  for (int i = 0; i < 4; ++i) {
+    sameFactor = sameFactor && m_pipeline.blendFactor[i] == blendFactor[i];
+    m_pipeline.blendFactor[i] = blendFactor[i];
+  }
+  countRedundant(m_pipeline.blendState == pBlendState && sameFactor &&
+                 m_pipeline.sampleMask == SampleMask);
+  m_pipeline.blendState = pBlendState;
+  m_pipeline.sampleMask = SampleMask;
+  record(RecordedCommandType::SetBlendState, pBlendState, SampleMask);
+}
+
+void
+NullRenderBackend::OMSetDepthStencilState(ID3D11DepthStencilState* pDepthStencilState,
+                                          unsigned int StencilRef) {
+  ++m_stats.stateChanges;
+  countRedundant(m_pipeline.depthStencilState == pDepthStencilState);
+  m_pipeline.depthStencilState = pDepthStencilState;
+  record(RecordedCommandType::SetDepthStencilState, pDepthStencilState, StencilRef);
+}
+
+void
+NullRenderBackend::OMSetRenderTargets(unsigned int NumViews,
+                                      ID3D11RenderTargetView* const* ppRenderTargetViews,
+                                      ID3D11DepthStencilView* pDepthStencilView) {
+  ++m_stats.stateChanges;
+  if (NumViews > D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT) {
+    reportValidationError("OMSetRenderTargets", "Too many simultaneous render targets");
+  }
+  m_pipeline.renderTarget = (NumViews > 0 && ppRenderTargetViews) ? ppRenderTargetViews[0] : nullptr;
+  m_pipeline.depthStencil = pDepthStencilView;
+  record(RecordedCommandType::SetRenderTargets, m_pipeline.renderTarget, NumViews);
+}
+
+void
+NullRenderBackend::ClearRenderTargetView(ID3D11RenderTargetView* pRenderTargetView,
+                                         const float ColorRGBA[4]) {
+  ++m_stats.clears;
+  record(RecordedCommandType::ClearRenderTarget, pRenderTargetView);
+}
+
+void
+NullRenderBackend::ClearDepthStencilView(ID3D11DepthStencilView* pDepthStencilView,
+                                         unsigned int ClearFlags,
+                                         float Depth,
+                                         UINT8 Stencil) {
+  ++m_stats.clears;
+  if (Depth < 0.0f || Depth > 1.0f) {
+    reportValidationError("ClearDepthStencilView", "Depth clear value outside [0, 1]");
+  }
+  record(RecordedCommandType::ClearDepthStencil, pDepthStencilView, ClearFlags, Stencil);
+}
+
+void
+NullRenderBackend::UpdateSubresource(ID3D11Resource* pDstResource,
+                                     unsigned int DstSubresource,
+                                     const D3D11_BOX* pDstBox,
+                                     const void* pSrcData,
+                                     unsigned int SrcRowPitch,
+                                     unsigned int SrcDepthPitch) {
+  unsigned long long bytes = computeUploadSize(pDstResource,
+                                               DstSubresource,
+                                               pDstBox,
+                                               SrcRowPitch,
+                                               SrcDepthPitch);
+  m_stats.bytesUploaded += bytes;
+  record(RecordedCommandType::UpdateSubresource, pDstResource,
+         DstSubresource, static_cast<unsigned int>(bytes));
+}
+
+void
+NullRenderBackend::CopySubresourceRegion(ID3D11Resource* pDstResource,
+                                         unsigned int DstSubresource,
+                                         unsigned int DstX,
+                                         unsigned int DstY,
+                                         unsigned int DstZ,
+                                         ID3D11Resource* pSrcResource,
+                                         unsigned int SrcSubresource,
+                                         const D3D11_BOX* pSrcBox) {
+  if (!pDstResource || !pSrcResource) {
+    reportValidationError("CopySubresourceRegion", "Copy without source or destination resource");
+    return;
+  }
+  unsigned long long bytes = computeCopySize(pSrcResource, pSrcBox);
+
+  // Para buffers se comprueban los lmites y el solape (D3D11 no define el resultado)
+  D3D11_RESOURCE_DIMENSION srcDimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+  D3D11_RESOURCE_DIMENSION dstDimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+  pSrcResource->GetType(&srcDimension);
+  pDstResource->GetType(&dstDimension);
+  if (srcDimension == D3D11_RESOURCE_DIMENSION_BUFFER &&
+      dstDimension == D3D11_RESOURCE_DIMENSION_BUFFER) {
+    D3D11_BUFFER_DESC srcDesc = {};
+    D3D11_BUFFER_DESC dstDesc = {};
+    static_cast<ID3D11Buffer*>(pSrcResource)->GetDesc(&srcDesc);
+    static_cast<ID3D11Buffer*>(pDstResource)->GetDesc(&dstDesc);
+    unsigned int srcBegin = pSrcBox ? pSrcBox->left : 0;
+    if (pSrcBox && (pSrcBox->left > pSrcBox->right || pSrcBox->right > srcDesc.ByteWidth)) {
+      reportValidationError("CopySubresourceRegion", "Source box exceeds the source buffer");
+    }
+    if (DstX + bytes > dstDesc.ByteWidth) {
+      reportValidationError("CopySubresourceRegion", "Copy exceeds the destination buffer");
+    }
+    if (pSrcResource == pDstResource &&
+        DstX < srcBegin + bytes && srcBegin < DstX + bytes) {
+      reportValidationError("CopySubresourceRegion", "Source and destination regions overlap");
+    }
+  }
+
+  m_stats.bytesCopied += bytes;
+  record(RecordedCommandType::CopySubresourceRegion, pDstResource,
+         DstX, static_cast<unsigned int>(bytes));
+}
+
+void
+NullRenderBackend::GenerateMips(ID3D11ShaderResourceView* pShaderResourceView) {
+  record(RecordedCommandType::GenerateMips, pShaderResourceView);
+}
+
+void
+NullRenderBackend::ResolveSubresource(ID3D11Resource* pDstResource,
+                                      unsigned int DstSubresource,
+                                      ID3D11Resource* pSrcResource,
+                                      unsigned int SrcSubresource,
+                                      DXGI_FORMAT Format) {
+  if (!pDstResource || !pSrcResource) {
+    reportValidationError("ResolveSubresource", "Resolve without source or destination resource");
+    return;
+  }
+  // Origen multisample, destino de una muestra y mismas dimensiones
+  D3D11_RESOURCE_DIMENSION srcDimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+  D3D11_RESOURCE_DIMENSION dstDimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+  pSrcResource->GetType(&srcDimension);
+  pDstResource->GetType(&dstDimension);
+  if (srcDimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D || dstDimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
+    reportValidationError("ResolveSubresource", "Resolve requires 2D textures");
+    return;
+  }
+  D3D11_TEXTURE2D_DESC srcDesc = {};
+  D3D11_TEXTURE2D_DESC dstDesc = {};
+  static_cast<ID3D11Texture2D*>(pSrcResource)->GetDesc(&srcDesc);
+  static_cast<ID3D11Texture2D*>(pDstResource)->GetDesc(&dstDesc);
+  if (srcDesc.SampleDesc.Count <= 1 || dstDesc.SampleDesc.Count != 1) {
+    reportValidationError("ResolveSubresource", "Source must be multisampled and destination single-sampled");
+  }
+  if (srcDesc.Width != dstDesc.Width || srcDesc.Height != dstDesc.Height) {
+    reportValidationError("ResolveSubresource", "Source and destination sizes differ");
+  }
+  record(RecordedCommandType::ResolveSubresource, pDstResource, DstSubresource, SrcSubresource);
+}
+
+void
+NullRenderBackend::validateDraw(const char* method,
+                                unsigned int IndexCount,
+                                unsigned int StartIndexLocation) {
+  if (!m_pipeline.vertexShader || !m_pipeline.pixelShader) {
+    reportValidationError(method, "Draw issued without vertex or pixel shader");
+  }
+  if (!m_pipeline.inputLayout) {
+    reportValidationError(method, "Draw issued without input layout");
+  }
+  if (!m_pipeline.vertexBuffer || !m_pipeline.indexBuffer) {
+    reportValidationError(method, "Draw issued without vertex or index buffer");
+  }
+  else if (StartIndexLocation + IndexCount > m_pipeline.indexCapacity) {
+    reportValidationError(method, "Index range exceeds the bound index buffer");
+  }
+  if (m_pipeline.topology == D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED) {
+    reportValidationError(method, "Draw issued without primitive topology");
+  }
+  if (!m_pipeline.renderTarget && !m_pipeline.depthStencil) {
+    reportValidationError(method, "Draw issued without render target or depth stencil");
+  }
+  if (!m_pipeline.viewportSet) {
+    reportValidationError(method, "Draw issued without viewport");
+  }
+}
+
+void
+NullRenderBackend::DrawIndexed(unsigned int IndexCount,
+                               unsigned int StartIndexLocation,
+                               int BaseVertexLocation) {
+  validateDraw("DrawIndexed", IndexCount, StartIndexLocation);
+
+  ++m_stats.drawCalls;
+  m_stats.indicesSubmitted += IndexCount;
+  record(RecordedCommandType::DrawIndexed, nullptr, IndexCount, StartIndexLocation);
+}
+
+void
+NullRenderBackend::DrawIndexedInstanced(unsigned int IndexCountPerInstance,
+                                        unsigned int InstanceCount,
+                                        unsigned int StartIndexLocation,
+                                        int BaseVertexLocation,
+                                        unsigned int StartInstanceLocation) {
+  validateDraw("DrawIndexedInstanced", IndexCountPerInstance, StartIndexLocation);
+  if (!m_pipeline.instanceBuffer) {
+    reportValidationError("DrawIndexedInstanced", "Draw issued without instance buffer in slot 1");
+  }
+  else if (StartInstanceLocation + InstanceCount > m_pipeline.instanceCapacity) {
+    reportValidationError("DrawIndexedInstanced", "Instance range exceeds the bound instance buffer");
+  }
+
+  ++m_stats.drawCalls;
+  ++m_stats.instancedDrawCalls;
+  m_stats.instancesSubmitted += InstanceCount;
+  m_stats.indicesSubmitted += static_cast<unsigned long long>(IndexCountPerInstance) * InstanceCount;
+  record(RecordedCommandType::DrawIndexedInstanced, nullptr, IndexCountPerInstance, InstanceCount);
+}
+
+HRESULT
+NullRenderBackend::Map(ID3D11Resource* pResource,
+                       unsigned int Subresource,
+                       D3D11_MAP MapType,
+                       unsigned int MapFlags,
+                       D3D11_MAPPED_SUBRESOURCE* pMappedResource) {
+  if (!pResource || !pMappedResource) {
+    reportValidationError("Map", "Resource or mapped subresource is null");
+    return E_INVALIDARG;
+  }
+
+  if (m_deferred && MapType != D3D11_MAP_WRITE_DISCARD && MapType != D3D11_MAP_WRITE_NO_OVERWRITE) {
+    reportValidationError("Map", "Deferred contexts only support WRITE_DISCARD and WRITE_NO_OVERWRITE");
+    return E_INVALIDARG;
+  }
+
+  D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+  pResource->GetType(&dimension);
+  if (MapType == D3D11_MAP_WRITE_NO_OVERWRITE && dimension == D3D11_RESOURCE_DIMENSION_BUFFER) {
+    D3D11_BUFFER_DESC desc = {};
+    static_cast<ID3D11Buffer*>(pResource)->GetDesc(&desc);
+    if ((desc.BindFlags & D3D11_BIND_CONSTANT_BUFFER) && !m_emulateConstantBufferOffsets) {
+      reportValidationError("Map", "NO_OVERWRITE on a constant buffer requires D3D11.1");
+    }
+  }
+
+  unsigned int rowPitch = 0;
+  unsigned int depthPitch = 0;
+  if (!computeMapPitch(pResource, dimension, Subresource, rowPitch, depthPitch)) {
+    depthPitch = static_cast<unsigned int>(computeUploadSize(pResource, Subresource, nullptr, 0, 0));
+    rowPitch = depthPitch;
+  }
+  std::vector<unsigned char>& shadow = m_mapShadow[pResource];
+  if (shadow.size() < depthPitch) {
+    shadow.resize(depthPitch);
+  }
+  ++m_stats.maps;
+
+  pMappedResource->pData = shadow.data();
+  pMappedResource->RowPitch = rowPitch;
+  pMappedResource->DepthPitch = depthPitch;
+  record(RecordedCommandType::Map, pResource, Subresource, MapType);
+  return S_OK;
+}
+
+void
+NullRenderBackend::Unmap(ID3D11Resource* pResource, unsigned int Subresource) {
+  record(RecordedCommandType::Unmap, pResource, Subresource);
+}
+
+void
+NullRenderBackend::Begin(ID3D11Asynchronous* pAsync) {
+  if (!pAsync) {
+    reportValidationError("Begin", "Query is null");
+    return;
+  }
+  // Los timestamps slo admiten End
+  D3D11_QUERY_DESC desc = {};
+  static_cast<ID3D11Query*>(pAsync)->GetDesc(&desc);
+  if (desc.Query == D3D11_QUERY_TIMESTAMP) {
+    reportValidationError("Begin", "Timestamp queries only support End");
+    return;
+  }
+  record(RecordedCommandType::BeginQuery, pAsync, desc.Query);
+}
+
+void
+NullRenderBackend::End(ID3D11Asynchronous* pAsync) {
+  if (!pAsync) {
+    reportValidationError("End", "Query is null");
+    return;
+  }
+  D3D11_QUERY_DESC desc = {};
+  static_cast<ID3D11Query*>(pAsync)->GetDesc(&desc);
+  record(RecordedCommandType::EndQuery, pAsync, desc.Query);
+}
+
+HRESULT
+NullRenderBackend::GetData(ID3D11Asynchronous* pAsync,
+                           void* pData,
+                           unsigned int DataSize,
+                           unsigned int GetDataFlags) {
+  if (!pAsync) {
+    reportValidationError("GetData", "Query is null");
+    return E_INVALIDARG;
+  }
+  if (m_deferred) {
+    reportValidationError("GetData", "Deferred contexts cannot read queries");
+    return E_FAIL;
+  }
+  if (!pData) {
+    return S_OK;
+  }
+  if (DataSize != pAsync->GetDataSize()) {
+    reportValidationError("GetData", "Data size does not match the query");
+    return E_INVALIDARG;
+  }
+  memset(pData, 0, DataSize);
+  D3D11_QUERY_DESC desc = {};
+  static_cast<ID3D11Query*>(pAsync)->GetDesc(&desc);
+  if (desc.Query == D3D11_QUERY_TIMESTAMP_DISJOINT) {
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT* disjoint = static_cast<D3D11_QUERY_DATA_TIMESTAMP_DISJOINT*>(pData);
+    disjoint->Frequency = 1;
+    disjoint->Disjoint = TRUE;
+  }
+  return S_OK;
+}
+
+void
+NullRenderBackend::ClearState() {
+  m_pipeline = PipelineMirror();
+  record(RecordedCommandType::ClearState, nullptr);
+}
@@ -26,7 +26,7 @@ RenderTargetView::init(Device& device, Texture& backBuffer, DXGI_FORMAT Format)
 	desc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DMS;
 
 	// Create the render target view
-	HRESULT hr = device.m_device->CreateRenderTargetView(backBuffer.m_texture,
+	HRESULT hr = device.CreateRenderTargetView(backBuffer.m_texture,
 		&desc,
 		&m_renderTargetView);
 	if (FAILED(hr)) {
@@ -63,7 +63,7 @@ RenderTargetView::init(Device& device,
 	desc.ViewDimension = ViewDimension;
 
 	// Create the render target view
-	HRESULT hr = device.m_device->CreateRenderTargetView(inTex.m_texture,
+	HRESULT hr = device.CreateRenderTargetView(inTex.m_texture,
 		&desc,
 		&m_renderTargetView);
 
@@ -91,10 +91,10 @@ RenderTargetView::render(DeviceContext& deviceContext,
 	}
 
 	// Clear the render target view
-	deviceContext.m_deviceContext->ClearRenderTargetView(m_renderTargetView, ClearColor);
+	deviceContext.ClearRenderTargetView(m_renderTargetView, ClearColor);
 
 	// Config render target view and depth stencil view
-	deviceContext.m_deviceContext->OMSetRenderTargets(numViews,
+	deviceContext.OMSetRenderTargets(numViews,
 		&m_renderTargetView,
 		depthStencilView.m_depthStencilView);
 }
@@ -110,7 +110,7 @@ RenderTargetView::render(DeviceContext& deviceContext, unsigned int numViews) {
 		return;
 	}
 	// Config render target view
-	deviceContext.m_deviceContext->OMSetRenderTargets(numViews,
+	deviceContext.OMSetRenderTargets(numViews,
 		&m_renderTargetView,
 		nullptr);
 }
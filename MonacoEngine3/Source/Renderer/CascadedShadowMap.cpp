@@ -0,0 +1,455 @@
+#include "Renderer/CascadedShadowMap.h"
+#include "Renderer/StaticBatcher.h"
+#include "Renderer/PipelineStateCache.h"
+#include "EngineUtilities/Utilities/Camera.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include "ECS/Actor.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <cmath>
+
+namespace {
+  // Margen de la caja sobre la esfera del tramo: cuanto mayor, ms frames sin recolocarla
+  const float kGuardBand = 0.15f;
+
+  // Bias de comparacin en profundidad normalizada (el grueso lo pone el rasterizador)
+  const float kCompareBias = 0.0015f;
+
+  float
+  snap(float value, float step) {
+    return floorf(value / step) * step;
+  }
+}
+
+HRESULT
+CascadedShadowMap::init(Device& device,
+                        ShaderCache& cache,
+                        const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout,
+                        const std::vector<D3D11_INPUT_ELEMENT_DESC>& instancedLayout,
+                        unsigned int cascadeCount,
+                        unsigned int resolution) {
+  destroy();
+  if (cascadeCount == 0 || cascadeCount > kMaxCascades || resolution == 0) {
+    ERROR("CascadedShadowMap", "init", "Cascade count must be 1..4 and resolution non-zero.");
+    return E_INVALIDARG;
+  }
+  m_cascadeCount = cascadeCount;
+  m_resolution = resolution;
+  setLightDirection(m_lightDirection);
+
+  HRESULT hr = createDepthArray(device, &m_shadowMap, m_depthStencilViews, &m_shaderResourceView);
+  if (SUCCEEDED(hr)) {
+    hr = createDepthArray(device, &m_staticMap, m_staticDepthStencilViews, nullptr);
+  }
+  if (FAILED(hr)) {
+    destroy();
+    return hr;
+  }
+
+  m_shader.setShaderCache(&cache);
+  hr = m_shader.init(device, "MonacoEngine3_Shadow.fx", layout);
+  if (SUCCEEDED(hr)) {
+    m_shaderInstanced.setShaderCache(&cache);
+    hr = m_shaderInstanced.init(device, "MonacoEngine3_Shadow_Instanced.fx", instancedLayout);
+  }
+  if (FAILED(hr)) {
+    ERROR("CascadedShadowMap", "init", ("Failed to initialize shadow shaders. HRESULT: " + std::to_string(hr)).c_str());
+    destroy();
+    return hr;
+  }
+
+  // Sin recorte en profundidad: lo que queda entre la luz y la caja se aplasta al plano cercano
+  PipelineStateCache& states = PipelineStateCache::getInstance();
+  D3D11_RASTERIZER_DESC rasterizerDesc = {};
+  rasterizerDesc.FillMode = D3D11_FILL_SOLID;
+  rasterizerDesc.CullMode = D3D11_CULL_NONE;
+  rasterizerDesc.DepthBias = 64;
+  rasterizerDesc.SlopeScaledDepthBias = 2.0f;
+  rasterizerDesc.DepthClipEnable = FALSE;
+  PipelineStateDesc casterStates;
+  casterStates.rasterizerState = states.getRasterizerState(device, rasterizerDesc);
+
+  D3D11_SAMPLER_DESC samplerDesc = {};
+  samplerDesc.Filter = D3D11_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
+  samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_BORDER;
+  samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_BORDER;
+  samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_BORDER;
+  samplerDesc.ComparisonFunc = D3D11_COMPARISON_LESS_EQUAL;
+  samplerDesc.BorderColor[0] = 1.0f;
+  samplerDesc.BorderColor[1] = 1.0f;
+  samplerDesc.BorderColor[2] = 1.0f;
+  samplerDesc.BorderColor[3] = 1.0f;
+  samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+  m_comparisonSampler = states.getSamplerState(device, samplerDesc);
+  if (!casterStates.rasterizerState || !m_comparisonSampler) {
+    ERROR("CascadedShadowMap", "init", "Failed to create shadow states.");
+    destroy();
+    return E_FAIL;
+  }
+
+  hr = m_queue.init(device);
+  if (FAILED(hr)) {
+    destroy();
+    return hr;
+  }
+  m_queue.setDefaultShader(m_shader, casterStates);
+  m_queue.setInstancedShader(m_shaderInstanced, casterStates);
+
+  for (unsigned int i = 0; i < m_cascadeCount && SUCCEEDED(hr); ++i) {
+    hr = m_cascadeBuffers[i].init(device, sizeof(XMMATRIX));
+  }
+  if (SUCCEEDED(hr)) {
+    hr = m_receiverBuffer.init(device, sizeof(CBShadowCascades));
+  }
+  if (FAILED(hr)) {
+    ERROR("CascadedShadowMap", "init", ("Failed to create shadow constant buffers. HRESULT: " + std::to_string(hr)).c_str());
+    destroy();
+    return hr;
+  }
+
+  MESSAGE("CascadedShadowMap", "init",
+    (std::to_string(m_cascadeCount) + " cascades of " + std::to_string(m_resolution) + "x" +
+     std::to_string(m_resolution)).c_str());
+  return S_OK;
+}
+
+HRESULT
+CascadedShadowMap::createDepthArray(Device& device,
+                                    ID3D11Texture2D** texture,
+                                    ID3D11DepthStencilView** depthStencilViews,
+                                    ID3D11ShaderResourceView** shaderResourceView) {
+  D3D11_TEXTURE2D_DESC textureDesc = {};
+  textureDesc.Width = m_resolution;
+  textureDesc.Height = m_resolution;
+  textureDesc.MipLevels = 1;
+  textureDesc.ArraySize = m_cascadeCount;
+  textureDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+  textureDesc.SampleDesc.Count = 1;
+  textureDesc.Usage = D3D11_USAGE_DEFAULT;
+  textureDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+  if (shaderResourceView) {
+    textureDesc.BindFlags |= D3D11_BIND_SHADER_RESOURCE;
+  }
+  HRESULT hr = device.CreateTexture2D(&textureDesc, nullptr, texture);
+  if (FAILED(hr)) {
+    ERROR("CascadedShadowMap", "createDepthArray", ("Failed to create shadow map. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
+  }
+
+  for (unsigned int slice = 0; slice < m_cascadeCount; ++slice) {
+    D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+    dsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
+    dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DARRAY;
+    dsvDesc.Texture2DArray.FirstArraySlice = slice;
+    dsvDesc.Texture2DArray.ArraySize = 1;
+    hr = device.CreateDepthStencilView(*texture, &dsvDesc, &depthStencilViews[slice]);
+    if (FAILED(hr)) {
+      ERROR("CascadedShadowMap", "createDepthArray", "Failed to create cascade depth stencil view.");
+      return hr;
+    }
+  }
+
+  if (shaderResourceView) {
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+    srvDesc.Texture2DArray.MipLevels = 1;
+    srvDesc.Texture2DArray.ArraySize = m_cascadeCount;
+    hr = device.CreateShaderResourceView(*texture, &srvDesc, shaderResourceView);
+    if (FAILED(hr)) {
+      ERROR("CascadedShadowMap", "createDepthArray", "Failed to create shadow map shader resource view.");
+      return hr;
+    }
+  }
+  return S_OK;
+}
+
+void
+CascadedShadowMap::destroy() {
+  for (unsigned int i = 0; i < kMaxCascades; ++i) {
+    SAFE_RELEASE(m_depthStencilViews[i]);
+    SAFE_RELEASE(m_staticDepthStencilViews[i]);
+    m_cascadeBuffers[i].destroy();
+    m_cascades[i] = ShadowCascade();
+  }
+  SAFE_RELEASE(m_shaderResourceView);
+  SAFE_RELEASE(m_shadowMap);
+  SAFE_RELEASE(m_staticMap);
+  // El sampler y el estado de raster son de la PipelineStateCache
+  m_comparisonSampler = nullptr;
+  m_receiverBuffer.destroy();
+  m_queue.destroy();
+  m_shader.destroy();
+  m_shaderInstanced.destroy();
+  m_cascadeCount = 0;
+  m_stats = ShadowStats();
+}
+
+void
+CascadedShadowMap::setLightDirection(const XMFLOAT3& direction) {
+  XMVECTOR forward = XMVector3Normalize(XMLoadFloat3(&direction));
+  // Con la luz casi vertical el "arriba" de la vista no puede ser Y
+  XMVECTOR up = fabsf(XMVectorGetY(forward)) > 0.99f ? XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f)
+                                                     : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+  XMStoreFloat3(&m_lightDirection, forward);
+  XMStoreFloat4x4(&m_lightRotation, XMMatrixLookToLH(XMVectorZero(), forward, up));
+  for (ShadowCascade& cascade : m_cascades) {
+    cascade.fitted = false;
+    cascade.staticValid = false;
+  }
+}
+
+void
+CascadedShadowMap::setSplitParams(float shadowDistance, float lambda) {
+  m_shadowDistance = shadowDistance;
+  m_splitLambda = lambda;
+}
+
+void
+CascadedShadowMap::invalidateStaticCasters() {
+  for (ShadowCascade& cascade : m_cascades) {
+    cascade.staticValid = false;
+  }
+}
+
+void
+CascadedShadowMap::update(const Camera& camera) {
+  PROFILE_SCOPE("CascadedShadowMap::update");
+  if (m_cascadeCount == 0) {
+    return;
+  }
+  float splits[kMaxCascades + 1];
+  camera.computeCascadeSplits(m_cascadeCount, m_shadowDistance, m_splitLambda, splits);
+  const XMMATRIX lightRotation = XMLoadFloat4x4(&m_lightRotation);
+
+  for (unsigned int i = 0; i < m_cascadeCount; ++i) {
+    ShadowCascade& cascade = m_cascades[i];
+    cascade.splitNear = splits[i];
+    cascade.splitFar = splits[i + 1];
+
+    // Esfera del tramo: el radio slo depende de distancias y FOV, no de la orientacin
+    XMFLOAT3 corners[8];
+    camera.getFrustumCorners(cascade.splitNear, cascade.splitFar, corners);
+    XMVECTOR center = XMVectorZero();
+    for (const XMFLOAT3& corner : corners) {
+      center = XMVectorAdd(center, XMLoadFloat3(&corner));
+    }
+    center = XMVectorScale(center, 1.0f / 8.0f);
+    float radius = 0.0f;
+    for (const XMFLOAT3& corner : corners) {
+      float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&corner), center)));
+      radius = distance > radius ? distance : radius;
+    }
+    // Redondeado para que el ruido de coma flotante no cambie el tamao del texel
+    radius = ceilf(radius * 16.0f) / 16.0f;
+    const float extent = radius * (1.0f + kGuardBand);
+    const float texel = 2.0f * extent / static_cast<float>(m_resolution);
+
+    XMFLOAT3 lightCenter;
+    XMStoreFloat3(&lightCenter, XMVector3TransformCoord(center, lightRotation));
+    const bool inside = cascade.fitted && cascade.extent == extent &&
+                        fabsf(lightCenter.x - cascade.lightCenter.x) + radius <= extent &&
+                        fabsf(lightCenter.y - cascade.lightCenter.y) + radius <= extent &&
+                        fabsf(lightCenter.z - cascade.lightCenter.z) + radius <= extent;
+    if (inside) {
+      // La caja anterior an cubre el tramo: misma matriz, la cach esttica sigue valiendo
+      continue;
+    }
+
+    cascade.lightCenter = XMFLOAT3(snap(lightCenter.x, texel), snap(lightCenter.y, texel), snap(lightCenter.z, texel));
+    cascade.extent = extent;
+    cascade.fitted = true;
+    cascade.staticValid = false;
+
+    const XMFLOAT3& c = cascade.lightCenter;
+    XMMATRIX projection = XMMatrixOrthographicOffCenterLH(c.x - extent, c.x + extent,
+                                                          c.y - extent, c.y + extent,
+                                                          c.z - extent, c.z + extent);
+    XMStoreFloat4x4(&cascade.viewProj, lightRotation * projection);
+  }
+
+  for (unsigned int i = 0; i < kMaxCascades; ++i) {
+    const unsigned int source = i < m_cascadeCount ? i : m_cascadeCount - 1;
+    m_receiverConstants.mCascadeViewProj[i] = XMMatrixTranspose(XMLoadFloat4x4(&m_cascades[source].viewProj));
+  }
+  const unsigned int last = m_cascadeCount - 1;
+  m_receiverConstants.vCascadeSplits = XMFLOAT4(m_cascades[0].splitFar,
+                                                m_cascades[last < 1 ? last : 1].splitFar,
+                                                m_cascades[last < 2 ? last : 2].splitFar,
+                                                m_cascades[last].splitFar);
+  m_receiverConstants.vShadowParams = XMFLOAT4(1.0f / static_cast<float>(m_resolution),
+                                               static_cast<float>(m_cascadeCount),
+                                               kCompareBias,
+                                               0.0f);
+}
+
+bool
+CascadedShadowMap::intersects(unsigned int index, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax) const {
+  const ShadowCascade& cascade = m_cascades[index];
+  const XMMATRIX lightRotation = XMLoadFloat4x4(&m_lightRotation);
+
+  // AABB de mundo -> AABB en espacio de luz (centro rotado, semiejes por |R|)
+  XMVECTOR worldMin = XMLoadFloat3(&boundsMin);
+  XMVECTOR worldMax = XMLoadFloat3(&boundsMax);
+  XMVECTOR center = XMVector3TransformCoord(XMVectorScale(XMVectorAdd(worldMin, worldMax), 0.5f), lightRotation);
+  XMVECTOR extents = XMVectorScale(XMVectorSubtract(worldMax, worldMin), 0.5f);
+  extents = XMVectorAdd(XMVectorAdd(
+    XMVectorMultiply(XMVectorSplatX(extents), XMVectorAbs(lightRotation.r[0])),
+    XMVectorMultiply(XMVectorSplatY(extents), XMVectorAbs(lightRotation.r[1]))),
+    XMVectorMultiply(XMVectorSplatZ(extents), XMVectorAbs(lightRotation.r[2])));
+
+  // X/Y contra la caja; en Z slo cuenta el lado lejano (lo cercano se aplasta)
+  XMVECTOR distance = XMVectorAbs(XMVectorSubtract(center, XMLoadFloat3(&cascade.lightCenter)));
+  XMVECTOR limit = XMVectorAdd(XMVectorReplicate(cascade.extent), extents);
+  if (!XMVector2LessOrEqual(distance, limit)) {
+    return false;
+  }
+  return XMVectorGetZ(center) - XMVectorGetZ(extents) <= cascade.lightCenter.z + cascade.extent;
+}
+
+void
+CascadedShadowMap::drawLayer(DeviceContext& deviceContext,
+                             ID3D11DepthStencilView* depthStencilView,
+                             unsigned int cascade) {
+  m_queue.sort();
+  deviceContext.OMSetRenderTargets(0, nullptr, depthStencilView);
+  m_cascadeBuffers[cascade].render(deviceContext, 0, 1);
+  m_queue.execute(deviceContext);
+  m_stats.drawCalls += m_queue.getStats().drawCalls;
+}
+
+void
+CascadedShadowMap::render(DeviceContext& deviceContext,
+                          const std::vector<EU::TSharedPointer<Actor>>& actors,
+                          StaticBatcher& staticBatcher) {
+  PROFILE_SCOPE("CascadedShadowMap::render");
+  m_stats = ShadowStats();
+  if (m_cascadeCount == 0) {
+    return;
+  }
+  m_stats.cascades = m_cascadeCount;
+  m_receiverBuffer.update(deviceContext, nullptr, 0, nullptr, &m_receiverConstants, 0, 0);
+
+  // t1 puede seguir enlazado del frame anterior; D3D11 no deja leer y escribir a la vez
+  unbind(deviceContext);
+  D3D11_VIEWPORT viewport = {};
+  viewport.Width = static_cast<float>(m_resolution);
+  viewport.Height = static_cast<float>(m_resolution);
+  viewport.MaxDepth = 1.0f;
+  deviceContext.RSSetViewports(1, &viewport);
+
+  // Cajas de mundo de los actores que no vienen del batching (una vez para todas las cascadas)
+  struct Caster {
+    Actor* actor;
+    XMFLOAT3 boundsMin;
+    XMFLOAT3 boundsMax;
+  };
+  std::vector<Caster> staticCasters;
+  std::vector<Caster> dynamicCasters;
+  for (const auto& actor : actors) {
+    Caster caster = { actor.get(), XMFLOAT3(), XMFLOAT3() };
+    if (!caster.actor || !caster.actor->canCastShadow() || caster.actor->isStaticBatched() ||
+        !caster.actor->getWorldBounds(caster.boundsMin, caster.boundsMax)) {
+      continue;
+    }
+    (caster.actor->isStatic() ? staticCasters : dynamicCasters).push_back(caster);
+  }
+
+  for (unsigned int i = 0; i < m_cascadeCount; ++i) {
+    ShadowCascade& cascade = m_cascades[i];
+    const XMMATRIX viewProj = XMLoadFloat4x4(&cascade.viewProj);
+    const XMMATRIX lightRotation = XMLoadFloat4x4(&m_lightRotation);
+    const float nearZ = cascade.lightCenter.z - cascade.extent;
+    const float farZ = cascade.lightCenter.z + cascade.extent;
+    XMMATRIX cascadeConstants = XMMatrixTranspose(viewProj);
+    m_cascadeBuffers[i].update(deviceContext, nullptr, 0, nullptr, &cascadeConstants, 0, 0);
+
+    // 1) Capa esttica: slo si cambi la caja, la luz o los proyectores estticos
+    const bool staticDirty = !cascade.staticValid;
+    if (staticDirty) {
+      m_queue.begin(lightRotation, nearZ, farZ);
+      staticBatcher.submit(m_queue, [&](const StaticSubmesh& submesh) {
+        ++m_stats.castersTested;
+        bool visible = submesh.owner && submesh.owner->canCastShadow() &&
+                       intersects(i, submesh.boundsMin, submesh.boundsMax);
+        if (!visible) {
+          ++m_stats.castersCulled;
+        }
+        return visible;
+      });
+      for (const Caster& caster : staticCasters) {
+        ++m_stats.castersTested;
+        if (!intersects(i, caster.boundsMin, caster.boundsMax)) {
+          ++m_stats.castersCulled;
+          continue;
+        }
+        caster.actor->submit(m_queue);
+      }
+      m_stats.staticPackets += static_cast<unsigned int>(m_queue.size());
+      deviceContext.ClearDepthStencilView(m_staticDepthStencilViews[i], D3D11_CLEAR_DEPTH, 1.0f, 0);
+      drawLayer(deviceContext, m_staticDepthStencilViews[i], i);
+      cascade.staticValid = true;
+      ++m_stats.staticCascadesRendered;
+    }
+    else {
+      ++m_stats.staticCascadesReused;
+    }
+
+    // 2) Proyectores dinmicos de esta cascada
+    m_queue.begin(lightRotation, nearZ, farZ);
+    for (const Caster& caster : dynamicCasters) {
+      ++m_stats.castersTested;
+      if (!intersects(i, caster.boundsMin, caster.boundsMax)) {
+        ++m_stats.castersCulled;
+        continue;
+      }
+      caster.actor->submit(m_queue);
+    }
+    const unsigned int dynamicPackets = static_cast<unsigned int>(m_queue.size());
+    m_stats.dynamicPackets += dynamicPackets;
+    cascade.dynamicCasters = dynamicPackets;
+
+    if (!staticDirty && dynamicPackets == 0 && cascade.liveIsStatic) {
+      // El mapa vivo ya es exactamente la capa esttica
+      ++m_stats.cascadesSkipped;
+      continue;
+    }
+
+    // 3) Mapa vivo = copia de la capa esttica + dinmicos encima
+    deviceContext.CopySubresourceRegion(m_shadowMap, i, 0, 0, 0, m_staticMap, i, nullptr);
+    if (dynamicPackets > 0) {
+      drawLayer(deviceContext, m_depthStencilViews[i], i);
+    }
+    cascade.liveIsStatic = dynamicPackets == 0;
+  }
+}
+
+void
+CascadedShadowMap::bind(DeviceContext& deviceContext) const {
+  if (!m_shaderResourceView) {
+    return;
+  }
+  ID3D11ShaderResourceView* shadowMap = m_shaderResourceView;
+  ID3D11SamplerState* sampler = m_comparisonSampler;
+  ID3D11Buffer* constants = m_receiverBuffer.getBuffer();
+  deviceContext.PSSetShaderResources(1, 1, &shadowMap);
+  deviceContext.PSSetSamplers(1, 1, &sampler);
+  deviceContext.PSSetConstantBuffers(3, 1, &constants);
+}
+
+void
+CascadedShadowMap::unbind(DeviceContext& deviceContext) const {
+  ID3D11ShaderResourceView* nullView = nullptr;
+  deviceContext.PSSetShaderResources(1, 1, &nullView);
+}
+
+RGTextureDesc
+CascadedShadowMap::getDesc() const {
+  RGTextureDesc desc;
+  desc.width = m_resolution;
+  desc.height = m_resolution;
+  desc.format = DXGI_FORMAT_D32_FLOAT;
+  desc.bindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
+  desc.arraySize = m_cascadeCount;
+  return desc;
+}
@@ -0,0 +1,478 @@
+#include "Renderer/ClusteredLighting.h"
+#include "EngineUtilities/Utilities/Camera.h"
+#include "EngineUtilities/Utilities/ThreadPool.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+  /** @brief Caja de vista repetida en los cuatro carriles, para probar cuatro esferas a la vez. */
+  struct BoxSplat {
+    XMVECTOR minX, minY, minZ;
+    XMVECTOR maxX, maxY, maxZ;
+  };
+
+  BoxSplat
+  splatBox(const XMFLOAT3& boxMin, const XMFLOAT3& boxMax) {
+    BoxSplat box;
+    box.minX = XMVectorReplicate(boxMin.x);
+    box.minY = XMVectorReplicate(boxMin.y);
+    box.minZ = XMVectorReplicate(boxMin.z);
+    box.maxX = XMVectorReplicate(boxMax.x);
+    box.maxY = XMVectorReplicate(boxMax.y);
+    box.maxZ = XMVectorReplicate(boxMax.z);
+    return box;
+  }
+
+  // Un bit por esfera del bloque que toca la caja: distancia al punto ms cercano <= radio
+  unsigned int
+  overlapMask(const XMFLOAT4A& x, const XMFLOAT4A& y, const XMFLOAT4A& z,
+              const XMFLOAT4A& radiusSq, const BoxSplat& box) {
+    const XMVECTOR zero = XMVectorZero();
+    XMVECTOR cx = XMLoadFloat4A(&x);
+    XMVECTOR cy = XMLoadFloat4A(&y);
+    XMVECTOR cz = XMLoadFloat4A(&z);
+    XMVECTOR dx = XMVectorAdd(XMVectorMax(XMVectorSubtract(box.minX, cx), zero),
+                              XMVectorMax(XMVectorSubtract(cx, box.maxX), zero));
+    XMVECTOR dy = XMVectorAdd(XMVectorMax(XMVectorSubtract(box.minY, cy), zero),
+                              XMVectorMax(XMVectorSubtract(cy, box.maxY), zero));
+    XMVECTOR dz = XMVectorAdd(XMVectorMax(XMVectorSubtract(box.minZ, cz), zero),
+                              XMVectorMax(XMVectorSubtract(cz, box.maxZ), zero));
+    XMVECTOR distanceSq = XMVectorMultiplyAdd(dx, dx, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dz, dz)));
+    XMVECTORU32 inside;
+    inside.v = XMVectorLessOrEqual(distanceSq, XMLoadFloat4A(&radiusSq));
+    return (inside.u[0] & 1u) | (inside.u[1] & 2u) | (inside.u[2] & 4u) | (inside.u[3] & 8u);
+  }
+}
+
+HRESULT
+ClusteredLighting::init(Device& device,
+                        unsigned int width,
+                        unsigned int height,
+                        unsigned int tilesX,
+                        unsigned int tilesY,
+                        unsigned int slices,
+                        unsigned int maxLights) {
+  destroy();
+  if (tilesX == 0 || tilesY == 0 || slices == 0 || maxLights == 0 || maxLights > kMaxVisibleLights) {
+    ERROR("ClusteredLighting", "init", "Grid dimensions must be non-zero and maxLights at most 65535.");
+    return E_INVALIDARG;
+  }
+  m_tilesX = tilesX;
+  m_tilesY = tilesY;
+  m_slices = slices;
+  m_maxLights = maxLights;
+  setViewportSize(width, height);
+  m_boundsDirty = true;
+  m_sliceWork.resize(slices);
+  m_grid.assign(2 * getClusterCount(), 0);
+
+  // La lista de ndices empieza con una media de 16 luces por cluster y crece en upload()
+  m_indexCapacity = 16 * getClusterCount();
+  HRESULT hr = createTypedBuffer(device, m_lightBuffer, &m_lightView, sizeof(XMFLOAT4),
+                                 3 * m_maxLights, DXGI_FORMAT_R32G32B32A32_FLOAT);
+  if (SUCCEEDED(hr)) {
+    hr = createTypedBuffer(device, m_gridBuffer, &m_gridView, 2 * sizeof(unsigned int),
+                           getClusterCount(), DXGI_FORMAT_R32G32_UINT);
+  }
+  if (SUCCEEDED(hr)) {
+    hr = createTypedBuffer(device, m_indexBuffer, &m_indexView, sizeof(unsigned short),
+                           m_indexCapacity, DXGI_FORMAT_R16_UINT);
+  }
+  if (SUCCEEDED(hr)) {
+    hr = m_constantBuffer.init(device, sizeof(CBClusters));
+  }
+  if (FAILED(hr)) {
+    ERROR("ClusteredLighting", "init", ("Failed to create cluster buffers. HRESULT: " + std::to_string(hr)).c_str());
+    destroy();
+    return hr;
+  }
+
+  MESSAGE("ClusteredLighting", "init",
+    (std::to_string(m_tilesX) + "x" + std::to_string(m_tilesY) + "x" + std::to_string(m_slices) +
+     " clusters, up to " + std::to_string(m_maxLights) + " visible lights").c_str());
+  return S_OK;
+}
+
+HRESULT
+ClusteredLighting::createTypedBuffer(Device& device,
+                                     Buffer& buffer,
+                                     ID3D11ShaderResourceView** shaderResourceView,
+                                     unsigned int stride,
+                                     unsigned int elementCount,
+                                     DXGI_FORMAT format) {
+  HRESULT hr = buffer.initDynamic(device, stride, elementCount, D3D11_BIND_SHADER_RESOURCE);
+  if (FAILED(hr)) {
+    return hr;
+  }
+  D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+  srvDesc.Format = format;
+  srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+  srvDesc.Buffer.FirstElement = 0;
+  srvDesc.Buffer.NumElements = elementCount;
+  hr = device.CreateShaderResourceView(buffer.getBuffer(), &srvDesc, shaderResourceView);
+  if (FAILED(hr)) {
+    ERROR("ClusteredLighting", "createTypedBuffer", "Failed to create buffer shader resource view.");
+  }
+  return hr;
+}
+
+void
+ClusteredLighting::destroy() {
+  SAFE_RELEASE(m_lightView);
+  SAFE_RELEASE(m_gridView);
+  SAFE_RELEASE(m_indexView);
+  m_lightBuffer.destroy();
+  m_gridBuffer.destroy();
+  m_indexBuffer.destroy();
+  m_constantBuffer.destroy();
+  m_indexCapacity = 0;
+  m_tilesX = 0;
+  m_tilesY = 0;
+  m_slices = 0;
+  m_lights.clear();
+  m_sliceWork.clear();
+  m_grid.clear();
+  m_indices.clear();
+  m_viewSpheres.clear();
+  m_gpuLights.clear();
+  m_stats = ClusterStats();
+}
+
+void
+ClusteredLighting::setDepthRange(float nearZ, float farZ) {
+  m_depthNear = nearZ;
+  m_depthFar = farZ;
+  m_boundsDirty = true;
+}
+
+void
+ClusteredLighting::setViewportSize(unsigned int width, unsigned int height) {
+  m_width = width > 0 ? width : 1;
+  m_height = height > 0 ? height : 1;
+}
+
+void
+ClusteredLighting::buildClusterBounds(const Camera& camera) {
+  m_boundsFovY = camera.getFovY();
+  m_boundsAspect = camera.getAspect();
+  m_boundsNear = camera.getNearZ();
+  m_boundsDirty = false;
+
+  // Cortes logartmicos entre m_depthNear y m_depthFar; el primero arranca en el plano cercano
+  m_sliceDepths.resize(m_slices + 1);
+  const float ratio = m_depthFar / m_depthNear;
+  for (unsigned int k = 0; k <= m_slices; ++k) {
+    m_sliceDepths[k] = m_depthNear * powf(ratio, static_cast<float>(k) / static_cast<float>(m_slices));
+  }
+  m_sliceDepths[0] = m_boundsNear < m_depthNear ? m_boundsNear : m_depthNear;
+
+  // En vista: x = ndcX * z / xScale, y = ndcY * z / yScale
+  const float yScale = 1.0f / tanf(0.5f * m_boundsFovY);
+  const float xScale = yScale / m_boundsAspect;
+  const unsigned int clusters = getClusterCount();
+  m_clusterMin.resize(clusters);
+  m_clusterMax.resize(clusters);
+  m_rowMin.resize(m_slices * m_tilesY);
+  m_rowMax.resize(m_slices * m_tilesY);
+
+  for (unsigned int slice = 0; slice < m_slices; ++slice) {
+    const float depths[2] = { m_sliceDepths[slice], m_sliceDepths[slice + 1] };
+    for (unsigned int y = 0; y < m_tilesY; ++y) {
+      // La fila 0 es la de arriba de la pantalla (NDC y = +1)
+      const float ndcY[2] = { 1.0f - 2.0f * y / m_tilesY, 1.0f - 2.0f * (y + 1) / m_tilesY };
+      XMFLOAT3& rowMin = m_rowMin[slice * m_tilesY + y];
+      XMFLOAT3& rowMax = m_rowMax[slice * m_tilesY + y];
+      rowMin = XMFLOAT3(FLT_MAX, FLT_MAX, depths[0]);
+      rowMax = XMFLOAT3(-FLT_MAX, -FLT_MAX, depths[1]);
+      for (unsigned int x = 0; x < m_tilesX; ++x) {
+        const float ndcX[2] = { -1.0f + 2.0f * x / m_tilesX, -1.0f + 2.0f * (x + 1) / m_tilesX };
+        XMFLOAT3 boxMin(FLT_MAX, FLT_MAX, depths[0]);
+        XMFLOAT3 boxMax(-FLT_MAX, -FLT_MAX, depths[1]);
+        for (float depth : depths) {
+          for (unsigned int i = 0; i < 2; ++i) {
+            float viewX = ndcX[i] * depth / xScale;
+            float viewY = ndcY[i] * depth / yScale;
+            boxMin.x = viewX < boxMin.x ? viewX : boxMin.x;
+            boxMax.x = viewX > boxMax.x ? viewX : boxMax.x;
+            boxMin.y = viewY < boxMin.y ? viewY : boxMin.y;
+            boxMax.y = viewY > boxMax.y ? viewY : boxMax.y;
+          }
+        }
+        const unsigned int cluster = (slice * m_tilesY + y) * m_tilesX + x;
+        m_clusterMin[cluster] = boxMin;
+        m_clusterMax[cluster] = boxMax;
+        rowMin.x = boxMin.x < rowMin.x ? boxMin.x : rowMin.x;
+        rowMin.y = boxMin.y < rowMin.y ? boxMin.y : rowMin.y;
+        rowMax.x = boxMax.x > rowMax.x ? boxMax.x : rowMax.x;
+        rowMax.y = boxMax.y > rowMax.y ? boxMax.y : rowMax.y;
+      }
+    }
+  }
+
+  const float depthScale = static_cast<float>(m_slices) / logf(ratio);
+  m_constants.vClusterDepth = XMFLOAT4(m_depthNear, m_depthFar, depthScale, 0.0f);
+}
+
+void
+ClusteredLighting::cullLights(const Camera& camera) {
+  const XMMATRIX view = camera.getView();
+  const float yScale = 1.0f / tanf(0.5f * m_boundsFovY);
+  const float xScale = yScale / m_boundsAspect;
+  // Normales de los planos laterales del frustum: |x| * xScale <= z, |y| * yScale <= z
+  const float xNorm = 1.0f / sqrtf(xScale * xScale + 1.0f);
+  const float yNorm = 1.0f / sqrtf(yScale * yScale + 1.0f);
+  const float nearZ = m_sliceDepths.front();
+  const float farZ = m_sliceDepths.back();
+
+  m_viewSpheres.clear();
+  m_gpuLights.clear();
+  for (const Light& light : m_lights) {
+    XMVECTOR center = XMLoadFloat3(&light.position);
+    XMVECTOR direction = XMVector3Normalize(XMLoadFloat3(&light.direction));
+    float radius = light.range;
+    float cosAngle = cosf(light.spotAngle);
+    if (light.type == LightType::Spot) {
+      // Esfera mnima del cono: con conos abiertos basta la de la base
+      float sinAngle = sinf(light.spotAngle);
+      if (light.spotAngle > XM_PIDIV4) {
+        center = XMVectorAdd(center, XMVectorScale(direction, light.range * cosAngle));
+        radius = light.range * sinAngle;
+      }
+      else {
+        radius = light.range / (2.0f * cosAngle);
+        center = XMVectorAdd(center, XMVectorScale(direction, radius));
+      }
+    }
+
+    XMFLOAT3 viewCenter;
+    XMStoreFloat3(&viewCenter, XMVector3TransformCoord(center, view));
+    if (viewCenter.z + radius < nearZ || viewCenter.z - radius > farZ ||
+        (fabsf(viewCenter.x) * xScale - viewCenter.z) * xNorm > radius ||
+        (fabsf(viewCenter.y) * yScale - viewCenter.z) * yNorm > radius) {
+      continue;
+    }
+    if (m_viewSpheres.size() >= m_maxLights) {
+      ++m_stats.droppedLights;
+      continue;
+    }
+
+    m_viewSpheres.push_back(XMFLOAT4(viewCenter.x, viewCenter.y, viewCenter.z, radius));
+    GPULight gpuLight;
+    gpuLight.positionRange = XMFLOAT4(light.position.x, light.position.y, light.position.z, light.range);
+    gpuLight.colorType = XMFLOAT4(light.color.x, light.color.y, light.color.z, static_cast<float>(light.type));
+    XMStoreFloat4(&gpuLight.directionCone, XMVectorSetW(direction, cosAngle));
+    m_gpuLights.push_back(gpuLight);
+  }
+}
+
+void
+ClusteredLighting::assign(const Camera& camera, ThreadPool& threadPool) {
+  PROFILE_SCOPE("ClusteredLighting::assign");
+  if (m_slices == 0) {
+    return;
+  }
+  auto begin = std::chrono::steady_clock::now();
+  m_stats = ClusterStats();
+  m_stats.lights = static_cast<unsigned int>(m_lights.size());
+  m_stats.clusters = getClusterCount();
+
+  if (m_boundsDirty || camera.getFovY() != m_boundsFovY || camera.getAspect() != m_boundsAspect ||
+      camera.getNearZ() != m_boundsNear) {
+    buildClusterBounds(camera);
+  }
+  cullLights(camera);
+  m_stats.visibleLights = static_cast<unsigned int>(m_viewSpheres.size());
+
+  // Cada corte escribe slo en su SliceWork: no hace falta sincronizar
+  if (!m_viewSpheres.empty()) {
+    threadPool.parallelFor(m_slices, [this](unsigned int slice) { assignSlice(slice); });
+  }
+
+  // Compactar: los cortes ya salen en el orden de la rejilla, basta concatenarlos
+  const unsigned int clustersPerSlice = m_tilesX * m_tilesY;
+  m_indices.clear();
+  for (unsigned int slice = 0; slice < m_slices; ++slice) {
+    SliceWork& work = m_sliceWork[slice];
+    const bool empty = m_viewSpheres.empty() || work.counts.size() != clustersPerSlice;
+    unsigned int offset = static_cast<unsigned int>(m_indices.size());
+    for (unsigned int local = 0; local < clustersPerSlice; ++local) {
+      const unsigned int count = empty ? 0 : work.counts[local];
+      const unsigned int cluster = slice * clustersPerSlice + local;
+      m_grid[2 * cluster] = offset;
+      m_grid[2 * cluster + 1] = count;
+      offset += count;
+      m_stats.activeClusters += count > 0 ? 1 : 0;
+      m_stats.maxLightsPerCluster = count > m_stats.maxLightsPerCluster ? count : m_stats.maxLightsPerCluster;
+    }
+    if (!empty) {
+      m_indices.insert(m_indices.end(), work.indices.begin(), work.indices.end());
+      m_stats.sphereTests += work.tests;
+    }
+  }
+  m_stats.lightIndices = static_cast<unsigned int>(m_indices.size());
+
+  m_constants.vClusterDims = XMFLOAT4(static_cast<float>(m_tilesX), static_cast<float>(m_tilesY),
+                                      static_cast<float>(m_slices), static_cast<float>(m_stats.visibleLights));
+  m_constants.vClusterScale = XMFLOAT4(static_cast<float>(m_tilesX) / m_width,
+                                       static_cast<float>(m_tilesY) / m_height, 0.0f, 0.0f);
+  m_stats.assignMs = std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - begin).count();
+}
+
+void
+ClusteredLighting::assignSlice(unsigned int slice) {
+  SliceWork& work = m_sliceWork[slice];
+  work.indices.clear();
+  work.counts.assign(m_tilesX * m_tilesY, 0);
+  work.tests = 0;
+
+  // Agrupa luces en bloques SoA de cuatro; los carriles sobrantes nunca pasan (radio^2 < 0)
+  auto buildBlocks = [this](const std::vector<unsigned short>& lights, std::vector<SphereBlock>& blocks) {
+    blocks.resize((lights.size() + 3) / 4);
+    for (size_t b = 0; b < blocks.size(); ++b) {
+      float lanes[4][4];
+      for (size_t lane = 0; lane < 4; ++lane) {
+        size_t i = 4 * b + lane;
+        if (i < lights.size()) {
+          const XMFLOAT4& sphere = m_viewSpheres[lights[i]];
+          lanes[0][lane] = sphere.x;
+          lanes[1][lane] = sphere.y;
+          lanes[2][lane] = sphere.z;
+          lanes[3][lane] = sphere.w * sphere.w;
+        }
+        else {
+          lanes[0][lane] = lanes[1][lane] = lanes[2][lane] = 0.0f;
+          lanes[3][lane] = -1.0f;
+        }
+      }
+      blocks[b].x = XMFLOAT4A(lanes[0][0], lanes[0][1], lanes[0][2], lanes[0][3]);
+      blocks[b].y = XMFLOAT4A(lanes[1][0], lanes[1][1], lanes[1][2], lanes[1][3]);
+      blocks[b].z = XMFLOAT4A(lanes[2][0], lanes[2][1], lanes[2][2], lanes[2][3]);
+      blocks[b].radiusSq = XMFLOAT4A(lanes[3][0], lanes[3][1], lanes[3][2], lanes[3][3]);
+    }
+  };
+  auto filter = [&work](const std::vector<SphereBlock>& blocks, const std::vector<unsigned short>& lights,
+                        const BoxSplat& box, std::vector<unsigned short>& out) {
+    for (size_t b = 0; b < blocks.size(); ++b) {
+      unsigned int mask = overlapMask(blocks[b].x, blocks[b].y, blocks[b].z, blocks[b].radiusSq, box);
+      for (unsigned int lane = 0; mask != 0; ++lane, mask >>= 1) {
+        if (mask & 1u) {
+          out.push_back(lights[4 * b + lane]);
+        }
+      }
+    }
+    work.tests += lights.size();
+  };
+
+  // 1) Profundidad: slo compara z, sin SIMD
+  const float sliceNear = m_sliceDepths[slice];
+  const float sliceFar = m_sliceDepths[slice + 1];
+  work.sliceLights.clear();
+  for (size_t i = 0; i < m_viewSpheres.size(); ++i) {
+    const XMFLOAT4& sphere = m_viewSpheres[i];
+    if (sphere.z + sphere.w >= sliceNear && sphere.z - sphere.w <= sliceFar) {
+      work.sliceLights.push_back(static_cast<unsigned short>(i));
+    }
+  }
+  if (work.sliceLights.empty()) {
+    return;
+  }
+  buildBlocks(work.sliceLights, work.sliceBlocks);
+
+  for (unsigned int y = 0; y < m_tilesY; ++y) {
+    // 2) Fila: la caja que une sus clusters descarta la mayora antes de ir tesela a tesela
+    const unsigned int row = slice * m_tilesY + y;
+    work.rowLights.clear();
+    filter(work.sliceBlocks, work.sliceLights, splatBox(m_rowMin[row], m_rowMax[row]), work.rowLights);
+    if (work.rowLights.empty()) {
+      continue;
+    }
+    buildBlocks(work.rowLights, work.rowBlocks);
+
+    // 3) Clusters de la fila; los ndices quedan en el orden de la rejilla
+    for (unsigned int x = 0; x < m_tilesX; ++x) {
+      const unsigned int cluster = row * m_tilesX + x;
+      const size_t before = work.indices.size();
+      filter(work.rowBlocks, work.rowLights, splatBox(m_clusterMin[cluster], m_clusterMax[cluster]), work.indices);
+      work.counts[y * m_tilesX + x] = static_cast<unsigned int>(work.indices.size() - before);
+    }
+  }
+}
+
+HRESULT
+ClusteredLighting::upload(Device& device, DeviceContext& deviceContext) {
+  if (!m_gridView) {
+    return E_FAIL;
+  }
+  HRESULT hr = S_OK;
+  if (m_indices.size() > m_indexCapacity) {
+    unsigned int capacity = m_indexCapacity;
+    while (capacity < m_indices.size()) {
+      capacity *= 2;
+    }
+    SAFE_RELEASE(m_indexView);
+    m_indexBuffer.destroy();
+    hr = createTypedBuffer(device, m_indexBuffer, &m_indexView, sizeof(unsigned short), capacity, DXGI_FORMAT_R16_UINT);
+    if (FAILED(hr)) {
+      ERROR("ClusteredLighting", "upload", ("Failed to grow light index buffer. HRESULT: " + std::to_string(hr)).c_str());
+      m_indexCapacity = 0;
+      return hr;
+    }
+    m_indexCapacity = capacity;
+  }
+
+  D3D11_MAPPED_SUBRESOURCE mapped = {};
+  if (!m_gpuLights.empty()) {
+    hr = deviceContext.Map(m_lightBuffer.getBuffer(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    if (FAILED(hr)) {
+      return hr;
+    }
+    memcpy(mapped.pData, m_gpuLights.data(), m_gpuLights.size() * sizeof(GPULight));
+    deviceContext.Unmap(m_lightBuffer.getBuffer(), 0);
+  }
+
+  hr = deviceContext.Map(m_gridBuffer.getBuffer(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+  if (FAILED(hr)) {
+    return hr;
+  }
+  memcpy(mapped.pData, m_grid.data(), m_grid.size() * sizeof(unsigned int));
+  deviceContext.Unmap(m_gridBuffer.getBuffer(), 0);
+
+  if (!m_indices.empty()) {
+    hr = deviceContext.Map(m_indexBuffer.getBuffer(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    if (FAILED(hr)) {
+      return hr;
+    }
+    memcpy(mapped.pData, m_indices.data(), m_indices.size() * sizeof(unsigned short));
+    deviceContext.Unmap(m_indexBuffer.getBuffer(), 0);
+  }
+
+  m_constantBuffer.update(deviceContext, nullptr, 0, nullptr, &m_constants, 0, 0);
+  return S_OK;
+}
+
+void
+ClusteredLighting::bind(DeviceContext& deviceContext) const {
+  if (!m_gridView) {
+    return;
+  }
+  ID3D11ShaderResourceView* views[] = { m_lightView, m_gridView, m_indexView };
+  ID3D11Buffer* constants = m_constantBuffer.getBuffer();
+  deviceContext.PSSetShaderResources(2, 3, views);
+  deviceContext.PSSetConstantBuffers(4, 1, &constants);
+}
+
+const unsigned short*
+ClusteredLighting::getClusterLights(unsigned int cluster, unsigned int& count) const {
+  if (2 * cluster + 1 >= m_grid.size()) {
+    count = 0;
+    return nullptr;
+  }
+  count = m_grid[2 * cluster + 1];
+  return count > 0 ? m_indices.data() + m_grid[2 * cluster] : nullptr;
+}
@@ -0,0 +1,184 @@
+#include "Renderer/ConstantBufferRing.h"
+#include "Device.h"
+#include "DeviceContext.h"
+
+namespace {
+  // Los rangos de *SSetConstantBuffers1 van en constantes de 16 bytes, mltiplos de 16
+  const unsigned int kConstantSize = 16;
+  const unsigned int kBlockAlignment = 256;
+}
+
+HRESULT
+ConstantBufferRing::init(Device& device,
+                         DeviceContext& deviceContext,
+                         unsigned int capacity,
+                         unsigned int framesInFlight) {
+  m_device = &device;
+  m_useOffsets = false;
+  m_needsDiscard = true;
+
+  if (!deviceContext.supportsConstantBufferOffsets()) {
+    MESSAGE("ConstantBufferRing", "init", "D3D11.1 constant buffer offsets unavailable, using per-draw buffers.");
+    return S_OK;
+  }
+
+  if (!m_allocator.init(capacity, kBlockAlignment, framesInFlight)) {
+    ERROR("ConstantBufferRing", "init", "Invalid ring capacity");
+    return E_INVALIDARG;
+  }
+  HRESULT hr = m_ring.initDynamic(device,
+                                  kBlockAlignment,
+                                  static_cast<unsigned int>(m_allocator.getCapacity() / kBlockAlignment),
+                                  D3D11_BIND_CONSTANT_BUFFER);
+  if (FAILED(hr)) {
+    // No es fatal: el pool de respaldo sigue funcionando
+    ERROR("ConstantBufferRing", "init",
+      ("Failed to create ring buffer, using per-draw buffers. HRESULT: " + std::to_string(hr)).c_str());
+    return S_OK;
+  }
+  m_useOffsets = true;
+  return S_OK;
+}
+
+void
+ConstantBufferRing::setFramesInFlight(unsigned int framesInFlight) {
+  if (!m_useOffsets) {
+    return;
+  }
+  if (!m_allocator.init(m_allocator.getCapacity(), kBlockAlignment, framesInFlight)) {
+    ERROR("ConstantBufferRing", "setFramesInFlight", "Invalid ring capacity");
+    m_useOffsets = false;
+    return;
+  }
+  m_needsDiscard = true;
+}
+
+void
+ConstantBufferRing::beginFrame() {
+  m_stats = ConstantBufferRingStats();
+  m_fallbackUsed = 0;
+  if (m_useOffsets) {
+    m_allocator.beginFrame();
+  }
+}
+
+ConstantBufferAllocation
+ConstantBufferRing::upload(DeviceContext& deviceContext, const void* data, unsigned int size) {
+  if (!data || size == 0) {
+    ERROR("ConstantBufferRing", "upload", "Empty upload");
+    return ConstantBufferAllocation();
+  }
+
+  if (m_useOffsets) {
+    unsigned long long offset = m_allocator.allocate(size);
+    if (offset != RingAllocator::kInvalidOffset) {
+      D3D11_MAP mapType = m_needsDiscard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+      D3D11_MAPPED_SUBRESOURCE mapped = {};
+      HRESULT hr = deviceContext.Map(m_ring.getBuffer(), 0, mapType, 0, &mapped);
+      if (SUCCEEDED(hr)) {
+        memcpy(static_cast<unsigned char*>(mapped.pData) + offset, data, size);
+        deviceContext.Unmap(m_ring.getBuffer(), 0);
+
+        m_needsDiscard = false;
+        ++m_stats.allocations;
+        m_stats.bytesWritten += size;
+        if (mapType == D3D11_MAP_WRITE_DISCARD) ++m_stats.discardMaps;
+        else ++m_stats.noOverwriteMaps;
+
+        ConstantBufferAllocation allocation;
+        allocation.buffer = m_ring.getBuffer();
+        allocation.firstConstant = static_cast<unsigned int>(offset / kConstantSize);
+        allocation.numConstants = static_cast<unsigned int>(m_allocator.alignUp(size) / kConstantSize);
+        return allocation;
+      }
+      ERROR("ConstantBufferRing", "upload", ("Failed to map ring. HRESULT: " + std::to_string(hr)).c_str());
+    }
+  }
+
+  // Sin D3D11.1 o con el anillo lleno
+  return uploadFallback(deviceContext, data, size);
+}
+
+ConstantBufferAllocation
+ConstantBufferRing::uploadFallback(DeviceContext& deviceContext, const void* data, unsigned int size) {
+  if (!m_device) {
+    ERROR("ConstantBufferRing", "uploadFallback", "Ring not initialized");
+    return ConstantBufferAllocation();
+  }
+
+  unsigned int aligned = (size + kConstantSize - 1) & ~(kConstantSize - 1);
+  if (m_fallbackUsed == m_fallback.size()) {
+    m_fallback.push_back(Buffer());
+    m_fallbackSizes.push_back(0);
+  }
+  Buffer& buffer = m_fallback[m_fallbackUsed];
+  if (m_fallbackSizes[m_fallbackUsed] < aligned) {
+    buffer.destroy();
+    HRESULT hr = buffer.initDynamic(*m_device, aligned, 1, D3D11_BIND_CONSTANT_BUFFER);
+    if (FAILED(hr)) {
+      ERROR("ConstantBufferRing", "uploadFallback",
+        ("Failed to create fallback buffer. HRESULT: " + std::to_string(hr)).c_str());
+      m_fallbackSizes[m_fallbackUsed] = 0;
+      return ConstantBufferAllocation();
+    }
+    m_fallbackSizes[m_fallbackUsed] = aligned;
+  }
+
+  D3D11_MAPPED_SUBRESOURCE mapped = {};
+  HRESULT hr = deviceContext.Map(buffer.getBuffer(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+  if (FAILED(hr)) {
+    ERROR("ConstantBufferRing", "uploadFallback", ("Failed to map buffer. HRESULT: " + std::to_string(hr)).c_str());
+    return ConstantBufferAllocation();
+  }
+  memcpy(mapped.pData, data, size);
+  deviceContext.Unmap(buffer.getBuffer(), 0);
+
+  ++m_fallbackUsed;
+  ++m_stats.allocations;
+  ++m_stats.fallbackAllocations;
+  ++m_stats.discardMaps;
+  m_stats.bytesWritten += size;
+
+  ConstantBufferAllocation allocation;
+  allocation.buffer = buffer.getBuffer();
+  return allocation;
+}
+
+void
+ConstantBufferRing::bind(DeviceContext& deviceContext,
+                         unsigned int slot,
+                         const ConstantBufferAllocation& allocation,
+                         bool pixelShader) {
+  if (!allocation.isValid()) {
+    return;
+  }
+  if (allocation.numConstants > 0) {
+    deviceContext.VSSetConstantBuffers1(slot, 1, &allocation.buffer,
+                                        &allocation.firstConstant, &allocation.numConstants);
+    if (pixelShader) {
+      deviceContext.PSSetConstantBuffers1(slot, 1, &allocation.buffer,
+                                          &allocation.firstConstant, &allocation.numConstants);
+    }
+  }
+  else {
+    deviceContext.VSSetConstantBuffers(slot, 1, &allocation.buffer);
+    if (pixelShader) {
+      deviceContext.PSSetConstantBuffers(slot, 1, &allocation.buffer);
+    }
+  }
+}
+
+void
+ConstantBufferRing::destroy() {
+  m_ring.destroy();
+  for (auto& buffer : m_fallback) {
+    buffer.destroy();
+  }
+  m_fallback.clear();
+  m_fallbackSizes.clear();
+  m_fallbackUsed = 0;
+  m_allocator.reset();
+  m_useOffsets = false;
+  m_needsDiscard = true;
+  m_device = nullptr;
+}
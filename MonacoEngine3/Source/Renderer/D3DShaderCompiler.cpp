@@ -0,0 +1,59 @@
+#include "Renderer/D3DShaderCompiler.h"
+
+bool
+D3DShaderCompiler::compile(const ShaderCompileRequest& request,
+                           std::vector<unsigned char>& bytecode,
+                           std::string& errors) {
+  // D3D espera las macros como pares de C-strings terminados en {nullptr, nullptr}
+  std::vector<D3D10_SHADER_MACRO> macros;
+  macros.reserve(request.defines.size() + 1);
+  for (const ShaderDefine& define : request.defines) {
+    D3D10_SHADER_MACRO macro = { define.name.c_str(), define.value.c_str() };
+    macros.push_back(macro);
+  }
+  D3D10_SHADER_MACRO terminator = { nullptr, nullptr };
+  macros.push_back(terminator);
+
+  ID3DBlob* shaderBlob = nullptr;
+  ID3DBlob* errorBlob = nullptr;
+  HRESULT hr = D3DX11CompileFromFile(request.fileName.c_str(),
+                                     macros.data(),
+                                     nullptr,
+                                     request.entryPoint.c_str(),
+                                     request.profile.c_str(),
+                                     request.flags,
+                                     0,
+                                     nullptr,
+                                     &shaderBlob,
+                                     &errorBlob,
+                                     nullptr);
+
+  if (errorBlob) {
+    errors.assign(static_cast<const char*>(errorBlob->GetBufferPointer()),
+                  errorBlob->GetBufferSize());
+  }
+  SAFE_RELEASE(errorBlob);
+
+  if (FAILED(hr) || !shaderBlob) {
+    if (errors.empty()) {
+      errors = "No error message available.";
+    }
+    SAFE_RELEASE(shaderBlob);
+    return false;
+  }
+
+  const unsigned char* data = static_cast<const unsigned char*>(shaderBlob->GetBufferPointer());
+  bytecode.assign(data, data + shaderBlob->GetBufferSize());
+  SAFE_RELEASE(shaderBlob);
+  return true;
+}
+
+unsigned int
+D3DShaderCompiler::getDefaultFlags() {
+  unsigned int flags = D3DCOMPILE_ENABLE_STRICTNESS;
+#if defined( DEBUG ) || defined( _DEBUG )
+  // Informacin de depuracin embebida, igual que la compilacin original
+  flags |= D3DCOMPILE_DEBUG;
+#endif
+  return flags;
+}
@@ -0,0 +1,236 @@
+#include "Renderer/DynamicResolution.h"
+#include "MeshComponent.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <cmath>
+
+// ---------------------------------------------------------------------------------
+// ResolutionController
+// ---------------------------------------------------------------------------------
+
+void
+ResolutionController::setSettings(const ResolutionControllerSettings& settings) {
+  m_settings = settings;
+  if (m_settings.minScale > m_settings.maxScale) {
+    m_settings.minScale = m_settings.maxScale;
+  }
+  float scale = m_stats.rawScale;
+  scale = scale < m_settings.minScale ? m_settings.minScale : scale;
+  scale = scale > m_settings.maxScale ? m_settings.maxScale : scale;
+  m_stats.rawScale = scale;
+  m_scale = scale;
+}
+
+void
+ResolutionController::reset() {
+  m_scale = m_settings.maxScale;
+  m_previousError = 0.0f;
+  m_previousError2 = 0.0f;
+  m_stats = ResolutionControllerStats();
+  m_stats.rawScale = m_scale;
+}
+
+float
+ResolutionController::update(float frameMs) {
+  if (frameMs <= 0.0f || m_settings.targetMs <= 0.0f) {
+    return m_scale;
+  }
+  ++m_stats.samples;
+  if (frameMs > m_settings.targetMs) {
+    ++m_stats.framesOverBudget;
+  }
+
+  // La primera muestra arranca la media; despus pesa @c smoothing
+  m_stats.filteredMs = m_stats.samples == 1
+    ? frameMs
+    : m_stats.filteredMs + m_settings.smoothing * (frameMs - m_stats.filteredMs);
+  float error = (m_settings.targetMs - m_stats.filteredMs) / m_settings.targetMs;
+  m_stats.error = error;
+  // La banda muerta se resta (no recorta) para que el error siga siendo continuo al salir de ella
+  if (fabsf(error) <= m_settings.deadband) {
+    error = 0.0f;
+  }
+  else {
+    error -= error > 0.0f ? m_settings.deadband : -m_settings.deadband;
+  }
+
+  // PID incremental: el trmino integral es la propia suma de incrementos sobre la escala
+  const float delta = m_settings.proportionalGain * (error - m_previousError) +
+                      m_settings.integralGain * error +
+                      m_settings.derivativeGain * (error - 2.0f * m_previousError + m_previousError2);
+  m_previousError2 = m_previousError;
+  m_previousError = error;
+
+  float raw = m_stats.rawScale + delta;
+  raw = raw < m_settings.minScale ? m_settings.minScale : raw;
+  raw = raw > m_settings.maxScale ? m_settings.maxScale : raw;
+  m_stats.rawScale = raw;
+
+  // Cuantizar: la escala aplicada slo se mueve cuando la continua se aleja un paso entero
+  float scale = m_scale;
+  if (m_settings.scaleStep > 0.0f) {
+    if (fabsf(raw - m_scale) >= m_settings.scaleStep || raw == m_settings.minScale || raw == m_settings.maxScale) {
+      scale = floorf(raw / m_settings.scaleStep + 0.5f) * m_settings.scaleStep;
+    }
+  }
+  else {
+    scale = raw;
+  }
+  scale = scale < m_settings.minScale ? m_settings.minScale : scale;
+  scale = scale > m_settings.maxScale ? m_settings.maxScale : scale;
+  if (scale != m_scale) {
+    ++m_stats.scaleChanges;
+    m_scale = scale;
+  }
+  return m_scale;
+}
+
+// ---------------------------------------------------------------------------------
+// DynamicResolution
+// ---------------------------------------------------------------------------------
+
+HRESULT
+DynamicResolution::init(Device& device,
+                        ShaderCache& cache,
+                        const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout,
+                        unsigned int width,
+                        unsigned int height) {
+  destroy();
+  m_width = width > 0 ? width : 1;
+  m_height = height > 0 ? height : 1;
+  m_controller.reset();
+
+  m_shader.setShaderCache(&cache);
+  HRESULT hr = m_shader.init(device, "MonacoEngine3_Upscale.fx", layout);
+  if (FAILED(hr)) {
+    ERROR("DynamicResolution", "init", ("Failed to initialize upscale shader. HRESULT: " + std::to_string(hr)).c_str());
+    destroy();
+    return hr;
+  }
+
+  // Quad en clip; la V crece hacia abajo como la textura
+  MeshComponent quad;
+  quad.m_vertex = {
+    { XMFLOAT3(-1.0f,  1.0f, 0.0f), XMFLOAT2(0.0f, 0.0f) },
+    { XMFLOAT3( 1.0f,  1.0f, 0.0f), XMFLOAT2(1.0f, 0.0f) },
+    { XMFLOAT3( 1.0f, -1.0f, 0.0f), XMFLOAT2(1.0f, 1.0f) },
+    { XMFLOAT3(-1.0f, -1.0f, 0.0f), XMFLOAT2(0.0f, 1.0f) },
+  };
+  quad.m_index = { 0, 1, 2, 0, 2, 3 };
+  quad.m_numVertex = 4;
+  quad.m_numIndex = 6;
+  hr = m_vertexBuffer.init(device, quad, D3D11_BIND_VERTEX_BUFFER);
+  if (SUCCEEDED(hr)) {
+    hr = m_indexBuffer.init(device, quad, D3D11_BIND_INDEX_BUFFER);
+  }
+  if (SUCCEEDED(hr)) {
+    hr = m_constantBuffer.init(device, sizeof(CBUpscale));
+  }
+  if (FAILED(hr)) {
+    ERROR("DynamicResolution", "init", ("Failed to create upscale buffers. HRESULT: " + std::to_string(hr)).c_str());
+    destroy();
+    return hr;
+  }
+
+  PipelineStateCache& states = PipelineStateCache::getInstance();
+  D3D11_SAMPLER_DESC samplerDesc = {};
+  samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+  samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+  samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+  samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+  samplerDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+  samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+  m_sampler = states.getSamplerState(device, samplerDesc);
+
+  // Sin profundidad: el quad cubre todo y no hay DSV enlazada
+  D3D11_DEPTH_STENCIL_DESC depthDesc = {};
+  depthDesc.DepthEnable = FALSE;
+  depthDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+  depthDesc.DepthFunc = D3D11_COMPARISON_ALWAYS;
+  PipelineStateDesc pipelineDesc;
+  pipelineDesc.vertexShader = m_shader.m_VertexShader;
+  pipelineDesc.pixelShader = m_shader.m_PixelShader;
+  pipelineDesc.inputLayout = m_shader.m_inputLayout.m_inputLayout;
+  pipelineDesc.depthStencilState = states.getDepthStencilState(device, depthDesc);
+  m_pipeline = states.getPipeline(pipelineDesc);
+  if (!m_sampler || !pipelineDesc.depthStencilState || m_pipeline == kNoPipeline) {
+    ERROR("DynamicResolution", "init", "Failed to create upscale states.");
+    destroy();
+    return E_FAIL;
+  }
+  return S_OK;
+}
+
+void
+DynamicResolution::destroy() {
+  m_shader.destroy();
+  m_vertexBuffer.destroy();
+  m_indexBuffer.destroy();
+  m_constantBuffer.destroy();
+  // Sampler y pipeline son de la PipelineStateCache
+  m_sampler = nullptr;
+  m_pipeline = kNoPipeline;
+}
+
+void
+DynamicResolution::setEnabled(bool enabled) {
+  if (enabled && !m_enabled) {
+    // Empieza desde la escala completa en lugar de la que qued al apagarlo
+    m_controller.reset();
+  }
+  m_enabled = enabled;
+}
+
+void
+DynamicResolution::update(float frameMs) {
+  if (m_enabled) {
+    m_controller.update(frameMs);
+  }
+}
+
+D3D11_VIEWPORT
+DynamicResolution::getSceneViewport() const {
+  const float scale = getScale();
+  D3D11_VIEWPORT viewport = {};
+  viewport.Width = floorf(m_width * scale + 0.5f);
+  viewport.Height = floorf(m_height * scale + 0.5f);
+  viewport.Width = viewport.Width < 1.0f ? 1.0f : viewport.Width;
+  viewport.Height = viewport.Height < 1.0f ? 1.0f : viewport.Height;
+  viewport.MaxDepth = 1.0f;
+  return viewport;
+}
+
+void
+DynamicResolution::upscale(DeviceContext& deviceContext,
+                           ID3D11ShaderResourceView* source,
+                           ID3D11RenderTargetView* target) {
+  if (m_pipeline == kNoPipeline || !source || !target) {
+    return;
+  }
+  const D3D11_VIEWPORT scene = getSceneViewport();
+  CBUpscale constants;
+  constants.vUVScale = XMFLOAT4(scene.Width / m_width,
+                                scene.Height / m_height,
+                                (scene.Width - 0.5f) / m_width,
+                                (scene.Height - 0.5f) / m_height);
+  m_constantBuffer.update(deviceContext, nullptr, 0, nullptr, &constants, 0, 0);
+
+  D3D11_VIEWPORT output = {};
+  output.Width = static_cast<float>(m_width);
+  output.Height = static_cast<float>(m_height);
+  output.MaxDepth = 1.0f;
+  deviceContext.OMSetRenderTargets(1, &target, nullptr);
+  deviceContext.RSSetViewports(1, &output);
+  PipelineStateCache::getInstance().bind(deviceContext, m_pipeline);
+  m_vertexBuffer.render(deviceContext, 0, 1);
+  m_indexBuffer.render(deviceContext, 0, 1, false, DXGI_FORMAT_R32_UINT);
+  m_constantBuffer.render(deviceContext, 0, 1, true);
+  ID3D11SamplerState* sampler = m_sampler;
+  deviceContext.PSSetShaderResources(0, 1, &source);
+  deviceContext.PSSetSamplers(0, 1, &sampler);
+  deviceContext.DrawIndexed(6, 0, 0);
+
+  // El objetivo interno vuelve a ser destino del resolve en el siguiente frame
+  ID3D11ShaderResourceView* nullView = nullptr;
+  deviceContext.PSSetShaderResources(0, 1, &nullView);
+}
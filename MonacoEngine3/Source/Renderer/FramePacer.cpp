@@ -0,0 +1,291 @@
+#include "Renderer/FramePacer.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <cmath>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace {
+  // Pausa entre sondeos de la consulta de la GPU: girar ocupara un ncleo mientras termina
+  const float kGpuPollMs = 0.25f;
+}
+
+HRESULT
+FramePacer::init(Device* device) {
+  LARGE_INTEGER frequency;
+  QueryPerformanceFrequency(&frequency);
+  m_frequency = frequency.QuadPart;
+
+  // Alta resolucin desde Windows 10 1803; antes, un temporizador normal (~1 ms de grano)
+  m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+  if (!m_timer) {
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+  }
+  reset();
+
+  if (!device || !device->m_device) {
+    return S_OK;
+  }
+  HRESULT hr = device->m_device->QueryInterface(__uuidof(IDXGIDevice1), reinterpret_cast<void**>(&m_dxgiDevice));
+  if (FAILED(hr)) {
+    m_dxgiDevice = nullptr;
+  }
+  applyFrameLatency();
+
+  D3D11_QUERY_DESC queryDesc = {};
+  queryDesc.Query = D3D11_QUERY_EVENT;
+  m_frameQueries.assign(kMaxFrameLatency, nullptr);
+  for (ID3D11Query*& query : m_frameQueries) {
+    hr = device->CreateQuery(&queryDesc, &query);
+    if (FAILED(hr)) {
+      // Sin consultas queda el tope de DXGI
+      ERROR("FramePacer", "init", ("Failed to create frame latency queries. HRESULT: " + std::to_string(hr)).c_str());
+      for (ID3D11Query*& created : m_frameQueries) {
+        SAFE_RELEASE(created);
+      }
+      m_frameQueries.clear();
+      break;
+    }
+  }
+  return S_OK;
+}
+
+void
+FramePacer::destroy() {
+  for (ID3D11Query*& query : m_frameQueries) {
+    SAFE_RELEASE(query);
+  }
+  m_frameQueries.clear();
+  m_queriesIssued = 0;
+  SAFE_RELEASE(m_dxgiDevice);
+  if (m_timer) {
+    CloseHandle(m_timer);
+    m_timer = nullptr;
+  }
+}
+
+void
+FramePacer::setSettings(const FramePacerSettings& settings) {
+  m_settings = settings;
+  m_settings.targetFps = m_settings.targetFps > 0.0f ? m_settings.targetFps : 0.0f;
+  m_settings.spinMs = m_settings.spinMs > 0.0f ? m_settings.spinMs : 0.0f;
+  m_settings.maxFrameLatency = m_settings.maxFrameLatency < 1 ? 1 : m_settings.maxFrameLatency;
+  m_settings.maxFrameLatency = m_settings.maxFrameLatency > kMaxFrameLatency ? kMaxFrameLatency : m_settings.maxFrameLatency;
+  // Con otro ritmo el calendario anterior ya no sirve
+  m_scheduled = false;
+  applyFrameLatency();
+}
+
+void
+FramePacer::reset() {
+  m_scheduled = false;
+  m_deadline = 0;
+  m_previousStart = 0;
+  m_frameStart = 0;
+  m_inputTicks = 0;
+  m_frameWorkMs = 0.0f;
+  m_current = FrameSample();
+  m_samples.assign(kWindow, FrameSample());
+  m_nextSample = 0;
+  m_stats = FramePacerStats();
+}
+
+void
+FramePacer::applyFrameLatency() {
+  if (m_dxgiDevice) {
+    m_dxgiDevice->SetMaximumFrameLatency(m_settings.maxFrameLatency);
+  }
+}
+
+long long
+FramePacer::now() {
+  LARGE_INTEGER ticks;
+  QueryPerformanceCounter(&ticks);
+  return ticks.QuadPart;
+}
+
+long long
+FramePacer::scheduleFrame(long long now, long long ticksPerSecond) {
+  if (m_settings.targetFps <= 0.0f || ticksPerSecond <= 0) {
+    m_scheduled = false;
+    return now;
+  }
+  const long long period = static_cast<long long>(static_cast<double>(ticksPerSecond) / m_settings.targetFps);
+  if (!m_scheduled) {
+    m_scheduled = true;
+    m_deadline = now;
+    return m_deadline;
+  }
+  // Calendario fijo: el retraso de un frame no desplaza a los siguientes
+  m_deadline += period;
+  if (now > m_deadline + period) {
+    // Ms de un periodo tarde (carga, ventana arrastrada): se ancla de nuevo sin rfaga
+    ++m_stats.framesMissed;
+    m_deadline = now;
+  }
+  else if (now > m_deadline) {
+    ++m_stats.framesMissed;
+  }
+  return m_deadline;
+}
+
+void
+FramePacer::waitUntil(long long deadline, float& sleepMs, float& spinMs) {
+  const double msPerTick = 1000.0 / static_cast<double>(m_frequency);
+  const long long spinTicks = static_cast<long long>(m_settings.spinMs / msPerTick);
+  long long start = now();
+  sleepMs = 0.0f;
+  spinMs = 0.0f;
+  if (start >= deadline) {
+    return;
+  }
+
+  // Dormir hasta el margen de giro
+  const long long ticksToSleep = deadline - spinTicks - start;
+  if (ticksToSleep > 0) {
+    sleepTicks(ticksToSleep);
+    const long long woke = now();
+    sleepMs = static_cast<float>((woke - start) * msPerTick);
+    start = woke;
+  }
+
+  // El resto, girando: el temporizador puede despertar tarde, el contador no
+  while (now() < deadline) {
+    YieldProcessor();
+  }
+  spinMs = start < deadline ? static_cast<float>((deadline - start) * msPerTick) : 0.0f;
+}
+
+void
+FramePacer::sleepTicks(long long ticks) {
+  // El temporizador cuenta en unidades de 100 ns
+  const double msPerTick = 1000.0 / static_cast<double>(m_frequency);
+  LARGE_INTEGER dueTime;
+  dueTime.QuadPart = -static_cast<long long>(ticks * msPerTick * 10000.0);
+  if (m_timer && dueTime.QuadPart < 0 && SetWaitableTimer(m_timer, &dueTime, 0, nullptr, nullptr, FALSE)) {
+    WaitForSingleObject(m_timer, INFINITE);
+  }
+  else {
+    Sleep(static_cast<DWORD>(ticks * msPerTick));
+  }
+}
+
+void
+FramePacer::waitForFrame(DeviceContext* deviceContext) {
+  const double msPerTick = 1000.0 / static_cast<double>(m_frequency);
+  m_current = FrameSample();
+
+  // La GPU no puede llevar ms de maxFrameLatency frames de retraso
+  if (deviceContext && !m_frameQueries.empty() && m_queriesIssued >= m_settings.maxFrameLatency) {
+    ID3D11Query* query = m_frameQueries[(m_queriesIssued - m_settings.maxFrameLatency) % kMaxFrameLatency];
+    const long long gpuWaitStart = now();
+    const long long pollTicks = static_cast<long long>(kGpuPollMs / msPerTick);
+    BOOL done = FALSE;
+    while (deviceContext->GetData(query, &done, sizeof(done), 0) == S_FALSE) {
+      sleepTicks(pollTicks);
+    }
+    m_current.gpuWaitMs = static_cast<float>((now() - gpuWaitStart) * msPerTick);
+  }
+
+  const long long deadline = scheduleFrame(now(), m_frequency);
+  waitUntil(deadline, m_current.sleepMs, m_current.spinMs);
+  m_previousStart = m_frameStart;
+  m_frameStart = now();
+  m_current.lateMs = m_settings.targetFps > 0.0f ? static_cast<float>((m_frameStart - deadline) * msPerTick) : 0.0f;
+}
+
+void
+FramePacer::markInput() {
+  if (m_inputTicks == 0) {
+    m_inputTicks = now();
+  }
+}
+
+void
+FramePacer::markInput(DWORD messageTime) {
+  // Antigedad en el reloj de GetTickCount; un mensaje "del futuro" (relojes de grano
+  // distinto) cuenta como recin llegado
+  const DWORD ageMs = GetTickCount() - messageTime;
+  const long long age = ageMs < 0x80000000u ? static_cast<long long>(ageMs) * m_frequency / 1000 : 0;
+  const long long ticks = now() - age;
+  if (m_inputTicks == 0 || ticks < m_inputTicks) {
+    m_inputTicks = ticks;
+  }
+}
+
+void
+FramePacer::framePresented(DeviceContext* deviceContext) {
+  if (deviceContext && !m_frameQueries.empty()) {
+    deviceContext->End(m_frameQueries[m_queriesIssued % kMaxFrameLatency]);
+    ++m_queriesIssued;
+  }
+  const double msPerTick = 1000.0 / static_cast<double>(m_frequency);
+  const long long presented = now();
+  m_frameWorkMs = m_frameStart != 0 ? static_cast<float>((presented - m_frameStart) * msPerTick) : 0.0f;
+  const float latencyMs = m_inputTicks != 0 ? static_cast<float>((presented - m_inputTicks) * msPerTick) : -1.0f;
+  m_inputTicks = 0;
+  if (m_previousStart == 0) {
+    return;
+  }
+  m_current.frameMs = static_cast<float>((m_frameStart - m_previousStart) * msPerTick);
+  m_current.latencyMs = latencyMs;
+  addSample(m_current);
+}
+
+void
+FramePacer::recordFrame(float frameMs, float latencyMs, float sleepMs, float spinMs, float lateMs) {
+  FrameSample sample;
+  sample.frameMs = frameMs;
+  sample.latencyMs = latencyMs;
+  sample.sleepMs = sleepMs;
+  sample.spinMs = spinMs;
+  sample.lateMs = lateMs;
+  addSample(sample);
+}
+
+void
+FramePacer::addSample(const FrameSample& sample) {
+  if (m_samples.empty()) {
+    m_samples.assign(kWindow, FrameSample());
+  }
+  m_samples[m_nextSample] = sample;
+  m_nextSample = (m_nextSample + 1) % kWindow;
+  ++m_stats.frames;
+
+  // Media y varianza exactas de la ventana: recorrer 240 muestras por frame cuesta poco
+  const unsigned int count = m_stats.frames < kWindow ? static_cast<unsigned int>(m_stats.frames) : kWindow;
+  double frameSum = 0.0, latencySum = 0.0, sleepSum = 0.0, spinSum = 0.0, lateSum = 0.0, gpuWaitSum = 0.0;
+  unsigned int latencyCount = 0;
+  float frameWorst = 0.0f, latencyWorst = 0.0f;
+  for (unsigned int i = 0; i < count; ++i) {
+    const FrameSample& s = m_samples[i];
+    frameSum += s.frameMs;
+    sleepSum += s.sleepMs;
+    spinSum += s.spinMs;
+    lateSum += s.lateMs;
+    gpuWaitSum += s.gpuWaitMs;
+    frameWorst = s.frameMs > frameWorst ? s.frameMs : frameWorst;
+    if (s.latencyMs >= 0.0f) {
+      latencySum += s.latencyMs;
+      latencyWorst = s.latencyMs > latencyWorst ? s.latencyMs : latencyWorst;
+      ++latencyCount;
+    }
+  }
+  const double frameAvg = frameSum / count;
+  double variance = 0.0;
+  for (unsigned int i = 0; i < count; ++i) {
+    const double d = m_samples[i].frameMs - frameAvg;
+    variance += d * d;
+  }
+  m_stats.frameMsAvg = static_cast<float>(frameAvg);
+  m_stats.frameMsStdDev = static_cast<float>(sqrt(variance / count));
+  m_stats.frameMsWorst = frameWorst;
+  m_stats.latencyMsAvg = latencyCount > 0 ? static_cast<float>(latencySum / latencyCount) : 0.0f;
+  m_stats.latencyMsWorst = latencyWorst;
+  m_stats.sleepMsAvg = static_cast<float>(sleepSum / count);
+  m_stats.spinMsAvg = static_cast<float>(spinSum / count);
+  m_stats.lateMsAvg = static_cast<float>(lateSum / count);
+  m_stats.gpuWaitMsAvg = static_cast<float>(gpuWaitSum / count);
+}
@@ -0,0 +1,85 @@
+#include "Renderer/FreeListAllocator.h"
+#include <iterator>
+
+void
+FreeListAllocator::init(unsigned int capacity) {
+  m_freeByOffset.clear();
+  m_freeBySize.clear();
+  m_allocated.clear();
+  m_capacity = capacity;
+  m_used = 0;
+  if (capacity > 0) {
+    insertFree(0, capacity);
+  }
+}
+
+void
+FreeListAllocator::insertFree(unsigned int offset, unsigned int size) {
+  m_freeByOffset[offset] = size;
+  m_freeBySize.insert(std::make_pair(size, offset));
+}
+
+void
+FreeListAllocator::eraseFree(std::map<unsigned int, unsigned int>::iterator block) {
+  auto range = m_freeBySize.equal_range(block->second);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == block->first) {
+      m_freeBySize.erase(it);
+      break;
+    }
+  }
+  m_freeByOffset.erase(block);
+}
+
+unsigned int
+FreeListAllocator::allocate(unsigned int size) {
+  if (size == 0) {
+    return kInvalidOffset;
+  }
+  // Best fit: el hueco ms pequeo que alcanza deja intactos los grandes
+  auto fit = m_freeBySize.lower_bound(size);
+  if (fit == m_freeBySize.end()) {
+    return kInvalidOffset;
+  }
+
+  unsigned int offset = fit->second;
+  unsigned int blockSize = fit->first;
+  m_freeBySize.erase(fit);
+  m_freeByOffset.erase(offset);
+  if (blockSize > size) {
+    insertFree(offset + size, blockSize - size);
+  }
+
+  m_allocated[offset] = size;
+  m_used += size;
+  return offset;
+}
+
+bool
+FreeListAllocator::free(unsigned int offset) {
+  auto allocation = m_allocated.find(offset);
+  if (allocation == m_allocated.end()) {
+    return false;
+  }
+  unsigned int size = allocation->second;
+  m_allocated.erase(allocation);
+  m_used -= size;
+
+  // Fusionar con el hueco siguiente y el anterior si se tocan
+  auto next = m_freeByOffset.lower_bound(offset);
+  if (next != m_freeByOffset.end() && offset + size == next->first) {
+    size += next->second;
+    auto erase = next++;
+    eraseFree(erase);
+  }
+  if (next != m_freeByOffset.begin()) {
+    auto previous = std::prev(next);
+    if (previous->first + previous->second == offset) {
+      offset = previous->first;
+      size += previous->second;
+      eraseFree(previous);
+    }
+  }
+  insertFree(offset, size);
+  return true;
+}
@@ -0,0 +1,245 @@
+#include "Renderer/MeshPool.h"
+#include "MeshComponent.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <algorithm>
+
+namespace {
+  const unsigned int kIndexStride = sizeof(unsigned int);
+
+  // Caja de bytes [first, first + count) * stride dentro de un buffer
+  D3D11_BOX
+  bufferBox(unsigned int first, unsigned int count, unsigned int stride) {
+    D3D11_BOX box = {};
+    box.left = first * stride;
+    box.right = (first + count) * stride;
+    box.top = 0;
+    box.bottom = 1;
+    box.front = 0;
+    box.back = 1;
+    return box;
+  }
+}
+
+HRESULT
+MeshPool::init(Device& device,
+               unsigned int vertexCapacity,
+               unsigned int indexCapacity) {
+  destroy();
+  if (vertexCapacity == 0 || indexCapacity == 0) {
+    ERROR("MeshPool", "init", "vertexCapacity or indexCapacity is zero");
+    return E_INVALIDARG;
+  }
+
+  HRESULT hr = m_vertexBuffer.initDefault(device, sizeof(SimpleVertex), vertexCapacity, D3D11_BIND_VERTEX_BUFFER);
+  if (FAILED(hr)) {
+    ERROR("MeshPool", "init", ("Failed to create vertex buffer. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
+  }
+  hr = m_indexBuffer.initDefault(device, kIndexStride, indexCapacity, D3D11_BIND_INDEX_BUFFER);
+  if (FAILED(hr)) {
+    ERROR("MeshPool", "init", ("Failed to create index buffer. HRESULT: " + std::to_string(hr)).c_str());
+    m_vertexBuffer.destroy();
+    return hr;
+  }
+  m_vertexAllocator.init(vertexCapacity);
+  m_indexAllocator.init(indexCapacity);
+  return S_OK;
+}
+
+void
+MeshPool::destroy() {
+  m_vertexBuffer.destroy();
+  m_indexBuffer.destroy();
+  m_vertexAllocator.init(0);
+  m_indexAllocator.init(0);
+  m_entries.clear();
+  m_freeHandles.clear();
+  m_defragmentations = 0;
+  m_bytesMoved = 0;
+}
+
+bool
+MeshPool::allocateRange(unsigned int vertexCount,
+                        unsigned int indexCount,
+                        MeshRange& range) {
+  unsigned int baseVertex = m_vertexAllocator.allocate(vertexCount);
+  if (baseVertex == FreeListAllocator::kInvalidOffset) {
+    return false;
+  }
+  unsigned int startIndex = m_indexAllocator.allocate(indexCount);
+  if (startIndex == FreeListAllocator::kInvalidOffset) {
+    m_vertexAllocator.free(baseVertex);
+    return false;
+  }
+  range.baseVertex = baseVertex;
+  range.vertexCount = vertexCount;
+  range.startIndex = startIndex;
+  range.indexCount = indexCount;
+  return true;
+}
+
+MeshHandle
+MeshPool::upload(Device& device,
+                 DeviceContext& deviceContext,
+                 const MeshComponent& mesh) {
+  if (!m_vertexBuffer.getBuffer() || !m_indexBuffer.getBuffer()) {
+    ERROR("MeshPool", "upload", "Pool is not initialized");
+    return kInvalidMesh;
+  }
+  if (mesh.m_vertex.empty() || mesh.m_index.empty()) {
+    ERROR("MeshPool", "upload", "Mesh has no vertices or indices");
+    return kInvalidMesh;
+  }
+  const unsigned int vertexCount = static_cast<unsigned int>(mesh.m_vertex.size());
+  const unsigned int indexCount = static_cast<unsigned int>(mesh.m_index.size());
+
+  MeshRange range;
+  if (!allocateRange(vertexCount, indexCount, range)) {
+    // Si el espacio libre total alcanza basta con compactar; si no, crecer
+    unsigned int vertexCapacity = m_vertexAllocator.getCapacity();
+    unsigned int indexCapacity = m_indexAllocator.getCapacity();
+    if (m_vertexAllocator.getFree() < vertexCount) {
+      vertexCapacity = (std::max)(vertexCapacity * 2, m_vertexAllocator.getUsed() + vertexCount);
+    }
+    if (m_indexAllocator.getFree() < indexCount) {
+      indexCapacity = (std::max)(indexCapacity * 2, m_indexAllocator.getUsed() + indexCount);
+    }
+    HRESULT hr = relocate(device, deviceContext, vertexCapacity, indexCapacity);
+    if (FAILED(hr) || !allocateRange(vertexCount, indexCount, range)) {
+      ERROR("MeshPool", "upload", "Mesh does not fit in the pool");
+      return kInvalidMesh;
+    }
+  }
+
+  D3D11_BOX vertexBox = bufferBox(range.baseVertex, vertexCount, sizeof(SimpleVertex));
+  m_vertexBuffer.update(deviceContext, nullptr, 0, &vertexBox, mesh.m_vertex.data(), 0, 0);
+  D3D11_BOX indexBox = bufferBox(range.startIndex, indexCount, kIndexStride);
+  m_indexBuffer.update(deviceContext, nullptr, 0, &indexBox, mesh.m_index.data(), 0, 0);
+
+  MeshHandle handle;
+  if (!m_freeHandles.empty()) {
+    handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+  }
+  else {
+    handle = static_cast<MeshHandle>(m_entries.size());
+    m_entries.push_back(MeshEntry());
+  }
+  m_entries[handle].range = range;
+  m_entries[handle].refCount = 1;
+  return handle;
+}
+
+void
+MeshPool::addRef(MeshHandle handle) {
+  if (!isValid(handle)) {
+    ERROR("MeshPool", "addRef", "Invalid mesh handle");
+    return;
+  }
+  ++m_entries[handle].refCount;
+}
+
+void
+MeshPool::release(MeshHandle handle) {
+  if (!isValid(handle)) {
+    ERROR("MeshPool", "release", "Invalid mesh handle");
+    return;
+  }
+  MeshEntry& entry = m_entries[handle];
+  if (--entry.refCount > 0) {
+    return;
+  }
+  m_vertexAllocator.free(entry.range.baseVertex);
+  m_indexAllocator.free(entry.range.startIndex);
+  entry.range = MeshRange();
+  m_freeHandles.push_back(handle);
+}
+
+HRESULT
+MeshPool::defragment(Device& device, DeviceContext& deviceContext) {
+  return relocate(device,
+                  deviceContext,
+                  m_vertexAllocator.getCapacity(),
+                  m_indexAllocator.getCapacity());
+}
+
+HRESULT
+MeshPool::relocate(Device& device,
+                   DeviceContext& deviceContext,
+                   unsigned int vertexCapacity,
+                   unsigned int indexCapacity) {
+  if (!m_vertexBuffer.getBuffer() || !m_indexBuffer.getBuffer()) {
+    ERROR("MeshPool", "relocate", "Pool is not initialized");
+    return E_POINTER;
+  }
+
+  // Buffers nuevos primero: si fallan el pool sigue como estaba
+  Buffer vertexBuffer;
+  HRESULT hr = vertexBuffer.initDefault(device, sizeof(SimpleVertex), vertexCapacity, D3D11_BIND_VERTEX_BUFFER);
+  if (FAILED(hr)) {
+    ERROR("MeshPool", "relocate", ("Failed to create vertex buffer. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
+  }
+  Buffer indexBuffer;
+  hr = indexBuffer.initDefault(device, kIndexStride, indexCapacity, D3D11_BIND_INDEX_BUFFER);
+  if (FAILED(hr)) {
+    ERROR("MeshPool", "relocate", ("Failed to create index buffer. HRESULT: " + std::to_string(hr)).c_str());
+    vertexBuffer.destroy();
+    return hr;
+  }
+
+  // Con un nico hueco libre, cada asignacin sale justo detrs de la anterior
+  m_vertexAllocator.init(vertexCapacity);
+  m_indexAllocator.init(indexCapacity);
+  for (MeshEntry& entry : m_entries) {
+    if (entry.refCount == 0) {
+      continue;
+    }
+    MeshRange packed;
+    allocateRange(entry.range.vertexCount, entry.range.indexCount, packed);
+
+    D3D11_BOX vertexBox = bufferBox(entry.range.baseVertex, entry.range.vertexCount, sizeof(SimpleVertex));
+    deviceContext.CopySubresourceRegion(vertexBuffer.getBuffer(), 0, packed.baseVertex * sizeof(SimpleVertex), 0, 0,
+                                        m_vertexBuffer.getBuffer(), 0, &vertexBox);
+    D3D11_BOX indexBox = bufferBox(entry.range.startIndex, entry.range.indexCount, kIndexStride);
+    deviceContext.CopySubresourceRegion(indexBuffer.getBuffer(), 0, packed.startIndex * kIndexStride, 0, 0,
+                                        m_indexBuffer.getBuffer(), 0, &indexBox);
+    m_bytesMoved += (vertexBox.right - vertexBox.left) + (indexBox.right - indexBox.left);
+    entry.range = packed;
+  }
+
+  m_vertexBuffer.destroy();
+  m_indexBuffer.destroy();
+  m_vertexBuffer = vertexBuffer;
+  m_indexBuffer = indexBuffer;
+  ++m_defragmentations;
+
+  MESSAGE("MeshPool", "relocate",
+    ("Compacted pool to " + std::to_string(vertexCapacity) + " vertices / " +
+     std::to_string(indexCapacity) + " indices.").c_str());
+  return S_OK;
+}
+
+MeshRange
+MeshPool::getRange(MeshHandle handle) const {
+  if (!isValid(handle)) {
+    return MeshRange();
+  }
+  return m_entries[handle].range;
+}
+
+MeshPoolStats
+MeshPool::getStats() const {
+  MeshPoolStats stats;
+  stats.vertexCapacity = m_vertexAllocator.getCapacity();
+  stats.verticesUsed = m_vertexAllocator.getUsed();
+  stats.indexCapacity = m_indexAllocator.getCapacity();
+  stats.indicesUsed = m_indexAllocator.getUsed();
+  stats.meshes = m_vertexAllocator.getAllocationCount();
+  stats.vertexFragmentation = m_vertexAllocator.getFragmentation();
+  stats.indexFragmentation = m_indexAllocator.getFragmentation();
+  stats.defragmentations = m_defragmentations;
+  stats.bytesMoved = m_bytesMoved;
+  return stats;
+}
@@ -0,0 +1,145 @@
+#include "Renderer/ParallelCommandRecorder.h"
+#include "EngineUtilities/Utilities/ThreadPool.h"
+
+HRESULT
+ParallelCommandRecorder::init(DeviceContext& immediate,
+                              ThreadPool& threadPool,
+                              unsigned int maxContexts,
+                              unsigned int minItemsPerContext) {
+  destroy();
+  m_threadPool = &threadPool;
+  m_minItemsPerContext = minItemsPerContext > 0 ? minItemsPerContext : 1;
+
+  IRenderBackend* backend = immediate.getBackend();
+  if (!backend) {
+    ERROR("ParallelCommandRecorder", "init", "Immediate context has no backend");
+    return E_POINTER;
+  }
+  if (maxContexts == 0) {
+    maxContexts = threadPool.getConcurrency();
+  }
+  if (maxContexts < 2) {
+    MESSAGE("ParallelCommandRecorder", "init", "Single render thread, recording on the immediate context.");
+    return S_OK;
+  }
+  if (!backend->supportsDeferredContexts()) {
+    MESSAGE("ParallelCommandRecorder", "init", "Backend has no deferred contexts, recording on the immediate context.");
+    return S_OK;
+  }
+
+  for (unsigned int i = 0; i < maxContexts; ++i) {
+    auto slot = std::make_unique<DeferredSlot>();
+    HRESULT hr = backend->createDeferredContext(slot->context, slot->backend);
+    if (FAILED(hr)) {
+      // No es fatal: se graba en serie
+      ERROR("ParallelCommandRecorder", "init",
+        ("Failed to create deferred context, recording on the immediate context. HRESULT: " + std::to_string(hr)).c_str());
+      destroy();
+      return S_OK;
+    }
+    m_slots.push_back(std::move(slot));
+  }
+
+  MESSAGE("ParallelCommandRecorder", "init",
+    ("Recording with " + std::to_string(maxContexts) + " deferred contexts.").c_str());
+  return S_OK;
+}
+
+void
+ParallelCommandRecorder::destroy() {
+  for (auto& slot : m_slots) {
+    slot->commandList.reset();
+    slot->context.destroy();
+    slot->backend.reset();
+  }
+  m_slots.clear();
+  m_ranges.clear();
+  m_stats = ParallelRecorderStats();
+}
+
+void
+ParallelCommandRecorder::partition(unsigned int itemCount,
+                                   unsigned int maxRanges,
+                                   unsigned int minItemsPerRange,
+                                   std::vector<WorkRange>& ranges) {
+  ranges.clear();
+  if (itemCount == 0) {
+    return;
+  }
+  if (minItemsPerRange == 0) {
+    minItemsPerRange = 1;
+  }
+
+  unsigned int rangeCount = itemCount / minItemsPerRange;
+  if (rangeCount > maxRanges) rangeCount = maxRanges;
+  if (rangeCount == 0) rangeCount = 1;
+
+  // Los primeros (itemCount % rangeCount) rangos llevan un elemento ms
+  unsigned int base = itemCount / rangeCount;
+  unsigned int extra = itemCount % rangeCount;
+  unsigned int begin = 0;
+  for (unsigned int i = 0; i < rangeCount; ++i) {
+    WorkRange range;
+    range.begin = begin;
+    range.end = begin + base + (i < extra ? 1 : 0);
+    ranges.push_back(range);
+    begin = range.end;
+  }
+}
+
+void
+ParallelCommandRecorder::record(DeviceContext& immediate,
+                                unsigned int itemCount,
+                                const SetupFn& setupState,
+                                const RecordFn& recordRange) {
+  m_stats = ParallelRecorderStats();
+  partition(itemCount, getMaxRanges(), m_minItemsPerContext, m_ranges);
+  if (m_ranges.empty()) {
+    return;
+  }
+  m_stats.ranges = static_cast<unsigned int>(m_ranges.size());
+  m_stats.itemsRecorded = itemCount;
+
+  // Poco trabajo o sin contextos diferidos: el inmediato ya tiene su estado
+  if (m_ranges.size() == 1 || !m_threadPool) {
+    WorkRange all;
+    all.end = itemCount;
+    m_stats.ranges = 1;
+    recordRange(immediate, all, 0);
+    return;
+  }
+
+  const bool stateFiltering = immediate.isStateFilteringEnabled();
+  m_threadPool->parallelFor(static_cast<unsigned int>(m_ranges.size()), [&](unsigned int index) {
+    DeferredSlot& slot = *m_slots[index];
+    slot.context.setStateFiltering(stateFiltering);
+    slot.context.resetStateStats();
+    slot.backend->resetStats();
+    if (setupState) {
+      setupState(slot.context);
+    }
+    recordRange(slot.context, m_ranges[index], index);
+    slot.result = slot.context.FinishCommandList(slot.commandList);
+  });
+
+  // Ejecutar en el orden de los rangos para conservar el orden de dibujo
+  IRenderBackend* immediateBackend = immediate.getBackend();
+  for (size_t i = 0; i < m_ranges.size(); ++i) {
+    DeferredSlot& slot = *m_slots[i];
+    if (SUCCEEDED(slot.result) && slot.commandList) {
+      immediate.ExecuteCommandList(*slot.commandList);
+      ++m_stats.commandLists;
+    }
+    else {
+      ERROR("ParallelCommandRecorder", "record",
+        ("Dropping command list. HRESULT: " + std::to_string(slot.result)).c_str());
+      ++m_stats.failedLists;
+    }
+    slot.commandList.reset();
+
+    if (immediateBackend) {
+      immediateBackend->accumulateStats(slot.backend->getStats());
+    }
+    immediate.accumulateStateStats(slot.context.getStateStats());
+  }
+}
@@ -0,0 +1,331 @@
+#include "Renderer/PipelineStateCache.h"
+#include "Device.h"
+#include "DeviceContext.h"
+
+namespace {
+  // -0.0f y 0.0f son el mismo valor para D3D pero no los mismos bytes
+  float
+  canonicalFloat(float value) {
+    return value == 0.0f ? 0.0f : value;
+  }
+
+  // Mezcla de un render target cuando BlendEnable es FALSE (D3D slo usa la mscara)
+  void
+  setDisabledBlend(D3D11_RENDER_TARGET_BLEND_DESC& target, UINT8 writeMask) {
+    target.BlendEnable = FALSE;
+    target.SrcBlend = D3D11_BLEND_ONE;
+    target.DestBlend = D3D11_BLEND_ZERO;
+    target.BlendOp = D3D11_BLEND_OP_ADD;
+    target.SrcBlendAlpha = D3D11_BLEND_ONE;
+    target.DestBlendAlpha = D3D11_BLEND_ZERO;
+    target.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+    target.RenderTargetWriteMask = writeMask;
+  }
+
+  // Copias campo a campo sobre memoria a cero: ni el relleno ni los campos que D3D
+  // ignora cambian el hash, as dos descripciones equivalentes comparten estado
+  D3D11_SAMPLER_DESC
+  normalize(const D3D11_SAMPLER_DESC& desc) {
+    D3D11_SAMPLER_DESC out;
+    memset(&out, 0, sizeof(out));
+    out.Filter = desc.Filter;
+    out.AddressU = desc.AddressU;
+    out.AddressV = desc.AddressV;
+    out.AddressW = desc.AddressW;
+    out.MipLODBias = canonicalFloat(desc.MipLODBias);
+    out.MaxAnisotropy = desc.MaxAnisotropy;
+    out.ComparisonFunc = desc.ComparisonFunc;
+    const bool border = desc.AddressU == D3D11_TEXTURE_ADDRESS_BORDER ||
+                        desc.AddressV == D3D11_TEXTURE_ADDRESS_BORDER ||
+                        desc.AddressW == D3D11_TEXTURE_ADDRESS_BORDER;
+    for (int i = 0; i < 4; ++i) {
+      out.BorderColor[i] = border ? canonicalFloat(desc.BorderColor[i]) : 0.0f;
+    }
+    out.MinLOD = canonicalFloat(desc.MinLOD);
+    out.MaxLOD = canonicalFloat(desc.MaxLOD);
+    return out;
+  }
+
+  D3D11_BLEND_DESC
+  normalize(const D3D11_BLEND_DESC& desc) {
+    D3D11_BLEND_DESC out;
+    memset(&out, 0, sizeof(out));
+    out.AlphaToCoverageEnable = desc.AlphaToCoverageEnable ? TRUE : FALSE;
+    out.IndependentBlendEnable = desc.IndependentBlendEnable ? TRUE : FALSE;
+    // Sin mezcla independiente D3D slo lee RenderTarget[0]
+    const int targets = out.IndependentBlendEnable ? 8 : 1;
+    for (int i = 0; i < 8; ++i) {
+      const D3D11_RENDER_TARGET_BLEND_DESC& in = desc.RenderTarget[i];
+      if (i >= targets) {
+        setDisabledBlend(out.RenderTarget[i], D3D11_COLOR_WRITE_ENABLE_ALL);
+      }
+      else if (!in.BlendEnable) {
+        setDisabledBlend(out.RenderTarget[i], in.RenderTargetWriteMask);
+      }
+      else {
+        D3D11_RENDER_TARGET_BLEND_DESC& target = out.RenderTarget[i];
+        target.BlendEnable = TRUE;
+        target.SrcBlend = in.SrcBlend;
+        target.DestBlend = in.DestBlend;
+        target.BlendOp = in.BlendOp;
+        target.SrcBlendAlpha = in.SrcBlendAlpha;
+        target.DestBlendAlpha = in.DestBlendAlpha;
+        target.BlendOpAlpha = in.BlendOpAlpha;
+        target.RenderTargetWriteMask = in.RenderTargetWriteMask;
+      }
+    }
+    return out;
+  }
+
+  D3D11_RASTERIZER_DESC
+  normalize(const D3D11_RASTERIZER_DESC& desc) {
+    D3D11_RASTERIZER_DESC out;
+    memset(&out, 0, sizeof(out));
+    out.FillMode = desc.FillMode;
+    out.CullMode = desc.CullMode;
+    out.FrontCounterClockwise = desc.FrontCounterClockwise ? TRUE : FALSE;
+    out.DepthBias = desc.DepthBias;
+    out.DepthBiasClamp = canonicalFloat(desc.DepthBiasClamp);
+    out.SlopeScaledDepthBias = canonicalFloat(desc.SlopeScaledDepthBias);
+    out.DepthClipEnable = desc.DepthClipEnable ? TRUE : FALSE;
+    out.ScissorEnable = desc.ScissorEnable ? TRUE : FALSE;
+    out.MultisampleEnable = desc.MultisampleEnable ? TRUE : FALSE;
+    out.AntialiasedLineEnable = desc.AntialiasedLineEnable ? TRUE : FALSE;
+    return out;
+  }
+
+  D3D11_DEPTH_STENCIL_DESC
+  normalize(const D3D11_DEPTH_STENCIL_DESC& desc) {
+    D3D11_DEPTH_STENCIL_DESC out;
+    memset(&out, 0, sizeof(out));
+    out.DepthEnable = desc.DepthEnable ? TRUE : FALSE;
+    out.DepthWriteMask = desc.DepthWriteMask;
+    out.DepthFunc = desc.DepthFunc;
+    out.StencilEnable = desc.StencilEnable ? TRUE : FALSE;
+    if (out.StencilEnable) {
+      out.StencilReadMask = desc.StencilReadMask;
+      out.StencilWriteMask = desc.StencilWriteMask;
+      out.FrontFace = desc.FrontFace;
+      out.BackFace = desc.BackFace;
+    }
+    else {
+      // Sin stencil sus campos no se usan: valores por defecto de D3D11
+      out.StencilReadMask = D3D11_DEFAULT_STENCIL_READ_MASK;
+      out.StencilWriteMask = D3D11_DEFAULT_STENCIL_WRITE_MASK;
+      out.FrontFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
+      out.FrontFace.StencilDepthFailOp = D3D11_STENCIL_OP_KEEP;
+      out.FrontFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
+      out.FrontFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
+      out.BackFace = out.FrontFace;
+    }
+    return out;
+  }
+
+  // Busca por hash y bytes; si no est, lo crea con @p create y lo guarda
+  template<typename Table, typename Desc, typename Create>
+  auto
+  findOrCreate(Table& table,
+               const Desc& requested,
+               PipelineStateCacheStats& stats,
+               unsigned int& created,
+               Create create) -> decltype(table.find(0, requested)) {
+    ++stats.stateRequests;
+    const Desc desc = normalize(requested);
+    const uint64_t hash = EU::fnv1a64(&desc, sizeof(Desc));
+    auto state = table.find(hash, desc);
+    if (state) {
+      ++stats.stateHits;
+      return state;
+    }
+    HRESULT hr = create(desc, &state);
+    if (FAILED(hr) || !state) {
+      return nullptr;
+    }
+    table.entries.insert(std::make_pair(hash, typename Table::Entry{ desc, state }));
+    ++created;
+    return state;
+  }
+
+  uint64_t
+  hashPipeline(const PipelineStateDesc& desc) {
+    // Campo a campo: el relleno tras la topologa no cuenta
+    uint64_t hash = EU::hashValue(desc.vertexShader);
+    hash = EU::hashValue(desc.pixelShader, hash);
+    hash = EU::hashValue(desc.inputLayout, hash);
+    hash = EU::hashValue(desc.blendState, hash);
+    hash = EU::hashValue(desc.rasterizerState, hash);
+    hash = EU::hashValue(desc.depthStencilState, hash);
+    return EU::hashValue(desc.topology, hash);
+  }
+
+  bool
+  samePipeline(const PipelineStateDesc& a, const PipelineStateDesc& b) {
+    return a.vertexShader == b.vertexShader &&
+           a.pixelShader == b.pixelShader &&
+           a.inputLayout == b.inputLayout &&
+           a.blendState == b.blendState &&
+           a.rasterizerState == b.rasterizerState &&
+           a.depthStencilState == b.depthStencilState &&
+           a.topology == b.topology;
+  }
+}
+
+PipelineStateCache::PipelineStateCache() {
+  m_pipelines.push_back(PipelineStateDesc());
+}
+
+HRESULT
+PipelineStateCache::init(Device& device) {
+  // Valores por defecto documentados de D3D11 (equivalen a enlazar nullptr)
+  D3D11_BLEND_DESC blendDesc = {};
+  blendDesc.RenderTarget[0].BlendEnable = FALSE;
+  blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+  blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_ZERO;
+  blendDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+  blendDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+  blendDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+  blendDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+  blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+  D3D11_RASTERIZER_DESC rasterizerDesc = {};
+  rasterizerDesc.FillMode = D3D11_FILL_SOLID;
+  rasterizerDesc.CullMode = D3D11_CULL_BACK;
+  rasterizerDesc.DepthClipEnable = TRUE;
+
+  D3D11_DEPTH_STENCIL_DESC depthDesc = {};
+  depthDesc.DepthEnable = TRUE;
+  depthDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+  depthDesc.DepthFunc = D3D11_COMPARISON_LESS;
+  depthDesc.StencilReadMask = 0xff;
+  depthDesc.StencilWriteMask = 0xff;
+  depthDesc.FrontFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
+  depthDesc.FrontFace.StencilDepthFailOp = D3D11_STENCIL_OP_KEEP;
+  depthDesc.FrontFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
+  depthDesc.FrontFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
+  depthDesc.BackFace = depthDesc.FrontFace;
+
+  m_defaultBlend = getBlendState(device, blendDesc);
+  m_defaultRasterizer = getRasterizerState(device, rasterizerDesc);
+  m_defaultDepthStencil = getDepthStencilState(device, depthDesc);
+  if (!m_defaultBlend || !m_defaultRasterizer || !m_defaultDepthStencil) {
+    ERROR("PipelineStateCache", "init", "Failed to create default states");
+    return E_FAIL;
+  }
+  return S_OK;
+}
+
+void
+PipelineStateCache::destroy() {
+  for (size_t i = 1; i < m_pipelines.size(); ++i) {
+    PipelineStateDesc& desc = m_pipelines[i];
+    SAFE_RELEASE(desc.vertexShader);
+    SAFE_RELEASE(desc.pixelShader);
+    SAFE_RELEASE(desc.inputLayout);
+    SAFE_RELEASE(desc.blendState);
+    SAFE_RELEASE(desc.rasterizerState);
+    SAFE_RELEASE(desc.depthStencilState);
+  }
+  m_samplers.release();
+  m_blendStates.release();
+  m_rasterizerStates.release();
+  m_depthStencilStates.release();
+  m_pipelines.resize(1);
+  m_pipelineLookup.clear();
+  m_defaultBlend = nullptr;
+  m_defaultRasterizer = nullptr;
+  m_defaultDepthStencil = nullptr;
+  m_stats = PipelineStateCacheStats();
+}
+
+ID3D11SamplerState*
+PipelineStateCache::getSamplerState(Device& device, const D3D11_SAMPLER_DESC& desc) {
+  return findOrCreate(m_samplers, desc, m_stats, m_stats.samplerStates,
+    [&](const D3D11_SAMPLER_DESC& normalized, ID3D11SamplerState** state) {
+      return device.CreateSamplerState(&normalized, state);
+    });
+}
+
+ID3D11BlendState*
+PipelineStateCache::getBlendState(Device& device, const D3D11_BLEND_DESC& desc) {
+  return findOrCreate(m_blendStates, desc, m_stats, m_stats.blendStates,
+    [&](const D3D11_BLEND_DESC& normalized, ID3D11BlendState** state) {
+      return device.CreateBlendState(&normalized, state);
+    });
+}
+
+ID3D11RasterizerState*
+PipelineStateCache::getRasterizerState(Device& device, const D3D11_RASTERIZER_DESC& desc) {
+  return findOrCreate(m_rasterizerStates, desc, m_stats, m_stats.rasterizerStates,
+    [&](const D3D11_RASTERIZER_DESC& normalized, ID3D11RasterizerState** state) {
+      return device.CreateRasterizerState(&normalized, state);
+    });
+}
+
+ID3D11DepthStencilState*
+PipelineStateCache::getDepthStencilState(Device& device, const D3D11_DEPTH_STENCIL_DESC& desc) {
+  return findOrCreate(m_depthStencilStates, desc, m_stats, m_stats.depthStencilStates,
+    [&](const D3D11_DEPTH_STENCIL_DESC& normalized, ID3D11DepthStencilState** state) {
+      return device.CreateDepthStencilState(&normalized, state);
+    });
+}
+
+PipelineHandle
+PipelineStateCache::getPipeline(const PipelineStateDesc& desc) {
+  if (!desc.vertexShader || !desc.pixelShader || !desc.inputLayout) {
+    ERROR("PipelineStateCache", "getPipeline", "Pipeline needs vertex shader, pixel shader and input layout");
+    return kNoPipeline;
+  }
+  ++m_stats.stateRequests;
+
+  PipelineStateDesc complete = desc;
+  if (!complete.blendState) complete.blendState = m_defaultBlend;
+  if (!complete.rasterizerState) complete.rasterizerState = m_defaultRasterizer;
+  if (!complete.depthStencilState) complete.depthStencilState = m_defaultDepthStencil;
+
+  const uint64_t hash = hashPipeline(complete);
+  auto range = m_pipelineLookup.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (samePipeline(m_pipelines[it->second], complete)) {
+      ++m_stats.stateHits;
+      return it->second;
+    }
+  }
+
+  // El pipeline retiene sus objetos: un ShaderProgram destruido (o recargado) no deja
+  // punteros colgando ni permite que otro objeto reutilice la misma direccin
+  complete.vertexShader->AddRef();
+  complete.pixelShader->AddRef();
+  complete.inputLayout->AddRef();
+  if (complete.blendState) complete.blendState->AddRef();
+  if (complete.rasterizerState) complete.rasterizerState->AddRef();
+  if (complete.depthStencilState) complete.depthStencilState->AddRef();
+
+  PipelineHandle handle = static_cast<PipelineHandle>(m_pipelines.size());
+  m_pipelines.push_back(complete);
+  m_pipelineLookup.insert(std::make_pair(hash, handle));
+  ++m_stats.pipelines;
+  return handle;
+}
+
+void
+PipelineStateCache::bind(DeviceContext& deviceContext, PipelineHandle handle) const {
+  if (handle == kNoPipeline || handle >= m_pipelines.size()) {
+    ERROR("PipelineStateCache", "bind", "Invalid pipeline handle");
+    return;
+  }
+  const PipelineStateDesc& desc = m_pipelines[handle];
+  deviceContext.VSSetShader(desc.vertexShader, nullptr, 0);
+  deviceContext.PSSetShader(desc.pixelShader, nullptr, 0);
+  deviceContext.IASetInputLayout(desc.inputLayout);
+  deviceContext.IASetPrimitiveTopology(desc.topology);
+  // Sin init() los estados quedan como estn (nullptr no se puede enlazar por el wrapper)
+  if (desc.rasterizerState) {
+    deviceContext.RSSetState(desc.rasterizerState);
+  }
+  if (desc.blendState) {
+    deviceContext.OMSetBlendState(desc.blendState, nullptr, 0xffffffff);
+  }
+  if (desc.depthStencilState) {
+    deviceContext.OMSetDepthStencilState(desc.depthStencilState, 0);
+  }
+}
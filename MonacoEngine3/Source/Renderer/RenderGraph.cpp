@@ -0,0 +1,673 @@
+#include "Renderer/RenderGraph.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include <algorithm>
+
+namespace {
+  // Bytes por pxel de los formatos que usa el motor (4 si no se conoce)
+  unsigned int
+  bytesPerPixel(DXGI_FORMAT format) {
+    switch (format) {
+    case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+    case DXGI_FORMAT_R32G32B32A32_UINT:
+      return 16;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R16G16B16A16_UNORM:
+    case DXGI_FORMAT_R32G32_FLOAT:
+    case DXGI_FORMAT_R32G32_UINT:
+    case DXGI_FORMAT_R32G8X24_TYPELESS:
+    case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+      return 8;
+    case DXGI_FORMAT_R16_TYPELESS:
+    case DXGI_FORMAT_R16_FLOAT:
+    case DXGI_FORMAT_R16_UNORM:
+    case DXGI_FORMAT_D16_UNORM:
+    case DXGI_FORMAT_R8G8_UNORM:
+      return 2;
+    case DXGI_FORMAT_R8_UNORM:
+      return 1;
+    default:
+      return 4;
+    }
+  }
+
+  // Profundidad que tambin se lee en shaders: textura typeless y un formato por vista
+  void
+  resolveDepthFormats(DXGI_FORMAT format,
+                      DXGI_FORMAT& textureFormat,
+                      DXGI_FORMAT& shaderFormat) {
+    switch (format) {
+    case DXGI_FORMAT_D24_UNORM_S8_UINT:
+      textureFormat = DXGI_FORMAT_R24G8_TYPELESS;
+      shaderFormat = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+      break;
+    case DXGI_FORMAT_D32_FLOAT:
+      textureFormat = DXGI_FORMAT_R32_TYPELESS;
+      shaderFormat = DXGI_FORMAT_R32_FLOAT;
+      break;
+    case DXGI_FORMAT_D16_UNORM:
+      textureFormat = DXGI_FORMAT_R16_TYPELESS;
+      shaderFormat = DXGI_FORMAT_R16_UNORM;
+      break;
+    case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+      textureFormat = DXGI_FORMAT_R32G8X24_TYPELESS;
+      shaderFormat = DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS;
+      break;
+    default:
+      textureFormat = format;
+      shaderFormat = format;
+      break;
+    }
+  }
+
+  void
+  addUnique(std::vector<RGHandle>& handles, RGHandle handle) {
+    if (std::find(handles.begin(), handles.end(), handle) == handles.end()) {
+      handles.push_back(handle);
+    }
+  }
+
+  // Cada textura que toca el pase, una sola vez aunque la lea y la escriba
+  template<typename Pass, typename Function>
+  void
+  forEachAccess(const Pass& pass, Function function) {
+    for (RGHandle handle : pass.reads) {
+      function(handle);
+    }
+    for (RGHandle handle : pass.writes) {
+      if (std::find(pass.reads.begin(), pass.reads.end(), handle) == pass.reads.end()) {
+        function(handle);
+      }
+    }
+  }
+}
+
+unsigned long long
+RGTextureDesc::getSizeInBytes() const {
+  return static_cast<unsigned long long>(width) * height * arraySize *
+         (sampleCount > 0 ? sampleCount : 1) * bytesPerPixel(format);
+}
+
+// ---------------------------------------------------------------------------------
+// RenderGraphBuilder
+// ---------------------------------------------------------------------------------
+
+RGHandle
+RenderGraphBuilder::create(const std::string& name, const RGTextureDesc& desc) {
+  RenderGraph::Resource resource;
+  resource.name = name;
+  resource.desc = desc;
+  RGHandle handle = static_cast<RGHandle>(m_graph.m_resources.size());
+  m_graph.m_resources.push_back(resource);
+  m_graph.m_passes[m_pass].creates.push_back(handle);
+  return write(handle);
+}
+
+RGHandle
+RenderGraphBuilder::read(RGHandle handle) {
+  if (handle >= m_graph.m_resources.size()) {
+    ERROR("RenderGraphBuilder", "read", ("Invalid handle in pass " + m_graph.m_passes[m_pass].name).c_str());
+    return kInvalidRGHandle;
+  }
+  addUnique(m_graph.m_passes[m_pass].reads, handle);
+  return handle;
+}
+
+RGHandle
+RenderGraphBuilder::write(RGHandle handle) {
+  if (handle >= m_graph.m_resources.size()) {
+    ERROR("RenderGraphBuilder", "write", ("Invalid handle in pass " + m_graph.m_passes[m_pass].name).c_str());
+    return kInvalidRGHandle;
+  }
+  addUnique(m_graph.m_passes[m_pass].writes, handle);
+  return handle;
+}
+
+void
+RenderGraphBuilder::setSideEffects() {
+  m_graph.m_passes[m_pass].sideEffects = true;
+}
+
+// ---------------------------------------------------------------------------------
+// RenderGraphResources
+// ---------------------------------------------------------------------------------
+
+ID3D11RenderTargetView*
+RenderGraphResources::getRenderTargetView(RGHandle handle, unsigned int slice) const {
+  if (handle >= m_graph.m_resources.size()) return nullptr;
+  const RenderGraph::Resource& resource = m_graph.m_resources[handle];
+  if (resource.imported) return resource.importedRTV;
+  const RenderGraph::PhysicalTexture* physical = m_graph.getPhysical(handle);
+  return physical && slice < physical->renderTargetViews.size() ? physical->renderTargetViews[slice] : nullptr;
+}
+
+ID3D11DepthStencilView*
+RenderGraphResources::getDepthStencilView(RGHandle handle, unsigned int slice) const {
+  if (handle >= m_graph.m_resources.size()) return nullptr;
+  const RenderGraph::Resource& resource = m_graph.m_resources[handle];
+  if (resource.imported) return resource.importedDSV;
+  const RenderGraph::PhysicalTexture* physical = m_graph.getPhysical(handle);
+  return physical && slice < physical->depthStencilViews.size() ? physical->depthStencilViews[slice] : nullptr;
+}
+
+ID3D11ShaderResourceView*
+RenderGraphResources::getShaderResourceView(RGHandle handle) const {
+  if (handle >= m_graph.m_resources.size()) return nullptr;
+  const RenderGraph::Resource& resource = m_graph.m_resources[handle];
+  if (resource.imported) return resource.importedSRV;
+  const RenderGraph::PhysicalTexture* physical = m_graph.getPhysical(handle);
+  return physical ? physical->shaderResourceView : nullptr;
+}
+
+ID3D11Texture2D*
+RenderGraphResources::getTexture(RGHandle handle) const {
+  if (handle >= m_graph.m_resources.size()) return nullptr;
+  if (m_graph.m_resources[handle].imported) return nullptr;
+  const RenderGraph::PhysicalTexture* physical = m_graph.getPhysical(handle);
+  return physical ? physical->texture : nullptr;
+}
+
+const RGTextureDesc&
+RenderGraphResources::getDesc(RGHandle handle) const {
+  static const RGTextureDesc empty;
+  return handle < m_graph.m_resources.size() ? m_graph.m_resources[handle].desc : empty;
+}
+
+// ---------------------------------------------------------------------------------
+// RenderGraph
+// ---------------------------------------------------------------------------------
+
+void
+RenderGraph::reset() {
+  m_passes.clear();
+  m_resources.clear();
+  m_order.clear();
+  m_slots.clear();
+  m_compiled = false;
+}
+
+void
+RenderGraph::destroy() {
+  reset();
+  for (PhysicalTexture& physical : m_pool) {
+    releasePhysicalTexture(physical);
+  }
+  m_pool.clear();
+  m_stats = RenderGraphStats();
+}
+
+RGHandle
+RenderGraph::importTexture(const std::string& name,
+                           const RGTextureDesc& desc,
+                           ID3D11RenderTargetView* renderTargetView,
+                           ID3D11DepthStencilView* depthStencilView,
+                           ID3D11ShaderResourceView* shaderResourceView) {
+  Resource resource;
+  resource.name = name;
+  resource.desc = desc;
+  resource.imported = true;
+  resource.importedRTV = renderTargetView;
+  resource.importedDSV = depthStencilView;
+  resource.importedSRV = shaderResourceView;
+  m_resources.push_back(resource);
+  m_compiled = false;
+  return static_cast<RGHandle>(m_resources.size() - 1);
+}
+
+void
+RenderGraph::addPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute) {
+  Pass pass;
+  pass.name = name;
+  pass.execute = execute;
+  m_passes.push_back(pass);
+  m_compiled = false;
+
+  RenderGraphBuilder builder(*this, static_cast<unsigned int>(m_passes.size() - 1));
+  if (setup) {
+    setup(builder);
+  }
+}
+
+bool
+RenderGraph::compile() {
+  PROFILE_SCOPE("RenderGraph::compile");
+  m_order.clear();
+  m_slots.clear();
+  m_compiled = false;
+  for (Resource& resource : m_resources) {
+    resource.writers.clear();
+    resource.readers.clear();
+    resource.firstUse = -1;
+    resource.lastUse = -1;
+    resource.physical = -1;
+  }
+  for (unsigned int i = 0; i < m_passes.size(); ++i) {
+    for (RGHandle handle : m_passes[i].writes) m_resources[handle].writers.push_back(i);
+    for (RGHandle handle : m_passes[i].reads) m_resources[handle].readers.push_back(i);
+  }
+
+  cullPasses();
+  if (!sortPasses()) {
+    return false;
+  }
+
+  // Vida de cada textura en posiciones del orden de ejecucin
+  for (unsigned int position = 0; position < m_order.size(); ++position) {
+    forEachAccess(m_passes[m_order[position]], [&](RGHandle handle) {
+      Resource& resource = m_resources[handle];
+      if (resource.firstUse < 0) resource.firstUse = static_cast<int>(position);
+      resource.lastUse = static_cast<int>(position);
+    });
+  }
+  assignPhysicalTextures();
+
+  m_stats.passes = static_cast<unsigned int>(m_passes.size());
+  m_stats.passesCulled = static_cast<unsigned int>(m_passes.size() - m_order.size());
+  m_stats.transientTextures = 0;
+  m_stats.transientBytes = 0;
+  m_stats.physicalBytes = 0;
+  for (const Resource& resource : m_resources) {
+    if (!resource.imported && resource.physical >= 0) {
+      ++m_stats.transientTextures;
+      m_stats.transientBytes += resource.desc.getSizeInBytes();
+    }
+  }
+  for (const Slot& slot : m_slots) {
+    m_stats.physicalBytes += slot.desc.getSizeInBytes();
+  }
+  m_stats.physicalTextures = static_cast<unsigned int>(m_slots.size());
+  m_compiled = true;
+  return true;
+}
+
+void
+RenderGraph::cullPasses() {
+  // Conteo de referencias: un pase vive si alguien usa lo que escribe
+  std::vector<RGHandle> unused;
+  for (Pass& pass : m_passes) {
+    pass.culled = false;
+    pass.refCount = static_cast<unsigned int>(pass.writes.size());
+  }
+  for (RGHandle handle = 0; handle < m_resources.size(); ++handle) {
+    Resource& resource = m_resources[handle];
+    resource.refCount = resource.imported ? 1 : 0;
+    for (unsigned int reader : resource.readers) {
+      // Leer lo que uno mismo escribe no mantiene vivo al pase
+      const std::vector<RGHandle>& writes = m_passes[reader].writes;
+      if (std::find(writes.begin(), writes.end(), handle) == writes.end()) {
+        ++resource.refCount;
+      }
+    }
+    if (resource.refCount == 0) {
+      unused.push_back(handle);
+    }
+  }
+
+  auto cull = [&](Pass& pass) {
+    pass.culled = true;
+    for (RGHandle read : pass.reads) {
+      Resource& resource = m_resources[read];
+      if (resource.refCount > 0 && --resource.refCount == 0) {
+        unused.push_back(read);
+      }
+    }
+  };
+
+  for (Pass& pass : m_passes) {
+    if (pass.writes.empty() && !pass.sideEffects) {
+      cull(pass);
+    }
+  }
+  while (!unused.empty()) {
+    RGHandle handle = unused.back();
+    unused.pop_back();
+    for (unsigned int writer : m_resources[handle].writers) {
+      Pass& pass = m_passes[writer];
+      if (pass.culled || pass.refCount == 0) continue;
+      if (--pass.refCount == 0 && !pass.sideEffects) {
+        cull(pass);
+      }
+    }
+  }
+}
+
+bool
+RenderGraph::sortPasses() {
+  const unsigned int passCount = static_cast<unsigned int>(m_passes.size());
+  std::vector<std::vector<unsigned int>> successors(passCount);
+  std::vector<unsigned int> inDegree(passCount, 0);
+  auto addEdge = [&](unsigned int from, unsigned int to) {
+    if (from == to) return;
+    std::vector<unsigned int>& edges = successors[from];
+    if (std::find(edges.begin(), edges.end(), to) == edges.end()) {
+      edges.push_back(to);
+      ++inDegree[to];
+    }
+  };
+
+  // Dependencias en orden de declaracin: RAW, WAW y WAR por textura
+  std::vector<int> lastWriter(m_resources.size(), -1);
+  std::vector<std::vector<unsigned int>> readersSinceWrite(m_resources.size());
+  int lastSideEffect = -1;
+  for (unsigned int i = 0; i < passCount; ++i) {
+    const Pass& pass = m_passes[i];
+    if (pass.culled) continue;
+    for (RGHandle handle : pass.reads) {
+      if (lastWriter[handle] < 0 && !m_resources[handle].imported) {
+        ERROR("RenderGraph", "compile",
+          ("Pass " + pass.name + " reads " + m_resources[handle].name + " before any pass writes it").c_str());
+        return false;
+      }
+      if (lastWriter[handle] >= 0) addEdge(lastWriter[handle], i);
+      readersSinceWrite[handle].push_back(i);
+    }
+    for (RGHandle handle : pass.writes) {
+      if (lastWriter[handle] >= 0) addEdge(lastWriter[handle], i);
+      for (unsigned int reader : readersSinceWrite[handle]) addEdge(reader, i);
+      readersSinceWrite[handle].clear();
+      lastWriter[handle] = static_cast<int>(i);
+    }
+    // Lo que se ve fuera del grafo (GUI, present) mantiene su orden relativo
+    if (pass.sideEffects) {
+      if (lastSideEffect >= 0) addEdge(lastSideEffect, i);
+      lastSideEffect = static_cast<int>(i);
+    }
+  }
+
+  // Accesos pendientes por textura, para saber qu pase cierra su vida
+  std::vector<unsigned int> pendingUses(m_resources.size(), 0);
+  std::vector<unsigned int> ready;
+  unsigned int livePasses = 0;
+  for (unsigned int i = 0; i < passCount; ++i) {
+    if (m_passes[i].culled) continue;
+    ++livePasses;
+    forEachAccess(m_passes[i], [&](RGHandle handle) { ++pendingUses[handle]; });
+    if (inDegree[i] == 0) ready.push_back(i);
+  }
+
+  // Kahn: entre los pases listos, el que menos memoria transitoria deja viva
+  while (!ready.empty()) {
+    size_t best = 0;
+    long long bestScore = 0;
+    for (size_t r = 0; r < ready.size(); ++r) {
+      const Pass& pass = m_passes[ready[r]];
+      long long score = 0;
+      for (RGHandle handle : pass.creates) {
+        score += static_cast<long long>(m_resources[handle].desc.getSizeInBytes());
+      }
+      forEachAccess(pass, [&](RGHandle handle) {
+        const Resource& resource = m_resources[handle];
+        if (!resource.imported && pendingUses[handle] == 1) {
+          score -= static_cast<long long>(resource.desc.getSizeInBytes());
+        }
+      });
+      if (r == 0 || score < bestScore || (score == bestScore && ready[r] < ready[best])) {
+        best = r;
+        bestScore = score;
+      }
+    }
+
+    unsigned int index = ready[best];
+    ready.erase(ready.begin() + best);
+    m_order.push_back(index);
+    const Pass& pass = m_passes[index];
+    forEachAccess(pass, [&](RGHandle handle) { --pendingUses[handle]; });
+    for (unsigned int next : successors[index]) {
+      if (--inDegree[next] == 0) ready.push_back(next);
+    }
+  }
+
+  if (m_order.size() != livePasses) {
+    ERROR("RenderGraph", "compile", "Render graph has a dependency cycle.");
+    m_order.clear();
+    return false;
+  }
+  return true;
+}
+
+void
+RenderGraph::assignPhysicalTextures() {
+  std::vector<RGHandle> transients;
+  for (RGHandle handle = 0; handle < m_resources.size(); ++handle) {
+    const Resource& resource = m_resources[handle];
+    if (!resource.imported && resource.firstUse >= 0) {
+      transients.push_back(handle);
+    }
+  }
+  std::sort(transients.begin(), transients.end(), [this](RGHandle a, RGHandle b) {
+    return m_resources[a].firstUse != m_resources[b].firstUse ?
+           m_resources[a].firstUse < m_resources[b].firstUse : a < b;
+  });
+
+  // Primer ajuste: una textura fsica se reutiliza si su ltimo uso ya pas
+  for (RGHandle handle : transients) {
+    Resource& resource = m_resources[handle];
+    int chosen = -1;
+    for (unsigned int s = 0; s < m_slots.size(); ++s) {
+      if (m_slots[s].desc == resource.desc && m_slots[s].lastUse < resource.firstUse) {
+        chosen = static_cast<int>(s);
+        break;
+      }
+    }
+    if (chosen < 0) {
+      Slot slot;
+      slot.desc = resource.desc;
+      m_slots.push_back(slot);
+      chosen = static_cast<int>(m_slots.size() - 1);
+    }
+    m_slots[chosen].lastUse = resource.lastUse;
+    resource.physical = chosen;
+  }
+}
+
+HRESULT
+RenderGraph::execute(Device& device, DeviceContext& deviceContext) {
+  if (!m_compiled) {
+    ERROR("RenderGraph", "execute", "Render graph must be compiled before execution.");
+    return E_FAIL;
+  }
+  ++m_frame;
+
+  // Lo que lleva demasiado sin usarse se libera antes de repartir
+  for (size_t i = m_pool.size(); i-- > 0;) {
+    if (m_frame - m_pool[i].lastFrameUsed > kPoolFrames) {
+      releasePhysicalTexture(m_pool[i]);
+      m_pool.erase(m_pool.begin() + i);
+    }
+  }
+  for (PhysicalTexture& physical : m_pool) {
+    physical.taken = false;
+  }
+
+  for (Slot& slot : m_slots) {
+    slot.poolIndex = -1;
+    for (unsigned int p = 0; p < m_pool.size(); ++p) {
+      if (!m_pool[p].taken && m_pool[p].desc == slot.desc) {
+        slot.poolIndex = static_cast<int>(p);
+        break;
+      }
+    }
+    if (slot.poolIndex < 0) {
+      PhysicalTexture physical;
+      physical.desc = slot.desc;
+      HRESULT hr = createPhysicalTexture(device, physical);
+      if (FAILED(hr)) {
+        releasePhysicalTexture(physical);
+        return hr;
+      }
+      m_pool.push_back(physical);
+      slot.poolIndex = static_cast<int>(m_pool.size() - 1);
+      ++m_stats.texturesCreated;
+    }
+    m_pool[slot.poolIndex].taken = true;
+    m_pool[slot.poolIndex].lastFrameUsed = m_frame;
+  }
+
+  RenderGraphResources resources(*this);
+  for (unsigned int index : m_order) {
+    if (m_passes[index].execute) {
+#if MONACO_PROFILING
+      // Cada pase es un scope de CPU y otro de GPU con su nombre
+      const char* passName = Profiler::getInstance().internName(m_passes[index].name);
+      PROFILE_SCOPE(passName);
+      PROFILE_GPU_SCOPE(deviceContext, passName);
+#endif
+      m_passes[index].execute(deviceContext, resources);
+    }
+  }
+  return S_OK;
+}
+
+HRESULT
+RenderGraph::createPhysicalTexture(Device& device, PhysicalTexture& physical) {
+  const RGTextureDesc& desc = physical.desc;
+  const bool depth = (desc.bindFlags & D3D11_BIND_DEPTH_STENCIL) != 0;
+  const bool multisampled = desc.sampleCount > 1;
+  const bool array = desc.arraySize > 1;
+
+  DXGI_FORMAT textureFormat = desc.format;
+  DXGI_FORMAT shaderFormat = desc.format;
+  if (depth && (desc.bindFlags & D3D11_BIND_SHADER_RESOURCE)) {
+    resolveDepthFormats(desc.format, textureFormat, shaderFormat);
+  }
+
+  D3D11_TEXTURE2D_DESC textureDesc = {};
+  textureDesc.Width = desc.width;
+  textureDesc.Height = desc.height;
+  textureDesc.MipLevels = 1;
+  textureDesc.ArraySize = desc.arraySize;
+  textureDesc.Format = textureFormat;
+  textureDesc.SampleDesc.Count = desc.sampleCount;
+  textureDesc.SampleDesc.Quality = desc.sampleQuality;
+  textureDesc.Usage = D3D11_USAGE_DEFAULT;
+  textureDesc.BindFlags = desc.bindFlags;
+  HRESULT hr = device.CreateTexture2D(&textureDesc, nullptr, &physical.texture);
+  if (FAILED(hr)) {
+    ERROR("RenderGraph", "createPhysicalTexture", ("Failed to create texture. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
+  }
+
+  // Una RTV/DSV por capa: los pases de cascadas o caras escriben capa a capa
+  for (unsigned int slice = 0; slice < desc.arraySize; ++slice) {
+    if (desc.bindFlags & D3D11_BIND_RENDER_TARGET) {
+      D3D11_RENDER_TARGET_VIEW_DESC rtvDesc = {};
+      rtvDesc.Format = desc.format;
+      if (multisampled && array) {
+        rtvDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DMSARRAY;
+        rtvDesc.Texture2DMSArray.FirstArraySlice = slice;
+        rtvDesc.Texture2DMSArray.ArraySize = 1;
+      }
+      else if (multisampled) {
+        rtvDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DMS;
+      }
+      else if (array) {
+        rtvDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
+        rtvDesc.Texture2DArray.FirstArraySlice = slice;
+        rtvDesc.Texture2DArray.ArraySize = 1;
+      }
+      else {
+        rtvDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+      }
+      ID3D11RenderTargetView* view = nullptr;
+      hr = device.CreateRenderTargetView(physical.texture, &rtvDesc, &view);
+      if (FAILED(hr)) {
+        ERROR("RenderGraph", "createPhysicalTexture", "Failed to create render target view.");
+        return hr;
+      }
+      physical.renderTargetViews.push_back(view);
+    }
+    if (depth) {
+      D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+      dsvDesc.Format = desc.format;
+      if (multisampled && array) {
+        dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DMSARRAY;
+        dsvDesc.Texture2DMSArray.FirstArraySlice = slice;
+        dsvDesc.Texture2DMSArray.ArraySize = 1;
+      }
+      else if (multisampled) {
+        dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DMS;
+      }
+      else if (array) {
+        dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DARRAY;
+        dsvDesc.Texture2DArray.FirstArraySlice = slice;
+        dsvDesc.Texture2DArray.ArraySize = 1;
+      }
+      else {
+        dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+      }
+      ID3D11DepthStencilView* view = nullptr;
+      hr = device.CreateDepthStencilView(physical.texture, &dsvDesc, &view);
+      if (FAILED(hr)) {
+        ERROR("RenderGraph", "createPhysicalTexture", "Failed to create depth stencil view.");
+        return hr;
+      }
+      physical.depthStencilViews.push_back(view);
+    }
+  }
+
+  if (desc.bindFlags & D3D11_BIND_SHADER_RESOURCE) {
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = shaderFormat;
+    if (multisampled && array) {
+      srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DMSARRAY;
+      srvDesc.Texture2DMSArray.ArraySize = desc.arraySize;
+    }
+    else if (multisampled) {
+      srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DMS;
+    }
+    else if (array) {
+      srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+      srvDesc.Texture2DArray.MipLevels = 1;
+      srvDesc.Texture2DArray.ArraySize = desc.arraySize;
+    }
+    else {
+      srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+      srvDesc.Texture2D.MipLevels = 1;
+    }
+    hr = device.CreateShaderResourceView(physical.texture, &srvDesc, &physical.shaderResourceView);
+    if (FAILED(hr)) {
+      ERROR("RenderGraph", "createPhysicalTexture", "Failed to create shader resource view.");
+      return hr;
+    }
+  }
+  return S_OK;
+}
+
+void
+RenderGraph::releasePhysicalTexture(PhysicalTexture& physical) {
+  for (ID3D11RenderTargetView*& view : physical.renderTargetViews) {
+    SAFE_RELEASE(view);
+  }
+  for (ID3D11DepthStencilView*& view : physical.depthStencilViews) {
+    SAFE_RELEASE(view);
+  }
+  physical.renderTargetViews.clear();
+  physical.depthStencilViews.clear();
+  SAFE_RELEASE(physical.shaderResourceView);
+  SAFE_RELEASE(physical.texture);
+}
+
+const RenderGraph::PhysicalTexture*
+RenderGraph::getPhysical(RGHandle handle) const {
+  int slot = m_resources[handle].physical;
+  if (slot < 0 || m_slots[slot].poolIndex < 0) {
+    return nullptr;
+  }
+  return &m_pool[m_slots[slot].poolIndex];
+}
+
+std::vector<std::string>
+RenderGraph::getExecutionOrder() const {
+  std::vector<std::string> names;
+  for (unsigned int index : m_order) {
+    names.push_back(m_passes[index].name);
+  }
+  return names;
+}
+
+int
+RenderGraph::getPhysicalIndex(RGHandle handle) const {
+  return handle < m_resources.size() ? m_resources[handle].physical : -1;
+}
@@ -0,0 +1,471 @@
+#include "Renderer/RenderQueue.h"
+#include "Renderer/ParallelCommandRecorder.h"
+#include "DeviceContext.h"
+#include "Device.h"
+#include "ShaderProgram.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+
+namespace {
+  const unsigned int kPipelineBits = 8;
+  const unsigned int kMaterialBits = 16;
+  const unsigned int kMeshBits = 12;
+  const unsigned int kDepthBits = 24;
+  const unsigned int kDepthMax = (1u << kDepthBits) - 1;
+  // Frames sin enviarse tras los que un puntero deja de tener ID
+  const unsigned long long kInternMaxAge = 300;
+}
+
+HRESULT
+RenderQueue::init(Device& device, unsigned int maxInstances) {
+  HRESULT hr = m_instanceBuffer.initDynamic(device, sizeof(InstanceData), maxInstances);
+  if (FAILED(hr)) {
+    ERROR("RenderQueue", "init",
+      ("Failed to create instance buffer. HRESULT: " + std::to_string(hr)).c_str());
+    m_maxInstances = 0;
+    return hr;
+  }
+  m_maxInstances = maxInstances;
+  return S_OK;
+}
+
+void
+RenderQueue::destroy() {
+  m_instanceBuffer.destroy();
+  m_maxInstances = 0;
+  m_packets.clear();
+  m_order.clear();
+  m_batches.clear();
+  clearInternTables();
+}
+
+void
+RenderQueue::clearInternTables() {
+  m_materialIds = InternTable();
+  m_meshIds = InternTable();
+}
+
+void
+RenderQueue::setDefaultShader(ShaderProgram& shader, const PipelineStateDesc& states) {
+  PipelineStateDesc desc = states;
+  desc.vertexShader = shader.m_VertexShader;
+  desc.pixelShader = shader.m_PixelShader;
+  desc.inputLayout = shader.m_inputLayout.m_inputLayout;
+  m_defaultPipeline = PipelineStateCache::getInstance().getPipeline(desc);
+}
+
+void
+RenderQueue::setInstancedShader(ShaderProgram& shader, const PipelineStateDesc& states) {
+  PipelineStateDesc desc = states;
+  desc.vertexShader = shader.m_VertexShader;
+  desc.pixelShader = shader.m_PixelShader;
+  desc.inputLayout = shader.m_inputLayout.m_inputLayout;
+  m_instancedPipeline = PipelineStateCache::getInstance().getPipeline(desc);
+}
+
+void
+RenderQueue::begin(const XMMATRIX& view, float nearZ, float farZ) {
+  m_packets.clear();
+  m_order.clear();
+  ++m_frameIndex;
+  if (m_frameIndex % kInternMaxAge == 0) {
+    pruneInternTable(m_materialIds, kInternMaxAge);
+    pruneInternTable(m_meshIds, kInternMaxAge);
+  }
+  m_view = view;
+  m_nearZ = nearZ;
+  m_farZ = farZ > nearZ ? farZ : nearZ + 1.0f;
+}
+
+float
+RenderQueue::computeViewDepth(const XMMATRIX& world) const {
+  XMVECTOR origin = XMVector3TransformCoord(XMVectorZero(), world * m_view);
+  float depth = (XMVectorGetZ(origin) - m_nearZ) / (m_farZ - m_nearZ);
+  if (depth < 0.0f) return 0.0f;
+  if (depth > 1.0f) return 1.0f;
+  return depth;
+}
+
+void
+RenderQueue::submit(const DrawPacket& packet) {
+  DrawPacket entry = packet;
+  if (entry.pipeline == kNoPipeline) {
+    if (!entry.vertexShader && !entry.pixelShader) {
+      entry.pipeline = m_defaultPipeline;
+    }
+    else {
+      // Paquetes con shaders propios: el pipeline se registra una vez y luego se reutiliza
+      const PipelineStateDesc& defaults = PipelineStateCache::getInstance().getDesc(m_defaultPipeline);
+      PipelineStateDesc desc;
+      desc.vertexShader = entry.vertexShader ? entry.vertexShader : defaults.vertexShader;
+      desc.pixelShader = entry.pixelShader ? entry.pixelShader : defaults.pixelShader;
+      desc.inputLayout = entry.inputLayout ? entry.inputLayout : defaults.inputLayout;
+      desc.topology = entry.topology;
+      entry.pipeline = PipelineStateCache::getInstance().getPipeline(desc);
+    }
+  }
+  if (entry.pipeline == kNoPipeline) {
+    ERROR("RenderQueue", "submit", "Packet has no pipeline, dropped");
+    return;
+  }
+  entry.sortKey = buildKey(entry);
+
+  SortEntry sortEntry = { entry.sortKey, static_cast<unsigned int>(m_packets.size()) };
+  m_order.push_back(sortEntry);
+  m_packets.push_back(entry);
+}
+
+unsigned int
+RenderQueue::intern(InternTable& table,
+                    const void* object,
+                    unsigned int bits,
+                    const char* name) {
+  auto it = table.entries.find(object);
+  if (it != table.entries.end()) {
+    it->second.lastFrame = m_frameIndex;
+    return it->second.id;
+  }
+
+  unsigned int id = 0;
+  if (!table.freeIds.empty()) {
+    id = table.freeIds.back();
+    table.freeIds.pop_back();
+  }
+  else {
+    const unsigned int mask = (1u << bits) - 1;
+    if (table.nextId > mask && !table.wrapReported) {
+      ERROR("RenderQueue", "intern",
+        (std::string(name) + " IDs exhausted (more than " + std::to_string(mask + 1) +
+         " live), sort keys will alias").c_str());
+      table.wrapReported = true;
+    }
+    id = table.nextId++ & mask;
+  }
+  table.entries.emplace(object, InternEntry{ id, m_frameIndex });
+  return id;
+}
+
+void
+RenderQueue::pruneInternTable(InternTable& table, unsigned long long maxAge) {
+  for (auto it = table.entries.begin(); it != table.entries.end();) {
+    if (m_frameIndex - it->second.lastFrame > maxAge) {
+      table.freeIds.push_back(it->second.id);
+      it = table.entries.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+  // Sin entradas vivas se puede volver a numerar desde cero
+  if (table.entries.empty()) {
+    table = InternTable();
+  }
+}
+
+unsigned long long
+RenderQueue::buildKey(const DrawPacket& packet) {
+  unsigned long long pass = static_cast<unsigned long long>(packet.pass) & 0xF;
+  unsigned long long pipeline = packet.pipeline & ((1u << kPipelineBits) - 1);
+  unsigned long long material = intern(m_materialIds, packet.texture, kMaterialBits, "Material");
+  // Las mallas de un MeshPool comparten buffer: el tramo tambin distingue la malla.
+  // Una colisin slo empeora el agrupado; canBatch compara los campos reales.
+  const void* meshKey = reinterpret_cast<const void*>(
+    reinterpret_cast<uintptr_t>(packet.vertexBuffer) ^
+    (static_cast<uintptr_t>(packet.startIndex) * 0x9E3779B1u) ^
+    (static_cast<uintptr_t>(static_cast<unsigned int>(packet.baseVertex)) << 1));
+  unsigned long long mesh = intern(m_meshIds, meshKey, kMeshBits, "Mesh");
+  unsigned long long depth = static_cast<unsigned long long>(packet.viewDepth * kDepthMax);
+
+  if (packet.pass == RenderPass::Transparent) {
+    // Fondo a frente: la profundidad invertida manda sobre el estado
+    return (pass << 60) |
+           ((kDepthMax - depth) << 36) |
+           (pipeline << 28) |
+           (material << 12) |
+           mesh;
+  }
+  return (pass << 60) |
+         (pipeline << 52) |
+         (material << 36) |
+         (mesh << 24) |
+         depth;
+}
+
+void
+RenderQueue::sort() {
+  PROFILE_SCOPE("RenderQueue::sort");
+  const size_t count = m_order.size();
+  if (count < 2) {
+    return;
+  }
+  m_scratch.resize(count);
+
+  SortEntry* src = m_order.data();
+  SortEntry* dst = m_scratch.data();
+  for (unsigned int shift = 0; shift < 64; shift += 8) {
+    unsigned int histogram[256] = {};
+    for (size_t i = 0; i < count; ++i) {
+      ++histogram[(src[i].key >> shift) & 0xFF];
+    }
+    // Si todas las claves comparten este byte la pasada no cambia nada
+    if (histogram[(src[0].key >> shift) & 0xFF] == count) {
+      continue;
+    }
+
+    unsigned int offset = 0;
+    for (unsigned int bucket = 0; bucket < 256; ++bucket) {
+      unsigned int n = histogram[bucket];
+      histogram[bucket] = offset;
+      offset += n;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+    }
+    std::swap(src, dst);
+  }
+
+  if (src != m_order.data()) {
+    m_order.swap(m_scratch);
+  }
+}
+
+bool
+RenderQueue::canBatch(const DrawPacket& a, const DrawPacket& b) {
+  return a.instanceable && b.instanceable &&
+         a.pass == RenderPass::Opaque && b.pass == RenderPass::Opaque &&
+         a.pipeline == b.pipeline &&
+         a.texture == b.texture &&
+         a.sampler == b.sampler &&
+         a.vertexBuffer == b.vertexBuffer &&
+         a.vertexStride == b.vertexStride &&
+         a.indexBuffer == b.indexBuffer &&
+         a.indexFormat == b.indexFormat &&
+         a.indexCount == b.indexCount &&
+         a.startIndex == b.startIndex &&
+         a.baseVertex == b.baseVertex;
+}
+
+void
+RenderQueue::bindState(DeviceContext& deviceContext,
+                       BindCache& cache,
+                       RenderQueueStats& stats,
+                       const DrawPacket& packet,
+                       bool instanced,
+                       const ConstantBufferAllocation& objectConstants) const {
+  const PipelineHandle pipeline = instanced ? m_instancedPipeline : packet.pipeline;
+  const bool first = !cache.valid;
+
+  // Shaders, layout, topologa y estados fijos: un solo entero decide si hay cambio
+  if (first || cache.pipeline != pipeline) {
+    PipelineStateCache::getInstance().bind(deviceContext, pipeline);
+    cache.pipeline = pipeline;
+    ++stats.bindsIssued;
+  }
+  if (first || cache.bound.vertexBuffer != packet.vertexBuffer ||
+      cache.bound.vertexStride != packet.vertexStride) {
+    unsigned int offset = 0;
+    deviceContext.IASetVertexBuffers(0, 1, &packet.vertexBuffer, &packet.vertexStride, &offset);
+    cache.bound.vertexBuffer = packet.vertexBuffer;
+    cache.bound.vertexStride = packet.vertexStride;
+    ++stats.bindsIssued;
+  }
+  if (first || cache.bound.indexBuffer != packet.indexBuffer ||
+      cache.bound.indexFormat != packet.indexFormat) {
+    deviceContext.IASetIndexBuffer(packet.indexBuffer, packet.indexFormat, 0);
+    cache.bound.indexBuffer = packet.indexBuffer;
+    cache.bound.indexFormat = packet.indexFormat;
+    ++stats.bindsIssued;
+  }
+  if (instanced) {
+    // Una sola vez por frame: cada grupo elige su rango con StartInstanceLocation
+    if (!cache.instanceBufferBound) {
+      ID3D11Buffer* instanceBuffer = m_instanceBuffer.getBuffer();
+      unsigned int stride = m_instanceBuffer.getStride();
+      unsigned int offset = 0;
+      deviceContext.IASetVertexBuffers(1, 1, &instanceBuffer, &stride, &offset);
+      cache.instanceBufferBound = true;
+      ++stats.bindsIssued;
+    }
+  }
+  else if (objectConstants.isValid() &&
+           (first || cache.bound.objectSlot != packet.objectSlot ||
+            cache.constants.buffer != objectConstants.buffer ||
+            cache.constants.firstConstant != objectConstants.firstConstant ||
+            cache.constants.numConstants != objectConstants.numConstants)) {
+    ConstantBufferRing::bind(deviceContext, packet.objectSlot, objectConstants, true);
+    cache.constants = objectConstants;
+    cache.bound.objectSlot = packet.objectSlot;
+    stats.bindsIssued += 2;
+  }
+  // Un paquete sin textura o sampler conserva los del anterior, igual que antes
+  if (packet.texture && cache.bound.texture != packet.texture) {
+    deviceContext.PSSetShaderResources(0, 1, &packet.texture);
+    cache.bound.texture = packet.texture;
+    ++stats.bindsIssued;
+  }
+  if (packet.sampler && cache.bound.sampler != packet.sampler) {
+    deviceContext.PSSetSamplers(0, 1, &packet.sampler);
+    cache.bound.sampler = packet.sampler;
+    ++stats.bindsIssued;
+  }
+  cache.valid = true;
+}
+
+void
+RenderQueue::prepare(DeviceContext& deviceContext) {
+  m_stats = RenderQueueStats();
+  m_stats.packets = static_cast<unsigned int>(m_packets.size());
+  m_batches.clear();
+  if (m_packets.empty()) {
+    return;
+  }
+
+  // 1) Planificar: series consecutivas agrupables (el orden ya las dej juntas)
+  const bool canInstance = m_instancedPipeline != kNoPipeline &&
+                           m_instanceBuffer.getBuffer() && m_maxInstances > 1;
+  const unsigned int count = static_cast<unsigned int>(m_order.size());
+  unsigned int instancesUsed = 0;
+  for (unsigned int i = 0; i < count;) {
+    unsigned int run = 1;
+    if (canInstance) {
+      const DrawPacket& head = m_packets[m_order[i].index];
+      while (i + run < count && canBatch(head, m_packets[m_order[i + run].index])) {
+        ++run;
+      }
+      if (run > m_maxInstances - instancesUsed) {
+        run = m_maxInstances - instancesUsed;
+      }
+    }
+
+    Batch batch = { i, 1, 0, false, ConstantBufferAllocation() };
+    if (run >= 2) {
+      batch.count = run;
+      batch.firstInstance = instancesUsed;
+      batch.instanced = true;
+      instancesUsed += run;
+    }
+    m_batches.push_back(batch);
+    i += batch.count;
+  }
+
+  // 2) Subir los datos por instancia de todo el frame con un solo Map
+  if (instancesUsed > 0) {
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    HRESULT hr = deviceContext.Map(m_instanceBuffer.getBuffer(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    if (SUCCEEDED(hr)) {
+      InstanceData* instances = static_cast<InstanceData*>(mapped.pData);
+      for (const Batch& batch : m_batches) {
+        if (!batch.instanced) continue;
+        for (unsigned int k = 0; k < batch.count; ++k) {
+          const DrawPacket& packet = m_packets[m_order[batch.begin + k].index];
+          instances[batch.firstInstance + k].mWorld = packet.world;
+          instances[batch.firstInstance + k].vMeshColor = packet.color;
+        }
+      }
+      deviceContext.Unmap(m_instanceBuffer.getBuffer(), 0);
+      m_stats.bytesMapped += instancesUsed * static_cast<unsigned int>(sizeof(InstanceData));
+    }
+    else {
+      ERROR("RenderQueue", "prepare", "Failed to map instance buffer, drawing packets individually");
+      for (size_t b = 0; b < m_batches.size(); ++b) {
+        if (!m_batches[b].instanced) continue;
+        // Partir la serie en paquetes sueltos
+        Batch whole = m_batches[b];
+        m_batches[b] = { whole.begin, 1, 0, false, ConstantBufferAllocation() };
+        for (unsigned int k = 1; k < whole.count; ++k) {
+          m_batches.insert(m_batches.begin() + b + k,
+                           { whole.begin + k, 1, 0, false, ConstantBufferAllocation() });
+        }
+        b += whole.count - 1;
+      }
+    }
+  }
+
+  // 3) Constantes por objeto de los paquetes sueltos
+  for (Batch& batch : m_batches) {
+    if (batch.instanced) continue;
+    const DrawPacket& packet = m_packets[m_order[batch.begin].index];
+    if (packet.objectData && m_constantRing) {
+      batch.objectConstants = m_constantRing->upload(deviceContext, packet.objectData, packet.objectDataSize);
+      m_stats.bytesMapped += packet.objectDataSize;
+    }
+    else if (packet.objectData && packet.objectBuffer) {
+      deviceContext.UpdateSubresource(packet.objectBuffer, 0, nullptr, packet.objectData, 0, 0);
+      batch.objectConstants.buffer = packet.objectBuffer;
+    }
+    else {
+      batch.objectConstants.buffer = packet.objectBuffer;
+    }
+  }
+}
+
+void
+RenderQueue::recordBatches(DeviceContext& deviceContext,
+                           unsigned int begin,
+                           unsigned int end,
+                           BindCache& cache,
+                           RenderQueueStats& stats) const {
+  for (unsigned int b = begin; b < end; ++b) {
+    const Batch& batch = m_batches[b];
+    const DrawPacket& packet = m_packets[m_order[batch.begin].index];
+
+    for (unsigned int k = 0; k < batch.count; ++k) {
+      const DrawPacket& member = m_packets[m_order[batch.begin + k].index];
+      stats.bindsRequested += 8;
+      if (member.texture) ++stats.bindsRequested;
+      if (member.sampler) ++stats.bindsRequested;
+    }
+
+    bindState(deviceContext, cache, stats, packet, batch.instanced, batch.objectConstants);
+
+    if (batch.instanced) {
+      deviceContext.DrawIndexedInstanced(packet.indexCount,
+                                         batch.count,
+                                         packet.startIndex,
+                                         packet.baseVertex,
+                                         batch.firstInstance);
+      ++stats.instancedDraws;
+      stats.instancesBatched += batch.count;
+    }
+    else {
+      deviceContext.DrawIndexed(packet.indexCount, packet.startIndex, packet.baseVertex);
+    }
+    ++stats.drawCalls;
+  }
+}
+
+void
+RenderQueue::execute(DeviceContext& deviceContext) {
+  prepare(deviceContext);
+  BindCache cache;
+  recordBatches(deviceContext, 0, static_cast<unsigned int>(m_batches.size()), cache, m_stats);
+}
+
+void
+RenderQueue::executeParallel(DeviceContext& immediate,
+                             ParallelCommandRecorder& recorder,
+                             const std::function<void(DeviceContext&)>& setupState) {
+  PROFILE_SCOPE("RenderQueue::executeParallel");
+  prepare(immediate);
+  if (m_batches.empty()) {
+    return;
+  }
+
+  // Cada rango cuenta por separado; sumar al final evita compartir contadores entre hilos
+  m_rangeStats.assign(recorder.getMaxRanges(), RenderQueueStats());
+  recorder.record(immediate,
+                  static_cast<unsigned int>(m_batches.size()),
+                  setupState,
+                  [this](DeviceContext& deviceContext, const WorkRange& range, unsigned int index) {
+    // Un contexto diferido empieza vaco: todo el estado de la cola hay que volver a enlazarlo
+    BindCache cache;
+    recordBatches(deviceContext, range.begin, range.end, cache, m_rangeStats[index]);
+  });
+
+  for (const RenderQueueStats& range : m_rangeStats) {
+    m_stats.drawCalls += range.drawCalls;
+    m_stats.instancedDraws += range.instancedDraws;
+    m_stats.instancesBatched += range.instancesBatched;
+    m_stats.bindsRequested += range.bindsRequested;
+    m_stats.bindsIssued += range.bindsIssued;
+  }
+}
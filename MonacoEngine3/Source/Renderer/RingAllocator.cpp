@@ -0,0 +1,74 @@
+#include "Renderer/RingAllocator.h"
+
+bool
+RingAllocator::init(unsigned long long capacity,
+                    unsigned long long alignment,
+                    unsigned int framesInFlight) {
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    return false;
+  }
+  m_alignment = alignment;
+  m_capacity = capacity & ~(alignment - 1);
+  m_framesInFlight = framesInFlight > 0 ? framesInFlight : 1;
+  m_highWater = 0;
+  reset();
+  return m_capacity > 0;
+}
+
+void
+RingAllocator::reset() {
+  m_head = 0;
+  m_used = 0;
+  m_frameBytes = 0;
+  m_wrapped = false;
+  m_frames.clear();
+}
+
+void
+RingAllocator::beginFrame() {
+  m_frames.push_back(m_frameBytes);
+  m_frameBytes = 0;
+
+  // El frame de hace N frames ya no lo lee la GPU
+  while (m_frames.size() > m_framesInFlight) {
+    m_used -= m_frames.front();
+    m_frames.erase(m_frames.begin());
+  }
+  if (m_used == 0) {
+    // Sin nada en vuelo conviene empezar desde el inicio y evitar relleno
+    m_head = 0;
+  }
+}
+
+unsigned long long
+RingAllocator::allocate(unsigned long long size) {
+  m_wrapped = false;
+  if (size == 0 || m_capacity == 0) {
+    return kInvalidOffset;
+  }
+
+  unsigned long long aligned = alignUp(size);
+  unsigned long long offset = m_head;
+  unsigned long long padding = 0;
+  if (offset + aligned > m_capacity) {
+    // No cabe al final: el resto del anillo se da por usado y se vuelve al inicio
+    padding = m_capacity - offset;
+    offset = 0;
+  }
+
+  if (padding + aligned > m_capacity - m_used) {
+    return kInvalidOffset;
+  }
+
+  m_wrapped = padding > 0;
+  m_head = offset + aligned;
+  if (m_head == m_capacity) {
+    m_head = 0;
+  }
+  m_used += padding + aligned;
+  m_frameBytes += padding + aligned;
+  if (m_used > m_highWater) {
+    m_highWater = m_used;
+  }
+  return offset;
+}
@@ -0,0 +1,279 @@
+#include "Renderer/ShaderCache.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+  const uint32_t kCacheMagic = 0x3143534D;  // "MSC1"
+  const uint32_t kCacheVersion = 1;
+
+  double
+  elapsedMs(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+  }
+
+  // La longitud delante evita que "ab"+"c" y "a"+"bc" den el mismo hash
+  uint64_t
+  hashString(const std::string& text, uint64_t seed) {
+    uint64_t hash = EU::hashValue(static_cast<uint64_t>(text.size()), seed);
+    return EU::fnv1a64(text.data(), text.size(), hash);
+  }
+
+  bool
+  readFile(const std::string& path, std::vector<char>& data) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+      return false;
+    }
+    std::streamoff size = file.tellg();
+    if (size < 0) {
+      return false;
+    }
+    data.resize(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    return size == 0 || file.read(data.data(), size).good();
+  }
+
+  std::string
+  directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+  }
+
+  // Nombres de las lneas "#include "x"" / "#include <x>" (sin mirar comentarios:
+  // un include de ms slo hace la clave ms estricta)
+  std::vector<std::string>
+  findIncludes(const std::vector<char>& source) {
+    std::vector<std::string> includes;
+    const char* it = source.data();
+    const char* end = it + source.size();
+    while (it < end) {
+      const char* lineEnd = static_cast<const char*>(memchr(it, '\n', end - it));
+      if (!lineEnd) {
+        lineEnd = end;
+      }
+      const char* c = it;
+      while (c < lineEnd && (*c == ' ' || *c == '\t')) ++c;
+      if (c < lineEnd && *c == '#') {
+        ++c;
+        while (c < lineEnd && (*c == ' ' || *c == '\t')) ++c;
+        if (lineEnd - c > 7 && strncmp(c, "include", 7) == 0) {
+          c += 7;
+          while (c < lineEnd && (*c == ' ' || *c == '\t')) ++c;
+          if (c < lineEnd && (*c == '"' || *c == '<')) {
+            char close = (*c == '"') ? '"' : '>';
+            const char* nameEnd = static_cast<const char*>(memchr(c + 1, close, lineEnd - c - 1));
+            if (nameEnd) {
+              includes.push_back(std::string(c + 1, nameEnd));
+            }
+          }
+        }
+      }
+      it = lineEnd + 1;
+    }
+    return includes;
+  }
+
+  template<typename T>
+  bool
+  readValue(const std::vector<char>& data, size_t& offset, T& value) {
+    if (data.size() - offset < sizeof(T)) {
+      return false;
+    }
+    memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+  }
+
+  template<typename T>
+  void
+  writeValue(std::vector<char>& data, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+  }
+}
+
+bool
+ShaderCache::init(IShaderCompiler& compiler, const std::string& path) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_compiler = &compiler;
+  m_path = path;
+  m_entries.clear();
+  m_dirty = false;
+  m_stats = ShaderCacheStats();
+
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<char> data;
+  if (!readFile(path, data)) {
+    // Primera ejecucin: no hay archivo todava
+    return true;
+  }
+  m_stats.bytesLoaded = data.size();
+  bool ok = parse(data);
+  m_stats.loadMs = elapsedMs(begin);
+  m_stats.entries = static_cast<unsigned int>(m_entries.size());
+  return ok;
+}
+
+bool
+ShaderCache::parse(const std::vector<char>& data) {
+  size_t offset = 0;
+  uint32_t magic = 0, version = 0, count = 0;
+  if (!readValue(data, offset, magic) || !readValue(data, offset, version) ||
+      !readValue(data, offset, count) || magic != kCacheMagic || version != kCacheVersion) {
+    // Otro formato: se recompila todo y se sobrescribe al guardar
+    m_dirty = true;
+    return false;
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    uint64_t key = 0;
+    uint32_t size = 0;
+    if (!readValue(data, offset, key) || !readValue(data, offset, size) ||
+        data.size() - offset < size) {
+      m_entries.clear();
+      m_dirty = true;
+      return false;
+    }
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data() + offset);
+    m_entries[key].assign(bytes, bytes + size);
+    offset += size;
+  }
+  return true;
+}
+
+bool
+ShaderCache::save() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_dirty || m_path.empty()) {
+    return true;
+  }
+
+  std::vector<char> data;
+  writeValue(data, kCacheMagic);
+  writeValue(data, kCacheVersion);
+  writeValue(data, static_cast<uint32_t>(m_entries.size()));
+  for (const auto& entry : m_entries) {
+    writeValue(data, entry.first);
+    writeValue(data, static_cast<uint32_t>(entry.second.size()));
+    data.insert(data.end(), entry.second.begin(), entry.second.end());
+  }
+
+  std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+  if (!file || !file.write(data.data(), data.size())) {
+    return false;
+  }
+  m_dirty = false;
+  return true;
+}
+
+void
+ShaderCache::destroy() {
+  save();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_compiler = nullptr;
+  m_stats.entries = 0;
+}
+
+bool
+ShaderCache::hashFile(const std::string& path,
+                      uint64_t& hash,
+                      std::unordered_set<std::string>& visited) const {
+  if (!visited.insert(path).second) {
+    return true;
+  }
+  std::vector<char> source;
+  if (!readFile(path, source)) {
+    // Include que no existe: cuenta su nombre, el compilador dar el error
+    hash = hashString(path, hash);
+    return false;
+  }
+  hash = hashString(path, hash);
+  hash = EU::hashValue(static_cast<uint64_t>(source.size()), hash);
+  hash = EU::fnv1a64(source.data(), source.size(), hash);
+
+  const std::string directory = directoryOf(path);
+  for (const std::string& include : findIncludes(source)) {
+    hashFile(directory + include, hash, visited);
+  }
+  return true;
+}
+
+bool
+ShaderCache::computeKey(const ShaderCompileRequest& request, uint64_t& key) const {
+  uint64_t hash = hashString(m_compiler ? m_compiler->getName() : "", EU::kFnvOffsetBasis);
+  std::unordered_set<std::string> visited;
+  if (!hashFile(request.fileName, hash, visited)) {
+    return false;
+  }
+  hash = hashString(request.entryPoint, hash);
+  hash = hashString(request.profile, hash);
+  hash = EU::hashValue(static_cast<uint64_t>(request.defines.size()), hash);
+  for (const ShaderDefine& define : request.defines) {
+    hash = hashString(define.name, hash);
+    hash = hashString(define.value, hash);
+  }
+  key = EU::hashValue(request.flags, hash);
+  return true;
+}
+
+bool
+ShaderCache::compile(const ShaderCompileRequest& request,
+                     std::vector<unsigned char>& bytecode,
+                     std::string& errors) {
+  if (!m_compiler) {
+    errors = "Shader cache has no compiler.";
+    return false;
+  }
+
+  uint64_t key = 0;
+  bool hasKey = computeKey(request, key);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = hasKey ? m_entries.find(key) : m_entries.end();
+    if (it != m_entries.end()) {
+      ++m_stats.hits;
+      bytecode = it->second;
+      return true;
+    }
+    ++m_stats.misses;
+  }
+
+  // Fuera del lock: otro hilo puede servir aciertos mientras ste compila
+  auto begin = std::chrono::steady_clock::now();
+  bool compiled = m_compiler->compile(request, bytecode, errors);
+  double compileMs = elapsedMs(begin);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_stats.compileMs += compileMs;
+  if (!compiled) {
+    ++m_stats.compileErrors;
+    return false;
+  }
+
+  if (hasKey) {
+    m_entries[key] = bytecode;
+    m_stats.entries = static_cast<unsigned int>(m_entries.size());
+    m_dirty = true;
+  }
+  return true;
+}
+
+ShaderCacheStats
+ShaderCache::getStats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+std::string
+ShaderCache::getReport() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::ostringstream report;
+  report << m_stats.hits << " hits, " << m_stats.misses << " misses, "
+         << m_stats.compileErrors << " errors, " << m_stats.entries << " entries ("
+         << m_stats.bytesLoaded << " bytes loaded in " << m_stats.loadMs << " ms, "
+         << m_stats.compileMs << " ms compiling)";
+  return report.str();
+}
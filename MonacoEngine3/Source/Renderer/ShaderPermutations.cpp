@@ -0,0 +1,190 @@
+#include "Renderer/ShaderPermutations.h"
+#include "Renderer/ShaderCache.h"
+#include "Renderer/D3DShaderCompiler.h"
+#include "Device.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include <chrono>
+
+HRESULT
+ShaderPermutations::init(Device& device,
+                         ShaderCache& cache,
+                         const std::string& fileName,
+                         const std::vector<D3D11_INPUT_ELEMENT_DESC>& Layout,
+                         const std::vector<std::string>& keywords) {
+  if (keywords.size() > 32) {
+    ERROR("ShaderPermutations", "init", "A permutation set supports at most 32 keywords.");
+    return E_INVALIDARG;
+  }
+  destroy();
+  m_cache = &cache;
+  m_fileName = fileName;
+  m_layout = Layout;
+  m_keywords = keywords;
+  m_validMask = keywords.size() == 32 ? ~0u : (1u << keywords.size()) - 1u;
+
+  // La base se compila aqu mismo: es lo que se dibuja mientras llegan las dems
+  CompiledVariant base = compileVariant(0);
+  createVariant(device, base);
+  auto it = m_variants.find(0);
+  if (it == m_variants.end() || !it->second) {
+    ERROR("ShaderPermutations", "init", ("Failed to build base variant of " + fileName).c_str());
+    m_variants.clear();
+    return E_FAIL;
+  }
+  m_fallback = it->second.get();
+
+  m_stop = false;
+  m_worker = std::thread(&ShaderPermutations::workerLoop, this);
+  return S_OK;
+}
+
+void
+ShaderPermutations::destroy() {
+  if (m_worker.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+      m_queue.clear();
+    }
+    m_wake.notify_all();
+    m_worker.join();
+  }
+  m_completed.clear();
+  for (auto& variant : m_variants) {
+    if (variant.second) {
+      variant.second->destroy();
+    }
+  }
+  m_variants.clear();
+  m_fallback = nullptr;
+  m_stats = ShaderPermutationStats();
+}
+
+ShaderProgram&
+ShaderPermutations::getVariant(Device& device, ShaderKeywordMask mask) {
+  mask &= m_validMask;
+
+  // Recoge lo que termin el hilo; los objetos de D3D se crean en este hilo
+  std::vector<CompiledVariant> completed;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    completed.swap(m_completed);
+  }
+  for (CompiledVariant& variant : completed) {
+    createVariant(device, variant);
+  }
+
+  auto it = m_variants.find(mask);
+  if (it != m_variants.end() && it->second) {
+    return *it->second;
+  }
+  if (it == m_variants.end() && m_worker.joinable()) {
+    m_variants[mask] = nullptr;
+    ++m_stats.variantsPending;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.push_back(mask);
+    }
+    m_wake.notify_one();
+  }
+  ++m_stats.fallbacksServed;
+  return *m_fallback;
+}
+
+ShaderKeywordMask
+ShaderPermutations::getKeywordMask(const std::string& name) const {
+  for (size_t i = 0; i < m_keywords.size(); ++i) {
+    if (m_keywords[i] == name) {
+      return 1u << i;
+    }
+  }
+  return 0;
+}
+
+bool
+ShaderPermutations::isReady(ShaderKeywordMask mask) const {
+  auto it = m_variants.find(mask & m_validMask);
+  return it != m_variants.end() && it->second != nullptr;
+}
+
+ShaderPermutations::CompiledVariant
+ShaderPermutations::compileVariant(ShaderKeywordMask mask) const {
+  PROFILE_SCOPE("ShaderPermutations::compileVariant");
+  CompiledVariant variant;
+  variant.mask = mask;
+
+  ShaderCompileRequest request;
+  request.fileName = m_fileName;
+  request.flags = D3DShaderCompiler::getDefaultFlags();
+  for (size_t i = 0; i < m_keywords.size(); ++i) {
+    if (mask & (1u << i)) {
+      request.defines.push_back(ShaderDefine{ m_keywords[i], "1" });
+    }
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  request.entryPoint = "VS";
+  request.profile = "vs_4_0";
+  variant.compiled = m_cache->compile(request, variant.vertexBytecode, variant.errors);
+  if (variant.compiled) {
+    request.entryPoint = "PS";
+    request.profile = "ps_4_0";
+    variant.compiled = m_cache->compile(request, variant.pixelBytecode, variant.errors);
+  }
+  variant.compileMs = std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - begin).count();
+  return variant;
+}
+
+void
+ShaderPermutations::createVariant(Device& device, CompiledVariant& variant) {
+  ++m_stats.compiles;
+  m_stats.compileMs += variant.compileMs;
+  if (variant.mask != 0 && m_stats.variantsPending > 0) {
+    --m_stats.variantsPending;
+  }
+
+  std::unique_ptr<ShaderProgram> program;
+  if (variant.compiled) {
+    program.reset(new ShaderProgram());
+    HRESULT hr = program->init(device, variant.vertexBytecode, variant.pixelBytecode, m_layout);
+    if (FAILED(hr)) {
+      program->destroy();
+      program.reset();
+      variant.errors = "Failed to create shader objects.";
+    }
+  }
+
+  if (!program) {
+    // La entrada queda a nullptr: no se vuelve a encolar y se sigue usando la base
+    ++m_stats.compileErrors;
+    ERROR("ShaderPermutations", "createVariant",
+      ("Variant " + std::to_string(variant.mask) + " of " + m_fileName + " failed: " + variant.errors).c_str());
+    m_variants[variant.mask] = nullptr;
+    return;
+  }
+  ++m_stats.variantsReady;
+  m_variants[variant.mask] = std::move(program);
+}
+
+void
+ShaderPermutations::workerLoop() {
+  PROFILE_THREAD_NAME("Shader compiler");
+  for (;;) {
+    ShaderKeywordMask mask = 0;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wake.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+      if (m_stop) {
+        return;
+      }
+      mask = m_queue.front();
+      m_queue.pop_front();
+    }
+
+    CompiledVariant variant = compileVariant(mask);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_completed.push_back(std::move(variant));
+  }
+}
@@ -0,0 +1,255 @@
+#include "Renderer/StaticBatcher.h"
+#include "Renderer/RenderQueue.h"
+#include "ECS/Actor.h"
+#include "MeshComponent.h"
+#include "Device.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include <cfloat>
+
+HRESULT
+StaticBatcher::build(Device& device,
+                     const std::vector<EU::TSharedPointer<Actor>>& actors,
+                     unsigned int maxVerticesPerPage) {
+  PROFILE_SCOPE("StaticBatcher::build");
+  destroy();
+  if (maxVerticesPerPage == 0) {
+    ERROR("StaticBatcher", "build", "maxVerticesPerPage is zero");
+    return E_INVALIDARG;
+  }
+
+  // Agrupar por material conservando el orden de aparicin.
+  // D3D11 devuelve el mismo objeto para estados con la misma descripcin, as que los
+  // samplers de actores distintos suelen coincidir. Los albedos en streaming se agrupan por
+  // su handle: la vista cambia con la residencia.
+  struct MaterialGroup {
+    ID3D11ShaderResourceView* texture;
+    TextureStreamer* streamer;
+    StreamHandle stream;
+    ID3D11SamplerState* sampler;
+    std::vector<Actor*> actors;
+  };
+  std::vector<MaterialGroup> groups;
+  for (const auto& actor : actors) {
+    if (actor.isNull() || !actor->isStatic() || actor->getMeshes().empty()) {
+      continue;
+    }
+    TextureStreamer* streamer = actor->getTextureStreamer();
+    const StreamHandle stream = actor->getTextureStream();
+    ID3D11ShaderResourceView* texture = streamer ? nullptr : actor->getAlbedo();
+    ID3D11SamplerState* sampler = actor->getSampler();
+    MaterialGroup* group = nullptr;
+    for (MaterialGroup& candidate : groups) {
+      if (candidate.texture == texture && candidate.streamer == streamer &&
+          candidate.stream == stream && candidate.sampler == sampler) {
+        group = &candidate;
+        break;
+      }
+    }
+    if (!group) {
+      groups.push_back({ texture, streamer, stream, sampler, {} });
+      group = &groups.back();
+    }
+    group->actors.push_back(actor.get());
+  }
+  if (groups.empty()) {
+    return S_OK;
+  }
+
+  HRESULT hr = m_objectBuffer.init(device, sizeof(CBChangesEveryFrame));
+  if (FAILED(hr)) {
+    ERROR("StaticBatcher", "build", ("Failed to create object buffer. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
+  }
+  m_objectConstants.mWorld = XMMatrixIdentity();
+  m_objectConstants.vMeshColor = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+
+  MeshComponent staging;
+  for (const MaterialGroup& group : groups) {
+    unsigned int firstSubmesh = static_cast<unsigned int>(m_submeshes.size());
+    for (Actor* actor : group.actors) {
+      // La matriz puede no estar calculada an si el actor no pas por update()
+      auto transform = actor->getComponent<Transform>();
+      XMMATRIX world = XMMatrixIdentity();
+      if (transform) {
+        transform->update(0.0f);
+        world = transform->matrix;
+      }
+
+      for (const MeshComponent& mesh : actor->getMeshes()) {
+        if (mesh.m_vertex.empty() || mesh.m_index.empty()) {
+          continue;
+        }
+        if (!staging.m_vertex.empty() &&
+            staging.m_vertex.size() + mesh.m_vertex.size() > maxVerticesPerPage) {
+          hr = flushPage(device, staging, group.texture, group.streamer, group.stream, group.sampler, firstSubmesh);
+          if (FAILED(hr)) {
+            destroy();
+            return hr;
+          }
+          firstSubmesh = static_cast<unsigned int>(m_submeshes.size());
+        }
+
+        StaticSubmesh submesh;
+        submesh.page = static_cast<unsigned int>(m_pages.size());
+        submesh.startIndex = static_cast<unsigned int>(staging.m_index.size());
+        submesh.indexCount = static_cast<unsigned int>(mesh.m_index.size());
+        submesh.owner = actor;
+
+        // Pre-transformar a mundo: la pgina se dibuja con matriz identidad
+        const unsigned int baseVertex = static_cast<unsigned int>(staging.m_vertex.size());
+        XMVECTOR boundsMin = XMVectorReplicate(FLT_MAX);
+        XMVECTOR boundsMax = XMVectorReplicate(-FLT_MAX);
+        for (const SimpleVertex& vertex : mesh.m_vertex) {
+          XMVECTOR position = XMVector3TransformCoord(XMLoadFloat3(&vertex.Pos), world);
+          boundsMin = XMVectorMin(boundsMin, position);
+          boundsMax = XMVectorMax(boundsMax, position);
+          SimpleVertex transformed = vertex;
+          XMStoreFloat3(&transformed.Pos, position);
+          staging.m_vertex.push_back(transformed);
+        }
+        XMStoreFloat3(&submesh.boundsMin, boundsMin);
+        XMStoreFloat3(&submesh.boundsMax, boundsMax);
+
+        // ndices de 32 bits: se rebasan aqu para que toda la pgina vaya con BaseVertex 0
+        for (unsigned int index : mesh.m_index) {
+          staging.m_index.push_back(index + baseVertex);
+        }
+        m_submeshes.push_back(submesh);
+      }
+      m_batchedActors.push_back(actor);
+    }
+
+    if (!staging.m_vertex.empty()) {
+      hr = flushPage(device, staging, group.texture, group.streamer, group.stream, group.sampler, firstSubmesh);
+      if (FAILED(hr)) {
+        destroy();
+        return hr;
+      }
+    }
+  }
+
+  // Slo al final: si algo falla los actores siguen dibujndose por su cuenta
+  for (Actor* actor : m_batchedActors) {
+    actor->setStaticBatched(true);
+  }
+  m_stats.actors = static_cast<unsigned int>(m_batchedActors.size());
+  m_stats.submeshes = static_cast<unsigned int>(m_submeshes.size());
+  m_stats.pages = static_cast<unsigned int>(m_pages.size());
+
+  MESSAGE("StaticBatcher", "build",
+    ("Merged " + std::to_string(m_stats.submeshes) + " static meshes into " +
+     std::to_string(m_stats.pages) + " pages.").c_str());
+  return S_OK;
+}
+
+HRESULT
+StaticBatcher::flushPage(Device& device,
+                         MeshComponent& staging,
+                         ID3D11ShaderResourceView* texture,
+                         TextureStreamer* streamer,
+                         StreamHandle stream,
+                         ID3D11SamplerState* sampler,
+                         unsigned int firstSubmesh) {
+  StaticPage page;
+  page.texture = texture;
+  page.streamer = streamer;
+  page.stream = stream;
+  page.sampler = sampler;
+  page.firstSubmesh = firstSubmesh;
+  page.submeshCount = static_cast<unsigned int>(m_submeshes.size()) - firstSubmesh;
+
+  HRESULT hr = page.vertexBuffer.init(device, staging, D3D11_BIND_VERTEX_BUFFER);
+  if (FAILED(hr)) {
+    ERROR("StaticBatcher", "flushPage", ("Failed to create page vertex buffer. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
+  }
+  hr = page.indexBuffer.init(device, staging, D3D11_BIND_INDEX_BUFFER);
+  if (FAILED(hr)) {
+    ERROR("StaticBatcher", "flushPage", ("Failed to create page index buffer. HRESULT: " + std::to_string(hr)).c_str());
+    page.vertexBuffer.destroy();
+    return hr;
+  }
+
+  XMVECTOR boundsMin = XMVectorReplicate(FLT_MAX);
+  XMVECTOR boundsMax = XMVectorReplicate(-FLT_MAX);
+  for (unsigned int i = firstSubmesh; i < m_submeshes.size(); ++i) {
+    boundsMin = XMVectorMin(boundsMin, XMLoadFloat3(&m_submeshes[i].boundsMin));
+    boundsMax = XMVectorMax(boundsMax, XMLoadFloat3(&m_submeshes[i].boundsMax));
+  }
+  XMStoreFloat3(&page.center, XMVectorScale(XMVectorAdd(boundsMin, boundsMax), 0.5f));
+
+  m_stats.vertices += static_cast<unsigned int>(staging.m_vertex.size());
+  m_stats.indices += static_cast<unsigned int>(staging.m_index.size());
+  m_pages.push_back(page);
+
+  staging.m_vertex.clear();
+  staging.m_index.clear();
+  return S_OK;
+}
+
+void
+StaticBatcher::submit(RenderQueue& queue, const VisibilityFn& isVisible) {
+  PROFILE_SCOPE("StaticBatcher::submit");
+  m_stats.drawsSubmitted = 0;
+  m_stats.submeshesCulled = 0;
+
+  DrawPacket packet;
+  packet.vertexStride = sizeof(SimpleVertex);
+  packet.indexFormat = DXGI_FORMAT_R32_UINT;
+  packet.objectBuffer = m_objectBuffer.getBuffer();
+  packet.objectSlot = 2;
+  packet.objectData = &m_objectConstants;
+  packet.objectDataSize = sizeof(CBChangesEveryFrame);
+
+  for (const StaticPage& page : m_pages) {
+    packet.vertexBuffer = page.vertexBuffer.getBuffer();
+    packet.indexBuffer = page.indexBuffer.getBuffer();
+    packet.texture = page.streamer ? page.streamer->getView(page.stream) : page.texture;
+    packet.sampler = page.sampler;
+    packet.viewDepth = queue.computeViewDepth(XMMatrixTranslation(page.center.x, page.center.y, page.center.z));
+
+    // Las mallas de una pgina son contiguas en el index buffer: cada serie visible es un draw
+    unsigned int runStart = 0;
+    unsigned int runCount = 0;
+    for (unsigned int i = page.firstSubmesh; i < page.firstSubmesh + page.submeshCount; ++i) {
+      const StaticSubmesh& submesh = m_submeshes[i];
+      if (isVisible && !isVisible(submesh)) {
+        ++m_stats.submeshesCulled;
+        if (runCount > 0) {
+          packet.startIndex = runStart;
+          packet.indexCount = runCount;
+          queue.submit(packet);
+          ++m_stats.drawsSubmitted;
+          runCount = 0;
+        }
+        continue;
+      }
+      if (runCount == 0) {
+        runStart = submesh.startIndex;
+      }
+      runCount += submesh.indexCount;
+    }
+    if (runCount > 0) {
+      packet.startIndex = runStart;
+      packet.indexCount = runCount;
+      queue.submit(packet);
+      ++m_stats.drawsSubmitted;
+    }
+  }
+}
+
+void
+StaticBatcher::destroy() {
+  for (StaticPage& page : m_pages) {
+    page.vertexBuffer.destroy();
+    page.indexBuffer.destroy();
+  }
+  m_pages.clear();
+  m_submeshes.clear();
+  for (Actor* actor : m_batchedActors) {
+    actor->setStaticBatched(false);
+  }
+  m_batchedActors.clear();
+  m_objectBuffer.destroy();
+  m_stats = StaticBatchStats();
+}
@@ -0,0 +1,20 @@
+#include "Renderer/StubShaderCompiler.h"
+
+bool
+StubShaderCompiler::compile(const ShaderCompileRequest& request,
+                            std::vector<unsigned char>& bytecode,
+                            std::string& errors) {
+  ++m_compiles;
+  if (!m_failingEntryPoint.empty() && request.entryPoint == m_failingEntryPoint) {
+    errors = request.fileName + ": error X0000: forced failure in '" + request.entryPoint + "'";
+    return false;
+  }
+
+  std::string text = "STUB|" + request.fileName + "|" + request.entryPoint + "|" + request.profile;
+  for (const ShaderDefine& define : request.defines) {
+    text += "|" + define.name + "=" + define.value;
+  }
+  text += "|" + std::to_string(request.flags);
+  bytecode.assign(text.begin(), text.end());
+  return true;
+}
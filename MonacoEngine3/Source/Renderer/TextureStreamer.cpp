@@ -0,0 +1,444 @@
+#include "Renderer/TextureStreamer.h"
+#include "Device.h"
+#include "RHI/IRenderBackend.h"
+#include "EngineUtilities/Utilities/Camera.h"
+#include "EngineUtilities/Utilities/EngineStats.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+HRESULT
+TextureStreamer::init(Device& device, const TextureStreamerSettings& settings) {
+  destroy();
+  if (!device.getBackend()) {
+    ERROR("TextureStreamer", "init", "Device has no render backend.");
+    return E_POINTER;
+  }
+  m_backend = device.getBackend();
+  m_settings = settings;
+  m_stop = false;
+  m_worker = std::thread(&TextureStreamer::workerLoop, this);
+  return S_OK;
+}
+
+void
+TextureStreamer::destroy() {
+  if (m_worker.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+      m_queue.clear();
+    }
+    m_wake.notify_all();
+    m_worker.join();
+  }
+  for (CompletedUpload& upload : m_completed) {
+    SAFE_RELEASE(upload.view);
+    SAFE_RELEASE(upload.texture);
+  }
+  m_completed.clear();
+  for (std::unique_ptr<StreamedTexture>& texture : m_textures) {
+    SAFE_RELEASE(texture->view);
+    SAFE_RELEASE(texture->texture);
+  }
+  if (m_stats.residentBytes > 0) {
+    ENGINE_GAUGE_ADD("stream_resident_bytes", -static_cast<long long>(m_stats.residentBytes));
+  }
+  m_textures.clear();
+  m_stats = TextureStreamerStats();
+  m_frame = 0;
+  m_backend = nullptr;
+}
+
+StreamHandle
+TextureStreamer::add(const std::string& path, const ImageImportSettings& settings) {
+  PROFILE_SCOPE("TextureStreamer::add");
+  if (!m_backend) {
+    ERROR("TextureStreamer", "add", "Streamer is not initialized.");
+    return kInvalidStream;
+  }
+  std::unique_ptr<StreamedTexture> texture(new StreamedTexture());
+  ImageImportSettings importSettings = settings;
+  importSettings.generateMips = true;
+  std::string error;
+  if (!ImageImporter::importFile(path, importSettings, texture->image, &error)) {
+    ERROR("TextureStreamer", "add", ("Failed to import " + path + ": " + error).c_str());
+    return kInvalidStream;
+  }
+  // Tras un fallo de cach los niveles estn en memoria propia; reimportar los deja
+  // proyectados desde el blob recin escrito y el sistema decide qu pginas cargar
+  if (!texture->image.fromCache && importSettings.useCache) {
+    ImportedImage mapped;
+    if (ImageImporter::importFile(path, importSettings, mapped) && mapped.fromCache) {
+      texture->image = std::move(mapped);
+    }
+  }
+  texture->name = path;
+
+  // Cola: el primer nivel que cabe en tailSize
+  const unsigned int levels = static_cast<unsigned int>(texture->image.levels.size());
+  unsigned int tailMip = levels - 1;
+  for (unsigned int mip = 0; mip < levels; ++mip) {
+    const ImportedLevel& level = texture->image.levels[mip];
+    if (std::max(level.width, level.height) <= m_settings.tailSize) {
+      tailMip = mip;
+      break;
+    }
+  }
+  tailMip = getValidTopMip(*texture, tailMip);
+  texture->tailMip = tailMip;
+  texture->wantedMip = tailMip;
+  texture->lastUsedFrame = m_frame;
+
+  const StreamHandle handle = static_cast<StreamHandle>(m_textures.size());
+  m_textures.push_back(std::move(texture));
+  UploadJob job;
+  makeJob(handle, tailMip, job);
+  ID3D11Texture2D* tailTexture = nullptr;
+  ID3D11ShaderResourceView* tailView = nullptr;
+  HRESULT hr = createTexture(job, &tailTexture, &tailView);
+  if (FAILED(hr)) {
+    ERROR("TextureStreamer", "add", ("Failed to create mip tail of " + path + ". HRESULT: " + std::to_string(hr)).c_str());
+    m_textures.pop_back();
+    return kInvalidStream;
+  }
+  replaceTexture(handle, tailMip, tailTexture, tailView, job.bytes);
+  ++m_stats.textures;
+  return handle;
+}
+
+void
+TextureStreamer::request(StreamHandle handle,
+                         const Camera& camera,
+                         const XMFLOAT3& boundsMin,
+                         const XMFLOAT3& boundsMax,
+                         float viewportHeight) {
+  if (handle >= m_textures.size()) {
+    return;
+  }
+  // Detrs de la cmara no se ve: la textura no se pide y envejece en el LRU
+  const EU::Vector3 position = camera.getPosition();
+  const EU::Vector3 forward = camera.GetForward();
+  XMVECTOR center = XMVectorScale(XMVectorAdd(XMLoadFloat3(&boundsMin), XMLoadFloat3(&boundsMax)), 0.5f);
+  const float radius = 0.5f * XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&boundsMax), XMLoadFloat3(&boundsMin))));
+  XMVECTOR toCenter = XMVectorSubtract(center, XMVectorSet(position.x, position.y, position.z, 0.0f));
+  if (XMVectorGetX(XMVector3Dot(toCenter, XMVectorSet(forward.x, forward.y, forward.z, 0.0f))) < -radius) {
+    return;
+  }
+
+  StreamedTexture& texture = *m_textures[handle];
+  const float mip = computeMip(camera, boundsMin, boundsMax, viewportHeight,
+                               texture.image.width, texture.image.height) + m_settings.mipBias;
+  texture.requestedMip = texture.requested ? std::min(texture.requestedMip, mip) : mip;
+  texture.requested = true;
+}
+
+float
+TextureStreamer::computeMip(const Camera& camera,
+                            const XMFLOAT3& boundsMin,
+                            const XMFLOAT3& boundsMax,
+                            float viewportHeight,
+                            unsigned int width,
+                            unsigned int height) {
+  XMVECTOR center = XMVectorScale(XMVectorAdd(XMLoadFloat3(&boundsMin), XMLoadFloat3(&boundsMax)), 0.5f);
+  const float radius = 0.5f * XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&boundsMax), XMLoadFloat3(&boundsMin))));
+  const EU::Vector3 position = camera.getPosition();
+  const float distance = XMVectorGetX(XMVector3Length(
+    XMVectorSubtract(center, XMVectorSet(position.x, position.y, position.z, 0.0f))));
+
+  // Dimetro proyectado de la esfera, medido desde su punto ms cercano (o el plano cercano)
+  const float nearest = std::max(distance - radius, std::max(camera.getNearZ(), 1e-3f));
+  const float pixelsPerUnit = viewportHeight / (2.0f * std::tan(camera.getFovY() * 0.5f));
+  const float projectedPixels = 2.0f * radius / nearest * pixelsPerUnit;
+  const float texels = static_cast<float>(std::max(width, height));
+  if (projectedPixels <= 0.0f || texels <= 0.0f) {
+    return static_cast<float>(MipGenerator::getLevelCount(width, height));
+  }
+  return std::log2(texels / projectedPixels);
+}
+
+void
+TextureStreamer::update() {
+  PROFILE_SCOPE("TextureStreamer::update");
+  ++m_frame;
+
+  // 1) Subidas terminadas: cambiar de textura en este hilo
+  std::vector<CompletedUpload> completed;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    completed.swap(m_completed);
+  }
+  for (CompletedUpload& upload : completed) {
+    StreamedTexture& texture = *m_textures[upload.handle];
+    texture.pending = false;
+    --m_stats.pending;
+    m_stats.reservedBytes -= upload.bytes;
+    m_stats.uploadMs += upload.ms;
+    if (FAILED(upload.hr)) {
+      ERROR("TextureStreamer", "update",
+        ("Failed to upload mip " + std::to_string(upload.firstMip) + " of " + texture.name +
+         ". HRESULT: " + std::to_string(upload.hr)).c_str());
+      continue;
+    }
+    replaceTexture(upload.handle, upload.firstMip, upload.texture, upload.view, upload.bytes);
+    ++m_stats.uploads;
+    m_stats.bytesUploaded += upload.bytes;
+    ENGINE_STAT_ADD("stream_uploads", 1);
+    ENGINE_STAT_ADD("stream_upload_bytes", static_cast<long long>(upload.bytes));
+  }
+
+  // 2) Nivel pedido por cada textura vista este frame
+  std::vector<StreamHandle> candidates;
+  m_stats.visible = 0;
+  m_stats.satisfied = 0;
+  m_stats.wantedBytes = 0;
+  for (StreamHandle handle = 0; handle < m_textures.size(); ++handle) {
+    StreamedTexture& texture = *m_textures[handle];
+    if (texture.requested) {
+      const unsigned int mip = static_cast<unsigned int>(std::floor(std::max(texture.requestedMip, 0.0f)));
+      texture.wantedMip = getValidTopMip(texture, std::min(mip, texture.tailMip));
+      texture.lastUsedFrame = m_frame;
+      texture.requested = false;
+      ++m_stats.visible;
+      if (texture.residentMip <= texture.wantedMip) {
+        ++m_stats.satisfied;
+      }
+      else if (!texture.pending) {
+        candidates.push_back(handle);
+      }
+    }
+    else {
+      texture.wantedMip = texture.tailMip;
+    }
+    m_stats.wantedBytes += getBytesFrom(texture, texture.wantedMip);
+  }
+
+  // 3) Presupuesto: primero lo que ya sobra (p. ej. tras bajarlo en la GUI)
+  while (m_stats.residentBytes + m_stats.reservedBytes > m_settings.budgetBytes && evictLeastRecentlyUsed()) {
+  }
+
+  // 4) Subidas nuevas, las que ms niveles echan en falta primero. Se elige el nivel ms
+  // detallado que cabe contando con lo expulsable y slo entonces se expulsa, y slo lo justo:
+  // expulsar para un nivel que al final no cabe tirara texturas en cada frame
+  std::sort(candidates.begin(), candidates.end(), [this](StreamHandle a, StreamHandle b) {
+    return m_textures[a]->residentMip - m_textures[a]->wantedMip > m_textures[b]->residentMip - m_textures[b]->wantedMip;
+  });
+  for (StreamHandle handle : candidates) {
+    if (m_stats.pending >= m_settings.maxInFlight) {
+      break;
+    }
+    StreamedTexture& texture = *m_textures[handle];
+    // Lo expulsable sale de lo residente, as que restarlo no baja de cero
+    const unsigned long long evictable = getEvictableBytes();
+    bool queued = false;
+    for (unsigned int mip = texture.wantedMip; mip < texture.residentMip; ++mip) {
+      const unsigned long long bytes = getBytesFrom(texture, mip);
+      if (getValidTopMip(texture, mip) != mip ||
+          m_stats.residentBytes + m_stats.reservedBytes + bytes - evictable > m_settings.budgetBytes) {
+        continue;
+      }
+      while (m_stats.residentBytes + m_stats.reservedBytes + bytes > m_settings.budgetBytes && evictLeastRecentlyUsed()) {
+      }
+      if (m_stats.residentBytes + m_stats.reservedBytes + bytes > m_settings.budgetBytes) {
+        // Slo si falla crear una cola: no se prueba otro nivel con memoria ya liberada
+        break;
+      }
+      UploadJob job;
+      makeJob(handle, mip, job);
+      texture.pending = true;
+      ++m_stats.pending;
+      m_stats.reservedBytes += job.bytes;
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(job));
+      }
+      m_wake.notify_one();
+      queued = true;
+      break;
+    }
+    if (!queued) {
+      ++m_stats.budgetMisses;
+    }
+  }
+}
+
+ID3D11ShaderResourceView*
+TextureStreamer::getView(StreamHandle handle) const {
+  return handle < m_textures.size() ? m_textures[handle]->view : nullptr;
+}
+
+StreamedTextureInfo
+TextureStreamer::getInfo(StreamHandle handle) const {
+  StreamedTextureInfo info;
+  if (handle >= m_textures.size()) {
+    return info;
+  }
+  const StreamedTexture& texture = *m_textures[handle];
+  info.name = texture.name;
+  info.width = texture.image.width;
+  info.height = texture.image.height;
+  info.levels = static_cast<unsigned int>(texture.image.levels.size());
+  info.residentMip = texture.residentMip;
+  info.wantedMip = texture.wantedMip;
+  info.tailMip = texture.tailMip;
+  info.residentBytes = texture.residentBytes;
+  info.framesUnused = m_frame - texture.lastUsedFrame;
+  info.pending = texture.pending;
+  return info;
+}
+
+unsigned int
+TextureStreamer::getValidTopMip(const StreamedTexture& texture, unsigned int mip) const {
+  if (texture.image.format == DXGI_FORMAT_R8G8B8A8_UNORM) {
+    return mip;
+  }
+  // El nivel 0 de una textura BCn debe medir mltiplos de 4 (el nivel 0 importado lo cumple)
+  while (mip > 0 && (texture.image.levels[mip].width % 4 != 0 || texture.image.levels[mip].height % 4 != 0)) {
+    --mip;
+  }
+  return mip;
+}
+
+unsigned long long
+TextureStreamer::getBytesFrom(const StreamedTexture& texture, unsigned int firstMip) const {
+  const bool blocks = texture.image.format != DXGI_FORMAT_R8G8B8A8_UNORM;
+  unsigned long long bytes = 0;
+  for (size_t mip = firstMip; mip < texture.image.levels.size(); ++mip) {
+    const ImportedLevel& level = texture.image.levels[mip];
+    bytes += static_cast<unsigned long long>(level.rowPitch) * (blocks ? (level.height + 3) / 4 : level.height);
+  }
+  return bytes;
+}
+
+void
+TextureStreamer::makeJob(StreamHandle handle, unsigned int firstMip, UploadJob& job) const {
+  const StreamedTexture& texture = *m_textures[handle];
+  const ImportedLevel& top = texture.image.levels[firstMip];
+  job.handle = handle;
+  job.firstMip = firstMip;
+  job.desc = D3D11_TEXTURE2D_DESC();
+  job.desc.Width = top.width;
+  job.desc.Height = top.height;
+  job.desc.MipLevels = static_cast<unsigned int>(texture.image.levels.size()) - firstMip;
+  job.desc.ArraySize = 1;
+  job.desc.Format = texture.image.format;
+  job.desc.SampleDesc.Count = 1;
+  job.desc.Usage = D3D11_USAGE_IMMUTABLE;    // Nunca se actualiza: se sustituye entera
+  job.desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+  texture.image.getSubresources(job.levels);
+  job.levels.erase(job.levels.begin(), job.levels.begin() + firstMip);
+  job.bytes = getBytesFrom(texture, firstMip);
+}
+
+HRESULT
+TextureStreamer::createTexture(const UploadJob& job,
+                               ID3D11Texture2D** texture,
+                               ID3D11ShaderResourceView** view) const {
+  HRESULT hr = m_backend->createTexture2DConcurrent(&job.desc, job.levels.data(), texture);
+  if (FAILED(hr)) {
+    return hr;
+  }
+  D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+  srvDesc.Format = job.desc.Format;
+  srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+  srvDesc.Texture2D.MipLevels = job.desc.MipLevels;
+  hr = m_backend->createShaderResourceViewConcurrent(*texture, &srvDesc, view);
+  if (FAILED(hr)) {
+    SAFE_RELEASE(*texture);
+  }
+  return hr;
+}
+
+void
+TextureStreamer::replaceTexture(StreamHandle handle,
+                                unsigned int firstMip,
+                                ID3D11Texture2D* texture,
+                                ID3D11ShaderResourceView* view,
+                                unsigned long long bytes) {
+  // El runtime mantiene viva la vista anterior mientras siga enlazada o grabada en una lista
+  StreamedTexture& entry = *m_textures[handle];
+  SAFE_RELEASE(entry.view);
+  SAFE_RELEASE(entry.texture);
+  entry.texture = texture;
+  entry.view = view;
+  entry.residentMip = firstMip;
+  ENGINE_GAUGE_ADD("stream_resident_bytes", static_cast<long long>(bytes) - static_cast<long long>(entry.residentBytes));
+  m_stats.residentBytes = m_stats.residentBytes - entry.residentBytes + bytes;
+  entry.residentBytes = bytes;
+}
+
+unsigned long long
+TextureStreamer::getEvictableBytes() const {
+  unsigned long long bytes = 0;
+  for (const auto& entry : m_textures) {
+    const StreamedTexture& texture = *entry;
+    if (isEvictable(texture)) {
+      bytes += texture.residentBytes - getBytesFrom(texture, texture.tailMip);
+    }
+  }
+  return bytes;
+}
+
+bool
+TextureStreamer::evictLeastRecentlyUsed() {
+  StreamHandle victim = kInvalidStream;
+  for (StreamHandle handle = 0; handle < m_textures.size(); ++handle) {
+    const StreamedTexture& texture = *m_textures[handle];
+    if (!isEvictable(texture)) {
+      continue;
+    }
+    if (victim == kInvalidStream || texture.lastUsedFrame < m_textures[victim]->lastUsedFrame) {
+      victim = handle;
+    }
+  }
+  if (victim == kInvalidStream) {
+    return false;
+  }
+
+  // La cola son unos KB: se crea aqu mismo y la memoria se libera al momento
+  UploadJob job;
+  makeJob(victim, m_textures[victim]->tailMip, job);
+  ID3D11Texture2D* texture = nullptr;
+  ID3D11ShaderResourceView* view = nullptr;
+  HRESULT hr = createTexture(job, &texture, &view);
+  if (FAILED(hr)) {
+    ERROR("TextureStreamer", "evictLeastRecentlyUsed",
+      ("Failed to recreate mip tail of " + m_textures[victim]->name + ". HRESULT: " + std::to_string(hr)).c_str());
+    return false;
+  }
+  replaceTexture(victim, job.firstMip, texture, view, job.bytes);
+  ++m_stats.evictions;
+  ENGINE_STAT_ADD("stream_evictions", 1);
+  return true;
+}
+
+void
+TextureStreamer::workerLoop() {
+  PROFILE_THREAD_NAME("Texture streamer");
+  for (;;) {
+    UploadJob job;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wake.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+      if (m_stop) {
+        return;
+      }
+      job = std::move(m_queue.front());
+      m_queue.pop_front();
+    }
+
+    // Leer los niveles del blob proyectado carga sus pginas de disco aqu, no en el frame
+    PROFILE_SCOPE("TextureStreamer::upload");
+    CompletedUpload upload;
+    upload.handle = job.handle;
+    upload.firstMip = job.firstMip;
+    upload.bytes = job.bytes;
+    auto begin = std::chrono::steady_clock::now();
+    upload.hr = createTexture(job, &upload.texture, &upload.view);
+    upload.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_completed.push_back(upload);
+  }
+}
@@ -3,6 +3,8 @@
 #include "ECS\Entity.h"
 #include "ECS\Transform.h"
 #include "DeviceContext.h"
+#include "Renderer\RenderQueue.h"
+#include "EngineUtilities\Utilities\Profiler.h"
 
 void SceneGraph::init() {
 	m_entities.clear();
@@ -162,6 +164,15 @@ SceneGraph::detach(Entity* child) {
 
 void
 SceneGraph::update(float deltaTime, DeviceContext& deviceContext) {
+	PROFILE_SCOPE("SceneGraph::update");
+	// El estado actual pasa a ser el anterior antes de avanzar el paso
+	for (Entity* e : m_entities)
+	{
+		if (!e) continue;
+		auto t = e->getComponent<Transform>();
+		if (t) t->beginStep();
+	}
+
 	// Actualiza todas las entidades
 	for (Entity* e : m_entities)
 	{
@@ -198,6 +209,17 @@ SceneGraph::updateWorldRecursive(Entity* node, const XMMATRIX& parentWorld) {
 	}
 }
 
+void
+SceneGraph::interpolate(float alpha) {
+	PROFILE_SCOPE("SceneGraph::interpolate");
+	for (Entity* e : m_entities)
+	{
+		if (!e) continue;
+		auto t = e->getComponent<Transform>();
+		if (t) t->interpolate(alpha);
+	}
+}
+
 void SceneGraph::render(DeviceContext& deviceContext) {
 	// Render all entities
 	for (auto& e : m_entities) {
@@ -206,3 +228,14 @@ void SceneGraph::render(DeviceContext& deviceContext) {
 		}
 	}
 }
+
+
+void SceneGraph::submit(RenderQueue& queue) {
+	PROFILE_SCOPE("SceneGraph::submit");
+	// Cada entidad emite sus paquetes; el orden final lo decide la cola
+	for (auto& e : m_entities) {
+		if (e) {
+			e->submit(queue);
+		}
+	}
+}
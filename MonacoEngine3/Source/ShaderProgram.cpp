@@ -1,12 +1,16 @@
 #include "ShaderProgram.h"
 #include "Device.h"
 #include "DeviceContext.h"
+#include "Renderer/D3DShaderCompiler.h"
+#include "Renderer/ShaderCache.h"
+#include "EngineUtilities/Utilities/Profiler.h"
 
 
 HRESULT 
 ShaderProgram::init(Device& device, 
 										const std::string& fileName, 
 										std::vector<D3D11_INPUT_ELEMENT_DESC> Layout) {
+	PROFILE_SCOPE("ShaderProgram::init");
 	if (!device.m_device) {
 		ERROR("ShaderProgram", "init", "Device is null.");
 		return E_POINTER;
@@ -44,6 +48,59 @@ ShaderProgram::init(Device& device,
 	return hr;
 }
 
+HRESULT
+ShaderProgram::init(Device& device,
+										const std::vector<unsigned char>& vertexBytecode,
+										const std::vector<unsigned char>& pixelBytecode,
+										std::vector<D3D11_INPUT_ELEMENT_DESC> Layout) {
+	if (!device.m_device) {
+		ERROR("ShaderProgram", "init", "Device is null.");
+		return E_POINTER;
+	}
+	if (vertexBytecode.empty() || pixelBytecode.empty()) {
+		ERROR("ShaderProgram", "init", "Shader bytecode is empty.");
+		return E_INVALIDARG;
+	}
+	if (Layout.empty()) {
+		ERROR("ShaderProgram", "init", "Input layout is empty.");
+		return E_INVALIDARG;
+	}
+
+	HRESULT hr = device.CreateVertexShader(vertexBytecode.data(),
+																				 vertexBytecode.size(),
+																				 nullptr,
+																				 &m_VertexShader);
+	if (FAILED(hr)) {
+		ERROR("ShaderProgram", "init", "Failed to create vertex shader.");
+		return hr;
+	}
+
+	// El InputLayout valida la firma de entrada contra un blob del VS
+	SAFE_RELEASE(m_vertexShaderData);
+	hr = D3DCreateBlob(vertexBytecode.size(), &m_vertexShaderData);
+	if (FAILED(hr)) {
+		ERROR("ShaderProgram", "init", "Failed to allocate vertex shader blob.");
+		return hr;
+	}
+	memcpy(m_vertexShaderData->GetBufferPointer(), vertexBytecode.data(), vertexBytecode.size());
+	hr = CreateInputLayout(device, Layout);
+	if (FAILED(hr)) {
+		ERROR("ShaderProgram", "init", "Failed to create input layout.");
+		return hr;
+	}
+
+	hr = device.CreatePixelShader(pixelBytecode.data(),
+																pixelBytecode.size(),
+																nullptr,
+																&m_PixelShader);
+	if (FAILED(hr)) {
+		ERROR("ShaderProgram", "init", "Failed to create pixel shader.");
+		return hr;
+	}
+
+	return S_OK;
+}
+
 HRESULT 
 ShaderProgram::CreateInputLayout(Device& device, 
 																 std::vector<D3D11_INPUT_ELEMENT_DESC> Layout) {
@@ -161,49 +218,40 @@ ShaderProgram::CreateShader(Device& device,
 
 HRESULT 
 ShaderProgram::CompileShaderFromFile(char* szFileName, 
-																		 LPCSTR szEntryPoint, 
-																		 LPCSTR szShaderModel, 
-																		 ID3DBlob** ppBlobOut) {
-	HRESULT hr = S_OK;
+																					 LPCSTR szEntryPoint, 
+																					 LPCSTR szShaderModel, 
+																					 ID3DBlob** ppBlobOut) {
+	ShaderCompileRequest request;
+	request.fileName = szFileName;
+	request.entryPoint = szEntryPoint;
+	request.profile = szShaderModel;
+	request.flags = D3DShaderCompiler::getDefaultFlags();
+
+	// Con cach slo se compila si cambi el archivo, algn include o los parmetros
+	std::vector<unsigned char> bytecode;
+	std::string errors;
+	bool compiled = false;
+	if (m_shaderCache) {
+		compiled = m_shaderCache->compile(request, bytecode, errors);
+	}
+	else {
+		D3DShaderCompiler compiler;
+		compiled = compiler.compile(request, bytecode, errors);
+	}
 
-	DWORD dwShaderFlags = D3DCOMPILE_ENABLE_STRICTNESS;
-#if defined( DEBUG ) || defined( _DEBUG )
-	// Set the D3DCOMPILE_DEBUG flag to embed debug information in the shaders.
-	// Setting this flag improves the shader debugging experience, but still allows 
-	// the shaders to be optimized and to run exactly the way they will run in 
-	// the release configuration of this program.
-	dwShaderFlags |= D3DCOMPILE_DEBUG;
-#endif
-	ID3DBlob* pErrorBlob;
-	hr = D3DX11CompileFromFile(szFileName,
-														 nullptr,
-														 nullptr,
-														 szEntryPoint,
-														 szShaderModel,
-														 dwShaderFlags,
-														 0,
-														 nullptr,
-														 ppBlobOut,
-														 &pErrorBlob,
-														 nullptr);
+	if (!compiled) {
+		ERROR("ShaderProgram", "CompileShaderFromFile",
+			("Failed to compile shader from file: " + request.fileName + ". Error: " + errors).c_str());
+		return E_FAIL;
+	}
 
+	// El InputLayout y CreateShader trabajan con blobs
+	HRESULT hr = D3DCreateBlob(bytecode.size(), ppBlobOut);
 	if (FAILED(hr)) {
-		if (pErrorBlob) {
-			ERROR("ShaderProgram", "CompileShaderFromFile",
-				"Failed to compile shader from file: %s. Error: %s",
-				szFileName, static_cast<const char*>(pErrorBlob->GetBufferPointer()));
-
-			pErrorBlob->Release();
-		}
-		else {
-			ERROR("ShaderProgram", "CompileShaderFromFile",
-				"Failed to compile shader from file: %s. No error message available.",
-				szFileName);
-		}
+		ERROR("ShaderProgram", "CompileShaderFromFile", "Failed to allocate shader blob.");
 		return hr;
 	}
-
-	SAFE_RELEASE(pErrorBlob)
+	memcpy((*ppBlobOut)->GetBufferPointer(), bytecode.data(), bytecode.size());
 
 	return S_OK;
 }
@@ -216,8 +264,8 @@ ShaderProgram::render(DeviceContext& deviceContext) {
 	}
 
 	m_inputLayout.render(deviceContext);
-	deviceContext.m_deviceContext->VSSetShader(m_VertexShader, nullptr, 0);
-	deviceContext.m_deviceContext->PSSetShader(m_PixelShader, nullptr, 0);
+	deviceContext.VSSetShader(m_VertexShader, nullptr, 0);
+	deviceContext.PSSetShader(m_PixelShader, nullptr, 0);
 }
 
 void
@@ -228,10 +276,10 @@ ShaderProgram::render(DeviceContext& deviceContext, ShaderType type) {
 	}
 	switch (type) {
 	case VERTEX_SHADER:
-		deviceContext.m_deviceContext->VSSetShader(m_VertexShader, nullptr, 0);
+		deviceContext.VSSetShader(m_VertexShader, nullptr, 0);
 		break;
 	case PIXEL_SHADER:
-		deviceContext.m_deviceContext->PSSetShader(m_PixelShader, nullptr, 0);
+		deviceContext.PSSetShader(m_PixelShader, nullptr, 0);
 		break;
 	default:
 		break;
@@ -153,7 +153,7 @@ SwapChain::destroy() {
 void
 SwapChain::present() {
   if (m_swapChain) {
-    HRESULT hr = m_swapChain->Present(0, 0);
+    HRESULT hr = m_swapChain->Present(m_syncInterval, 0);
     if (FAILED(hr)) {
       ERROR("SwapChain", "present",
         ("Failed to present swap chain. HRESULT: " + std::to_string(hr)).c_str());
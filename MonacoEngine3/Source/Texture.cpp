@@ -1,13 +1,28 @@
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
 #include "Texture.h"
 #include "Device.h"
 #include "DeviceContext.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+#include "EngineUtilities/Utilities/EngineStats.h"
+#include "EngineUtilities/Utilities/ImageImporter.h"
+#include "EngineUtilities/Utilities/ThreadPool.h"
+#include <chrono>
+
+namespace {
+  // Memoria viva de texturas; destroy() la descuenta al soltar la ultima referencia
+  void
+  trackTextureBytes(long long bytes, int textures) {
+    ENGINE_GAUGE_ADD("textures", textures);
+    ENGINE_GAUGE_ADD("texture_bytes", bytes);
+  }
+}
 
 HRESULT 
 Texture::init(Device& device, 
               const std::string& textureName, 
-              ExtensionType extensionType) {
+              ExtensionType extensionType,
+              ThreadPool* threadPool,
+              BcFormat compression) {
+	PROFILE_SCOPE("Texture::init");
 	if (!device.m_device) {
 		ERROR("Texture", "init", "Device is null.");
 		return E_POINTER;
@@ -24,119 +39,43 @@ Texture::init(Device& device,
 		m_textureName = textureName + ".dds";
 
 		// Cargar textura DDS
-		hr = D3DX11CreateShaderResourceViewFromFile(
-			device.m_device,
-			m_textureName.c_str(),
-			nullptr,
-			nullptr,
-			&m_textureFromImg,
-			nullptr
-		);
+		hr = device.CreateShaderResourceViewFromFile(m_textureName, &m_textureFromImg);
 
 		if (FAILED(hr)) {
 			ERROR("Texture", "init",
 				("Failed to load DDS texture. Verify filepath: " + m_textureName).c_str());
 			return hr;
 		}
+		// El tamano real (mips y formato comprimido) lo da el recurso que creo D3DX
+		ID3D11Resource* resource = nullptr;
+		ID3D11Texture2D* texture2D = nullptr;
+		m_textureFromImg->GetResource(&resource);
+		if (resource && SUCCEEDED(resource->QueryInterface(__uuidof(ID3D11Texture2D),
+		                                                   reinterpret_cast<void**>(&texture2D)))) {
+			D3D11_TEXTURE2D_DESC ddsDesc;
+			texture2D->GetDesc(&ddsDesc);
+			m_gpuBytes = getTextureBytes(ddsDesc);
+			trackTextureBytes(static_cast<long long>(m_gpuBytes), 1);
+		}
+		SAFE_RELEASE(texture2D);
+		SAFE_RELEASE(resource);
 		break;
 	}
 
 	case PNG: {
-    m_textureName = textureName + ".png";
-    int width, height, channels;
-    unsigned char* data = stbi_load(m_textureName.c_str(), &width, &height, &channels, 4); // 4 bytes por pixel (RGBA)
-    if (!data) {
-      ERROR("Texture", "init",
-        ("Failed to load PNG texture: " + std::string(stbi_failure_reason())).c_str());
-      return E_FAIL;
-    }
-
-    // Crear descripci?n de textura
-    D3D11_TEXTURE2D_DESC textureDesc = {};
-    textureDesc.Width = width;
-    textureDesc.Height = height;
-    textureDesc.MipLevels = 1;
-    textureDesc.ArraySize = 1;
-    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDesc.SampleDesc.Count = 1;
-    textureDesc.Usage = D3D11_USAGE_DEFAULT;
-    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-
-    // Crear datos de subrecarga
-    D3D11_SUBRESOURCE_DATA initData = {};
-    initData.pSysMem = data;
-    initData.SysMemPitch = width * 4;
-
-    hr = device.CreateTexture2D(&textureDesc, &initData, &m_texture);
-    stbi_image_free(data); // Liberar los datos de imagen inmediatamente
-		
-    if (FAILED(hr)) {
-      ERROR("Texture", "init", "Failed to create texture from PNG data");
-      return hr;
-    }
-
-    // Crear vista del recurso de la textura
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-    srvDesc.Format = textureDesc.Format;
-    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MipLevels = 1;
-
-    hr = device.m_device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
-    SAFE_RELEASE(m_texture); // Liberar textura intermedia
-
-    if (FAILED(hr)) {
-      ERROR("Texture", "init", "Failed to create shader resource view for PNG texture");
-      return hr;
-    }
+		m_textureName = textureName + ".png";
+		hr = initFromImage(device, "PNG", threadPool, compression);
+		if (FAILED(hr)) {
+			return hr;
+		}
 		break;
 	}
 	case JPG: {
-    m_textureName = textureName + ".jpg";
-    int width, height, channels;
-    unsigned char* data = stbi_load(m_textureName.c_str(), &width, &height, &channels, 4); // 4 bytes por pixel (RGBA)
-    if (!data) {
-      ERROR("Texture", "init",
-        ("Failed to load JPG texture: " + std::string(stbi_failure_reason())).c_str());
-      return E_FAIL;
-    }
-
-    // Crear descripci?n de textura
-    D3D11_TEXTURE2D_DESC textureDesc = {};
-    textureDesc.Width = width;
-    textureDesc.Height = height;
-    textureDesc.MipLevels = 1;
-    textureDesc.ArraySize = 1;
-    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDesc.SampleDesc.Count = 1;
-    textureDesc.Usage = D3D11_USAGE_DEFAULT;
-    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-
-    // Crear datos de subrecarga
-    D3D11_SUBRESOURCE_DATA initData = {};
-    initData.pSysMem = data;
-    initData.SysMemPitch = width * 4;
-
-    hr = device.CreateTexture2D(&textureDesc, &initData, &m_texture);
-    stbi_image_free(data); // Liberar los datos de imagen inmediatamente
-
-    if (FAILED(hr)) {
-      ERROR("Texture", "init", "Failed to create texture from PNG data");
-      return hr;
-    }
-
-    // Crear vista del recurso de la textura
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-    srvDesc.Format = textureDesc.Format;
-    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MipLevels = 1;
-
-    hr = device.m_device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
-    SAFE_RELEASE(m_texture); // Liberar textura intermedia
-
-    if (FAILED(hr)) {
-      ERROR("Texture", "init", "Failed to create shader resource view for JPG texture");
-      return hr;
-    }
+		m_textureName = textureName + ".jpg";
+		hr = initFromImage(device, "JPG", threadPool, compression);
+		if (FAILED(hr)) {
+			return hr;
+		}
 		break;
 	}
 	default:
@@ -147,6 +86,69 @@ Texture::init(Device& device,
 	return hr;
 }
 
+HRESULT
+Texture::initFromImage(Device& device, const char* label, ThreadPool* threadPool, BcFormat compression) {
+  // Un solo camino para PNG y JPG: el importador decodifica o sirve el blob de la cache
+  // BC4/BC5 guardan datos (mascaras, normales), no color: se filtran sin sRGB
+  ImageImportSettings settings;
+  settings.compression = compression;
+  settings.srgb = compression != BcFormat::BC4 && compression != BcFormat::BC5;
+  settings.threadPool = threadPool;
+  ImportedImage image;
+  std::string error;
+  if (!ImageImporter::importFile(m_textureName, settings, image, &error)) {
+    ERROR("Texture", "init", ("Failed to load " + std::string(label) + " texture: " + error).c_str());
+    return E_FAIL;
+  }
+
+  // Con un acierto los niveles apuntan a la proyeccion del archivo: se suben sin copia
+  std::vector<D3D11_SUBRESOURCE_DATA> initData;
+  image.getSubresources(initData);
+  return uploadLevels(device, label, image.format, image.width, image.height, initData);
+}
+
+HRESULT
+Texture::uploadLevels(Device& device,
+                      const char* label,
+                      DXGI_FORMAT format,
+                      unsigned int width,
+                      unsigned int height,
+                      const std::vector<D3D11_SUBRESOURCE_DATA>& levels) {
+  // Crear descripcion de textura
+  D3D11_TEXTURE2D_DESC textureDesc = {};
+  textureDesc.Width = width;
+  textureDesc.Height = height;
+  textureDesc.MipLevels = static_cast<unsigned int>(levels.size());
+  textureDesc.ArraySize = 1;
+  textureDesc.Format = format;
+  textureDesc.SampleDesc.Count = 1;
+  textureDesc.Usage = D3D11_USAGE_DEFAULT;
+  textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+  // Un subrecurso por nivel
+  HRESULT hr = device.CreateTexture2D(&textureDesc, levels.data(), &m_texture);
+  if (FAILED(hr)) {
+    ERROR("Texture", "init", ("Failed to create texture from " + std::string(label) + " data").c_str());
+    return hr;
+  }
+
+  // Crear vista del recurso de la textura
+  D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+  srvDesc.Format = textureDesc.Format;
+  srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+  srvDesc.Texture2D.MipLevels = textureDesc.MipLevels;
+
+  hr = device.CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
+  SAFE_RELEASE(m_texture); // Liberar textura intermedia
+  if (FAILED(hr)) {
+    ERROR("Texture", "init", ("Failed to create shader resource view for " + std::string(label) + " texture").c_str());
+    return hr;
+  }
+  m_gpuBytes = getTextureBytes(textureDesc);
+  trackTextureBytes(static_cast<long long>(m_gpuBytes), 1);
+  return S_OK;
+}
+
 HRESULT 
 Texture::init(Device& device, 
               unsigned int width, 
@@ -186,6 +188,8 @@ Texture::init(Device& device,
       ("Failed to create texture with specified params. HRESULT: " + std::to_string(hr)).c_str());
     return hr;
   }
+  m_gpuBytes = getTextureBytes(desc);
+  trackTextureBytes(static_cast<long long>(m_gpuBytes), 1);
 
   return S_OK;
 }
@@ -207,7 +211,7 @@ Texture::init(Device& device, Texture& textureRef, DXGI_FORMAT format) {
   srvDesc.Texture2D.MipLevels = 1;
   srvDesc.Texture2D.MostDetailedMip = 0;
 
-  HRESULT hr = device.m_device->CreateShaderResourceView(textureRef.m_texture,
+  HRESULT hr = device.CreateShaderResourceView(textureRef.m_texture,
                                                          &srvDesc,
                                                          &m_textureFromImg);
 
@@ -235,158 +239,211 @@ Texture::render(DeviceContext& deviceContext,
   }
 
   if (m_textureFromImg) {
+    ENGINE_STAT_ADD("texture_binds", 1);
     deviceContext.PSSetShaderResources(StartSlot, NumViews, &m_textureFromImg);
   }
 }
 
 void 
 Texture::destroy() {
+  // La vista retiene el recurso: se suelta primero la textura y el recuento final lo da la vista
+  ULONG references = 1;
   if (m_texture != nullptr) {
-    SAFE_RELEASE(m_texture);
+    references = m_texture->Release();
+    m_texture = nullptr;
+  }
+  if (m_textureFromImg != nullptr) {
+    references = m_textureFromImg->Release();
+    m_textureFromImg = nullptr;
   }
-  else if (m_textureFromImg != nullptr) {
-    SAFE_RELEASE(m_textureFromImg);
+  if (references == 0 && m_gpuBytes > 0) {
+    trackTextureBytes(-static_cast<long long>(m_gpuBytes), -1);
   }
+  m_gpuBytes = 0;
 }
 
-HRESULT 
-Texture::CreateCubemap(Device& device, 
-                       DeviceContext& deviceContext, 
-                       const std::array<std::string, 6>& facePaths, 
-                       bool generateMips) {
-  // 0) Limpieza si ya hab?a recursos
-  destroy();
+unsigned long long
+Texture::getTextureBytes(const D3D11_TEXTURE2D_DESC& desc) {
+  unsigned int blockBytes = 0;    // BCn: bytes por bloque de 4x4
+  unsigned int pixelBytes = 4;
+  switch (desc.Format) {
+  case DXGI_FORMAT_BC1_TYPELESS: case DXGI_FORMAT_BC1_UNORM: case DXGI_FORMAT_BC1_UNORM_SRGB:
+  case DXGI_FORMAT_BC4_TYPELESS: case DXGI_FORMAT_BC4_UNORM: case DXGI_FORMAT_BC4_SNORM:
+    blockBytes = 8;
+    break;
+  case DXGI_FORMAT_BC2_TYPELESS: case DXGI_FORMAT_BC2_UNORM: case DXGI_FORMAT_BC2_UNORM_SRGB:
+  case DXGI_FORMAT_BC3_TYPELESS: case DXGI_FORMAT_BC3_UNORM: case DXGI_FORMAT_BC3_UNORM_SRGB:
+  case DXGI_FORMAT_BC5_TYPELESS: case DXGI_FORMAT_BC5_UNORM: case DXGI_FORMAT_BC5_SNORM:
+  case DXGI_FORMAT_BC6H_TYPELESS: case DXGI_FORMAT_BC6H_UF16: case DXGI_FORMAT_BC6H_SF16:
+  case DXGI_FORMAT_BC7_TYPELESS: case DXGI_FORMAT_BC7_UNORM: case DXGI_FORMAT_BC7_UNORM_SRGB:
+    blockBytes = 16;
+    break;
+  case DXGI_FORMAT_R32G32B32A32_TYPELESS: case DXGI_FORMAT_R32G32B32A32_FLOAT:
+  case DXGI_FORMAT_R32G32B32A32_UINT: case DXGI_FORMAT_R32G32B32A32_SINT:
+    pixelBytes = 16;
+    break;
+  case DXGI_FORMAT_R16G16B16A16_TYPELESS: case DXGI_FORMAT_R16G16B16A16_FLOAT:
+  case DXGI_FORMAT_R16G16B16A16_UNORM: case DXGI_FORMAT_R32G32_FLOAT:
+  case DXGI_FORMAT_R32G8X24_TYPELESS: case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+    pixelBytes = 8;
+    break;
+  case DXGI_FORMAT_R16_TYPELESS: case DXGI_FORMAT_R16_FLOAT: case DXGI_FORMAT_R16_UNORM:
+  case DXGI_FORMAT_D16_UNORM: case DXGI_FORMAT_R8G8_UNORM:
+    pixelBytes = 2;
+    break;
+  case DXGI_FORMAT_R8_TYPELESS: case DXGI_FORMAT_R8_UNORM: case DXGI_FORMAT_A8_UNORM:
+    pixelBytes = 1;
+    break;
+  default:
+    break;
+  }
 
-  // 1) Cargar caras con stb_image (forzar RGBA)
-  stbi_set_flip_vertically_on_load(false);
-
-  int width = 0, height = 0, channels = 0;
-  std::array<unsigned char*, 6> facePixels{};
-  facePixels.fill(nullptr);
-
-  for (int i = 0; i < 6; ++i) {
-		int w = 0, h = 0, c = 0;
-    facePixels[i] = stbi_load(facePaths[i].c_str(), &w, &h, &c, 4);
-    if (!facePixels[i]) {
-      // liberar lo ya cargado
-      for (int k = 0; k < i; ++k) {
-        if (facePixels[k]) {
-          stbi_image_free(facePixels[k]);
-					return E_FAIL;
-        }
-      }
+  // MipLevels 0 = cadena completa hasta 1x1
+  unsigned int mipLevels = desc.MipLevels;
+  if (mipLevels == 0) {
+    unsigned int size = desc.Width > desc.Height ? desc.Width : desc.Height;
+    mipLevels = 1;
+    while (size > 1) {
+      size >>= 1;
+      ++mipLevels;
     }
-
-    if (i == 0) {
-      width = w;
-      height = h;
+  }
+  unsigned long long bytes = 0;
+  unsigned int width = desc.Width;
+  unsigned int height = desc.Height;
+  for (unsigned int mip = 0; mip < mipLevels; ++mip) {
+    if (blockBytes > 0) {
+      bytes += static_cast<unsigned long long>((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
     }
     else {
-      if (w != width || h != height) {
+      bytes += static_cast<unsigned long long>(width) * height * pixelBytes;
+    }
+    width = width > 1 ? width / 2 : 1;
+    height = height > 1 ? height / 2 : 1;
+  }
+  const unsigned int samples = desc.SampleDesc.Count > 1 ? desc.SampleDesc.Count : 1;
+  const unsigned int slices = desc.ArraySize > 1 ? desc.ArraySize : 1;
+  return bytes * slices * samples;
+}
+
+HRESULT
+Texture::decodeCubemapFaces(const std::array<std::string, 6>& facePaths,
+                            bool generateMips,
+                            ThreadPool* threadPool,
+                            CubemapFaces& out,
+                            bool useCache) {
+  PROFILE_SCOPE("Texture::decodeCubemapFaces");
+  const auto begin = std::chrono::steady_clock::now();
+  out = CubemapFaces();
+
+  // Una cara por tarea: cada una pasa por el importador (cache incluida) en su hilo.
+  // Cada cara es duena de sus datos, asi que nada se fuga aunque falle otra
+  ImageImportSettings settings;
+  settings.generateMips = generateMips;
+  settings.useCache = useCache;   // Sin pool dentro: parallelFor no es reentrante y las caras ya van en paralelo
+  std::array<std::string, 6> errors;
+  auto decodeFace = [&](unsigned int face) {
+    ImageImporter::importFile(facePaths[face], settings, out.faces[face], &errors[face]);
+  };
+  if (threadPool) {
+    threadPool->parallelFor(6, decodeFace);
+  }
+  else {
+    for (unsigned int face = 0; face < 6; ++face) {
+      decodeFace(face);
+    }
+  }
+
+  HRESULT hr = S_OK;
+  for (unsigned int face = 0; face < 6; ++face) {
+    if (!errors[face].empty()) {
+      ERROR("Texture", "CreateCubemap", ("Failed to load cubemap face " + errors[face]).c_str());
+      hr = E_FAIL;
+    }
+  }
+  if (SUCCEEDED(hr)) {
+    out.width = out.faces[0].width;
+    out.height = out.faces[0].height;
+    for (unsigned int face = 1; face < 6; ++face) {
+      if (out.faces[face].width != out.width || out.faces[face].height != out.height) {
         ERROR("Texture", "CreateCubemap", "All cubemap faces must have the same dimensions.");
-        // liberar lo ya cargado
-        for (int k = 0; k <= i; ++k) {
-          if (facePixels[k]) {
-            stbi_image_free(facePixels[k]);
-            return E_FAIL;
-          }
-        }
+        hr = E_FAIL;
+        break;
       }
-		}
+    }
+  }
+  if (FAILED(hr)) {
+    out = CubemapFaces();
+    return hr;
   }
+  out.decodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+  return S_OK;
+}
 
-  // 2) Crear Texture2D array (6 slices) y marcarla como cubemap
+HRESULT 
+Texture::CreateCubemap(Device& device, 
+                       const std::array<std::string, 6>& facePaths, 
+                       bool generateMips,
+                       ThreadPool* threadPool) {
+  PROFILE_SCOPE("Texture::CreateCubemap");
+  // 0) Limpieza si ya habia recursos
+  destroy();
+
+  // 1) Importar las caras (y sus mips) en paralelo; con cache, desde sus blobs proyectados
+  CubemapFaces decoded;
+  HRESULT hr = decodeCubemapFaces(facePaths, generateMips, threadPool, decoded);
+  if (FAILED(hr)) {
+    return hr;
+  }
+  const unsigned int mipLevels = static_cast<unsigned int>(decoded.faces[0].levels.size());
+
+  // 2) Crear Texture2D array (6 slices) con todos sus niveles y marcarla como cubemap
   D3D11_TEXTURE2D_DESC texDesc{};
-  texDesc.Width = static_cast<unsigned int>(width);
-  texDesc.Height = static_cast<unsigned int>(height);
-  texDesc.MipLevels = generateMips ? 0 : 1;
+  texDesc.Width = decoded.width;
+  texDesc.Height = decoded.height;
+  texDesc.MipLevels = mipLevels;
   texDesc.ArraySize = 6;
   texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
   texDesc.SampleDesc.Count = 1;
   texDesc.SampleDesc.Quality = 0;
   texDesc.Usage = D3D11_USAGE_DEFAULT;
-  texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | (generateMips ? D3D11_BIND_RENDER_TARGET : 0);
+  texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
   texDesc.CPUAccessFlags = 0;
-  texDesc.MiscFlags = D3D11_RESOURCE_MISC_TEXTURECUBE | (generateMips ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0);
-
-  HRESULT hr = S_OK;
-
-  if (!generateMips) {
-    std::array<D3D11_SUBRESOURCE_DATA, 6> initData{};
-    for (int face = 0; face < 6; ++face)
-    {
-      initData[face].pSysMem = facePixels[face];
-      initData[face].SysMemPitch = static_cast<unsigned int>(width * 4);
-      initData[face].SysMemSlicePitch = 0;
-    }
-
-		hr = device.CreateTexture2D(&texDesc, initData.data(), &m_texture);
-    if (FAILED(hr)) {
-      for (auto* p : facePixels) {
-        if (p) {
-          stbi_image_free(p);
-        }
-      } 
-      return hr;
+  texDesc.MiscFlags = D3D11_RESOURCE_MISC_TEXTURECUBE;
+
+  // Subrecurso = cara * niveles + nivel
+  std::vector<D3D11_SUBRESOURCE_DATA> initData(6 * mipLevels);
+  std::vector<D3D11_SUBRESOURCE_DATA> faceData;
+  for (unsigned int face = 0; face < 6; ++face) {
+    decoded.faces[face].getSubresources(faceData);
+    for (unsigned int mip = 0; mip < mipLevels; ++mip) {
+      initData[D3D11CalcSubresource(mip, face, mipLevels)] = faceData[mip];
     }
   }
-  else {
-    // crear vac?o y subir mip 0 por cara
-    hr = device.CreateTexture2D(&texDesc, nullptr, &m_texture);
-    if (FAILED(hr)) {
-      for (auto* p : facePixels) {
-        if (p) {
-          stbi_image_free(p);
-        }
-      }
-      return hr;
-    }
 
-    for (unsigned int face = 0; face < 6; ++face)
-    {
-      // Mip 0, ArraySlice=face
-      unsigned int sub = D3D11CalcSubresource(0, face, 0 /*MipLevels=0*/);
-      deviceContext.UpdateSubresource(m_texture, 
-                                      sub, 
-                                      nullptr, 
-                                      facePixels[face], 
-                                      static_cast<unsigned int>(width * 4), 0);
-    }
+  hr = device.CreateTexture2D(&texDesc, initData.data(), &m_texture);
+  if (FAILED(hr)) {
+    ERROR("Texture", "CreateCubemap", ("Failed to create cubemap texture. HRESULT: " + std::to_string(hr)).c_str());
+    return hr;
   }
+  m_gpuBytes = getTextureBytes(texDesc);
+  trackTextureBytes(static_cast<long long>(m_gpuBytes), 1);
 
   // 3) Crear SRV dimension TEXTURECUBE
   D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
   srvDesc.Format = texDesc.Format;
   srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
   srvDesc.TextureCube.MostDetailedMip = 0;
-  srvDesc.TextureCube.MipLevels = generateMips ? (unsigned int)-1 : 1;
-  
-  hr = device.m_device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
+  srvDesc.TextureCube.MipLevels = mipLevels;
 
+  hr = device.CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
   if (FAILED(hr)) {
-    for (auto* p : facePixels) {
-      if (p) {
-        stbi_image_free(p);
-			}
-    }
+    ERROR("Texture", "CreateCubemap", ("Failed to create cubemap shader resource view. HRESULT: " + std::to_string(hr)).c_str());
     destroy();
-		return hr;
-  }
-
-  // 4) Generar mips si aplica
-  if (generateMips)
-  {
-    deviceContext.m_deviceContext->GenerateMips(m_textureFromImg);
-  }
-
-  // 5) Liberar CPU pixels
-  for (auto* p : facePixels) {
-    if (p) {
-      stbi_image_free(p);
-    }
+    return hr;
   }
 
-  // 6) Guarda nombre (opcional)
+  // 4) Guarda nombre (opcional)
   m_textureName = "Cubemap";
 
   return S_OK;
@@ -0,0 +1,99 @@
+#include "EngineUtilities/Utilities/ThreadPool.h"
+#include "EngineUtilities/Utilities/Profiler.h"
+
+void
+ThreadPool::init(unsigned int workerCount) {
+  destroy();
+  if (workerCount == 0) {
+    unsigned int cores = std::thread::hardware_concurrency();
+    workerCount = cores > 1 ? cores - 1 : 0;
+  }
+
+  m_stop = false;
+  m_workers.reserve(workerCount);
+  for (unsigned int i = 0; i < workerCount; ++i) {
+    m_workers.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+void
+ThreadPool::destroy() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_wake.notify_all();
+  for (std::thread& worker : m_workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  m_workers.clear();
+}
+
+void
+ThreadPool::drain() {
+  PROFILE_SCOPE("ThreadPool::drain");
+  for (;;) {
+    unsigned int index = m_next.fetch_add(1);
+    if (index >= m_count) {
+      return;
+    }
+    (*m_task)(index);
+  }
+}
+
+void
+ThreadPool::parallelFor(unsigned int count, const std::function<void(unsigned int)>& task) {
+  if (count == 0) {
+    return;
+  }
+  // Sin hilos o con un solo elemento no compensa despertar a nadie
+  if (m_workers.empty() || count == 1) {
+    for (unsigned int i = 0; i < count; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_next.store(0);
+    m_busyWorkers = static_cast<unsigned int>(m_workers.size());
+    ++m_generation;
+  }
+  m_wake.notify_all();
+
+  drain();
+
+  // Esperar a que cada hilo suelte el lote (no slo a que se acaben los ndices)
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [this] { return m_busyWorkers == 0; });
+  m_task = nullptr;
+}
+
+void
+ThreadPool::workerLoop(unsigned int index) {
+  PROFILE_THREAD_NAME("Worker " + std::to_string(index));
+  unsigned long long seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+      if (m_stop) {
+        return;
+      }
+      seen = m_generation;
+    }
+
+    drain();
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      --m_busyWorkers;
+    }
+    m_done.notify_one();
+  }
+}
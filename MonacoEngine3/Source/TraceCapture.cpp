@@ -0,0 +1,242 @@
+#include "EngineUtilities/Utilities/TraceCapture.h"
+#include <cstdio>
+#include <fstream>
+
+namespace {
+  // Los nombres son literales o nombres de pases: basta con escapar comillas, barras y control
+  void
+  appendEscaped(std::string& out, const char* text) {
+    for (const char* c = text ? text : "?"; *c; ++c) {
+      if (*c == '"' || *c == '\\') {
+        out += '\\';
+        out += *c;
+      }
+      else if (static_cast<unsigned char>(*c) < 0x20) {
+        out += ' ';
+      }
+      else {
+        out += *c;
+      }
+    }
+  }
+}
+
+long long
+TraceCapture::now() {
+  LARGE_INTEGER ticks;
+  QueryPerformanceCounter(&ticks);
+  return ticks.QuadPart;
+}
+
+bool
+TraceCapture::start(unsigned int frameCount, const std::string& fileName) {
+  if (isCapturing() || isWriting()) {
+    return false;
+  }
+  if (m_writer.joinable()) {
+    m_writer.join();
+  }
+  m_fileName = fileName;
+  m_framesRequested = frameCount;
+  m_framesCaptured = 0;
+  // Si se pide a mitad de frame, ese frame no cuenta: empieza a contar en el siguiente
+  m_frameStart = 0;
+  m_captureStart = now();
+  m_generation.fetch_add(1, std::memory_order_acq_rel);
+  m_capturing.store(true, std::memory_order_release);
+  return true;
+}
+
+void
+TraceCapture::stop() {
+  if (!m_capturing.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+  if (m_writer.joinable()) {
+    m_writer.join();
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats = TraceCaptureStats();
+    m_stats.framesRequested = m_framesRequested;
+    m_stats.framesCaptured = m_framesCaptured;
+  }
+  // El frame sigue en cuanto se lanza el hilo; los eventos que lleguen tarde caen
+  // detrs del contador que lea el escritor y no se escriben
+  m_writing.store(true, std::memory_order_release);
+  m_writer = std::thread(&TraceCapture::write, this,
+                         m_generation.load(std::memory_order_acquire), m_captureStart, m_fileName);
+}
+
+void
+TraceCapture::destroy() {
+  stop();
+  if (m_writer.joinable()) {
+    m_writer.join();
+  }
+}
+
+TraceCapture::ThreadBuffer&
+TraceCapture::getThreadBuffer() {
+  // Un buffer por hilo y por proceso: los hilos que terminan dejan el suyo para el escritor
+  thread_local ThreadBuffer* t_buffer = nullptr;
+  if (!t_buffer) {
+    std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+    buffer->threadId = GetCurrentThreadId();
+    buffer->events.resize(kEventsPerThread);
+    t_buffer = buffer.get();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_threads.push_back(std::move(buffer));
+  }
+  return *t_buffer;
+}
+
+void
+TraceCapture::setThreadName(const std::string& name) {
+  ThreadBuffer& buffer = getThreadBuffer();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  buffer.name = name;
+}
+
+void
+TraceCapture::endEvent(const char* name, long long start) {
+  if (start == 0 || !isCapturing()) {
+    return;
+  }
+  const long long end = now();
+  ThreadBuffer& buffer = getThreadBuffer();
+
+  // Slo el hilo dueo toca su contador: al ver una captura nueva lo vaca l mismo
+  const unsigned int generation = m_generation.load(std::memory_order_acquire);
+  unsigned int count = buffer.count.load(std::memory_order_relaxed);
+  if (buffer.generation.load(std::memory_order_relaxed) != generation) {
+    count = 0;
+    buffer.count.store(0, std::memory_order_relaxed);
+    buffer.dropped.store(0, std::memory_order_relaxed);
+    buffer.generation.store(generation, std::memory_order_release);
+  }
+  if (count >= kEventsPerThread) {
+    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  TraceEvent& event = buffer.events[count];
+  event.name = name;
+  event.start = start;
+  event.end = end;
+  buffer.count.store(count + 1, std::memory_order_release);
+}
+
+void
+TraceCapture::beginFrame() {
+  if (isCapturing()) {
+    m_frameStart = now();
+  }
+}
+
+void
+TraceCapture::endFrame() {
+  if (!isCapturing() || m_frameStart == 0) {
+    return;
+  }
+  endEvent("Frame", m_frameStart);
+  m_frameStart = 0;
+  ++m_framesCaptured;
+  if (m_framesRequested > 0 && m_framesCaptured >= m_framesRequested) {
+    stop();
+  }
+}
+
+void
+TraceCapture::write(unsigned int generation, long long captureStart, std::string fileName) {
+  const long long writeStart = now();
+  LARGE_INTEGER frequency;
+  QueryPerformanceFrequency(&frequency);
+  const double usPerTick = 1000000.0 / static_cast<double>(frequency.QuadPart);
+
+  // Copia de la lista y de los nombres; los eventos se leen sin bloquear a nadie
+  struct ThreadSnapshot {
+    const ThreadBuffer* buffer;
+    std::string name;
+    unsigned int count;
+  };
+  std::vector<ThreadSnapshot> threads;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : m_threads) {
+      ThreadSnapshot snapshot = { buffer.get(), buffer->name, 0 };
+      if (buffer->generation.load(std::memory_order_acquire) == generation) {
+        snapshot.count = buffer->count.load(std::memory_order_acquire);
+      }
+      threads.push_back(snapshot);
+    }
+  }
+
+  TraceCaptureStats stats;
+  const DWORD processId = GetCurrentProcessId();
+  std::string json;
+  json.reserve(1 << 20);
+  json += "{\"traceEvents\":[\n";
+  char line[256];
+  snprintf(line, sizeof(line),
+           "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":0,\"args\":{\"name\":\"MonacoEngine3\"}}",
+           static_cast<unsigned long>(processId));
+  json += line;
+
+  for (const ThreadSnapshot& thread : threads) {
+    if (thread.count == 0 && thread.name.empty()) {
+      continue;
+    }
+    const unsigned long threadId = static_cast<unsigned long>(thread.buffer->threadId);
+    if (!thread.name.empty()) {
+      snprintf(line, sizeof(line), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":%lu,\"args\":{\"name\":\"",
+               static_cast<unsigned long>(processId), threadId);
+      json += line;
+      appendEscaped(json, thread.name.c_str());
+      json += "\"}}";
+    }
+    if (thread.count > 0) {
+      ++stats.threads;
+    }
+    for (unsigned int i = 0; i < thread.count; ++i) {
+      const TraceEvent& event = thread.buffer->events[i];
+      // Un scope abierto antes de empezar la captura se recorta a su inicio
+      const long long start = event.start > captureStart ? event.start : captureStart;
+      json += ",\n{\"name\":\"";
+      appendEscaped(json, event.name);
+      snprintf(line, sizeof(line), "\",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%lu}",
+               (start - captureStart) * usPerTick, (event.end - start) * usPerTick,
+               static_cast<unsigned long>(processId), threadId);
+      json += line;
+    }
+    stats.events += thread.count;
+    stats.droppedEvents += thread.buffer->dropped.load(std::memory_order_relaxed);
+  }
+  json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  std::ofstream file(fileName, std::ios::binary);
+  file.write(json.data(), static_cast<std::streamsize>(json.size()));
+  if (!file) {
+    ERROR("TraceCapture", "write", ("Failed to write trace file " + fileName).c_str());
+  }
+  else {
+    stats.bytesWritten = json.size();
+  }
+  file.close();
+
+  LARGE_INTEGER writeEnd;
+  QueryPerformanceCounter(&writeEnd);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.framesRequested = m_stats.framesRequested;
+    stats.framesCaptured = m_stats.framesCaptured;
+    stats.writeMs = (writeEnd.QuadPart - writeStart) * usPerTick * 0.001;
+    m_stats = stats;
+  }
+  m_writing.store(false, std::memory_order_release);
+}
+
+TraceCaptureStats
+TraceCapture::getStats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
@@ -0,0 +1,203 @@
+//--------------------------------------------------------------------------------------
+// File: MonacoEngine3_Instanced.fx
+//
+// Variante instanciada de MonacoEngine3.fx: el mundo y el color llegan por instancia
+// (slot 1) en lugar de cbChangesEveryFrame. View/Projection, textura y sampler no cambian.
+//
+// Keywords (ShaderPermutations):
+//   SHOW_INSTANCE_COLOR  pinta solo el color de instancia, sin textura
+//   RECEIVE_SHADOWS      oscurece con las cascadas de CascadedShadowMap (t1, s1, b3)
+//   CLUSTERED_LIGHTS     suma las luces puntuales y focos de ClusteredLighting (t2..t4, b4)
+//--------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------
+// Constant Buffer Variables
+//--------------------------------------------------------------------------------------
+Texture2D txDiffuse : register( t0 );
+SamplerState samLinear : register( s0 );
+
+cbuffer cbNeverChanges : register( b0 )
+{
+    matrix View;
+};
+
+cbuffer cbChangeOnResize : register( b1 )
+{
+    matrix Projection;
+};
+
+#if defined( RECEIVE_SHADOWS )
+Texture2DArray txShadow : register( t1 );
+SamplerComparisonState samShadow : register( s1 );
+
+cbuffer cbShadowCascades : register( b3 )
+{
+    matrix CascadeViewProj[4];
+    float4 CascadeSplits;   // distancia de vista donde termina cada cascada
+    float4 ShadowParams;    // x = texel en UV, y = cascadas, z = bias de comparacion
+};
+#endif
+
+#if defined( CLUSTERED_LIGHTS )
+Buffer<float4> LightData : register( t2 );      // 3 por luz: posicion/alcance, color/tipo, direccion/cos
+Buffer<uint2> ClusterLights : register( t3 );   // por cluster: inicio en LightIndices y cantidad
+Buffer<uint> LightIndices : register( t4 );
+
+cbuffer cbClusters : register( b4 )
+{
+    float4 ClusterDims;     // x, y = teselas, z = cortes, w = luces visibles
+    float4 ClusterDepth;    // x = depthNear (inicio del primer corte), y = depthFar (fin del ultimo), z = cortes / log(y / x)
+    float4 ClusterScale;    // xy = teselas por pixel
+};
+#endif
+
+//--------------------------------------------------------------------------------------
+struct VS_INPUT
+{
+    float4 Pos : POSITION;
+    float2 Tex : TEXCOORD0;
+    // Datos por instancia: filas de la matriz de mundo (sin transponer) y color
+    float4 World0 : WORLD0;
+    float4 World1 : WORLD1;
+    float4 World2 : WORLD2;
+    float4 World3 : WORLD3;
+    float4 Color : COLOR0;
+};
+
+struct PS_INPUT
+{
+    float4 Pos : SV_POSITION;
+    float2 Tex : TEXCOORD0;
+    float4 Color : COLOR0;
+#if defined( RECEIVE_SHADOWS ) || defined( CLUSTERED_LIGHTS )
+    float3 WorldPos : TEXCOORD1;
+    float ViewDepth : TEXCOORD2;
+#endif
+};
+
+
+//--------------------------------------------------------------------------------------
+// Vertex Shader
+//--------------------------------------------------------------------------------------
+PS_INPUT VS( VS_INPUT input )
+{
+    PS_INPUT output = (PS_INPUT)0;
+    float4x4 world = float4x4( input.World0, input.World1, input.World2, input.World3 );
+    output.Pos = mul( input.Pos, world );
+#if defined( RECEIVE_SHADOWS ) || defined( CLUSTERED_LIGHTS )
+    output.WorldPos = output.Pos.xyz;
+#endif
+    output.Pos = mul( output.Pos, View );
+#if defined( RECEIVE_SHADOWS ) || defined( CLUSTERED_LIGHTS )
+    output.ViewDepth = output.Pos.z;
+#endif
+    output.Pos = mul( output.Pos, Projection );
+    output.Tex = input.Tex;
+    output.Color = input.Color;
+
+    return output;
+}
+
+
+#if defined( RECEIVE_SHADOWS )
+//--------------------------------------------------------------------------------------
+// Sombra: cascada por distancia de vista y PCF 3x3 con comparacion bilineal
+//--------------------------------------------------------------------------------------
+float ShadowFactor( float3 worldPos, float viewDepth )
+{
+    int count = (int)ShadowParams.y;
+    if ( viewDepth > CascadeSplits[count - 1] )
+    {
+        return 1.0f;
+    }
+    int cascade = 0;
+    [unroll] for ( int i = 0; i < 3; ++i )
+    {
+        if ( i < count - 1 && viewDepth > CascadeSplits[i] )
+        {
+            cascade = i + 1;
+        }
+    }
+
+    float4 shadowPos = mul( float4( worldPos, 1.0f ), CascadeViewProj[cascade] );
+    float2 uv = shadowPos.xy * float2( 0.5f, -0.5f ) + 0.5f;
+    float depth = shadowPos.z - ShadowParams.z;
+    float lit = 0.0f;
+    [unroll] for ( int y = -1; y <= 1; ++y )
+    {
+        [unroll] for ( int x = -1; x <= 1; ++x )
+        {
+            float2 offset = float2( x, y ) * ShadowParams.x;
+            lit += txShadow.SampleCmpLevelZero( samShadow, float3( uv + offset, cascade ), depth );
+        }
+    }
+    return lit / 9.0f;
+}
+#endif
+
+
+#if defined( CLUSTERED_LIGHTS )
+//--------------------------------------------------------------------------------------
+// Luces dinamicas: cluster por tesela de pantalla y corte logaritmico de profundidad
+//--------------------------------------------------------------------------------------
+float3 ClusteredLight( float3 worldPos, float3 normal, float viewDepth, float2 pixel )
+{
+    if ( viewDepth > ClusterDepth.y )
+    {
+        return 0.0f;
+    }
+    float slice = floor( log( viewDepth / ClusterDepth.x ) * ClusterDepth.z );
+    uint z = (uint)clamp( slice, 0.0f, ClusterDims.z - 1.0f );
+    uint2 tile = (uint2)min( pixel * ClusterScale.xy, ClusterDims.xy - 1.0f );
+    uint cluster = ( z * (uint)ClusterDims.y + tile.y ) * (uint)ClusterDims.x + tile.x;
+    uint2 range = ClusterLights.Load( cluster );
+
+    float3 lit = 0.0f;
+    for ( uint i = 0; i < range.y; ++i )
+    {
+        uint index = LightIndices.Load( range.x + i ) * 3;
+        float4 positionRange = LightData.Load( index );
+        float4 colorType = LightData.Load( index + 1 );
+        float4 directionCone = LightData.Load( index + 2 );
+
+        float3 toLight = positionRange.xyz - worldPos;
+        float distance = length( toLight );
+        float3 L = toLight / max( distance, 0.0001f );
+        float attenuation = saturate( 1.0f - distance / positionRange.w );
+        attenuation *= attenuation;
+        if ( colorType.w > 0.5f )
+        {
+            // Foco: se apaga linealmente del eje al borde del cono
+            float cosAngle = dot( -L, directionCone.xyz );
+            attenuation *= saturate( ( cosAngle - directionCone.w ) / max( 1.0f - directionCone.w, 0.0001f ) );
+        }
+        lit += colorType.rgb * saturate( dot( normal, L ) ) * attenuation;
+    }
+    return lit;
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------
+// Pixel Shader
+//--------------------------------------------------------------------------------------
+float4 PS( PS_INPUT input) : SV_Target
+{
+#if defined( SHOW_INSTANCE_COLOR )
+    float4 color = input.Color;
+#else
+    float4 color = txDiffuse.Sample( samLinear, input.Tex ) * input.Color;
+#endif
+#if defined( CLUSTERED_LIGHTS )
+    // El vertice no trae normal: la de la cara sale de las derivadas de la posicion
+    float3 normal = normalize( cross( ddx( input.WorldPos ), ddy( input.WorldPos ) ) );
+    float3 albedo = color.rgb;
+#endif
+#if defined( RECEIVE_SHADOWS )
+    color.rgb *= lerp( 0.35f, 1.0f, ShadowFactor( input.WorldPos, input.ViewDepth ) );
+#endif
+#if defined( CLUSTERED_LIGHTS )
+    color.rgb += albedo * ClusteredLight( input.WorldPos, normal, input.ViewDepth, input.Pos.xy );
+#endif
+    return color;
+}
@@ -0,0 +1,53 @@
+//--------------------------------------------------------------------------------------
+// File: MonacoEngine3_Shadow.fx
+//
+// Pase de sombras (solo profundidad) de CascadedShadowMap: lleva cada vertice al clip
+// de la cascada que se esta dibujando. El mundo llega como en MonacoEngine3.fx
+// (cbChangesEveryFrame en b2); ViewProj de la cascada ocupa b0.
+//--------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------
+// Constant Buffer Variables
+//--------------------------------------------------------------------------------------
+cbuffer cbShadowCascade : register( b0 )
+{
+    matrix LightViewProj;
+};
+
+cbuffer cbChangesEveryFrame : register( b2 )
+{
+    matrix World;
+    float4 vMeshColor;
+};
+
+//--------------------------------------------------------------------------------------
+struct VS_INPUT
+{
+    float4 Pos : POSITION;
+};
+
+struct PS_INPUT
+{
+    float4 Pos : SV_POSITION;
+};
+
+
+//--------------------------------------------------------------------------------------
+// Vertex Shader
+//--------------------------------------------------------------------------------------
+PS_INPUT VS( VS_INPUT input )
+{
+    PS_INPUT output = (PS_INPUT)0;
+    output.Pos = mul( input.Pos, World );
+    output.Pos = mul( output.Pos, LightViewProj );
+
+    return output;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Pixel Shader: sin salida de color, solo se escribe profundidad
+//--------------------------------------------------------------------------------------
+void PS( PS_INPUT input )
+{
+}
@@ -0,0 +1,52 @@
+//--------------------------------------------------------------------------------------
+// File: MonacoEngine3_Shadow_Instanced.fx
+//
+// Variante instanciada de MonacoEngine3_Shadow.fx: el mundo llega por instancia
+// (slot 1), con el mismo layout que MonacoEngine3_Instanced.fx.
+//--------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------
+// Constant Buffer Variables
+//--------------------------------------------------------------------------------------
+cbuffer cbShadowCascade : register( b0 )
+{
+    matrix LightViewProj;
+};
+
+//--------------------------------------------------------------------------------------
+struct VS_INPUT
+{
+    float4 Pos : POSITION;
+    // Datos por instancia: filas de la matriz de mundo (sin transponer)
+    float4 World0 : WORLD0;
+    float4 World1 : WORLD1;
+    float4 World2 : WORLD2;
+    float4 World3 : WORLD3;
+};
+
+struct PS_INPUT
+{
+    float4 Pos : SV_POSITION;
+};
+
+
+//--------------------------------------------------------------------------------------
+// Vertex Shader
+//--------------------------------------------------------------------------------------
+PS_INPUT VS( VS_INPUT input )
+{
+    PS_INPUT output = (PS_INPUT)0;
+    float4x4 world = float4x4( input.World0, input.World1, input.World2, input.World3 );
+    output.Pos = mul( input.Pos, world );
+    output.Pos = mul( output.Pos, LightViewProj );
+
+    return output;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Pixel Shader: sin salida de color, solo se escribe profundidad
+//--------------------------------------------------------------------------------------
+void PS( PS_INPUT input )
+{
+}
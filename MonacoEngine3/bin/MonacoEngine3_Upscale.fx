@@ -0,0 +1,52 @@
+//--------------------------------------------------------------------------------------
+// File: MonacoEngine3_Upscale.fx
+//
+// Escalado de DynamicResolution: un quad de pantalla completa (ya en clip) muestrea
+// la esquina del objetivo interno donde se dibujo la escena y la estira al back buffer.
+//--------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------
+// Constant Buffer Variables
+//--------------------------------------------------------------------------------------
+Texture2D txScene : register( t0 );
+SamplerState samLinear : register( s0 );
+
+cbuffer cbUpscale : register( b0 )
+{
+    float4 UVScale;     // xy = parte usada del objetivo, zw = UV maxima (medio texel dentro)
+};
+
+//--------------------------------------------------------------------------------------
+struct VS_INPUT
+{
+    float4 Pos : POSITION;
+    float2 Tex : TEXCOORD0;
+};
+
+struct PS_INPUT
+{
+    float4 Pos : SV_POSITION;
+    float2 Tex : TEXCOORD0;
+};
+
+
+//--------------------------------------------------------------------------------------
+// Vertex Shader
+//--------------------------------------------------------------------------------------
+PS_INPUT VS( VS_INPUT input )
+{
+    PS_INPUT output = (PS_INPUT)0;
+    output.Pos = float4( input.Pos.xy, 0.0f, 1.0f );
+    output.Tex = input.Tex * UVScale.xy;
+    return output;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Pixel Shader
+//--------------------------------------------------------------------------------------
+float4 PS( PS_INPUT input ) : SV_Target
+{
+    // Sin el recorte, el filtrado del borde mezclaria texels fuera de la region dibujada
+    return txScene.Sample( samLinear, min( input.Tex, UVScale.zw ) );
+}